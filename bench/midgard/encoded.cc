@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "midgard/encoded.h"
+#include "midgard/pointll.h"
+#include "midgard/varint.h"
+
+using namespace valhalla::midgard;
+
+namespace {
+
+// a shape the way they look in the tiles and in route responses, a point every few to a few hundred
+// metres which mostly keeps going in the same direction
+std::vector<PointLL> make_shape(size_t length) {
+  std::mt19937 gen(length);
+  std::normal_distribution<double> turn(0, 0.3);
+  std::lognormal_distribution<double> step(-9, 1);
+  std::vector<PointLL> shape;
+  shape.reserve(length);
+  double lon = 5.1, lat = 52.09, heading = 0;
+  for (size_t i = 0; i < length; ++i) {
+    shape.emplace_back(lon, lat);
+    heading += turn(gen);
+    auto distance = step(gen);
+    lon += std::cos(heading) * distance;
+    lat += std::sin(heading) * distance;
+  }
+  return shape;
+}
+
+// the first argument is the number of points and the second which kernel to use
+void set_kernel(benchmark::State& state) {
+  if (!varint::use_kernel(static_cast<varint::Kernel>(state.range(1)))) {
+    state.SkipWithError("kernel not supported on this cpu");
+  }
+}
+
+void count_points(benchmark::State& state, size_t bytes) {
+  state.counters["points"] =
+      benchmark::Counter(state.range(0) * state.iterations(), benchmark::Counter::kIsRate);
+  state.SetBytesProcessed(bytes * state.iterations());
+}
+
+void BM_EncodePolyline(benchmark::State& state, int precision) {
+  set_kernel(state);
+  auto shape = make_shape(state.range(0));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    auto encoded = encode(shape, precision);
+    bytes = encoded.size();
+    benchmark::DoNotOptimize(encoded);
+  }
+  count_points(state, bytes);
+}
+
+void BM_DecodePolyline(benchmark::State& state, int precision) {
+  set_kernel(state);
+  auto encoded = encode(make_shape(state.range(0)), precision);
+  for (auto _ : state) {
+    auto shape = decode<std::vector<PointLL>>(encoded, 1.0 / precision);
+    benchmark::DoNotOptimize(shape);
+  }
+  count_points(state, encoded.size());
+}
+
+void BM_EncodeShape7(benchmark::State& state) {
+  set_kernel(state);
+  auto shape = make_shape(state.range(0));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    auto encoded = encode7(shape);
+    bytes = encoded.size();
+    benchmark::DoNotOptimize(encoded);
+  }
+  count_points(state, bytes);
+}
+
+// what EdgeInfo::lazy_shape does, popping points one at a time
+void BM_DecodeShape7(benchmark::State& state) {
+  set_kernel(state);
+  auto encoded = encode7(make_shape(state.range(0)));
+  for (auto _ : state) {
+    Shape7Decoder<PointLL> decoder(encoded.data(), encoded.size());
+    while (!decoder.empty()) {
+      benchmark::DoNotOptimize(decoder.pop());
+    }
+  }
+  count_points(state, encoded.size());
+}
+
+// loki only looks at the first couple of points of some edges
+void BM_DecodeShape7First(benchmark::State& state) {
+  set_kernel(state);
+  auto encoded = encode7(make_shape(state.range(0)));
+  for (auto _ : state) {
+    Shape7Decoder<PointLL> decoder(encoded.data(), encoded.size());
+    benchmark::DoNotOptimize(decoder.pop());
+    benchmark::DoNotOptimize(decoder.pop());
+  }
+  state.counters["points"] = benchmark::Counter(2 * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// most edges have a handful of points, route and trace shapes have thousands
+void Lengths(benchmark::internal::Benchmark* b) {
+  for (auto kernel : {varint::Kernel::kScalar, varint::Kernel::kSimd}) {
+    for (int length : {4, 16, 128, 1024, 16384}) {
+      b->Args({length, static_cast<int>(kernel)});
+    }
+  }
+  b->ArgNames({"points", "kernel"});
+}
+
+BENCHMARK_CAPTURE(BM_EncodePolyline, polyline5, 1e5)->Apply(Lengths);
+BENCHMARK_CAPTURE(BM_DecodePolyline, polyline5, 1e5)->Apply(Lengths);
+BENCHMARK_CAPTURE(BM_EncodePolyline, polyline6, 1e6)->Apply(Lengths);
+BENCHMARK_CAPTURE(BM_DecodePolyline, polyline6, 1e6)->Apply(Lengths);
+BENCHMARK(BM_EncodeShape7)->Apply(Lengths);
+BENCHMARK(BM_DecodeShape7)->Apply(Lengths);
+BENCHMARK(BM_DecodeShape7First)->Apply(Lengths);
+
+} // namespace
+
+BENCHMARK_MAIN();
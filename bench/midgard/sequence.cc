@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "midgard/sequence.h"
+
+using namespace valhalla::midgard;
+
+namespace {
+
+const std::string kFile = "bench_sequence_" + std::to_string(getpid()) + ".bin";
+
+// fills the file with the same pseudo random ids every time, splitmix64 so its cheap to make
+void write_ids(size_t count) {
+  mem_map<uint64_t> ids;
+  ids.create(kFile, count, POSIX_MADV_SEQUENTIAL);
+  for (uint64_t i = 0; i < count; ++i) {
+    uint64_t z = (i + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    ids.get()[i] = z ^ (z >> 31);
+  }
+}
+
+// the first argument is the number of ids and the second the number of threads
+void BM_SequenceSort(benchmark::State& state) {
+  const size_t count = state.range(0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    write_ids(count);
+    sequence<uint64_t> ids(kFile, false);
+    state.ResumeTiming();
+    ids.sort([](const uint64_t& a, const uint64_t& b) { return a < b; }, 1024 * 1024 * 512 / 8,
+             state.range(1));
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * count * sizeof(uint64_t));
+  unlink(kFile.c_str());
+}
+
+// the billion id sort needs 8GB of disk and a while, so it only runs when asked for with
+// VALHALLA_BENCH_SEQUENCE_BILLION=1
+void Counts(benchmark::internal::Benchmark* b) {
+  std::vector<int64_t> counts{1 << 20, 1 << 24, 1 << 27};
+  if (std::getenv("VALHALLA_BENCH_SEQUENCE_BILLION")) {
+    counts.push_back(1000000000);
+  }
+  int64_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+  for (auto count : counts) {
+    b->Args({count, 1});
+    if (threads > 1) {
+      b->Args({count, threads});
+    }
+  }
+  b->ArgNames({"ids", "threads"});
+}
+
+BENCHMARK(BM_SequenceSort)->Apply(Counts)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "baldr/predictedspeeds.h"
+#include "mjolnir/predictedtraffic.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+// rows like the ones in the csvs, every one with a speed profile
+std::string make_rows(size_t count) {
+  std::vector<float> speeds(kBucketsPerWeek);
+  std::string rows;
+  for (size_t i = 0; i < count; ++i) {
+    for (size_t j = 0; j < speeds.size(); ++j) {
+      speeds[j] = 30 + (i + j / 12) % 60;
+    }
+    auto coefficients = compress_speed_buckets(speeds.data());
+    rows += "2/" + std::to_string(756425 + i % 100) + "/" + std::to_string(i) + "," +
+            std::to_string(40 + i % 50) + "," + std::to_string(20 + i % 30) + "," +
+            encode_compressed_speeds(coefficients.data()) + "\n";
+  }
+  return rows;
+}
+
+void BM_ParseRows(benchmark::State& state) {
+  const size_t count = 1000;
+  auto rows = make_rows(count);
+  TrafficRow row;
+  for (auto _ : state) {
+    for (const char *line = rows.data(), *end = line + rows.size(); line < end;) {
+      auto line_end = static_cast<const char*>(std::memchr(line, '\n', end - line));
+      benchmark::DoNotOptimize(row.Parse(line, line_end));
+      line = line_end + 1;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * rows.size());
+}
+BENCHMARK(BM_ParseRows);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+#include <string>
+
+#include "filesystem.h"
+#include "statistics.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+// statistics for as many tiles as an extract has, a few thousand for a country
+statistics make_statistics(size_t tile_count) {
+  statistics stats;
+  const std::vector<std::string> isos = {"DE", "NL", "BE", "FR", "AT", "CH", "PL", "CZ", "DK"};
+  for (size_t tile_id = 0; tile_id < tile_count; ++tile_id) {
+    const auto& iso = isos[tile_id % isos.size()];
+    for (auto rclass : rclasses) {
+      float length = 100.f + (tile_id * 31 + static_cast<size_t>(rclass)) % 1000;
+      stats.add_tile_road(tile_id, rclass, length);
+      stats.add_country_road(iso, rclass, length);
+      stats.add_tile_one_way(tile_id, rclass, length / 2);
+      stats.add_country_one_way(iso, rclass, length / 2);
+      stats.add_tile_speed_info(tile_id, rclass, length / 3);
+      stats.add_country_speed_info(iso, rclass, length / 3);
+      stats.add_tile_named(tile_id, rclass, length / 4);
+      stats.add_country_named(iso, rclass, length / 4);
+      stats.add_tile_int_edge(tile_id, rclass, tile_id % 7);
+      stats.add_country_int_edge(iso, rclass, tile_id % 7);
+      stats.add_tile_hazmat(tile_id, rclass, length / 5);
+      stats.add_tile_truck_route(tile_id, rclass, length / 6);
+      stats.add_tile_height(tile_id, rclass, tile_id % 3);
+      stats.add_tile_weight(tile_id, rclass, tile_id % 5);
+    }
+    stats.add_tile_area(tile_id, 600.f);
+    stats.add_tile_geom(tile_id, AABB2<PointLL>(PointLL(5.f, 50.f), PointLL(5.25f, 50.25f)));
+    stats.add_exitinfo(std::make_pair(static_cast<uint64_t>(tile_id), short(tile_id % 2)));
+    stats.add_fork_exitinfo(std::make_pair(static_cast<uint64_t>(tile_id), short(tile_id % 3 == 0)));
+    stats.add_exitinfo(std::make_pair(iso, short(tile_id % 2)));
+  }
+  return stats;
+}
+
+void BM_WriteColumns(benchmark::State& state) {
+  auto stats = make_statistics(state.range(0));
+  const std::string dir = "bench_statistics_columns";
+  for (auto _ : state) {
+    stats.build_columns(dir);
+  }
+  filesystem::remove_all(dir);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WriteColumns)->Arg(2000)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+void BM_WriteDatabase(benchmark::State& state) {
+  auto stats = make_statistics(state.range(0));
+  const std::string database = "bench_statistics.sqlite";
+  for (auto _ : state) {
+    stats.build_db(database);
+  }
+  filesystem::remove(database);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WriteDatabase)->Arg(2000)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "mjolnir/graph_lua_proc.h"
+#include "mjolnir/luatagtransform.h"
+#include "mjolnir/nativetagtransform.h"
+
+using namespace valhalla::mjolnir;
+
+namespace {
+
+const std::string kGraphLua(lua_graph_lua, lua_graph_lua + lua_graph_lua_len);
+
+// tags of the sort that are common in an extract
+const std::vector<Tags> kWays = {
+    {{"highway", "residential"}, {"name", "Oudegracht"}, {"surface", "paving_stones"}},
+    {{"highway", "primary"}, {"ref", "N230"}, {"maxspeed", "50"}, {"lanes", "2"}, {"oneway", "yes"}},
+    {{"highway", "footway"}, {"footway", "sidewalk"}},
+    {{"highway", "cycleway"}, {"segregated", "no"}, {"foot", "designated"}},
+    {{"highway", "service"}, {"service", "driveway"}, {"access", "private"}},
+};
+
+const std::vector<Tags> kNodes = {
+    {{"highway", "traffic_signals"}, {"traffic_signals:direction", "forward"}},
+    {{"highway", "crossing"}, {"crossing", "zebra"}},
+    {{"barrier", "gate"}, {"access", "private"}},
+    {{"barrier", "bollard"}, {"bicycle", "yes"}, {"foot", "yes"}},
+    {{"highway", "stop"}, {"direction", "forward"}},
+};
+
+const std::vector<Tags> kRelations = {
+    {{"type", "restriction"}, {"restriction", "no_left_turn"}},
+    {{"type", "restriction"}, {"restriction:conditional", "no_u_turn @ (Mo-Fr 07:00-09:00)"}},
+    {{"type", "route"}, {"route", "bicycle"}, {"network", "lcn"}, {"ref", "12"}},
+    {{"type", "route"}, {"route", "bus"}, {"name", "Bus 8"}},
+    {{"type", "multipolygon"}, {"landuse", "residential"}},
+    {{"type", "connectivity"}, {"connectivity", "1:1|2"}},
+};
+
+void BM_LuaWays(benchmark::State& state) {
+  LuaTagTransform lua(kGraphLua);
+  for (auto _ : state) {
+    for (const auto& tags : kWays) {
+      benchmark::DoNotOptimize(lua.Transform(OSMType::kWay, 1, tags));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kWays.size());
+}
+BENCHMARK(BM_LuaWays);
+
+void BM_NativeWays(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const auto& tags : kWays) {
+      benchmark::DoNotOptimize(NativeTagTransform::Transform(OSMType::kWay, tags));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kWays.size());
+}
+BENCHMARK(BM_NativeWays);
+
+void BM_LuaNodes(benchmark::State& state) {
+  LuaTagTransform lua(kGraphLua);
+  for (auto _ : state) {
+    for (const auto& tags : kNodes) {
+      benchmark::DoNotOptimize(lua.Transform(OSMType::kNode, 1, tags));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNodes.size());
+}
+BENCHMARK(BM_LuaNodes);
+
+void BM_NativeNodes(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const auto& tags : kNodes) {
+      benchmark::DoNotOptimize(NativeTagTransform::Transform(OSMType::kNode, tags));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNodes.size());
+}
+BENCHMARK(BM_NativeNodes);
+
+void BM_LuaRelations(benchmark::State& state) {
+  LuaTagTransform lua(kGraphLua);
+  for (auto _ : state) {
+    for (const auto& tags : kRelations) {
+      benchmark::DoNotOptimize(lua.Transform(OSMType::kRelation, 1, tags));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kRelations.size());
+}
+BENCHMARK(BM_LuaRelations);
+
+void BM_NativeRelations(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const auto& tags : kRelations) {
+      benchmark::DoNotOptimize(NativeTagTransform::Transform(OSMType::kRelation, tags));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kRelations.size());
+}
+BENCHMARK(BM_NativeRelations);
+
+} // namespace
+
+BENCHMARK_MAIN();
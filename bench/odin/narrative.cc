@@ -0,0 +1,104 @@
+#include <list>
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "baldr/verbal_text_formatter_factory.h"
+#include "odin/enhancedtrippath.h"
+#include "odin/maneuver.h"
+#include "odin/markup_formatter.h"
+#include "odin/narrative_builder_factory.h"
+#include "odin/narrativebuilder.h"
+#include "odin/util.h"
+
+#include "proto/directions.pb.h"
+#include "proto/options.pb.h"
+#include "proto/trip.pb.h"
+
+using namespace valhalla;
+using namespace valhalla::odin;
+
+namespace {
+
+constexpr size_t kManeuverCount = 500;
+
+// the kinds of maneuvers a long drive is made of, most of them turns and continues
+const DirectionsLeg_Maneuver_Type kTypes[] = {
+    DirectionsLeg_Maneuver_Type_kRight,           DirectionsLeg_Maneuver_Type_kContinue,
+    DirectionsLeg_Maneuver_Type_kLeft,            DirectionsLeg_Maneuver_Type_kSlightRight,
+    DirectionsLeg_Maneuver_Type_kBecomes,         DirectionsLeg_Maneuver_Type_kRampRight,
+    DirectionsLeg_Maneuver_Type_kMerge,           DirectionsLeg_Maneuver_Type_kStayLeft,
+    DirectionsLeg_Maneuver_Type_kExitRight,       DirectionsLeg_Maneuver_Type_kSharpLeft,
+    DirectionsLeg_Maneuver_Type_kRoundaboutEnter, DirectionsLeg_Maneuver_Type_kRoundaboutExit,
+    DirectionsLeg_Maneuver_Type_kUturnLeft,       DirectionsLeg_Maneuver_Type_kSlightLeft,
+};
+
+// a synthetic route starting and ending with the usual maneuvers and named streets and signs in
+// between so that every phrase has tags to fill in
+std::list<Maneuver> make_route() {
+  std::list<Maneuver> maneuvers;
+  for (size_t i = 0; i < kManeuverCount; ++i) {
+    maneuvers.emplace_back();
+    auto& maneuver = maneuvers.back();
+    maneuver.set_verbal_formatter(baldr::VerbalTextFormatterFactory::Create("US", "PA"));
+    if (i == 0) {
+      maneuver.set_type(DirectionsLeg_Maneuver_Type_kStart);
+    } else if (i + 1 == kManeuverCount) {
+      maneuver.set_type(DirectionsLeg_Maneuver_Type_kDestination);
+    } else {
+      maneuver.set_type(kTypes[i % (sizeof(kTypes) / sizeof(kTypes[0]))]);
+    }
+    auto street = std::to_string(i);
+    maneuver.set_street_names({{street + " Main Street", false}, {"US " + street, true}});
+    if (i % 3 == 0) {
+      maneuver.set_begin_street_names({{street + " Market Street", false}});
+    }
+    maneuver.set_begin_cardinal_direction(
+        static_cast<DirectionsLeg_Maneuver_CardinalDirection>(i % 8));
+    maneuver.set_length(0.1f + (i % 17) * 0.7f);
+    maneuver.set_time(10 + i % 60);
+    maneuver.set_roundabout_exit_count(1 + i % 4);
+    maneuver.set_to_stay_on(i % 2);
+    auto* signs = maneuver.mutable_signs();
+    signs->mutable_exit_number_list()->emplace_back(std::to_string(i % 90 + 1) + "A", false);
+    signs->mutable_exit_branch_list()->emplace_back("I " + street + " North", true);
+    signs->mutable_exit_toward_list()->emplace_back("Harrisburg", false);
+  }
+  return maneuvers;
+}
+
+// the first argument says whether to form the verbal instructions as well
+void BM_NarrativeAllLocales(benchmark::State& state) {
+  TripLeg leg;
+  leg.add_location()->set_name("Home");
+  leg.add_location()->set_name("Work");
+  EnhancedTripLeg etl(leg);
+  auto maneuvers = make_route();
+
+  // one builder per locale
+  std::list<Options> options;
+  std::list<std::unique_ptr<NarrativeBuilder>> builders;
+  for (const auto& locale : get_locales()) {
+    options.emplace_back();
+    options.back().set_language(locale.first);
+    options.back().set_verbal_instructions(state.range(0));
+    builders.emplace_back(NarrativeBuilderFactory::Create(options.back(), &etl, MarkupFormatter()));
+  }
+
+  for (auto _ : state) {
+    for (auto& builder : builders) {
+      builder->Build(maneuvers);
+    }
+    benchmark::DoNotOptimize(maneuvers.back().instruction());
+  }
+  state.counters["instructions"] =
+      benchmark::Counter(kManeuverCount * builders.size() * state.iterations(),
+                         benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_NarrativeAllLocales)->ArgName("verbal")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "baldr/transittimetable.h"
+#include "thor/connectionscan.h"
+
+using namespace valhalla;
+using namespace valhalla::baldr;
+using namespace valhalla::thor;
+
+namespace {
+
+// there are no gtfs feeds in the test data so this lays out a metro the way a feed of a big city
+// would: a grid of lines running both ways along every row and column, a stop where each crosses
+// another, a vehicle every few minutes from early in the morning until midnight and short walks
+// between neighbouring stops
+class ConnectionScanFixture : public benchmark::Fixture {
+public:
+  void SetUp(const ::benchmark::State& state) override {
+    const uint32_t size = state.range(0);
+    const uint32_t headway = state.range(1);
+    constexpr uint32_t kHop = 120, kFirst = 5 * 3600, kLast = 24 * 3600;
+    auto stop = [size](uint32_t row, uint32_t column) { return row * size + column; };
+
+    std::vector<TransitTimetable::stop_t> stops;
+    std::vector<std::vector<TransitTimetable::footpath_t>> footpaths(size * size);
+    for (uint32_t row = 0; row < size; ++row) {
+      for (uint32_t column = 0; column < size; ++column) {
+        stops.push_back({stop(row, column), 0, 0});
+        if (column + 1 < size) {
+          footpaths[stop(row, column)].push_back({stop(row, column + 1), 400, 500});
+          footpaths[stop(row, column + 1)].push_back({stop(row, column), 400, 500});
+        }
+      }
+    }
+
+    // each run of each line in each direction is its own trip
+    std::vector<TransitTimetable::connection_t> connections;
+    uint32_t trip = 0;
+    for (uint32_t line = 0; line < size * 4; ++line) {
+      auto index = line % size;
+      bool vertical = line / size % 2;
+      bool backwards = line / size / 2;
+      for (uint32_t start = kFirst + line % headway; start < kLast; start += headway, ++trip) {
+        for (uint32_t hop = 0; hop + 1 < size; ++hop) {
+          auto from = backwards ? size - 1 - hop : hop;
+          auto to = backwards ? from - 1 : from + 1;
+          auto from_stop = vertical ? stop(from, index) : stop(index, from);
+          auto to_stop = vertical ? stop(to, index) : stop(index, to);
+          connections.push_back({line, start + hop * kHop, start + (hop + 1) * kHop - 20,
+                                 from_stop, to_stop, trip, trip, 0,
+                                 TransitTimetable::kWheelchairAccessible});
+        }
+      }
+    }
+    connection_count_ = connections.size();
+
+    std::string file_name = "test/data/bench_connection_scan_timetable.bin";
+    TransitTimetable::Write(file_name, std::move(stops), {{~0ULL, 0x7f, 63, 0, 0}},
+                            std::move(connections), footpaths, trip);
+    timetable_ = std::make_shared<const TransitTimetable>(file_name);
+
+    // random trips across town during the day
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<uint32_t> pick_stop(0, size * size - 1);
+    std::uniform_int_distribution<uint32_t> pick_time(7 * 3600, 20 * 3600);
+    for (int i = 0; i < 64; ++i) {
+      queries_.push_back({pick_stop(gen), pick_stop(gen), pick_time(gen)});
+    }
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    queries_.clear();
+    timetable_.reset();
+  }
+
+  struct query_t {
+    uint32_t from;
+    uint32_t to;
+    uint32_t departure;
+  };
+
+  ConnectionScan::filter_t filter() const {
+    return {0, 1, 0, 805, 30};
+  }
+
+  std::shared_ptr<const TransitTimetable> timetable_;
+  std::vector<query_t> queries_;
+  size_t connection_count_;
+};
+
+BENCHMARK_DEFINE_F(ConnectionScanFixture, EarliestArrival)(benchmark::State& state) {
+  ConnectionScan scan(timetable_);
+  ConnectionScan::journey_t journey;
+  size_t found = 0;
+  for (auto _ : state) {
+    for (const auto& query : queries_) {
+      found += scan.EarliestArrival({{query.from, 60, 0}}, {{query.to, 60, 0}}, query.departure,
+                                    filter(), journey);
+    }
+  }
+  state.counters["connections"] = connection_count_;
+  state.counters["queries"] =
+      benchmark::Counter(queries_.size() * state.iterations(), benchmark::Counter::kIsRate);
+  state.counters["found"] = benchmark::Counter(found, benchmark::Counter::kAvgIterations);
+}
+
+// all of the journeys worth taking in the next hour
+BENCHMARK_DEFINE_F(ConnectionScanFixture, Range)(benchmark::State& state) {
+  ConnectionScan scan(timetable_);
+  size_t found = 0;
+  for (auto _ : state) {
+    for (const auto& query : queries_) {
+      found += scan.Range({{query.from, 60, 0}}, {{query.to, 60, 0}}, query.departure, 3600,
+                          filter(), 10)
+                   .size();
+    }
+  }
+  state.counters["connections"] = connection_count_;
+  state.counters["queries"] =
+      benchmark::Counter(queries_.size() * state.iterations(), benchmark::Counter::kIsRate);
+  state.counters["journeys"] = benchmark::Counter(found, benchmark::Counter::kAvgIterations);
+}
+
+// small town with a bus every quarter hour up to a metro with a train every 3 minutes
+BENCHMARK_REGISTER_F(ConnectionScanFixture, EarliestArrival)
+    ->Args({10, 900})
+    ->Args({30, 300})
+    ->Args({60, 180})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(ConnectionScanFixture, Range)
+    ->Args({10, 900})
+    ->Args({30, 300})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "baldr/graphtile.h"
+#include "thor/edgestatus.h"
+
+using namespace valhalla;
+using namespace valhalla::baldr;
+using namespace valhalla::thor;
+
+namespace {
+
+struct test_tile : public GraphTile {
+  using GraphTile::header_;
+};
+
+// Simulates the edge status bookkeeping of a number of back to back requests where each request
+// touches a random set of tiles of varying sizes. This is the allocation pattern a thor worker sees
+// under load
+class EdgeStatusFixture : public benchmark::Fixture {
+public:
+  void SetUp(const ::benchmark::State& state) override {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<uint32_t> edge_count(1000, 200000);
+    headers_.resize(256);
+    for (size_t i = 0; i < headers_.size(); ++i) {
+      headers_[i].set_directededgecount(edge_count(gen));
+      auto* tile = new test_tile;
+      tile->header_ = &headers_[i];
+      tiles_.emplace_back(tile);
+    }
+
+    // each request touches a different subset of tiles and edges
+    std::uniform_int_distribution<uint32_t> tile_index(0, headers_.size() - 1);
+    requests_.resize(64);
+    for (auto& request : requests_) {
+      for (int i = 0; i < state.range(0); ++i) {
+        auto t = tile_index(gen);
+        auto edge_id = gen() % headers_[t].directededgecount();
+        request.emplace_back(t, edge_id);
+      }
+    }
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    requests_.clear();
+    tiles_.clear();
+    headers_.clear();
+  }
+
+  void run_request(EdgeStatus& edgestatus, size_t r) {
+    uint32_t index = 0;
+    for (const auto& touched : requests_[r]) {
+      GraphId edge_id(touched.first, 2, touched.second);
+      edgestatus.Set(edge_id, EdgeSet::kTemporary, index++, tiles_[touched.first]);
+    }
+  }
+
+protected:
+  std::vector<GraphTileHeader> headers_;
+  std::vector<graph_tile_ptr> tiles_;
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> requests_;
+};
+
+// A new edge status for every request means all the memory comes from the system each time
+BENCHMARK_DEFINE_F(EdgeStatusFixture, FreshPerRequest)(benchmark::State& state) {
+  size_t r = 0, blocks = 0, requests = 0;
+  for (auto _ : state) {
+    EdgeStatus edgestatus;
+    run_request(edgestatus, r++ % requests_.size());
+    blocks += edgestatus.arena().block_allocations();
+    ++requests;
+  }
+  state.counters["system_allocations_per_request"] = static_cast<double>(blocks) / requests;
+}
+
+// Reusing the edge status between requests like the thor worker does
+BENCHMARK_DEFINE_F(EdgeStatusFixture, ReusedBetweenRequests)(benchmark::State& state) {
+  size_t r = 0, blocks = 0, requests = 0;
+  EdgeStatus edgestatus;
+  for (auto _ : state) {
+    run_request(edgestatus, r++ % requests_.size());
+    blocks += edgestatus.arena().block_allocations();
+    ++requests;
+    edgestatus.clear();
+  }
+  state.counters["system_allocations_per_request"] = static_cast<double>(blocks) / requests;
+}
+
+double p99(const std::vector<double>& v) {
+  auto sorted = v;
+  std::sort(sorted.begin(), sorted.end());
+  return sorted[static_cast<size_t>(0.99 * (sorted.size() - 1))];
+}
+
+BENCHMARK_REGISTER_F(EdgeStatusFixture, FreshPerRequest)
+    ->Arg(64)
+    ->Arg(1024)
+    ->Repetitions(20)
+    ->ComputeStatistics("p99", p99)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(EdgeStatusFixture, ReusedBetweenRequests)
+    ->Arg(64)
+    ->Arg(1024)
+    ->Repetitions(20)
+    ->ComputeStatistics("p99", p99)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -1,9 +1,11 @@
 #include <array>
 #include <benchmark/benchmark.h>
 #include <iostream>
+#include <memory>
 #include <random>
 #include <string>
 
+#include "baldr/edgereach.h"
 #include "baldr/graphreader.h"
 #include "loki/reach.h"
 #include "sif/costfactory.h"
@@ -47,6 +49,44 @@ void BM_ReachUtrecht(benchmark::State& state) {
 
 BENCHMARK(BM_ReachUtrecht)->Unit(benchmark::kMillisecond)->Repetitions(10);
 
+// The same but looking the reach up in the sidecar written by the reach build stage
+void BM_PrecomputedReachUtrecht(benchmark::State& state) {
+
+  const auto config =
+      test::make_config("test/data/utrecht_tiles", {},
+                        {{"additional_data", "mjolnir.traffic_extract", "mjolnir.tile_extract"}});
+
+  // get tile access
+  GraphReader reader(config.get_child("mjolnir"));
+
+  auto costing = sif::CostFactory{}.Create(Costing::auto_);
+  loki::Reach reach_finder;
+  reach_finder.set_precomputed(std::make_shared<const EdgeReach>(
+                                   GraphReader::FindSidecar(config.get_child("mjolnir"),
+                                                            EdgeReach::kFileName)),
+                               EdgeReach::Mode::kAuto);
+
+  using Edge = std::pair<GraphId, const DirectedEdge*>;
+  std::vector<Edge> edges;
+
+  for (auto tile_id : reader.GetTileSet()) {
+    auto tile = reader.GetGraphTile(tile_id);
+    for (GraphId edge_id = tile->header()->graphid();
+         edge_id.id() < tile->header()->directededgecount(); ++edge_id) {
+      const auto* edge = tile->directededge(edge_id);
+      edges.emplace_back(edge_id, edge);
+    }
+  }
+
+  for (auto _ : state) {
+    for (const auto& edge : edges) {
+      auto reach = reach_finder(edge.second, edge.first, 50, reader, costing, kInbound | kOutbound);
+    }
+  }
+}
+
+BENCHMARK(BM_PrecomputedReachUtrecht)->Unit(benchmark::kMillisecond)->Repetitions(10);
+
 } // namespace
 
 BENCHMARK_MAIN();
@@ -1,10 +1,14 @@
 #include <array>
+#include <atomic>
 #include <benchmark/benchmark.h>
+#include <chrono>
 #include <iostream>
 #include <random>
 #include <string>
+#include <thread>
 
 #include "baldr/graphreader.h"
+#include "baldr/traffictile.h"
 #include "loki/search.h"
 #include "midgard/logging.h"
 #include "midgard/pointll.h"
@@ -203,6 +207,147 @@ void customize_traffic(const boost::property_tree::ptree& config,
 
 BENCHMARK(BM_UtrechtBidirectionalAstar)->Unit(benchmark::kMillisecond);
 
+// Routes with a cold tile cache reading tiles from the tile_dir, the argument is the number of
+// background threads used to prefetch tiles along the search frontier (0 disables prefetching)
+static void BM_UtrechtColdCacheBidirectionalAstar(benchmark::State& state) {
+  const auto config =
+      test::make_config("test/data/utrecht_tiles",
+                        {{"mjolnir.tile_prefetch_threads", std::to_string(state.range(0))}},
+                        {"mjolnir.traffic_extract"});
+  auto reader = test::make_clean_graphreader(config.get_child("mjolnir"));
+
+  Options options;
+  create_costing_options(options);
+  sif::TravelMode mode;
+  auto costs = sif::CostFactory().CreateModeCosting(options, mode);
+  auto cost = costs[static_cast<size_t>(mode)];
+
+  // Some longer routes across Utrecht so that the search crosses tile borders
+  std::vector<valhalla::baldr::Location> locations{midgard::PointLL{5.025595, 52.067372},
+                                                   midgard::PointLL{5.135983, 52.110116},
+                                                   midgard::PointLL{5.110077, 52.062043},
+                                                   midgard::PointLL{5.095273, 52.108956}};
+  const auto projections = loki::Search(locations, *reader, cost);
+  std::vector<valhalla::Location> pbf_locations;
+  for (const auto& location : locations) {
+    auto found = projections.find(location);
+    if (found == projections.cend()) {
+      throw std::runtime_error("Found no matching locations");
+    }
+    pbf_locations.emplace_back();
+    baldr::PathLocation::toPBF(found->second, &pbf_locations.back(), *reader);
+  }
+
+  thor::BidirectionalAStar astar;
+  for (auto _ : state) {
+    for (size_t i = 0; i < pbf_locations.size(); i += 2) {
+      reader->Clear();
+      auto result = astar.GetBestPath(pbf_locations[i], pbf_locations[i + 1], *reader, costs,
+                                      sif::TravelMode::kDrive);
+      astar.Clear();
+    }
+  }
+
+  auto stats = reader->GetPrefetchStats();
+  state.counters["prefetch_requested"] = stats.requested;
+  state.counters["prefetch_collected"] = stats.collected;
+  state.counters["prefetch_hits"] = stats.hits;
+  state.counters["prefetch_waits"] = stats.waits;
+  state.counters["prefetch_misses"] = stats.misses;
+}
+
+BENCHMARK(BM_UtrechtColdCacheBidirectionalAstar)
+    ->Unit(benchmark::kMillisecond)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(4);
+
+// Routes while live traffic is published into double buffered traffic tiles underneath them, the
+// argument is the number of updates per second (0 disables them). Like the service each route pins
+// a snapshot of the live traffic so it sees the same speeds from start to finish
+static void BM_UtrechtLiveTrafficUpdates(benchmark::State& state) {
+  const auto config = build_config("generated-double-buffered-live-data.tar");
+  test::build_live_traffic_data(config, baldr::TRAFFIC_TILE_VERSION, true);
+
+  // a fifth of the edges get a random live speed in every update
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<> traffic_dist(0., 1.);
+  auto generate_traffic = [&gen, &traffic_dist](baldr::GraphReader&, baldr::TrafficTile&, int,
+                                                baldr::TrafficSpeed* current) -> void {
+    *current = {};
+    if (traffic_dist(gen) < 0.2) {
+      current->breakpoint1 = 255;
+      current->overall_encoded_speed = traffic_dist(gen) * 100;
+    }
+  };
+  test::customize_live_traffic_data(config, generate_traffic);
+
+  auto reader = test::make_clean_graphreader(config.get_child("mjolnir"));
+  Options options;
+  create_costing_options(options);
+  sif::TravelMode mode;
+  auto costs = sif::CostFactory().CreateModeCosting(options, mode);
+  auto cost = costs[static_cast<size_t>(mode)];
+
+  std::vector<valhalla::baldr::Location> locations{midgard::PointLL{5.025595, 52.067372},
+                                                   midgard::PointLL{5.135983, 52.110116},
+                                                   midgard::PointLL{5.110077, 52.062043},
+                                                   midgard::PointLL{5.095273, 52.108956}};
+  const auto projections = loki::Search(locations, *reader, cost);
+  std::vector<valhalla::Location> pbf_locations;
+  for (const auto& location : locations) {
+    auto found = projections.find(location);
+    if (found == projections.cend()) {
+      throw std::runtime_error("Found no matching locations");
+    }
+    pbf_locations.emplace_back();
+    baldr::PathLocation::toPBF(found->second, &pbf_locations.back(), *reader);
+  }
+
+  // publish updates in the background at the requested rate
+  std::atomic<bool> done{false};
+  size_t updates = 0;
+  std::thread updater([&]() {
+    if (state.range(0) == 0) {
+      return;
+    }
+    auto period = std::chrono::microseconds(1000000 / state.range(0));
+    auto next = std::chrono::steady_clock::now() + period;
+    while (!done) {
+      if (std::chrono::steady_clock::now() >= next) {
+        test::customize_live_traffic_data(config, generate_traffic);
+        ++updates;
+        next += period;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  });
+
+  thor::BidirectionalAStar astar;
+  size_t routes = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < pbf_locations.size(); i += 2) {
+      baldr::TrafficSnapshot snapshot;
+      auto result = astar.GetBestPath(pbf_locations[i], pbf_locations[i + 1], *reader, costs,
+                                      sif::TravelMode::kDrive);
+      astar.Clear();
+      ++routes;
+    }
+  }
+
+  done = true;
+  updater.join();
+  state.counters["routes"] = benchmark::Counter(routes, benchmark::Counter::kIsRate);
+  state.counters["updates"] = updates;
+}
+
+BENCHMARK(BM_UtrechtLiveTrafficUpdates)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->MinTime(5.0)
+    ->Arg(0)
+    ->Arg(1);
+
 /*
  * A set of fixed random routes across the globe.  Taken from test_requests/random.txt
  */
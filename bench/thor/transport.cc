@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+
+#include "loki/worker.h"
+#include "thor/worker.h"
+#include "worker.h"
+
+#include "test.h"
+
+using namespace valhalla;
+
+namespace {
+
+// the same as the default httpd.service.arena_block_size
+constexpr size_t kArenaBlockSize = 1024 * 1024;
+
+const std::string kLocations =
+    R"([{"lat":52.099247,"lon":5.115873},{"lat":52.101841,"lon":5.114576},)"
+    R"({"lat":52.074073,"lon":5.112481},{"lat":52.110116,"lon":5.135983},)"
+    R"({"lat":52.108956,"lon":5.095273}])";
+
+boost::property_tree::ptree config() {
+  return test::make_config("test/data/utrecht_tiles", {},
+                           {{"additional_data", "mjolnir.traffic_extract", "mjolnir.tile_extract"}});
+}
+
+// what loki forwards to thor for a route and what thor then forwards to odin
+const std::pair<Api, Api>& route_requests() {
+  static const std::pair<Api, Api> requests = []() {
+    auto conf = config();
+    loki::loki_worker_t loki_worker(conf);
+    thor::thor_worker_t thor_worker(conf);
+    std::pair<Api, Api> requests;
+    ParseApi(R"({"costing":"auto","locations":)" + kLocations + "}", Options::route,
+             requests.first);
+    loki_worker.route(requests.first);
+    requests.second.CopyFrom(requests.first);
+    thor_worker.route(requests.second);
+    return requests;
+  }();
+  return requests;
+}
+
+// what loki forwards to thor for a matrix, thor answers those itself
+const Api& matrix_request() {
+  static const Api request = []() {
+    auto conf = config();
+    loki::loki_worker_t loki_worker(conf);
+    Api request;
+    ParseApi(R"({"costing":"auto","sources":)" + kLocations + R"(,"targets":)" + kLocations + "}",
+             Options::sources_to_targets, request);
+    loki_worker.matrix(request);
+    return request;
+  }();
+  return request;
+}
+
+// one hop the way the workers do it, serialize what the last stage made and parse it into an arena
+// on the other side. the argument is whether to prune the request for the next stage first
+void hop(benchmark::State& state, Api request, Stage next) {
+  if (state.range(0)) {
+    prune_for(next, request);
+  }
+  std::unique_ptr<char[]> block(new char[kArenaBlockSize]);
+  google::protobuf::ArenaOptions options;
+  options.initial_block = block.get();
+  options.initial_block_size = kArenaBlockSize;
+  size_t bytes = 0;
+  for (auto _ : state) {
+    auto message = request.SerializeAsString();
+    google::protobuf::Arena arena(options);
+    auto* parsed = google::protobuf::Arena::CreateMessage<Api>(&arena);
+    if (!parsed->ParseFromArray(message.data(), message.size())) {
+      state.SkipWithError("failed to parse the request");
+      break;
+    }
+    bytes = message.size();
+  }
+  state.counters["message_bytes"] = bytes;
+  state.SetBytesProcessed(bytes * state.iterations());
+}
+
+void BM_RouteLokiToThor(benchmark::State& state) {
+  hop(state, route_requests().first, Stage::kThor);
+}
+
+void BM_RouteThorToOdin(benchmark::State& state) {
+  hop(state, route_requests().second, Stage::kOdin);
+}
+
+void BM_MatrixLokiToThor(benchmark::State& state) {
+  hop(state, matrix_request(), Stage::kThor);
+}
+
+BENCHMARK(BM_RouteLokiToThor)->ArgName("pruned")->Arg(0)->Arg(1);
+BENCHMARK(BM_RouteThorToOdin)->ArgName("pruned")->Arg(0)->Arg(1);
+BENCHMARK(BM_MatrixLokiToThor)->ArgName("pruned")->Arg(0)->Arg(1);
+
+} // namespace
+
+BENCHMARK_MAIN();
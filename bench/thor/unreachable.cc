@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "baldr/componentlabels.h"
+#include "baldr/graphreader.h"
+#include "baldr/pathlocation.h"
+#include "sif/costfactory.h"
+#include "test.h"
+#include "thor/bidirectional_astar.h"
+#include <valhalla/proto/options.pb.h>
+
+using namespace valhalla;
+using namespace valhalla::baldr;
+
+namespace {
+
+// Pairs of locations in utrecht which the component labels know cant reach each other. This is
+// what loki rejects up front now and what thor had to explore until it ran out of graph before
+class UnreachableFixture : public benchmark::Fixture {
+public:
+  void SetUp(const ::benchmark::State& state) override {
+    config_ = test::make_config("test/data/utrecht_tiles", {},
+                                {{"additional_data", "mjolnir.traffic_extract",
+                                  "mjolnir.tile_extract"}});
+    reader_.reset(new GraphReader(config_.get_child("mjolnir")));
+    labels_.reset(new ComponentLabels(config_.get<std::string>("mjolnir.tile_dir") + "/" +
+                                      ComponentLabels::kFileName));
+
+    Options options;
+    options.set_costing_type(Costing::auto_);
+    rapidjson::Document doc;
+    sif::ParseCosting(doc, "/costing_options", options);
+    costs_ = sif::CostFactory().CreateModeCosting(options, mode_);
+    const auto& cost = costs_[static_cast<size_t>(mode_)];
+
+    // every edge we could start or end a route on
+    std::vector<GraphId> edges;
+    for (const auto& tile_id : reader_->GetTileSet(TileHierarchy::levels().back().level)) {
+      auto tile = reader_->GetGraphTile(tile_id);
+      for (GraphId edge_id = tile->header()->graphid();
+           edge_id.id() < tile->header()->directededgecount(); ++edge_id) {
+        const auto* edge = tile->directededge(edge_id);
+        if (!edge->is_shortcut() && cost->Allowed(edge, tile)) {
+          edges.push_back(edge_id);
+        }
+      }
+    }
+
+    // randomly pair them up until we have enough that cant reach each other
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<size_t> pick(0, edges.size() - 1);
+    for (size_t tries = 0; tries < 1000000 && origins_.size() < 16; ++tries) {
+      auto from = edges[pick(gen)];
+      auto to = edges[pick(gen)];
+      auto from_node = reader_->directededge(from)->endnode();
+      auto to_node = reader_->edge_startnode(to);
+      if (from != to && !labels_->MayReach(from_node, to_node, ComponentLabels::kAuto)) {
+        origins_.push_back(location(from));
+        destinations_.push_back(location(to));
+      }
+    }
+    if (origins_.empty()) {
+      throw std::runtime_error("Found no unreachable pairs");
+    }
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    origins_.clear();
+    destinations_.clear();
+    labels_.reset();
+    reader_.reset();
+  }
+
+  // a location half way along the edge
+  valhalla::Location location(const GraphId& edge_id) {
+    auto node = reader_->edge_startnode(edge_id);
+    auto ll = reader_->GetGraphTile(node)->get_node_ll(node);
+    PathLocation path_location{Location(ll)};
+    path_location.edges.emplace_back(edge_id, 0.5, ll, 0);
+    valhalla::Location pbf;
+    PathLocation::toPBF(path_location, &pbf, *reader_);
+    return pbf;
+  }
+
+  boost::property_tree::ptree config_;
+  std::unique_ptr<GraphReader> reader_;
+  std::unique_ptr<ComponentLabels> labels_;
+  sif::mode_costing_t costs_;
+  sif::TravelMode mode_;
+  std::vector<valhalla::Location> origins_;
+  std::vector<valhalla::Location> destinations_;
+};
+
+// what loki does now, look up the labels of the edges end points
+BENCHMARK_DEFINE_F(UnreachableFixture, ComponentLabels)(benchmark::State& state) {
+  size_t rejected = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < origins_.size(); ++i) {
+      GraphId from_id(origins_[i].correlation().edges(0).graph_id());
+      GraphId to_id(destinations_[i].correlation().edges(0).graph_id());
+      auto from_node = reader_->directededge(from_id)->endnode();
+      auto to_node = reader_->edge_startnode(to_id);
+      rejected += !labels_->MayReach(from_node, to_node, ComponentLabels::kAuto);
+    }
+  }
+  state.counters["pairs"] = origins_.size();
+  state.counters["rejected"] = benchmark::Counter(rejected, benchmark::Counter::kAvgIterations);
+}
+
+// what thor had to do before, search until there is nothing left to search
+BENCHMARK_DEFINE_F(UnreachableFixture, BidirectionalAStar)(benchmark::State& state) {
+  thor::BidirectionalAStar astar;
+  size_t failed = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < origins_.size(); ++i) {
+      failed += astar.GetBestPath(origins_[i], destinations_[i], *reader_, costs_, mode_).empty();
+      astar.Clear();
+    }
+  }
+  state.counters["pairs"] = origins_.size();
+  state.counters["failed"] = benchmark::Counter(failed, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_REGISTER_F(UnreachableFixture, ComponentLabels)->Unit(benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(UnreachableFixture, BidirectionalAStar)->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#include "baldr/componentlabels.h"
+
+namespace valhalla {
+namespace baldr {
+
+constexpr uint16_t ComponentLabels::kModeAccess[];
+
+ComponentLabels::ComponentLabels(const std::string& file_name)
+    : header_(nullptr), tiles_(nullptr), labels_(nullptr), islands_{} {
+  struct stat s;
+  if (stat(file_name.c_str(), &s) != 0 || static_cast<size_t>(s.st_size) < sizeof(header_t)) {
+    throw std::runtime_error(file_name + " is not a component label file");
+  }
+  memory_.map_readonly(file_name, s.st_size);
+
+  // make sure its what we think it is and that all of the parts are there
+  header_ = reinterpret_cast<const header_t*>(memory_.get());
+  if (header_->magic != kMagic || header_->version != kVersion ||
+      header_->mode_count != kModeCount) {
+    throw std::runtime_error(file_name + " is not a compatible component label file");
+  }
+  uint64_t size = sizeof(header_t) + header_->tile_count * sizeof(tile_t) +
+                  header_->node_count * kModeCount * sizeof(uint32_t);
+  for (auto count : header_->island_count) {
+    size += count * sizeof(uint32_t);
+  }
+  if (size != memory_.size()) {
+    throw std::runtime_error(file_name + " is truncated");
+  }
+
+  // point at the various parts
+  tiles_ = reinterpret_cast<const tile_t*>(memory_.get() + sizeof(header_t));
+  labels_ = reinterpret_cast<const uint32_t*>(tiles_ + header_->tile_count);
+  islands_[0] = labels_ + header_->node_count * kModeCount;
+  for (int mode = 1; mode < kModeCount; ++mode) {
+    islands_[mode] = islands_[mode - 1] + header_->island_count[mode - 1];
+  }
+}
+
+bool ComponentLabels::mode_for_access(uint32_t access_mask, Mode& mode) {
+  // the labels only prove something cant be reached if the mode was labelled on a superset of the
+  // edges the costing may use
+  auto covers = [access_mask](uint16_t mode_access) {
+    return access_mask && !(access_mask & ~static_cast<uint32_t>(mode_access));
+  };
+  auto found = std::find_if(std::begin(kModeAccess), std::end(kModeAccess), covers);
+  if (found == std::end(kModeAccess)) {
+    return false;
+  }
+  mode = static_cast<Mode>(found - std::begin(kModeAccess));
+  return true;
+}
+
+size_t ComponentLabels::tile_index(const GraphId& tile_id) const {
+  const auto key = tile_id.Tile_Base().value;
+  auto found = std::lower_bound(tiles_, tiles_ + header_->tile_count, key,
+                                [](const tile_t& tile, uint64_t key) { return tile.tile_id < key; });
+  if (found == tiles_ + header_->tile_count || found->tile_id != key) {
+    return header_->tile_count;
+  }
+  return found - tiles_;
+}
+
+uint32_t ComponentLabels::node_count(const GraphId& tile_id) const {
+  auto index = tile_index(tile_id);
+  if (index == header_->tile_count) {
+    return 0;
+  }
+  auto end = index + 1 < header_->tile_count ? tiles_[index + 1].node_offset : header_->node_count;
+  return end - tiles_[index].node_offset;
+}
+
+uint32_t ComponentLabels::label(const GraphId& node, Mode mode) const {
+  auto index = tile_index(node);
+  if (index == header_->tile_count) {
+    return kUnknownLabel;
+  }
+  auto offset = tiles_[index].node_offset + node.id();
+  auto end = index + 1 < header_->tile_count ? tiles_[index + 1].node_offset : header_->node_count;
+  return offset < end ? labels_[mode * header_->node_count + offset] : kUnknownLabel;
+}
+
+uint32_t ComponentLabels::island(uint32_t label, Mode mode) const {
+  // islands are stored by the first label in them so we want the last one not after this label
+  const auto* begin = islands_[mode];
+  const auto* end = begin + header_->island_count[mode];
+  return std::upper_bound(begin, end, label) - begin - 1;
+}
+
+bool ComponentLabels::MayReach(const GraphId& from, const GraphId& to, Mode mode) const {
+  auto from_label = label(from, mode);
+  auto to_label = label(to, mode);
+  if (from_label == kUnknownLabel || to_label == kUnknownLabel || from_label == to_label) {
+    return true;
+  }
+
+  // different islands are never connected and within an island components only reach the ones
+  // that were finished before them
+  return island(from_label, mode) == island(to_label, mode) && to_label < from_label;
+}
+
+} // namespace baldr
+} // namespace valhalla
@@ -1,5 +1,14 @@
 #include "baldr/compression_utils.h"
 
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#ifdef HAVE_ZSTD
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
 namespace valhalla {
 namespace baldr {
 
@@ -121,5 +130,185 @@ bool inflate(const std::function<void(z_stream&)>& src_func,
   return true;
 }
 
+#ifdef HAVE_ZSTD
+
+namespace {
+
+struct dctx_deleter_t {
+  void operator()(ZSTD_DCtx* context) const {
+    ZSTD_freeDCtx(context);
+  }
+};
+
+struct cctx_deleter_t {
+  void operator()(ZSTD_CCtx* context) const {
+    ZSTD_freeCCtx(context);
+  }
+};
+
+// contexts hold on to their buffers so each thread keeps one around rather than making a new one
+// every time, which would allocate and free a few hundred kilobytes per tile
+ZSTD_DCtx* decompression_context() {
+  thread_local std::unique_ptr<ZSTD_DCtx, dctx_deleter_t> context(ZSTD_createDCtx());
+  return context.get();
+}
+
+ZSTD_CCtx* compression_context() {
+  thread_local std::unique_ptr<ZSTD_CCtx, cctx_deleter_t> context(ZSTD_createCCtx());
+  return context.get();
+}
+
+} // namespace
+
+struct ZstdDictionary::pimpl_t {
+  ~pimpl_t() {
+    ZSTD_freeDDict(ddict);
+    ZSTD_freeCDict(cdict);
+  }
+  ZSTD_DDict* ddict = nullptr;
+  ZSTD_CDict* cdict = nullptr;
+  uint32_t id = 0;
+  int level = 0;
+};
+
+bool zstd_supported() {
+  return true;
+}
+
+ZstdDictionary::ZstdDictionary(const std::vector<char>& dictionary, int level)
+    : pimpl(new pimpl_t()) {
+  pimpl->id = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+  if (pimpl->id == 0) {
+    throw std::runtime_error("Not a zstd dictionary");
+  }
+  pimpl->level = level;
+  pimpl->ddict = ZSTD_createDDict(dictionary.data(), dictionary.size());
+  if (level > 0) {
+    pimpl->cdict = ZSTD_createCDict(dictionary.data(), dictionary.size(), level);
+  }
+  if (!pimpl->ddict || (level > 0 && !pimpl->cdict)) {
+    throw std::runtime_error("Could not load zstd dictionary");
+  }
+}
+
+ZstdDictionary::~ZstdDictionary() = default;
+
+std::vector<char> ZstdDictionary::Train(const std::vector<char>& samples,
+                                        const std::vector<size_t>& sizes,
+                                        size_t capacity) {
+  if (std::accumulate(sizes.begin(), sizes.end(), size_t(0)) != samples.size()) {
+    throw std::runtime_error("Sample sizes do not add up to the samples");
+  }
+  std::vector<char> dictionary(capacity);
+  auto size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samples.data(),
+                                    sizes.data(), static_cast<unsigned>(sizes.size()));
+  if (ZDICT_isError(size)) {
+    throw std::runtime_error(std::string("Could not train zstd dictionary: ") +
+                             ZDICT_getErrorName(size));
+  }
+  dictionary.resize(size);
+  return dictionary;
+}
+
+uint32_t ZstdDictionary::id() const {
+  return pimpl->id;
+}
+
+int ZstdDictionary::level() const {
+  return pimpl->level;
+}
+
+bool zstd_compress(const char* src,
+                   size_t size,
+                   std::vector<char>& dst,
+                   int level,
+                   const ZstdDictionary* dictionary) {
+  // it has to have been prepared for compressing
+  if (dictionary && !dictionary->pimpl->cdict) {
+    return false;
+  }
+
+  auto* context = compression_context();
+  dst.resize(ZSTD_compressBound(size));
+  auto compressed_size =
+      dictionary ? ZSTD_compress_usingCDict(context, dst.data(), dst.size(), src, size,
+                                            dictionary->pimpl->cdict)
+                 : ZSTD_compressCCtx(context, dst.data(), dst.size(), src, size, level);
+  if (ZSTD_isError(compressed_size)) {
+    dst.clear();
+    return false;
+  }
+  dst.resize(compressed_size);
+  return true;
+}
+
+bool zstd_decompress(const char* src,
+                     size_t size,
+                     std::vector<char>& dst,
+                     const ZstdDictionary* dictionary) {
+  // we only ever write frames that say how big they are
+  auto content_size = ZSTD_getFrameContentSize(src, size);
+  if (content_size == ZSTD_CONTENTSIZE_ERROR || content_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+    return false;
+  }
+
+  auto* context = decompression_context();
+  dst.resize(content_size);
+  auto decompressed_size =
+      dictionary ? ZSTD_decompress_usingDDict(context, dst.data(), dst.size(), src, size,
+                                              dictionary->pimpl->ddict)
+                 : ZSTD_decompressDCtx(context, dst.data(), dst.size(), src, size);
+  if (ZSTD_isError(decompressed_size) || decompressed_size != dst.size()) {
+    dst.clear();
+    return false;
+  }
+  return true;
+}
+
+uint32_t zstd_dictionary_id(const char* src, size_t size) {
+  return ZSTD_getDictID_fromFrame(src, size);
+}
+
+#else
+
+struct ZstdDictionary::pimpl_t {};
+
+bool zstd_supported() {
+  return false;
+}
+
+ZstdDictionary::ZstdDictionary(const std::vector<char>&, int) {
+  throw std::runtime_error("Valhalla was built without zstd support");
+}
+
+ZstdDictionary::~ZstdDictionary() = default;
+
+std::vector<char>
+ZstdDictionary::Train(const std::vector<char>&, const std::vector<size_t>&, size_t) {
+  throw std::runtime_error("Valhalla was built without zstd support");
+}
+
+uint32_t ZstdDictionary::id() const {
+  return 0;
+}
+
+int ZstdDictionary::level() const {
+  return 0;
+}
+
+bool zstd_compress(const char*, size_t, std::vector<char>&, int, const ZstdDictionary*) {
+  return false;
+}
+
+bool zstd_decompress(const char*, size_t, std::vector<char>&, const ZstdDictionary*) {
+  return false;
+}
+
+uint32_t zstd_dictionary_id(const char*, size_t) {
+  return 0;
+}
+
+#endif
+
 } // namespace baldr
-} // namespace valhalla
\ No newline at end of file
+} // namespace valhalla
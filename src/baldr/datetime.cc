@@ -1,5 +1,8 @@
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -41,6 +44,13 @@ from_cache(const TP& tp,
   infos.emplace_back(tp.get_info());
   return infos.back();
 }
+
+// the local time of a moment in a timezone without going through the tz db when we can help it
+date::local_seconds to_local(const uint64_t seconds, const date::time_zone* time_zone) {
+  auto offset = valhalla::baldr::DateTime::get_tz_transitions().offset(time_zone, seconds);
+  return date::local_seconds(std::chrono::seconds(static_cast<int64_t>(seconds) + offset));
+}
+
 } // namespace
 
 using namespace valhalla::baldr;
@@ -64,6 +74,14 @@ size_t tz_db_t::to_index(const std::string& zone) const {
   return it->second;
 }
 
+size_t tz_db_t::to_index(const date::time_zone* zone) const {
+  // the zones are stored contiguously so we can work out the index from the address
+  if (!zone || db.zones.empty() || zone < &db.zones.front() || zone > &db.zones.back()) {
+    return 0;
+  }
+  return zone - &db.zones.front() + 1;
+}
+
 const date::time_zone* tz_db_t::from_index(size_t index) const {
   if (index < 1 || index > db.zones.size()) {
     return nullptr;
@@ -76,6 +94,106 @@ const tz_db_t& get_tz_db() {
   return tz_db;
 }
 
+constexpr int64_t tz_transitions_t::kBegin;
+constexpr int64_t tz_transitions_t::kEnd;
+
+tz_transitions_t::tz_transitions_t(const tz_db_t& tz_db) : tz_db(tz_db) {
+  // walk each zone from one transition to the next, only keeping the ones that change the offset
+  const date::sys_seconds end{std::chrono::seconds(kEnd)};
+  zones.emplace_back();
+  for (size_t index = 1; const auto* tz = tz_db.from_index(index); ++index) {
+    zones.emplace_back();
+    auto& zone = zones.back();
+    date::sys_seconds time{std::chrono::seconds(kBegin)};
+    while (time < end) {
+      auto info = tz->get_info(time);
+      auto offset = static_cast<int32_t>(info.offset.count());
+      if (zone.offsets.empty() || zone.offsets.back() != offset) {
+        zone.begins.push_back(time.time_since_epoch().count());
+        zone.offsets.push_back(offset);
+      }
+      if (info.end <= time) {
+        break;
+      }
+      time = info.end;
+    }
+  }
+}
+
+size_t tz_transitions_t::find(const zone_t& zone, int64_t seconds) {
+  return std::upper_bound(zone.begins.cbegin(), zone.begins.cend(), seconds) -
+         zone.begins.cbegin() - 1;
+}
+
+int32_t tz_transitions_t::offset(size_t zone, uint64_t seconds) const {
+  if (zone < 1 || zone >= zones.size()) {
+    // tiles built with a newer tz db can have zones we dont, like no zone they get no offset
+    static std::atomic<bool> warned{false};
+    if (zone >= zones.size() && !warned.exchange(true)) {
+      LOG_WARN("Timezone index " + std::to_string(zone) + " is not in the tz db, using UTC");
+    }
+    return 0;
+  }
+
+  // outside of the table we have to ask the tz db
+  auto time = static_cast<int64_t>(seconds);
+  if (time < kBegin || time >= kEnd) {
+    date::sys_seconds tp{std::chrono::seconds(time)};
+    return static_cast<int32_t>(tz_db.from_index(zone)->get_info(tp).offset.count());
+  }
+  const auto& transitions = zones[zone];
+  return transitions.offsets[find(transitions, time)];
+}
+
+int32_t tz_transitions_t::offset(const date::time_zone* zone, uint64_t seconds) const {
+  if (!zone) {
+    return 0;
+  }
+
+  // a zone from some other copy of the tz db has no index in ours, it still has an offset though
+  auto index = tz_db.to_index(zone);
+  if (index == 0) {
+    date::sys_seconds tp{std::chrono::seconds(static_cast<int64_t>(seconds))};
+    return static_cast<int32_t>(zone->get_info(tp).offset.count());
+  }
+  return offset(index, seconds);
+}
+
+void tz_transitions_t::offsets(const uint64_t* seconds,
+                               const uint32_t* zones,
+                               size_t count,
+                               int32_t* offsets) const {
+  // the transition we found last and the range of time it covers
+  size_t last_zone = 0;
+  int64_t begin = 0, end = 0;
+  int32_t last_offset = 0;
+  for (size_t i = 0; i < count; ++i) {
+    auto time = static_cast<int64_t>(seconds[i]);
+    if (zones[i] == last_zone && begin <= time && time < end) {
+      offsets[i] = last_offset;
+      continue;
+    }
+
+    // outside of the table or in a zone we dont know there is nothing to remember
+    if (zones[i] < 1 || zones[i] >= this->zones.size() || time < kBegin || time >= kEnd) {
+      offsets[i] = offset(zones[i], seconds[i]);
+      last_zone = 0;
+      continue;
+    }
+    const auto& zone = this->zones[zones[i]];
+    auto index = find(zone, time);
+    last_zone = zones[i];
+    begin = zone.begins[index];
+    end = index + 1 < zone.begins.size() ? zone.begins[index + 1] : kEnd;
+    last_offset = offsets[i] = zone.offsets[index];
+  }
+}
+
+const tz_transitions_t& get_tz_transitions() {
+  static const tz_transitions_t tz_transitions(get_tz_db());
+  return tz_transitions;
+}
+
 // get a formatted date.  date in the format of 2016-11-06T01:00 or 2016-11-06
 date::local_seconds get_formatted_date(const std::string& date, bool can_throw) {
   std::istringstream in{date};
@@ -144,6 +262,13 @@ int timezone_diff(const uint64_t seconds,
   if (!origin_tz || !dest_tz || origin_tz == dest_tz) {
     return 0;
   }
+
+  // within the table its just the difference of the two offsets
+  auto time = static_cast<int64_t>(seconds);
+  if (tz_transitions_t::kBegin <= time && time < tz_transitions_t::kEnd) {
+    const auto& transitions = get_tz_transitions();
+    return transitions.offset(dest_tz, seconds) - transitions.offset(origin_tz, seconds);
+  }
   std::chrono::seconds dur(seconds);
   std::chrono::time_point<std::chrono::system_clock> tp(dur);
 
@@ -174,18 +299,16 @@ seconds_to_date(const uint64_t seconds, const date::time_zone* time_zone, bool t
     return iso_date;
   }
 
-  std::chrono::seconds dur(seconds);
-  std::chrono::time_point<std::chrono::system_clock> tp(dur);
-  const auto date = date::make_zoned(time_zone, tp);
-
-  std::ostringstream iso_date_time;
-  if (tz_format)
-    iso_date_time << date::format("%FT%R%z", date);
-  else
-    iso_date_time << date::format("%FT%R", date);
-  iso_date = iso_date_time.str();
-  if (tz_format)
-    iso_date.insert(19, 1, ':');
+  auto offset = get_tz_transitions().offset(time_zone, seconds);
+  date::local_seconds local(std::chrono::seconds(static_cast<int64_t>(seconds) + offset));
+  iso_date = date::format("%FT%R", local);
+  if (tz_format) {
+    auto minutes = std::abs(offset) / 60;
+    char tz_offset[8];
+    snprintf(tz_offset, sizeof(tz_offset), "%c%02d:%02d", offset < 0 ? '-' : '+', minutes / 60,
+             minutes % 60);
+    iso_date += tz_offset;
+  }
   return iso_date;
 }
 
@@ -288,15 +411,12 @@ bool is_conditional_active(const bool type,
   std::chrono::minutes b_td = std::chrono::hours(0);
   std::chrono::minutes e_td = std::chrono::hours(23) + std::chrono::minutes(59);
 
-  std::chrono::seconds dur(current_time);
-  std::chrono::time_point<std::chrono::system_clock> tp(dur);
-
   uint32_t e_year = 0, b_year = 0;
-  const auto in_local_time = date::make_zoned(time_zone, tp);
-  auto date = date::floor<date::days>(in_local_time.get_local_time());
+  const auto in_local_time = to_local(current_time, time_zone);
+  auto date = date::floor<date::days>(in_local_time);
   auto d = date::year_month_day(date);
-  auto t = date::make_time(in_local_time.get_local_time() - date); // Yields time_of_day type
-  std::chrono::minutes td = t.hours() + t.minutes();               // Yields time_of_day type
+  auto t = date::make_time(in_local_time - date);    // Yields time_of_day type
+  std::chrono::minutes td = t.hours() + t.minutes(); // Yields time_of_day type
 
   try {
     date::year_month_day begin_date, end_date;
@@ -517,9 +637,7 @@ bool is_conditional_active(const bool type,
 
 uint32_t second_of_week(uint32_t epoch_time, const date::time_zone* time_zone) {
   // get the date time in this timezone
-  std::chrono::seconds dur(epoch_time);
-  std::chrono::time_point<std::chrono::system_clock> utp(dur);
-  const auto tp = date::make_zoned(time_zone, utp).get_local_time();
+  const auto tp = to_local(epoch_time, time_zone);
   // floor to midnight of that day
   auto days = date::floor<date::days>(tp);
   // get the ordinal day of the week
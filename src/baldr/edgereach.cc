@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#include "baldr/edgereach.h"
+
+namespace valhalla {
+namespace baldr {
+
+EdgeReach::EdgeReach(const std::string& file_name)
+    : header_(nullptr), tiles_(nullptr), reach_(nullptr) {
+  struct stat s;
+  if (stat(file_name.c_str(), &s) != 0 || static_cast<size_t>(s.st_size) < sizeof(header_t)) {
+    throw std::runtime_error(file_name + " is not an edge reach file");
+  }
+  memory_.map_readonly(file_name, s.st_size);
+
+  // make sure its what we think it is and that all of the parts are there
+  header_ = reinterpret_cast<const header_t*>(memory_.get());
+  if (header_->magic != kMagic || header_->version != kVersion ||
+      header_->mode_count != ComponentLabels::kModeCount) {
+    throw std::runtime_error(file_name + " is not a compatible edge reach file");
+  }
+  if (sizeof(header_t) + header_->tile_count * sizeof(tile_t) +
+          header_->edge_count * ComponentLabels::kModeCount * sizeof(reach_t) !=
+      memory_.size()) {
+    throw std::runtime_error(file_name + " is truncated");
+  }
+
+  // point at the various parts
+  tiles_ = reinterpret_cast<const tile_t*>(memory_.get() + sizeof(header_t));
+  reach_ = reinterpret_cast<const reach_t*>(tiles_ + header_->tile_count);
+}
+
+size_t EdgeReach::tile_index(const GraphId& tile_id) const {
+  const auto key = tile_id.Tile_Base().value;
+  auto found = std::lower_bound(tiles_, tiles_ + header_->tile_count, key,
+                                [](const tile_t& tile, uint64_t key) { return tile.tile_id < key; });
+  if (found == tiles_ + header_->tile_count || found->tile_id != key) {
+    return header_->tile_count;
+  }
+  return found - tiles_;
+}
+
+uint32_t EdgeReach::edge_count(const GraphId& tile_id) const {
+  auto index = tile_index(tile_id);
+  if (index == header_->tile_count) {
+    return 0;
+  }
+  auto end = index + 1 < header_->tile_count ? tiles_[index + 1].edge_offset : header_->edge_count;
+  return end - tiles_[index].edge_offset;
+}
+
+bool EdgeReach::Get(const GraphId& edge_id,
+                    Mode mode,
+                    uint32_t& outbound,
+                    uint32_t& inbound) const {
+  auto index = tile_index(edge_id);
+  if (index == header_->tile_count) {
+    return false;
+  }
+  auto offset = tiles_[index].edge_offset + edge_id.id();
+  auto end = index + 1 < header_->tile_count ? tiles_[index + 1].edge_offset : header_->edge_count;
+  if (offset >= end) {
+    return false;
+  }
+  const auto& reach = reach_[mode * header_->edge_count + offset];
+  outbound = reach.outbound;
+  inbound = reach.inbound;
+  return true;
+}
+
+} // namespace baldr
+} // namespace valhalla
@@ -1,7 +1,11 @@
+#include <atomic>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <set>
 #include <string>
 #include <sys/stat.h>
+#include <thread>
 #include <utility>
 
 #include "baldr/connectivity_map.h"
@@ -17,9 +21,13 @@ using namespace valhalla::midgard;
 
 namespace {
 
-constexpr size_t DEFAULT_MAX_CACHE_SIZE = 1073741824; // 1 gig
-constexpr size_t AVERAGE_TILE_SIZE = 2097152;         // 2 megs
-constexpr size_t AVERAGE_MM_TILE_SIZE = 1024;         // 1k
+constexpr size_t DEFAULT_MAX_CACHE_SIZE = 1073741824;       // 1 gig
+constexpr size_t AVERAGE_TILE_SIZE = 2097152;               // 2 megs
+constexpr size_t AVERAGE_MM_TILE_SIZE = 1024;               // 1k
+constexpr size_t DEFAULT_SHARED_CACHE_SIZE = 4294967296;    // 4 gigs
+constexpr size_t DEFAULT_SHARED_SHORTCUT_SIZE = 1073741824; // 1 gig
+// recovered shortcuts are shared through a segment named after the shared tile cache
+constexpr char kSharedShortcutsSuffix[] = ".shortcuts";
 
 struct tile_index_entry {
   uint64_t offset;  // byte offset from the beginning of the tar
@@ -151,6 +159,8 @@ GraphReader::tile_extract_t::tile_extract_t(const boost::property_tree::ptree& p
       else {
         LOG_INFO("Traffic tile extract successfully loaded with tile count: " +
                  std::to_string(traffic_tiles.size()));
+        // double buffered traffic is only flipped once an update is published for all the tiles
+        TrafficEpochs::Set(TrafficEpochs::Open(pt.get<std::string>("traffic_extract")));
         if (traffic_archive->corrupt_blocks) {
           LOG_WARN("Traffic tile extract had " + std::to_string(traffic_archive->corrupt_blocks) +
                    " corrupt blocks");
@@ -427,8 +437,102 @@ graph_tile_ptr SynchronizedTileCache::Put(const GraphId& graphid, graph_tile_ptr
   return cache_.Put(graphid, std::move(tile), size);
 }
 
+// ----------------------------------------------------------------------------
+// SharedTileCache implementation
+// ----------------------------------------------------------------------------
+
+namespace {
+
+// tile memory that lives in a shared segment, keeps the segment mapped while the tile is in use
+class SharedGraphMemory final : public GraphMemory {
+public:
+  SharedGraphMemory(std::shared_ptr<SharedTileSegment> segment, std::pair<char*, size_t> position)
+      : segment_(std::move(segment)) {
+    data = position.first;
+    size = position.second;
+  }
+
+private:
+  const std::shared_ptr<SharedTileSegment> segment_;
+};
+
+} // namespace
+
+SharedTileCache::SharedTileCache(std::shared_ptr<SharedTileSegment> segment,
+                                 size_t max_size,
+                                 memory_loader_t traffic_loader)
+    : segment_(std::move(segment)), traffic_loader_(std::move(traffic_loader)), cache_size_(0),
+      max_cache_size_(max_size) {
+}
+
+// Reserves enough cache to hold (max_cache_size / tile_size) items.
+void SharedTileCache::Reserve(size_t tile_size) {
+  cache_.reserve(max_cache_size_ / tile_size);
+}
+
+// Checks if tile exists in the cache.
+bool SharedTileCache::Contains(const GraphId& graphid) const {
+  return cache_.find(graphid) != cache_.end() || segment_->Find(graphid).first != nullptr;
+}
+
+// Lets you know if the cache is too large.
+bool SharedTileCache::OverCommitted() const {
+  return cache_size_ > max_cache_size_;
+}
+
+// Clears the cache.
+void SharedTileCache::Clear() {
+  cache_size_ = 0;
+  cache_.clear();
+}
+
+// Get a pointer to a graph tile object given a GraphId.
+graph_tile_ptr SharedTileCache::Get(const GraphId& graphid) const {
+  auto cached = cache_.find(graphid);
+  if (cached != cache_.end()) {
+    return cached->second;
+  }
+
+  // maybe another process already loaded it
+  auto bytes = segment_->Find(graphid);
+  if (bytes.first == nullptr) {
+    return nullptr;
+  }
+  cache_size_ += sizeof(GraphTile);
+  return cache_.emplace(graphid, Wrap(graphid, bytes)).first->second;
+}
+
+// Puts a copy of a tile of into the cache.
+graph_tile_ptr SharedTileCache::Put(const GraphId& graphid, graph_tile_ptr tile, size_t size) {
+  // publish it unless someone beat us to it, either way we can drop our private copy
+  auto bytes = segment_->Find(graphid);
+  if (bytes.first == nullptr && tile && tile->header()) {
+    bytes = segment_->Publish(graphid, reinterpret_cast<const char*>(tile->header()),
+                              tile->header()->end_offset());
+  }
+  if (bytes.first != nullptr) {
+    tile = Wrap(graphid, bytes);
+    size = sizeof(GraphTile);
+  }
+
+  cache_size_ += size;
+  return cache_.emplace(graphid, std::move(tile)).first->second;
+}
+
+void SharedTileCache::Trim() {
+  Clear();
+}
+
+graph_tile_ptr SharedTileCache::Wrap(const GraphId& graphid,
+                                     const std::pair<char*, size_t>& bytes) const {
+  return GraphTile::Create(graphid, std::make_unique<SharedGraphMemory>(segment_, bytes),
+                           traffic_loader_ ? traffic_loader_(graphid) : nullptr);
+}
+
 // Constructs tile cache.
-TileCache* TileCacheFactory::createTileCache(const boost::property_tree::ptree& pt) {
+TileCache* TileCacheFactory::createTileCache(const boost::property_tree::ptree& pt,
+                                             std::shared_ptr<SharedTileSegment> shared_segment,
+                                             SharedTileCache::memory_loader_t traffic_loader) {
   size_t max_cache_size = pt.get<size_t>("max_cache_size", DEFAULT_MAX_CACHE_SIZE);
 
   bool use_lru_cache = pt.get<bool>("use_lru_mem_cache", false);
@@ -447,7 +551,10 @@ TileCache* TileCacheFactory::createTileCache(const boost::property_tree::ptree&
     static std::mutex factoryMutex;
     std::lock_guard<std::mutex> lock(factoryMutex);
     if (!globalTileCache_) {
-      if (use_lru_cache) {
+      if (shared_segment) {
+        globalTileCache_.reset(new SharedTileCache(std::move(shared_segment), max_cache_size,
+                                                   std::move(traffic_loader)));
+      } else if (use_lru_cache) {
         globalTileCache_.reset(new TileCacheLRU(max_cache_size, lru_mem_control));
       } else {
         // globalTileCache_.reset(new SimpleTileCache(max_cache_size));
@@ -457,6 +564,11 @@ TileCache* TileCacheFactory::createTileCache(const boost::property_tree::ptree&
     return new SynchronizedTileCache(*globalTileCache_, globalCacheMutex_);
   }
 
+  // share the tiles with other processes
+  if (shared_segment) {
+    return new SharedTileCache(std::move(shared_segment), max_cache_size, std::move(traffic_loader));
+  }
+
   // or do you want to use an LRU cache
   if (use_lru_cache) {
     return new TileCacheLRU(max_cache_size, lru_mem_control);
@@ -471,14 +583,46 @@ TileCache* TileCacheFactory::createTileCache(const boost::property_tree::ptree&
   return new FlatTileCache(max_cache_size);
 }
 
+class TarballGraphMemory final : public GraphMemory {
+public:
+  TarballGraphMemory(std::shared_ptr<midgard::tar> archive, std::pair<char*, size_t> position)
+      : archive_(std::move(archive)) {
+    data = position.first;
+    size = position.second;
+  }
+
+private:
+  const std::shared_ptr<midgard::tar> archive_;
+};
+
 // Constructor using separate tile files
 GraphReader::GraphReader(const boost::property_tree::ptree& pt,
                          std::unique_ptr<tile_getter_t>&& tile_getter)
     : tile_extract_(new tile_extract_t(pt)),
       tile_dir_(tile_extract_->tiles.empty() ? pt.get<std::string>("tile_dir", "") : ""),
+      tileset_id_(0),
       tile_getter_(std::move(tile_getter)),
       max_concurrent_users_(pt.get<size_t>("max_concurrent_reader_users", 1)),
-      tile_url_(pt.get<std::string>("tile_url", "")), cache_(TileCacheFactory::createTileCache(pt)) {
+      tile_url_(pt.get<std::string>("tile_url", "")),
+      shared_segment_(
+          tile_extract_->tiles.empty() && !pt.get<std::string>("shared_tile_cache", "").empty()
+              ? SharedTileSegment::Get(pt.get<std::string>("shared_tile_cache"),
+                                       pt.get<size_t>("shared_tile_cache_size",
+                                                      DEFAULT_SHARED_CACHE_SIZE),
+                                       GetTilesetId())
+              : nullptr),
+      cache_(TileCacheFactory::createTileCache(
+          pt,
+          shared_segment_,
+          [extract = tile_extract_](const GraphId& base) -> std::unique_ptr<const GraphMemory> {
+            auto traffic_ptr = extract->traffic_tiles.find(base);
+            if (traffic_ptr == extract->traffic_tiles.end()) {
+              return nullptr;
+            }
+            return std::make_unique<TarballGraphMemory>(extract->traffic_archive,
+                                                        traffic_ptr->second);
+          })),
+      prefetch_margin_(pt.get<float>("tile_prefetch_margin", 0.1f)) {
 
   // Make a tile fetcher if we havent passed one in from somewhere else
   if (!tile_getter_ && !tile_url_.empty()) {
@@ -495,6 +639,25 @@ GraphReader::GraphReader(const boost::property_tree::ptree& pt,
   // mmap'd file
   cache_->Reserve(tile_extract_->tiles.empty() ? AVERAGE_TILE_SIZE : AVERAGE_MM_TILE_SIZE);
 
+  // Load tiles from disk on background threads ahead of the path algorithms if configured to. With
+  // an mmapped extract there is nothing to gain since no reading or inflating happens
+  auto prefetch_threads = pt.get<size_t>("tile_prefetch_threads", 0);
+  if (prefetch_threads && tile_extract_->tiles.empty() && !tile_dir_.empty()) {
+    auto loader = [tile_dir = tile_dir_,
+                   extract = tile_extract_](const GraphId& base) -> graph_tile_ptr {
+      auto traffic_ptr = extract->traffic_tiles.find(base);
+      auto traffic_memory = traffic_ptr != extract->traffic_tiles.end()
+                                ? std::make_unique<TarballGraphMemory>(extract->traffic_archive,
+                                                                       traffic_ptr->second)
+                                : nullptr;
+      graph_tile_ptr tile = GraphTile::Create(tile_dir, base, std::move(traffic_memory));
+      return tile && tile->header() ? tile : graph_tile_ptr{};
+    };
+    prefetcher_ =
+        std::make_unique<TilePrefetcher>(prefetch_threads,
+                                         pt.get<size_t>("tile_prefetch_max_pending", 64), loader);
+  }
+
   // Initialize the incident cache singleton if we have any kind of configuration to do so. if the
   // configuration is wrong or any kind of problem occurs this throws. the call below will spawn a
   // single background thread which is responsible for loading incidents continually
@@ -506,9 +669,19 @@ GraphReader::GraphReader(const boost::property_tree::ptree& pt,
                                                            : GetTileSet());
   }
 
-  // Fill shortcut recovery cache if requested or by default in memmap mode
+  // Fill shortcut recovery cache if requested or by default in memmap mode. The recovered shortcuts
+  // are shared with other processes whenever tiles are, this includes an mmapped extract since the
+  // recovered shortcuts, unlike its tiles, arent in the page cache
   if (pt.get<bool>("shortcut_caching", false)) {
-    shortcut_recovery_t::get_instance(this);
+    auto shared_name = pt.get<std::string>("shared_tile_cache", "");
+    if (!shared_name.empty()) {
+      shared_shortcut_segment_ =
+          SharedTileSegment::Get(shared_name + kSharedShortcutsSuffix,
+                                 pt.get<size_t>("shared_shortcut_cache_size",
+                                                DEFAULT_SHARED_SHORTCUT_SIZE),
+                                 GetTilesetId());
+    }
+    shortcut_recovery_t::get_instance(this, shared_shortcut_segment_);
   }
 }
 
@@ -531,21 +704,10 @@ bool GraphReader::DoesTileExist(const GraphId& graphid) const {
       tile_dir_ + filesystem::path::preferred_separator + GraphTile::FileSuffix(graphid.Tile_Base());
   struct stat buffer;
   return stat(file_location.c_str(), &buffer) == 0 ||
-         stat((file_location + ".gz").c_str(), &buffer) == 0;
+         stat((file_location + ".gz").c_str(), &buffer) == 0 ||
+         stat((file_location + ".zst").c_str(), &buffer) == 0;
 }
 
-class TarballGraphMemory final : public GraphMemory {
-public:
-  TarballGraphMemory(std::shared_ptr<midgard::tar> archive, std::pair<char*, size_t> position)
-      : archive_(std::move(archive)) {
-    data = position.first;
-    size = position.second;
-  }
-
-private:
-  const std::shared_ptr<midgard::tar> archive_;
-};
-
 // Get a pointer to a graph tile object given a GraphId. Return nullptr
 // if the tile is not found/empty
 graph_tile_ptr GraphReader::GetGraphTile(const GraphId& graphid) {
@@ -563,6 +725,20 @@ graph_tile_ptr GraphReader::GetGraphTile(const GraphId& graphid) {
     return cached;
   }
 
+  // Maybe it was already loaded in the background
+  graph_tile_ptr tile = prefetcher_ ? prefetcher_->Take(base) : nullptr;
+
+  // If not we have to go get it
+  if (!tile && !(tile = LoadTile(base))) {
+    return nullptr;
+  }
+
+  // Keep a copy in the cache and return it
+  const size_t size = CacheSize(tile);
+  return cache_->Put(base, std::move(tile), size);
+}
+
+graph_tile_ptr GraphReader::LoadTile(const GraphId& base) {
   // Try getting it from the memmapped tar extract
   if (!tile_extract_->tiles.empty()) {
     // Do we have this tile
@@ -586,10 +762,7 @@ graph_tile_ptr GraphReader::GetGraphTile(const GraphId& graphid) {
       return nullptr;
     }
     // LOG_DEBUG("Memory map cache hit " + GraphTile::FileSuffix(base));
-
-    // Keep a copy in the cache and return it
-    const size_t size = AVERAGE_MM_TILE_SIZE; // tile.end_offset();  // TODO what size??
-    return cache_->Put(base, std::move(tile), size);
+    return tile;
   } // Try getting it from flat file
   else {
     auto traffic_ptr = tile_extract_->traffic_tiles.find(base);
@@ -625,10 +798,123 @@ graph_tile_ptr GraphReader::GetGraphTile(const GraphId& graphid) {
     } else {
       // LOG_DEBUG("Disk cache hit " + GraphTile::FileSuffix(base));
     }
+    return tile;
+  }
+}
 
-    // Keep a copy in the cache and return it
-    const size_t size = tile->header()->end_offset();
-    return cache_->Put(base, std::move(tile), size);
+size_t GraphReader::CacheSize(const graph_tile_ptr& tile) const {
+  // TODO: what size for mmapped tiles?? tile.end_offset()?
+  return tile_extract_->tiles.empty() ? tile->header()->end_offset() : AVERAGE_MM_TILE_SIZE;
+}
+
+size_t GraphReader::Preload(const std::vector<GraphId>& tile_ids, size_t concurrency) {
+  // skip whatever we already have
+  std::vector<GraphId> todo;
+  todo.reserve(tile_ids.size());
+  for (const auto& tile_id : tile_ids) {
+    if (tile_id.Is_Valid() && !cache_->Contains(tile_id.Tile_Base())) {
+      todo.push_back(tile_id.Tile_Base());
+    }
+  }
+
+  // the caches arent thread safe (unless its the global one) so we guard all access to them
+  std::mutex cache_lock;
+  std::atomic<size_t> next(0);
+  std::atomic<size_t> loaded(0);
+  std::atomic<bool> full(false);
+  auto work = [&]() {
+    for (size_t i = next++; i < todo.size() && !full; i = next++) {
+      // the expensive part, reading and inflating, happens in parallel
+      auto tile = LoadTile(todo[i]);
+      if (!tile) {
+        continue;
+      }
+      const size_t size = CacheSize(tile);
+
+      // then we hand the tile to the cache, the last reference held by this thread must be dropped
+      // while holding the lock because the reference count may not be thread safe
+      std::lock_guard<std::mutex> lock(cache_lock);
+      cache_->Put(todo[i], std::move(tile), size);
+      ++loaded;
+      // no sense in loading more than fits, it would just evict what we already loaded
+      if (cache_->OverCommitted()) {
+        full = true;
+      }
+    }
+  };
+
+  // spread the work out over some threads, this thread does some of it too. if we might need to go
+  // to the tile_url we cant have more threads than the tile getter allows
+  if (tile_getter_) {
+    concurrency = std::min(concurrency, max_concurrent_users_);
+  }
+  concurrency = std::max<size_t>(1, std::min(concurrency, todo.size()));
+  std::vector<std::thread> threads;
+  threads.reserve(concurrency - 1);
+  for (size_t i = 1; i < concurrency; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (full) {
+    LOG_WARN("Tile cache is full, stopped preloading after " + std::to_string(loaded) + " of " +
+             std::to_string(todo.size()) + " tiles");
+  }
+  return loaded;
+}
+
+size_t GraphReader::Preload(const midgard::AABB2<midgard::PointLL>& bbox, size_t concurrency) {
+  return Preload(TileHierarchy::GetGraphIds(bbox), concurrency);
+}
+
+size_t GraphReader::Preload(const uint8_t level, size_t concurrency) {
+  auto tile_set = GetTileSet(level);
+  return Preload(std::vector<GraphId>(tile_set.begin(), tile_set.end()), concurrency);
+}
+
+void GraphReader::PrefetchTile(const GraphId& base) {
+  // move whatever finished loading into the cache
+  prefetcher_->Collect([this](const GraphId& id, graph_tile_ptr&& tile) {
+    if (!cache_->Contains(id)) {
+      const size_t size = tile->header()->end_offset();
+      cache_->Put(id, std::move(tile), size);
+    }
+  });
+
+  // and ask for this one if we dont have it yet
+  if (!cache_->Contains(base)) {
+    prefetcher_->Prefetch(base);
+  }
+}
+
+void GraphReader::PrefetchNeighborTiles(const GraphId& node, const midgard::PointLL& ll) {
+  // find the range of tiles within the margin around the node
+  const auto& tiles = TileHierarchy::get_tiling(node.level());
+  const float margin = tiles.TileSize() * prefetch_margin_;
+  auto min_col = tiles.Col(ll.lng() - margin);
+  auto max_col = tiles.Col(ll.lng() + margin);
+  auto min_row = tiles.Row(ll.lat() - margin);
+  auto max_row = tiles.Row(ll.lat() + margin);
+
+  // the common case is that the node isnt near any border
+  if (min_col == max_col && min_row == max_row) {
+    return;
+  }
+
+  // otherwise we ask for the tiles across the border(s)
+  for (auto row = min_row; row <= max_row; ++row) {
+    for (auto col = min_col; col <= max_col; ++col) {
+      if (row < 0 || col < 0) {
+        continue;
+      }
+      GraphId tile_id(tiles.TileId(col, row), node.level(), 0);
+      if (tile_id.tileid() != node.tileid()) {
+        PrefetchTile(tile_id);
+      }
+    }
   }
 }
 
@@ -892,6 +1178,75 @@ std::unordered_set<GraphId> GraphReader::GetTileSet() const {
   return tiles;
 }
 
+// Identify the tiles by the headers of the level 0 tiles
+uint64_t GraphReader::GetTilesetId() const {
+  auto id = tileset_id_.load(std::memory_order_acquire);
+  if (id) {
+    return id;
+  }
+
+  // fnv-1a over the header of every level 0 tile in tile id order
+  id = 14695981039346656037ull;
+  auto hash = [&id](const char* bytes, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      id = (id ^ static_cast<unsigned char>(bytes[i])) * 1099511628211ull;
+    }
+  };
+  const uint8_t level = TileHierarchy::levels().front().level;
+  if (tile_extract_->tiles.size()) {
+    std::map<uint64_t, std::pair<char*, size_t>> tiles;
+    for (const auto& t : tile_extract_->tiles) {
+      if (static_cast<GraphId>(t.first).level() == level) {
+        tiles.emplace(t.first, t.second);
+      }
+    }
+    for (const auto& t : tiles) {
+      hash(t.second.first, std::min(t.second.second, sizeof(GraphTileHeader)));
+    }
+  } else if (!tile_dir_.empty()) {
+    // the files could be compressed, their first bytes identify them just as well
+    auto level_tiles = GetTileSet(level);
+    std::set<GraphId> tiles(level_tiles.begin(), level_tiles.end());
+    std::vector<char> header(sizeof(GraphTileHeader));
+    for (const auto& tile_id : tiles) {
+      auto path = tile_dir_ + filesystem::path::preferred_separator + GraphTile::FileSuffix(tile_id);
+      for (const auto& suffix : {"", ".gz", ".zst"}) {
+        std::ifstream file(path + suffix, std::ios::binary);
+        if (file.is_open()) {
+          file.read(header.data(), header.size());
+          hash(header.data(), file.gcount());
+          break;
+        }
+      }
+    }
+  }
+
+  // 0 means we havent looked yet
+  id = std::max<uint64_t>(id, 1);
+  tileset_id_.store(id, std::memory_order_release);
+  return id;
+}
+
+// Look for a sidecar in the tile_dir and then next to the extract
+std::string GraphReader::FindSidecar(const boost::property_tree::ptree& pt,
+                                     const std::string& file_name) {
+  std::vector<std::string> dirs;
+  if (auto tile_dir = pt.get_optional<std::string>("tile_dir")) {
+    dirs.push_back(*tile_dir);
+  }
+  if (auto extract = pt.get_optional<std::string>("tile_extract")) {
+    auto dir = filesystem::path(*extract).parent_path().string();
+    dirs.push_back(dir.empty() ? "." : dir);
+  }
+  for (const auto& dir : dirs) {
+    auto path = dir + filesystem::path::preferred_separator + file_name;
+    if (!dir.empty() && filesystem::exists(path)) {
+      return path;
+    }
+  }
+  return "";
+}
+
 // Get the set of tiles for a specified level
 std::unordered_set<GraphId> GraphReader::GetTileSet(const uint8_t level) const {
   // either mmap'd tiles
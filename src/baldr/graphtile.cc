@@ -10,6 +10,7 @@
 #include "midgard/tiles.h"
 
 #include <boost/algorithm/string.hpp>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstdio>
@@ -19,8 +20,10 @@
 #include <iomanip>
 #include <iostream>
 #include <locale>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -38,6 +41,64 @@ std::string MakeSingleTileUrl(const std::string& tile_url, const valhalla::baldr
          tile_url.substr(id_pos + std::strlen(valhalla::baldr::GraphTile::kTilePathPattern));
 }
 
+// the dictionary that zstd tiles of a level were compressed with. each is loaded once and kept
+// around, unless the one on disk has changed since. finding it is on the path of every tile load
+// so it is a lock free look at the level's slot, only loading a dictionary takes the lock
+struct zstd_dictionary_entry_t {
+  std::string tile_dir;
+  std::shared_ptr<const valhalla::baldr::ZstdDictionary> dictionary;
+};
+
+std::shared_ptr<const valhalla::baldr::ZstdDictionary>
+ZstdDictionaryFor(const std::string& tile_dir, uint8_t level, uint32_t id) {
+  static std::atomic<const zstd_dictionary_entry_t*> slots[valhalla::baldr::kMaxGraphHierarchy + 1];
+  auto matches = [&tile_dir, id](const zstd_dictionary_entry_t* entry) {
+    return entry && entry->dictionary->id() == id && entry->tile_dir == tile_dir;
+  };
+  if (level > valhalla::baldr::kMaxGraphHierarchy) {
+    return nullptr;
+  }
+  auto& slot = slots[level];
+  const auto* entry = slot.load(std::memory_order_acquire);
+  if (matches(entry)) {
+    return entry->dictionary;
+  }
+
+  // another thread may have loaded it while we waited. readers can still be looking at the entry
+  // that gets replaced so none are ever freed, there is one per dictionary that was loaded
+  static std::mutex mutex;
+  static std::vector<std::unique_ptr<const zstd_dictionary_entry_t>> entries;
+  std::lock_guard<std::mutex> lock(mutex);
+  entry = slot.load(std::memory_order_acquire);
+  if (matches(entry)) {
+    return entry->dictionary;
+  }
+
+  auto path = tile_dir + filesystem::path::preferred_separator + std::to_string(level) +
+              filesystem::path::preferred_separator + valhalla::baldr::ZSTD_DICTIONARY;
+  std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    return nullptr;
+  }
+  std::vector<char> bytes(file.tellg());
+  file.seekg(0, std::ios::beg);
+  file.read(bytes.data(), bytes.size());
+  std::shared_ptr<const valhalla::baldr::ZstdDictionary> dictionary;
+  try {
+    dictionary = std::make_shared<const valhalla::baldr::ZstdDictionary>(bytes);
+  } catch (const std::exception& e) {
+    LOG_ERROR(path + ": " + e.what());
+    return nullptr;
+  }
+  if (dictionary->id() != id) {
+    return nullptr;
+  }
+
+  entries.emplace_back(new zstd_dictionary_entry_t{tile_dir, dictionary});
+  slot.store(entries.back().get(), std::memory_order_release);
+  return dictionary;
+}
+
 // the point of this function is to avoid race conditions for writing a tile between threads
 // so the easiest thing to do is just use the thread id to differentiate
 std::string GenerateTmpSuffix() {
@@ -147,6 +208,30 @@ graph_tile_ptr GraphTile::Create(const std::string& tile_dir,
     return DecompressTile(graphid, std::move(compressed));
   }
 
+  // Try to load a zstd compressed tile
+  std::ifstream zst_file(file_location + ".zst", std::ios::in | std::ios::binary | std::ios::ate);
+  if (zst_file.is_open()) {
+    size_t filesize = zst_file.tellg();
+    zst_file.seekg(0, std::ios::beg);
+    std::vector<char> compressed(filesize);
+    zst_file.read(compressed.data(), filesize);
+    zst_file.close();
+
+    // it may need the dictionary of its level
+    auto dictionary_id = zstd_dictionary_id(compressed.data(), compressed.size());
+    auto dictionary =
+        dictionary_id ? ZstdDictionaryFor(tile_dir, graphid.level(), dictionary_id) : nullptr;
+    std::vector<char> data;
+    if ((dictionary_id && !dictionary) ||
+        !zstd_decompress(compressed.data(), compressed.size(), data, dictionary.get())) {
+      LOG_ERROR("Failed to decompress " + file_location + ".zst");
+      return nullptr;
+    }
+    return graph_tile_ptr{new GraphTile(graphid,
+                                        std::make_unique<const VectorGraphMemory>(std::move(data)),
+                                        std::move(traffic_memory))};
+  }
+
   // Nothing to load anywhere
   return nullptr;
 }
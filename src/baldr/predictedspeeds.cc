@@ -1,5 +1,8 @@
 #include "baldr/predictedspeeds.h"
 
+#include <stdexcept>
+#include <string>
+
 namespace valhalla {
 namespace baldr {
 
@@ -97,21 +100,52 @@ std::string encode_compressed_speeds(const int16_t* coefficients) {
 }
 
 std::array<int16_t, kCoefficientCount> decode_compressed_speeds(const std::string& encoded) {
-  const std::string& decoded_str = midgard::decode64(encoded);
-  if (decoded_str.size() != kDecodedSpeedSize) {
-    throw std::runtime_error(
-        "Decoded speed string size expected= " + std::to_string(kDecodedSpeedSize) +
-        " actual=" + std::to_string(decoded_str.size()));
-  }
-  const int8_t* raw = reinterpret_cast<const int8_t*>(decoded_str.data());
-  // Create the coefficients. Each group of 2 bytes represents a signed, int16 number
-  // (big endian). Convert to little endian.
   std::array<int16_t, kCoefficientCount> coefficients;
-  for (uint32_t i = 0, idx = 0; i < kCoefficientCount; ++i, idx += 2) {
-    coefficients[i] = midgard::to_little_endian(*(reinterpret_cast<const uint16_t*>(&raw[idx])));
+  if (!decode_compressed_speeds(encoded.data(), encoded.size(), coefficients.data())) {
+    throw std::runtime_error("Invalid base64 encoded speeds of length " +
+                             std::to_string(encoded.size()) + ", expected " +
+                             std::to_string(kDecodedSpeedSize) + " bytes once decoded");
   }
   return coefficients;
 }
 
+bool decode_compressed_speeds(const char* encoded, size_t size, int16_t* coefficients) {
+  // the value of each base64 character or -1 if its not one
+  static const auto kValues = []() {
+    std::array<int8_t, 256> values;
+    values.fill(-1);
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (int8_t i = 0; i < 64; ++i) {
+      values[static_cast<uint8_t>(alphabet[i])] = i;
+    }
+    return values;
+  }();
+
+  // padding is optional, without it 400 bytes are 534 characters
+  while (size > 0 && encoded[size - 1] == '=') {
+    --size;
+  }
+  if (size != (kDecodedSpeedSize * 4 + 2) / 3) {
+    return false;
+  }
+
+  // Each group of 2 bytes represents a signed, int16 number (big endian). Convert to little endian.
+  uint32_t bits = 0, bit_count = 0, byte_count = 0;
+  for (size_t i = 0; i < size; ++i) {
+    auto value = kValues[static_cast<uint8_t>(encoded[i])];
+    if (value < 0) {
+      return false;
+    }
+    bits = (bits << 6) | value;
+    bit_count += 6;
+    if (bit_count >= 16) {
+      bit_count -= 16;
+      coefficients[byte_count / 2] = static_cast<int16_t>((bits >> bit_count) & 0xffff);
+      byte_count += 2;
+    }
+  }
+  return true;
+}
+
 } // namespace baldr
 } // namespace valhalla
@@ -0,0 +1,357 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "baldr/sharedtilesegment.h"
+#include "midgard/logging.h"
+
+namespace {
+
+// marks a segment as fully initialized and ready to use
+constexpr uint64_t kMagic = 0x56414c4853484d31; // VALHSHM1
+constexpr uint64_t kVersion = 2;
+
+// tiles are copied in at this alignment so that their structures can be used in place
+constexpr uint64_t kAlignment = 64;
+
+// roughly how many bytes of tile data we expect per slot, the smaller tiles on the higher levels
+// are much smaller than this and the local ones are much bigger
+constexpr uint64_t kBytesPerSlot = 16384;
+constexpr uint64_t kMinSlots = 1024;
+
+// how long to wait for another process to finish creating the segment
+constexpr auto kInitTimeout = std::chrono::seconds(10);
+
+// how many times to replace a segment that doesnt fit before giving up
+constexpr size_t kOpenAttempts = 3;
+
+// states of a slot once its key has been claimed
+enum : uint32_t { kWriting = 0, kReady = 1, kFailed = 2 };
+
+// posix shared memory object names must start with a slash
+std::string shm_name(const std::string& name) {
+  return name.empty() || name.front() != '/' ? "/" + name : name;
+}
+
+uint64_t align(uint64_t value) {
+  return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+#ifndef _WIN32
+// unlinks the segment unless someone already replaced it with a new one
+void unlink_if(const std::string& name, ino_t inode) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd == -1) {
+    return;
+  }
+  struct stat s {};
+  if (fstat(fd, &s) == 0 && s.st_ino == inode) {
+    shm_unlink(name.c_str());
+  }
+  close(fd);
+}
+
+// whether the process that claimed a slot is gone
+bool owner_died(uint32_t pid) {
+  return pid != 0 && kill(static_cast<pid_t>(pid), 0) == -1 && errno == ESRCH;
+}
+#else
+bool owner_died(uint32_t) {
+  return false;
+}
+#endif
+
+} // namespace
+
+namespace valhalla {
+namespace baldr {
+
+// this lives at the start of the segment, followed by the slots and then the tile data
+struct SharedTileSegment::header_t {
+  std::atomic<uint64_t> magic;
+  uint64_t version;
+  uint64_t size;
+  uint64_t tileset_id;
+  uint64_t slot_count;
+  uint64_t data_offset;
+  std::atomic<uint64_t> used;
+  std::atomic<uint64_t> tiles;
+};
+
+// open addressing hash table entry, key is the tile id + 1 so that 0 can mean empty. owner is the
+// pid of the process writing the tile so that others can take over if it dies half way through
+struct SharedTileSegment::slot_t {
+  std::atomic<uint64_t> key;
+  std::atomic<uint32_t> state;
+  std::atomic<uint32_t> owner;
+  uint64_t offset;
+  uint64_t size;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared memory requires address free 64bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "Shared memory requires address free 32bit atomics");
+
+#ifndef _WIN32
+
+SharedTileSegment::SharedTileSegment(const std::string& name, size_t size, uint64_t tileset_id)
+    : name_(shm_name(name)), size_(0), writable_(nullptr), readable_(nullptr), header_(nullptr),
+      slots_(nullptr) {
+  // a segment of other tiles or one whose creator died half way through gets replaced, someone else
+  // may be replacing it at the same time so we look again afterwards
+  for (size_t attempt = 0;; ++attempt) {
+    if (Open(size, tileset_id)) {
+      break;
+    }
+    if (attempt == kOpenAttempts) {
+      throw std::runtime_error(name_ + " is not a valid shared tile segment for these tiles");
+    }
+  }
+  slots_ = reinterpret_cast<slot_t*>(writable_ + sizeof(header_t));
+}
+
+bool SharedTileSegment::Open(size_t size, uint64_t tileset_id) {
+  // try to be the one who creates it
+  bool creator = true;
+  int fd = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd == -1 && errno == EEXIST) {
+    creator = false;
+    fd = shm_open(name_.c_str(), O_RDWR, 0);
+  }
+  if (fd == -1) {
+    throw std::runtime_error(name_ + "(shm_open): " + strerror(errno));
+  }
+  struct stat s {};
+  fstat(fd, &s);
+  const auto inode = s.st_ino;
+
+  // the creator sizes it, everyone else waits for that to happen
+  const auto deadline = std::chrono::steady_clock::now() + kInitTimeout;
+  if (creator) {
+    size_ = size;
+    if (size_ < sizeof(header_t) + kMinSlots * sizeof(slot_t) + kAlignment) {
+      close(fd);
+      shm_unlink(name_.c_str());
+      throw std::runtime_error(name_ + " is too small to be a shared tile segment");
+    }
+    if (ftruncate(fd, size_) == -1) {
+      auto error = std::string(strerror(errno));
+      close(fd);
+      shm_unlink(name_.c_str());
+      throw std::runtime_error(name_ + "(ftruncate): " + error);
+    }
+  } else {
+    while (fstat(fd, &s) == 0 && s.st_size == 0 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    size_ = s.st_size;
+    if (size_ == 0) {
+      close(fd);
+      LOG_WARN("Replacing " + name_ + " which was never initialized");
+      unlink_if(name_, inode);
+      return false;
+    }
+  }
+
+  // map it twice, tiles are only handed out from the read only mapping
+  writable_ =
+      static_cast<char*>(mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+  readable_ = writable_ == MAP_FAILED
+                  ? static_cast<char*>(MAP_FAILED)
+                  : static_cast<char*>(mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0));
+  const auto error = std::string(strerror(errno));
+  close(fd);
+  if (writable_ == MAP_FAILED || readable_ == MAP_FAILED) {
+    if (writable_ != MAP_FAILED) {
+      munmap(writable_, size_);
+    }
+    throw std::runtime_error(name_ + "(mmap): " + error);
+  }
+  header_ = reinterpret_cast<header_t*>(writable_);
+
+  // lay out the header and the slots, the rest of the memory is already zeroed
+  if (creator) {
+    header_->version = kVersion;
+    header_->size = size_;
+    header_->tileset_id = tileset_id;
+    header_->slot_count = std::max(kMinSlots, size_ / kBytesPerSlot);
+    header_->data_offset = align(sizeof(header_t) + header_->slot_count * sizeof(slot_t));
+    if (header_->data_offset >= size_) {
+      header_->slot_count = kMinSlots;
+      header_->data_offset = align(sizeof(header_t) + header_->slot_count * sizeof(slot_t));
+    }
+    header_->used.store(0, std::memory_order_relaxed);
+    header_->tiles.store(0, std::memory_order_relaxed);
+    header_->magic.store(kMagic, std::memory_order_release);
+    LOG_INFO("Created shared tile segment " + name_ + " of " + std::to_string(size_) + " bytes");
+    return true;
+  }
+
+  // wait for the creator to finish
+  while (header_->magic.load(std::memory_order_acquire) != kMagic &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::string problem;
+  if (header_->magic.load(std::memory_order_acquire) != kMagic || header_->version != kVersion ||
+      header_->size != size_) {
+    problem = "is not a valid shared tile segment";
+  } else if (header_->tileset_id != tileset_id) {
+    problem = "holds tiles of another tileset";
+  }
+  if (problem.empty()) {
+    return true;
+  }
+
+  // replace it, processes still using it keep their mapping until they are restarted
+  LOG_WARN("Replacing " + name_ + " which " + problem);
+  munmap(writable_, size_);
+  munmap(readable_, size_);
+  writable_ = readable_ = nullptr;
+  header_ = nullptr;
+  unlink_if(name_, inode);
+  return false;
+}
+
+SharedTileSegment::~SharedTileSegment() {
+  munmap(writable_, size_);
+  munmap(readable_, size_);
+}
+
+bool SharedTileSegment::Remove(const std::string& name) {
+  return shm_unlink(shm_name(name).c_str()) == 0;
+}
+
+#else
+
+SharedTileSegment::SharedTileSegment(const std::string& name, size_t, uint64_t)
+    : name_(name), size_(0), writable_(nullptr), readable_(nullptr), header_(nullptr),
+      slots_(nullptr) {
+  throw std::runtime_error("Shared tile segments are not supported on this platform");
+}
+
+SharedTileSegment::~SharedTileSegment() {
+}
+
+bool SharedTileSegment::Remove(const std::string&) {
+  return false;
+}
+
+#endif
+
+SharedTileSegment::slot_t* SharedTileSegment::FindSlot(uint64_t key) const {
+  // linear probing until we find the key or an empty slot
+  const auto slot_count = header_->slot_count;
+  for (uint64_t i = 0, index = std::hash<uint64_t>{}(key) % slot_count; i < slot_count;
+       ++i, index = (index + 1) % slot_count) {
+    auto current = slots_[index].key.load(std::memory_order_acquire);
+    if (current == key || current == 0) {
+      return &slots_[index];
+    }
+  }
+  return nullptr;
+}
+
+std::pair<char*, size_t> SharedTileSegment::Find(const GraphId& graphid) const {
+  const uint64_t key = graphid.Tile_Base().value + 1;
+  auto* slot = FindSlot(key);
+  if (!slot || slot->key.load(std::memory_order_acquire) != key ||
+      slot->state.load(std::memory_order_acquire) != kReady) {
+    return {nullptr, 0};
+  }
+  return {readable_ + header_->data_offset + slot->offset, slot->size};
+}
+
+std::pair<char*, size_t> SharedTileSegment::Publish(const GraphId& graphid,
+                                                    const char* data,
+                                                    size_t size) {
+  const uint64_t key = graphid.Tile_Base().value + 1;
+  const uint32_t pid = static_cast<uint32_t>(getpid());
+  while (auto* slot = FindSlot(key)) {
+    if (slot->key.load(std::memory_order_acquire) == key) {
+      // someone else already has this tile, its either ready or in progress. if whoever was
+      // writing it died we take over, otherwise we leave it to them
+      auto owner = slot->owner.load(std::memory_order_acquire);
+      if (slot->state.load(std::memory_order_acquire) != kWriting || !owner_died(owner) ||
+          !slot->owner.compare_exchange_strong(owner, pid, std::memory_order_acq_rel)) {
+        return Find(graphid);
+      }
+      LOG_WARN("Taking over tile " + std::to_string(graphid.Tile_Base().value) + " in " + name_ +
+               " from process " + std::to_string(owner) + " which is gone");
+    } // try to claim the empty slot, if someone beat us to it we look again
+    else {
+      uint64_t expected = 0;
+      if (!slot->key.compare_exchange_strong(expected, key, std::memory_order_acq_rel)) {
+        continue;
+      }
+      slot->owner.store(pid, std::memory_order_release);
+    }
+
+    // we own the slot now so reserve some space for the tile
+    const uint64_t capacity = header_->size - header_->data_offset;
+    const uint64_t needed = align(size);
+    uint64_t offset = header_->used.load(std::memory_order_relaxed);
+    do {
+      if (offset + needed > capacity) {
+        slot->state.store(kFailed, std::memory_order_release);
+        return {nullptr, 0};
+      }
+    } while (!header_->used.compare_exchange_weak(offset, offset + needed,
+                                                  std::memory_order_relaxed));
+
+    // copy it in and only then let everyone know its there
+    std::memcpy(writable_ + header_->data_offset + offset, data, size);
+    slot->offset = offset;
+    slot->size = size;
+    slot->state.store(kReady, std::memory_order_release);
+    header_->tiles.fetch_add(1, std::memory_order_relaxed);
+    return {readable_ + header_->data_offset + offset, size};
+  }
+
+  // no slots left
+  return {nullptr, 0};
+}
+
+uint64_t SharedTileSegment::tileset_id() const {
+  return header_->tileset_id;
+}
+
+SharedTileSegment::stats_t SharedTileSegment::stats() const {
+  stats_t stats;
+  stats.capacity = header_->size - header_->data_offset;
+  stats.used = header_->used.load(std::memory_order_relaxed);
+  stats.tiles = header_->tiles.load(std::memory_order_relaxed);
+  stats.slots = header_->slot_count;
+  return stats;
+}
+
+std::shared_ptr<SharedTileSegment>
+SharedTileSegment::Get(const std::string& name, size_t size, uint64_t tileset_id) {
+  static std::mutex segments_mutex;
+  static std::unordered_map<std::string, std::weak_ptr<SharedTileSegment>> segments;
+  std::lock_guard<std::mutex> lock(segments_mutex);
+  auto segment = segments[shm_name(name)].lock();
+  if (!segment || segment->tileset_id() != tileset_id) {
+    segment = std::make_shared<SharedTileSegment>(name, size, tileset_id);
+    segments[shm_name(name)] = segment;
+  }
+  return segment;
+}
+
+} // namespace baldr
+} // namespace valhalla
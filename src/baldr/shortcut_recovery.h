@@ -1,12 +1,17 @@
 #pragma once
 
 #include "baldr/graphreader.h"
+#include "baldr/sharedtilesegment.h"
 #include "baldr/tilehierarchy.h"
 #include "midgard/logging.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace {
@@ -14,18 +19,33 @@ namespace {
 // a static cache for shortcut recovery that we can optionally pre-fill
 struct shortcut_recovery_t {
 protected:
+  // maps shortcut ids to the edges they were recovered as
+  using shortcuts_t = std::unordered_map<uint64_t, std::vector<valhalla::baldr::GraphId>>;
+
   /**
    * Constructs a shortcut cache from a graphreaders tileset by recovering all shortcuts. If the
-   * graphreader passed in is null nothing is cached and revoery will happen on the fly
+   * graphreader passed in is null nothing is cached and revoery will happen on the fly. If a shared
+   * segment is passed in the shortcuts of each tile are published to it so that other processes
+   * using the same segment dont have to recover them or keep their own copy
    * @param reader
+   * @param segment  shared memory to publish the recovered shortcuts to and look them up in
    */
-  shortcut_recovery_t(valhalla::baldr::GraphReader* reader) {
+  shortcut_recovery_t(valhalla::baldr::GraphReader* reader,
+                      std::shared_ptr<valhalla::baldr::SharedTileSegment> segment = nullptr)
+      : segment(std::move(segment)), unrecovered(0), superseded(0) {
     // do nothing if the reader is no good
     if (!reader) {
       LOG_INFO("Shortcut recovery cache disabled");
       return;
     }
-    LOG_INFO("Shortcut recovery cache enabled");
+    LOG_INFO(std::string("Shortcut recovery cache enabled") +
+             (this->segment ? " and shared through " + this->segment->name() : ""));
+
+    // the shortcuts of each tile are collected and published together. opposing shortcuts are
+    // cheaper to get from the ones we recovered so we hold on to those until we get to their tile
+    std::unordered_map<uint64_t, shortcuts_t> pending;
+    std::unordered_set<uint64_t> done;
+    size_t recovered_count = 0, shared = 0;
 
     // completely skip the levels that dont have shortcuts
     for (const auto& level : valhalla::baldr::TileHierarchy::levels()) {
@@ -34,6 +54,14 @@ protected:
         continue;
       // for each tile
       for (auto tile_id : reader->GetTileSet(level.level)) {
+        done.insert(tile_id);
+        auto tile_shortcuts = std::move(pending[tile_id]);
+        pending.erase(tile_id);
+        // another process already did this one
+        if (this->segment && this->segment->Find(tile_id).first) {
+          ++shared;
+          continue;
+        }
         // cull cache if we are over allocated
         if (reader->OverCommitted())
           reader->Trim();
@@ -48,7 +76,7 @@ protected:
           auto shortcut_id = tile->header()->graphid();
           shortcut_id.set_id(&edge - tile->directededge(0));
           // skip already found opposing edges
-          if (shortcuts.find(shortcut_id) != shortcuts.end())
+          if (tile_shortcuts.find(shortcut_id) != tile_shortcuts.end())
             continue;
           // recover the shortcut and make a copy for opposing direction
           auto recovered = recover_shortcut(*reader, shortcut_id);
@@ -59,13 +87,17 @@ protected:
           unrecovered += failed;
           superseded += failed ? 0 : recovered.size();
           // cache it even if it failed (no point in trying the same thing twice)
-          shortcuts.emplace(shortcut_id, std::move(recovered));
+          tile_shortcuts.emplace(shortcut_id, std::move(recovered));
 
           // its cheaper to get the opposing without crawling the graph
           auto opp_tile = tile;
           auto opp_id = reader->GetOpposingEdgeId(shortcut_id, opp_tile);
           if (!opp_id.Is_Valid())
             continue; // dont store edges which arent in our tileset
+          // if its tile is already done it was found there
+          auto opp_tile_id = opp_id.Tile_Base();
+          if (opp_tile_id != tile_id && done.find(opp_tile_id) != done.end())
+            continue;
 
           for (auto& id : opp_recovered) {
             id = reader->GetOpposingEdgeId(id, opp_tile);
@@ -79,14 +111,106 @@ protected:
           unrecovered += failed;
           superseded += failed ? 0 : opp_recovered.size();
           // cache it even if it failed (no point in trying the same thing twice)
-          shortcuts.emplace(opp_id, std::move(opp_recovered));
+          auto& opp_shortcuts = opp_tile_id == tile_id ? tile_shortcuts : pending[opp_tile_id];
+          opp_shortcuts.emplace(opp_id, std::move(opp_recovered));
+        }
+
+        // share them if we can, if not we keep them to ourselves
+        recovered_count += tile_shortcuts.size();
+        if (!publish(tile_id, tile_shortcuts)) {
+          shortcuts.insert(std::make_move_iterator(tile_shortcuts.begin()),
+                           std::make_move_iterator(tile_shortcuts.end()));
         }
       }
     }
 
-    LOG_INFO(std::to_string(shortcuts.size()) + " shortcuts recovered as " +
+    LOG_INFO(std::to_string(recovered_count) + " shortcuts recovered as " +
              std::to_string(superseded) + " superseded edges. " + std::to_string(unrecovered) +
-             " shortcuts could not be recovered.");
+             " shortcuts could not be recovered." +
+             (this->segment ? " " + std::to_string(shortcuts.size()) +
+                                  " shortcuts did not fit in shared memory. The shortcuts of " +
+                                  std::to_string(shared) +
+                                  " tiles were already shared by another process."
+                            : ""));
+  }
+
+  // an entry in the sorted index at the start of the shortcuts of a tile in shared memory, the
+  // recovered edges of all the shortcuts follow the index
+  struct shared_shortcut_t {
+    uint64_t shortcut_id;
+    uint32_t offset;
+    uint32_t count;
+  };
+
+  /**
+   * Copies the recovered shortcuts of a tile to shared memory
+   * @param tile_id    the tile the shortcuts are in
+   * @param recovered  the recovered shortcuts
+   * @return true if the shortcuts are in shared memory, false if there is no shared memory or it
+   *         is full
+   */
+  bool publish(const valhalla::baldr::GraphId& tile_id, const shortcuts_t& recovered) {
+    if (!segment)
+      return false;
+    // lay out the index and the edges and sort the index by shortcut id so we can search it
+    std::vector<shared_shortcut_t> index;
+    index.reserve(recovered.size());
+    uint32_t count = 0;
+    for (const auto& shortcut : recovered) {
+      index.push_back({shortcut.first, count, static_cast<uint32_t>(shortcut.second.size())});
+      count += shortcut.second.size();
+    }
+    std::sort(index.begin(), index.end(),
+              [](const shared_shortcut_t& a, const shared_shortcut_t& b) {
+                return a.shortcut_id < b.shortcut_id;
+              });
+    std::vector<char> bytes(sizeof(uint64_t) + index.size() * sizeof(shared_shortcut_t) +
+                            count * sizeof(uint64_t));
+    uint64_t entries = index.size();
+    std::memcpy(bytes.data(), &entries, sizeof(entries));
+    std::memcpy(bytes.data() + sizeof(uint64_t), index.data(),
+                index.size() * sizeof(shared_shortcut_t));
+    auto* edges = bytes.data() + sizeof(uint64_t) + index.size() * sizeof(shared_shortcut_t);
+    for (const auto& entry : index) {
+      for (const auto& edge_id : recovered.find(entry.shortcut_id)->second) {
+        std::memcpy(edges, &edge_id.value, sizeof(uint64_t));
+        edges += sizeof(uint64_t);
+      }
+    }
+    // if someone else beat us to it thats just as good
+    return segment->Publish(tile_id, bytes.data(), bytes.size()).first != nullptr;
+  }
+
+  /**
+   * Looks up a shortcut in shared memory
+   * @param shortcut_id  the shortcut
+   * @param recovered    the edges the shortcut was recovered as
+   * @return true if the shortcut was found
+   */
+  bool find_shared(const valhalla::baldr::GraphId& shortcut_id,
+                   std::vector<valhalla::baldr::GraphId>& recovered) const {
+    if (!segment)
+      return false;
+    auto bytes = segment->Find(shortcut_id);
+    if (!bytes.first)
+      return false;
+    // tiles are published with an alignment which suits the index and the edges
+    const auto entries = *reinterpret_cast<const uint64_t*>(bytes.first);
+    const auto* index = reinterpret_cast<const shared_shortcut_t*>(bytes.first + sizeof(uint64_t));
+    const auto* edges = reinterpret_cast<const uint64_t*>(index + entries);
+    const auto* entry = std::lower_bound(index, index + entries, shortcut_id.value,
+                                         [](const shared_shortcut_t& e, uint64_t id) {
+                                           return e.shortcut_id < id;
+                                         });
+    if (entry == index + entries || entry->shortcut_id != shortcut_id.value)
+      return false;
+    recovered.clear();
+    recovered.reserve(entry->count);
+    for (const auto* edge = edges + entry->offset; edge != edges + entry->offset + entry->count;
+         ++edge) {
+      recovered.emplace_back(*edge);
+    }
+    return true;
   }
 
   /**
@@ -194,8 +318,10 @@ protected:
     return edges;
   }
 
-  // a place to cache the recovered shortcuts
-  std::unordered_map<uint64_t, std::vector<valhalla::baldr::GraphId>> shortcuts;
+  // a place to cache the recovered shortcuts that arent in shared memory
+  shortcuts_t shortcuts;
+  // shared memory where the recovered shortcuts of each tile are shared with other processes
+  std::shared_ptr<valhalla::baldr::SharedTileSegment> segment;
   // a place to keep some stats about the recovery
   size_t unrecovered;
   size_t superseded;
@@ -206,10 +332,13 @@ public:
    * the reader is nullptr then the cache will not be filled and recovery will be on the fly
    *
    * @param reader       the reader used to initialize the cache the first time
+   * @param segment      shared memory to share the cache with other processes through
    * @return a filled cache mapping shortcuts to superceeded edges
    */
-  static shortcut_recovery_t& get_instance(valhalla::baldr::GraphReader* reader = nullptr) {
-    static shortcut_recovery_t cache{reader};
+  static shortcut_recovery_t&
+  get_instance(valhalla::baldr::GraphReader* reader = nullptr,
+               std::shared_ptr<valhalla::baldr::SharedTileSegment> segment = nullptr) {
+    static shortcut_recovery_t cache{reader, std::move(segment)};
     return cache;
   }
 
@@ -224,10 +353,13 @@ public:
                                             valhalla::baldr::GraphReader& reader) const {
     // in the case that we didnt fill the cache we fallback to recovering on the fly
     auto itr = shortcuts.find(shortcut_id);
-    if (itr == shortcuts.cend())
-      return recover_shortcut(reader, shortcut_id);
-    // it was in cache
-    return itr->second;
+    if (itr != shortcuts.cend())
+      return itr->second;
+    // maybe its in shared memory
+    std::vector<valhalla::baldr::GraphId> recovered;
+    if (find_shared(shortcut_id, recovered))
+      return recovered;
+    return recover_shortcut(reader, shortcut_id);
   }
 };
 
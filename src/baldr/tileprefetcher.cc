@@ -0,0 +1,166 @@
+#include <algorithm>
+
+#include "baldr/graphtile.h"
+#include "baldr/tileprefetcher.h"
+#include "midgard/logging.h"
+
+namespace valhalla {
+namespace baldr {
+
+TilePrefetcher::TilePrefetcher(size_t thread_count, size_t max_pending, loader_t loader)
+    : loader_(std::move(loader)), max_pending_(max_pending), ready_count_(0), generation_(0),
+      stop_(false) {
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads_.emplace_back(&TilePrefetcher::Work, this);
+  }
+}
+
+TilePrefetcher::~TilePrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    queue_.clear();
+  }
+  work_cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+bool TilePrefetcher::Prefetch(const GraphId& tile_id) {
+  // we've already asked for this one
+  if (!requested_.insert(tile_id).second) {
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() + in_flight_.size() + ready_.size() >= max_pending_) {
+      // forget it so we can try again later
+      requested_.erase(tile_id);
+      return false;
+    }
+    queue_.push_back(tile_id);
+  }
+  ++stats_.requested;
+  work_cv_.notify_one();
+  return true;
+}
+
+void TilePrefetcher::CollectReady(const collector_t& collector) {
+  decltype(ready_) ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready.swap(ready_);
+    ready_count_.store(0, std::memory_order_release);
+  }
+  for (auto& tile : ready) {
+    // the cache owns it now and may evict it later, so let it be prefetched again
+    requested_.erase(tile.first);
+    if (tile.second) {
+      ++stats_.collected;
+      collector(tile.first, std::move(tile.second));
+    }
+  }
+}
+
+graph_tile_ptr TilePrefetcher::Take(const GraphId& tile_id) {
+  // never asked for it so the caller has to get it
+  if (requested_.find(tile_id) == requested_.cend()) {
+    ++stats_.misses;
+    return nullptr;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  // its still waiting in the queue, no sense in waiting for a thread to pick it up
+  auto queued = std::find(queue_.begin(), queue_.end(), tile_id);
+  if (queued != queue_.end()) {
+    queue_.erase(queued);
+    requested_.erase(tile_id);
+    ++stats_.misses;
+    return nullptr;
+  }
+
+  // its being loaded right now so we wait for it
+  bool waited = false;
+  if (in_flight_.find(tile_id) != in_flight_.cend()) {
+    waited = true;
+    done_cv_.wait(lock,
+                  [this, &tile_id]() { return in_flight_.find(tile_id) == in_flight_.cend(); });
+  }
+
+  // hand it over if it loaded
+  graph_tile_ptr tile;
+  auto found = ready_.find(tile_id);
+  if (found != ready_.end()) {
+    tile = std::move(found->second);
+    ready_.erase(found);
+    ready_count_.store(ready_.size(), std::memory_order_release);
+  }
+  requested_.erase(tile_id);
+
+  // keep track of how useful prefetching was
+  if (!tile) {
+    ++stats_.misses;
+  } else if (waited) {
+    ++stats_.waits;
+  } else {
+    ++stats_.hits;
+  }
+  return tile;
+}
+
+void TilePrefetcher::Clear() {
+  decltype(ready_) ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.clear();
+    ready.swap(ready_);
+    ready_count_.store(0, std::memory_order_release);
+    // anything in flight right now will be thrown away when its done
+    ++generation_;
+  }
+  requested_.clear();
+}
+
+TilePrefetcher::stats_t TilePrefetcher::stats() const {
+  return stats_;
+}
+
+void TilePrefetcher::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+    if (stop_) {
+      return;
+    }
+
+    // grab the next tile and mark it as in flight
+    auto tile_id = queue_.front();
+    queue_.pop_front();
+    in_flight_.insert(tile_id);
+    auto generation = generation_;
+
+    // do the expensive part without holding the lock
+    lock.unlock();
+    graph_tile_ptr tile;
+    try {
+      tile = loader_(tile_id);
+    } catch (const std::exception& e) {
+      LOG_WARN("Failed to prefetch tile " + std::to_string(tile_id.value) + ": " + e.what());
+    }
+    lock.lock();
+
+    // keep it unless it was cleared while we were loading it
+    in_flight_.erase(tile_id);
+    if (generation == generation_) {
+      ready_.emplace(tile_id, std::move(tile));
+      ready_count_.store(ready_.size(), std::memory_order_release);
+    }
+    done_cv_.notify_all();
+  }
+}
+
+} // namespace baldr
+} // namespace valhalla
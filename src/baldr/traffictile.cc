@@ -0,0 +1,140 @@
+#include "baldr/traffictile.h"
+#include "midgard/logging.h"
+#include "midgard/sequence.h"
+
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <thread>
+
+namespace {
+
+std::string epochs_file(const std::string& traffic_extract) {
+  return traffic_extract + ".epochs";
+}
+
+} // namespace
+
+namespace valhalla {
+namespace baldr {
+
+constexpr uint64_t TrafficEpochs::kMagic;
+constexpr size_t TrafficEpochs::kReaderSlots;
+
+TrafficEpochs::TrafficEpochs(const std::string& traffic_extract, bool create)
+    : map_(new midgard::mem_map<char>()), layout_(nullptr) {
+  auto file_name = epochs_file(traffic_extract);
+  struct stat s;
+  if (stat(file_name.c_str(), &s) != 0) {
+    if (!create) {
+      throw std::runtime_error(file_name + " does not exist");
+    }
+    // nothing is published yet but the tiles start out at 0 so 1 is as good as published
+    std::ofstream file(file_name, std::ios::binary);
+    std::vector<char> zeros(sizeof(layout_t), 0);
+    file.write(zeros.data(), zeros.size());
+    file.close();
+    map_->map(file_name, sizeof(layout_t));
+    layout_ = reinterpret_cast<layout_t*>(map_->get());
+    layout_->published = layout_->begun = 1;
+    layout_->magic = kMagic;
+    return;
+  }
+
+  if (static_cast<size_t>(s.st_size) < sizeof(layout_t)) {
+    throw std::runtime_error(file_name + " is too small to be traffic epochs");
+  }
+  map_->map(file_name, sizeof(layout_t));
+  layout_ = reinterpret_cast<layout_t*>(map_->get());
+  if (layout_->magic != kMagic) {
+    throw std::runtime_error(file_name + " is not traffic epochs");
+  }
+}
+
+TrafficEpochs::~TrafficEpochs() {
+}
+
+std::shared_ptr<TrafficEpochs> TrafficEpochs::Open(const std::string& traffic_extract) {
+  struct stat s;
+  if (stat(epochs_file(traffic_extract).c_str(), &s) != 0) {
+    return nullptr;
+  }
+  try {
+    return std::make_shared<TrafficEpochs>(traffic_extract);
+  } catch (const std::exception& e) {
+    LOG_WARN(std::string("Traffic updates will be seen halfway through: ") + e.what());
+  }
+  return nullptr;
+}
+
+std::atomic<TrafficEpochs*>& TrafficEpochs::current() {
+  static std::atomic<TrafficEpochs*> epochs{nullptr};
+  return epochs;
+}
+
+void TrafficEpochs::Set(std::shared_ptr<TrafficEpochs> epochs) {
+  // snapshots hold on to the epochs they pinned so we cant let go of any
+  static std::mutex mutex;
+  static std::vector<std::shared_ptr<TrafficEpochs>> kept;
+  std::lock_guard<std::mutex> lock(mutex);
+  current().store(epochs.get(), std::memory_order_release);
+  if (epochs) {
+    kept.emplace_back(std::move(epochs));
+  }
+}
+
+uint32_t TrafficEpochs::Pin(uint32_t epoch) {
+  while (true) {
+    auto published = layout_->published.load();
+    if (epoch == 0 || epoch > published) {
+      epoch = published;
+    }
+    layout_->readers[epoch % kReaderSlots].fetch_add(1);
+
+    // the update after the epoch only overwrites older speeds, any later one could overwrite ours
+    if (layout_->begun.load() <= epoch + 1) {
+      return epoch;
+    }
+    Unpin(epoch);
+    epoch = 0;
+  }
+}
+
+void TrafficEpochs::Unpin(uint32_t epoch) {
+  // the slot could have been forgotten about by an update that got tired of waiting
+  auto& readers = layout_->readers[epoch % kReaderSlots];
+  auto count = readers.load();
+  while (count && !readers.compare_exchange_weak(count, count - 1)) {
+  }
+}
+
+uint32_t TrafficEpochs::Begin(std::chrono::milliseconds timeout) {
+  // readers pinned to anything older than the last update could be reading what we overwrite
+  auto published = layout_->published.load();
+  auto epoch = published + 1;
+  layout_->begun.store(epoch);
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  for (size_t slot = 0; slot < kReaderSlots; ++slot) {
+    if (slot == published % kReaderSlots) {
+      continue;
+    }
+    while (layout_->readers[slot].load()) {
+      if (std::chrono::steady_clock::now() >= deadline) {
+        LOG_WARN("Traffic readers of epoch slot " + std::to_string(slot) +
+                 " are taking too long, assuming they are gone");
+        layout_->readers[slot].store(0);
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  return epoch;
+}
+
+void TrafficEpochs::Publish(uint32_t epoch) {
+  layout_->published.store(epoch);
+}
+
+} // namespace baldr
+} // namespace valhalla
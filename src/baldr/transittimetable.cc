@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+
+#include "baldr/transittimetable.h"
+
+namespace valhalla {
+namespace baldr {
+
+constexpr uint32_t TransitTimetable::kInvalidStop;
+constexpr uint32_t TransitTimetable::kNoConnection;
+constexpr uint32_t TransitTimetable::kWheelchairAccessible;
+constexpr uint32_t TransitTimetable::kBicycleAccessible;
+
+TransitTimetable::TransitTimetable(const std::string& file_name)
+    : header_(nullptr), stops_(nullptr), schedules_(nullptr), connections_(nullptr),
+      footpaths_(nullptr) {
+  struct stat s;
+  if (stat(file_name.c_str(), &s) != 0 || static_cast<size_t>(s.st_size) < sizeof(header_t)) {
+    throw std::runtime_error(file_name + " is not a transit timetable");
+  }
+  memory_.map_readonly(file_name, s.st_size);
+
+  // make sure its what we think it is and that all of the parts are there
+  header_ = reinterpret_cast<const header_t*>(memory_.get());
+  if (header_->magic != kMagic || header_->version != kVersion) {
+    throw std::runtime_error(file_name + " is not a compatible transit timetable");
+  }
+  if (sizeof(header_t) + header_->stop_count * sizeof(stop_t) +
+          header_->schedule_count * sizeof(schedule_t) +
+          header_->connection_count * sizeof(connection_t) +
+          header_->footpath_count * sizeof(footpath_t) !=
+      memory_.size()) {
+    throw std::runtime_error(file_name + " is truncated");
+  }
+
+  // point at the various parts
+  stops_ = reinterpret_cast<const stop_t*>(memory_.get() + sizeof(header_t));
+  schedules_ = reinterpret_cast<const schedule_t*>(stops_ + header_->stop_count);
+  connections_ = reinterpret_cast<const connection_t*>(schedules_ + header_->schedule_count);
+  footpaths_ = reinterpret_cast<const footpath_t*>(connections_ + header_->connection_count);
+}
+
+void TransitTimetable::Write(const std::string& file_name,
+                             std::vector<stop_t> stops,
+                             const std::vector<schedule_t>& schedules,
+                             std::vector<connection_t> connections,
+                             const std::vector<std::vector<footpath_t>>& footpaths,
+                             uint32_t trip_count) {
+  if (footpaths.size() != stops.size()) {
+    throw std::logic_error("Every stop needs its list of footpaths");
+  }
+
+  // the scan relies on the hops of a trip being in order so ties go to the earlier arrival
+  std::sort(connections.begin(), connections.end(),
+            [](const connection_t& a, const connection_t& b) {
+              return a.departure == b.departure ? a.arrival < b.arrival
+                                                : a.departure < b.departure;
+            });
+
+  // link the hops of each trip so that a ride can be followed without scanning everything between
+  std::vector<uint32_t> last_hop(trip_count, kNoConnection);
+  for (uint32_t i = 0; i < connections.size(); ++i) {
+    auto& connection = connections[i];
+    if (connection.trip >= trip_count) {
+      throw std::logic_error("Connection of trip " + std::to_string(connection.trip) +
+                             " but there are only " + std::to_string(trip_count) + " trips");
+    }
+    connection.next = kNoConnection;
+    if (last_hop[connection.trip] != kNoConnection) {
+      connections[last_hop[connection.trip]].next = i;
+    }
+    last_hop[connection.trip] = i;
+  }
+
+  // point each stop at its footpaths
+  uint32_t footpath_count = 0;
+  for (size_t i = 0; i < stops.size(); ++i) {
+    stops[i].footpath_offset = footpath_count;
+    stops[i].footpath_count = footpaths[i].size();
+    footpath_count += footpaths[i].size();
+  }
+
+  header_t header{};
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.stop_count = stops.size();
+  header.schedule_count = schedules.size();
+  header.connection_count = connections.size();
+  header.footpath_count = footpath_count;
+  header.trip_count = trip_count;
+
+  // go through a temporary file so that nobody reads half of it
+  auto temp_name = file_name + ".tmp";
+  {
+    std::ofstream file(temp_name, std::ios::binary | std::ios::out | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(stops.data()), stops.size() * sizeof(stop_t));
+    file.write(reinterpret_cast<const char*>(schedules.data()),
+               schedules.size() * sizeof(schedule_t));
+    file.write(reinterpret_cast<const char*>(connections.data()),
+               connections.size() * sizeof(connection_t));
+    for (const auto& stop_footpaths : footpaths) {
+      file.write(reinterpret_cast<const char*>(stop_footpaths.data()),
+                 stop_footpaths.size() * sizeof(footpath_t));
+    }
+    if (!file) {
+      throw std::runtime_error("Failed to write " + temp_name);
+    }
+  }
+  if (std::rename(temp_name.c_str(), file_name.c_str()) != 0) {
+    throw std::runtime_error("Failed to move " + temp_name + " to " + file_name);
+  }
+}
+
+uint32_t TransitTimetable::find_stop(const GraphId& node) const {
+  auto found = std::lower_bound(stops_, stops_ + header_->stop_count, node.value,
+                                [](const stop_t& stop, uint64_t node) { return stop.node < node; });
+  if (found == stops_ + header_->stop_count || found->node != node.value) {
+    return kInvalidStop;
+  }
+  return found - stops_;
+}
+
+const TransitTimetable::connection_t* TransitTimetable::first_departure(const uint32_t time) const {
+  return std::lower_bound(connections_, connections_ + header_->connection_count, time,
+                          [](const connection_t& connection, uint32_t time) {
+                            return connection.departure < time;
+                          });
+}
+
+} // namespace baldr
+} // namespace valhalla
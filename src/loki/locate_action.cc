@@ -23,7 +23,8 @@ std::string loki_worker_t::locate(Api& request) {
   // correlate the various locations to the underlying graph
   init_locate(request);
   auto locations = PathLocation::fromPBF(request.options().locations());
-  auto projections = loki::Search(locations, *reader, costing);
+  auto projections =
+      loki::Search(locations, *reader, costing, precomputed_reach(request.options()));
   return tyr::serializeLocate(request, locations, projections, *reader);
 }
 
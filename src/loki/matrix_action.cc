@@ -116,7 +116,8 @@ void loki_worker_t::matrix(Api& request) {
   // correlate the various locations to the underlying graph
   std::unordered_map<size_t, size_t> color_counts;
   try {
-    const auto searched = loki::Search(sources_targets, *reader, costing);
+    const auto searched =
+        loki::Search(sources_targets, *reader, costing, precomputed_reach(options));
     for (size_t i = 0; i < sources_targets.size(); ++i) {
       const auto& l = sources_targets[i];
       const auto& projection = searched.at(l);
@@ -144,19 +145,32 @@ void loki_worker_t::matrix(Api& request) {
   } catch (const std::exception&) { throw valhalla_exception_t{171}; }
 
   // are all the locations in the same color regions
-  if (!connectivity_map) {
-    return;
-  }
-  bool connected = false;
-  for (const auto& c : color_counts) {
-    if (c.second == sources_targets.size()) {
-      connected = true;
-      break;
+  if (connectivity_map) {
+    bool connected = false;
+    for (const auto& c : color_counts) {
+      if (c.second == sources_targets.size()) {
+        connected = true;
+        break;
+      }
     }
+    if (!connected) {
+      throw valhalla_exception_t{170};
+    };
   }
-  if (!connected) {
+
+  // a matrix is allowed to have some unreachable pairs but if none of them are reachable there is
+  // no point in searching for any of them
+  ComponentLabels::Mode mode;
+  if (component_mode(options, mode)) {
+    for (const auto& source : options.sources()) {
+      for (const auto& target : options.targets()) {
+        if (may_reach(source, target, mode)) {
+          return;
+        }
+      }
+    }
     throw valhalla_exception_t{170};
-  };
+  }
 }
 } // namespace loki
 } // namespace valhalla
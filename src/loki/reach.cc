@@ -1,10 +1,70 @@
 #include "loki/reach.h"
+#include "baldr/rapidjson_utils.h"
 
 using namespace valhalla::baldr;
 
 namespace valhalla {
 namespace loki {
 
+Costing default_costing(Costing::Type type) {
+  rapidjson::Document doc;
+  doc.SetObject();
+  Costing costing;
+  sif::ParseCosting(doc, "/costing_options/" + Costing_Enum_Name(type), &costing, type);
+  return costing;
+}
+
+std::string reach_access_key(const Costing::Options& options) {
+  // reach only depends on which edges and nodes are allowed, not what they cost
+  auto key = options;
+  key.clear_maneuver_penalty();
+  key.clear_destination_only_penalty();
+  key.clear_gate_cost();
+  key.clear_gate_penalty();
+  key.clear_toll_booth_cost();
+  key.clear_toll_booth_penalty();
+  key.clear_alley_penalty();
+  key.clear_country_crossing_cost();
+  key.clear_country_crossing_penalty();
+  key.clear_ferry_cost();
+  key.clear_use_ferry();
+  key.clear_use_highways();
+  key.clear_use_tolls();
+  key.clear_use_roads();
+  key.clear_walking_speed();
+  key.clear_step_penalty();
+  key.clear_mode_factor();
+  key.clear_walkway_factor();
+  key.clear_sidewalk_factor();
+  key.clear_alley_factor();
+  key.clear_driveway_factor();
+  key.clear_driveway_penalty();
+  key.clear_top_speed();
+  key.clear_use_hills();
+  key.clear_use_primary();
+  key.clear_use_trails();
+  key.clear_low_class_penalty();
+  key.clear_cycling_speed();
+  key.clear_use_bus();
+  key.clear_use_rail();
+  key.clear_use_transfers();
+  key.clear_transfer_cost();
+  key.clear_transfer_penalty();
+  key.clear_bike_share_cost();
+  key.clear_bike_share_penalty();
+  key.clear_rail_ferry_cost();
+  key.clear_use_rail_ferry();
+  key.clear_shortest();
+  key.clear_service_penalty();
+  key.clear_use_tracks();
+  key.clear_use_distance();
+  key.clear_use_living_streets();
+  key.clear_service_factor();
+  key.clear_closure_factor();
+  key.clear_private_access_penalty();
+  return key.SerializeAsString();
+}
+
 Reach::Reach() : Dijkstras() {
   // Mock up the Location struct with the important stuff missing
   auto* path_edge = locations_.Add()->mutable_correlation()->add_edges();
@@ -53,6 +113,17 @@ directed_reach Reach::operator()(const DirectedEdge* edge,
     return reach;
   max_reach_ = max_reach;
 
+  // mjolnir already did the expansion for us, as long as the tile hasnt changed since
+  uint32_t outbound, inbound;
+  graph_tile_ptr tile, start_tile = reader.GetGraphTile(edge_id);
+  if (precomputed_ && max_reach <= precomputed_->max_reach() && start_tile &&
+      precomputed_->edge_count(edge_id) == start_tile->header()->directededgecount() &&
+      precomputed_->Get(edge_id, precomputed_mode_, outbound, inbound)) {
+    reach.outbound = direction & kOutbound ? std::min(outbound, max_reach) : 0;
+    reach.inbound = direction & kInbound ? std::min(inbound, max_reach) : 0;
+    return reach;
+  }
+
   // these are used below to get conservative estimates of forward and reverse reach
   constexpr uint16_t forward_disallow_mask = sif::kDisallowEndRestriction |
                                              sif::kDisallowSimpleRestriction | sif::kDisallowClosure |
@@ -71,7 +142,6 @@ directed_reach Reach::operator()(const DirectedEdge* edge,
   // we're finding nodes here so we'll double it assuming we queue less edges than nodes we see
   max_reserved_labels_count_ = max_reach * 2;
   Clear();
-  graph_tile_ptr tile, start_tile = reader.GetGraphTile(edge_id);
   if ((tile = start_tile) &&
       costing->Allowed(edge, tile, sif::kDisallowSimpleRestriction | sif::kDisallowShortcut))
     enqueue(edge->endnode(), reader, costing, tile);
@@ -97,7 +97,7 @@ void loki_worker_t::route(Api& request) {
   std::unordered_map<size_t, size_t> color_counts;
   try {
     auto locations = PathLocation::fromPBF(options.locations(), true);
-    const auto projections = loki::Search(locations, *reader, costing);
+    const auto projections = loki::Search(locations, *reader, costing, precomputed_reach(options));
     for (size_t i = 0; i < locations.size(); ++i) {
       const auto& correlated = projections.at(locations[i]);
       PathLocation::toPBF(correlated, options.mutable_locations(i), *reader);
@@ -119,19 +119,28 @@ void loki_worker_t::route(Api& request) {
   } catch (const std::exception&) { throw valhalla_exception_t{171}; }
 
   // are all the locations in the same color regions
-  if (!connectivity_map) {
-    return;
+  if (connectivity_map) {
+    bool connected = false;
+    for (const auto& c : color_counts) {
+      if (c.second == options.locations_size()) {
+        connected = true;
+        break;
+      }
+    }
+    if (!connected) {
+      throw valhalla_exception_t{170};
+    };
   }
-  bool connected = false;
-  for (const auto& c : color_counts) {
-    if (c.second == options.locations_size()) {
-      connected = true;
-      break;
+
+  // can each location actually get to the next one, centroid doesnt go from one to the next
+  ComponentLabels::Mode mode;
+  if (options.action() != Options::centroid && component_mode(options, mode)) {
+    for (int i = 0; i + 1 < options.locations_size(); ++i) {
+      if (!may_reach(options.locations(i), options.locations(i + 1), mode)) {
+        throw valhalla_exception_t{170};
+      }
     }
   }
-  if (!connected) {
-    throw valhalla_exception_t{170};
-  };
 }
 } // namespace loki
 } // namespace valhalla
@@ -256,8 +256,15 @@ struct bin_handler_t {
 
   bin_handler_t(const std::vector<valhalla::baldr::Location>& locations,
                 valhalla::baldr::GraphReader& reader,
-                const std::shared_ptr<DynamicCost>& costing)
+                const std::shared_ptr<DynamicCost>& costing,
+                const std::shared_ptr<const EdgeReach>& edge_reach)
       : reader(reader), costing(costing) {
+    // the precomputed reach is per mode so the costing has to line up with one of them
+    EdgeReach::Mode mode;
+    if (edge_reach && ComponentLabels::mode_for_access(costing->access_mode(), mode)) {
+      reach_finder.set_precomputed(edge_reach, mode);
+    }
+
     // get the unique set of input locations and the max reachability of them all
     std::unordered_set<Location> uniq_locations(locations.begin(), locations.end());
     pps.reserve(uniq_locations.size());
@@ -801,7 +808,8 @@ namespace loki {
 std::unordered_map<valhalla::baldr::Location, PathLocation>
 Search(const std::vector<valhalla::baldr::Location>& locations,
        GraphReader& reader,
-       const std::shared_ptr<DynamicCost>& costing) {
+       const std::shared_ptr<DynamicCost>& costing,
+       const std::shared_ptr<const EdgeReach>& edge_reach) {
   // we cannot continue without costing
   if (!costing)
     throw std::runtime_error("No costing was provided for edge candidate search");
@@ -811,7 +819,7 @@ Search(const std::vector<valhalla::baldr::Location>& locations,
     return std::unordered_map<valhalla::baldr::Location, PathLocation>{};
 
   // setup the unique list of locations
-  bin_handler_t handler(locations, reader, costing);
+  bin_handler_t handler(locations, reader, costing, edge_reach);
   // search over the bins doing multiple locations per bin
   handler.search();
   // turn each locations candidate set into path locations
@@ -36,6 +36,31 @@ void loki_worker_t::status(Api& request) const {
   status->set_version(VALHALLA_VERSION);
   status->set_tileset_last_modified(get_tileset_last_modified(reader));
 
+  // how full the tile cache shared between processes is, this is cheap so we always report it
+  if (auto segment = reader->GetSharedTileSegment()) {
+    auto stats = segment->stats();
+    status->set_shared_tile_cache_capacity(stats.capacity);
+    status->set_shared_tile_cache_used(stats.used);
+    status->set_shared_tile_cache_tiles(stats.tiles);
+  }
+  if (auto segment = reader->GetSharedShortcutSegment()) {
+    auto stats = segment->stats();
+    status->set_shared_shortcut_cache_capacity(stats.capacity);
+    status->set_shared_shortcut_cache_used(stats.used);
+    status->set_shared_shortcut_cache_tiles(stats.tiles);
+  }
+
+  // same for the result cache
+  if (result_cache) {
+    auto stats = result_cache->stats();
+    status->set_result_cache_hits(stats.hits);
+    status->set_result_cache_misses(stats.misses);
+    status->set_result_cache_path_hits(stats.path_hits);
+    status->set_result_cache_path_misses(stats.path_misses);
+    status->set_result_cache_capacity(stats.capacity);
+    status->set_result_cache_used(stats.used);
+  }
+
   // only return more info if explicitly asked for (can be very expensive)
   // bail if we wont be getting extra info
   if (!request.options().verbose() || !allow_verbose)
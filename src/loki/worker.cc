@@ -9,6 +9,7 @@
 
 #include "baldr/json.h"
 #include "baldr/rapidjson_utils.h"
+#include "baldr/traffictile.h"
 #include "midgard/logging.h"
 #include "sif/autocost.h"
 #include "sif/bicyclecost.h"
@@ -18,6 +19,7 @@
 #include "tyr/actor.h"
 
 #include "loki/polygon_search.h"
+#include "loki/reach.h"
 #include "loki/search.h"
 #include "loki/worker.h"
 
@@ -28,6 +30,18 @@ using namespace valhalla::baldr;
 using namespace valhalla::sif;
 using namespace valhalla::loki;
 
+#ifdef HAVE_HTTP
+namespace {
+
+// thor is next so we leave out what it wont look at
+std::string serialize_to_pbf(Api& request) {
+  prune_for(Stage::kThor, request);
+  return request.SerializeAsString();
+}
+
+} // namespace
+#endif
+
 namespace valhalla {
 namespace loki {
 void loki_worker_t::parse_locations(google::protobuf::RepeatedPtrField<valhalla::Location>* locations,
@@ -104,7 +118,7 @@ void loki_worker_t::parse_costing(Api& api, bool allow_none) {
     }
     try {
       auto exclude_locations = PathLocation::fromPBF(options.exclude_locations());
-      auto results = loki::Search(exclude_locations, *reader, costing);
+      auto results = loki::Search(exclude_locations, *reader, costing, precomputed_reach(options));
       std::unordered_set<uint64_t> avoids;
       auto& co = *options.mutable_costings()->find(options.costing_type())->second.mutable_options();
       for (const auto& result : results) {
@@ -245,10 +259,121 @@ loki_worker_t::loki_worker_t(const boost::property_tree::ptree& config,
   max_alternates = config.get<unsigned int>("service_limits.max_alternates");
   allow_verbose = config.get<bool>("service_limits.status.allow_verbose", false);
 
+  // the component labels are optional, without them we only have the coarser connectivity map
+  if (config.get<bool>("loki.use_component_labels", false)) {
+    auto labels_file =
+        GraphReader::FindSidecar(config.get_child("mjolnir"), ComponentLabels::kFileName);
+    try {
+      if (labels_file.empty()) {
+        throw std::runtime_error(std::string(ComponentLabels::kFileName) +
+                                 " is neither in the tile_dir nor next to the tile_extract, "
+                                 "build it with valhalla_build_tiles -s components -e components");
+      }
+      component_labels = std::make_shared<ComponentLabels>(labels_file);
+    } catch (const std::exception& e) {
+      LOG_WARN("Not using component labels: " + std::string(e.what()));
+    }
+  }
+
+  // same goes for the precomputed reach
+  if (config.get<bool>("loki.use_precomputed_reach", false)) {
+    auto reach_file = GraphReader::FindSidecar(config.get_child("mjolnir"), EdgeReach::kFileName);
+    try {
+      if (reach_file.empty()) {
+        throw std::runtime_error(std::string(EdgeReach::kFileName) +
+                                 " is neither in the tile_dir nor next to the tile_extract, "
+                                 "build it with valhalla_build_tiles -s reach -e reach");
+      }
+      edge_reach = std::make_shared<EdgeReach>(reach_file);
+      for (auto type : kPrecomputedReachCostings) {
+        precomputed_reach_keys[type] = reach_access_key(default_costing(type).options());
+      }
+    } catch (const std::exception& e) {
+      LOG_WARN("Not using precomputed reach: " + std::string(e.what()));
+    }
+  }
+
   // signal that the worker started successfully
   started();
 }
 
+bool loki_worker_t::component_mode(const Options& options, ComponentLabels::Mode& mode) const {
+  if (!component_labels) {
+    return false;
+  }
+
+  // only the costings whose access mask the labels were built from, multimodal and the like can
+  // get places these modes cant
+  switch (options.costing_type()) {
+    case Costing::auto_:
+    case Costing::bicycle:
+    case Costing::pedestrian:
+    case Costing::truck:
+      break;
+    default:
+      return false;
+  }
+
+  // the labels follow oneways and access so if those are ignored anything might be reachable
+  const auto& co = options.costings().find(options.costing_type())->second.options();
+  if (co.ignore_oneways() || co.ignore_access()) {
+    return false;
+  }
+  return ComponentLabels::mode_for_access(costing->access_mode(), mode);
+}
+
+bool loki_worker_t::may_reach(const valhalla::Location& origin,
+                              const valhalla::Location& destination,
+                              ComponentLabels::Mode mode) const {
+  // we only trust the labels for tiles that still look like the ones they were built from
+  auto labelled = [this](const GraphId& node) {
+    auto tile = node.Is_Valid() ? reader->GetGraphTile(node) : nullptr;
+    return tile && component_labels->node_count(node) == tile->header()->nodecount();
+  };
+
+  for (const auto& from_edge : origin.correlation().edges()) {
+    // we leave the origin along its edge so we start at its end node
+    GraphId from_id(from_edge.graph_id());
+    const auto* edge = reader->directededge(from_id);
+    auto from_node = edge ? edge->endnode() : GraphId();
+    if (!labelled(from_node)) {
+      return true;
+    }
+
+    for (const auto& to_edge : destination.correlation().edges()) {
+      // a path along a single edge never gets to a node
+      GraphId to_id(to_edge.graph_id());
+      if (from_id == to_id) {
+        return true;
+      }
+
+      // and we arrive at the destination along its edge so we need to get to its start node
+      auto to_node = reader->edge_startnode(to_id);
+      if (!labelled(to_node) || component_labels->MayReach(from_node, to_node, mode)) {
+        return true;
+      }
+    }
+  }
+
+  // none of the edges could possibly get there, no edges at all is someone elses problem
+  return origin.correlation().edges_size() == 0 || destination.correlation().edges_size() == 0;
+}
+
+std::shared_ptr<const EdgeReach> loki_worker_t::precomputed_reach(const Options& options) const {
+  auto key = precomputed_reach_keys.find(options.costing_type());
+  if (!edge_reach || key == precomputed_reach_keys.cend()) {
+    return nullptr;
+  }
+
+  // preferences dont matter but anything that changes which edges can be used does
+  auto costing = options.costings().find(options.costing_type());
+  if (costing == options.costings().cend() ||
+      reach_access_key(costing->second.options()) != key->second) {
+    return nullptr;
+  }
+  return edge_reach;
+}
+
 void loki_worker_t::cleanup() {
   service_worker_t::cleanup();
   if (reader->OverCommitted()) {
@@ -270,7 +395,9 @@ loki_worker_t::work(const std::list<zmq::message_t>& job,
   // grab the request info and make sure to record any metrics before we are done
   auto& info = *static_cast<prime_server::http_request_info_t*>(request_info);
   LOG_INFO("Got Loki Request " + std::to_string(info.id));
-  Api request;
+  // the request lives in an arena backed by a buffer we reuse between requests
+  google::protobuf::Arena arena(arena_options());
+  Api& request = *google::protobuf::Arena::CreateMessage<Api>(&arena);
   prime_server::worker_t::result_t result{true, {}, ""};
   try {
     // request parsing
@@ -287,51 +414,63 @@ loki_worker_t::work(const std::list<zmq::message_t>& job,
 
     // Set the interrupt function
     service_worker_t::set_interrupt(&interrupt_function);
-    // do request specific processing
-    switch (options.action()) {
-      case Options::route:
-      case Options::centroid:
-        route(request);
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      case Options::locate:
-        result = to_response(locate(request), info, request);
-        break;
-      case Options::sources_to_targets:
-      case Options::optimized_route:
-        matrix(request);
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      case Options::isochrone:
-        isochrones(request);
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      case Options::trace_attributes:
-      case Options::trace_route:
-        trace(request);
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      case Options::height:
-        result = to_response(height(request), info, request);
-        break;
-      case Options::transit_available:
-        result = to_response(transit_available(request), info, request);
-        break;
-      case Options::status:
-        status(request);
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      case Options::expansion:
-        if (options.expansion_action() == Options::route) {
+    // read the same live traffic for the whole request, even while it is being updated
+    baldr::TrafficSnapshot traffic(traffic_epoch(request));
+    // if we already answered the same request we can send that straight back
+    auto key = result_cache ? result_cache->Key(ResultCache::Kind::kResponse, options,
+                                                reader->GetTilesetId())
+                            : std::string();
+    request.mutable_info()->set_cache_key(key);
+    std::string cached;
+    if (!key.empty() && result_cache->Find(ResultCache::Kind::kResponse, key, cached)) {
+      result = to_response(cached, info, request);
+    } else {
+      // do request specific processing
+      switch (options.action()) {
+        case Options::route:
+        case Options::centroid:
           route(request);
-        } else {
+          result.messages.emplace_back(serialize_to_pbf(request));
+          break;
+        case Options::locate:
+          result = to_response(locate(request), info, request);
+          break;
+        case Options::sources_to_targets:
+        case Options::optimized_route:
+          matrix(request);
+          result.messages.emplace_back(serialize_to_pbf(request));
+          break;
+        case Options::isochrone:
           isochrones(request);
-        }
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      default:
-        // apparently you wanted something that we figured we'd support but havent written yet
-        throw valhalla_exception_t{107};
+          result.messages.emplace_back(serialize_to_pbf(request));
+          break;
+        case Options::trace_attributes:
+        case Options::trace_route:
+          trace(request);
+          result.messages.emplace_back(serialize_to_pbf(request));
+          break;
+        case Options::height:
+          result = to_response(height(request), info, request);
+          break;
+        case Options::transit_available:
+          result = to_response(transit_available(request), info, request);
+          break;
+        case Options::status:
+          status(request);
+          result.messages.emplace_back(serialize_to_pbf(request));
+          break;
+        case Options::expansion:
+          if (options.expansion_action() == Options::route) {
+            route(request);
+          } else {
+            isochrones(request);
+          }
+          result.messages.emplace_back(serialize_to_pbf(request));
+          break;
+        default:
+          // apparently you wanted something that we figured we'd support but havent written yet
+          throw valhalla_exception_t{107};
+      }
     }
   } catch (const valhalla_exception_t& e) {
     LOG_WARN("400::" + std::string(e.what()) + " request_id=" + std::to_string(info.id));
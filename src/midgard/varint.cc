@@ -0,0 +1,304 @@
+#include "midgard/varint.h"
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define VALHALLA_VARINT_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using namespace valhalla::midgard::varint;
+
+// the sign bit goes to the least significant end so that small negative numbers stay small
+inline uint32_t zigzag(int32_t value) {
+  return value < 0 ? ~(static_cast<uint32_t>(value) << 1) : static_cast<uint32_t>(value) << 1;
+}
+
+// the polyline format undoes the zigzag before the shift and the shape7 format after it, they only
+// differ when the value doesnt fit in 31 bits but we keep them apart to match what we always did
+inline int32_t unzigzag5(uint32_t value) {
+  auto result = static_cast<int32_t>(value);
+  return result & 1 ? ~(result >> 1) : (result >> 1);
+}
+
+inline int32_t unzigzag7(uint32_t value) {
+  auto result = static_cast<int32_t>(value);
+  return (result & 1 ? ~result : result) >> 1;
+}
+
+// one value a byte at a time, false if the input ends before the value does
+bool decode5_value(const char*& begin, const char* end, int32_t& value) {
+  const char* pos = begin;
+  int32_t byte;
+  uint32_t shift = 0, result = 0;
+  do {
+    if (pos == end) {
+      return false;
+    }
+    // take the least significant 5 bits shifted into place
+    byte = int32_t(*pos++) - 63;
+    if (shift < 32) {
+      result |= static_cast<uint32_t>(byte & 0x1f) << shift;
+    }
+    shift += 5;
+    // if the most significant bit is set there is more to this number
+  } while (byte >= 0x20);
+  value = unzigzag5(result);
+  begin = pos;
+  return true;
+}
+
+bool decode7_value(const char*& begin, const char* end, int32_t& value) {
+  const char* pos = begin;
+  int32_t byte;
+  uint32_t shift = 0, result = 0;
+  do {
+    if (pos == end) {
+      return false;
+    }
+    // take the least significant 7 bits shifted into place
+    byte = *pos++;
+    if (shift < 32) {
+      result |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    }
+    shift += 7;
+    // if the most significant bit is set there is more to this number
+  } while (byte & 0x80);
+  value = unzigzag7(result);
+  begin = pos;
+  return true;
+}
+
+size_t decode5_scalar(const char*& begin, const char* end, int32_t* values, size_t count) {
+  size_t decoded = 0;
+  while (decoded < count && decode5_value(begin, end, values[decoded])) {
+    ++decoded;
+  }
+  return decoded;
+}
+
+size_t decode7_scalar(const char*& begin, const char* end, int32_t* values, size_t count) {
+  size_t decoded = 0;
+  while (decoded < count && decode7_value(begin, end, values[decoded])) {
+    ++decoded;
+  }
+  return decoded;
+}
+
+void encode5_scalar(const int32_t* values, size_t count, std::string& output) {
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t number = zigzag(values[i]);
+    // write 5 bit chunks of the number
+    while (number >= 0x20) {
+      output.push_back(static_cast<char>((0x20 | (number & 0x1f)) + 63));
+      number >>= 5;
+    }
+    // write the last chunk
+    output.push_back(static_cast<char>(number + 63));
+  }
+}
+
+void encode7_scalar(const int32_t* values, size_t count, std::string& output) {
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t number = zigzag(values[i]);
+    // we take 7 bits of this at a time, marking the most significant bit means there are more
+    while (number > 0x7f) {
+      output.push_back(static_cast<char>(0x80 | (number & 0x7f)));
+      number >>= 7;
+    }
+    // write the last chunk
+    output.push_back(static_cast<char>(number));
+  }
+}
+
+#ifdef VALHALLA_VARINT_SIMD
+
+// a one in the lowest bit of each of the first n bytes of a word
+inline uint64_t low_bytes(uint32_t n) {
+  return n >= 8 ? 0x0101010101010101ULL : 0x0101010101010101ULL & ((1ULL << (n * 8)) - 1);
+}
+
+// finds where each value ends 16 bytes at a time and then pulls the payload bits of each value out
+// of the bytes in one go. a value has to end within 8 bytes of where it starts for that to work
+// which is always the case unless the input is garbage, the odd ones go the slow way
+template <uint64_t kPayload, bool kPolyline>
+__attribute__((target("bmi2"))) size_t
+decode_simd(const char*& begin, const char* end, int32_t* values, size_t count) {
+  size_t decoded = 0;
+  alignas(16) uint8_t block[24] = {};
+  while (decoded < count && end - begin >= 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    uint32_t ends;
+    if (kPolyline) {
+      // a chunk without the continuation bit is below 0x20 + 63, the payload is the byte - 63 which
+      // in the lowest 5 bits is the same as adding 1 without the borrows
+      ends = _mm_movemask_epi8(_mm_cmplt_epi8(bytes, _mm_set1_epi8(0x20 + 63)));
+      bytes = _mm_add_epi8(bytes, _mm_set1_epi8(1));
+    } else {
+      ends = ~_mm_movemask_epi8(bytes) & 0xffff;
+    }
+    _mm_store_si128(reinterpret_cast<__m128i*>(block), bytes);
+
+    // take all of the values that end in this block
+    uint32_t offset = 0;
+    while (ends && decoded < count) {
+      uint32_t length = __builtin_ctz(ends) + 1 - offset;
+      if (length > 8) {
+        break;
+      }
+      uint64_t word;
+      std::memcpy(&word, block + offset, sizeof(word));
+      uint64_t mask = length == 8 ? kPayload : kPayload & ((1ULL << (length * 8)) - 1);
+      auto result = static_cast<uint32_t>(_pext_u64(word, mask));
+      values[decoded++] = kPolyline ? unzigzag5(result) : unzigzag7(result);
+      offset += length;
+      ends &= ends - 1;
+    }
+    begin += offset;
+
+    // a value that goes on for too long
+    if (offset == 0) {
+      bool ok = kPolyline ? decode5_value(begin, end, values[decoded])
+                          : decode7_value(begin, end, values[decoded]);
+      if (!ok) {
+        return decoded;
+      }
+      ++decoded;
+    }
+  }
+
+  // the last few bytes
+  return decoded + (kPolyline ? decode5_scalar(begin, end, values + decoded, count - decoded)
+                              : decode7_scalar(begin, end, values + decoded, count - decoded));
+}
+
+// how many chunks a value needs by the number of leading zeros it has, dividing is slower
+template <uint32_t kBits> struct lengths_t {
+  uint8_t chunks[32];
+  constexpr lengths_t() : chunks() {
+    for (uint32_t zeros = 0; zeros < 32; ++zeros) {
+      chunks[zeros] = (32 - zeros + kBits - 1) / kBits;
+    }
+  }
+};
+
+// scatters the bits of each value into its chunks with one pdep and writes all of them at once
+template <uint32_t kBits, uint64_t kPayload, uint8_t kMore, uint8_t kOffset>
+__attribute__((target("bmi2"))) void
+encode_simd(const int32_t* values, size_t count, std::string& output) {
+  // the whole word is written each time so the buffer has room for one more than we use
+  constexpr size_t kChunk = 64;
+  constexpr uint32_t kMaxBytes = (32 + kBits - 1) / kBits;
+  constexpr lengths_t<kBits> kLengths{};
+  char buffer[kChunk * kMaxBytes + sizeof(uint64_t)];
+  for (size_t chunk = 0; chunk < count; chunk += kChunk) {
+    char* pos = buffer;
+    for (size_t i = chunk; i < count && i < chunk + kChunk; ++i) {
+      uint32_t number = zigzag(values[i]);
+      uint32_t length = kLengths.chunks[__builtin_clz(number | 1)];
+      uint64_t word = _pdep_u64(number, kPayload) | low_bytes(length - 1) * kMore;
+      word += low_bytes(length) * kOffset;
+      std::memcpy(pos, &word, sizeof(word));
+      pos += length;
+    }
+    output.append(buffer, pos);
+  }
+}
+
+size_t decode5_simd(const char*& begin, const char* end, int32_t* values, size_t count) {
+  return decode_simd<0x1f1f1f1f1f1f1f1fULL, true>(begin, end, values, count);
+}
+
+size_t decode7_simd(const char*& begin, const char* end, int32_t* values, size_t count) {
+  return decode_simd<0x7f7f7f7f7f7f7f7fULL, false>(begin, end, values, count);
+}
+
+void encode5_simd(const int32_t* values, size_t count, std::string& output) {
+  encode_simd<5, 0x1f1f1f1f1f1f1f1fULL, 0x20, 63>(values, count, output);
+}
+
+void encode7_simd(const int32_t* values, size_t count, std::string& output) {
+  encode_simd<7, 0x7f7f7f7f7f7f7f7fULL, 0x80, 0>(values, count, output);
+}
+
+bool simd_supported() {
+  __builtin_cpu_init();
+  // before zen 3 amd does pdep and pext in microcode which is much slower than the scalar loops
+  return __builtin_cpu_supports("bmi2") &&
+         !(__builtin_cpu_is("amd") && (__builtin_cpu_is("znver1") || __builtin_cpu_is("znver2")));
+}
+
+#endif
+
+struct kernels_t {
+  Kernel kernel;
+  size_t (*decode5)(const char*&, const char*, int32_t*, size_t);
+  size_t (*decode7)(const char*&, const char*, int32_t*, size_t);
+  void (*encode5)(const int32_t*, size_t, std::string&);
+  void (*encode7)(const int32_t*, size_t, std::string&);
+};
+
+const kernels_t kScalarKernels{Kernel::kScalar, decode5_scalar, decode7_scalar, encode5_scalar,
+                               encode7_scalar};
+#ifdef VALHALLA_VARINT_SIMD
+const kernels_t kSimdKernels{Kernel::kSimd, decode5_simd, decode7_simd, encode5_simd,
+                             encode7_simd};
+#endif
+
+// anything decoding during static initialization gets the scalar kernels until we pick
+std::atomic<const kernels_t*> kernels{&kScalarKernels};
+const bool kPicked = use_kernel(Kernel::kSimd);
+
+inline const kernels_t& active() {
+  return *kernels.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+namespace valhalla {
+namespace midgard {
+namespace varint {
+
+Kernel active_kernel() {
+  return active().kernel;
+}
+
+bool use_kernel(Kernel kernel) {
+  switch (kernel) {
+    case Kernel::kScalar:
+      kernels.store(&kScalarKernels, std::memory_order_relaxed);
+      return true;
+    case Kernel::kSimd:
+#ifdef VALHALLA_VARINT_SIMD
+      if (simd_supported()) {
+        kernels.store(&kSimdKernels, std::memory_order_relaxed);
+        return true;
+      }
+#endif
+      return false;
+  }
+  return false;
+}
+
+size_t decode5(const char*& begin, const char* end, int32_t* values, size_t count) {
+  return active().decode5(begin, end, values, count);
+}
+
+size_t decode7(const char*& begin, const char* end, int32_t* values, size_t count) {
+  return active().decode7(begin, end, values, count);
+}
+
+void encode5(const int32_t* values, size_t count, std::string& output) {
+  active().encode5(values, count, output);
+}
+
+void encode7(const int32_t* values, size_t count, std::string& output) {
+  active().encode7(values, count, output);
+}
+
+} // namespace varint
+} // namespace midgard
+} // namespace valhalla
@@ -0,0 +1,123 @@
+#include "midgard/workerpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace valhalla {
+namespace midgard {
+
+struct WorkerPool::Job {
+  Job(size_t count, const std::function<void(size_t)>& task)
+      : task(task), count(count), next(0), done(0), errors(count) {
+  }
+
+  // runs tasks until they have all been handed out
+  void Run() {
+    for (size_t i = next++; i < count; i = next++) {
+      try {
+        task(i);
+      } catch (...) { errors[i] = std::current_exception(); }
+      if (++done == count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        done_cv.notify_all();
+      }
+    }
+  }
+
+  // the caller waits for the job so the task outlives every call to it
+  const std::function<void(size_t)>& task;
+  const size_t count;
+  std::atomic<size_t> next;
+  std::atomic<size_t> done;
+  std::vector<std::exception_ptr> errors;
+  std::mutex mutex;
+  std::condition_variable done_cv;
+};
+
+WorkerPool::WorkerPool(size_t threads) : stop_(false) {
+  threads_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    threads_.emplace_back(&WorkerPool::Work, this);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+
+  // let the pool in on it and do our share
+  auto job = std::make_shared<Job>(count, task);
+  if (count > 1 && !threads_.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back(job);
+    }
+    work_cv_.notify_all();
+  }
+  job->Run();
+
+  // everything has been handed out so there is nothing left for the pool to pick up
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto queued = std::find(jobs_.begin(), jobs_.end(), job);
+    if (queued != jobs_.end()) {
+      jobs_.erase(queued);
+    }
+  }
+
+  // wait for the tasks the pool is still running
+  {
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->done_cv.wait(lock, [&job]() { return job->done == job->count; });
+  }
+
+  for (const auto& error : job->errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+void WorkerPool::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+    if (jobs_.empty()) {
+      return;
+    }
+
+    // help with the oldest job, once we come back everything in it has been handed out
+    auto job = jobs_.front();
+    lock.unlock();
+    job->Run();
+    lock.lock();
+    if (!jobs_.empty() && jobs_.front() == job) {
+      jobs_.pop_front();
+    }
+  }
+}
+
+std::shared_ptr<WorkerPool> SharedWorkerPool::Get(size_t threads) {
+  threads = threads > 0 ? threads - 1 : 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!pool_ || pool_->size() != threads) {
+    pool_ = std::make_shared<WorkerPool>(threads);
+  }
+  return pool_;
+}
+
+} // namespace midgard
+} // namespace valhalla
@@ -7,6 +7,37 @@
 #include <sqlite3.h>
 #include <unordered_map>
 
+namespace {
+
+// Orientations closer to 0 than this are treated as collinear
+constexpr double kCollinear = 1e-12;
+
+double orientation(double ax, double ay, double bx, double by, double cx, double cy) {
+  return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+// Whether the path from a to b properly crosses the segment, sets degenerate if it touches the
+// segment or passes through one of its ends since then counting crossings doesnt work
+template <typename segment_t>
+bool crosses(double ax, double ay, double bx, double by, const segment_t& s, bool& degenerate) {
+  if (std::max(ax, bx) < std::min(s.x1, s.x2) || std::min(ax, bx) > std::max(s.x1, s.x2) ||
+      std::max(ay, by) < std::min(s.y1, s.y2) || std::min(ay, by) > std::max(s.y1, s.y2)) {
+    return false;
+  }
+  auto o1 = orientation(ax, ay, bx, by, s.x1, s.y1);
+  auto o2 = orientation(ax, ay, bx, by, s.x2, s.y2);
+  auto o3 = orientation(s.x1, s.y1, s.x2, s.y2, ax, ay);
+  auto o4 = orientation(s.x1, s.y1, s.x2, s.y2, bx, by);
+  if (std::abs(o1) < kCollinear || std::abs(o2) < kCollinear || std::abs(o3) < kCollinear ||
+      std::abs(o4) < kCollinear) {
+    degenerate = true;
+    return false;
+  }
+  return (o1 > 0) != (o2 > 0) && (o3 > 0) != (o4 > 0);
+}
+
+} // namespace
+
 namespace valhalla {
 namespace mjolnir {
 
@@ -66,6 +97,169 @@ uint32_t GetMultiPolyId(const std::multimap<uint32_t, multi_polygon_type>& polys
   return index;
 }
 
+PolygonIndex::PolygonIndex(const std::multimap<uint32_t, multi_polygon_type>& polys,
+                           const AABB2<PointLL>& bounds,
+                           uint32_t divisions)
+    : bounds_(bounds), divisions_(divisions), cell_width_(bounds.Width() / divisions),
+      cell_height_(bounds.Height() / divisions) {
+  for (const auto& poly : polys) {
+    polygons_.emplace_back(poly.first, &poly.second);
+  }
+  // everything is outside of an empty grid so the polygons are tested one by one
+  if (polygons_.size() < 2 || divisions_ == 0 || cell_width_ <= 0 || cell_height_ <= 0) {
+    divisions_ = 0;
+    return;
+  }
+
+  auto cell_count = divisions_ * divisions_;
+  std::vector<std::vector<entry_t>> cell_entries(cell_count);
+  std::vector<segment_t> segments;
+  std::vector<std::vector<uint32_t>> cell_segments(cell_count);
+  std::vector<bool> inside(cell_count);
+  for (uint32_t polygon = 0; polygon < polygons_.size(); ++polygon) {
+    // find which cells each of the polygon's segments could be in
+    segments.clear();
+    for (auto& c : cell_segments) {
+      c.clear();
+    }
+    auto add_ring = [&](const polygon_type::ring_type& ring) {
+      for (size_t i = 1; i < ring.size(); ++i) {
+        segment_t s{ring[i - 1].x(), ring[i - 1].y(), ring[i].x(), ring[i].y()};
+        auto min_col = std::floor((std::min(s.x1, s.x2) - bounds_.minx()) / cell_width_);
+        auto max_col = std::floor((std::max(s.x1, s.x2) - bounds_.minx()) / cell_width_);
+        auto min_row = std::floor((std::min(s.y1, s.y2) - bounds_.miny()) / cell_height_);
+        auto max_row = std::floor((std::max(s.y1, s.y2) - bounds_.miny()) / cell_height_);
+        if (max_col < 0 || max_row < 0 || min_col >= divisions_ || min_row >= divisions_) {
+          continue;
+        }
+        auto id = static_cast<uint32_t>(segments.size());
+        segments.push_back(s);
+        for (auto row = static_cast<uint32_t>(std::max(min_row, 0.));
+             row <= static_cast<uint32_t>(std::min<double>(max_row, divisions_ - 1)); ++row) {
+          for (auto col = static_cast<uint32_t>(std::max(min_col, 0.));
+               col <= static_cast<uint32_t>(std::min<double>(max_col, divisions_ - 1)); ++col) {
+            cell_segments[row * divisions_ + col].push_back(id);
+          }
+        }
+      }
+    };
+    for (const auto& part : *polygons_[polygon].second) {
+      add_ring(part.outer());
+      for (const auto& inner : part.inners()) {
+        add_ring(inner);
+      }
+    }
+
+    // walk from cell center to cell center to find which are inside, only the first one and any
+    // we cant get to by counting crossings need an exact test
+    for (uint32_t cell = 0; cell < cell_count; ++cell) {
+      auto to = center(cell);
+      if (cell == 0) {
+        inside[cell] =
+            boost::geometry::covered_by(point_type(to.lng(), to.lat()), *polygons_[polygon].second);
+        continue;
+      }
+      auto previous = cell % divisions_ ? cell - 1 : cell - divisions_;
+      auto from = center(previous);
+      // the segments of both cells, some are in both but must only be counted once
+      const auto& a = cell_segments[previous];
+      const auto& b = cell_segments[cell];
+      bool degenerate = false, crossed = false;
+      for (size_t i = 0, j = 0; (i < a.size() || j < b.size()) && !degenerate;) {
+        uint32_t id;
+        if (j == b.size() || (i < a.size() && a[i] < b[j])) {
+          id = a[i++];
+        } else if (i == a.size() || b[j] < a[i]) {
+          id = b[j++];
+        } else {
+          id = a[i++];
+          ++j;
+        }
+        crossed ^= crosses(from.lng(), from.lat(), to.lng(), to.lat(), segments[id], degenerate);
+      }
+      inside[cell] = degenerate ? boost::geometry::covered_by(point_type(to.lng(), to.lat()),
+                                                              *polygons_[polygon].second)
+                                : inside[previous] != crossed;
+    }
+
+    // keep the polygon in the cells it covers or crosses
+    for (uint32_t cell = 0; cell < cell_count; ++cell) {
+      if (cell_segments[cell].empty() && !inside[cell]) {
+        continue;
+      }
+      entry_t entry{polygon, static_cast<uint32_t>(segments_.size()), 0,
+                    static_cast<bool>(inside[cell])};
+      for (auto id : cell_segments[cell]) {
+        segments_.push_back(segments[id]);
+      }
+      entry.end = static_cast<uint32_t>(segments_.size());
+      cell_entries[cell].push_back(entry);
+    }
+  }
+
+  // flatten the cells
+  cells_.reserve(cell_count + 1);
+  for (const auto& entries : cell_entries) {
+    cells_.push_back(static_cast<uint32_t>(entries_.size()));
+    entries_.insert(entries_.end(), entries.begin(), entries.end());
+  }
+  cells_.push_back(static_cast<uint32_t>(entries_.size()));
+}
+
+int32_t PolygonIndex::cell_of(const PointLL& ll) const {
+  if (divisions_ == 0 || !bounds_.Contains(ll)) {
+    return -1;
+  }
+  auto col = std::min(static_cast<uint32_t>((ll.lng() - bounds_.minx()) / cell_width_),
+                      divisions_ - 1);
+  auto row = std::min(static_cast<uint32_t>((ll.lat() - bounds_.miny()) / cell_height_),
+                      divisions_ - 1);
+  return row * divisions_ + col;
+}
+
+PointLL PolygonIndex::center(uint32_t cell) const {
+  return {bounds_.minx() + (cell % divisions_ + .5) * cell_width_,
+          bounds_.miny() + (cell / divisions_ + .5) * cell_height_};
+}
+
+bool PolygonIndex::covers(const entry_t& entry, uint32_t cell, const PointLL& ll) const {
+  // no boundary in this cell so its all inside
+  if (entry.begin == entry.end) {
+    return true;
+  }
+  // count the crossings on the way from the center to the point
+  auto from = center(cell);
+  bool degenerate = false, crossed = false;
+  for (auto s = entry.begin; s < entry.end && !degenerate; ++s) {
+    crossed ^= crosses(from.lng(), from.lat(), ll.lng(), ll.lat(), segments_[s], degenerate);
+  }
+  if (degenerate) {
+    return boost::geometry::covered_by(point_type(ll.lng(), ll.lat()),
+                                       *polygons_[entry.polygon].second);
+  }
+  return entry.center_inside != crossed;
+}
+
+// Get the polygon index.  Used by admin areas.  Looks the polygons up in the index.
+uint32_t GetMultiPolyId(const PolygonIndex& index, const PointLL& ll, GraphTileBuilder& graphtile) {
+  uint32_t found = 0;
+  index.covering(ll, [&found, &graphtile](uint32_t id) {
+    found = id;
+    return graphtile.admins_builder(id).state_offset() != 0;
+  });
+  return found;
+}
+
+// Get the polygon index.  Used by tz and admin areas.  Looks the polygons up in the index.
+uint32_t GetMultiPolyId(const PolygonIndex& index, const PointLL& ll) {
+  uint32_t found = 0;
+  index.covering(ll, [&found](uint32_t id) {
+    found = id;
+    return true;
+  });
+  return found;
+}
+
 // Get the timezone polys from the db
 std::multimap<uint32_t, multi_polygon_type> GetTimeZones(sqlite3* db_handle,
                                                          const AABB2<PointLL>& aabb) {
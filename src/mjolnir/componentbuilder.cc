@@ -0,0 +1,295 @@
+#include "mjolnir/componentbuilder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "baldr/componentlabels.h"
+#include "baldr/graphconstants.h"
+#include "baldr/graphid.h"
+#include "baldr/graphreader.h"
+#include "baldr/graphtile.h"
+#include "baldr/tilehierarchy.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+
+using namespace valhalla::baldr;
+
+namespace {
+
+constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+
+// maps every node in the graph to a dense index and back so we can keep flat arrays per node
+class node_index_t {
+public:
+  explicit node_index_t(GraphReader& reader) : node_count_(0) {
+    // sorted so that the sidecar can binary search them, transit nodes arent routable by themselves
+    for (const auto& tile_id : reader.GetTileSet()) {
+      if (tile_id.level() != TileHierarchy::GetTransitLevel().level) {
+        tiles_.push_back({tile_id.value, 0});
+      }
+    }
+    std::sort(tiles_.begin(), tiles_.end(),
+              [](const ComponentLabels::tile_t& a, const ComponentLabels::tile_t& b) {
+                return a.tile_id < b.tile_id;
+              });
+    for (auto& tile : tiles_) {
+      tile.node_offset = node_count_;
+      node_count_ += reader.GetGraphTile(GraphId(tile.tile_id))->header()->nodecount();
+      if (reader.OverCommitted()) {
+        reader.Trim();
+      }
+    }
+    if (node_count_ >= kUnvisited) {
+      throw std::runtime_error("Too many nodes to label components");
+    }
+  }
+
+  uint32_t node_count() const {
+    return node_count_;
+  }
+
+  const std::vector<ComponentLabels::tile_t>& tiles() const {
+    return tiles_;
+  }
+
+  // kUnvisited if the node isnt in the graph
+  uint32_t index(const GraphId& node) const {
+    auto key = node.Tile_Base().value;
+    auto found = std::lower_bound(tiles_.cbegin(), tiles_.cend(), key,
+                                  [](const ComponentLabels::tile_t& tile, uint64_t key) {
+                                    return tile.tile_id < key;
+                                  });
+    return found == tiles_.cend() || found->tile_id != key ? kUnvisited
+                                                           : found->node_offset + node.id();
+  }
+
+  GraphId node(uint32_t index) const {
+    auto found = std::upper_bound(tiles_.cbegin(), tiles_.cend(), index,
+                                  [](uint32_t index, const ComponentLabels::tile_t& tile) {
+                                    return index < tile.node_offset;
+                                  }) -
+                 1;
+    GraphId node(found->tile_id);
+    node.set_id(index - found->node_offset);
+    return node;
+  }
+
+protected:
+  std::vector<ComponentLabels::tile_t> tiles_;
+  uint32_t node_count_;
+};
+
+// appends the nodes we can get to from a node, either following the direction of travel or not.
+// shortcuts dont change what is reachable and transit lines are not usable by these modes
+void adjacent(GraphReader& reader,
+              const node_index_t& nodes,
+              uint32_t index,
+              uint16_t access,
+              bool directed,
+              std::vector<uint32_t>& adjacent) {
+  if (reader.OverCommitted()) {
+    reader.Trim();
+  }
+  auto node_id = nodes.node(index);
+  auto tile = reader.GetGraphTile(node_id);
+  const auto* node = tile->node(node_id);
+  const auto transit_level = TileHierarchy::GetTransitLevel().level;
+  for (const auto& edge : tile->GetDirectedEdges(node)) {
+    auto edge_access = edge.forwardaccess() | (directed ? 0 : edge.reverseaccess());
+    if (edge.is_shortcut() || edge.IsTransitLine() || edge.endnode().level() == transit_level ||
+        !(edge_access & access)) {
+      continue;
+    }
+    auto end = nodes.index(edge.endnode());
+    if (end != kUnvisited) {
+      adjacent.push_back(end);
+    }
+  }
+
+  // changing levels is free and always possible
+  for (const auto& transition : tile->GetNodeTransitions(node)) {
+    auto end = nodes.index(transition.endnode());
+    if (end != kUnvisited) {
+      adjacent.push_back(end);
+    }
+  }
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+ComponentBuilder::labels_t ComponentBuilder::Label(uint32_t node_count,
+                                                   const adjacency_t& successors,
+                                                   const adjacency_t& neighbors) {
+  // find the islands first, the breadth first order we visit them in is also the order we run
+  // tarjan in below so that every island ends up with a contiguous range of labels
+  std::vector<uint32_t> order;
+  order.reserve(node_count);
+  std::vector<size_t> island_starts;
+  std::vector<bool> seen(node_count, false);
+  std::vector<uint32_t> adjacent;
+  for (uint32_t root = 0; root < node_count; ++root) {
+    if (seen[root]) {
+      continue;
+    }
+    island_starts.push_back(order.size());
+    seen[root] = true;
+    order.push_back(root);
+    for (size_t i = island_starts.back(); i < order.size(); ++i) {
+      adjacent.clear();
+      neighbors(order[i], adjacent);
+      for (auto node : adjacent) {
+        if (!seen[node]) {
+          seen[node] = true;
+          order.push_back(node);
+        }
+      }
+    }
+  }
+
+  // iterative tarjan, each frame keeps the range of its successors in a shared stack which the
+  // frames above it push onto and pop off of again
+  struct frame_t {
+    uint32_t node;
+    size_t begin;
+    size_t next;
+    size_t end;
+  };
+  labels_t result;
+  result.labels.resize(node_count, kUnvisited);
+  std::vector<uint32_t> index(node_count, kUnvisited);
+  std::vector<uint32_t> low(node_count);
+  std::vector<bool>& on_stack = seen;
+  on_stack.assign(node_count, false);
+  std::vector<uint32_t> stack;
+  std::vector<frame_t> frames;
+  std::vector<uint32_t> pending;
+  uint32_t counter = 0, component = 0;
+
+  auto visit = [&](uint32_t node) {
+    index[node] = low[node] = counter++;
+    stack.push_back(node);
+    on_stack[node] = true;
+    auto begin = pending.size();
+    successors(node, pending);
+    frames.push_back({node, begin, begin, pending.size()});
+  };
+
+  auto next_island = island_starts.cbegin();
+  for (size_t i = 0; i < order.size(); ++i) {
+    // the previous island is completely labelled by now so this one starts with the next label
+    if (next_island != island_starts.cend() && *next_island == i) {
+      result.islands.push_back(component);
+      ++next_island;
+    }
+
+    auto root = order[i];
+    if (index[root] != kUnvisited) {
+      continue;
+    }
+    visit(root);
+    while (!frames.empty()) {
+      // keep going deeper while there are successors left
+      auto& frame = frames.back();
+      if (frame.next < frame.end) {
+        auto node = frame.node;
+        auto successor = pending[frame.next++];
+        if (index[successor] == kUnvisited) {
+          visit(successor);
+        } else if (on_stack[successor]) {
+          low[node] = std::min(low[node], index[successor]);
+        }
+        continue;
+      }
+
+      // done with this node, if its the root of a component then label the whole thing
+      auto node = frame.node;
+      pending.resize(frame.begin);
+      frames.pop_back();
+      if (low[node] == index[node]) {
+        uint32_t member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          on_stack[member] = false;
+          result.labels[member] = component;
+        } while (member != node);
+        ++component;
+      }
+      if (!frames.empty()) {
+        auto parent = frames.back().node;
+        low[parent] = std::min(low[parent], low[node]);
+      }
+    }
+  }
+
+  return result;
+}
+
+void ComponentBuilder::Build(const boost::property_tree::ptree& pt) {
+  auto tile_dir = pt.get<std::string>("mjolnir.tile_dir");
+  auto file_name = tile_dir + filesystem::path::preferred_separator + ComponentLabels::kFileName;
+  GraphReader reader(pt.get_child("mjolnir"));
+  node_index_t nodes(reader);
+  LOG_INFO("Labelling components of " + std::to_string(nodes.node_count()) + " nodes in " +
+           std::to_string(nodes.tiles().size()) + " tiles");
+
+  // label each mode in turn
+  std::vector<labels_t> modes;
+  for (auto access : ComponentLabels::kModeAccess) {
+    auto successors = [&](uint32_t node, std::vector<uint32_t>& out) {
+      adjacent(reader, nodes, node, access, true, out);
+    };
+    auto neighbors = [&](uint32_t node, std::vector<uint32_t>& out) {
+      adjacent(reader, nodes, node, access, false, out);
+    };
+    modes.emplace_back(Label(nodes.node_count(), successors, neighbors));
+    const auto& labels = modes.back().labels;
+    auto components = labels.empty() ? 0 : *std::max_element(labels.cbegin(), labels.cend()) + 1;
+    LOG_INFO("Access " + std::to_string(access) + " has " + std::to_string(components) +
+             " components on " + std::to_string(modes.back().islands.size()) + " islands");
+  }
+
+  // write it out next to the tiles, going through a temporary file so that nobody reads half of it
+  ComponentLabels::header_t header{};
+  header.magic = ComponentLabels::kMagic;
+  header.version = ComponentLabels::kVersion;
+  header.mode_count = ComponentLabels::kModeCount;
+  header.tile_count = nodes.tiles().size();
+  header.node_count = nodes.node_count();
+  for (size_t mode = 0; mode < modes.size(); ++mode) {
+    header.island_count[mode] = modes[mode].islands.size();
+  }
+  auto temp_name = file_name + ".tmp";
+  {
+    std::ofstream file(temp_name, std::ios::binary | std::ios::out | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(nodes.tiles().data()),
+               nodes.tiles().size() * sizeof(ComponentLabels::tile_t));
+    for (const auto& mode : modes) {
+      file.write(reinterpret_cast<const char*>(mode.labels.data()),
+                 mode.labels.size() * sizeof(uint32_t));
+    }
+    for (const auto& mode : modes) {
+      file.write(reinterpret_cast<const char*>(mode.islands.data()),
+                 mode.islands.size() * sizeof(uint32_t));
+    }
+    if (!file) {
+      throw std::runtime_error("Failed to write " + temp_name);
+    }
+  }
+  if (std::rename(temp_name.c_str(), file_name.c_str()) != 0) {
+    throw std::runtime_error("Failed to move " + temp_name + " to " + file_name);
+  }
+  LOG_INFO("Wrote component labels to " + file_name);
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -18,8 +18,7 @@
 
 #include "mjolnir/elevationbuilder.h"
 #include "mjolnir/graphtilebuilder.h"
-
-#include <deque>
+#include "mjolnir/tilescheduler.h"
 
 using namespace valhalla::midgard;
 using namespace valhalla::baldr;
@@ -38,10 +37,11 @@ void add_edge_elevation(uint32_t edgeIndex,
                         valhalla::skadi::sample* sample);
 
 /**
- * Adds elevation to a set of tiles. Each thread pulls a tile of the queue
+ * Adds elevation to a set of tiles. Each thread gets its tiles from the scheduler
  */
 void add_elevation(const boost::property_tree::ptree& pt,
-                   std::deque<GraphId>& tilequeue,
+                   TileScheduler& scheduler,
+                   unsigned int worker,
                    std::mutex& lock,
                    const std::unique_ptr<valhalla::skadi::sample>& sample,
                    bool embed_elevation,
@@ -56,17 +56,8 @@ void add_elevation(const boost::property_tree::ptree& pt,
       geo_attribute_cache;
 
   // Check for more tiles
-  while (true) {
-    lock.lock();
-    if (tilequeue.empty()) {
-      lock.unlock();
-      break;
-    }
-    // Get the next tile Id
-    GraphId tile_id = tilequeue.front();
-    tilequeue.pop_front();
-    lock.unlock();
-
+  GraphId tile_id;
+  while (scheduler.Next(worker, tile_id)) {
     // Get the tile. Serialize the entire tile?
     GraphTileBuilder tilebuilder(graphreader.tile_dir(), tile_id, true);
 
@@ -209,42 +200,39 @@ void ElevationBuilder::Build(const boost::property_tree::ptree& pt) {
     return;
   }
 
-  // Create a randomized queue of tiles (at all levels) to work from
-  std::deque<GraphId> tilequeue;
-  GraphReader reader(pt.get_child("mjolnir"));
-  auto tileset = reader.GetTileSet();
-  for (const auto& id : tileset) {
-    tilequeue.emplace_back(id);
-  }
-  std::random_device rd;
-  std::shuffle(tilequeue.begin(), tilequeue.end(), std::mt19937(rd()));
-
-  // An mutex we can use to do the synchronization
-  std::mutex lock;
-
   // Setup threads
   uint32_t nthreads =
       std::max(static_cast<unsigned int>(1),
                pt.get<unsigned int>("mjolnir.concurrency", std::thread::hardware_concurrency()));
   std::vector<std::shared_ptr<std::thread>> threads(nthreads);
 
+  // Schedule the tiles (at all levels), biggest first
+  GraphReader reader(pt.get_child("mjolnir"));
+  auto tileset = reader.GetTileSet();
+  TileScheduler scheduler("Adding elevation", tile_dir,
+                          std::vector<GraphId>(tileset.begin(), tileset.end()), nthreads);
+
+  // An mutex we can use to do the synchronization
+  std::mutex lock;
+
   // Setup promises. Hold the results for the threads
   std::vector<std::promise<uint32_t>> results(nthreads);
 
-  LOG_INFO("Adding elevation to " + std::to_string(tilequeue.size()) + " tiles with " +
+  LOG_INFO("Adding elevation to " + std::to_string(scheduler.size()) + " tiles with " +
            std::to_string(nthreads) + " threads...");
 
   // Spawn the threads
-  for (auto& thread : threads) {
-    results.emplace_back();
-    thread.reset(new std::thread(add_elevation, std::cref(pt), std::ref(tilequeue), std::ref(lock),
-                                 std::ref(sample), embed_elevation.value_or(false), std::ref(results.back())));
+  for (uint32_t i = 0; i < nthreads; ++i) {
+    threads[i].reset(new std::thread(add_elevation, std::cref(pt), std::ref(scheduler), i,
+                                     std::ref(lock), std::ref(sample),
+                                     embed_elevation.value_or(false), std::ref(results[i])));
   }
 
   // Wait for threads to finish
   for (auto& thread : threads) {
     thread->join();
   }
+  scheduler.LogStats();
 
   /** // Get the promise from the future
   for (auto& result : results) {
@@ -2,6 +2,7 @@
 #include "mjolnir/admin.h"
 #include "mjolnir/countryaccess.h"
 #include "mjolnir/graphtilebuilder.h"
+#include "mjolnir/tilescheduler.h"
 #include "mjolnir/util.h"
 #include "speed_assigner.h"
 
@@ -1309,12 +1310,13 @@ bool ConsistentNames(const std::string& country_code,
 }
 
 // We make sure to lock on reading and writing because we dont want to race
-// since difference threads, use for the tilequeue as well
+// since difference threads, the scheduler hands out the tiles
 void enhance(const boost::property_tree::ptree& pt,
              const OSMData& osmdata,
              const std::string& access_file,
              const boost::property_tree::ptree& hierarchy_properties,
-             std::queue<GraphId>& tilequeue,
+             TileScheduler& scheduler,
+             unsigned int worker,
              std::mutex& lock,
              std::promise<enhancer_stats>& result) {
 
@@ -1352,17 +1354,11 @@ void enhance(const boost::property_tree::ptree& pt,
   const auto& local_level = TileHierarchy::levels().back().level;
   const auto& tiles = TileHierarchy::levels().back().tiles;
 
-  // Iterate through the tiles in the queue and perform enhancements
-  while (true) {
-    // Get the next tile Id from the queue and get writeable and readable
-    // tile. Lock while we access the tile queue and get the tile.
+  // Iterate through the tiles we are given and perform enhancements
+  GraphId tile_id;
+  while (scheduler.Next(worker, tile_id)) {
+    // Get writeable and readable tile. Lock while we get the tile.
     lock.lock();
-    if (tilequeue.empty()) {
-      lock.unlock();
-      break;
-    }
-    GraphId tile_id = tilequeue.front();
-    tilequeue.pop();
 
     // Get a readable tile.If the tile is empty, skip it. Empty tiles are
     // added where ways go through a tile but no end not is within the tile.
@@ -1765,34 +1761,32 @@ void GraphEnhancer::Enhance(const boost::property_tree::ptree& pt,
   // A place to hold the results of those threads, exceptions or otherwise
   std::list<std::promise<enhancer_stats>> results;
 
-  // Create a randomized queue of tiles to work from
-  std::deque<GraphId> tempqueue;
+  // Schedule the local tiles, biggest first
   boost::property_tree::ptree hierarchy_properties = pt.get_child("mjolnir");
   auto local_level = TileHierarchy::levels().back().level;
   GraphReader reader(hierarchy_properties);
   auto local_tiles = reader.GetTileSet(local_level);
-  for (const auto& tile_id : local_tiles) {
-    tempqueue.emplace_back(tile_id);
-  }
-  std::random_device rd;
-  std::shuffle(tempqueue.begin(), tempqueue.end(), std::mt19937(rd()));
-  std::queue<GraphId> tilequeue(tempqueue);
+  TileScheduler scheduler("Enhancing", reader.tile_dir(),
+                          std::vector<GraphId>(local_tiles.begin(), local_tiles.end()),
+                          threads.size());
 
   // An atomic object we can use to do the synchronization
   std::mutex lock;
 
   // Start the threads
-  for (auto& thread : threads) {
+  for (unsigned int i = 0; i < threads.size(); ++i) {
     results.emplace_back();
-    thread.reset(new std::thread(enhance, std::cref(hierarchy_properties), std::cref(osmdata),
-                                 std::cref(access_file), std::ref(hierarchy_properties),
-                                 std::ref(tilequeue), std::ref(lock), std::ref(results.back())));
+    threads[i].reset(new std::thread(enhance, std::cref(hierarchy_properties), std::cref(osmdata),
+                                     std::cref(access_file), std::ref(hierarchy_properties),
+                                     std::ref(scheduler), i, std::ref(lock),
+                                     std::ref(results.back())));
   }
 
   // Wait for them to finish up their work
   for (auto& thread : threads) {
     thread->join();
   }
+  scheduler.LogStats();
 
   // Check all of the outcomes, to see about maximum density (km/km2)
   enhancer_stats stats{std::numeric_limits<float>::min(), 0, 0, 0, 0, 0, 0, {0}};
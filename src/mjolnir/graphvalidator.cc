@@ -1,6 +1,7 @@
 
 #include "mjolnir/graphvalidator.h"
 #include "mjolnir/graphtilebuilder.h"
+#include "mjolnir/tilescheduler.h"
 #include "mjolnir/util.h"
 
 #include <boost/format.hpp>
@@ -247,7 +248,8 @@ uint32_t GetOpposingEdgeIndex(const GraphId& startnode,
 using tweeners_t = GraphTileBuilder::tweeners_t;
 void validate(
     const boost::property_tree::ptree& pt,
-    std::deque<GraphId>& tilequeue,
+    TileScheduler& scheduler,
+    unsigned int worker,
     std::mutex& lock,
     std::promise<std::tuple<std::vector<uint32_t>, std::vector<std::vector<float>>, tweeners_t>>&
         result) {
@@ -269,17 +271,8 @@ void validate(
   std::set<uint32_t> problem_ways;
 
   // Check for more tiles
-  while (true) {
-    lock.lock();
-    if (tilequeue.empty()) {
-      lock.unlock();
-      break;
-    }
-    // Get the next tile Id
-    GraphId tile_id = tilequeue.front();
-    tilequeue.pop_front();
-    lock.unlock();
-
+  GraphId tile_id;
+  while (scheduler.Next(worker, tile_id)) {
     // Point tiles to the set we need for current level
     const auto& tiles = tile_id.level() == TileHierarchy::GetTransitLevel().level
                             ? TileHierarchy::levels().back().tiles
@@ -502,21 +495,15 @@ void merge(const tweeners_t& in, tweeners_t& out) {
 
 // crack open tiles and bin edges that pass through them but dont end or begin in them
 void bin_tweeners(const std::string& tile_dir,
-                  tweeners_t::iterator& start,
-                  const tweeners_t::iterator& end,
-                  uint64_t dataset_id,
-                  std::mutex& lock) {
+                  const tweeners_t& tweeners,
+                  TileScheduler& scheduler,
+                  unsigned int worker,
+                  uint64_t dataset_id) {
   // go while we have tiles to update
-  while (true) {
-    lock.lock();
-    if (start == end) {
-      lock.unlock();
-      break;
-    }
+  GraphId tile_id;
+  while (scheduler.Next(worker, tile_id)) {
     // grab this tile and its extra bin edges
-    const auto& tile_bin = *start;
-    ++start;
-    lock.unlock();
+    const auto& tile_bin = *tweeners.find(tile_id);
 
     // some tiles are just there because edges' shapes passes through them (no edges/nodes, just bins)
     // if that's the case we need to make a tile to store the spatial index (binned edges) there
@@ -542,45 +529,42 @@ void GraphValidator::Validate(const boost::property_tree::ptree& pt) {
   auto hierarchy_properties = pt.get_child("mjolnir");
   std::string tile_dir = hierarchy_properties.get<std::string>("tile_dir");
 
-  // Create a randomized queue of tiles (at all levels) to work from
-  std::deque<GraphId> tilequeue;
+  // Setup threads
+  std::vector<std::shared_ptr<std::thread>> threads(
+      std::max(static_cast<unsigned int>(1),
+               pt.get<unsigned int>("mjolnir.concurrency", std::thread::hardware_concurrency())));
+
+  // Schedule the tiles (at all levels), biggest first
   GraphReader reader(pt.get_child("mjolnir"));
   auto tileset = reader.GetTileSet();
-  for (const auto& id : tileset) {
-    tilequeue.emplace_back(id);
-  }
-  // fixed seed for reproducible tile build
-  std::shuffle(tilequeue.begin(), tilequeue.end(), std::mt19937(3));
+  std::vector<GraphId> tiles(tileset.begin(), tileset.end());
+  TileScheduler scheduler("Validating", tile_dir, tiles, threads.size());
 
   // Remember what the dataset id is in case we have to make some tiles
-  graph_tile_ptr first_tile = GraphTile::Create(tile_dir, *tilequeue.begin());
-  assert(tilequeue.size() && first_tile);
+  graph_tile_ptr first_tile = GraphTile::Create(tile_dir, *tiles.begin());
+  assert(tiles.size() && first_tile);
   auto dataset_id = first_tile->header()->dataset_id();
 
   // An mutex we can use to do the synchronization
   std::mutex lock;
 
-  // Setup threads
-  std::vector<std::shared_ptr<std::thread>> threads(
-      std::max(static_cast<unsigned int>(1),
-               pt.get<unsigned int>("mjolnir.concurrency", std::thread::hardware_concurrency())));
-
   // Setup promises
   std::list<
       std::promise<std::tuple<std::vector<uint32_t>, std::vector<std::vector<float>>, tweeners_t>>>
       results;
 
   // Spawn the threads
-  for (auto& thread : threads) {
+  for (unsigned int i = 0; i < threads.size(); ++i) {
     results.emplace_back();
-    thread.reset(new std::thread(validate, std::cref(pt), std::ref(tilequeue), std::ref(lock),
-                                 std::ref(results.back())));
+    threads[i].reset(new std::thread(validate, std::cref(pt), std::ref(scheduler), i,
+                                     std::ref(lock), std::ref(results.back())));
   }
 
   // Wait for threads to finish
   for (auto& thread : threads) {
     thread->join();
   }
+  scheduler.LogStats();
   // Get the promise from the future
   std::vector<uint32_t> duplicates(TileHierarchy::levels().size(), 0);
   std::vector<std::vector<float>> densities(3);
@@ -601,15 +585,20 @@ void GraphValidator::Validate(const boost::property_tree::ptree& pt) {
 
   // run a pass to add the edges that binned to tweener tiles
   LOG_INFO("Binning inter-tile edges...");
-  auto start = tweeners.begin();
-  auto end = tweeners.end();
-  for (auto& thread : threads) {
-    thread.reset(new std::thread(bin_tweeners, std::cref(tile_dir), std::ref(start), std::cref(end),
-                                 dataset_id, std::ref(lock)));
+  std::vector<GraphId> tweener_tiles;
+  tweener_tiles.reserve(tweeners.size());
+  for (const auto& tile_bin : tweeners) {
+    tweener_tiles.push_back(tile_bin.first);
+  }
+  TileScheduler tweener_scheduler("Binning", tile_dir, tweener_tiles, threads.size());
+  for (unsigned int i = 0; i < threads.size(); ++i) {
+    threads[i].reset(new std::thread(bin_tweeners, std::cref(tile_dir), std::cref(tweeners),
+                                     std::ref(tweener_scheduler), i, dataset_id));
   }
   for (auto& thread : threads) {
     thread->join();
   }
+  tweener_scheduler.LogStats();
   LOG_INFO("Finished");
 
   // print dupcount and find densities
@@ -65,12 +65,12 @@ Tags LuaTagTransform::Transform(OSMType type, uint64_t osmid, const Tags& maptag
     // grab the function
     lua_getglobal(state_, lua_func.c_str());
 
-    // set up the lua table (map)
+    // set up the lua table (map), sized up front so lua doesnt rehash it as it grows
     int count = 0;
-    lua_newtable(state_);
+    lua_createtable(state_, 0, maptags.size());
     for (const auto& tag : maptags) {
-      lua_pushstring(state_, tag.first.c_str());
-      lua_pushstring(state_, tag.second.c_str());
+      lua_pushlstring(state_, tag.first.data(), tag.first.size());
+      lua_pushlstring(state_, tag.second.data(), tag.second.size());
       lua_rawset(state_, -3);
       count++;
     }
@@ -102,6 +102,7 @@ Tags LuaTagTransform::Transform(OSMType type, uint64_t osmid, const Tags& maptag
     }
 
     // pull out the keys and values into a map
+    result.reserve(maptags.size());
     lua_pushnil(state_);
     while (lua_next(state_, -2) != 0) {
       const char* key = lua_tostring(state_, -2);
@@ -109,12 +110,13 @@ Tags LuaTagTransform::Transform(OSMType type, uint64_t osmid, const Tags& maptag
         LOG_ERROR((boost::format("Invalid key in Lua function: %1%.") % lua_func).str());
         break;
       }
-      const char* value = lua_tostring(state_, -1);
+      size_t length = 0;
+      const char* value = lua_tolstring(state_, -1, &length);
       if (value == nullptr) {
         LOG_ERROR((boost::format("Invalid value in Lua function: %1%.") % lua_func).str());
         break;
       }
-      result[key] = value;
+      result[key].assign(value, length);
       lua_pop(state_, 1);
     }
 
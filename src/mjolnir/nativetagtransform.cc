@@ -0,0 +1,2061 @@
+#include "mjolnir/nativetagtransform.h"
+#include "midgard/logging.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <forward_list>
+#include <initializer_list>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace valhalla::mjolnir;
+
+namespace {
+
+// the lua tables whose values are "true" or "false"
+using Flags = std::unordered_map<std::string, bool>;
+// the lua tables whose values are numbers
+using Numbers = std::unordered_map<std::string, uint32_t>;
+
+const std::string kTrue = "true";
+const std::string kFalse = "false";
+
+namespace tag {
+// every key the lua reads or writes on a node or way, each named after its key with the colons
+// turned into underscores
+enum Key : uint8_t {
+  kFIXME, kAccess, kAccess_Conditional, kAccessMask, kAdvisorySpeed, kAltName, kAmenity, kArea,
+  kAutoBackward, kAutoForward, kAutoTag, kAverageSpeed, kBackwardLanes, kBackwardSignal,
+  kBackwardSpeed, kBackwardStop, kBackwardYield, kBarrier, kBicycle, kBicycle_Backward,
+  kBicycleRental, kBicycleRoad, kBikeBackward, kBikeForward, kBikeLocalRef, kBikeNationalRef,
+  kBikeNetworkMask, kBikeRegionalRef, kBikeTag, kBollard, kBorderControl, kBridge, kBus,
+  kBus_Backward, kBusBackward, kBusForward, kBusTag, kBusway, kBusway_Left, kBusway_Right,
+  kCashOnlyToll, kConstruction, kCrossing, kCycleLaneLeft, kCycleLaneLeftOpposite, kCycleLaneRight,
+  kCycleLaneRightOpposite, kCyclestreet, kCycleway, kCycleway_Both, kCycleway_Both_Buffer,
+  kCycleway_Left, kCycleway_Left_Buffer, kCycleway_Right, kCycleway_Right_Buffer, kDefaultSpeed,
+  kDirection, kEmergency, kEmergencyBackward, kEmergencyForward, kEmergencyTag, kFerry, kFoot,
+  kFoot_Backward, kFootTag, kFootway, kForwardLanes, kForwardSignal, kForwardSpeed, kForwardStop,
+  kForwardYield, kGate, kGiveWay, kHazmat, kHazmat_A, kHazmat_B, kHazmat_C, kHazmat_D, kHazmat_E,
+  kHazmat_Water, kHgv, kHgv_NationalNetwork, kHgv_StateNetwork, kHighway, kHov, kHov_Lanes,
+  kHov_Minimum, kHovBackward, kHovForward, kHovTag, kHovType, kImpassable, kIntRef, kIso_3166_2,
+  kJunction, kLanes, kLanes_Backward, kLanes_Bus, kLanes_Forward, kLanes_Psv, kLanes_Psv_Backward,
+  kLanes_Psv_Forward, kLcn, kLcnRef, kLink, kMaxSpeed, kMaxaxleload, kMaxheight, kMaxheight_Physical,
+  kMaxlength, kMaxspeed, kMaxspeed_Advisory, kMaxspeed_Backward, kMaxspeed_Forward, kMaxspeed_Hgv,
+  kMaxspeed_Practical, kMaxweight, kMaxwidth, kMaxwidth_Physical, kMofa, kMofa_Backward, kMoped,
+  kMoped_Backward, kMopedBackward, kMopedForward, kMopedTag, kMotorVehicle, kMotorcar, kMotorcycle,
+  kMotorcycle_Backward, kMotorcycleBackward, kMotorcycleForward, kMotorcycleTag, kMotorroad,
+  kMotorroadTag, kMtb, kName, kName_En, kNcn, kNcnRef, kNoThruTraffic, kNote, kOfficialName, kOneway,
+  kOneway_Bicycle, kOneway_Bus, kOneway_Conditional, kOneway_Foot, kOneway_Mofa, kOneway_Moped,
+  kOneway_Motorcycle, kOneway_Psv, kOneway_Taxi, kOnewayReverse, kPedestrian, kPedestrianBackward,
+  kPedestrianForward, kPrivate, kPsv, kPublicTransport, kRail, kRailway, kRcn, kRcnRef, kRef,
+  kReferencePoint, kRoadClass, kRoundabout, kRoute, kSacScale, kSeasonal, kSegregated, kService,
+  kService_Bicycle_Rental, kShop, kShoulder, kShoulder_Both, kShoulder_Left, kShoulder_Right,
+  kShoulderLeft, kShoulderRight, kSource, kStateIsoCode, kStop, kSumpBuster, kTaggedAccess, kTaxi,
+  kTaxi_Backward, kTaxiBackward, kTaxiForward, kTaxiTag, kToll, kTollBooth, kTollGantry, kTracktype,
+  kTrafficSignals_Direction, kTruckBackward, kTruckForward, kTruckRoute, kTruckTag, kTunnel,
+  kUnsignedRef, kUse, kVehicle, kWheelchair, kCount,
+};
+} // namespace tag
+
+const std::unordered_map<std::string, tag::Key> kKeys = {
+    {"FIXME", tag::kFIXME}, {"access", tag::kAccess},
+    {"access:conditional", tag::kAccess_Conditional}, {"access_mask", tag::kAccessMask},
+    {"advisory_speed", tag::kAdvisorySpeed}, {"alt_name", tag::kAltName}, {"amenity", tag::kAmenity},
+    {"area", tag::kArea}, {"auto_backward", tag::kAutoBackward}, {"auto_forward", tag::kAutoForward},
+    {"auto_tag", tag::kAutoTag}, {"average_speed", tag::kAverageSpeed},
+    {"backward_lanes", tag::kBackwardLanes}, {"backward_signal", tag::kBackwardSignal},
+    {"backward_speed", tag::kBackwardSpeed}, {"backward_stop", tag::kBackwardStop},
+    {"backward_yield", tag::kBackwardYield}, {"barrier", tag::kBarrier}, {"bicycle", tag::kBicycle},
+    {"bicycle:backward", tag::kBicycle_Backward}, {"bicycle_rental", tag::kBicycleRental},
+    {"bicycle_road", tag::kBicycleRoad}, {"bike_backward", tag::kBikeBackward},
+    {"bike_forward", tag::kBikeForward}, {"bike_local_ref", tag::kBikeLocalRef},
+    {"bike_national_ref", tag::kBikeNationalRef}, {"bike_network_mask", tag::kBikeNetworkMask},
+    {"bike_regional_ref", tag::kBikeRegionalRef}, {"bike_tag", tag::kBikeTag},
+    {"bollard", tag::kBollard}, {"border_control", tag::kBorderControl}, {"bridge", tag::kBridge},
+    {"bus", tag::kBus}, {"bus:backward", tag::kBus_Backward}, {"bus_backward", tag::kBusBackward},
+    {"bus_forward", tag::kBusForward}, {"bus_tag", tag::kBusTag}, {"busway", tag::kBusway},
+    {"busway:left", tag::kBusway_Left}, {"busway:right", tag::kBusway_Right},
+    {"cash_only_toll", tag::kCashOnlyToll}, {"construction", tag::kConstruction},
+    {"crossing", tag::kCrossing}, {"cycle_lane_left", tag::kCycleLaneLeft},
+    {"cycle_lane_left_opposite", tag::kCycleLaneLeftOpposite},
+    {"cycle_lane_right", tag::kCycleLaneRight},
+    {"cycle_lane_right_opposite", tag::kCycleLaneRightOpposite}, {"cyclestreet", tag::kCyclestreet},
+    {"cycleway", tag::kCycleway}, {"cycleway:both", tag::kCycleway_Both},
+    {"cycleway:both:buffer", tag::kCycleway_Both_Buffer}, {"cycleway:left", tag::kCycleway_Left},
+    {"cycleway:left:buffer", tag::kCycleway_Left_Buffer}, {"cycleway:right", tag::kCycleway_Right},
+    {"cycleway:right:buffer", tag::kCycleway_Right_Buffer}, {"default_speed", tag::kDefaultSpeed},
+    {"direction", tag::kDirection}, {"emergency", tag::kEmergency},
+    {"emergency_backward", tag::kEmergencyBackward}, {"emergency_forward", tag::kEmergencyForward},
+    {"emergency_tag", tag::kEmergencyTag}, {"ferry", tag::kFerry}, {"foot", tag::kFoot},
+    {"foot:backward", tag::kFoot_Backward}, {"foot_tag", tag::kFootTag}, {"footway", tag::kFootway},
+    {"forward_lanes", tag::kForwardLanes}, {"forward_signal", tag::kForwardSignal},
+    {"forward_speed", tag::kForwardSpeed}, {"forward_stop", tag::kForwardStop},
+    {"forward_yield", tag::kForwardYield}, {"gate", tag::kGate}, {"give_way", tag::kGiveWay},
+    {"hazmat", tag::kHazmat}, {"hazmat:A", tag::kHazmat_A}, {"hazmat:B", tag::kHazmat_B},
+    {"hazmat:C", tag::kHazmat_C}, {"hazmat:D", tag::kHazmat_D}, {"hazmat:E", tag::kHazmat_E},
+    {"hazmat:water", tag::kHazmat_Water}, {"hgv", tag::kHgv},
+    {"hgv:national_network", tag::kHgv_NationalNetwork},
+    {"hgv:state_network", tag::kHgv_StateNetwork}, {"highway", tag::kHighway}, {"hov", tag::kHov},
+    {"hov:lanes", tag::kHov_Lanes}, {"hov:minimum", tag::kHov_Minimum},
+    {"hov_backward", tag::kHovBackward}, {"hov_forward", tag::kHovForward},
+    {"hov_tag", tag::kHovTag}, {"hov_type", tag::kHovType}, {"impassable", tag::kImpassable},
+    {"int_ref", tag::kIntRef}, {"iso:3166_2", tag::kIso_3166_2}, {"junction", tag::kJunction},
+    {"lanes", tag::kLanes}, {"lanes:backward", tag::kLanes_Backward}, {"lanes:bus", tag::kLanes_Bus},
+    {"lanes:forward", tag::kLanes_Forward}, {"lanes:psv", tag::kLanes_Psv},
+    {"lanes:psv:backward", tag::kLanes_Psv_Backward}, {"lanes:psv:forward", tag::kLanes_Psv_Forward},
+    {"lcn", tag::kLcn}, {"lcn_ref", tag::kLcnRef}, {"link", tag::kLink},
+    {"max_speed", tag::kMaxSpeed}, {"maxaxleload", tag::kMaxaxleload},
+    {"maxheight", tag::kMaxheight}, {"maxheight:physical", tag::kMaxheight_Physical},
+    {"maxlength", tag::kMaxlength}, {"maxspeed", tag::kMaxspeed},
+    {"maxspeed:advisory", tag::kMaxspeed_Advisory}, {"maxspeed:backward", tag::kMaxspeed_Backward},
+    {"maxspeed:forward", tag::kMaxspeed_Forward}, {"maxspeed:hgv", tag::kMaxspeed_Hgv},
+    {"maxspeed:practical", tag::kMaxspeed_Practical}, {"maxweight", tag::kMaxweight},
+    {"maxwidth", tag::kMaxwidth}, {"maxwidth:physical", tag::kMaxwidth_Physical},
+    {"mofa", tag::kMofa}, {"mofa:backward", tag::kMofa_Backward}, {"moped", tag::kMoped},
+    {"moped:backward", tag::kMoped_Backward}, {"moped_backward", tag::kMopedBackward},
+    {"moped_forward", tag::kMopedForward}, {"moped_tag", tag::kMopedTag},
+    {"motor_vehicle", tag::kMotorVehicle}, {"motorcar", tag::kMotorcar},
+    {"motorcycle", tag::kMotorcycle}, {"motorcycle:backward", tag::kMotorcycle_Backward},
+    {"motorcycle_backward", tag::kMotorcycleBackward},
+    {"motorcycle_forward", tag::kMotorcycleForward}, {"motorcycle_tag", tag::kMotorcycleTag},
+    {"motorroad", tag::kMotorroad}, {"motorroad_tag", tag::kMotorroadTag}, {"mtb", tag::kMtb},
+    {"name", tag::kName}, {"name:en", tag::kName_En}, {"ncn", tag::kNcn}, {"ncn_ref", tag::kNcnRef},
+    {"no_thru_traffic", tag::kNoThruTraffic}, {"note", tag::kNote},
+    {"official_name", tag::kOfficialName}, {"oneway", tag::kOneway},
+    {"oneway:bicycle", tag::kOneway_Bicycle}, {"oneway:bus", tag::kOneway_Bus},
+    {"oneway:conditional", tag::kOneway_Conditional}, {"oneway:foot", tag::kOneway_Foot},
+    {"oneway:mofa", tag::kOneway_Mofa}, {"oneway:moped", tag::kOneway_Moped},
+    {"oneway:motorcycle", tag::kOneway_Motorcycle}, {"oneway:psv", tag::kOneway_Psv},
+    {"oneway:taxi", tag::kOneway_Taxi}, {"oneway_reverse", tag::kOnewayReverse},
+    {"pedestrian", tag::kPedestrian}, {"pedestrian_backward", tag::kPedestrianBackward},
+    {"pedestrian_forward", tag::kPedestrianForward}, {"private", tag::kPrivate}, {"psv", tag::kPsv},
+    {"public_transport", tag::kPublicTransport}, {"rail", tag::kRail}, {"railway", tag::kRailway},
+    {"rcn", tag::kRcn}, {"rcn_ref", tag::kRcnRef}, {"ref", tag::kRef},
+    {"reference_point", tag::kReferencePoint}, {"road_class", tag::kRoadClass},
+    {"roundabout", tag::kRoundabout}, {"route", tag::kRoute}, {"sac_scale", tag::kSacScale},
+    {"seasonal", tag::kSeasonal}, {"segregated", tag::kSegregated}, {"service", tag::kService},
+    {"service:bicycle:rental", tag::kService_Bicycle_Rental}, {"shop", tag::kShop},
+    {"shoulder", tag::kShoulder}, {"shoulder:both", tag::kShoulder_Both},
+    {"shoulder:left", tag::kShoulder_Left}, {"shoulder:right", tag::kShoulder_Right},
+    {"shoulder_left", tag::kShoulderLeft}, {"shoulder_right", tag::kShoulderRight},
+    {"source", tag::kSource}, {"state_iso_code", tag::kStateIsoCode}, {"stop", tag::kStop},
+    {"sump_buster", tag::kSumpBuster}, {"tagged_access", tag::kTaggedAccess}, {"taxi", tag::kTaxi},
+    {"taxi:backward", tag::kTaxi_Backward}, {"taxi_backward", tag::kTaxiBackward},
+    {"taxi_forward", tag::kTaxiForward}, {"taxi_tag", tag::kTaxiTag}, {"toll", tag::kToll},
+    {"toll_booth", tag::kTollBooth}, {"toll_gantry", tag::kTollGantry},
+    {"tracktype", tag::kTracktype}, {"traffic_signals:direction", tag::kTrafficSignals_Direction},
+    {"truck_backward", tag::kTruckBackward}, {"truck_forward", tag::kTruckForward},
+    {"truck_route", tag::kTruckRoute}, {"truck_tag", tag::kTruckTag}, {"tunnel", tag::kTunnel},
+    {"unsigned_ref", tag::kUnsignedRef}, {"use", tag::kUse}, {"vehicle", tag::kVehicle},
+    {"wheelchair", tag::kWheelchair},
+};
+
+// the keys by their tag::Key
+const std::array<std::string, tag::kCount> kKeyNames = [] {
+  std::array<std::string, tag::kCount> names;
+  for (const auto& key : kKeys) {
+    names[key.second] = key.first;
+  }
+  return names;
+}();
+
+// the modes in the order of the highway table, and the keys the lua keeps their access in
+constexpr size_t kModeCount = 8;
+constexpr size_t kPedestrian = 6;
+const tag::Key kForward[kModeCount] = {tag::kAutoForward,       tag::kTruckForward,
+                                       tag::kBusForward,        tag::kTaxiForward,
+                                       tag::kMopedForward,      tag::kMotorcycleForward,
+                                       tag::kPedestrianForward, tag::kBikeForward};
+const tag::Key kBackward[kModeCount] = {tag::kAutoBackward,       tag::kTruckBackward,
+                                        tag::kBusBackward,        tag::kTaxiBackward,
+                                        tag::kMopedBackward,      tag::kMotorcycleBackward,
+                                        tag::kPedestrianBackward, tag::kBikeBackward};
+const tag::Key kModeTags[kModeCount] = {tag::kAutoTag, tag::kTruckTag, tag::kBusTag,
+                                        tag::kTaxiTag, tag::kMopedTag, tag::kMotorcycleTag,
+                                        tag::kFootTag, tag::kBikeTag};
+
+// the highway table of lua/graph.lua, the forward access of each mode in the order above
+const std::unordered_map<std::string, std::array<bool, kModeCount>> kHighways = {
+    {"motorway", {true, true, true, true, false, true, false, false}},
+    {"motorway_link", {true, true, true, true, false, true, false, false}},
+    {"trunk", {true, true, true, true, true, true, true, true}},
+    {"trunk_link", {true, true, true, true, true, true, true, true}},
+    {"primary", {true, true, true, true, true, true, true, true}},
+    {"primary_link", {true, true, true, true, true, true, true, true}},
+    {"secondary", {true, true, true, true, true, true, true, true}},
+    {"secondary_link", {true, true, true, true, true, true, true, true}},
+    {"residential", {true, true, true, true, true, true, true, true}},
+    {"residential_link", {true, true, true, true, true, true, true, true}},
+    {"service", {true, true, true, true, true, true, true, true}},
+    {"tertiary", {true, true, true, true, true, true, true, true}},
+    {"tertiary_link", {true, true, true, true, true, true, true, true}},
+    {"road", {true, true, true, true, true, true, true, true}},
+    {"track", {true, true, true, true, true, true, true, true}},
+    {"unclassified", {true, true, true, true, true, true, true, true}},
+    {"undefined", {false, false, false, false, false, false, false, false}},
+    {"unknown", {false, false, false, false, false, false, false, false}},
+    {"living_street", {true, true, true, true, true, true, true, true}},
+    {"footway", {false, false, false, false, false, false, true, false}},
+    {"pedestrian", {false, false, false, false, false, false, true, false}},
+    {"steps", {false, false, false, false, false, false, true, true}},
+    {"bridleway", {false, false, false, false, false, false, false, false}},
+    {"cycleway", {false, false, false, false, false, false, false, true}},
+    {"path", {false, false, false, false, false, false, true, true}},
+    {"bus_guideway", {false, false, true, false, false, false, false, false}},
+    {"busway", {false, false, true, false, false, false, false, false}},
+};
+
+const Numbers kRoadClasses = {
+    {"motorway", 0},     {"motorway_link", 0}, {"trunk", 1},          {"trunk_link", 1},
+    {"primary", 2},      {"primary_link", 2},  {"secondary", 3},      {"secondary_link", 3},
+    {"tertiary", 4},     {"tertiary_link", 4}, {"unclassified", 5},   {"residential", 6},
+    {"residential_link", 6},
+};
+
+// the restriction table of lua/graph.lua
+const Numbers kRestrictions = {
+    {"no_left_turn", 0},    {"no_right_turn", 1},  {"no_straight_on", 2},   {"no_u_turn", 3},
+    {"only_right_turn", 4}, {"only_left_turn", 5}, {"only_straight_on", 6}, {"no_entry", 7},
+    {"no_exit", 8},         {"no_turn", 9},
+};
+
+// the default_speed table, indexed by road class
+const uint32_t kDefaultSpeeds[] = {105, 90, 75, 60, 50, 40, 35, 25};
+
+const Flags kAccess = {
+    {"yes", true},          {"private", true},     {"no", false},         {"permissive", true},
+    {"agricultural", false}, {"use_sidepath", true}, {"delivery", true},   {"designated", true},
+    {"dismount", true},     {"discouraged", false}, {"forestry", false},  {"destination", true},
+    {"customers", true},    {"official", false},   {"public", true},      {"restricted", true},
+    {"allowed", true},      {"emergency", false},  {"psv", false},        {"permit", true},
+    {"residents", true},
+};
+
+const Flags kPrivate = {
+    {"private", true}, {"destination", true}, {"customers", true},
+    {"delivery", true}, {"permit", true},     {"residents", true},
+};
+
+const Flags kNoThruTraffic = {
+    {"destination", true}, {"customers", true}, {"delivery", true},
+    {"permit", true},      {"residents", true},
+};
+
+const Numbers kUses = {
+    {"driveway", 4},         {"alley", 5},          {"parking_aisle", 6},
+    {"emergency_access", 7}, {"drive-through", 8},
+};
+
+const Flags kMotorVehicle = {
+    {"yes", true},          {"private", true},     {"no", false},         {"permissive", true},
+    {"agricultural", false}, {"delivery", true},   {"designated", true},  {"discouraged", false},
+    {"forestry", false},    {"destination", true}, {"customers", true},   {"official", false},
+    {"public", true},       {"restricted", true},  {"allowed", true},     {"permit", true},
+    {"residents", true},
+};
+
+const Flags kMoped = {
+    {"yes", true},      {"designated", true}, {"private", true},  {"permissive", true},
+    {"destination", true}, {"delivery", true}, {"dismount", true}, {"no", false},
+    {"unknown", false}, {"agricultural", false}, {"permit", true}, {"residents", true},
+};
+
+const Flags kFoot = {
+    {"yes", true},          {"private", true},     {"no", false},          {"permissive", true},
+    {"agricultural", false}, {"use_sidepath", true}, {"delivery", true},   {"designated", true},
+    {"discouraged", false}, {"forestry", false},   {"destination", true},  {"customers", true},
+    {"official", true},     {"public", true},      {"restricted", true},   {"crossing", true},
+    {"sidewalk", true},     {"allowed", true},     {"passable", true},     {"footway", true},
+    {"permit", true},       {"residents", true},
+};
+
+const Flags kWheelchair = {
+    {"no", false},        {"yes", true},        {"designated", true}, {"limited", true},
+    {"official", true},   {"destination", true}, {"public", true},    {"permissive", true},
+    {"only", true},       {"private", true},    {"impassable", false}, {"partial", false},
+    {"bad", false},       {"half", false},      {"assisted", true},   {"permit", true},
+    {"residents", true},
+};
+
+const Flags kBus = {
+    {"no", false},         {"yes", true},        {"designated", true},
+    {"urban", true},       {"permissive", true}, {"restricted", true},
+    {"destination", true}, {"delivery", false},  {"official", false},
+};
+
+const Flags kTaxi = kBus;
+
+const Flags kPsv = {
+    {"bus", true},        {"taxi", true}, {"no", false}, {"yes", true},
+    {"designated", true}, {"permissive", true}, {"1", true}, {"2", true},
+};
+
+const Flags kTruck = {
+    {"designated", true},   {"yes", true},           {"no", false},
+    {"destination", true},  {"delivery", true},      {"local", true},
+    {"agricultural", false}, {"private", true},      {"discouraged", false},
+    {"permissive", false},  {"unsuitable", false},   {"agricultural;forestry", false},
+    {"official", false},    {"forestry", false},     {"destination;delivery", true},
+    {"permit", true},       {"residents", true},
+};
+
+const Flags kHazmat = {
+    {"designated", true}, {"yes", true}, {"no", false}, {"destination", true}, {"delivery", true},
+};
+
+const Flags kShoulder = {{"yes", true}, {"both", true}, {"no", false}};
+const Flags kShoulderRight = {{"right", true}};
+const Flags kShoulderLeft = {{"left", true}};
+
+const Flags kBicycle = {
+    {"yes", true},       {"designated", true}, {"use_sidepath", true}, {"no", false},
+    {"permissive", true}, {"destination", true}, {"dismount", true},   {"lane", true},
+    {"track", true},     {"shared", true},     {"shared_lane", true},  {"sidepath", true},
+    {"share_busway", true}, {"none", false},   {"allowed", true},      {"private", true},
+    {"official", true},  {"permit", true},     {"residents", true},
+};
+
+const Flags kCycleway = {
+    {"yes", true},      {"designated", true}, {"use_sidepath", true}, {"permissive", true},
+    {"destination", true}, {"dismount", true}, {"lane", true},        {"track", true},
+    {"shared", true},   {"shared_lane", true}, {"sidepath", true},    {"share_busway", true},
+    {"allowed", true},  {"private", true},    {"cyclestreet", true},  {"crossing", true},
+};
+
+const Flags kBikeReverse = {{"opposite", true}, {"opposite_lane", true}, {"opposite_track", true}};
+const Flags kBusReverse = {{"opposite", true}, {"opposite_lane", true}};
+
+const Numbers kShared = {{"shared_lane", 1}, {"share_busway", 1}, {"shared", 1}};
+const Numbers kBuffer = {{"yes", 2}};
+const Numbers kDedicated = {{"opposite_lane", 2}, {"lane", 2}, {"buffered_lane", 2}};
+const Numbers kSeparated = {{"opposite_track", 3}, {"track", 3}};
+
+const Flags kOneway = {
+    {"no", false},  {"false", false},     {"-1", true},          {"yes", true},
+    {"true", true}, {"1", true},          {"reversible", false}, {"alternating", false},
+};
+
+const Flags kBridge = {{"yes", true}, {"no", false}, {"1", true}};
+const Flags kTunnel = {{"yes", true}, {"no", false}, {"1", true}, {"building_passage", true}};
+const Flags kToll = {
+    {"yes", true}, {"no", false},       {"true", true},       {"false", false},
+    {"1", true},   {"interval", true},  {"snowmobile", true},
+};
+
+// the *_node tables the lua uses to build the access mask of a node
+const Numbers kMotorVehicleNode = {
+    {"yes", 1},         {"private", 1},      {"no", 0},          {"permissive", 1},
+    {"agricultural", 0}, {"delivery", 1},    {"designated", 1},  {"discouraged", 0},
+    {"forestry", 0},    {"destination", 1},  {"customers", 1},   {"official", 0},
+    {"public", 1},      {"restricted", 1},   {"allowed", 1},     {"permit", 1},
+    {"residents", 1},
+};
+
+const Numbers kBicycleNode = {
+    {"yes", 4},        {"designated", 4},  {"use_sidepath", 4}, {"no", 0},
+    {"permissive", 4}, {"destination", 4}, {"dismount", 4},     {"lane", 4},
+    {"track", 4},      {"shared", 4},      {"shared_lane", 4},  {"sidepath", 4},
+    {"share_busway", 4}, {"none", 0},      {"allowed", 4},      {"private", 4},
+    {"official", 4},   {"permit", 4},      {"residents", 4},
+};
+
+const Numbers kFootNode = {
+    {"yes", 2},         {"private", 2},      {"no", 0},          {"permissive", 2},
+    {"agricultural", 0}, {"use_sidepath", 2}, {"delivery", 2},   {"designated", 2},
+    {"discouraged", 0}, {"forestry", 0},     {"destination", 2}, {"customers", 2},
+    {"official", 2},    {"public", 2},       {"restricted", 2},  {"crossing", 2},
+    {"sidewalk", 2},    {"allowed", 2},      {"passable", 2},    {"footway", 2},
+    {"permit", 2},      {"residents", 2},
+};
+
+const Numbers kWheelchairNode = {
+    {"no", 0},           {"yes", 256},         {"designated", 256}, {"limited", 256},
+    {"official", 256},   {"destination", 256}, {"public", 256},     {"permissive", 256},
+    {"only", 256},       {"private", 256},     {"impassable", 0},   {"partial", 0},
+    {"bad", 0},          {"half", 0},          {"assisted", 256},   {"permit", 256},
+    {"residents", 256},
+};
+
+const Numbers kMopedNode = {
+    {"yes", 512},      {"designated", 512}, {"private", 512},  {"permissive", 512},
+    {"destination", 512}, {"delivery", 512}, {"dismount", 512}, {"no", 0},
+    {"unknown", 0},    {"agricultural", 0}, {"permit", 512},   {"residents", 512},
+};
+
+const Numbers kMotorCycleNode = {
+    {"yes", 1024},       {"private", 1024},    {"no", 0},            {"permissive", 1024},
+    {"agricultural", 0}, {"delivery", 1024},   {"designated", 1024}, {"discouraged", 0},
+    {"forestry", 0},     {"destination", 1024}, {"customers", 1024}, {"official", 0},
+    {"public", 1024},    {"restricted", 1024}, {"allowed", 1024},
+};
+
+const Numbers kBusNode = {
+    {"no", 0},          {"yes", 64},        {"designated", 64},
+    {"urban", 64},      {"permissive", 64}, {"restricted", 64},
+    {"destination", 64}, {"delivery", 0},   {"official", 0},
+};
+
+const Numbers kTaxiNode = {
+    {"no", 0},          {"yes", 32},        {"designated", 32},
+    {"urban", 32},      {"permissive", 32}, {"restricted", 32},
+    {"destination", 32}, {"delivery", 0},   {"official", 0},
+};
+
+const Numbers kTruckNode = {
+    {"designated", 8},  {"yes", 8},          {"no", 0},
+    {"destination", 8}, {"delivery", 8},     {"local", 8},
+    {"agricultural", 0}, {"private", 8},     {"discouraged", 0},
+    {"permissive", 0},  {"unsuitable", 0},   {"agricultural;forestry", 0},
+    {"official", 0},    {"forestry", 0},     {"destination;delivery", 8},
+    {"permit", 8},      {"residents", 8},
+};
+
+const Numbers kPsvBusNode = {
+    {"bus", 64}, {"no", 0}, {"yes", 64}, {"designated", 64}, {"permissive", 64}, {"1", 64}, {"2", 64},
+};
+
+const Numbers kPsvTaxiNode = {
+    {"taxi", 32}, {"no", 0}, {"yes", 32}, {"designated", 32},
+    {"permissive", 32}, {"1", 32}, {"2", 32},
+};
+
+// the restrictions for specific modes, in the order the lua prefers them
+const char* kModeRestrictions[] = {
+    "restriction:hgv",     "restriction:emergency",  "restriction:taxi",
+    "restriction:motorcar", "restriction:bus",       "restriction:bicycle",
+    "restriction:hazmat",  "restriction:motorcycle", "restriction:foot",
+};
+
+// the tags of a node or way while the lua's rules are applied to them. the keys the rules use live
+// in an array by their tag::Key so that reading or writing one doesnt hash its name, the rest of
+// the tags are passed through as they are. a value points at the input tags, at a constant or at a
+// string the kv made, none of which change once made so any number of keys can share one
+class Kv {
+public:
+  explicit Kv(const Tags& tags) {
+    values_.fill(nullptr);
+    listed_.fill(false);
+    others_.reserve(tags.size());
+    for (const auto& tag : tags) {
+      auto found = kKeys.find(tag.first);
+      if (found == kKeys.cend()) {
+        others_.push_back(&tag);
+      } else {
+        set(found->second, &tag.second);
+      }
+    }
+  }
+
+  const std::string* get(tag::Key key) const {
+    return values_[key];
+  }
+
+  void set(tag::Key key, const std::string* value) {
+    if (value != nullptr && !listed_[key]) {
+      listed_[key] = true;
+      keys_[key_count_++] = key;
+    }
+    values_[key] = value;
+  }
+
+  void set(tag::Key key, std::string value) {
+    owned_.push_front(std::move(value));
+    set(key, &owned_.front());
+  }
+
+  void erase(tag::Key key) {
+    values_[key] = nullptr;
+  }
+
+  void swap(tag::Key a, tag::Key b) {
+    const std::string* value = values_[a];
+    set(a, values_[b]);
+    set(b, value);
+  }
+
+  // the tags as the lua would have returned them
+  Tags tags() const {
+    Tags tags;
+    tags.reserve(others_.size() + key_count_);
+    for (const auto* tag : others_) {
+      tags.emplace(*tag);
+    }
+    for (size_t i = 0; i < key_count_; ++i) {
+      if (const std::string* value = values_[keys_[i]]) {
+        tags.emplace(kKeyNames[keys_[i]], *value);
+      }
+    }
+    return tags;
+  }
+
+private:
+  std::array<const std::string*, tag::kCount> values_;
+  // the keys that have had a value, so making the tags doesnt look at every key
+  std::array<bool, tag::kCount> listed_;
+  std::array<tag::Key, tag::kCount> keys_;
+  size_t key_count_ = 0;
+  std::forward_list<std::string> owned_;
+  std::vector<const Tags::value_type*> others_;
+};
+
+const std::string* get(const Kv& kv, tag::Key key) {
+  return kv.get(key);
+}
+
+bool is(const Kv& kv, tag::Key key, const char* expected) {
+  const std::string* value = kv.get(key);
+  return value && *value == expected;
+}
+
+void set(Kv& kv, tag::Key key, const std::string* value) {
+  kv.set(key, value);
+}
+
+// true and false are pointed at, any other string may not outlive the kv so it is copied
+void set(Kv& kv, tag::Key key, const std::string& value) {
+  if (&value == &kTrue || &value == &kFalse) {
+    kv.set(key, &value);
+  } else {
+    kv.set(key, std::string(value));
+  }
+}
+
+void set(Kv& kv, tag::Key key, std::string&& value) {
+  kv.set(key, std::move(value));
+}
+
+// kv[key] = number in the lua, the number becomes a string the way luajit's tostring makes one
+void set_number(Kv& kv, tag::Key key, std::optional<double> value) {
+  if (!value) {
+    kv.erase(key);
+  } else if (std::isnan(*value)) {
+    kv.set(key, std::string("nan"));
+  } else if (std::isinf(*value)) {
+    kv.set(key, std::string(*value < 0 ? "-inf" : "inf"));
+  } else if (*value == std::floor(*value) && std::fabs(*value) < 1e14 &&
+             !(*value == 0 && std::signbit(*value))) {
+    // whole numbers with fewer than 15 digits print the same as an integer
+    kv.set(key, std::to_string(static_cast<int64_t>(*value)));
+  } else {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.14g", *value);
+    kv.set(key, std::string(buffer));
+  }
+}
+
+void swap(Kv& kv, tag::Key a, tag::Key b) {
+  kv.swap(a, b);
+}
+
+// kv[key] in the lua, nullptr is nil
+const std::string* get(const Tags& tags, const char* key) {
+  auto found = tags.find(key);
+  return found == tags.cend() ? nullptr : &found->second;
+}
+
+// value == "..." in the lua, which is false for nil
+bool is(const std::string* value, const char* expected) {
+  return value && *value == expected;
+}
+
+// kv[key] == "..." in the lua
+bool is(const Tags& tags, const char* key, const char* expected) {
+  return is(get(tags, key), expected);
+}
+
+// table[value] for the tables of "true" and "false"
+const std::string* flag(const Flags& table, const std::string* value) {
+  if (value == nullptr) {
+    return nullptr;
+  }
+  auto found = table.find(*value);
+  return found == table.cend() ? nullptr : found->second ? &kTrue : &kFalse;
+}
+
+// table[value] for the tables of numbers
+const uint32_t* lookup(const Numbers& table, const std::string* value) {
+  if (value == nullptr) {
+    return nullptr;
+  }
+  auto found = table.find(*value);
+  return found == table.cend() ? nullptr : &found->second;
+}
+
+// restriction[value] in the lua
+const uint32_t* restriction(const std::string* value) {
+  return lookup(kRestrictions, value);
+}
+
+// table[value] for the *_node tables, nothing is nil
+std::optional<uint32_t> mask(const Numbers& table, const std::string* value) {
+  const uint32_t* found = lookup(table, value);
+  return found ? std::optional<uint32_t>(*found) : std::nullopt;
+}
+
+// a or b or c in the lua
+template <typename T> const T* first(std::initializer_list<const T*> values) {
+  for (const T* value : values) {
+    if (value) {
+      return value;
+    }
+  }
+  return nullptr;
+}
+
+// kv[key] = value in the lua where a nil value removes the key
+void set(Tags& tags, const char* key, const std::string* value) {
+  if (value == nullptr) {
+    tags.erase(key);
+  } else {
+    tags[key] = *value;
+  }
+}
+
+void set(Tags& tags, const char* key, const std::string& value) {
+  tags[key] = value;
+}
+
+void set(Tags& tags, const char* key, const uint32_t* value) {
+  if (value == nullptr) {
+    tags.erase(key);
+  } else {
+    tags[key] = std::to_string(*value);
+  }
+}
+
+// kv[key] = number in the lua, the number becomes a string the way luajit's tostring makes one
+void set_number(Tags& tags, const char* key, std::optional<double> value) {
+  if (!value) {
+    tags.erase(key);
+  } else if (std::isnan(*value)) {
+    tags[key] = "nan";
+  } else if (std::isinf(*value)) {
+    tags[key] = *value < 0 ? "-inf" : "inf";
+  } else {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.14g", *value);
+    tags[key] = buffer;
+  }
+}
+
+// swaps kv[a] and kv[b], either of which may be nil
+void swap(Tags& tags, const char* a, const char* b) {
+  auto found_a = tags.find(a);
+  auto found_b = tags.find(b);
+  if (found_a != tags.end() && found_b != tags.end()) {
+    std::swap(found_a->second, found_b->second);
+  } else if (found_a != tags.end()) {
+    std::string value = std::move(found_a->second);
+    tags.erase(found_a);
+    tags[b] = std::move(value);
+  } else if (found_b != tags.end()) {
+    std::string value = std::move(found_b->second);
+    tags.erase(found_b);
+    tags[a] = std::move(value);
+  }
+}
+
+bool is_space(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+bool is_digit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+// tonumber in the lua, luajit allows surrounding spaces, hex, inf and nan
+std::optional<double> to_number(const std::string& value) {
+  const char* begin = value.c_str();
+  const char* end = begin + value.size();
+  char* parsed = nullptr;
+  double number = std::strtod(begin, &parsed);
+  if (parsed == begin || std::find(begin, static_cast<const char*>(parsed), '(') != parsed) {
+    return std::nullopt;
+  }
+  while (parsed < end && is_space(*parsed)) {
+    ++parsed;
+  }
+  return parsed == end ? std::optional<double>(number) : std::nullopt;
+}
+
+// round(val, 2) in the lua
+double round2(double value) {
+  return std::floor(value * 100 + 0.5) / 100;
+}
+
+// numeric_prefix in the lua, empty if the value doesnt start with a number
+std::string numeric_prefix(const std::string& value, bool allow_decimals) {
+  size_t index = 0;
+  bool seen_dot = false;
+  for (; index < value.size(); ++index) {
+    if (is_digit(value[index])) {
+      continue;
+    }
+    if (value[index] != '.' || !allow_decimals || seen_dot) {
+      break;
+    }
+    seen_dot = true;
+  }
+  return value.substr(0, index);
+}
+
+bool ends_with(const std::string& value, const char* suffix) {
+  size_t length = std::char_traits<char>::length(suffix);
+  return value.size() >= length && value.compare(value.size() - length, length, suffix) == 0;
+}
+
+// normalize_speed in the lua, in kph and only between 10 and 150
+std::optional<double> normalize_speed(const std::string* speed) {
+  if (speed == nullptr) {
+    return std::nullopt;
+  }
+  std::string prefix = numeric_prefix(*speed, false);
+  if (prefix.empty()) {
+    return std::nullopt;
+  }
+  double number = std::strtod(prefix.c_str(), nullptr);
+  if (ends_with(*speed, "mph")) {
+    number = std::floor(number * 1.609344 + 0.5);
+  }
+  if (number > 150 || number < 10) {
+    return std::nullopt;
+  }
+  return number;
+}
+
+// normalize_weight in the lua, in tons. like the lua this throws on a prefix that is only a dot
+std::optional<double> normalize_weight(const std::string* weight) {
+  if (weight == nullptr) {
+    return std::nullopt;
+  }
+  std::string w;
+  for (char c : *weight) {
+    if (!is_space(c)) {
+      w.push_back(c);
+    }
+  }
+  std::string num = numeric_prefix(w, true);
+  if (num.empty()) {
+    return std::nullopt;
+  }
+
+  auto whole = [&w, &num](const char* unit) { return num + unit == w; };
+  auto tons = [&num](double divisor) {
+    auto number = to_number(num);
+    if (!number) {
+      throw std::runtime_error("attempt to perform arithmetic on a nil value in normalize_weight");
+    }
+    return round2(*number / divisor);
+  };
+
+  if (ends_with(w, "t") || ends_with(w, "tonne") || ends_with(w, "tonnes")) {
+    if (whole("t") || whole("tonne") || whole("tonnes")) {
+      return tons(1);
+    }
+  }
+  if (ends_with(w, "ton") || ends_with(w, "tons")) {
+    if (whole("ton") || whole("tons")) {
+      return tons(1);
+    }
+  }
+  if (ends_with(w, "lb") || ends_with(w, "lbs")) {
+    if (whole("lb") || whole("lbs")) {
+      return tons(2000);
+    }
+  }
+  if (ends_with(w, "kg")) {
+    if (whole("kg")) {
+      return tons(1000);
+    }
+  }
+  return tons(1);
+}
+
+// normalize_measurement in the lua, in meters. this is the lua's gmatch of
+// (%d+[.,]?%d*) *([a-zA-Z\"\']*) summing each term
+std::optional<double> normalize_measurement(const std::string* measurement) {
+  if (measurement == nullptr) {
+    return std::nullopt;
+  }
+  std::string value = *measurement;
+  std::replace(value.begin(), value.end(), ',', '.');
+  if (auto number = to_number(value)) {
+    return round2(*number);
+  }
+
+  double sum = 0;
+  size_t count = 0;
+  size_t i = 0;
+  while (i < value.size()) {
+    if (!is_digit(value[i])) {
+      ++i;
+      continue;
+    }
+    size_t start = i;
+    while (i < value.size() && is_digit(value[i])) {
+      ++i;
+    }
+    if (i < value.size() && (value[i] == '.' || value[i] == ',')) {
+      ++i;
+    }
+    while (i < value.size() && is_digit(value[i])) {
+      ++i;
+    }
+    auto item = to_number(value.substr(start, i - start));
+    while (i < value.size() && value[i] == ' ') {
+      ++i;
+    }
+    std::string unit;
+    for (; i < value.size(); ++i) {
+      char c = value[i];
+      if (c >= 'A' && c <= 'Z') {
+        unit.push_back(c - 'A' + 'a');
+      } else if ((c >= 'a' && c <= 'z') || c == '"' || c == '\'') {
+        unit.push_back(c);
+      } else {
+        break;
+      }
+    }
+    if (!item) {
+      return std::nullopt;
+    }
+
+    if (unit == "m" || unit == "meter" || unit == "meters") {
+      sum = sum + *item;
+    } else if (unit == "cm") {
+      sum = sum + *item * 0.01;
+    } else if (unit == "ft" || unit == "feet" || unit == "foot" || unit == "'") {
+      sum = sum + *item * 0.3048;
+    } else if (unit == "in" || unit == "inches" || unit == "inch" || unit == "\"" ||
+               unit == "''") {
+      sum = sum + *item * 0.0254;
+    } else {
+      return std::nullopt;
+    }
+    ++count;
+  }
+  return count > 0 ? std::optional<double>(round2(sum)) : std::nullopt;
+}
+
+// is_cash_only_payment in the lua
+bool is_cash_only_payment(const Tags& tags) {
+  bool allows_cash_payment = false;
+  bool allows_noncash_payment = false;
+  for (const auto& tag : tags) {
+    if (tag.first.compare(0, 8, "payment:") != 0) {
+      continue;
+    }
+    std::string type = tag.first.substr(8);
+    bool is_cash_payment_type = type == "cash" || type == "notes" || type == "coins";
+    bool no = tag.second.size() == 2 && (tag.second[0] == 'n' || tag.second[0] == 'N') &&
+              (tag.second[1] == 'o' || tag.second[1] == 'O');
+    if (is_cash_payment_type && !allows_cash_payment) {
+      allows_cash_payment = !no;
+    }
+    if (!is_cash_payment_type && !allows_noncash_payment) {
+      allows_noncash_payment = !no;
+    }
+  }
+  return allows_cash_payment && !allows_noncash_payment;
+}
+
+// shared[value] or separated[value] or dedicated[value] in the lua
+const uint32_t* cycle_lane(const std::string* value) {
+  return first({lookup(kShared, value), lookup(kSeparated, value), lookup(kDedicated, value)});
+}
+
+// the number of lanes in a lanes tag, nil for none or more than 15
+std::optional<double> lane_count(const std::string* lanes) {
+  if (lanes == nullptr) {
+    return std::nullopt;
+  }
+  std::string prefix = numeric_prefix(*lanes, false);
+  if (prefix.empty()) {
+    return std::nullopt;
+  }
+  double count = std::strtod(prefix.c_str(), nullptr);
+  return count > 15 ? std::nullopt : std::optional<double>(count);
+}
+
+// filter_tags_generic in the lua, modifies the tags in place and returns true if the way should be
+// skipped. this follows the lua line for line, reading each tag at the point the lua does because
+// the lua writes some of the tags it reads later
+bool filter_way(Kv& kv) {
+  if ((is(kv, tag::kHighway, "construction") && !get(kv, tag::kConstruction)) ||
+      is(kv, tag::kHighway, "proposed")) {
+    return true;
+  }
+
+  // figure out what basic type of road it is
+  const std::string* highway =
+      get(kv, is(kv, tag::kHighway, "construction") ? tag::kConstruction : tag::kHighway);
+  auto found = highway ? kHighways.find(*highway) : kHighways.cend();
+  const auto* forward = found == kHighways.cend() ? nullptr : &found->second;
+  bool ferry = is(kv, tag::kRoute, "ferry");
+  bool rail = is(kv, tag::kRoute, "shuttle_train");
+  const std::string* access = flag(kAccess, get(kv, tag::kAccess));
+
+  set(kv, tag::kEmergencyForward, kFalse);
+  set(kv, tag::kEmergencyBackward, kFalse);
+
+  if (ferry || rail || get(kv, tag::kHighway)) {
+    if (is(kv, tag::kAccess, "emergency") || is(kv, tag::kEmergency, "yes") ||
+        is(kv, tag::kService, "emergency_access")) {
+      set(kv, tag::kEmergencyForward, kTrue);
+      set(kv, tag::kEmergencyTag, kTrue);
+    }
+    if (is(kv, tag::kEmergency, "no")) {
+      set(kv, tag::kEmergencyTag, kFalse);
+    }
+  }
+
+  bool blocked = is(kv, tag::kImpassable, "yes") || is(access, "false") ||
+                 (is(kv, tag::kAccess, "private") &&
+                  (is(kv, tag::kEmergency, "yes") || is(kv, tag::kService, "emergency_access")));
+  auto no_access = [&kv](bool pedestrian) {
+    for (size_t i = 0; i < kModeCount; ++i) {
+      if (pedestrian || i != kPedestrian) {
+        set(kv, kForward[i], kFalse);
+        set(kv, kBackward[i], kFalse);
+      }
+    }
+  };
+
+  // the access tags of each mode, in the order of kForward
+  const std::string* motor_vehicle = flag(kMotorVehicle, get(kv, tag::kMotorVehicle));
+  const std::string* psv =
+      first({flag(kPsv, get(kv, tag::kPsv)), flag(kPsv, get(kv, tag::kLanes_Psv_Forward))});
+  const std::string* mode_tags[kModeCount] = {
+      first({flag(kMotorVehicle, get(kv, tag::kMotorcar)), motor_vehicle}),
+      first({flag(kTruck, get(kv, tag::kHgv)), motor_vehicle}),
+      first({flag(kBus, get(kv, tag::kBus)), psv, motor_vehicle}),
+      first({flag(kTaxi, get(kv, tag::kTaxi)), psv, motor_vehicle}),
+      first({flag(kMoped, get(kv, tag::kMoped)), flag(kMoped, get(kv, tag::kMofa)), motor_vehicle}),
+      first({flag(kMotorVehicle, get(kv, tag::kMotorcycle)), motor_vehicle}),
+      first({flag(kFoot, get(kv, tag::kFoot)), flag(kFoot, get(kv, tag::kPedestrian))}),
+      first({flag(kBicycle, get(kv, tag::kBicycle)), flag(kCycleway, get(kv, tag::kCycleway)),
+             flag(kBicycle, get(kv, tag::kBicycleRoad)), flag(kBicycle, get(kv, tag::kCyclestreet))}),
+  };
+  auto mode_overrides = [&kv]() {
+    if (!get(kv, tag::kBikeTag)) {
+      if (is(kv, tag::kSacScale, "hiking")) {
+        set(kv, tag::kBikeForward, kTrue);
+        set(kv, tag::kBikeTag, kTrue);
+      } else if (get(kv, tag::kSacScale)) {
+        set(kv, tag::kBikeForward, kFalse);
+      }
+    }
+    if (is(kv, tag::kAccess, "psv")) {
+      set(kv, tag::kTaxiForward, kTrue);
+      set(kv, tag::kTaxiTag, kTrue);
+      set(kv, tag::kBusForward, kTrue);
+      set(kv, tag::kBusTag, kTrue);
+    }
+    if (is(kv, tag::kMotorroad, "yes")) {
+      set(kv, tag::kMotorroadTag, kTrue);
+    }
+  };
+
+  if (forward) {
+    for (size_t i = 0; i < kModeCount; ++i) {
+      set(kv, kForward[i], (*forward)[i] ? kTrue : kFalse);
+    }
+    if (blocked) {
+      no_access(true);
+    } else if (is(kv, tag::kVehicle, "no")) { // don't change ped access
+      no_access(false);
+    }
+    // a tag for the mode overrides what the highway allows
+    for (size_t i = 0; i < kModeCount; ++i) {
+      set(kv, kForward[i], first({mode_tags[i], get(kv, kForward[i])}));
+      set(kv, kModeTags[i], mode_tags[i]);
+    }
+    mode_overrides();
+  } else if ((!ferry && !rail) || blocked) {
+    no_access(true);
+  } else {
+    // if its a ferry and these tags dont show up we want to set them to true
+    const std::string& pedestrian_default = ferry || rail ? kTrue : kFalse;
+    const std::string& default_value = is(kv, tag::kVehicle, "no") ? kFalse : pedestrian_default;
+    for (size_t i = 0; i < kModeCount; ++i) {
+      if (i == 1) {
+        // the lua lets an existing truck_forward win over motor_vehicle here
+        set(kv, kForward[i],
+            first({flag(kTruck, get(kv, tag::kHgv)), get(kv, kForward[i]), motor_vehicle,
+                   &default_value}));
+      } else {
+        set(kv, kForward[i],
+            first({mode_tags[i], i == kPedestrian ? &pedestrian_default : &default_value}));
+      }
+      set(kv, kModeTags[i], mode_tags[i]);
+    }
+    mode_overrides();
+  }
+
+  // TODO: handle Time conditional restrictions if available for HOVs with oneway = reversible
+  if ((is(kv, tag::kAccess, "permissive") || is(kv, tag::kAccess, "hov") ||
+       is(kv, tag::kAccess, "taxi")) &&
+      is(kv, tag::kOneway, "reversible")) {
+    // for now enable only for buses if the tag exists and they are allowed
+    if (!is(kv, tag::kBusForward, "true")) {
+      return true;
+    }
+    for (auto key : {tag::kAutoForward, tag::kTruckForward, tag::kPedestrianForward,
+                     tag::kBikeForward, tag::kMopedForward, tag::kMotorcycleForward}) {
+      set(kv, key, kFalse);
+    }
+  }
+
+  // service=driveway means all are routable
+  if (is(kv, tag::kService, "driveway") && !get(kv, tag::kAccess)) {
+    for (auto key : kForward) {
+      set(kv, key, kTrue);
+    }
+  }
+
+  // check the oneway-ness and traversability against the direction of the geom
+  if ((is(kv, tag::kOneway, "yes") && is(kv, tag::kOneway_Bicycle, "no")) ||
+      is(kv, tag::kBicycle_Backward, "yes") || is(kv, tag::kBicycle_Backward, "no")) {
+    set(kv, tag::kBikeBackward, kTrue);
+  }
+  if (!get(kv, tag::kBikeBackward) || is(kv, tag::kBikeBackward, "false")) {
+    set(kv, tag::kBikeBackward,
+        first({flag(kBikeReverse, get(kv, tag::kCycleway)),
+               flag(kBikeReverse, get(kv, tag::kCycleway_Left)),
+               flag(kBikeReverse, get(kv, tag::kCycleway_Right)), &kFalse}));
+  }
+  const std::string* oneway_bike = nullptr;
+  if (is(kv, tag::kBikeBackward, "true")) {
+    oneway_bike = flag(kOneway, get(kv, tag::kOneway_Bicycle));
+  }
+
+  if (!get(kv, tag::kOneway_Bus) && get(kv, tag::kOneway_Psv)) {
+    set(kv, tag::kOneway_Bus, get(kv, tag::kOneway_Psv));
+  }
+  if ((is(kv, tag::kOneway, "yes") && is(kv, tag::kOneway_Bus, "no")) ||
+      is(kv, tag::kBus_Backward, "yes") || is(kv, tag::kBus_Backward, "designated")) {
+    set(kv, tag::kBusBackward, kTrue);
+  }
+  if (!get(kv, tag::kBusBackward) || is(kv, tag::kBusBackward, "false")) {
+    set(kv, tag::kBusBackward,
+        first({flag(kBusReverse, get(kv, tag::kBusway)),
+               flag(kBusReverse, get(kv, tag::kBusway_Left)),
+               flag(kBusReverse, get(kv, tag::kBusway_Right)),
+               flag(kPsv, get(kv, tag::kLanes_Psv_Backward)), &kFalse}));
+  }
+  const std::string* oneway_bus = nullptr;
+  if (is(kv, tag::kBusBackward, "true")) {
+    oneway_bus = flag(kOneway, get(kv, tag::kOneway_Bus));
+    if (is(oneway_bus, "false") && is(kv, tag::kBus_Backward, "yes")) {
+      oneway_bus = &kTrue;
+    }
+  }
+
+  if (!get(kv, tag::kOneway_Taxi) && get(kv, tag::kOneway_Psv)) {
+    set(kv, tag::kOneway_Taxi, get(kv, tag::kOneway_Psv));
+  }
+  if ((is(kv, tag::kOneway, "yes") && is(kv, tag::kOneway_Taxi, "no")) ||
+      is(kv, tag::kTaxi_Backward, "yes") || is(kv, tag::kTaxi_Backward, "designated")) {
+    set(kv, tag::kTaxiBackward, kTrue);
+  }
+  if (!get(kv, tag::kTaxiBackward) || is(kv, tag::kTaxiBackward, "false")) {
+    set(kv, tag::kTaxiBackward, first({flag(kPsv, get(kv, tag::kLanes_Psv_Backward)), &kFalse}));
+  }
+  const std::string* oneway_taxi = nullptr;
+  if (is(kv, tag::kTaxiBackward, "true")) {
+    oneway_taxi = flag(kOneway, get(kv, tag::kOneway_Taxi));
+    if (is(oneway_taxi, "false") && is(kv, tag::kTaxi_Backward, "yes")) {
+      oneway_taxi = &kTrue;
+    }
+  }
+
+  if (!get(kv, tag::kMopedBackward)) {
+    set(kv, tag::kMopedBackward, kFalse);
+  }
+  if ((is(kv, tag::kOneway, "yes") &&
+       (is(kv, tag::kOneway_Moped, "no") || is(kv, tag::kOneway_Mofa, "no"))) ||
+      is(kv, tag::kMoped_Backward, "yes") || is(kv, tag::kMofa_Backward, "yes")) {
+    set(kv, tag::kMopedBackward, kTrue);
+  }
+  const std::string* oneway_moped = nullptr;
+  if (is(kv, tag::kMopedBackward, "true")) {
+    oneway_moped = first({flag(kOneway, get(kv, tag::kOneway_Moped)),
+                          flag(kOneway, get(kv, tag::kOneway_Mofa))});
+  }
+
+  if (!get(kv, tag::kMotorcycleBackward)) {
+    set(kv, tag::kMotorcycleBackward, kFalse);
+  }
+  if ((is(kv, tag::kOneway, "yes") && is(kv, tag::kOneway_Motorcycle, "no")) ||
+      is(kv, tag::kMotorcycle_Backward, "yes")) {
+    set(kv, tag::kMotorcycleBackward, kTrue);
+  }
+  const std::string* oneway_motorcycle = nullptr;
+  if (is(kv, tag::kMotorcycleBackward, "true")) {
+    oneway_motorcycle = flag(kOneway, get(kv, tag::kOneway_Motorcycle));
+  }
+
+  if (!get(kv, tag::kPedestrianBackward)) {
+    set(kv, tag::kPedestrianBackward, kFalse);
+  }
+  if ((is(kv, tag::kOneway, "yes") && is(kv, tag::kOneway_Foot, "no")) ||
+      is(kv, tag::kFoot_Backward, "yes")) {
+    set(kv, tag::kPedestrianBackward, kTrue);
+  }
+  const std::string* oneway_foot = nullptr;
+  if (is(kv, tag::kPedestrianBackward, "true")) {
+    oneway_foot = flag(kOneway, get(kv, tag::kOneway_Foot));
+  }
+
+  bool oneway_reverse = is(kv, tag::kOneway, "-1");
+  const std::string* oneway_norm = flag(kOneway, get(kv, tag::kOneway));
+  if (is(kv, tag::kJunction, "roundabout") || is(kv, tag::kJunction, "circular")) {
+    oneway_norm = &kTrue;
+    set(kv, tag::kRoundabout, kTrue);
+  } else {
+    set(kv, tag::kRoundabout, kFalse);
+  }
+  set(kv, tag::kOneway, oneway_norm);
+
+  // the mode only goes in reverse or goes both ways on a oneway
+  auto oneway_mode = [&kv](tag::Key backward, tag::Key forward, const std::string* oneway) {
+    if (is(kv, backward, "true")) {
+      if (is(oneway, "true")) {
+        set(kv, forward, kFalse);
+      } else if (is(oneway, "false")) {
+        set(kv, forward, kTrue);
+      }
+    }
+  };
+  // the lua also compares oneway[...] to false here, which never holds because the table has strings
+  auto unset_or = [&kv](tag::Key key, const char* value) {
+    return !get(kv, key) || is(kv, key, value);
+  };
+  if (is(oneway_norm, "true")) {
+    set(kv, tag::kAutoBackward, kFalse);
+    set(kv, tag::kTruckBackward, kFalse);
+    set(kv, tag::kEmergencyBackward, kFalse);
+
+    oneway_mode(tag::kBikeBackward, tag::kBikeForward, oneway_bike);
+    oneway_mode(tag::kBusBackward, tag::kBusForward, oneway_bus);
+    oneway_mode(tag::kTaxiBackward, tag::kTaxiForward, oneway_taxi);
+    oneway_mode(tag::kMopedBackward, tag::kMopedForward, oneway_moped);
+    oneway_mode(tag::kMotorcycleBackward, tag::kMotorcycleForward, oneway_motorcycle);
+    // don't apply oneway tag unless oneway:foot or pedestrian only way
+    if (is(kv, tag::kHighway, "footway") || is(kv, tag::kHighway, "pedestrian") ||
+        is(kv, tag::kHighway, "steps") || is(kv, tag::kHighway, "path") ||
+        get(kv, tag::kOneway_Foot)) {
+      oneway_mode(tag::kPedestrianBackward, tag::kPedestrianForward, oneway_foot);
+    } else {
+      set(kv, tag::kPedestrianBackward, get(kv, tag::kPedestrianForward));
+    }
+  } else if (!oneway_norm || is(oneway_norm, "false")) {
+    set(kv, tag::kAutoBackward, get(kv, tag::kAutoForward));
+    set(kv, tag::kTruckBackward, get(kv, tag::kTruckForward));
+    set(kv, tag::kEmergencyBackward, get(kv, tag::kEmergencyForward));
+
+    if (is(kv, tag::kBikeBackward, "false") && !is(kv, tag::kOneway_Bicycle, "-1") &&
+        unset_or(tag::kOneway_Bicycle, "no")) {
+      set(kv, tag::kBikeBackward, get(kv, tag::kBikeForward));
+    }
+    if (is(kv, tag::kBusBackward, "false") && !is(kv, tag::kOneway_Bus, "-1") &&
+        !get(kv, tag::kOneway_Bus)) {
+      set(kv, tag::kBusBackward, get(kv, tag::kBusForward));
+    }
+    if (is(kv, tag::kTaxiBackward, "false") && !is(kv, tag::kOneway_Taxi, "-1") &&
+        !get(kv, tag::kOneway_Taxi)) {
+      set(kv, tag::kTaxiBackward, get(kv, tag::kTaxiForward));
+    }
+    if (is(kv, tag::kMopedBackward, "false") && unset_or(tag::kOneway_Moped, "no") &&
+        unset_or(tag::kOneway_Mofa, "no")) {
+      set(kv, tag::kMopedBackward, get(kv, tag::kMopedForward));
+    }
+    if (is(kv, tag::kMotorcycleBackward, "false") && !is(kv, tag::kOneway_Motorcycle, "-1") &&
+        unset_or(tag::kOneway_Motorcycle, "no")) {
+      set(kv, tag::kMotorcycleBackward, get(kv, tag::kMotorcycleForward));
+    }
+    if (is(kv, tag::kPedestrianBackward, "false") && unset_or(tag::kOneway_Foot, "no")) {
+      set(kv, tag::kPedestrianBackward, get(kv, tag::kPedestrianForward));
+    }
+  }
+
+  // bike forward / backward overrides
+  if (cycle_lane(get(kv, tag::kCycleway_Both)) ||
+      (cycle_lane(get(kv, tag::kCycleway_Right)) && cycle_lane(get(kv, tag::kCycleway_Left)))) {
+    set(kv, tag::kBikeForward, kTrue);
+    set(kv, tag::kBikeBackward, kTrue);
+  }
+  if (is(kv, tag::kBusway, "lane") ||
+      (is(kv, tag::kBusway_Left, "lane") && is(kv, tag::kBusway_Right, "lane"))) {
+    set(kv, tag::kBusForward, kTrue);
+    set(kv, tag::kBusBackward, kTrue);
+  }
+
+  // flip the onewayness
+  set(kv, tag::kOnewayReverse, kFalse);
+  if (oneway_reverse) {
+    set(kv, tag::kOnewayReverse, kTrue);
+    for (size_t i = 0; i < kModeCount; ++i) {
+      swap(kv, kForward[i], kBackward[i]);
+    }
+    swap(kv, tag::kEmergencyForward, tag::kEmergencyBackward);
+  }
+  if (is(kv, tag::kOneway_Bicycle, "-1")) {
+    swap(kv, tag::kBikeForward, tag::kBikeBackward);
+  }
+  if (is(kv, tag::kOneway_Moped, "-1") || is(kv, tag::kOneway_Mofa, "-1")) {
+    swap(kv, tag::kMopedForward, tag::kMopedBackward);
+  }
+  if (is(kv, tag::kOneway_Motorcycle, "-1")) {
+    swap(kv, tag::kMotorcycleForward, tag::kMotorcycleBackward);
+  }
+  if (is(kv, tag::kOneway_Foot, "-1")) {
+    swap(kv, tag::kPedestrianForward, tag::kPedestrianBackward);
+  }
+  if (is(kv, tag::kOneway_Bus, "-1")) {
+    swap(kv, tag::kBusForward, tag::kBusBackward);
+  }
+
+  // bus only logic
+  if (is(kv, tag::kLanes_Bus, "1")) {
+    set(kv, tag::kBusForward, kTrue);
+    set(kv, tag::kBusBackward, kFalse);
+  } else if (is(kv, tag::kLanes_Bus, "2")) {
+    set(kv, tag::kBusForward, kTrue);
+    set(kv, tag::kBusBackward, kTrue);
+  }
+  if (is(kv, tag::kOneway_Taxi, "-1")) {
+    swap(kv, tag::kTaxiForward, tag::kTaxiBackward);
+  }
+  if (is(kv, tag::kLanes_Psv, "1")) {
+    set(kv, tag::kTaxiForward, kTrue);
+    set(kv, tag::kTaxiBackward, kFalse);
+  } else if (is(kv, tag::kLanes_Psv, "2")) {
+    set(kv, tag::kTaxiForward, kTrue);
+    set(kv, tag::kTaxiBackward, kTrue);
+  }
+
+  // if none of the modes were set we are done looking at this, taxi is not looked at
+  bool any_access = false;
+  for (size_t i = 0; i < kModeCount; ++i) {
+    any_access = any_access || (kForward[i] != tag::kTaxiForward &&
+                                (!is(kv, kForward[i], "false") || !is(kv, kBackward[i], "false")));
+  }
+  any_access = any_access || !is(kv, tag::kEmergencyForward, "false") ||
+               !is(kv, tag::kEmergencyBackward, "false");
+  // save bridleways for country access logic
+  if (!any_access && !is(kv, tag::kHighway, "bridleway")) {
+    return true;
+  }
+
+  // toss actual areas
+  if (is(kv, tag::kArea, "yes")) {
+    return true;
+  }
+
+  kv.erase(tag::kFIXME);
+  kv.erase(tag::kNote);
+  kv.erase(tag::kSource);
+
+  // set a few flags
+  const uint32_t* rc =
+      lookup(kRoadClasses,
+             get(kv, is(kv, tag::kHighway, "construction") ? tag::kConstruction : tag::kHighway));
+  uint32_t road_class = rc ? *rc : 7; // service and other = 7
+  if (!get(kv, tag::kHighway) && ferry) {
+    road_class = 2;
+  } else if (!get(kv, tag::kHighway) &&
+             (get(kv, tag::kRailway) || is(kv, tag::kRoute, "shuttle_train"))) {
+    road_class = 2;
+  }
+  set_number(kv, tag::kRoadClass, road_class);
+  set_number(kv, tag::kDefaultSpeed, kDefaultSpeeds[road_class]);
+
+  // lower the default speed for driveways
+  if (is(kv, tag::kService, "driveway")) {
+    set_number(kv, tag::kDefaultSpeed, std::floor(kDefaultSpeeds[road_class] * 0.5));
+  }
+
+  const uint32_t* service_use = lookup(kUses, get(kv, tag::kService));
+  std::optional<uint32_t> use = service_use ? std::optional<uint32_t>(*service_use) : std::nullopt;
+  auto none_of = [&kv](std::initializer_list<tag::Key> keys) {
+    for (auto key : keys) {
+      if (!is(kv, key, "false")) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (get(kv, tag::kHighway)) {
+    if (is(kv, tag::kHighway, "construction")) {
+      use = 43;
+    } else if (is(kv, tag::kHighway, "track")) {
+      use = 3;
+    } else if (is(kv, tag::kHighway, "living_street")) {
+      use = 10;
+    } else if (!use && is(kv, tag::kHighway, "service")) {
+      use = 11;
+    } else if (is(kv, tag::kHighway, "cycleway")) {
+      use = 20;
+    } else if (none_of({tag::kPedestrianForward, tag::kAutoForward, tag::kAutoBackward}) &&
+               (is(kv, tag::kBikeForward, "true") || is(kv, tag::kBikeBackward, "true"))) {
+      use = 20;
+    } else if (is(kv, tag::kHighway, "footway") && is(kv, tag::kFootway, "sidewalk")) {
+      use = 24;
+    } else if (is(kv, tag::kHighway, "footway") && is(kv, tag::kFootway, "crossing")) {
+      use = 32;
+    } else if (is(kv, tag::kHighway, "footway")) {
+      use = 25;
+    } else if (is(kv, tag::kHighway, "steps")) {
+      use = 26; // steps/stairs
+    } else if (is(kv, tag::kHighway, "path")) {
+      use = 27;
+    } else if (is(kv, tag::kHighway, "pedestrian")) {
+      use = 28;
+    } else if (is(kv, tag::kPedestrianForward, "true") &&
+               none_of({tag::kAutoForward, tag::kAutoBackward, tag::kTruckForward,
+                        tag::kTruckBackward, tag::kBusForward, tag::kBusBackward,
+                        tag::kBikeForward, tag::kBikeBackward, tag::kMopedForward,
+                        tag::kMopedBackward, tag::kMotorcycleForward, tag::kMotorcycleBackward})) {
+      use = 28;
+    } else if (is(kv, tag::kHighway, "bridleway")) {
+      use = 29;
+    }
+  }
+  if (!use && get(kv, tag::kService)) {
+    use = 40; // other
+  } else if (!use) {
+    use = 0; // general road, no special use
+  }
+
+  // do not override 'construction' use
+  if (use != 43u && (is(kv, tag::kAccess, "emergency") || is(kv, tag::kEmergency, "yes")) &&
+      none_of({tag::kAutoForward, tag::kAutoBackward, tag::kTruckForward, tag::kTruckBackward,
+               tag::kBusForward, tag::kBusBackward, tag::kBikeForward, tag::kBikeBackward,
+               tag::kMopedForward, tag::kMopedBackward, tag::kMotorcycleForward,
+               tag::kMotorcycleBackward})) {
+    use = 7;
+  }
+  set_number(kv, tag::kUse, *use);
+
+  const std::string* r_shoulder = first(
+      {flag(kShoulder, get(kv, tag::kShoulder)), flag(kShoulder, get(kv, tag::kShoulder_Both))});
+  const std::string* l_shoulder = r_shoulder;
+  if (!r_shoulder) {
+    r_shoulder = first({flag(kShoulder, get(kv, tag::kShoulder_Right)),
+                        flag(kShoulderRight, get(kv, tag::kShoulder)), &kFalse});
+    l_shoulder = first({flag(kShoulder, get(kv, tag::kShoulder_Left)),
+                        flag(kShoulderLeft, get(kv, tag::kShoulder)), &kFalse});
+
+    // If the road is oneway and one shoulder is tagged but not the other, we set both to true so
+    // that when setting the shoulder in graphbuilder, driving on the right side vs the left side
+    // doesn't cause the edge to miss the shoulder tag
+    if (is(oneway_norm, "true") && *r_shoulder == kTrue && *l_shoulder == kFalse) {
+      l_shoulder = &kTrue;
+    } else if (is(oneway_norm, "true") && *r_shoulder == kFalse && *l_shoulder == kTrue) {
+      r_shoulder = &kTrue;
+    }
+  }
+  set(kv, tag::kShoulderRight, r_shoulder);
+  set(kv, tag::kShoulderLeft, l_shoulder);
+
+  const std::string* cycle_lane_right_opposite = &kFalse;
+  const std::string* cycle_lane_left_opposite = &kFalse;
+  uint32_t cycle_lane_right = 0;
+  uint32_t cycle_lane_left = 0;
+
+  // We have special use cases for cycle lanes when on a cycleway, footway, or path
+  if ((use == 20u || use == 25u || use == 27u) &&
+      (is(kv, tag::kBikeForward, "true") || is(kv, tag::kBikeBackward, "true"))) {
+    if (is(kv, tag::kPedestrianForward, "false")) {
+      cycle_lane_right = 3; // separated
+    } else if (is(kv, tag::kSegregated, "yes")) {
+      cycle_lane_right = 2; // dedicated
+    } else if (is(kv, tag::kSegregated, "no")) {
+      cycle_lane_right = 1; // shared
+    } else if (use == 20u) {
+      cycle_lane_right = 2; // no segregated tag on a cycleway so we assume separated lanes
+    } else {
+      cycle_lane_right = 1; // no segregated tag on a footway or path so we assume shared lanes
+    }
+    cycle_lane_left = cycle_lane_right;
+  } else {
+    // Set flags if any of the lanes are marked "opposite" (contraflow)
+    cycle_lane_right_opposite = first({flag(kBikeReverse, get(kv, tag::kCycleway)), &kFalse});
+    cycle_lane_left_opposite = cycle_lane_right_opposite;
+    if (*cycle_lane_right_opposite == kFalse) {
+      cycle_lane_right_opposite = first({flag(kBikeReverse, get(kv, tag::kCycleway_Right)), &kFalse});
+      cycle_lane_left_opposite = first({flag(kBikeReverse, get(kv, tag::kCycleway_Left)), &kFalse});
+    }
+
+    // Figure out which side of the road has what cyclelane
+    auto lane = [&kv](tag::Key key, tag::Key buffer) {
+      const uint32_t* value = first({cycle_lane(get(kv, key)), lookup(kBuffer, get(kv, buffer))});
+      return value ? *value : 0;
+    };
+    cycle_lane_right = lane(tag::kCycleway, tag::kCycleway_Both_Buffer);
+    cycle_lane_left = cycle_lane_right;
+    if (cycle_lane_right == 0) {
+      cycle_lane_right = lane(tag::kCycleway_Right, tag::kCycleway_Right_Buffer);
+      cycle_lane_left = lane(tag::kCycleway_Left, tag::kCycleway_Left_Buffer);
+    }
+
+    // If we have the oneway:bicycle=no tag and there are not "opposite_lane/opposite_track" tags
+    // then there are certain situations where the cyclelane is considered a two-way. (Based off of
+    // some examples on wiki.openstreetmap.org/wiki/Bicycle)
+    if (is(kv, tag::kOneway_Bicycle, "no") && *cycle_lane_right_opposite == kFalse &&
+        *cycle_lane_left_opposite == kFalse) {
+      if (cycle_lane_right == 2 || cycle_lane_right == 3) {
+        if (is(oneway_norm, "true")) { // Example M1 or M2d but on the right side
+          cycle_lane_left = cycle_lane_right;
+          cycle_lane_left_opposite = &kTrue;
+        } else if (cycle_lane_left == 0) { // Example L1b
+          cycle_lane_left = cycle_lane_right;
+        }
+      } else if (cycle_lane_left == 2 || cycle_lane_left == 3) {
+        if (is(oneway_norm, "true")) { // Example M2d
+          cycle_lane_right = cycle_lane_left;
+          cycle_lane_right_opposite = &kTrue;
+        } else if (cycle_lane_right == 0) { // Example L1b but on the left side
+          cycle_lane_right = cycle_lane_left;
+        }
+      }
+    }
+  }
+  set_number(kv, tag::kCycleLaneRight, cycle_lane_right);
+  set_number(kv, tag::kCycleLaneLeft, cycle_lane_left);
+  set(kv, tag::kCycleLaneRightOpposite, cycle_lane_right_opposite);
+  set(kv, tag::kCycleLaneLeftOpposite, cycle_lane_left_opposite);
+
+  const std::string* highway_type =
+      get(kv, is(kv, tag::kHighway, "construction") ? tag::kConstruction : tag::kHighway);
+  if (highway_type && highway_type->find("_link") != std::string::npos) { // *_link
+    set(kv, tag::kLink, kTrue);
+  }
+
+  set(kv, tag::kPrivate,
+      first({flag(kPrivate, get(kv, tag::kAccess)), flag(kPrivate, get(kv, tag::kMotorVehicle)),
+             &kFalse}));
+  set(kv, tag::kNoThruTraffic, first({flag(kNoThruTraffic, get(kv, tag::kAccess)), &kFalse}));
+  set(kv, tag::kFerry, ferry ? kTrue : kFalse);
+  set(kv, tag::kRail, is(kv, tag::kAutoForward, "true") &&
+                          (is(kv, tag::kRailway, "rail") || is(kv, tag::kRoute, "shuttle_train"))
+                      ? kTrue
+                      : kFalse);
+
+  if (is(kv, tag::kMaxspeed, "none")) {
+    // special case unlimited speed limit (german autobahn)
+    set(kv, tag::kMaxSpeed, std::string("unlimited"));
+  } else {
+    set_number(kv, tag::kMaxSpeed, normalize_speed(get(kv, tag::kMaxspeed)));
+  }
+  set_number(kv, tag::kAdvisorySpeed, normalize_speed(get(kv, tag::kMaxspeed_Advisory)));
+  set_number(kv, tag::kAverageSpeed, normalize_speed(get(kv, tag::kMaxspeed_Practical)));
+  set_number(kv, tag::kBackwardSpeed, normalize_speed(get(kv, tag::kMaxspeed_Backward)));
+  set_number(kv, tag::kForwardSpeed, normalize_speed(get(kv, tag::kMaxspeed_Forward)));
+  set(kv, tag::kWheelchair, flag(kWheelchair, get(kv, tag::kWheelchair)));
+
+  // lower the default speed for tracks
+  if (is(kv, tag::kHighway, "track")) {
+    uint32_t speed = 5;
+    if (is(kv, tag::kTracktype, "grade1")) {
+      speed = 20;
+    } else if (is(kv, tag::kTracktype, "grade2")) {
+      speed = 15;
+    } else if (is(kv, tag::kTracktype, "grade3")) {
+      speed = 12;
+    } else if (is(kv, tag::kTracktype, "grade4")) {
+      speed = 10;
+    }
+    set_number(kv, tag::kDefaultSpeed, speed);
+  }
+
+  // use unsigned_ref if all the conditions are met
+  if (!get(kv, tag::kName) && !get(kv, tag::kName_En) && !get(kv, tag::kAltName) &&
+      !get(kv, tag::kOfficialName) && !get(kv, tag::kRef) && !get(kv, tag::kIntRef) &&
+      (is(kv, tag::kHighway, "motorway") || is(kv, tag::kHighway, "trunk") ||
+       is(kv, tag::kHighway, "primary")) &&
+      get(kv, tag::kUnsignedRef)) {
+    set(kv, tag::kRef, get(kv, tag::kUnsignedRef));
+  }
+
+  set_number(kv, tag::kLanes, lane_count(get(kv, tag::kLanes)));
+  set_number(kv, tag::kForwardLanes, lane_count(get(kv, tag::kLanes_Forward)));
+  set_number(kv, tag::kBackwardLanes, lane_count(get(kv, tag::kLanes_Backward)));
+
+  set(kv, tag::kBridge, first({flag(kBridge, get(kv, tag::kBridge)), &kFalse}));
+
+  // TODO access:conditional
+  if (get(kv, tag::kSeasonal) && !is(kv, tag::kSeasonal, "no")) {
+    set(kv, tag::kSeasonal, kTrue);
+  }
+
+  set(kv, tag::kHovTag, kTrue);
+  if (is(kv, tag::kHov, "no")) {
+    set(kv, tag::kHovForward, kFalse);
+    set(kv, tag::kHovBackward, kFalse);
+  } else {
+    set(kv, tag::kHovForward, get(kv, tag::kAutoForward));
+    set(kv, tag::kHovBackward, get(kv, tag::kAutoBackward));
+  }
+
+  // hov restrictions
+  if ((get(kv, tag::kHov) && !is(kv, tag::kHov, "no")) || get(kv, tag::kHov_Lanes) ||
+      get(kv, tag::kHov_Minimum)) {
+    bool only_hov_allowed = is(kv, tag::kHov, "designated");
+    if (only_hov_allowed && get(kv, tag::kHov_Lanes)) {
+      const std::string& lanes = *get(kv, tag::kHov_Lanes);
+      for (size_t start = 0; start <= lanes.size();) {
+        size_t end = std::min(lanes.find('|', start), lanes.size());
+        if (lanes.compare(start, end - start, "designated") != 0) {
+          only_hov_allowed = false;
+        }
+        start = end + 1;
+      }
+    }
+
+    if (only_hov_allowed) {
+      // If we get here we know the way is a true hov-lane (not mixed). As a result, none of the
+      // following costings can use it. (Okay, that's not exactly true, we do some wizardry in some
+      // of the costings to allow hov under certain conditions.)
+      if (!get(kv, tag::kAutoTag)) {
+        set(kv, tag::kAutoForward, kFalse);
+        set(kv, tag::kAutoBackward, kFalse);
+      }
+      if (!get(kv, tag::kTruckTag)) {
+        set(kv, tag::kTruckForward, kFalse);
+        set(kv, tag::kTruckBackward, kFalse);
+      }
+      if (!get(kv, tag::kFootTag)) {
+        set(kv, tag::kPedestrianForward, kFalse);
+        set(kv, tag::kPedestrianBackward, kFalse);
+      }
+      if (!get(kv, tag::kBikeTag)) {
+        set(kv, tag::kBikeForward, kFalse);
+        set(kv, tag::kBikeBackward, kFalse);
+      }
+
+      // only 2 or 3 are accepted for "hov:minimum" because routing onto an HOV lane without the
+      // correct number of occupants is illegal
+      if (is(kv, tag::kHov_Minimum, "2")) {
+        set(kv, tag::kHovType, std::string("HOV2"));
+      } else if (is(kv, tag::kHov_Minimum, "3")) {
+        set(kv, tag::kHovType, std::string("HOV3"));
+      }
+
+      // HOV lanes are sometimes time-conditional and can change direction. We avoid these. Also,
+      // we expect "hov_type" to be set.
+      if (is(kv, tag::kOneway, "alternating") || is(kv, tag::kOneway, "reversible") ||
+          is(kv, tag::kOneway, "false") || get(kv, tag::kOneway_Conditional) ||
+          get(kv, tag::kAccess_Conditional) || !get(kv, tag::kHovType)) {
+        set(kv, tag::kHovForward, kFalse);
+        set(kv, tag::kHovBackward, kFalse);
+      }
+    }
+  }
+
+  set(kv, tag::kTunnel, first({flag(kTunnel, get(kv, tag::kTunnel)), &kFalse}));
+  set(kv, tag::kToll, first({flag(kToll, get(kv, tag::kToll)), &kFalse}));
+
+  // truck goodies
+  auto maxheight = normalize_measurement(get(kv, tag::kMaxheight));
+  set_number(kv, tag::kMaxheight,
+             maxheight ? maxheight : normalize_measurement(get(kv, tag::kMaxheight_Physical)));
+  auto maxwidth = normalize_measurement(get(kv, tag::kMaxwidth));
+  set_number(kv, tag::kMaxwidth,
+             maxwidth ? maxwidth : normalize_measurement(get(kv, tag::kMaxwidth_Physical)));
+  set_number(kv, tag::kMaxlength, normalize_measurement(get(kv, tag::kMaxlength)));
+  set_number(kv, tag::kMaxweight, normalize_weight(get(kv, tag::kMaxweight)));
+  set_number(kv, tag::kMaxaxleload, normalize_weight(get(kv, tag::kMaxaxleload)));
+
+  // TODO: hazmat really should have subcategories
+  set(kv, tag::kHazmat,
+      first({flag(kHazmat, get(kv, tag::kHazmat)), flag(kHazmat, get(kv, tag::kHazmat_Water)),
+             flag(kHazmat, get(kv, tag::kHazmat_A)), flag(kHazmat, get(kv, tag::kHazmat_B)),
+             flag(kHazmat, get(kv, tag::kHazmat_C)), flag(kHazmat, get(kv, tag::kHazmat_D)),
+             flag(kHazmat, get(kv, tag::kHazmat_E))}));
+  set_number(kv, tag::kMaxspeed_Hgv, normalize_speed(get(kv, tag::kMaxspeed_Hgv)));
+
+  if (get(kv, tag::kHgv_NationalNetwork) || get(kv, tag::kHgv_StateNetwork) ||
+      is(kv, tag::kHgv, "local") || is(kv, tag::kHgv, "designated")) {
+    set(kv, tag::kTruckRoute, kTrue);
+  }
+
+  uint32_t bike_mask = 0;
+  if (get(kv, tag::kNcnRef) || is(kv, tag::kNcn, "yes")) {
+    bike_mask = 1;
+  }
+  if (get(kv, tag::kRcnRef) || is(kv, tag::kRcn, "yes")) {
+    bike_mask |= 2;
+  }
+  if (get(kv, tag::kLcnRef) || is(kv, tag::kLcn, "yes")) {
+    bike_mask |= 4;
+  }
+  if (is(kv, tag::kMtb, "yes")) {
+    bike_mask |= 8;
+  }
+  set(kv, tag::kBikeNationalRef, get(kv, tag::kNcnRef));
+  set(kv, tag::kBikeRegionalRef, get(kv, tag::kRcnRef));
+  set(kv, tag::kBikeLocalRef, get(kv, tag::kLcnRef));
+  set_number(kv, tag::kBikeNetworkMask, bike_mask);
+
+  // Explicitly turn off access for construction type. It's done for backward compatibility of
+  // valhalla tiles and valhalla routing, older routers only look at the access to decide whether
+  // an edge is routable and dont know about Use::kConstruction.
+  if (is(kv, tag::kHighway, "construction")) {
+    no_access(true);
+    for (auto key : {tag::kHovForward, tag::kHovBackward, tag::kEmergencyForward,
+                     tag::kEmergencyBackward}) {
+      set(kv, key, kFalse);
+    }
+  }
+
+  return false;
+}
+
+// ways_proc in the lua
+Tags way(const Tags& tags) {
+  // if there were no tags passed in we dont care about it
+  if (tags.empty()) {
+    return {};
+  }
+  Kv kv(tags);
+  try {
+    if (filter_way(kv)) {
+      return {};
+    }
+  } catch (const std::exception& e) {
+    // the lua errors out on the same tags, which gets the way skipped
+    LOG_ERROR(std::string("Failed to transform the tags of a way: ") + e.what());
+    return {};
+  }
+  return kv.tags();
+}
+
+// nodes_proc in the lua
+Tags node(const Tags& tags) {
+  Kv kv(tags);
+
+  if (const std::string* iso = get(kv, tag::kIso_3166_2)) {
+    std::string code = *iso;
+    auto dash = code.find('-');
+    if (dash == 2) {
+      if (code.size() == 6 || code.size() == 5) {
+        set(kv, tag::kStateIsoCode, code.substr(3));
+      }
+    } else if (dash == std::string::npos) {
+      if (code.size() == 2 || code.size() == 3) {
+        set(kv, tag::kStateIsoCode, code);
+      } else if (code.size() == 4 || code.size() == 5) {
+        set(kv, tag::kStateIsoCode, code.substr(2));
+      }
+    }
+  }
+
+  // normalize a few tags that we care about
+  const std::string* initial_access = flag(kAccess, get(kv, tag::kAccess));
+  bool access = !is(initial_access, "false");
+  if (is(kv, tag::kImpassable, "yes") ||
+      (is(kv, tag::kAccess, "private") &&
+       (is(kv, tag::kEmergency, "yes") || is(kv, tag::kService, "emergency_access")))) {
+    access = false;
+  }
+
+  std::optional<uint32_t> hov_tag;
+  if ((get(kv, tag::kHov) && !is(kv, tag::kHov, "no")) || get(kv, tag::kHov_Lanes) ||
+      get(kv, tag::kHov_Minimum)) {
+    hov_tag = 128;
+  }
+
+  auto foot_tag = mask(kFootNode, get(kv, tag::kFoot));
+  auto wheelchair_tag = mask(kWheelchairNode, get(kv, tag::kWheelchair));
+  auto bike_tag = mask(kBicycleNode, get(kv, tag::kBicycle));
+  auto truck_tag = mask(kTruckNode, get(kv, tag::kHgv));
+  auto auto_tag = mask(kMotorVehicleNode, get(kv, tag::kMotorcar));
+  auto motor_vehicle_tag = mask(kMotorVehicleNode, get(kv, tag::kMotorVehicle));
+  auto moped_tag = mask(kMopedNode, get(kv, tag::kMoped));
+  if (!moped_tag) {
+    moped_tag = mask(kMopedNode, get(kv, tag::kMofa));
+  }
+  auto motorcycle_tag = mask(kMotorCycleNode, get(kv, tag::kMotorcycle));
+
+  if (!auto_tag) {
+    auto_tag = motor_vehicle_tag;
+  }
+  std::optional<uint32_t> bus_tag;
+  std::optional<uint32_t> taxi_tag;
+  if (is(kv, tag::kAccess, "psv")) {
+    bus_tag = 64;
+    taxi_tag = 32;
+  } else {
+    bus_tag = mask(kBusNode, get(kv, tag::kBus));
+    taxi_tag = mask(kTaxiNode, get(kv, tag::kTaxi));
+  }
+
+  if (!bus_tag) {
+    bus_tag = mask(kPsvBusNode, get(kv, tag::kPsv));
+  }
+  // if bus was not set and car is
+  if (!bus_tag && auto_tag == 1u) {
+    bus_tag = 64;
+  }
+  // if wheelchair was not set and foot is
+  if (!wheelchair_tag && foot_tag == 2u) {
+    wheelchair_tag = 256;
+  }
+  // if hov was not set and car is
+  if (!hov_tag && auto_tag == 1u) {
+    hov_tag = 128;
+  }
+  if (!taxi_tag) {
+    taxi_tag = mask(kPsvTaxiNode, get(kv, tag::kPsv));
+  }
+  // if taxi was not set and car is
+  if (!taxi_tag && auto_tag == 1u) {
+    taxi_tag = 32;
+  }
+  // if truck was not set and car is
+  if (!truck_tag && auto_tag == 1u) {
+    truck_tag = 8;
+  }
+
+  // must shut these off if motor_vehicle = 0
+  if (motor_vehicle_tag == 0u) {
+    for (auto* tag : {&hov_tag, &bus_tag, &taxi_tag, &truck_tag, &moped_tag, &motorcycle_tag}) {
+      *tag = tag->value_or(0);
+    }
+  }
+
+  std::optional<uint32_t> emergency_tag;
+  if (is(kv, tag::kAccess, "emergency") || is(kv, tag::kEmergency, "yes") ||
+      is(kv, tag::kService, "emergency_access")) {
+    emergency_tag = 16;
+  }
+
+  // do not shut off bike access if there is a highway crossing
+  if (bike_tag == 0u && is(kv, tag::kHighway, "crossing")) {
+    bike_tag = 4;
+  }
+
+  // if tag exists use it, otherwise access allowed for all modes unless access = false or
+  // kv["hov"] == "designated" or kv["vehicle"] == "no". if access=private use allowed modes, but
+  // consider private_access tag as true.
+  uint32_t auto_mask = auto_tag.value_or(1);
+  uint32_t truck = truck_tag.value_or(8);
+  uint32_t bus = bus_tag.value_or(64);
+  uint32_t taxi = taxi_tag ? *taxi_tag : auto_tag.value_or(32);
+  uint32_t foot = foot_tag.value_or(2);
+  uint32_t wheelchair = wheelchair_tag.value_or(256);
+  uint32_t bike = bike_tag.value_or(4);
+  uint32_t emergency = emergency_tag.value_or(16);
+  uint32_t hov = hov_tag ? *hov_tag : auto_tag.value_or(128);
+  uint32_t moped = moped_tag.value_or(512);
+  uint32_t motorcycle = motorcycle_tag.value_or(1024);
+
+  // if access = false use tag if exists, otherwise no access for that mode
+  if (!access || is(kv, tag::kVehicle, "no") || is(kv, tag::kHov, "designated")) {
+    auto_mask = auto_tag.value_or(0);
+    truck = truck_tag.value_or(0);
+    bus = bus_tag.value_or(0);
+    taxi = taxi_tag.value_or(0);
+    // don't change ped if kv["vehicle"] == "no"
+    if (!access || is(kv, tag::kHov, "designated")) {
+      foot = foot_tag.value_or(0);
+    }
+    wheelchair = wheelchair_tag.value_or(0);
+    bike = bike_tag.value_or(0);
+    moped = moped_tag.value_or(0);
+    motorcycle = motorcycle_tag.value_or(0);
+    emergency = emergency_tag.value_or(0);
+    hov = hov_tag.value_or(0);
+  }
+
+  // check for gates, bollards, and sump_busters
+  bool gate = is(kv, tag::kBarrier, "gate") || is(kv, tag::kBarrier, "yes") ||
+              is(kv, tag::kBarrier, "lift_gate") || is(kv, tag::kBarrier, "swing_gate");
+  bool bollard = false;
+  bool sump_buster = false;
+  if (!gate) {
+    // if there was a bollard cars can't get through it
+    bollard = is(kv, tag::kBarrier, "bollard") || is(kv, tag::kBarrier, "block") ||
+              is(kv, tag::kBarrier, "jersey_barrier") || is(kv, tag::kBollard, "removable");
+    // if sump_buster then no access for auto, hov, and taxi unless a tag exists
+    sump_buster = is(kv, tag::kBarrier, "sump_buster");
+
+    // save the following as gates
+    if (bollard && is(kv, tag::kBollard, "rising")) {
+      gate = true;
+      bollard = false;
+    }
+
+    if (bollard && !initial_access) {
+      // bollard = true shuts off access when access is not originally specified
+      auto_mask = auto_tag.value_or(0);
+      truck = truck_tag.value_or(0);
+      bus = bus_tag.value_or(0);
+      taxi = taxi_tag.value_or(0);
+      foot = foot_tag.value_or(2);
+      wheelchair = wheelchair_tag.value_or(256);
+      bike = bike_tag.value_or(4);
+      moped = moped_tag.value_or(0);
+      motorcycle = motorcycle_tag.value_or(0);
+      emergency = emergency_tag.value_or(0);
+      hov = hov_tag.value_or(0);
+    } else if (sump_buster) {
+      // sump_buster = true shuts off access unless the tag exists
+      auto_mask = auto_tag.value_or(0);
+      truck = truck_tag.value_or(8);
+      bus = bus_tag.value_or(64);
+      taxi = taxi_tag.value_or(0);
+      foot = foot_tag.value_or(2);
+      wheelchair = wheelchair_tag.value_or(256);
+      bike = bike_tag.value_or(4);
+      moped = moped_tag.value_or(512);
+      motorcycle = motorcycle_tag.value_or(1024);
+      emergency = emergency_tag.value_or(16);
+      hov = hov_tag.value_or(0);
+    }
+  }
+
+  // if nothing blocks access at this node assume access is allowed
+  if (!gate && !bollard && !sump_buster && access &&
+      (is(kv, tag::kHighway, "crossing") || is(kv, tag::kRailway, "crossing") ||
+       is(kv, tag::kFootway, "crossing") || is(kv, tag::kCycleway, "crossing") ||
+       is(kv, tag::kFoot, "crossing") || is(kv, tag::kBicycle, "crossing") ||
+       is(kv, tag::kPedestrian, "crossing") || get(kv, tag::kCrossing))) {
+    auto_mask = auto_tag.value_or(1);
+    truck = truck_tag.value_or(8);
+    bus = bus_tag.value_or(64);
+    taxi = taxi_tag.value_or(32);
+    foot = foot_tag.value_or(2);
+    wheelchair = wheelchair_tag.value_or(256);
+    bike = bike_tag.value_or(4);
+    moped = moped_tag.value_or(512);
+    motorcycle = motorcycle_tag.value_or(1024);
+    emergency = emergency_tag.value_or(16);
+    hov = hov_tag.value_or(128);
+  }
+
+  // store the gate and bollard info
+  set(kv, tag::kGate, gate ? kTrue : kFalse);
+  set(kv, tag::kBollard, bollard ? kTrue : kFalse);
+  set(kv, tag::kSumpBuster, sump_buster ? kTrue : kFalse);
+
+  if (is(kv, tag::kBarrier, "border_control")) {
+    set(kv, tag::kBorderControl, kTrue);
+  } else if (is(kv, tag::kBarrier, "toll_booth")) {
+    set(kv, tag::kTollBooth, kTrue);
+    // none of the keys the rules change are payment ones so the input tags have the same payments
+    if (is_cash_only_payment(tags)) {
+      set(kv, tag::kCashOnlyToll, kTrue);
+    }
+  } else if (is(kv, tag::kHighway, "toll_gantry")) {
+    set(kv, tag::kTollGantry, kTrue);
+  }
+
+  if (is(kv, tag::kAmenity, "bicycle_rental") ||
+      (is(kv, tag::kShop, "bicycle") && is(kv, tag::kService_Bicycle_Rental, "yes"))) {
+    set(kv, tag::kBicycleRental, kTrue);
+  }
+
+  for (auto [direction, signal] : {std::make_pair("forward", tag::kForwardSignal),
+                                   std::make_pair("backward", tag::kBackwardSignal)}) {
+    if (is(kv, tag::kTrafficSignals_Direction, direction)) {
+      set(kv, signal, kTrue);
+      if (!get(kv, tag::kPublicTransport) && get(kv, tag::kName)) {
+        set(kv, tag::kJunction, std::string("named"));
+      }
+    }
+  }
+
+  // stops and give ways apply to the direction they are tagged with
+  struct Sign {
+    const char* highway;
+    tag::Key key, forward, backward;
+  };
+  for (const auto& sign : {Sign{"stop", tag::kStop, tag::kForwardStop, tag::kBackwardStop},
+                           Sign{"give_way", tag::kGiveWay, tag::kForwardYield,
+                                tag::kBackwardYield}}) {
+    if (!is(kv, tag::kHighway, sign.highway)) {
+      continue;
+    }
+    if (is(kv, tag::kDirection, "both")) {
+      set(kv, sign.forward, kTrue);
+      set(kv, sign.backward, kTrue);
+    } else if (is(kv, tag::kDirection, "forward")) {
+      set(kv, sign.forward, kTrue);
+    } else if (is(kv, tag::kDirection, "backward") || is(kv, tag::kDirection, "reverse")) {
+      set(kv, sign.backward, kTrue);
+    } else if (get(kv, tag::kDirection) && !get(kv, sign.key)) {
+      kv.erase(tag::kHighway);
+    }
+  }
+
+  if (!get(kv, tag::kPublicTransport) && get(kv, tag::kName)) {
+    if (is(kv, tag::kHighway, "traffic_signals")) {
+      if (!is(kv, tag::kJunction, "yes")) {
+        set(kv, tag::kJunction, std::string("named"));
+      }
+    } else if (is(kv, tag::kJunction, "yes") || is(kv, tag::kReferencePoint, "yes")) {
+      set(kv, tag::kJunction, std::string("named"));
+    }
+  }
+
+  set(kv, tag::kPrivate,
+      first({flag(kPrivate, get(kv, tag::kAccess)), flag(kPrivate, get(kv, tag::kMotorVehicle)),
+             &kFalse}));
+
+  // store a mask denoting access
+  set_number(kv, tag::kAccessMask, auto_mask | emergency | truck | bike | foot | wheelchair | bus |
+                                       hov | moped | motorcycle | taxi);
+
+  // if no information about access is given
+  bool tagged_access = initial_access || auto_tag || truck_tag || bus_tag || taxi_tag ||
+                       foot_tag || wheelchair_tag || bike_tag || moped_tag || motorcycle_tag ||
+                       emergency_tag || hov_tag;
+  set_number(kv, tag::kTaggedAccess, tagged_access ? 1 : 0);
+
+  return kv.tags();
+}
+
+// restriction_prefix in the lua, which is as many characters from the start as there are non
+// spaces before the @ of no_left_turn @ (07:00-09:00)
+bool restriction_prefix(const std::string* value, std::string& prefix) {
+  if (value == nullptr) {
+    return false;
+  }
+  auto at = value->find('@');
+  if (at == std::string::npos) {
+    return false;
+  }
+  size_t length = 0;
+  for (size_t i = 0; i < at; ++i) {
+    length += (*value)[i] != ' ';
+  }
+  prefix = value->substr(0, length);
+  return true;
+}
+
+// restriction_suffix in the lua, everything from the first non space after the @ or, if there are
+// only spaces after it, the last character
+bool restriction_suffix(const std::string* value, std::string& suffix) {
+  if (value == nullptr) {
+    return false;
+  }
+  auto at = value->find('@');
+  if (at == std::string::npos) {
+    return false;
+  }
+  auto start = value->find_first_not_of(' ', at + 1);
+  suffix = value->substr(start == std::string::npos ? value->size() - 1 : start);
+  return true;
+}
+
+// kv[key] = restriction_suffix(kv[key]) in the lua
+void set_suffix(Tags& tags, const char* key) {
+  std::string suffix;
+  if (restriction_suffix(get(tags, key), suffix)) {
+    tags[key] = std::move(suffix);
+  } else {
+    tags.erase(key);
+  }
+}
+
+// rels_proc in the lua
+Tags relation(const Tags& tags) {
+  const std::string* type = get(tags, "type");
+  if (type && *type == "connectivity") {
+    return tags;
+  }
+  if (!type || (*type != "route" && *type != "restriction")) {
+    return {};
+  }
+
+  Tags kv = tags;
+  if (get(kv, "restriction:probable") &&
+      (get(kv, "restriction") || get(kv, "restriction:conditional"))) {
+    kv.erase("restriction:probable");
+  }
+
+  // the restriction, which one with a mode wins over
+  std::string prefix;
+  const uint32_t* restrict = restriction(get(kv, "restriction"));
+  if (!restrict && restriction_prefix(get(kv, "restriction:conditional"), prefix)) {
+    restrict = restriction(&prefix);
+  }
+  if (!restrict && restriction_prefix(get(kv, "restriction:probable"), prefix)) {
+    restrict = restriction(&prefix);
+  }
+  const uint32_t* restrict_type = nullptr;
+  for (const auto* key : kModeRestrictions) {
+    if ((restrict_type = restriction(get(kv, key)))) {
+      restrict = restrict_type;
+      break;
+    }
+  }
+
+  if (*type == "restriction" || get(kv, "restriction:conditional") ||
+      get(kv, "restriction:probable")) {
+    if (!restrict) {
+      return {};
+    }
+    set_suffix(kv, "restriction:conditional");
+    set_suffix(kv, "restriction:probable");
+    for (const auto* key : kModeRestrictions) {
+      set(kv, key, restriction(get(kv, key)));
+    }
+    set(kv, "restriction", restrict_type ? nullptr : restrict);
+    return kv;
+  }
+
+  const std::string* route = get(kv, "route");
+  if (route && (*route == "bicycle" || *route == "mtb")) {
+    const std::string* network = get(kv, "network");
+    uint32_t bike_mask = 0;
+    if ((network && *network == "mtb") || *route == "mtb") {
+      bike_mask = 8;
+    }
+    if (network && *network == "ncn") {
+      bike_mask |= 1;
+    } else if (network && *network == "rcn") {
+      bike_mask |= 2;
+    } else if (network && *network == "lcn") {
+      bike_mask |= 4;
+    }
+    kv["bike_network_mask"] = std::to_string(bike_mask);
+  } else if (restrict) {
+    // has a restriction but the type is not restriction
+    return {};
+  }
+
+  kv.erase("day_on");
+  kv.erase("day_off");
+  kv.erase("restriction");
+  return kv;
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+Tags NativeTagTransform::Transform(OSMType type, const Tags& tags) {
+  switch (type) {
+    case OSMType::kNode:
+      return node(tags);
+    case OSMType::kWay:
+      return way(tags);
+    default:
+      return relation(tags);
+  }
+}
+
+} // namespace mjolnir
+} // namespace valhalla
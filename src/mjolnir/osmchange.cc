@@ -0,0 +1,449 @@
+#include "mjolnir/osmchange.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <zlib.h>
+
+#include "baldr/graphtile.h"
+#include "baldr/tilehierarchy.h"
+#include "midgard/logging.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+bool ends_with(const std::string& value, const std::string& suffix) {
+  return value.size() >= suffix.size() &&
+         value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool is_space(int c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// hands out the characters of a file a buffer at a time. zlib reads a file that isnt gzip
+// compressed as it is, so .osc and .osc.gz files are read the same way
+class osc_input {
+public:
+  explicit osc_input(const std::string& file_name)
+      : file(gzopen(file_name.c_str(), "rb")), buffer(kBufferSize) {
+    if (file == nullptr) {
+      throw std::runtime_error("Failed to open " + file_name);
+    }
+    gzbuffer(file, kBufferSize);
+  }
+
+  ~osc_input() {
+    gzclose(file);
+  }
+
+  // the next character or EOF at the end of the file
+  int get() {
+    if (pos == end && !fill()) {
+      return EOF;
+    }
+    return static_cast<unsigned char>(buffer[pos++]);
+  }
+
+  // the next character without using it up
+  int peek() {
+    if (pos == end && !fill()) {
+      return EOF;
+    }
+    return static_cast<unsigned char>(buffer[pos]);
+  }
+
+private:
+  bool fill() {
+    int read = gzread(file, buffer.data(), kBufferSize);
+    if (read < 0) {
+      int error;
+      throw std::runtime_error(std::string("Failed to decompress: ") + gzerror(file, &error));
+    }
+    pos = 0;
+    end = static_cast<size_t>(read);
+    return end > 0;
+  }
+
+  static constexpr unsigned kBufferSize = 1 << 17;
+  gzFile file;
+  std::vector<char> buffer;
+  size_t pos = 0;
+  size_t end = 0;
+};
+
+// the start tag of an element, its attribute values are kept as they are in the file since only
+// numbers and names are looked at and they dont have entities in them
+struct element_t {
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> attributes;
+  bool empty = false;
+
+  // the value of an attribute or nullptr if the element doesnt have it
+  const std::string* attribute(const char* key) const {
+    for (const auto& attribute : attributes) {
+      if (attribute.first == key) {
+        return &attribute.second;
+      }
+    }
+    return nullptr;
+  }
+};
+
+// streams through the xml of an osmChange file one element at a time. only what an osmChange
+// holds is understood: elements, attributes, text, comments, cdata, processing instructions and a
+// doctype without an internal subset. unterminated or mismatched tags, unquoted values and a
+// missing or second root element throw
+class osc_parser {
+public:
+  explicit osc_parser(const std::string& file_name) : in(file_name) {
+  }
+
+  // reads up to the next start or end tag, returns false at the end of the document
+  bool next(element_t& element, bool& closing) {
+    while (true) {
+      int c = in.get();
+      while (c != '<' && c != EOF) {
+        c = in.get();
+      }
+      if (c == EOF) {
+        if (!open.empty() || !seen_root) {
+          throw std::runtime_error("Not a complete osmChange document");
+        }
+        return false;
+      }
+
+      c = in.get();
+      if (c == '?') {
+        skip_past("?>");
+      } else if (c == '!') {
+        if (in.peek() == '-') {
+          expect("--");
+          skip_past("-->");
+        } else if (in.peek() == '[') {
+          expect("[CDATA[");
+          skip_past("]]>");
+        } else {
+          skip_past(">");
+        }
+      } else if (c == '/') {
+        read_name(in.get(), element.name);
+        skip_spaces();
+        expect(">");
+        if (open.empty() || open.back() != element.name) {
+          throw std::runtime_error("Mismatched end tag </" + element.name + ">");
+        }
+        open.pop_back();
+        closing = true;
+        return true;
+      } else {
+        read_start(c, element);
+        closing = false;
+        return true;
+      }
+    }
+  }
+
+private:
+  static bool is_name(int c) {
+    return c != EOF && !is_space(c) && c != '/' && c != '>' && c != '=' && c != '<' &&
+           c != '"' && c != '\'';
+  }
+
+  void read_name(int c, std::string& name) {
+    if (!is_name(c)) {
+      throw std::runtime_error("Expected a name in a tag");
+    }
+    name.assign(1, static_cast<char>(c));
+    while (is_name(in.peek())) {
+      name.push_back(static_cast<char>(in.get()));
+    }
+  }
+
+  void read_start(int c, element_t& element) {
+    read_name(c, element.name);
+    if (open.empty()) {
+      if (seen_root) {
+        throw std::runtime_error("Found <" + element.name + "> after the end of the document");
+      }
+      if (element.name != "osmChange") {
+        throw std::runtime_error("Not an osmChange document, found <" + element.name + ">");
+      }
+      seen_root = true;
+    }
+
+    // reuse the strings of the last element rather than allocate new ones
+    size_t count = 0;
+    while (true) {
+      bool spaced = skip_spaces();
+      c = in.get();
+      if (c == EOF) {
+        throw std::runtime_error("Not a complete osmChange document");
+      }
+      if (c == '>' || c == '/') {
+        element.empty = c == '/';
+        if (element.empty) {
+          expect(">");
+        }
+        break;
+      }
+      if (!spaced) {
+        throw std::runtime_error("Expected a space before an attribute of <" + element.name + ">");
+      }
+      if (count == element.attributes.size()) {
+        element.attributes.emplace_back();
+      }
+      auto& attribute = element.attributes[count++];
+      read_name(c, attribute.first);
+      skip_spaces();
+      expect("=");
+      skip_spaces();
+      int quote = in.get();
+      if (quote != '"' && quote != '\'') {
+        throw std::runtime_error("Unquoted value of " + attribute.first + " in <" + element.name +
+                                 ">");
+      }
+      attribute.second.clear();
+      for (c = in.get(); c != quote; c = in.get()) {
+        if (c == EOF) {
+          throw std::runtime_error("Not a complete osmChange document");
+        }
+        if (c == '<') {
+          throw std::runtime_error("Bad value of " + attribute.first + " in <" + element.name +
+                                   ">");
+        }
+        attribute.second.push_back(static_cast<char>(c));
+      }
+    }
+    element.attributes.resize(count);
+    if (!element.empty) {
+      open.push_back(element.name);
+    }
+  }
+
+  bool skip_spaces() {
+    bool skipped = false;
+    while (is_space(in.peek())) {
+      in.get();
+      skipped = true;
+    }
+    return skipped;
+  }
+
+  void expect(const char* text) {
+    for (; *text; ++text) {
+      if (in.get() != *text) {
+        throw std::runtime_error(std::string("Expected ") + text);
+      }
+    }
+  }
+
+  // skips past the end of a comment, cdata or the like
+  void skip_past(const std::string& end) {
+    std::string last;
+    while (last != end) {
+      int c = in.get();
+      if (c == EOF) {
+        throw std::runtime_error("Not a complete osmChange document");
+      }
+      if (last.size() == end.size()) {
+        last.erase(0, 1);
+      }
+      last.push_back(static_cast<char>(c));
+    }
+  }
+
+  osc_input in;
+  std::vector<std::string> open;
+  bool seen_root = false;
+};
+
+uint64_t id_attribute(const element_t& element, const char* key) {
+  const std::string* value = element.attribute(key);
+  if (value == nullptr) {
+    throw std::runtime_error("Missing " + std::string(key) + " in <" + element.name + ">");
+  }
+  // ids of objects that are yet to be uploaded are negative, their magnitude is used
+  const char* begin = value->c_str() + (!value->empty() && value->front() == '-');
+  char* end = nullptr;
+  uint64_t id = std::strtoull(begin, &end, 10);
+  if (*begin < '0' || *begin > '9' || *end != '\0') {
+    throw std::runtime_error("Bad " + std::string(key) + " in <" + element.name + ">");
+  }
+  return id;
+}
+
+// a coordinate, missing ones make the point invalid
+double coordinate_attribute(const element_t& element, const char* key) {
+  const std::string* value = element.attribute(key);
+  if (value == nullptr) {
+    return INVALID_LL;
+  }
+  char* end = nullptr;
+  double coordinate = std::strtod(value->c_str(), &end);
+  if (value->empty() || *end != '\0' || !std::isfinite(coordinate)) {
+    throw std::runtime_error("Bad " + std::string(key) + " in <" + element.name + ">");
+  }
+  return coordinate;
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+OSMChange OSMChange::Read(const std::string& file_name) {
+  if (!ends_with(file_name, ".osc") && !ends_with(file_name, ".osc.gz")) {
+    throw std::runtime_error("Not an osmChange file, expected .osc or .osc.gz");
+  }
+
+  OSMChange change;
+  osc_parser parser(file_name);
+  element_t element;
+  bool closing = false;
+  // the way or relation whose nodes or members come next
+  std::vector<uint64_t>* way_nodes = nullptr;
+  bool in_relation = false;
+  // the elements are grouped by action in the file but what matters is only that they changed
+  while (parser.next(element, closing)) {
+    if (closing) {
+      way_nodes = element.name == "way" ? nullptr : way_nodes;
+      in_relation = element.name == "relation" ? false : in_relation;
+    } else if (element.name == "node") {
+      // deleted nodes usually dont have a location
+      change.nodes[id_attribute(element, "id")] =
+          PointLL(coordinate_attribute(element, "lon"), coordinate_attribute(element, "lat"));
+    } else if (element.name == "way") {
+      auto& nodes = change.ways[id_attribute(element, "id")];
+      nodes.clear();
+      way_nodes = element.empty ? nullptr : &nodes;
+    } else if (element.name == "nd" && way_nodes) {
+      way_nodes->push_back(id_attribute(element, "ref"));
+    } else if (element.name == "relation") {
+      in_relation = !element.empty;
+    } else if (element.name == "member" && in_relation) {
+      const std::string* type = element.attribute("type");
+      if (type && *type == "way") {
+        change.relation_ways.insert(id_attribute(element, "ref"));
+      }
+    }
+  }
+  return change;
+}
+
+ChangedTiles FindChangedTiles(GraphReader& reader, const OSMChange& change) {
+  // the local tile under a point
+  const auto& local_level = TileHierarchy::levels().back();
+  auto local_tile = [&local_level](const PointLL& ll) {
+    auto tile_id = ll.IsValid() ? local_level.tiles.TileId(ll) : -1;
+    return tile_id < 0 ? GraphId() : GraphId(tile_id, local_level.level, 0);
+  };
+
+  // the changed nodes land where they are now, where they were before cant be known from the
+  // tiles since they dont keep osm node ids but usually its close enough to be a neighbor
+  ChangedTiles changed_tiles;
+  for (const auto& node : change.nodes) {
+    auto tile_id = local_tile(node.second);
+    if (tile_id.Is_Valid()) {
+      changed_tiles.changed.insert(tile_id);
+    }
+  }
+
+  // go through every edge of every level, the edges of changed ways change their tiles and the
+  // rest tell us which local tiles are connected to which
+  std::unordered_set<uint64_t> found_ways;
+  std::set<std::pair<GraphId, GraphId>> links;
+  for (const auto& level : TileHierarchy::levels()) {
+    for (const auto& tile_id : reader.GetTileSet(level.level)) {
+      graph_tile_ptr tile = reader.GetGraphTile(tile_id);
+      if (!tile) {
+        continue;
+      }
+      graph_tile_ptr end_tile = tile;
+      PointLL base_ll = tile->header()->base_ll();
+      for (uint32_t i = 0; i < tile->header()->nodecount(); ++i) {
+        const NodeInfo* node = tile->node(i);
+        auto from = local_tile(node->latlng(base_ll));
+        for (uint32_t j = 0; j < node->edge_count(); ++j) {
+          const DirectedEdge* edge = tile->directededge(node->edge_index() + j);
+          // connections to transit stops are rebuilt with transit
+          if (edge->endnode().level() > local_level.level ||
+              !reader.GetGraphTile(edge->endnode(), end_tile)) {
+            continue;
+          }
+          const NodeInfo* end_node = end_tile->node(edge->endnode());
+          auto to = local_tile(end_node->latlng(end_tile->header()->base_ll()));
+          auto way_id = tile->edgeinfo(edge).wayid();
+          if (change.ways.count(way_id) || change.relation_ways.count(way_id)) {
+            changed_tiles.changed.insert(from);
+            changed_tiles.changed.insert(to);
+            found_ways.insert(way_id);
+          }
+          if (from != to) {
+            links.emplace(from, to);
+            links.emplace(to, from);
+          }
+        }
+      }
+
+      // Check if we need to clear the tile cache
+      if (reader.OverCommitted()) {
+        reader.Trim();
+      }
+    }
+  }
+
+  // tiles with edges into the changed ones
+  for (const auto& link : links) {
+    if (changed_tiles.changed.count(link.first) && !changed_tiles.changed.count(link.second)) {
+      changed_tiles.neighbors.insert(link.second);
+    }
+  }
+
+  // the tiles of the other levels that are over the local ones
+  for (const auto* local : {&changed_tiles.changed, &changed_tiles.neighbors}) {
+    for (const auto& tile_id : *local) {
+      auto center = local_level.tiles.Center(tile_id.tileid());
+      for (const auto& level : TileHierarchy::levels()) {
+        if (level.level != local_level.level) {
+          changed_tiles.parents.emplace(level.tiles.TileId(center), level.level, 0);
+        }
+      }
+    }
+  }
+
+  // ways that are neither in the tiles nor have any nodes with a location in the change
+  for (const auto& way : change.ways) {
+    if (found_ways.count(way.first)) {
+      continue;
+    }
+    bool located = false;
+    for (auto node_id : way.second) {
+      auto node = change.nodes.find(node_id);
+      if ((located = node != change.nodes.cend() && node->second.IsValid())) {
+        break;
+      }
+    }
+    changed_tiles.unlocated_ways += !located;
+  }
+
+  LOG_INFO("Change touches " + std::to_string(changed_tiles.changed.size()) + " local tiles, " +
+           std::to_string(changed_tiles.neighbors.size()) + " neighboring tiles and " +
+           std::to_string(changed_tiles.parents.size()) + " parent tiles");
+  if (changed_tiles.unlocated_ways) {
+    LOG_WARN(std::to_string(changed_tiles.unlocated_ways) +
+             " changed ways could not be located in the tiles");
+  }
+  return changed_tiles;
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -4,6 +4,7 @@
 
 #include "graph_lua_proc.h"
 #include "mjolnir/luatagtransform.h"
+#include "mjolnir/nativetagtransform.h"
 #include "mjolnir/osmaccess.h"
 #include "mjolnir/osmpronunciation.h"
 
@@ -150,7 +151,8 @@ public:
   }
 
   graph_callback(const boost::property_tree::ptree& pt, OSMData& osmdata)
-      : lua_(get_lua(pt)), osmdata_(osmdata) {
+      : lua_(get_lua(pt)), native_tags_(!pt.get_optional<std::string>("graph_lua_name")),
+        osmdata_(osmdata) {
     current_way_node_index_ = last_node_ = last_way_ = last_relation_ = 0;
 
     highway_cutoff_rc_ = RoadClass::kPrimary;
@@ -1416,7 +1418,7 @@ public:
     if (bss_nodes_) {
       // Get tags - do't bother with Lua callout if the taglist is empty
       if (tags.size() > 0) {
-        results = lua_.Transform(OSMType::kNode, osmid, tags);
+        results = transform(OSMType::kNode, osmid, tags);
       } else {
         results = empty_node_results_;
       }
@@ -1488,7 +1490,7 @@ public:
     // Get tags if not already available.  Don't bother calling Lua if there
     // are no OSM tags to process.
     if (tags.size() > 0) {
-      results = results ? results : lua_.Transform(OSMType::kNode, osmid, tags);
+      results = results ? results : transform(OSMType::kNode, osmid, tags);
     } else {
       results = results ? results : empty_node_results_;
     }
@@ -1683,8 +1685,7 @@ public:
 
     // Transform tags. If no results that means the way does not have tags
     // suitable for use in routing.
-    Tags results =
-        tags.size() == 0 ? empty_way_results_ : lua_.Transform(OSMType::kWay, osmid_, tags);
+    Tags results = tags.size() == 0 ? empty_way_results_ : transform(OSMType::kWay, osmid_, tags);
     if (results.size() == 0) {
       return;
     }
@@ -2178,7 +2179,7 @@ public:
 
     // Get tags
     Tags results =
-        tags.empty() ? empty_relation_results_ : lua_.Transform(OSMType::kRelation, osmid, tags);
+        tags.empty() ? empty_relation_results_ : transform(OSMType::kRelation, osmid, tags);
     if (results.size() == 0) {
       return;
     }
@@ -2615,6 +2616,12 @@ public:
     osmdata_.max_changeset_id_ = std::max(osmdata_.max_changeset_id_, changeset_id);
   }
 
+  // transforms the tags natively when the built in lua is in use, otherwise with the lua
+  Tags transform(OSMType type, uint64_t osmid, const Tags& tags) {
+    return native_tags_ ? NativeTagTransform::Transform(type, tags)
+                        : lua_.Transform(type, osmid, tags);
+  }
+
   // lets the sequences be set and reset
   void reset(sequence<OSMWay>* ways,
              sequence<OSMWayNode>* way_nodes,
@@ -2948,6 +2955,9 @@ public:
   // Lua Tag Transformation class
   LuaTagTransform lua_;
 
+  // Whether the built in lua is being used so that what it does natively can skip the lua
+  bool native_tags_;
+
   // Pointer to all the OSM data (for use by callbacks)
   OSMData& osmdata_;
 
@@ -2994,10 +3004,11 @@ OSMData PBFGraphParser::ParseWays(const boost::property_tree::ptree& pt,
                                   const std::string& pronunciation_file) {
   // TODO: option 1: each one threads makes an osmdata and we splice them together at the end
   // option 2: synchronize around adding things to a single osmdata. will have to test to see
-  // which is the least expensive (memory and speed). leaning towards option 2
-  //  unsigned int threads =
-  //      std::max(static_cast<unsigned int>(1),
-  //               pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
+  // which is the least expensive (memory and speed). leaning towards option 2. for now only the
+  // sorting of the intermediate files is done in parallel
+  unsigned int threads =
+      std::max(static_cast<unsigned int>(1),
+               pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
 
   // Create OSM data. Set the member pointer so that the parsing callback methods can use it.
   OSMData osmdata{};
@@ -3042,7 +3053,8 @@ OSMData PBFGraphParser::ParseWays(const boost::property_tree::ptree& pt,
   LOG_INFO("Sorting osm access tags by way id...");
   {
     sequence<OSMAccess> access(access_file, false);
-    access.sort([](const OSMAccess& a, const OSMAccess& b) { return a.way_id() < b.way_id(); });
+    access.sort([](const OSMAccess& a, const OSMAccess& b) { return a.way_id() < b.way_id(); },
+                access.kSortBufferSize, threads);
   }
 
   // we need to sort the pronunciation indexes so that we can easily find them.
@@ -3050,9 +3062,14 @@ OSMData PBFGraphParser::ParseWays(const boost::property_tree::ptree& pt,
   {
     sequence<OSMPronunciation> pronunciation(pronunciation_file, false);
     pronunciation.sort(
-        [](const OSMPronunciation& a, const OSMPronunciation& b) { return a.way_id() < b.way_id(); });
+        [](const OSMPronunciation& a, const OSMPronunciation& b) { return a.way_id() < b.way_id(); },
+        pronunciation.kSortBufferSize, threads);
   }
 
+  // sort the maps of osm data by way id so that the graph builder can search them
+  LOG_INFO("Sorting osm data by way id...");
+  osmdata.sort_maps();
+
   LOG_INFO("Finished");
 
   // Return OSM data
@@ -3067,10 +3084,11 @@ void PBFGraphParser::ParseRelations(const boost::property_tree::ptree& pt,
                                     OSMData& osmdata) {
   // TODO: option 1: each one threads makes an osmdata and we splice them together at the end
   // option 2: synchronize around adding things to a single osmdata. will have to test to see
-  // which is the least expensive (memory and speed). leaning towards option 2
-  //  unsigned int threads =
-  //      std::max(static_cast<unsigned int>(1),
-  //               pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
+  // which is the least expensive (memory and speed). leaning towards option 2. for now only the
+  // sorting of the intermediate files is done in parallel
+  unsigned int threads =
+      std::max(static_cast<unsigned int>(1),
+               pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
 
   // Create OSM data. Set the member pointer so that the parsing callback methods can use it.
   graph_callback callback(pt, osmdata);
@@ -3111,12 +3129,17 @@ void PBFGraphParser::ParseRelations(const boost::property_tree::ptree& pt,
 
   callback.reset(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
 
+  // sort the maps of osm data by way id so that the graph builder can search them
+  LOG_INFO("Sorting osm data by way id...");
+  osmdata.sort_maps();
+
   // Sort complex restrictions. Keep this scoped so the file handles are closed when done sorting.
   LOG_INFO("Sorting complex restrictions by from id...");
   {
     sequence<OSMRestriction> complex_restrictions_from(complex_restriction_from_file, false);
     complex_restrictions_from.sort(
-        [](const OSMRestriction& a, const OSMRestriction& b) { return a < b; });
+        [](const OSMRestriction& a, const OSMRestriction& b) { return a < b; },
+        complex_restrictions_from.kSortBufferSize, threads);
   }
 
   // Sort complex restrictions. Keep this scoped so the file handles are closed when done sorting.
@@ -3124,7 +3147,8 @@ void PBFGraphParser::ParseRelations(const boost::property_tree::ptree& pt,
   {
     sequence<OSMRestriction> complex_restrictions_to(complex_restriction_to_file, false);
     complex_restrictions_to.sort(
-        [](const OSMRestriction& a, const OSMRestriction& b) { return a < b; });
+        [](const OSMRestriction& a, const OSMRestriction& b) { return a < b; },
+        complex_restrictions_to.kSortBufferSize, threads);
   }
   LOG_INFO("Finished");
 }
@@ -3136,10 +3160,11 @@ void PBFGraphParser::ParseNodes(const boost::property_tree::ptree& pt,
                                 OSMData& osmdata) {
   // TODO: option 1: each one threads makes an osmdata and we splice them together at the end
   // option 2: synchronize around adding things to a single osmdata. will have to test to see
-  // which is the least expensive (memory and speed). leaning towards option 2
-  //  unsigned int threads =
-  //      std::max(static_cast<unsigned int>(1),
-  //               pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
+  // which is the least expensive (memory and speed). leaning towards option 2. for now only the
+  // sorting of the intermediate files is done in parallel
+  unsigned int threads =
+      std::max(static_cast<unsigned int>(1),
+               pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
 
   // Create OSM data. Set the member pointer so that the parsing callback methods can use it.
   graph_callback callback(pt, osmdata);
@@ -3188,7 +3213,8 @@ void PBFGraphParser::ParseNodes(const boost::property_tree::ptree& pt,
   {
     sequence<OSMWayNode> way_nodes(way_nodes_file, false);
     way_nodes.sort(
-        [](const OSMWayNode& a, const OSMWayNode& b) { return a.node.osmid_ < b.node.osmid_; });
+        [](const OSMWayNode& a, const OSMWayNode& b) { return a.node.osmid_ < b.node.osmid_; },
+        way_nodes.kSortBufferSize, threads);
   }
 
   // Parse node in all the input files. Skip any that are not marked from
@@ -3217,13 +3243,15 @@ void PBFGraphParser::ParseNodes(const boost::property_tree::ptree& pt,
   LOG_INFO("Sorting osm way node references by way index and node shape index...");
   {
     sequence<OSMWayNode> way_nodes(way_nodes_file, false);
-    way_nodes.sort([](const OSMWayNode& a, const OSMWayNode& b) {
-      if (a.way_index == b.way_index) {
-        // TODO: if its equal we have screwed something up, should we check and throw here?
-        return a.way_shape_node_index < b.way_shape_node_index;
-      }
-      return a.way_index < b.way_index;
-    });
+    way_nodes.sort(
+        [](const OSMWayNode& a, const OSMWayNode& b) {
+          if (a.way_index == b.way_index) {
+            // TODO: if its equal we have screwed something up, should we check and throw here?
+            return a.way_shape_node_index < b.way_shape_node_index;
+          }
+          return a.way_index < b.way_index;
+        },
+        way_nodes.kSortBufferSize, threads);
   }
 
   // Some OSM extracts do not have changeset Ids. For these set the max changeset Id
@@ -0,0 +1,202 @@
+#include "mjolnir/predictedtraffic.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "baldr/nodeinfo.h"
+#include "baldr/nodetransition.h"
+#include "filesystem.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+// an unsigned number, spaces before it are fine and an empty one is zero
+bool parse_number(const char*& begin, const char* end, uint32_t max, uint32_t& number) {
+  while (begin != end && *begin == ' ') {
+    ++begin;
+  }
+  uint64_t value = 0;
+  for (; begin != end && *begin >= '0' && *begin <= '9'; ++begin) {
+    value = value * 10 + (*begin - '0');
+    if (value > max) {
+      return false;
+    }
+  }
+  number = value;
+  return true;
+}
+
+// a speed field
+bool parse_speed(const char* begin, const char* end, uint8_t& speed) {
+  uint32_t value = 0;
+  if (!parse_number(begin, end, 255, value) || begin != end) {
+    return false;
+  }
+  speed = value;
+  return true;
+}
+
+// level/tileid/id
+bool parse_graph_id(const char* begin, const char* end, GraphId& graph_id) {
+  uint32_t level, tile_id, id;
+  auto start = begin;
+  if (!parse_number(begin, end, kMaxGraphHierarchy, level) || begin == start || begin == end ||
+      *begin++ != '/') {
+    return false;
+  }
+  start = begin;
+  if (!parse_number(begin, end, kMaxGraphTileId, tile_id) || begin == start || begin == end ||
+      *begin++ != '/') {
+    return false;
+  }
+  start = begin;
+  if (!parse_number(begin, end, kMaxGraphId, id) || begin == start || begin != end) {
+    return false;
+  }
+  graph_id = GraphId(tile_id, level, id);
+  return true;
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+TrafficRow::Field TrafficRow::Parse(const char* begin, const char* end) {
+  // a windows line ending
+  if (begin != end && *(end - 1) == '\r') {
+    --end;
+  }
+
+  free_flow_speed = constrained_flow_speed = 0;
+  has_coefficients = false;
+  field_count = 0;
+  for (uint8_t field = kEdgeId; field < kFieldCount; ++field) {
+    auto field_end = static_cast<const char*>(std::memchr(begin, ',', end - begin));
+    field_end = field_end ? field_end : end;
+    ++field_count;
+
+    bool parsed = false;
+    switch (field) {
+      case kEdgeId:
+        parsed = parse_graph_id(begin, field_end, edge_id);
+        break;
+      case kFreeFlowSpeed:
+        parsed = parse_speed(begin, field_end, free_flow_speed);
+        break;
+      case kConstrainedFlowSpeed:
+        parsed = parse_speed(begin, field_end, constrained_flow_speed);
+        break;
+      case kCompressedSpeeds:
+        has_coefficients = begin != field_end;
+        parsed = !has_coefficients ||
+                 baldr::decode_compressed_speeds(begin, field_end - begin, coefficients.data());
+        break;
+    }
+    if (!parsed) {
+      return static_cast<Field>(field);
+    }
+
+    if (field_end == end) {
+      break;
+    }
+    begin = field_end + 1;
+  }
+  return kFieldCount;
+}
+
+void TileSpeedsUpdater::Open(const std::string& tile_path) {
+  std::ifstream file(tile_path, std::ios::in | std::ios::binary);
+  if (!file.read(reinterpret_cast<char*>(&header_), sizeof(GraphTileHeader))) {
+    throw std::runtime_error("Could not read the header of " + tile_path);
+  }
+
+  // the directed edges come right after the nodes and their transitions
+  tile_path_ = tile_path;
+  edges_offset_ = sizeof(GraphTileHeader) + header_.nodecount() * sizeof(NodeInfo) +
+                  header_.transitioncount() * sizeof(NodeTransition);
+  edges_.resize(header_.directededgecount());
+  file.seekg(edges_offset_);
+  if (!file.read(reinterpret_cast<char*>(edges_.data()), edges_.size() * sizeof(DirectedEdge))) {
+    throw std::runtime_error("Could not read the directed edges of " + tile_path);
+  }
+
+  // whatever predicted speeds the tile had are replaced by the ones we add
+  for (auto& edge : edges_) {
+    edge.set_has_predicted_speed(false);
+  }
+  updated_.assign(edges_.size(), false);
+  updated_count_ = 0;
+  profile_offsets_.clear();
+  profiles_.clear();
+}
+
+bool TileSpeedsUpdater::Update(uint32_t edge_index, const TrafficRow& row) {
+  if (updated_[edge_index]) {
+    return false;
+  }
+  updated_[edge_index] = true;
+  ++updated_count_;
+
+  auto& edge = edges_[edge_index];
+  if (row.constrained_flow_speed) {
+    edge.set_constrained_flow_speed(row.constrained_flow_speed);
+  }
+  if (row.free_flow_speed) {
+    edge.set_free_flow_speed(row.free_flow_speed);
+  }
+  if (row.has_coefficients) {
+    // edges without a profile point at the first one, their flag says not to look
+    if (profile_offsets_.empty()) {
+      profile_offsets_.assign(edges_.size(), 0);
+    }
+    profile_offsets_[edge_index] = profiles_.size();
+    profiles_.insert(profiles_.end(), row.coefficients.begin(), row.coefficients.end());
+    edge.set_has_predicted_speed(true);
+  }
+  return true;
+}
+
+uint32_t TileSpeedsUpdater::Write() {
+  // the predicted speeds are the last thing in a tile, new ones go over the old ones if there are
+  size_t old_end = header_.end_offset();
+  size_t offset = old_end;
+  if (header_.predictedspeeds_count() > 0) {
+    offset = header_.predictedspeeds_offset();
+    auto old_size = edges_.size() * sizeof(uint32_t) +
+                    header_.predictedspeeds_count() * kCoefficientCount * sizeof(int16_t);
+    if (offset + old_size != old_end) {
+      throw std::runtime_error("Predicted speeds are not at the end of " + tile_path_);
+    }
+  }
+  header_.set_predictedspeeds_offset(offset);
+  header_.set_predictedspeeds_count(profiles_.size() / kCoefficientCount);
+  header_.set_end_offset(offset + profile_offsets_.size() * sizeof(uint32_t) +
+                         profiles_.size() * sizeof(int16_t));
+
+  {
+    std::fstream file(tile_path_, std::ios::in | std::ios::out | std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&header_), sizeof(GraphTileHeader));
+    file.seekp(edges_offset_);
+    file.write(reinterpret_cast<const char*>(edges_.data()), edges_.size() * sizeof(DirectedEdge));
+    file.seekp(offset);
+    file.write(reinterpret_cast<const char*>(profile_offsets_.data()),
+               profile_offsets_.size() * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(profiles_.data()), profiles_.size() * sizeof(int16_t));
+    if (!file) {
+      throw std::runtime_error("Could not write the speeds to " + tile_path_);
+    }
+  }
+
+  // there were more predicted speeds before
+  if (header_.end_offset() < old_end) {
+    filesystem::resize_file(tile_path_, header_.end_offset());
+  }
+  return updated_count_;
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -0,0 +1,144 @@
+#include "mjolnir/reachbuilder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "baldr/edgereach.h"
+#include "baldr/graphreader.h"
+#include "baldr/graphtile.h"
+#include "baldr/tilehierarchy.h"
+#include "filesystem.h"
+#include "loki/reach.h"
+#include "midgard/logging.h"
+#include "sif/costfactory.h"
+
+using namespace valhalla::baldr;
+
+namespace {
+
+// the reach of each direction has to fit in a byte
+constexpr uint32_t kMaxReach = 255;
+
+// computes the reach of all of the edges in the tiles handed out by the shared index
+void compute(const boost::property_tree::ptree& pt,
+             const std::vector<EdgeReach::tile_t>& tiles,
+             uint64_t edge_count,
+             uint32_t max_reach,
+             std::atomic<size_t>& next_tile,
+             std::vector<EdgeReach::reach_t>& reach) {
+  GraphReader reader(pt.get_child("mjolnir"));
+  valhalla::loki::Reach reach_finder;
+  std::vector<valhalla::sif::cost_ptr_t> costings;
+  valhalla::sif::CostFactory factory;
+  for (auto type : valhalla::loki::kPrecomputedReachCostings) {
+    costings.push_back(factory.Create(valhalla::loki::default_costing(type)));
+  }
+
+  for (auto index = next_tile++; index < tiles.size(); index = next_tile++) {
+    // hold on to the tile so that its edges stay put while we expand from them
+    auto tile = reader.GetGraphTile(GraphId(tiles[index].tile_id));
+    for (GraphId edge_id = tile->header()->graphid();
+         edge_id.id() < tile->header()->directededgecount(); ++edge_id) {
+      // loki never considers shortcuts or transit lines as candidates
+      const auto* edge = tile->directededge(edge_id);
+      if (edge->is_shortcut() || edge->IsTransitLine()) {
+        continue;
+      }
+      for (size_t mode = 0; mode < costings.size(); ++mode) {
+        auto found = reach_finder(edge, edge_id, max_reach, reader, costings[mode]);
+        auto& edge_reach = reach[mode * edge_count + tiles[index].edge_offset + edge_id.id()];
+        edge_reach.outbound = found.outbound;
+        edge_reach.inbound = found.inbound;
+      }
+    }
+
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+  }
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+void ReachBuilder::Build(const boost::property_tree::ptree& pt) {
+  auto tile_dir = pt.get<std::string>("mjolnir.tile_dir");
+  auto file_name = tile_dir + filesystem::path::preferred_separator + EdgeReach::kFileName;
+  auto max_reach =
+      std::min(pt.get<uint32_t>("service_limits.max_reachability", 100), kMaxReach);
+
+  // lay out the edges of all the tiles, transit edges arent candidates for any of the modes
+  std::vector<EdgeReach::tile_t> tiles;
+  uint64_t edge_count = 0;
+  {
+    GraphReader reader(pt.get_child("mjolnir"));
+    for (const auto& tile_id : reader.GetTileSet()) {
+      if (tile_id.level() != TileHierarchy::GetTransitLevel().level) {
+        tiles.push_back({tile_id.value, 0});
+      }
+    }
+    std::sort(tiles.begin(), tiles.end(),
+              [](const EdgeReach::tile_t& a, const EdgeReach::tile_t& b) {
+                return a.tile_id < b.tile_id;
+              });
+    for (auto& tile : tiles) {
+      tile.edge_offset = edge_count;
+      edge_count += reader.GetGraphTile(GraphId(tile.tile_id))->header()->directededgecount();
+      if (reader.OverCommitted()) {
+        reader.Trim();
+      }
+    }
+  }
+  LOG_INFO("Computing reach of " + std::to_string(edge_count) + " edges in " +
+           std::to_string(tiles.size()) + " tiles up to " + std::to_string(max_reach));
+
+  // each thread takes the next tile until there are none left
+  std::vector<EdgeReach::reach_t> reach(edge_count * ComponentLabels::kModeCount, {0, 0});
+  std::atomic<size_t> next_tile(0);
+  std::vector<std::thread> threads(
+      std::max(1u, pt.get<unsigned int>("mjolnir.concurrency",
+                                        std::thread::hardware_concurrency())));
+  for (auto& thread : threads) {
+    thread = std::thread(compute, std::cref(pt), std::cref(tiles), edge_count, max_reach,
+                         std::ref(next_tile), std::ref(reach));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // write it out next to the tiles, going through a temporary file so that nobody reads half of it
+  EdgeReach::header_t header{};
+  header.magic = EdgeReach::kMagic;
+  header.version = EdgeReach::kVersion;
+  header.mode_count = ComponentLabels::kModeCount;
+  header.max_reach = max_reach;
+  header.tile_count = tiles.size();
+  header.edge_count = edge_count;
+  auto temp_name = file_name + ".tmp";
+  {
+    std::ofstream file(temp_name, std::ios::binary | std::ios::out | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(tiles.data()),
+               tiles.size() * sizeof(EdgeReach::tile_t));
+    file.write(reinterpret_cast<const char*>(reach.data()),
+               reach.size() * sizeof(EdgeReach::reach_t));
+    if (!file) {
+      throw std::runtime_error("Failed to write " + temp_name);
+    }
+  }
+  if (std::rename(temp_name.c_str(), file_name.c_str()) != 0) {
+    throw std::runtime_error("Failed to move " + temp_name + " to " + file_name);
+  }
+  LOG_INFO("Wrote edge reach to " + file_name);
+}
+
+} // namespace mjolnir
+} // namespace valhalla
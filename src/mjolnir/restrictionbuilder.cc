@@ -3,8 +3,11 @@
 #include "mjolnir/dataquality.h"
 #include "mjolnir/graphtilebuilder.h"
 #include "mjolnir/osmrestriction.h"
+#include "mjolnir/tilescheduler.h"
 
+#include <chrono>
 #include <future>
+#include <numeric>
 #include <queue>
 #include <set>
 #include <thread>
@@ -320,29 +323,236 @@ void HandleOnlyRestrictionProperties(const std::vector<Result>& results,
   }
 }
 
+// The complex restrictions of a level joined up front with the ways of its tiles. The restrictions
+// of a tile are contiguous, tiles are in sorted order and within a tile they are sorted by from way
+struct LevelRestrictions {
+  std::vector<GraphId> tiles;
+  std::vector<OSMRestriction> from;
+  std::vector<size_t> from_offsets;
+  std::vector<OSMRestriction> to;
+  std::vector<size_t> to_offsets;
+};
+
+// Finds the complex restrictions that start from a way. Either searches the whole restriction file
+// for every way or only the restrictions joined up front for the current tile
+class RestrictionLookup {
+public:
+  explicit RestrictionLookup(const std::string& file)
+      : restrictions_(new sequence<OSMRestriction>(file, false)) {
+  }
+
+  RestrictionLookup(const std::vector<GraphId>& tiles,
+                    const std::vector<OSMRestriction>& joined,
+                    const std::vector<size_t>& offsets)
+      : tiles_(&tiles), joined_(&joined), offsets_(&offsets) {
+  }
+
+  void set_tile(const GraphId& tile_id) {
+    if (!joined_) {
+      return;
+    }
+    auto index = std::lower_bound(tiles_->begin(), tiles_->end(), tile_id) - tiles_->begin();
+    begin_ = joined_->data() + (*offsets_)[index];
+    end_ = joined_->data() + (*offsets_)[index + 1];
+  }
+
+  std::vector<OSMRestriction> operator()(uint64_t way_id) const {
+    auto by_from = [](const OSMRestriction& a, const OSMRestriction& b) {
+      return a.from() < b.from();
+    };
+    OSMRestriction target{way_id};
+    std::vector<OSMRestriction> found;
+    if (restrictions_) {
+      for (auto it = restrictions_->find(target, by_from); it != restrictions_->end(); ++it) {
+        OSMRestriction restriction = *it;
+        if (restriction.from() != way_id) {
+          break;
+        }
+        found.push_back(restriction);
+      }
+    } else {
+      auto range = std::equal_range(begin_, end_, target, by_from);
+      found.assign(range.first, range.second);
+    }
+    return found;
+  }
+
+protected:
+  std::unique_ptr<sequence<OSMRestriction>> restrictions_;
+  const std::vector<GraphId>* tiles_ = nullptr;
+  const std::vector<OSMRestriction>* joined_ = nullptr;
+  const std::vector<size_t>* offsets_ = nullptr;
+  const OSMRestriction* begin_ = nullptr;
+  const OSMRestriction* end_ = nullptr;
+};
+
+// A way id and the index of a tile in which one of its edges starts or ends a complex restriction
+using TileWay = std::pair<uint64_t, uint32_t>;
+
+struct RestrictedWays {
+  std::vector<TileWay> starting;
+  std::vector<TileWay> ending;
+};
+
+void find_restricted_ways(const boost::property_tree::ptree& hierarchy_properties,
+                          const std::vector<GraphId>& tiles,
+                          TileScheduler& scheduler,
+                          unsigned int worker,
+                          std::mutex& lock,
+                          std::promise<RestrictedWays>& result) {
+  GraphReader reader(hierarchy_properties);
+  RestrictedWays ways;
+
+  GraphId tile_id;
+  while (scheduler.Next(worker, tile_id)) {
+    lock.lock();
+    graph_tile_ptr tile = reader.GetGraphTile(tile_id);
+    lock.unlock();
+    if (!tile) {
+      continue;
+    }
+
+    // the same edges build() looks restrictions up for
+    uint32_t index = std::lower_bound(tiles.begin(), tiles.end(), tile_id) - tiles.begin();
+    for (const auto& edge : tile->GetDirectedEdges()) {
+      if ((!edge.start_restriction() && !edge.end_restriction()) || edge.IsTransitLine() ||
+          edge.is_shortcut() || edge.use() == Use::kTransitConnection ||
+          edge.use() == Use::kEgressConnection || edge.use() == Use::kPlatformConnection) {
+        continue;
+      }
+      auto way_id = tile->edgeinfo(&edge).wayid();
+      if (edge.start_restriction()) {
+        ways.starting.emplace_back(way_id, index);
+      }
+      if (edge.end_restriction()) {
+        ways.ending.emplace_back(way_id, index);
+      }
+    }
+
+    lock.lock();
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+    lock.unlock();
+  }
+
+  result.set_value(std::move(ways));
+}
+
+// Joins the ways with the restrictions that start from them in a single pass over the sorted
+// restriction file. Returns the restrictions grouped by tile and their offsets per tile
+std::pair<std::vector<OSMRestriction>, std::vector<size_t>>
+JoinRestrictions(const std::string& file, std::vector<TileWay>& ways, size_t tile_count) {
+  std::sort(ways.begin(), ways.end());
+  ways.erase(std::unique(ways.begin(), ways.end()), ways.end());
+
+  // the matches come out in from way order
+  std::vector<std::pair<uint32_t, OSMRestriction>> matches;
+  sequence<OSMRestriction> restrictions(file, false);
+  auto way = ways.cbegin();
+  for (auto it = restrictions.begin(); it != restrictions.end() && way != ways.cend(); ++it) {
+    OSMRestriction restriction = *it;
+    while (way != ways.cend() && way->first < restriction.from()) {
+      ++way;
+    }
+    for (auto match = way; match != ways.cend() && match->first == restriction.from(); ++match) {
+      matches.emplace_back(match->second, restriction);
+    }
+  }
+
+  // group them by tile keeping that order within each
+  std::pair<std::vector<OSMRestriction>, std::vector<size_t>> joined;
+  auto& offsets = joined.second;
+  offsets.resize(tile_count + 1, 0);
+  for (const auto& match : matches) {
+    ++offsets[match.first + 1];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  auto next = offsets;
+  joined.first.resize(matches.size());
+  for (const auto& match : matches) {
+    joined.first[next[match.first]++] = match.second;
+  }
+  return joined;
+}
+
+// Finds the ways that start or end restrictions in each tile of the level and joins them with the
+// restriction files, so the workers never have to search the files
+std::unique_ptr<LevelRestrictions> JoinLevelRestrictions(const std::string& complex_from_file,
+                                                         const std::string& complex_to_file,
+                                                         const boost::property_tree::ptree& config,
+                                                         std::vector<GraphId> tiles,
+                                                         const std::string& tile_dir,
+                                                         uint8_t level,
+                                                         size_t thread_count) {
+  std::unique_ptr<LevelRestrictions> joined(new LevelRestrictions);
+  joined->tiles = std::move(tiles);
+  std::sort(joined->tiles.begin(), joined->tiles.end());
+
+  TileScheduler scheduler("Finding restricted ways at level " + std::to_string(level), tile_dir,
+                          joined->tiles, thread_count);
+  std::mutex lock;
+  std::vector<std::promise<RestrictedWays>> promises(thread_count);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.emplace_back(find_restricted_ways, std::cref(config), std::cref(joined->tiles),
+                         std::ref(scheduler), i, std::ref(lock), std::ref(promises[i]));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  scheduler.LogStats();
+
+  RestrictedWays ways;
+  for (auto& p : promises) {
+    auto found = p.get_future().get();
+    ways.starting.insert(ways.starting.end(), found.starting.begin(), found.starting.end());
+    ways.ending.insert(ways.ending.end(), found.ending.begin(), found.ending.end());
+  }
+
+  // the ways ending restrictions look up the restrictions starting from the other end as well
+  auto to = JoinRestrictions(complex_to_file, ways.ending, joined->tiles.size());
+  joined->to = std::move(to.first);
+  joined->to_offsets = std::move(to.second);
+  for (size_t tile = 0; tile < joined->tiles.size(); ++tile) {
+    for (size_t i = joined->to_offsets[tile]; i < joined->to_offsets[tile + 1]; ++i) {
+      ways.starting.emplace_back(joined->to[i].to(), tile);
+    }
+  }
+  auto from = JoinRestrictions(complex_from_file, ways.starting, joined->tiles.size());
+  joined->from = std::move(from.first);
+  joined->from_offsets = std::move(from.second);
+
+  LOG_INFO("Joined " + std::to_string(joined->from.size()) + " from and " +
+           std::to_string(joined->to.size()) + " to restrictions with the tiles at level " +
+           std::to_string(level));
+  return joined;
+}
+
 void build(const std::string& complex_restriction_from_file,
            const std::string& complex_restriction_to_file,
            const boost::property_tree::ptree& hierarchy_properties,
-           std::queue<GraphId>& tilequeue,
+           const LevelRestrictions* joined,
+           TileScheduler& scheduler,
+           unsigned int worker,
            std::mutex& lock,
            std::promise<Result>& result) {
-  sequence<OSMRestriction> complex_restrictions_from(complex_restriction_from_file, false);
-  sequence<OSMRestriction> complex_restrictions_to(complex_restriction_to_file, false);
+  // without the restrictions joined up front the files are searched for each restricted edge
+  RestrictionLookup restrictions_from =
+      joined ? RestrictionLookup(joined->tiles, joined->from, joined->from_offsets)
+             : RestrictionLookup(complex_restriction_from_file);
+  RestrictionLookup restrictions_to =
+      joined ? RestrictionLookup(joined->tiles, joined->to, joined->to_offsets)
+             : RestrictionLookup(complex_restriction_to_file);
 
   GraphReader reader(hierarchy_properties);
   Result stats;
 
-  // Iterate through the tiles in the queue and perform enhancements
-  while (true) {
-    // Get the next tile Id from the queue and get writeable and readable
-    // tile. Lock while we access the tile queue and get the tile.
+  // Iterate through the tiles we are given and perform enhancements
+  GraphId tile_id;
+  while (scheduler.Next(worker, tile_id)) {
+    // Get writeable and readable tile. Lock while we get the tile.
     lock.lock();
-    if (tilequeue.empty()) {
-      lock.unlock();
-      break;
-    }
-    GraphId tile_id = tilequeue.front();
-    tilequeue.pop();
 
     // Get a readable tile. If the tile is empty, skip it. Empty tiles are
     // added where ways go through a tile but no end not is within the tile.
@@ -356,6 +566,8 @@ void build(const std::string& complex_restriction_from_file,
     // Tile builder - serialize in existing tile
     GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, true);
     lock.unlock();
+    restrictions_from.set_tile(tile_id);
+    restrictions_to.set_tile(tile_id);
 
     std::unordered_multimap<GraphId, ComplexRestrictionBuilder> forward_tmp_cr;
     std::unordered_multimap<GraphId, ComplexRestrictionBuilder> reverse_tmp_cr;
@@ -394,15 +606,8 @@ void build(const std::string& complex_restriction_from_file,
         // other hierarchy levels as needed at endnodes.
 
         if (directededge.start_restriction()) {
-          OSMRestriction target_res{edge_info.wayid()}; // this is our from way id
-          sequence<OSMRestriction>::iterator res_it =
-              complex_restrictions_from.find(target_res,
-                                             [](const OSMRestriction& a, const OSMRestriction& b) {
-                                               return a.from() < b.from();
-                                             });
-          OSMRestriction restriction{};
-          while (res_it != complex_restrictions_from.end() &&
-                 (restriction = *res_it).from() == edge_info.wayid()) {
+          // this is our from way id
+          for (const auto& restriction : restrictions_from(edge_info.wayid())) {
             GraphId currentNode = directededge.endnode();
 
             std::vector<uint64_t> res_way_ids;
@@ -535,32 +740,14 @@ void build(const std::string& complex_restriction_from_file,
                 }
               }
             }
-            ++res_it;
           }
         }
 
         if (directededge.end_restriction()) {
-          OSMRestriction target_to_res{edge_info.wayid()}; // this is our from way id
-          sequence<OSMRestriction>::iterator res_to_it =
-              complex_restrictions_to.find(target_to_res,
-                                           [](const OSMRestriction& a, const OSMRestriction& b) {
-                                             return a.from() < b.from();
-                                           });
-          OSMRestriction restriction_to{};
           // is this edge the end of a restriction?
-          while (res_to_it != complex_restrictions_to.end() &&
-                 (restriction_to = *res_to_it).from() == edge_info.wayid()) {
-
-            OSMRestriction target_res{restriction_to.to()}; // this is our from way id
-            OSMRestriction restriction{};
-            sequence<OSMRestriction>::iterator res_it =
-                complex_restrictions_from.find(target_res,
-                                               [](const OSMRestriction& a, const OSMRestriction& b) {
-                                                 return a.from() < b.from();
-                                               });
-            while (res_it != complex_restrictions_from.end() &&
-                   (restriction = *res_it).from() == restriction_to.to()) {
-
+          for (const auto& restriction_to : restrictions_to(edge_info.wayid())) {
+            // this is our from way id
+            for (const auto& restriction : restrictions_from(restriction_to.to())) {
               GraphId currentNode = directededge.endnode();
 
               std::vector<uint64_t> res_way_ids;
@@ -693,9 +880,7 @@ void build(const std::string& complex_restriction_from_file,
                   }
                 }
               }
-              ++res_it;
             }
-            res_to_it++;
           }
         }
       }
@@ -730,24 +915,32 @@ void RestrictionBuilder::Build(const boost::property_tree::ptree& pt,
 
   boost::property_tree::ptree hierarchy_properties = pt.get_child("mjolnir");
   GraphReader reader(hierarchy_properties);
+  bool sorted = pt.get<bool>("mjolnir.sorted_restrictions", false);
   for (auto tl = TileHierarchy::levels().rbegin(); tl != TileHierarchy::levels().rend(); ++tl) {
-    // Create a randomized queue of tiles to work from
-    std::deque<GraphId> tempqueue;
-    auto level_tiles = reader.GetTileSet(tl->level);
-    for (const auto& tile_id : level_tiles) {
-      tempqueue.emplace_back(tile_id);
-    }
-    std::random_device rd;
-    std::shuffle(tempqueue.begin(), tempqueue.end(), std::mt19937(rd()));
-    std::queue<GraphId> tilequeue(tempqueue);
+    auto start = std::chrono::steady_clock::now();
 
-    // An atomic object we can use to do the synchronization
-    std::mutex lock;
     // A place to hold worker threads and their results, exceptions or otherwise
-
     std::vector<std::shared_ptr<std::thread>> threads(
         std::max(static_cast<unsigned int>(1),
                  pt.get<unsigned int>("mjolnir.concurrency", std::thread::hardware_concurrency())));
+
+    // Join the restrictions with the tiles in a sequential pass over the files, otherwise every
+    // restricted edge searches them
+    auto level_tiles = reader.GetTileSet(tl->level);
+    std::vector<GraphId> tiles(level_tiles.begin(), level_tiles.end());
+    std::unique_ptr<LevelRestrictions> joined;
+    if (sorted) {
+      joined = JoinLevelRestrictions(complex_from_restrictions_file, complex_to_restrictions_file,
+                                     hierarchy_properties, tiles, reader.tile_dir(), tl->level,
+                                     threads.size());
+    }
+
+    // Schedule the tiles of this level, biggest first
+    TileScheduler scheduler("Adding restrictions at level " + std::to_string(tl->level),
+                            reader.tile_dir(), tiles, threads.size());
+
+    // An atomic object we can use to do the synchronization
+    std::mutex lock;
     // Hold the results (DataQuality/stats) for the threads
     std::vector<std::promise<Result>> promises(threads.size());
 
@@ -756,14 +949,16 @@ void RestrictionBuilder::Build(const boost::property_tree::ptree& pt,
     for (size_t i = 0; i < threads.size(); ++i) {
       threads[i].reset(new std::thread(build, std::cref(complex_from_restrictions_file),
                                        std::cref(complex_to_restrictions_file),
-                                       std::cref(hierarchy_properties), std::ref(tilequeue),
-                                       std::ref(lock), std::ref(promises[i])));
+                                       std::cref(hierarchy_properties), joined.get(),
+                                       std::ref(scheduler), i, std::ref(lock),
+                                       std::ref(promises[i])));
     }
 
     // Wait for them to finish up their work
     for (auto& thread : threads) {
       thread->join();
     }
+    scheduler.LogStats();
 
     std::vector<Result> results;
     for (auto& p : promises) {
@@ -787,6 +982,10 @@ void RestrictionBuilder::Build(const boost::property_tree::ptree& pt,
     }
     LOG_INFO("--Forward restrictions added: " + std::to_string(forward_restrictions_count));
     LOG_INFO("--Reverse restrictions added: " + std::to_string(reverse_restrictions_count));
+    LOG_INFO("Adding restrictions at level " + std::to_string(tl->level) + " took " +
+             std::to_string(
+                 std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()) +
+             "s");
   }
   LOG_INFO("Finished");
 }
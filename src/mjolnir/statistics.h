@@ -278,7 +278,20 @@ public:
 
   void add(const statistics& stats);
 
-  void build_db();
+  /**
+   * Write the statistics as a spatialite database with a table per kind of statistic.
+   * @param  database  the database file, replaced if it is there
+   */
+  void build_db(const std::string& database = "statistics.sqlite");
+
+  /**
+   * Write the same tables as build_db does to a directory of column files, <table>.columns, one
+   * thread per table. Each file holds its columns as flat arrays that can be memory mapped, which
+   * is a lot quicker to write than inserting the rows into sqlite. The tile geometries are the
+   * minx, miny, maxx and maxy columns rather than a polygon. Throws if a table cant be written.
+   * @param  dir  the directory to write the tables to
+   */
+  void build_columns(const std::string& dir) const;
 
 private:
   void create_tile_tables(sqlite3* db_handle);
@@ -0,0 +1,379 @@
+#include "statistics.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <stdexcept>
+
+#include "filesystem.h"
+#include "midgard/logging.h"
+
+using namespace valhalla::midgard;
+using namespace valhalla::baldr;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+// the start of every table file
+constexpr char kColumnsMagic[8] = {'V', 'S', 'T', 'A', 'T', 'C', 'O', 'L'};
+constexpr uint32_t kColumnsVersion = 1;
+constexpr size_t kColumnNameSize = 40;
+
+enum class ColumnType : uint32_t { kUInt64 = 0, kFloat = 1, kString = 2 };
+
+// what the file says about each column
+struct ColumnHeader {
+  char name[kColumnNameSize];
+  uint32_t type;
+  uint32_t reserved;
+  uint64_t offset;
+  uint64_t size;
+};
+static_assert(sizeof(ColumnHeader) == 64, "Column headers must stay 64 bytes");
+
+// columns are 8 byte aligned within the file so they can be used straight from a memory map
+uint64_t aligned(uint64_t offset) {
+  return (offset + 7) & ~uint64_t(7);
+}
+
+/**
+ * A table that is put together column by column and then written out in one go. The file is the
+ * magic, the version, the column count and the row count followed by a 64 byte header per column
+ * saying where its values are. Numbers are stored as arrays of little endian values, strings as
+ * row count + 1 uint32 offsets followed by the characters.
+ */
+class ColumnTable {
+public:
+  ColumnTable(const std::string& name, size_t rows) : name_(name), rows_(rows) {
+  }
+
+  void add(const std::string& name, const std::vector<uint64_t>& values) {
+    add(name, ColumnType::kUInt64, values);
+  }
+
+  void add(const std::string& name, const std::vector<float>& values) {
+    add(name, ColumnType::kFloat, values);
+  }
+
+  void add(const std::string& name, const std::vector<std::string>& values) {
+    std::vector<uint32_t> offsets(1, 0);
+    std::vector<char> characters;
+    for (const auto& value : values) {
+      characters.insert(characters.end(), value.begin(), value.end());
+      offsets.push_back(characters.size());
+    }
+    check(name, values.size());
+    columns_.push_back({name, ColumnType::kString, {}});
+    auto& data = columns_.back().data;
+    data.resize(offsets.size() * sizeof(uint32_t) + characters.size());
+    std::memcpy(data.data(), offsets.data(), offsets.size() * sizeof(uint32_t));
+    std::memcpy(data.data() + offsets.size() * sizeof(uint32_t), characters.data(),
+                characters.size());
+  }
+
+  // writes <dir>/<name>.columns, throws if it cant
+  void write(const std::string& dir) const {
+    // lay out the columns after the headers
+    std::vector<ColumnHeader> headers(columns_.size());
+    uint64_t offset = aligned(sizeof(kColumnsMagic) + 2 * sizeof(uint32_t) + sizeof(uint64_t) +
+                              headers.size() * sizeof(ColumnHeader));
+    for (size_t i = 0; i < columns_.size(); ++i) {
+      auto& header = headers[i];
+      std::memset(&header, 0, sizeof(header));
+      std::strncpy(header.name, columns_[i].name.c_str(), kColumnNameSize - 1);
+      header.type = static_cast<uint32_t>(columns_[i].type);
+      header.offset = offset;
+      header.size = columns_[i].data.size();
+      offset = aligned(offset + header.size);
+    }
+
+    auto path = dir + filesystem::path::preferred_separator + name_ + ".columns";
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    uint32_t column_count = columns_.size();
+    uint64_t rows = rows_;
+    file.write(kColumnsMagic, sizeof(kColumnsMagic));
+    file.write(reinterpret_cast<const char*>(&kColumnsVersion), sizeof(kColumnsVersion));
+    file.write(reinterpret_cast<const char*>(&column_count), sizeof(column_count));
+    file.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+    file.write(reinterpret_cast<const char*>(headers.data()), headers.size() * sizeof(ColumnHeader));
+    const char padding[8] = {};
+    for (size_t i = 0; i < columns_.size(); ++i) {
+      file.write(padding, headers[i].offset - file.tellp());
+      file.write(columns_[i].data.data(), columns_[i].data.size());
+    }
+    if (!file) {
+      throw std::runtime_error("Could not write " + path);
+    }
+  }
+
+private:
+  struct Column {
+    std::string name;
+    ColumnType type;
+    std::vector<char> data;
+  };
+
+  template <typename T>
+  void add(const std::string& name, ColumnType type, const std::vector<T>& values) {
+    check(name, values.size());
+    columns_.push_back({name, type, {}});
+    columns_.back().data.resize(values.size() * sizeof(T));
+    std::memcpy(columns_.back().data.data(), values.data(), values.size() * sizeof(T));
+  }
+
+  void check(const std::string& name, size_t rows) const {
+    if (rows != rows_ || name.size() >= kColumnNameSize) {
+      throw std::logic_error("Column " + name + " does not fit table " + name_);
+    }
+  }
+
+  std::string name_;
+  size_t rows_;
+  std::vector<Column> columns_;
+};
+
+// the value for a key and road class, or nothing if there was none
+template <typename Map, typename Key>
+typename Map::mapped_type::mapped_type get(const Map& map, const Key& key, RoadClass rclass) {
+  auto found = map.find(key);
+  if (found == map.cend()) {
+    return {};
+  }
+  auto value = found->second.find(rclass);
+  return value == found->second.cend() ? typename Map::mapped_type::mapped_type{} : value->second;
+}
+
+std::string column_name(RoadClass rclass) {
+  auto name = roadClassToString.at(rclass);
+  std::transform(name.begin(), name.end(), name.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return name;
+}
+
+// the key of a set or a map entry
+template <typename Key> const Key& key_of(const Key& key) {
+  return key;
+}
+
+template <typename Key, typename Value> const Key& key_of(const std::pair<const Key, Value>& entry) {
+  return entry.first;
+}
+
+// sorted so the files come out the same every time
+template <typename Key, typename Container> std::vector<Key> sorted_keys(const Container& keys) {
+  std::vector<Key> sorted;
+  sorted.reserve(keys.size());
+  for (const auto& key : keys) {
+    sorted.push_back(key_of(key));
+  }
+  std::sort(sorted.begin(), sorted.end());
+  return sorted;
+}
+
+// the road lengths of each tile or country, in total and per road class
+template <typename Key, typename Map>
+void add_lengths(ColumnTable& table, const std::vector<Key>& keys, const Map& lengths) {
+  std::vector<float> total(keys.size(), 0);
+  std::vector<std::vector<float>> per_class(rclasses.size(), std::vector<float>(keys.size()));
+  for (size_t i = 0; i < keys.size(); ++i) {
+    for (size_t c = 0; c < rclasses.size(); ++c) {
+      per_class[c][i] = get(lengths, keys[i], rclasses[c]);
+      total[i] += per_class[c][i];
+    }
+  }
+  table.add("totalroadlen", total);
+  for (size_t c = 0; c < rclasses.size(); ++c) {
+    table.add(column_name(rclasses[c]), per_class[c]);
+  }
+}
+
+// a table with a row per tile or country and road class, starting with the key and the type
+template <typename Key>
+ColumnTable rclass_table(const std::string& name,
+                         const std::string& key_name,
+                         const std::vector<Key>& keys) {
+  ColumnTable table(name, keys.size() * rclasses.size());
+  std::vector<Key> key_values;
+  std::vector<std::string> types;
+  for (const auto& key : keys) {
+    for (auto rclass : rclasses) {
+      key_values.push_back(key);
+      types.push_back(roadClassToString.at(rclass));
+    }
+  }
+  table.add(key_name, key_values);
+  table.add("type", types);
+  return table;
+}
+
+// one statistic for every row of a table made by rclass_table
+template <typename T, typename Key, typename Map>
+void add_rclass_column(ColumnTable& table,
+                       const std::string& name,
+                       const std::vector<Key>& keys,
+                       const Map& map) {
+  std::vector<T> values;
+  values.reserve(keys.size() * rclasses.size());
+  for (const auto& key : keys) {
+    for (auto rclass : rclasses) {
+      values.push_back(get(map, key, rclass));
+    }
+  }
+  table.add(name, values);
+}
+
+// the share of exits or forks that have signs
+template <typename Key, typename Map>
+ColumnTable exit_table(const std::string& name,
+                       const std::string& key_name,
+                       const Map& signs,
+                       const Map& counts) {
+  auto keys = sorted_keys<Key>(signs);
+  std::vector<float> percent;
+  percent.reserve(keys.size());
+  for (const auto& key : keys) {
+    percent.push_back(static_cast<float>(signs.at(key)) / static_cast<float>(counts.at(key)));
+  }
+  ColumnTable table(name, keys.size());
+  table.add(key_name, keys);
+  table.add("exitsign", percent);
+  return table;
+}
+
+ColumnTable tile_table(const statistics& stats, const std::vector<uint64_t>& tile_ids) {
+  ColumnTable table("tiledata", tile_ids.size());
+  table.add("tileid", tile_ids);
+  std::vector<float> areas, minx, miny, maxx, maxy;
+  for (auto tile_id : tile_ids) {
+    auto area = stats.get_tile_areas().find(tile_id);
+    areas.push_back(area == stats.get_tile_areas().cend() ? 0.f : area->second);
+    auto geometry = stats.get_tile_geometries().find(tile_id);
+    if (geometry == stats.get_tile_geometries().cend()) {
+      LOG_ERROR("Geometry for tile " + std::to_string(tile_id) + " not found.");
+    }
+    const auto bounds =
+        geometry == stats.get_tile_geometries().cend() ? AABB2<PointLL>() : geometry->second;
+    minx.push_back(bounds.minx());
+    miny.push_back(bounds.miny());
+    maxx.push_back(bounds.maxx());
+    maxy.push_back(bounds.maxy());
+  }
+  table.add("tilearea", areas);
+  add_lengths(table, tile_ids, stats.get_tile_lengths());
+  table.add("minx", minx);
+  table.add("miny", miny);
+  table.add("maxx", maxx);
+  table.add("maxy", maxy);
+  return table;
+}
+
+ColumnTable country_table(const statistics& stats, const std::vector<std::string>& isos) {
+  ColumnTable table("countrydata", isos.size());
+  table.add("isocode", isos);
+  add_lengths(table, isos, stats.get_country_lengths());
+  return table;
+}
+
+template <typename Key, typename LengthMap, typename CountMap>
+ColumnTable road_table(const std::string& name,
+                       const std::string& key_name,
+                       const std::vector<Key>& keys,
+                       const LengthMap& one_way,
+                       const LengthMap& speed_info,
+                       const CountMap& int_edges,
+                       const LengthMap& named) {
+  auto table = rclass_table(name, key_name, keys);
+  add_rclass_column<float>(table, "oneway", keys, one_way);
+  add_rclass_column<float>(table, "maxspeed", keys, speed_info);
+  add_rclass_column<uint64_t>(table, "internaledges", keys, int_edges);
+  add_rclass_column<float>(table, "named", keys, named);
+  return table;
+}
+
+template <typename Key, typename LengthMap, typename CountMap>
+ColumnTable truck_table(const std::string& name,
+                        const std::string& key_name,
+                        const std::vector<Key>& keys,
+                        const LengthMap& hazmat,
+                        const LengthMap& truck_route,
+                        const CountMap& height,
+                        const CountMap& width,
+                        const CountMap& length,
+                        const CountMap& weight,
+                        const CountMap& axle_load) {
+  auto table = rclass_table(name, key_name, keys);
+  add_rclass_column<float>(table, "hazmat", keys, hazmat);
+  add_rclass_column<float>(table, "truck_route", keys, truck_route);
+  add_rclass_column<uint64_t>(table, "height", keys, height);
+  add_rclass_column<uint64_t>(table, "width", keys, width);
+  add_rclass_column<uint64_t>(table, "length", keys, length);
+  add_rclass_column<uint64_t>(table, "weight", keys, weight);
+  add_rclass_column<uint64_t>(table, "axle_load", keys, axle_load);
+  return table;
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+void statistics::build_columns(const std::string& dir) const {
+  LOG_INFO("Writing statistics columns to " + dir);
+  filesystem::create_directories(dir);
+  auto tiles = sorted_keys<uint64_t>(tile_ids);
+  auto isos = sorted_keys<std::string>(iso_codes);
+
+  // every table is made and written by its own thread
+  std::vector<std::function<ColumnTable()>> tables = {
+      [&]() { return tile_table(*this, tiles); },
+      [&]() {
+        return road_table("rclasstiledata", "tileid", tiles, tile_one_way, tile_speed_info,
+                          tile_int_edges, tile_named);
+      },
+      [&]() {
+        return truck_table("truckrclasstiledata", "tileid", tiles, tile_hazmat,
+                           tile_truck_route, tile_height, tile_width, tile_length, tile_weight,
+                           tile_axle_load);
+      },
+      [&]() { return country_table(*this, isos); },
+      [&]() {
+        return road_table("rclassctrydata", "isocode", isos, country_one_way, country_speed_info,
+                          country_int_edges, country_named);
+      },
+      [&]() {
+        return truck_table("truckrclassctrydata", "isocode", isos, country_hazmat,
+                           country_truck_route, country_height, country_width, country_length,
+                           country_weight, country_axle_load);
+      },
+      [&]() {
+        return exit_table<uint64_t>("tile_exitinfo", "tileid", tile_exit_signs, tile_exit_count);
+      },
+      [&]() {
+        return exit_table<uint64_t>("tile_forkinfo", "tileid", tile_fork_signs, tile_fork_count);
+      },
+      [&]() {
+        return exit_table<std::string>("ctry_exitinfo", "isocode", ctry_exit_signs,
+                                       ctry_exit_count);
+      },
+      [&]() {
+        return exit_table<std::string>("ctry_forkinfo", "isocode", ctry_fork_signs,
+                                       ctry_fork_count);
+      },
+  };
+  std::vector<std::future<void>> writes;
+  for (const auto& table : tables) {
+    writes.emplace_back(std::async(std::launch::async, [&table, &dir]() { table().write(dir); }));
+  }
+  // rethrows if any of them failed
+  for (auto& write : writes) {
+    write.get();
+  }
+  LOG_INFO("Statistics columns saved to " + dir);
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -17,8 +17,7 @@ using namespace valhalla::mjolnir;
 namespace valhalla {
 namespace mjolnir {
 
-void statistics::build_db() {
-  std::string database = "statistics.sqlite";
+void statistics::build_db(const std::string& database) {
   if (filesystem::exists(database)) {
     filesystem::remove(database);
   }
@@ -102,7 +101,7 @@ void statistics::build_db() {
   }
 
   sqlite3_close(db_handle);
-  LOG_INFO("Statistics database saved to statistics.sqlite");
+  LOG_INFO("Statistics database saved to " + database);
 }
 void statistics::create_tile_tables(sqlite3* db_handle) {
   uint32_t ret;
@@ -0,0 +1,291 @@
+#include "mjolnir/tilecompressor.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+
+#include "baldr/compression_utils.h"
+#include "baldr/graphtile.h"
+#include "baldr/tilehierarchy.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+// the zstd cli cuts the files it trains on into blocks this big, the tiles are much bigger
+constexpr size_t kSampleBlockSize = 128 * 1024;
+
+std::vector<char> read_file(const std::string& path) {
+  std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    throw std::runtime_error("Could not open " + path);
+  }
+  std::vector<char> data(file.tellg());
+  file.seekg(0, std::ios::beg);
+  if (!file.read(data.data(), data.size())) {
+    throw std::runtime_error("Could not read " + path);
+  }
+  return data;
+}
+
+// written to the side and moved in place so no one reads half a file
+void write_file(const std::string& path, const std::vector<char>& data) {
+  auto tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.write(data.data(), data.size())) {
+      throw std::runtime_error("Could not write " + tmp_path);
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    throw std::runtime_error("Could not move " + tmp_path + " to " + path);
+  }
+}
+
+bool ends_with(const std::string& path, const std::string& suffix) {
+  return path.size() > suffix.size() &&
+         path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// the tiles of a level uncompressed. the dictionary is about to be replaced so any that an earlier
+// run compressed and didnt keep are decompressed to be compressed again with the new one
+std::vector<std::string> level_tiles(const std::string& tile_dir,
+                                     uint8_t level,
+                                     const std::string& dictionary_path) {
+  std::set<std::string> tiles, compressed_tiles;
+  filesystem::path level_dir(tile_dir + filesystem::path::preferred_separator +
+                             std::to_string(level));
+  if (!filesystem::is_directory(level_dir)) {
+    return {};
+  }
+  for (filesystem::recursive_directory_iterator i(level_dir), end; i != end; ++i) {
+    const auto& path = i->path().string();
+    if (!i->is_regular_file()) {
+      continue;
+    }
+    try {
+      GraphTile::GetTileId(path);
+    } catch (...) { continue; }
+    if (ends_with(path, SUFFIX_NON_COMPRESSED)) {
+      tiles.insert(path);
+    } else if (ends_with(path, SUFFIX_ZSTD)) {
+      compressed_tiles.insert(path.substr(0, path.size() - SUFFIX_ZSTD.size()) +
+                              SUFFIX_NON_COMPRESSED);
+    }
+  }
+
+  std::unique_ptr<ZstdDictionary> dictionary;
+  std::vector<char> data;
+  for (const auto& tile : compressed_tiles) {
+    if (tiles.count(tile)) {
+      continue;
+    }
+    auto compressed = read_file(tile + ".zst");
+    if (zstd_dictionary_id(compressed.data(), compressed.size()) && !dictionary) {
+      dictionary.reset(new ZstdDictionary(read_file(dictionary_path)));
+    }
+    if (!zstd_decompress(compressed.data(), compressed.size(), data, dictionary.get())) {
+      throw std::runtime_error("Could not decompress " + tile + ".zst");
+    }
+    write_file(tile, data);
+    tiles.insert(tile);
+  }
+  return std::vector<std::string>(tiles.begin(), tiles.end());
+}
+
+// a dictionary trained on blocks of randomly chosen tiles, or nothing if there was too little
+// to train on
+std::vector<char> train(const std::vector<std::string>& tiles,
+                        uint8_t level,
+                        const TileCompressor::Options& options) {
+  std::vector<std::string> shuffled(tiles);
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(level));
+  std::vector<char> samples;
+  std::vector<size_t> sizes;
+  for (const auto& tile : shuffled) {
+    auto data = read_file(tile);
+    for (size_t offset = 0; offset < data.size() && samples.size() < options.sample_size;
+         offset += kSampleBlockSize) {
+      auto size = std::min(kSampleBlockSize, data.size() - offset);
+      samples.insert(samples.end(), data.begin() + offset, data.begin() + offset + size);
+      sizes.push_back(size);
+    }
+    if (samples.size() >= options.sample_size) {
+      break;
+    }
+  }
+
+  try {
+    return ZstdDictionary::Train(samples, sizes, options.dictionary_size);
+  } catch (const std::exception& e) {
+    LOG_WARN("Level " + std::to_string(level) + " is compressed without a dictionary: " +
+             e.what());
+  }
+  return {};
+}
+
+std::vector<char> gzip(const std::vector<char>& data) {
+  std::vector<char> compressed;
+  auto src_func = [&data](z_stream& s) -> int {
+    s.next_in = const_cast<Byte*>(reinterpret_cast<const Byte*>(data.data()));
+    s.avail_in = static_cast<unsigned int>(data.size());
+    return Z_FINISH;
+  };
+  auto dst_func = [&compressed, &data](z_stream& s) -> void {
+    auto size = compressed.size();
+    if (s.total_out < size) {
+      compressed.resize(s.total_out);
+    } else {
+      compressed.resize(size + data.size() / 2 + 1024);
+      s.next_out = reinterpret_cast<Byte*>(compressed.data() + size);
+      s.avail_out = compressed.size() - size;
+    }
+  };
+  if (!deflate(src_func, dst_func)) {
+    throw std::runtime_error("Could not gzip tile");
+  }
+  return compressed;
+}
+
+void gunzip(const std::vector<char>& compressed, std::vector<char>& data) {
+  data.clear();
+  auto src_func = [&compressed](z_stream& s) -> void {
+    s.next_in = const_cast<Byte*>(reinterpret_cast<const Byte*>(compressed.data()));
+    s.avail_in = static_cast<unsigned int>(compressed.size());
+  };
+  auto dst_func = [&data, &compressed](z_stream& s) -> int {
+    auto size = data.size();
+    if (s.total_out < size) {
+      data.resize(s.total_out);
+    } else {
+      data.resize(size + compressed.size() * 4);
+      s.next_out = reinterpret_cast<Byte*>(data.data() + size);
+      s.avail_out = data.size() - size;
+    }
+    return Z_NO_FLUSH;
+  };
+  if (!inflate(src_func, dst_func)) {
+    throw std::runtime_error("Could not gunzip tile");
+  }
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// compresses the tiles the shared index hands out until there are none left
+TileCompressor::LevelStats compress_tiles(const std::vector<std::string>& tiles,
+                                          std::atomic<size_t>& next_tile,
+                                          const ZstdDictionary* dictionary,
+                                          const TileCompressor::Options& options) {
+  TileCompressor::LevelStats stats;
+  std::vector<char> compressed, decompressed;
+  for (auto i = next_tile++; i < tiles.size(); i = next_tile++) {
+    const auto& tile = tiles[i];
+    auto data = read_file(tile);
+    if (!zstd_compress(data.data(), data.size(), compressed, options.level, dictionary)) {
+      throw std::runtime_error("Could not compress " + tile);
+    }
+
+    // the uncompressed one may be about to go away so make sure we can get it back
+    auto start = std::chrono::steady_clock::now();
+    if (!zstd_decompress(compressed.data(), compressed.size(), decompressed, dictionary) ||
+        decompressed != data) {
+      throw std::runtime_error("Compressed " + tile + " does not decompress to the original");
+    }
+    stats.zstd_seconds += seconds_since(start);
+
+    if (options.compare_gzip) {
+      auto gzipped = gzip(data);
+      start = std::chrono::steady_clock::now();
+      gunzip(gzipped, decompressed);
+      stats.gzip_seconds += seconds_since(start);
+      stats.gzip_size += gzipped.size();
+    }
+
+    write_file(tile + ".zst", compressed);
+    if (!options.keep) {
+      filesystem::remove(tile);
+    }
+    ++stats.tiles;
+    stats.size += data.size();
+    stats.zstd_size += compressed.size();
+  }
+  return stats;
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+std::vector<TileCompressor::LevelStats> TileCompressor::Compress(const std::string& tile_dir,
+                                                                 const Options& options) {
+  if (!zstd_supported()) {
+    throw std::runtime_error("Valhalla was built without zstd support");
+  }
+
+  // transit tiles have their own level and so their own dictionary
+  std::vector<uint8_t> levels;
+  for (const auto& level : TileHierarchy::levels()) {
+    levels.push_back(level.level);
+  }
+  levels.push_back(TileHierarchy::GetTransitLevel().level);
+
+  std::vector<LevelStats> all_stats;
+  for (auto level : levels) {
+    auto dictionary_path = tile_dir + filesystem::path::preferred_separator +
+                           std::to_string(level) + filesystem::path::preferred_separator +
+                           ZSTD_DICTIONARY;
+    auto tiles = level_tiles(tile_dir, level, dictionary_path);
+    if (tiles.empty()) {
+      continue;
+    }
+
+    LOG_INFO("Training a dictionary on the " + std::to_string(tiles.size()) + " tiles of level " +
+             std::to_string(level));
+    auto trained = train(tiles, level, options);
+    std::unique_ptr<ZstdDictionary> dictionary;
+    if (trained.empty()) {
+      filesystem::remove(dictionary_path);
+    } else {
+      write_file(dictionary_path, trained);
+      dictionary.reset(new ZstdDictionary(trained, options.level));
+    }
+
+    LOG_INFO("Compressing the tiles of level " + std::to_string(level));
+    std::atomic<size_t> next_tile(0);
+    std::vector<std::future<LevelStats>> results;
+    for (unsigned int i = 0; i < std::max(options.concurrency, 1u); ++i) {
+      results.emplace_back(std::async(std::launch::async, compress_tiles, std::cref(tiles),
+                                      std::ref(next_tile), dictionary.get(), std::cref(options)));
+    }
+
+    LevelStats stats;
+    stats.level = level;
+    stats.dictionary_size = trained.size();
+    for (auto& result : results) {
+      auto thread_stats = result.get();
+      stats.tiles += thread_stats.tiles;
+      stats.size += thread_stats.size;
+      stats.zstd_size += thread_stats.zstd_size;
+      stats.zstd_seconds += thread_stats.zstd_seconds;
+      stats.gzip_size += thread_stats.gzip_size;
+      stats.gzip_seconds += thread_stats.gzip_seconds;
+    }
+    all_stats.push_back(stats);
+  }
+  return all_stats;
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -0,0 +1,263 @@
+#include "mjolnir/tilescheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "baldr/graphtile.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+constexpr size_t kNoTile = std::numeric_limits<size_t>::max();
+
+// how many of the slowest tiles to name
+constexpr size_t kSlowestTiles = 5;
+
+// the histogram buckets double in size starting from a millisecond
+constexpr size_t kHistogramBuckets = 16;
+
+std::string seconds(double s) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(s < 10 ? 3 : 1) << s << "s";
+  return ss.str();
+}
+
+std::string bucket_label(size_t bucket) {
+  if (bucket == 0) {
+    return "<1ms";
+  }
+  auto ms = [](size_t b) {
+    auto value = size_t(1) << (b - 1);
+    return value < 1000 ? std::to_string(value) + "ms" : std::to_string(value / 1000) + "s";
+  };
+  if (bucket == kHistogramBuckets - 1) {
+    return ">=" + ms(bucket);
+  }
+  return ms(bucket) + "-" + ms(bucket + 1);
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+struct TileScheduler::Worker {
+  // the tiles of this worker as indices into tiles_, biggest first. thieves take from the back
+  std::mutex lock;
+  std::deque<size_t> queue;
+  // what is left in the queue, so thieves know who to steal from
+  std::atomic<size_t> count{0};
+  std::atomic<uint64_t> cost{0};
+
+  // only ever touched by the thread of this worker
+  size_t current = kNoTile;
+  std::chrono::steady_clock::time_point current_start;
+  std::chrono::steady_clock::time_point first;
+  std::chrono::steady_clock::time_point finished;
+  bool started = false;
+  size_t stolen = 0;
+  double busy_seconds = 0;
+  std::vector<std::pair<float, size_t>> timings;
+};
+
+TileScheduler::TileScheduler(const std::string& stage,
+                             const std::string& tile_dir,
+                             const std::vector<GraphId>& tiles,
+                             unsigned int workers)
+    : stage_(stage) {
+  tiles_.reserve(tiles.size());
+  for (const auto& tile_id : tiles) {
+    auto path = tile_dir + filesystem::path::preferred_separator + GraphTile::FileSuffix(tile_id);
+    struct stat s;
+    tiles_.emplace_back(tile_id, stat(path.c_str(), &s) == 0 ? s.st_size : 0);
+  }
+  workers_.resize(std::max(workers, 1u));
+  Deal();
+}
+
+TileScheduler::TileScheduler(const std::string& stage,
+                             std::vector<std::pair<GraphId, uint64_t>> tiles,
+                             unsigned int workers)
+    : stage_(stage), tiles_(std::move(tiles)) {
+  workers_.resize(std::max(workers, 1u));
+  Deal();
+}
+
+TileScheduler::~TileScheduler() = default;
+
+void TileScheduler::Deal() {
+  for (auto& worker : workers_) {
+    worker.reset(new Worker);
+  }
+
+  // biggest first, ties in tile order so the same tiles are always dealt the same way
+  std::vector<size_t> order(tiles_.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return tiles_[a].second != tiles_[b].second ? tiles_[a].second > tiles_[b].second
+                                                : tiles_[a].first < tiles_[b].first;
+  });
+
+  // each goes to whoever has the least so far, tiles that cost nothing are spread evenly
+  auto less_work = [](const std::unique_ptr<Worker>& a, const std::unique_ptr<Worker>& b) {
+    return a->cost != b->cost ? a->cost < b->cost : a->count < b->count;
+  };
+  for (auto index : order) {
+    auto least = std::min_element(workers_.begin(), workers_.end(), less_work);
+    (*least)->queue.push_back(index);
+    (*least)->cost += tiles_[index].second;
+    ++(*least)->count;
+  }
+}
+
+bool TileScheduler::Next(unsigned int worker_index, GraphId& tile_id) {
+  auto& worker = *workers_[worker_index];
+  auto now = std::chrono::steady_clock::now();
+  if (!worker.started) {
+    worker.started = true;
+    worker.first = now;
+  }
+
+  // the previous tile is done
+  if (worker.current != kNoTile) {
+    auto elapsed = std::chrono::duration<double>(now - worker.current_start).count();
+    worker.busy_seconds += elapsed;
+    worker.timings.emplace_back(elapsed, worker.current);
+    worker.current = kNoTile;
+  }
+
+  // our own biggest tile
+  size_t index = kNoTile;
+  {
+    std::lock_guard<std::mutex> lock(worker.lock);
+    if (!worker.queue.empty()) {
+      index = worker.queue.front();
+      worker.queue.pop_front();
+      worker.cost -= tiles_[index].second;
+      --worker.count;
+    }
+  }
+
+  // or the smallest tile of whoever has the most left. someone may beat us to it so keep looking
+  // until everyone is out
+  while (index == kNoTile) {
+    Worker* victim = nullptr;
+    for (auto& other : workers_) {
+      if (other.get() != &worker && other->count > 0 &&
+          (!victim || other->cost > victim->cost ||
+           (other->cost == victim->cost && other->count > victim->count))) {
+        victim = other.get();
+      }
+    }
+    if (!victim) {
+      break;
+    }
+    std::lock_guard<std::mutex> lock(victim->lock);
+    if (!victim->queue.empty()) {
+      index = victim->queue.back();
+      victim->queue.pop_back();
+      victim->cost -= tiles_[index].second;
+      --victim->count;
+      ++worker.stolen;
+    }
+  }
+
+  if (index == kNoTile) {
+    worker.finished = now;
+    return false;
+  }
+  worker.current = index;
+  worker.current_start = std::chrono::steady_clock::now();
+  tile_id = tiles_[index].first;
+  return true;
+}
+
+void TileScheduler::LogStats() const {
+  // the stage ran from when the first worker asked for a tile till the last one was told there
+  // were none left
+  auto first = std::chrono::steady_clock::time_point::max();
+  auto finished = std::chrono::steady_clock::time_point::min();
+  double busy_seconds = 0;
+  size_t stolen = 0;
+  std::vector<std::pair<float, size_t>> timings;
+  for (const auto& worker : workers_) {
+    if (!worker->started) {
+      continue;
+    }
+    first = std::min(first, worker->first);
+    finished = std::max(finished, worker->finished);
+    busy_seconds += worker->busy_seconds;
+    stolen += worker->stolen;
+    timings.insert(timings.end(), worker->timings.begin(), worker->timings.end());
+  }
+  if (timings.empty()) {
+    return;
+  }
+  auto wall_seconds = std::chrono::duration<double>(finished - first).count();
+
+  // how long the worker that finished first sat around waiting for the last one
+  double longest_wait = 0;
+  for (const auto& worker : workers_) {
+    if (worker->started) {
+      longest_wait =
+          std::max(longest_wait, std::chrono::duration<double>(finished - worker->finished).count());
+    }
+  }
+
+  std::stringstream utilization;
+  utilization << std::fixed << std::setprecision(1)
+              << (wall_seconds > 0 ? 100 * busy_seconds / (workers_.size() * wall_seconds) : 100.)
+              << "%";
+  LOG_INFO(stage_ + ": " + std::to_string(timings.size()) + " tiles on " +
+           std::to_string(workers_.size()) + " threads in " + seconds(wall_seconds) + ", " +
+           utilization.str() + " utilization, " + std::to_string(stolen) +
+           " tiles stolen, the first thread done waited " + seconds(longest_wait));
+
+  // how long the tiles took
+  std::vector<size_t> histogram(kHistogramBuckets, 0);
+  for (const auto& timing : timings) {
+    auto ms = timing.first * 1000;
+    size_t bucket = ms < 1 ? 0 : static_cast<size_t>(std::log2(ms)) + 1;
+    ++histogram[std::min(bucket, kHistogramBuckets - 1)];
+  }
+  std::string buckets;
+  for (size_t bucket = 0; bucket < histogram.size(); ++bucket) {
+    if (histogram[bucket]) {
+      buckets += (buckets.empty() ? "" : ", ") + bucket_label(bucket) + ": " +
+                 std::to_string(histogram[bucket]);
+    }
+  }
+  LOG_INFO(stage_ + ": time per tile " + buckets);
+
+  // and which ones took the longest
+  auto slowest = std::min(kSlowestTiles, timings.size());
+  std::partial_sort(timings.begin(), timings.begin() + slowest, timings.end(),
+                    [](const std::pair<float, size_t>& a, const std::pair<float, size_t>& b) {
+                      return a.first > b.first;
+                    });
+  std::string tiles;
+  for (size_t i = 0; i < slowest; ++i) {
+    const auto& tile = tiles_[timings[i].second];
+    tiles += (tiles.empty() ? "" : ", ") + std::to_string(tile.first.level()) + "/" +
+             std::to_string(tile.first.tileid()) + " " + seconds(timings[i].first) + " (" +
+             std::to_string(tile.second) + ")";
+  }
+  LOG_INFO(stage_ + ": slowest tiles (cost) " + tiles);
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -1,6 +1,8 @@
 #include "mjolnir/transitbuilder.h"
 #include "mjolnir/graphtilebuilder.h"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <future>
 #include <iostream>
@@ -19,10 +21,13 @@
 #include "baldr/graphreader.h"
 #include "baldr/graphtile.h"
 #include "baldr/tilehierarchy.h"
+#include "baldr/transittimetable.h"
 #include "filesystem.h"
 #include "midgard/distanceapproximator.h"
 #include "midgard/logging.h"
 #include "midgard/util.h"
+#include "sif/costfactory.h"
+#include "thor/connectionscan.h"
 
 using namespace valhalla::midgard;
 using namespace valhalla::baldr;
@@ -652,6 +657,41 @@ void build(const boost::property_tree::ptree& pt,
   results.set_value({});
 }
 
+// walks from the stops handed out by the shared index to the stops around them
+void walk_transfers(const boost::property_tree::ptree& pt,
+                    const TransitTimetable& timetable,
+                    std::atomic<uint32_t>& next_stop,
+                    std::vector<std::vector<TransitTimetable::footpath_t>>& footpaths) {
+  GraphReader reader(pt);
+  valhalla::sif::CostFactory factory;
+  valhalla::sif::mode_costing_t mode_costing;
+  auto& pc = mode_costing[static_cast<uint32_t>(valhalla::sif::travel_mode_t::kPedestrian)];
+  pc = factory.Create(valhalla::Costing::pedestrian);
+  pc->SetAllowTransitConnections(true);
+
+  // the default is also the longest transfer a request can ask for
+  auto max_distance = pc->GetMaxTransferDistanceMM();
+  valhalla::thor::StopWalk walk;
+  for (auto stop = next_stop++; stop < timetable.stop_count(); stop = next_stop++) {
+    GraphId node(timetable.stop(stop).node);
+    walk.Walk(valhalla::thor::StopWalk::StopLocation(reader, node), reader, mode_costing, true,
+              max_distance, timetable);
+    for (const auto& reached : walk.stops()) {
+      if (reached.stop != stop) {
+        footpaths[stop].push_back({reached.stop, reached.secs, reached.distance});
+      }
+    }
+    std::sort(footpaths[stop].begin(), footpaths[stop].end(),
+              [](const TransitTimetable::footpath_t& a, const TransitTimetable::footpath_t& b) {
+                return a.stop < b.stop;
+              });
+
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+  }
+}
+
 } // namespace
 
 namespace valhalla {
@@ -775,5 +815,141 @@ void TransitBuilder::Build(const boost::property_tree::ptree& pt) {
   LOG_INFO("Finished - TransitBuilder took " + std::to_string(secs) + " secs");
 }
 
+// Flatten the departures into a timetable for the connection scan
+void TransitBuilder::BuildTimetable(const boost::property_tree::ptree& pt) {
+  auto t1 = std::chrono::high_resolution_clock::now();
+  auto tile_dir = pt.get<std::string>("mjolnir.tile_dir");
+  auto file_name = tile_dir + filesystem::path::preferred_separator + TransitTimetable::kFileName;
+  GraphReader reader(pt.get_child("mjolnir"));
+  auto transit_tiles = reader.GetTileSet(TileHierarchy::GetTransitLevel().level);
+
+  // every platform is a stop
+  std::vector<TransitTimetable::stop_t> stops;
+  for (const auto& tile_id : transit_tiles) {
+    auto tile = reader.GetGraphTile(tile_id);
+    for (GraphId node_id = tile_id; node_id.id() < tile->header()->nodecount(); ++node_id) {
+      if (tile->node(node_id)->type() == NodeType::kMultiUseTransitPlatform) {
+        stops.push_back({node_id.value, 0, 0});
+      }
+    }
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+  }
+  if (stops.empty()) {
+    LOG_INFO("No transit stops found. Timetable will not be built.");
+    return;
+  }
+  std::sort(stops.begin(), stops.end(),
+            [](const TransitTimetable::stop_t& a, const TransitTimetable::stop_t& b) {
+              return a.node < b.node;
+            });
+  auto find_stop = [&stops](const GraphId& node) {
+    auto found = std::lower_bound(stops.cbegin(), stops.cend(), node.value,
+                                  [](const TransitTimetable::stop_t& stop, uint64_t node) {
+                                    return stop.node < node;
+                                  });
+    return found == stops.cend() || found->node != node.value
+               ? TransitTimetable::kInvalidStop
+               : static_cast<uint32_t>(found - stops.cbegin());
+  };
+
+  // every departure of every line is a connection between the stops at either end of the line
+  std::vector<TransitTimetable::schedule_t> schedules;
+  std::vector<TransitTimetable::connection_t> connections;
+  std::unordered_map<uint64_t, uint32_t> trips;
+  for (const auto& tile_id : transit_tiles) {
+    auto tile = reader.GetGraphTile(tile_id);
+
+    // the line edges leave the platforms of this tile
+    std::unordered_map<uint32_t, std::pair<GraphId, uint32_t>> lines;
+    for (GraphId node_id = tile_id; node_id.id() < tile->header()->nodecount(); ++node_id) {
+      auto from_stop = find_stop(node_id);
+      GraphId edge_id(tile_id.tileid(), tile_id.level(), tile->node(node_id)->edge_index());
+      for (const auto& edge : tile->GetDirectedEdges(node_id)) {
+        if (edge.IsTransitLine() && from_stop != TransitTimetable::kInvalidStop) {
+          lines.emplace(edge.lineid(), std::make_pair(edge_id, from_stop));
+        }
+        ++edge_id;
+      }
+    }
+
+    // the schedules are relative to when the tile was made so keep that with them
+    uint32_t schedule_offset = schedules.size();
+    for (uint32_t i = 0; i < tile->header()->schedulecount(); ++i) {
+      const auto* schedule = tile->GetTransitSchedule(i);
+      schedules.push_back({schedule->days(), schedule->days_of_week(), schedule->end_day(),
+                           tile->header()->date_created(), 0});
+    }
+
+    for (const auto& departure : tile->GetDepartures()) {
+      auto line = lines.find(departure.lineid());
+      if (line == lines.cend()) {
+        continue;
+      }
+      auto to_stop = find_stop(tile->directededge(line->second.first)->endnode());
+      if (to_stop == TransitTimetable::kInvalidStop) {
+        continue;
+      }
+      TransitTimetable::connection_t connection{};
+      connection.edge = line->second.first.value;
+      connection.from_stop = line->second.second;
+      connection.to_stop = to_stop;
+      connection.tripid = departure.tripid();
+      connection.schedule = schedule_offset + departure.schedule_index();
+      connection.flags =
+          (departure.wheelchair_accessible() ? TransitTimetable::kWheelchairAccessible : 0) |
+          (departure.bicycle_accessible() ? TransitTimetable::kBicycleAccessible : 0);
+
+      // each run of a frequency based trip is its own vehicle, the runs of a trip line up from one
+      // stop to the next since they all share the frequency
+      auto end_time = departure.type() == kFrequencySchedule ? departure.end_time()
+                                                             : departure.departure_time();
+      for (uint32_t run = 0, time = departure.departure_time(); time <= end_time; ++run) {
+        auto key = (static_cast<uint64_t>(departure.tripid()) << 32) | run;
+        connection.trip = trips.emplace(key, trips.size()).first->second;
+        connection.departure = time;
+        connection.arrival = time + departure.elapsed_time();
+        connections.push_back(connection);
+        if (departure.type() != kFrequencySchedule || !departure.frequency()) {
+          break;
+        }
+        time += departure.frequency();
+      }
+    }
+
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+  }
+  LOG_INFO("Flattened " + std::to_string(connections.size()) + " connections of " +
+           std::to_string(trips.size()) + " trips between " + std::to_string(stops.size()) +
+           " stops");
+
+  // write it without transfers so that the walks can find the stops, then walk them all
+  std::vector<std::vector<TransitTimetable::footpath_t>> footpaths(stops.size());
+  TransitTimetable::Write(file_name, stops, schedules, connections, footpaths, trips.size());
+  {
+    TransitTimetable timetable(file_name);
+    std::atomic<uint32_t> next_stop(0);
+    std::vector<std::thread> threads(
+        std::max(1u, pt.get<unsigned int>("mjolnir.concurrency",
+                                          std::thread::hardware_concurrency())));
+    for (auto& thread : threads) {
+      thread = std::thread(walk_transfers, std::cref(pt.get_child("mjolnir")), std::cref(timetable),
+                           std::ref(next_stop), std::ref(footpaths));
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  TransitTimetable::Write(file_name, std::move(stops), schedules, std::move(connections), footpaths,
+                          trips.size());
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+  uint32_t secs = std::chrono::duration_cast<std::chrono::seconds>(t2 - t1).count();
+  LOG_INFO("Finished - timetable took " + std::to_string(secs) + " secs");
+}
+
 } // namespace mjolnir
 } // namespace valhalla
@@ -1,12 +1,16 @@
 #include "mjolnir/util.h"
 
+#include "baldr/componentlabels.h"
+#include "baldr/edgereach.h"
 #include "baldr/tilehierarchy.h"
+#include "baldr/transittimetable.h"
 #include "filesystem.h"
 #include "midgard/aabb2.h"
 #include "midgard/logging.h"
 #include "midgard/point2.h"
 #include "midgard/polyline2.h"
 #include "mjolnir/bssbuilder.h"
+#include "mjolnir/componentbuilder.h"
 #include "mjolnir/elevationbuilder.h"
 #include "mjolnir/graphbuilder.h"
 #include "mjolnir/graphenhancer.h"
@@ -15,6 +19,7 @@
 #include "mjolnir/hierarchybuilder.h"
 #include "mjolnir/osmpbfparser.h"
 #include "mjolnir/pbfgraphparser.h"
+#include "mjolnir/reachbuilder.h"
 #include "mjolnir/restrictionbuilder.h"
 #include "mjolnir/shortcutbuilder.h"
 #include "mjolnir/transitbuilder.h"
@@ -208,6 +213,11 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
       filesystem::remove_all(level_dir);
     }
 
+    // the component labels, edge reach and timetable would no longer match the new tiles
+    remove_temp_file(tile_dir + valhalla::baldr::ComponentLabels::kFileName);
+    remove_temp_file(tile_dir + valhalla::baldr::EdgeReach::kFileName);
+    remove_temp_file(tile_dir + valhalla::baldr::TransitTimetable::kFileName);
+
     // Create the directory if it does not exist
     filesystem::create_directories(tile_dir);
   }
@@ -403,6 +413,21 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
     remove_temp_file(tile_manifest);
     OSMData::cleanup_temp_files(tile_dir);
   }
+
+  // Label the strongly connected components of each mode so loki can reject impossible routes
+  if (start_stage <= BuildStage::kComponents && BuildStage::kComponents <= end_stage) {
+    ComponentBuilder::Build(config);
+  }
+
+  // Precompute the reach of every edge for the default costings so loki doesnt have to expand
+  if (start_stage <= BuildStage::kReach && BuildStage::kReach <= end_stage) {
+    ReachBuilder::Build(config);
+  }
+
+  // Flatten the transit schedules into a timetable for the connection scan
+  if (start_stage <= BuildStage::kTimetable && BuildStage::kTimetable <= end_stage) {
+    TransitBuilder::BuildTimetable(config);
+  }
   return true;
 }
 
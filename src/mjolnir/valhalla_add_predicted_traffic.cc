@@ -3,22 +3,21 @@
 #include "baldr/rapidjson_utils.h"
 #include "filesystem.h"
 #include "midgard/logging.h"
+#include "midgard/sequence.h"
 #include "midgard/util.h"
-#include "mjolnir/graphtilebuilder.h"
+#include "mjolnir/predictedtraffic.h"
 #include "mjolnir/util.h"
 
 #include <cmath>
 #include <cstdint>
 #include <cxxopts.hpp>
 
-#include <boost/archive/iterators/base64_from_binary.hpp>
-#include <boost/archive/iterators/binary_from_base64.hpp>
-#include <boost/archive/iterators/transform_width.hpp>
 #include <boost/optional.hpp>
 #include <boost/property_tree/ptree.hpp>
-#include <boost/tokenizer.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <deque>
 #include <future>
 #include <mutex>
@@ -34,6 +33,8 @@ namespace vj = valhalla::mjolnir;
 
 namespace bpt = boost::property_tree;
 
+using namespace valhalla::baldr;
+
 // args
 boost::property_tree::ptree config;
 filesystem::path traffic_tile_dir;
@@ -60,182 +61,107 @@ struct stats {
   }
 };
 
-struct TrafficSpeeds {
-  uint8_t constrained_flow_speed;
-  uint8_t free_flow_speed;
-  boost::optional<std::array<int16_t, kCoefficientCount>> coefficients;
+// the csv files of a tile and how big they are all together
+struct SpeedFiles {
+  GraphId tile_id;
+  std::vector<std::string> files;
+  uint64_t size = 0;
 };
 
-/**
- * Read speed CSV file and update the tile_speeds in unique_data
- */
-std::unordered_map<uint32_t, TrafficSpeeds>
-ParseTrafficFile(const std::vector<std::string>& filenames, stats& stat) {
-  typedef boost::tokenizer<boost::char_separator<char>> tokenizer;
-  boost::char_separator<char> sep{","};
-  std::unordered_map<uint32_t, TrafficSpeeds> ts;
-
-  // for each traffic tile
-  for (const auto& full_filename : filenames) {
-    // Open file
-    std::string line;
-    std::ifstream file(full_filename);
-    uint32_t line_num = 0;
-    if (file.is_open()) {
-      // for each row in the file
-      while (getline(file, line) && ++line_num) {
-        decltype(ts)::iterator traffic = ts.end();
-        tokenizer tok{line, sep};
-        uint32_t field_num = 0;
-        bool has_error = false;
-        // for each column in the row
-        for (const auto& t : tok) {
-          if (has_error)
-            break;
-          // parse each column
-          switch (field_num) {
-            case 0: {
-              try {
-                auto inserted = ts.insert(decltype(ts)::value_type(GraphId(t).id(), {}));
-                traffic = inserted.first;
-                // skip duplicates
-                if (!inserted.second) {
-                  ++stat.dup_count;
-                  has_error = true;
-                  traffic = ts.end();
-                }
-              } catch (std::exception& e) {
-                LOG_WARN("Invalid GraphId in file: " + full_filename + " line number " +
-                         std::to_string(line_num));
-                has_error = true;
-              }
-            } break;
-            case 1: {
-              try {
-                traffic->second.free_flow_speed = std::stoi(t);
-                stat.free_flow_count++;
-              } catch (std::exception& e) {
-                LOG_WARN("Invalid free flow speed in file: " + full_filename + " line number " +
-                         std::to_string(line_num));
-                has_error = true;
-              }
-            } break;
-            case 2: {
-              try {
-                traffic->second.constrained_flow_speed = std::stoi(t);
-                stat.constrained_count++;
-              } catch (std::exception& e) {
-                LOG_WARN("Invalid constrained flow speed in file: " + full_filename +
-                         " line number " + std::to_string(line_num));
-                has_error = true;
-              }
-            } break;
-            case 3: {
-              if (t.size()) {
-                try {
-                  // Decode the base64 predicted speeds
-                  traffic->second.coefficients = decode_compressed_speeds(t);
-                  stat.compressed_count++;
-                } catch (std::exception& e) {
-                  LOG_WARN("Invalid compressed speeds in file: " + full_filename + " line number " +
-                           std::to_string(line_num) + "; error='" + e.what() + "'");
-                  has_error = true;
-                }
-              }
-            } break;
-            default:
-              break;
-          }
-          field_num++;
-        }
-        // if this one was erroneous lets not keep it
-        if (has_error && traffic != ts.end())
-          ts.erase(traffic);
-      }
-      file.close();
-    } else {
-      LOG_ERROR("Could not open file: " + full_filename);
-    }
-  }
-
-  return ts;
-}
-
-void update_tile(const std::string& tile_dir,
-                 const GraphId& tile_id,
-                 const std::unordered_map<uint32_t, TrafficSpeeds>& speeds,
-                 stats& stat) {
-  auto tile_path = tile_dir + filesystem::path::preferred_separator + GraphTile::FileSuffix(tile_id);
-  if (!filesystem::exists(tile_path)) {
-    LOG_ERROR("No tile at " + tile_path);
-    return;
-  }
-
-  // Get the tile
-  vj::GraphTileBuilder tile_builder(tile_dir, tile_id, false);
-
-  // Get a count of how many predicted speed edges there will be this avoids reallocs
-  size_t pred_count = 0;
-  for (uint32_t j = 0; j < tile_builder.header()->directededgecount(); ++j) {
-    auto found = speeds.find(j);
-    pred_count += found != speeds.cend() && static_cast<bool>(found->second.coefficients);
-  }
-
-  // Update directed edges as needed
-  std::vector<DirectedEdge> directededges;
-  directededges.reserve(tile_builder.header()->directededgecount());
-  for (uint32_t j = 0; j < tile_builder.header()->directededgecount(); ++j) {
-    // skip edges for which we dont have speed data
-    DirectedEdge& directededge = tile_builder.directededge(j);
-    auto found = speeds.find(j);
-    if (found != speeds.end()) {
-      const auto& speed = found->second;
-      if (speed.constrained_flow_speed) {
-        directededge.set_constrained_flow_speed(speed.constrained_flow_speed);
-      }
-      if (speed.free_flow_speed) {
-        directededge.set_free_flow_speed(speed.free_flow_speed);
-      }
-      if (speed.coefficients) {
-        tile_builder.AddPredictedSpeed(j, *speed.coefficients, pred_count);
-        directededge.set_has_predicted_speed(true);
-      }
-      ++stat.updated_count;
-    }
-
-    // Add the directed edge to the local list
-    directededges.emplace_back(std::move(directededge));
-  }
-
-  // Write the new tile with updated directed edges and the predicted speeds
-  tile_builder.UpdatePredictedSpeeds(directededges);
-}
-
 /**
  * Read both the constrained and freeflow speed CSV files
  * We expect the files to be named as <quadtreeID>.constrained.csv and
  * <quadtreeID>.freeflow.csv. (e.g., 1202021.constrained.csv and 1202021.freeflow.csv)
+ *
+ * The threads take the next tile from the queue until it runs out, the biggest tiles come first
+ * so that none of the threads is left with a big one at the end
  */
-void update_tiles(
-    const std::string& tile_dir,
-    std::vector<std::pair<GraphId, std::vector<std::string>>>::const_iterator tile_start,
-    std::vector<std::pair<GraphId, std::vector<std::string>>>::const_iterator tile_end,
-    std::promise<stats>& result) {
+void update_tiles(const std::string& tile_dir,
+                  const std::vector<SpeedFiles>& traffic_tiles,
+                  std::atomic<size_t>& next_tile,
+                  std::atomic<size_t>& done_tiles,
+                  std::promise<stats>& result) {
 
   std::stringstream thread_name;
   thread_name << std::this_thread::get_id();
 
-  // Iterate through the tiles and parse them
-  size_t total = tile_end - tile_start;
-  double count = 0;
+  // reused from row to row and tile to tile
+  vj::TrafficRow row;
+  vj::TileSpeedsUpdater updater;
+  vm::mem_map<char> csv;
   stats stat{};
-  for (; tile_start != tile_end; ++tile_start) {
-    LOG_INFO(thread_name.str() + " parsing traffic data for " + std::to_string(tile_start->first));
-    auto traffic = ParseTrafficFile(tile_start->second, stat);
-    LOG_INFO(thread_name.str() + " add traffic data to " + std::to_string(tile_start->first));
-    update_tile(tile_dir, tile_start->first, traffic, stat);
-    LOG_INFO(thread_name.str() + " finished " + std::to_string(tile_start->first) + "(" +
-             std::to_string(++count / total * 100.0) + ")");
+  for (auto i = next_tile++; i < traffic_tiles.size(); i = next_tile++) {
+    const auto& traffic_tile = traffic_tiles[i];
+    auto tile_path = tile_dir + filesystem::path::preferred_separator +
+                     GraphTile::FileSuffix(traffic_tile.tile_id);
+    if (!filesystem::exists(tile_path)) {
+      LOG_ERROR("No tile at " + tile_path);
+      continue;
+    }
+
+    LOG_INFO(thread_name.str() + " add traffic data to " + std::to_string(traffic_tile.tile_id));
+    updater.Open(tile_path);
+    for (const auto& file_name : traffic_tile.files) {
+      auto file_size = filesystem::directory_entry(file_name).file_size();
+      if (file_size == 0) {
+        continue;
+      }
+      csv.map_readonly(file_name, file_size, POSIX_MADV_SEQUENTIAL);
+
+      // for each row in the file
+      uint32_t line_num = 0;
+      for (const char *line = csv.get(), *end = line + csv.size(); line < end;) {
+        auto line_end = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        line_end = line_end ? line_end : end;
+        auto line_begin = line;
+        line = line_end + 1;
+        ++line_num;
+        // blank lines have nothing to say
+        if (line_begin == line_end || (line_begin + 1 == line_end && *line_begin == '\r')) {
+          continue;
+        }
+
+        switch (row.Parse(line_begin, line_end)) {
+          case vj::TrafficRow::kEdgeId:
+            LOG_WARN("Invalid GraphId in file: " + file_name + " line number " +
+                     std::to_string(line_num));
+            continue;
+          case vj::TrafficRow::kFreeFlowSpeed:
+            LOG_WARN("Invalid free flow speed in file: " + file_name + " line number " +
+                     std::to_string(line_num));
+            continue;
+          case vj::TrafficRow::kConstrainedFlowSpeed:
+            LOG_WARN("Invalid constrained flow speed in file: " + file_name + " line number " +
+                     std::to_string(line_num));
+            continue;
+          case vj::TrafficRow::kCompressedSpeeds:
+            LOG_WARN("Invalid compressed speeds in file: " + file_name + " line number " +
+                     std::to_string(line_num));
+            continue;
+          default:
+            break;
+        }
+
+        if (row.edge_id.id() >= updater.edge_count()) {
+          LOG_WARN("No such edge in the tile from file: " + file_name + " line number " +
+                   std::to_string(line_num));
+          continue;
+        }
+        // skip duplicates
+        if (!updater.Update(row.edge_id.id(), row)) {
+          ++stat.dup_count;
+          continue;
+        }
+        stat.free_flow_count += row.field_count > vj::TrafficRow::kFreeFlowSpeed;
+        stat.constrained_count += row.field_count > vj::TrafficRow::kConstrainedFlowSpeed;
+        stat.compressed_count += row.has_coefficients;
+      }
+    }
+
+    // Write the updated directed edges and the predicted speeds
+    stat.updated_count += updater.Write();
+    LOG_INFO(thread_name.str() + " finished " + std::to_string(traffic_tile.tile_id) + "(" +
+             std::to_string(++done_tiles * 100.0 / traffic_tiles.size()) + ")");
   }
 
   result.set_value(stat);
@@ -320,7 +246,7 @@ int main(int argc, char** argv) {
   }
 
   // queue up all the work we'll be doing
-  std::unordered_map<GraphId, std::vector<std::string>> files_per_tile;
+  std::unordered_map<GraphId, SpeedFiles> files_per_tile;
   for (filesystem::recursive_directory_iterator i(traffic_tile_dir), end; i != end; ++i) {
     if (i->is_regular_file()) {
       // remove any extension
@@ -330,14 +256,20 @@ int main(int argc, char** argv) {
       try {
         // parse it into a tile id and store the file path with it
         auto id = GraphTile::GetTileId(file_name);
-        files_per_tile[id].push_back(i->path().string());
+        auto& traffic_tile = files_per_tile[id];
+        traffic_tile.tile_id = id;
+        traffic_tile.files.push_back(i->path().string());
+        traffic_tile.size += i->file_size();
       } catch (...) {}
     }
   }
-  std::vector<std::pair<GraphId, std::vector<std::string>>> traffic_tiles(files_per_tile.begin(),
-                                                                          files_per_tile.end());
-  std::random_device rd;
-  std::shuffle(traffic_tiles.begin(), traffic_tiles.end(), std::mt19937(rd()));
+  std::vector<SpeedFiles> traffic_tiles;
+  traffic_tiles.reserve(files_per_tile.size());
+  for (auto& traffic_tile : files_per_tile) {
+    traffic_tiles.emplace_back(std::move(traffic_tile.second));
+  }
+  std::sort(traffic_tiles.begin(), traffic_tiles.end(),
+            [](const SpeedFiles& a, const SpeedFiles& b) { return a.size > b.size; });
 
   LOG_INFO("Adding predicted traffic with " + std::to_string(num_threads) + " threads");
   std::vector<std::shared_ptr<std::thread>> threads(num_threads);
@@ -345,22 +277,16 @@ int main(int argc, char** argv) {
   std::cout << traffic_tile_dir << std::endl;
 
   LOG_INFO("Parsing speeds from " + std::to_string(traffic_tiles.size()) + " tiles.");
-  size_t floor = traffic_tiles.size() / threads.size();
-  size_t at_ceiling = traffic_tiles.size() - (threads.size() * floor);
-  decltype(traffic_tiles)::const_iterator tile_start, tile_end = traffic_tiles.begin();
   auto tile_dir = config.get<std::string>("mjolnir.tile_dir");
+  std::atomic<size_t> next_tile(0), done_tiles(0);
   // A place to hold the results of those threads (exceptions, stats)
   std::list<std::promise<stats>> results;
-  // Atomically pass around stats info
   for (size_t i = 0; i < threads.size(); ++i) {
-    // Where the range begins
-    tile_start = tile_end;
-    // Where the range ends
-    tile_end += (i < at_ceiling ? floor + 1 : floor);
     // Make the thread
     results.emplace_back();
-    threads[i].reset(
-        new std::thread(update_tiles, tile_dir, tile_start, tile_end, std::ref(results.back())));
+    threads[i].reset(new std::thread(update_tiles, tile_dir, std::cref(traffic_tiles),
+                                     std::ref(next_tile), std::ref(done_tiles),
+                                     std::ref(results.back())));
   }
 
   // wait for it to finish
@@ -1,3 +1,4 @@
+#include <chrono>
 #include <cinttypes>
 #include <cstdint>
 #include <future>
@@ -38,6 +39,7 @@
 #include "midgard/logging.h"
 #include "midgard/pointll.h"
 #include "midgard/util.h"
+#include "mjolnir/admin.h"
 #include "mjolnir/util.h"
 
 // sqlite is included in util.h and must be before spatialite
@@ -188,15 +190,42 @@ void Benchmark(const boost::property_tree::ptree& pt) {
   // Iterate through the tiles and perform enhancements
   std::unordered_map<uint32_t, multi_polygon_type> polys;
   std::unordered_map<uint32_t, bool> drive_on_right;
+  // time looking up the admin of every node against the polygons and against the index over them
+  using clock = std::chrono::steady_clock;
+  clock::duration scan_time{0}, index_time{0}, build_time{0};
+  uint64_t lookups = 0, mismatches = 0;
   for (uint32_t id = 0; id < tiles.TileCount(); id++) {
     // Get the admin polys if there is data for tiles that exist
     GraphId tile_id(id, local_level, 0);
     if (reader.DoesTileExist(tile_id)) {
-      polys = GetAdminInfo(db_handle, drive_on_right, tiles.TileBounds(id));
+      auto bounds = tiles.TileBounds(id);
+      polys = GetAdminInfo(db_handle, drive_on_right, bounds);
       LOG_INFO("polys: " + std::to_string(polys.size()));
       if (polys.size() < 128) {
         counts[polys.size()]++;
       }
+
+      graph_tile_ptr tile = reader.GetGraphTile(tile_id);
+      if (!tile) {
+        continue;
+      }
+      std::multimap<uint32_t, multi_polygon_type> ordered(polys.begin(), polys.end());
+      auto start = clock::now();
+      valhalla::mjolnir::PolygonIndex index(ordered, bounds);
+      build_time += clock::now() - start;
+
+      auto base_ll = tile->header()->base_ll();
+      for (uint32_t n = 0; n < tile->header()->nodecount(); ++n) {
+        auto ll = tile->node(n)->latlng(base_ll);
+        start = clock::now();
+        auto scanned = valhalla::mjolnir::GetMultiPolyId(ordered, ll);
+        auto middle = clock::now();
+        auto indexed = valhalla::mjolnir::GetMultiPolyId(index, ll);
+        index_time += clock::now() - middle;
+        scan_time += middle - start;
+        mismatches += scanned != indexed;
+        ++lookups;
+      }
     }
   }
   for (uint32_t i = 0; i < 128; i++) {
@@ -204,6 +233,17 @@ void Benchmark(const boost::property_tree::ptree& pt) {
       LOG_INFO("Tiles with " + std::to_string(i) + " admin polys: " + std::to_string(counts[i]));
     }
   }
+
+  auto ms = [](clock::duration d) {
+    return std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(d).count()) + " ms";
+  };
+  LOG_INFO("Node lookups: " + std::to_string(lookups));
+  LOG_INFO("Testing every polygon: " + ms(scan_time));
+  LOG_INFO("PolygonIndex: " + ms(index_time) + " plus " + ms(build_time) + " building the indices");
+  if (mismatches) {
+    LOG_ERROR("PolygonIndex disagreed with testing every polygon " + std::to_string(mismatches) +
+              " times");
+  }
 }
 
 bool ParseArguments(int argc, char* argv[]) {
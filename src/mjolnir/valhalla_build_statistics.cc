@@ -5,6 +5,7 @@
 #include "baldr/rapidjson_utils.h"
 #include <boost/format.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <chrono>
 #include <cxxopts.hpp>
 #include <future>
 #include <iostream>
@@ -36,6 +37,8 @@ using namespace valhalla::baldr;
 using namespace valhalla::mjolnir;
 
 filesystem::path config_file_path;
+std::string columns_dir;
+bool write_sqlite = false;
 
 namespace {
 
@@ -563,7 +566,19 @@ void BuildStatistics(const boost::property_tree::ptree& pt) {
   }
   LOG_INFO("Finished");
 
-  stats.build_db();
+  // the columns are what we always write, the database is much slower to make so its optional
+  auto seconds_since = [](std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - start;
+    return std::to_string(elapsed.count()) + "s";
+  };
+  auto start = std::chrono::steady_clock::now();
+  stats.build_columns(columns_dir);
+  LOG_INFO("Writing the columns took " + seconds_since(start));
+  if (write_sqlite) {
+    start = std::chrono::steady_clock::now();
+    stats.build_db();
+    LOG_INFO("Writing the database took " + seconds_since(start));
+  }
   stats.roulette_data.GenerateTasks(pt);
 }
 
@@ -572,12 +587,16 @@ bool ParseArguments(int argc, char* argv[]) {
     // clang-format off
     cxxopts::Options options("valhalla_build_statistics",
         "valhalla_build_statistics " VALHALLA_VERSION "\n\n"
-        "valhalla_build_statistics is a program that builds a statistics database.\n\n");
+        "valhalla_build_statistics is a program that gathers statistics about the roads in the\n"
+        "tiles and writes them as column files, one per table, and optionally as a spatialite\n"
+        "database.\n\n");
 
     options.add_options()
       ("h,help", "Print this help message")
       ("v,version", "Print the version of this software.")
-      ("c,config", "Path to the json configuration file.", cxxopts::value<std::string>());
+      ("c,config", "Path to the json configuration file.", cxxopts::value<std::string>())
+      ("o,output-dir", "Directory to write the statistics columns to.", cxxopts::value<std::string>(columns_dir)->default_value("statistics"))
+      ("s,sqlite", "Also write the statistics to the spatialite database statistics.sqlite.", cxxopts::value<bool>(write_sqlite));
     // clang-format on
 
     auto result = options.parse(argc, argv);
@@ -625,7 +644,12 @@ int main(int argc, char** argv) {
     valhalla::midgard::logging::Configure(loggin_config);
   }
 
-  BuildStatistics(pt);
+  try {
+    BuildStatistics(pt);
+  } catch (const std::exception& e) {
+    LOG_ERROR("Could not build the statistics: " + std::string(e.what()));
+    return EXIT_FAILURE;
+  }
 
   return EXIT_SUCCESS;
 }
@@ -2,10 +2,14 @@
 #include <vector>
 
 #include "config.h"
+#include "mjolnir/osmchange.h"
 #include "mjolnir/util.h"
 
 using namespace valhalla::mjolnir;
 
+#include "baldr/graphreader.h"
+#include "baldr/graphtile.h"
+#include "baldr/json.h"
 #include "baldr/rapidjson_utils.h"
 #include <boost/optional.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -16,13 +20,45 @@ using namespace valhalla::mjolnir;
 #include "midgard/logging.h"
 #include "midgard/util.h"
 
+// Print the tiles of the existing tile set that an osm change file touches
+bool list_changed_tiles(const boost::property_tree::ptree& pt, const std::string& osc_file) {
+  OSMChange change;
+  try {
+    change = OSMChange::Read(osc_file);
+  } catch (const std::exception& e) {
+    LOG_ERROR(osc_file + ": " + e.what());
+    return false;
+  }
+
+  valhalla::baldr::GraphReader reader(pt.get_child("mjolnir"));
+  auto changed_tiles = FindChangedTiles(reader, change);
+  auto tiles = [](const std::set<valhalla::baldr::GraphId>& tile_ids) {
+    auto files = valhalla::baldr::json::array({});
+    for (const auto& tile_id : tile_ids) {
+      files->emplace_back(valhalla::baldr::GraphTile::FileSuffix(tile_id));
+    }
+    return files;
+  };
+  std::cout << *valhalla::baldr::json::map({
+                   {"changed", tiles(changed_tiles.changed)},
+                   {"neighbors", tiles(changed_tiles.neighbors)},
+                   {"parents", tiles(changed_tiles.parents)},
+                   {"unlocated_ways", static_cast<uint64_t>(changed_tiles.unlocated_ways)},
+               })
+            << std::endl;
+  return true;
+}
+
 // List the build stages
 void list_stages() {
   std::cout << "Build stage strings (in order)" << std::endl;
-  for (int i = static_cast<int>(BuildStage::kInitialize); i <= static_cast<int>(BuildStage::kCleanup);
-       ++i) {
+  for (int i = static_cast<int>(BuildStage::kInitialize);
+       i <= static_cast<int>(BuildStage::kTimetable); ++i) {
     std::cout << "    " << to_string(static_cast<BuildStage>(i)) << std::endl;
   }
+  std::cout << "The stages after cleanup write sidecars for loki and thor, they only run when the"
+            << std::endl
+            << "end stage is set to one of them" << std::endl;
 }
 
 int main(int argc, char** argv) {
@@ -31,6 +67,7 @@ int main(int argc, char** argv) {
   std::vector<std::string> input_files;
   BuildStage start_stage = BuildStage::kInitialize;
   BuildStage end_stage = BuildStage::kCleanup;
+  std::string osc_file;
   boost::property_tree::ptree pt;
 
   try {
@@ -50,6 +87,7 @@ int main(int argc, char** argv) {
       ("i,inline-config", "Inline JSON config", cxxopts::value<std::string>())
       ("s,start", "Starting stage of the build pipeline", cxxopts::value<std::string>()->default_value("initialize"))
       ("e,end", "End stage of the build pipeline", cxxopts::value<std::string>()->default_value("cleanup"))
+      ("osc", "Instead of building, print which tiles of the existing tile set an OSM change file (.osc or .osc.gz) touches. Nothing is rebuilt, the list is for scripting partial updates", cxxopts::value<std::string>(osc_file))
       ("input_files", "positional arguments", cxxopts::value<std::vector<std::string>>(input_files));
     // clang-format on
 
@@ -120,6 +158,11 @@ int main(int argc, char** argv) {
       return EXIT_FAILURE;
     }
 
+    // nothing gets built for a change file
+    if (result.count("osc")) {
+      return list_changed_tiles(pt, osc_file) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     if (!result.count("input_files") && start_stage <= BuildStage::kParseNodes &&
         end_stage >= BuildStage::kParseWays) {
       std::cerr << "Input file is required\n\n" << options.help() << "\n\n";
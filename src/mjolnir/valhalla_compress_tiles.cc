@@ -0,0 +1,153 @@
+#include "baldr/rapidjson_utils.h"
+#include "config.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+#include "midgard/util.h"
+#include "mjolnir/tilecompressor.h"
+
+#include <cxxopts.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+namespace bpt = boost::property_tree;
+
+// args
+boost::property_tree::ptree config;
+valhalla::mjolnir::TileCompressor::Options compress_options;
+
+namespace {
+
+std::string megabytes(uint64_t bytes) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1) << bytes / (1024. * 1024.) << "MB";
+  return ss.str();
+}
+
+std::string ratio(uint64_t size, uint64_t compressed_size) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(2)
+     << (compressed_size ? static_cast<double>(size) / compressed_size : 0.) << "x";
+  return ss.str();
+}
+
+std::string seconds(double s) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3) << s << "s";
+  return ss.str();
+}
+
+} // namespace
+
+bool ParseArguments(int argc, char* argv[]) {
+  try {
+    // clang-format off
+    cxxopts::Options options(
+      "valhalla_compress_tiles",
+      "valhalla_compress_tiles " VALHALLA_VERSION "\n\n"
+      "valhalla_compress_tiles compresses the tiles in mjolnir.tile_dir with zstd. A dictionary\n"
+      "is trained on the tiles of each level and saved next to them as zstd.dict, the tiles are\n"
+      "then compressed with it to <tile>.gph.zst. The uncompressed tiles are removed unless they\n"
+      "are kept, they are read before the compressed ones if they are there. Running it again\n"
+      "after the tiles were rebuilt retrains the dictionaries and compresses everything again.\n\n");
+
+    options.add_options()
+      ("h,help", "Print this help message.")
+      ("v,version", "Print the version of this software.")
+      ("c,config", "Path to the json configuration file.", cxxopts::value<std::string>())
+      ("i,inline-config", "Inline json config.", cxxopts::value<std::string>())
+      ("j,concurrency", "Number of threads to use.", cxxopts::value<unsigned int>(compress_options.concurrency))
+      ("l,level", "zstd compression level.", cxxopts::value<int>(compress_options.level)->default_value("19"))
+      ("dictionary-size", "Largest size in bytes of the dictionary of each level.", cxxopts::value<size_t>(compress_options.dictionary_size)->default_value("112640"))
+      ("sample-size", "Bytes of tiles of each level to train its dictionary on.", cxxopts::value<size_t>(compress_options.sample_size)->default_value("67108864"))
+      ("k,keep", "Keep the uncompressed tiles.", cxxopts::value<bool>(compress_options.keep))
+      ("compare-gzip", "Also gzip the tiles to compare sizes and decompression times.", cxxopts::value<bool>(compress_options.compare_gzip));
+    // clang-format on
+
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+      std::cout << options.help() << "\n";
+      exit(0);
+    }
+
+    if (result.count("version")) {
+      std::cout << "valhalla_compress_tiles " << VALHALLA_VERSION << "\n";
+      exit(0);
+    }
+
+    // Read the config file
+    if (result.count("inline-config")) {
+      std::stringstream ss;
+      ss << result["inline-config"].as<std::string>();
+      rapidjson::read_json(ss, config);
+    } else if (result.count("config") &&
+               filesystem::is_regular_file(result["config"].as<std::string>())) {
+      rapidjson::read_json(result["config"].as<std::string>(), config);
+    } else {
+      std::cerr << "Configuration is required\n\n" << options.help() << "\n\n";
+      return false;
+    }
+
+    if (!config.get_optional<std::string>("mjolnir.tile_dir")) {
+      std::cerr << "The configuration has no mjolnir.tile_dir to compress\n";
+      return false;
+    }
+
+    return true;
+  } catch (cxxopts::OptionException& e) {
+    std::cerr << "Unable to parse command line options because: " << e.what() << "\n"
+              << "This is a bug, please report it at " PACKAGE_BUGREPORT << "\n";
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (!ParseArguments(argc, argv)) {
+    return EXIT_FAILURE;
+  }
+
+  // configure logging
+  boost::optional<boost::property_tree::ptree&> logging_subtree =
+      config.get_child_optional("mjolnir.logging");
+  if (logging_subtree) {
+    auto logging_config =
+        valhalla::midgard::ToMap<const boost::property_tree::ptree&,
+                                 std::unordered_map<std::string, std::string>>(logging_subtree.get());
+    valhalla::midgard::logging::Configure(logging_config);
+  }
+
+  std::vector<valhalla::mjolnir::TileCompressor::LevelStats> all_stats;
+  try {
+    auto tile_dir = config.get<std::string>("mjolnir.tile_dir");
+    all_stats = valhalla::mjolnir::TileCompressor::Compress(tile_dir, compress_options);
+  } catch (const std::exception& e) {
+    LOG_ERROR("Could not compress the tiles: " + std::string(e.what()));
+    return EXIT_FAILURE;
+  }
+
+  for (const auto& stats : all_stats) {
+    LOG_INFO("Level " + std::to_string(stats.level) + ": " + std::to_string(stats.tiles) +
+             " tiles, " + megabytes(stats.size) + " compressed to " + megabytes(stats.zstd_size) +
+             " (" + ratio(stats.size, stats.zstd_size) + ") with a " +
+             std::to_string(stats.dictionary_size) + " byte dictionary, decompressed in " +
+             seconds(stats.zstd_seconds));
+    if (compress_options.compare_gzip) {
+      LOG_INFO("Level " + std::to_string(stats.level) + ": gzip would be " +
+               megabytes(stats.gzip_size) + " (" + ratio(stats.size, stats.gzip_size) +
+               "), decompressed in " + seconds(stats.gzip_seconds));
+    }
+  }
+  if (all_stats.empty()) {
+    LOG_WARN("There were no uncompressed tiles to compress");
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,321 @@
+#include "baldr/graphreader.h"
+#include "baldr/rapidjson_utils.h"
+#include "baldr/traffictile.h"
+#include "config.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+#include "midgard/sequence.h"
+#include "midgard/util.h"
+
+#include <cxxopts.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vm = valhalla::midgard;
+namespace vb = valhalla::baldr;
+
+namespace bpt = boost::property_tree;
+
+// args
+boost::property_tree::ptree config;
+std::vector<std::string> update_files;
+bool replace = false;
+
+namespace {
+
+// Traffic tiles are written in place, in the memory map of the traffic extract
+class MappedTrafficMemory : public vb::GraphMemory {
+public:
+  MappedTrafficMemory(char* data_, size_t size_) {
+    data = data_;
+    size = size_;
+  }
+};
+
+// The new speeds of an update, per tile, as the edge index within the tile and its speed
+using batch_t = std::unordered_map<vb::GraphId, std::vector<std::pair<uint32_t, vb::TrafficSpeed>>>;
+
+// The traffic tiles in the extract we are updating
+struct traffic_extract_t {
+  vm::mem_map<char> mm;
+  std::unordered_map<vb::GraphId, vb::TrafficTile> tiles;
+  std::shared_ptr<vb::TrafficEpochs> epochs;
+  size_t single_buffered = 0;
+};
+
+// Maps the traffic extract and stamps the header of any tile that never had one, for example
+// those in the empty skeleton that valhalla_build_extract makes
+void load(const std::string& traffic_extract, traffic_extract_t& extract) {
+  // the double buffered tiles flip to an update once its published here
+  extract.epochs = vb::TrafficEpochs::Open(traffic_extract);
+  if (!extract.epochs) {
+    extract.epochs = std::make_shared<vb::TrafficEpochs>(traffic_extract, true);
+    LOG_WARN("Created the traffic epochs, services that loaded the traffic extract before need a "
+             "restart to not see updates halfway through");
+  }
+
+  vm::tar tar(traffic_extract);
+  extract.mm.map(traffic_extract, tar.mm.size());
+  vb::GraphReader reader(config.get_child("mjolnir"));
+  for (const auto& entry : tar.contents) {
+    vb::GraphId tile_id;
+    try {
+      tile_id = vb::GraphTile::GetTileId(entry.first);
+    } catch (...) { continue; }
+
+    if (entry.second.second < sizeof(vb::TrafficTileHeader)) {
+      LOG_WARN("Traffic tile " + entry.first + " is too small to hold a header");
+      continue;
+    }
+    auto* data = extract.mm.get() + (entry.second.first - tar.mm.get());
+    vb::TrafficTile tile(std::make_unique<MappedTrafficMemory>(data, entry.second.second));
+    if (tile.header->traffic_tile_version != vb::TRAFFIC_TILE_VERSION) {
+      auto graph_tile = reader.GetGraphTile(tile_id);
+      if (!graph_tile) {
+        LOG_WARN("No routing tile for traffic tile " + entry.first);
+        continue;
+      }
+      auto count = graph_tile->header()->directededgecount();
+      if (entry.second.second < sizeof(vb::TrafficTileHeader) + count * sizeof(vb::TrafficSpeed)) {
+        LOG_WARN("Traffic tile " + entry.first + " is too small for its " + std::to_string(count) +
+                 " edges");
+        continue;
+      }
+      *tile.header = vb::TrafficTileHeader{};
+      tile.header->tile_id = tile_id.value;
+      tile.header->directed_edge_count = count;
+      tile.header->traffic_tile_version = vb::TRAFFIC_TILE_VERSION;
+    }
+    extract.single_buffered += !tile.double_buffered();
+    extract.tiles.emplace(tile_id, std::move(tile));
+  }
+}
+
+// Parses a line of edge_id,speed[,congestion] where the edge id is either level/tileid/id or the
+// numeric value of the GraphId, the speed is in kph with empty meaning unknown and the optional
+// congestion goes from 0 for free flowing to 1 for standing still
+bool parse(const std::string& line, vb::GraphId& edge_id, vb::TrafficSpeed& speed) {
+  std::vector<std::string> columns;
+  std::stringstream ss(line);
+  for (std::string column; std::getline(ss, column, ',');) {
+    columns.emplace_back(std::move(column));
+  }
+  if (columns.size() < 2) {
+    return false;
+  }
+
+  try {
+    edge_id = columns[0].find('/') != std::string::npos ? vb::GraphId(columns[0])
+                                                        : vb::GraphId(std::stoull(columns[0]));
+    speed = vb::TrafficSpeed{vb::UNKNOWN_TRAFFIC_SPEED_RAW,
+                             vb::UNKNOWN_TRAFFIC_SPEED_RAW,
+                             vb::UNKNOWN_TRAFFIC_SPEED_RAW,
+                             vb::UNKNOWN_TRAFFIC_SPEED_RAW,
+                             255,
+                             255,
+                             0,
+                             0,
+                             0,
+                             false};
+    if (!columns[1].empty()) {
+      auto kph = std::min(std::max(std::stof(columns[1]), 0.f),
+                          static_cast<float>(vb::MAX_TRAFFIC_SPEED_KPH));
+      speed.overall_encoded_speed = speed.encoded_speed1 = static_cast<uint32_t>(kph + .5f) >> 1;
+    }
+    if (columns.size() > 2 && !columns[2].empty()) {
+      auto congestion = std::min(std::max(std::stof(columns[2]), 0.f), 1.f);
+      speed.congestion1 = 1 + static_cast<uint32_t>(std::round(congestion * 62));
+    }
+  } catch (...) { return false; }
+  return edge_id.Is_Valid();
+}
+
+// Writes one batch of updates into the traffic tiles and publishes it
+void publish(traffic_extract_t& extract, const batch_t& batch) {
+  auto now = static_cast<uint64_t>(std::time(nullptr));
+  auto epoch = extract.epochs->Begin();
+  size_t updated = 0;
+  for (auto& tile : extract.tiles) {
+    auto found = batch.find(tile.first);
+    if (!replace && found == batch.cend()) {
+      continue;
+    }
+
+    auto* speeds = tile.second.begin_update(epoch);
+    auto count = tile.second.header->directed_edge_count;
+    if (replace) {
+      // keep the incidents, those are not ours to change
+      for (uint32_t i = 0; i < count; ++i) {
+        speeds[i] = vb::TrafficSpeed{0, 0, 0, 0, 0, 0, 0, 0, 0, speeds[i].has_incidents != 0};
+      }
+    }
+    if (found != batch.cend()) {
+      for (const auto& update : found->second) {
+        if (update.first >= count) {
+          continue;
+        }
+        auto speed = update.second;
+        speed.has_incidents = speeds[update.first].has_incidents;
+        speeds[update.first] = speed;
+        ++updated;
+      }
+    }
+    tile.second.header->last_update = now;
+  }
+  extract.epochs->Publish(epoch);
+  LOG_INFO("Published " + std::to_string(updated) + " speeds as update " + std::to_string(epoch));
+}
+
+// Reads batches of updates from the stream, publishing each one when a blank line is read or the
+// stream ends so that a feed can keep streaming batches into the same process
+void ingest(std::istream& stream, traffic_extract_t& extract) {
+  batch_t batch;
+  size_t lines = 0, skipped = 0, unpublished = 0;
+  vb::GraphId edge_id;
+  vb::TrafficSpeed speed;
+  for (std::string line; std::getline(stream, line);) {
+    if (line.empty() || line == "\r") {
+      if (unpublished) {
+        publish(extract, batch);
+        batch.clear();
+        unpublished = 0;
+      }
+      continue;
+    }
+    ++lines;
+    ++unpublished;
+    if (!parse(line, edge_id, speed)) {
+      ++skipped;
+      continue;
+    }
+    batch[edge_id.Tile_Base()].emplace_back(edge_id.id(), speed);
+  }
+  if (unpublished) {
+    publish(extract, batch);
+  }
+  if (skipped) {
+    LOG_WARN("Skipped " + std::to_string(skipped) + " of " + std::to_string(lines) +
+             " lines which are not edge_id,speed[,congestion]");
+  }
+}
+
+} // namespace
+
+bool ParseArguments(int argc, char* argv[]) {
+  try {
+    // clang-format off
+    cxxopts::Options options(
+      "valhalla_ingest_traffic",
+      "valhalla_ingest_traffic " VALHALLA_VERSION "\n\n"
+      "valhalla_ingest_traffic writes live traffic speeds into the traffic extract while the\n"
+      "service is reading from it. Each line of the input is edge_id,speed[,congestion] where\n"
+      "the edge id is level/tileid/id or the numeric id, the speed is in kph (empty if unknown)\n"
+      "and the congestion goes from 0 to 1. A blank line or the end of the input publishes the\n"
+      "lines read since the last update so a feed can keep streaming updates on stdin. Double\n"
+      "buffered tiles, see --traffic-buffers of valhalla_build_extract, all flip to the new\n"
+      "speeds at once when an update is published in <traffic_extract>.epochs while other\n"
+      "tiles are updated in place.\n\n");
+
+    options.add_options()
+      ("h,help", "Print this help message.")
+      ("v,version", "Print the version of this software.")
+      ("c,config", "Path to the json configuration file.", cxxopts::value<std::string>())
+      ("i,inline-config", "Inline json config.", cxxopts::value<std::string>())
+      ("r,replace", "Drop the speeds of every edge that is not in the update.", cxxopts::value<bool>(replace))
+      ("files", "positional arguments", cxxopts::value<std::vector<std::string>>(update_files));
+    // clang-format on
+
+    options.parse_positional({"files"});
+    options.positional_help("Update files, stdin if none");
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+      std::cout << options.help() << "\n";
+      exit(0);
+    }
+
+    if (result.count("version")) {
+      std::cout << "valhalla_ingest_traffic " << VALHALLA_VERSION << "\n";
+      exit(0);
+    }
+
+    // Read the config file
+    if (result.count("inline-config")) {
+      std::stringstream ss;
+      ss << result["inline-config"].as<std::string>();
+      rapidjson::read_json(ss, config);
+    } else if (result.count("config") &&
+               filesystem::is_regular_file(result["config"].as<std::string>())) {
+      rapidjson::read_json(result["config"].as<std::string>(), config);
+    } else {
+      std::cerr << "Configuration is required\n\n" << options.help() << "\n\n";
+      return false;
+    }
+
+    if (!config.get_optional<std::string>("mjolnir.traffic_extract")) {
+      std::cerr << "The configuration has no mjolnir.traffic_extract to write to\n";
+      return false;
+    }
+
+    return true;
+  } catch (cxxopts::OptionException& e) {
+    std::cerr << "Unable to parse command line options because: " << e.what() << "\n"
+              << "This is a bug, please report it at " PACKAGE_BUGREPORT << "\n";
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (!ParseArguments(argc, argv)) {
+    return EXIT_FAILURE;
+  }
+
+  // configure logging
+  boost::optional<boost::property_tree::ptree&> logging_subtree =
+      config.get_child_optional("mjolnir.logging");
+  if (logging_subtree) {
+    auto logging_config =
+        valhalla::midgard::ToMap<const boost::property_tree::ptree&,
+                                 std::unordered_map<std::string, std::string>>(logging_subtree.get());
+    valhalla::midgard::logging::Configure(logging_config);
+  }
+
+  traffic_extract_t extract;
+  try {
+    load(config.get<std::string>("mjolnir.traffic_extract"), extract);
+  } catch (const std::exception& e) {
+    LOG_ERROR("Could not load the traffic extract: " + std::string(e.what()));
+    return EXIT_FAILURE;
+  }
+  LOG_INFO("Loaded " + std::to_string(extract.tiles.size()) + " traffic tiles");
+  if (extract.single_buffered) {
+    LOG_WARN(std::to_string(extract.single_buffered) +
+             " traffic tiles are not double buffered and will be updated in place");
+  }
+
+  if (update_files.empty()) {
+    ingest(std::cin, extract);
+  }
+  for (const auto& file : update_files) {
+    std::ifstream stream(file);
+    if (!stream) {
+      LOG_ERROR("Could not open " + file);
+      return EXIT_FAILURE;
+    }
+    ingest(stream, extract);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -1,7 +1,12 @@
+#include <atomic>
+#include <functional>
 #include <iostream>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "midgard/logging.h"
+#include "midgard/workerpool.h"
 #include "odin/directionsbuilder.h"
 #include "odin/enhancedtrippath.h"
 #include "odin/maneuversbuilder.h"
@@ -16,11 +21,42 @@ namespace {
 // Minimum edge length to verify heading (~3 feet)
 constexpr auto kMinEdgeLength = 0.001f;
 
+// Requests with at least this many legs, over all routes, have their legs built on multiple threads
+std::atomic<size_t> parallel_min_legs{valhalla::odin::DirectionsBuilder::kDefaultParallelMinLegs};
+// How many threads to build the legs with, 0 or 1 disables it
+std::atomic<size_t> parallel_threads{valhalla::odin::DirectionsBuilder::kDefaultParallelThreads};
+// The threads the legs of all requests are built on
+valhalla::midgard::SharedWorkerPool parallel_pool;
+
+/**
+ * Runs the given function for every leg index, handing the legs out one at a time to a bounded
+ * number of threads when there are enough of them. Legs vary a lot in size so rather than giving
+ * each thread a fixed chunk they take the next leg whenever they are done with one
+ * @param leg_count  the number of legs
+ * @param func       does the work for the leg index it is given
+ */
+void ForEachLeg(size_t leg_count, const std::function<void(size_t)>& func) {
+  size_t threads = parallel_threads.load(std::memory_order_relaxed);
+  if (threads < 2 || leg_count < 2 ||
+      leg_count < parallel_min_legs.load(std::memory_order_relaxed)) {
+    for (size_t i = 0; i < leg_count; ++i) {
+      func(i);
+    }
+    return;
+  }
+
+  // the pool hands the legs out one at a time and reports the error of the first leg that failed
+  parallel_pool.Get(threads)->ParallelFor(leg_count, func);
+}
+
 } // namespace
 
 namespace valhalla {
 namespace odin {
 
+constexpr size_t DirectionsBuilder::kDefaultParallelMinLegs;
+constexpr size_t DirectionsBuilder::kDefaultParallelThreads;
+
 // Returns the trip directions based on the specified directions options
 // and trip path. This method calls ManeuversBuilder::Build and
 // NarrativeBuilder::Build to form the maneuver list. This method
@@ -28,40 +64,58 @@ namespace odin {
 // trip directions.
 void DirectionsBuilder::Build(Api& api, const MarkupFormatter& markup_formatter) {
   const auto& options = api.options();
+
+  // Lay out the directions for all of the legs up front so that the legs, which dont depend on
+  // each other, can be filled out in any order and the output order is always the same
+  std::vector<std::pair<TripLeg*, DirectionsLeg*>> legs;
   for (auto& trip_route : *api.mutable_trip()->mutable_routes()) {
     auto& directions_route = *api.mutable_directions()->mutable_routes()->Add();
     for (auto& trip_path : *trip_route.mutable_legs()) {
-      auto& trip_directions = *directions_route.mutable_legs()->Add();
+      legs.emplace_back(&trip_path, directions_route.mutable_legs()->Add());
+    }
+  }
 
-      // Validate trip path node list
-      if (trip_path.node_size() < 1) {
-        throw valhalla_exception_t{210};
-      }
+  ForEachLeg(legs.size(), [&](size_t i) {
+    auto& trip_path = *legs[i].first;
+    auto& trip_directions = *legs[i].second;
 
-      // Create an enhanced trip path from the specified trip_path
-      EnhancedTripLeg etp(trip_path);
+    // Validate trip path node list
+    if (trip_path.node_size() < 1) {
+      throw valhalla_exception_t{210};
+    }
 
-      // Produce maneuvers if desired
-      std::list<Maneuver> maneuvers;
-      if (options.directions_type() != DirectionsType::none) {
-        // Update the heading of ~0 length edges
-        UpdateHeading(&etp);
+    // Create an enhanced trip path from the specified trip_path
+    EnhancedTripLeg etp(trip_path);
 
-        ManeuversBuilder maneuversBuilder(options, &etp);
-        maneuvers = maneuversBuilder.Build();
+    // Produce maneuvers if desired
+    std::list<Maneuver> maneuvers;
+    if (options.directions_type() != DirectionsType::none) {
+      // Update the heading of ~0 length edges
+      UpdateHeading(&etp);
 
-        // Create the instructions if desired
-        if (options.directions_type() == DirectionsType::instructions) {
-          std::unique_ptr<NarrativeBuilder> narrative_builder =
-              NarrativeBuilderFactory::Create(options, &etp, markup_formatter);
-          narrative_builder->Build(maneuvers);
-        }
-      }
+      ManeuversBuilder maneuversBuilder(options, &etp);
+      maneuvers = maneuversBuilder.Build();
 
-      // Return trip directions
-      PopulateDirectionsLeg(options, &etp, maneuvers, trip_directions);
+      // Create the instructions if desired
+      if (options.directions_type() == DirectionsType::instructions) {
+        std::unique_ptr<NarrativeBuilder> narrative_builder =
+            NarrativeBuilderFactory::Create(options, &etp, markup_formatter);
+        narrative_builder->Build(maneuvers);
+      }
     }
-  }
+
+    // Return trip directions
+    PopulateDirectionsLeg(options, &etp, maneuvers, trip_directions);
+  });
+}
+
+void DirectionsBuilder::Configure(const boost::property_tree::ptree& config) {
+  parallel_min_legs.store(config.get<size_t>("odin.directions_parallel_min_legs",
+                                             kDefaultParallelMinLegs),
+                          std::memory_order_relaxed);
+  parallel_threads.store(config.get<size_t>("odin.directions_parallel_threads",
+                                            kDefaultParallelThreads),
+                         std::memory_order_relaxed);
 }
 
 // Update the heading of ~0 length edges.
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <stdexcept>
 
 #include <boost/property_tree/ptree.hpp>
@@ -35,6 +36,65 @@ std::unordered_map<K, V> as_unordered_map(boost::property_tree::ptree const& pt,
 namespace valhalla {
 namespace odin {
 
+PhraseTemplate::PhraseTemplate(const std::string& phrase) {
+  size_t pos = 0;
+  while (pos < phrase.size()) {
+    // A tag is an upper case name with underscores in angle brackets
+    size_t begin = phrase.find('<', pos);
+    size_t end = begin == std::string::npos
+                     ? std::string::npos
+                     : phrase.find_first_not_of("ABCDEFGHIJKLMNOPQRSTUVWXYZ_", begin + 1);
+    bool tag = end != std::string::npos && end > begin + 1 && phrase[end] == '>';
+
+    // Everything up to the tag, or the bracket if it isnt a tag, is literal text
+    size_t literal_end = begin == std::string::npos ? phrase.size() : (tag ? begin : begin + 1);
+    if (literal_end > pos) {
+      if (!parts_.empty() && !parts_.back().tag) {
+        parts_.back().text.append(phrase, pos, literal_end - pos);
+      } else {
+        parts_.push_back({phrase.substr(pos, literal_end - pos), false});
+      }
+      literal_size_ += literal_end - pos;
+    }
+    pos = literal_end;
+
+    if (tag) {
+      parts_.push_back({phrase.substr(begin, end + 1 - begin), true});
+      pos = end + 1;
+    }
+  }
+
+  // An empty phrase is still a phrase
+  if (parts_.empty()) {
+    parts_.push_back({"", false});
+  }
+}
+
+std::string PhraseTemplate::Fill(Values values) const {
+  // Size the result up front so that it is only allocated once
+  size_t size = literal_size_;
+  for (const auto& value : values) {
+    size += value.second.size();
+  }
+  std::string result;
+  result.reserve(size);
+
+  for (const auto& part : parts_) {
+    if (part.tag) {
+      auto value = std::find_if(values.begin(), values.end(),
+                                [&part](const std::pair<const char*, const std::string&>& value) {
+                                  return part.text == value.first;
+                                });
+      if (value != values.end()) {
+        result.append(value->second);
+        continue;
+      }
+    }
+    result.append(part.text);
+  }
+  return result;
+}
+
 NarrativeDictionary::NarrativeDictionary(const std::string& language_tag,
                                          const boost::property_tree::ptree& narrative_pt) {
   this->language_tag = language_tag;
@@ -320,6 +380,20 @@ void NarrativeDictionary::Load(PhraseSet& phrase_handle,
                                const boost::property_tree::ptree& phrase_pt) {
 
   phrase_handle.phrases = as_unordered_map<std::string, std::string>(phrase_pt, kPhrasesKey);
+
+  // Compile the phrases with a numeric id for the narrative builder
+  phrase_handle.templates.clear();
+  for (const auto& phrase : phrase_handle.phrases) {
+    if (phrase.first.empty() ||
+        phrase.first.find_first_not_of("0123456789") != std::string::npos) {
+      continue;
+    }
+    size_t phrase_id = std::stoul(phrase.first);
+    if (phrase_id >= phrase_handle.templates.size()) {
+      phrase_handle.templates.resize(phrase_id + 1);
+    }
+    phrase_handle.templates[phrase_id] = PhraseTemplate(phrase.second);
+  }
 }
 
 void NarrativeDictionary::Load(StartSubset& start_handle,
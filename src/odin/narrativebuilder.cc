@@ -46,451 +46,526 @@ NarrativeBuilder::NarrativeBuilder(const Options& options,
                                    const NarrativeDictionary& dictionary,
                                    const MarkupFormatter& markup_formatter)
     : options_(options), trip_path_(trip_path), dictionary_(dictionary),
-      markup_formatter_(markup_formatter), articulated_preposition_enabled_(false) {
+      markup_formatter_(markup_formatter), articulated_preposition_enabled_(false),
+      verbal_(options.has_verbal_instructions_case() ? options.verbal_instructions() : true) {
 }
 
 void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
   Maneuver* prev_maneuver = nullptr;
   for (auto& maneuver : maneuvers) {
-    switch (maneuver.type()) {
-      case DirectionsLeg_Maneuver_Type_kStartRight:
-      case DirectionsLeg_Maneuver_Type_kStart:
-      case DirectionsLeg_Maneuver_Type_kStartLeft:
-      case DirectionsLeg_Maneuver_Type_kFerryExit:
-      case DirectionsLeg_Maneuver_Type_kPostTransitConnectionDestination: {
-        // Set instruction
-        maneuver.set_instruction(FormStartInstruction(maneuver));
-
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctStartTransitionInstruction(maneuver));
+    FormInstructions(maneuver, prev_maneuver);
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalStartInstruction(maneuver));
+    // Skip the verbal variants when the request doesnt want them
+    if (verbal_) {
+      FormVerbalInstructions(maneuver, prev_maneuver);
+    }
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kDestinationRight:
-      case DirectionsLeg_Maneuver_Type_kDestination:
-      case DirectionsLeg_Maneuver_Type_kDestinationLeft: {
-        // Set instruction
-        maneuver.set_instruction(FormDestinationInstruction(maneuver));
+    maneuver.set_instruction(FormBssManeuverType(maneuver.bss_maneuver_type()) +
+                             maneuver.instruction());
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            FormVerbalAlertDestinationInstruction(maneuver));
+    // Update previous maneuver
+    prev_maneuver = &maneuver;
+  }
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalDestinationInstruction(maneuver));
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kBecomes: {
-        if (prev_maneuver) {
-          // Set instruction
-          maneuver.set_instruction(FormBecomesInstruction(maneuver, prev_maneuver));
-
-          // Set verbal pre transition instruction
-          maneuver.set_verbal_pre_transition_instruction(
-              FormVerbalBecomesInstruction(maneuver, prev_maneuver));
-        }
+  // Iterate over maneuvers to form verbal multi-cue instructions
+  if (verbal_) {
+    FormVerbalMultiCue(maneuvers);
+  }
+}
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver,
-                                                maneuver
-                                                    .HasBeginStreetNames())); // Set verbal succinct
-                                                                              // transition
-                                                                              // instruction
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kSlightRight:
-      case DirectionsLeg_Maneuver_Type_kSlightLeft:
-      case DirectionsLeg_Maneuver_Type_kRight:
-      case DirectionsLeg_Maneuver_Type_kSharpRight:
-      case DirectionsLeg_Maneuver_Type_kSharpLeft:
-      case DirectionsLeg_Maneuver_Type_kLeft: {
+void NarrativeBuilder::FormInstructions(Maneuver& maneuver, Maneuver* prev_maneuver) {
+  switch (maneuver.type()) {
+    case DirectionsLeg_Maneuver_Type_kStartRight:
+    case DirectionsLeg_Maneuver_Type_kStart:
+    case DirectionsLeg_Maneuver_Type_kStartLeft:
+    case DirectionsLeg_Maneuver_Type_kFerryExit:
+    case DirectionsLeg_Maneuver_Type_kPostTransitConnectionDestination: {
+      // Set instruction
+      maneuver.set_instruction(FormStartInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kDestinationRight:
+    case DirectionsLeg_Maneuver_Type_kDestination:
+    case DirectionsLeg_Maneuver_Type_kDestinationLeft: {
+      // Set instruction
+      maneuver.set_instruction(FormDestinationInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kBecomes: {
+      if (prev_maneuver) {
         // Set instruction
-        maneuver.set_instruction(FormTurnInstruction(maneuver));
-
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctTurnTransitionInstruction(maneuver));
-
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertTurnInstruction(maneuver));
-
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalTurnInstruction(maneuver));
-
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
-        break;
+        maneuver.set_instruction(FormBecomesInstruction(maneuver, prev_maneuver));
       }
-      case DirectionsLeg_Maneuver_Type_kUturnRight:
-      case DirectionsLeg_Maneuver_Type_kUturnLeft: {
-        // Set instruction
-        maneuver.set_instruction(FormUturnInstruction(maneuver));
-
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctUturnTransitionInstruction(maneuver));
-
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertUturnInstruction(maneuver));
-
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalUturnInstruction(maneuver));
-
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kRampStraight: {
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kSlightRight:
+    case DirectionsLeg_Maneuver_Type_kSlightLeft:
+    case DirectionsLeg_Maneuver_Type_kRight:
+    case DirectionsLeg_Maneuver_Type_kSharpRight:
+    case DirectionsLeg_Maneuver_Type_kSharpLeft:
+    case DirectionsLeg_Maneuver_Type_kLeft: {
+      // Set instruction
+      maneuver.set_instruction(FormTurnInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kUturnRight:
+    case DirectionsLeg_Maneuver_Type_kUturnLeft: {
+      // Set instruction
+      maneuver.set_instruction(FormUturnInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kRampStraight: {
+      // Set instruction
+      maneuver.set_instruction(FormRampStraightInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kRampRight:
+    case DirectionsLeg_Maneuver_Type_kRampLeft: {
+      // Set instruction
+      maneuver.set_instruction(FormRampInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kExitRight:
+    case DirectionsLeg_Maneuver_Type_kExitLeft: {
+      // Set instruction
+      maneuver.set_instruction(FormExitInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kStayStraight:
+    case DirectionsLeg_Maneuver_Type_kStayRight:
+    case DirectionsLeg_Maneuver_Type_kStayLeft: {
+      if (maneuver.to_stay_on()) {
+        // Set stay on instruction
+        maneuver.set_instruction(FormKeepToStayOnInstruction(maneuver));
+      } else {
         // Set instruction
-        maneuver.set_instruction(FormRampStraightInstruction(maneuver));
-
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            FormVerbalAlertRampStraightInstruction(maneuver));
-
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalRampStraightInstruction(maneuver));
-
-        // Only set verbal post if > min ramp length
-        // or contains obvious maneuver
-        // or has collapsed merge maneuver
-        if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
-            maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
-          // Set verbal post transition instruction
-          maneuver.set_verbal_post_transition_instruction(
-              FormVerbalPostTransitionInstruction(maneuver));
-        }
-        break;
+        maneuver.set_instruction(FormKeepInstruction(maneuver));
       }
-      case DirectionsLeg_Maneuver_Type_kRampRight:
-      case DirectionsLeg_Maneuver_Type_kRampLeft: {
-        // Set instruction
-        maneuver.set_instruction(FormRampInstruction(maneuver));
-
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertRampInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kMerge:
+    case DirectionsLeg_Maneuver_Type_kMergeRight:
+    case DirectionsLeg_Maneuver_Type_kMergeLeft: {
+      // Set instruction
+      maneuver.set_instruction(FormMergeInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kRoundaboutEnter: {
+      // Set instruction
+      maneuver.set_instruction(FormEnterRoundaboutInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kRoundaboutExit: {
+      // Set instruction
+      maneuver.set_instruction(FormExitRoundaboutInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kFerryEnter: {
+      // Set instruction
+      maneuver.set_instruction(FormEnterFerryInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransitConnectionStart: {
+      // Set instruction
+      maneuver.set_instruction(FormTransitConnectionStartInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransitConnectionTransfer: {
+      // Set instruction
+      maneuver.set_instruction(FormTransitConnectionTransferInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransitConnectionDestination: {
+      // Set instruction
+      maneuver.set_instruction(FormTransitConnectionDestinationInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransit: {
+      // Set depart instruction
+      maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalRampInstruction(maneuver));
+      // Set instruction
+      maneuver.set_instruction(FormTransitInstruction(maneuver));
 
-        // Only set verbal post if > min ramp length
-        // or contains obvious maneuver
-        // or has collapsed merge maneuver
-        if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
-            maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
-          // Set verbal post transition instruction
-          maneuver.set_verbal_post_transition_instruction(
-              FormVerbalPostTransitionInstruction(maneuver));
-        }
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kExitRight:
-      case DirectionsLeg_Maneuver_Type_kExitLeft: {
-        // Set instruction
-        maneuver.set_instruction(FormExitInstruction(maneuver));
+      // Set arrive instruction
+      maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransitRemainOn: {
+      // Set depart instruction
+      maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertExitInstruction(maneuver));
+      // Set instruction
+      maneuver.set_instruction(FormTransitRemainOnInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalExitInstruction(maneuver));
+      // Set arrive instruction
+      maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransitTransfer: {
+      // Set depart instruction
+      maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
 
-        // Only set verbal post if > min ramp length
-        // or contains obvious maneuver
-        // or has collapsed merge maneuver
-        if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
-            maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
-          // Set verbal post transition instruction
-          maneuver.set_verbal_post_transition_instruction(
-              FormVerbalPostTransitionInstruction(maneuver));
-        }
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kStayStraight:
-      case DirectionsLeg_Maneuver_Type_kStayRight:
-      case DirectionsLeg_Maneuver_Type_kStayLeft: {
-        if (maneuver.to_stay_on()) {
-          // Set stay on instruction
-          maneuver.set_instruction(FormKeepToStayOnInstruction(maneuver));
-
-          // Set verbal transition alert instruction
-          maneuver.set_verbal_transition_alert_instruction(
-              FormVerbalAlertKeepToStayOnInstruction(maneuver));
-
-          // Set verbal pre transition instruction
-          maneuver.set_verbal_pre_transition_instruction(FormVerbalKeepToStayOnInstruction(maneuver));
-
-          // For a ramp - only set verbal post if > min ramp length
-          if (maneuver.ramp() && !maneuver.has_collapsed_merge_maneuver()) {
-            if (maneuver.length() > kVerbalPostMinimumRampLength) {
-              // Set verbal post transition instruction
-              maneuver.set_verbal_post_transition_instruction(
-                  FormVerbalPostTransitionInstruction(maneuver));
-            }
-          } else {
-            // Set verbal post transition instruction
-            maneuver.set_verbal_post_transition_instruction(
-                FormVerbalPostTransitionInstruction(maneuver));
-          }
-        } else {
-          // Set instruction
-          maneuver.set_instruction(FormKeepInstruction(maneuver));
-
-          // Set verbal transition alert instruction
-          maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertKeepInstruction(maneuver));
-
-          // Set verbal pre transition instruction
-          maneuver.set_verbal_pre_transition_instruction(FormVerbalKeepInstruction(maneuver));
-
-          // For a ramp - only set verbal post if > min ramp length
-          if (maneuver.ramp() && !maneuver.has_collapsed_merge_maneuver()) {
-            if (maneuver.length() > kVerbalPostMinimumRampLength) {
-              // Set verbal post transition instruction
-              maneuver.set_verbal_post_transition_instruction(
-                  FormVerbalPostTransitionInstruction(maneuver));
-            }
-          } else {
-            // Set verbal post transition instruction
-            maneuver.set_verbal_post_transition_instruction(
-                FormVerbalPostTransitionInstruction(maneuver));
-          }
-        }
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kMerge:
-      case DirectionsLeg_Maneuver_Type_kMergeRight:
-      case DirectionsLeg_Maneuver_Type_kMergeLeft: {
-        // Set instruction
-        maneuver.set_instruction(FormMergeInstruction(maneuver));
+      // Set instruction
+      maneuver.set_instruction(FormTransitTransferInstruction(maneuver));
 
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctMergeTransitionInstruction(maneuver));
+      // Set arrive instruction
+      maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kContinue:
+    default: {
+      // Set instruction
+      maneuver.set_instruction(FormContinueInstruction(maneuver));
+      break;
+    }
+  }
+}
 
-        // Set verbal transition alert instruction if previous maneuver
-        // is greater than 2 km
-        if (prev_maneuver && (prev_maneuver->length(Options::kilometers) >
-                              kVerbalAlertMergePriorManeuverMinimumLength)) {
-          maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertMergeInstruction(maneuver));
-        }
+void NarrativeBuilder::FormVerbalInstructions(Maneuver& maneuver, Maneuver* prev_maneuver) {
+  switch (maneuver.type()) {
+    case DirectionsLeg_Maneuver_Type_kStartRight:
+    case DirectionsLeg_Maneuver_Type_kStart:
+    case DirectionsLeg_Maneuver_Type_kStartLeft:
+    case DirectionsLeg_Maneuver_Type_kFerryExit:
+    case DirectionsLeg_Maneuver_Type_kPostTransitConnectionDestination: {
+      // Set verbal succinct transition instruction
+      maneuver.set_verbal_succinct_transition_instruction(
+          FormVerbalSuccinctStartTransitionInstruction(maneuver));
+
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalStartInstruction(maneuver));
+
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kDestinationRight:
+    case DirectionsLeg_Maneuver_Type_kDestination:
+    case DirectionsLeg_Maneuver_Type_kDestinationLeft: {
+      // Set verbal transition alert instruction
+      maneuver.set_verbal_transition_alert_instruction(
+          FormVerbalAlertDestinationInstruction(maneuver));
 
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalDestinationInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kBecomes: {
+      if (prev_maneuver) {
         // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalMergeInstruction(maneuver));
-
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
-        break;
+        maneuver.set_verbal_pre_transition_instruction(
+            FormVerbalBecomesInstruction(maneuver, prev_maneuver));
       }
-      case DirectionsLeg_Maneuver_Type_kRoundaboutEnter: {
-        // Set instruction
-        maneuver.set_instruction(FormEnterRoundaboutInstruction(maneuver));
 
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctEnterRoundaboutTransitionInstruction(maneuver));
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kSlightRight:
+    case DirectionsLeg_Maneuver_Type_kSlightLeft:
+    case DirectionsLeg_Maneuver_Type_kRight:
+    case DirectionsLeg_Maneuver_Type_kSharpRight:
+    case DirectionsLeg_Maneuver_Type_kSharpLeft:
+    case DirectionsLeg_Maneuver_Type_kLeft: {
+      // Set verbal succinct transition instruction
+      maneuver.set_verbal_succinct_transition_instruction(
+          FormVerbalSuccinctTurnTransitionInstruction(maneuver));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            FormVerbalAlertEnterRoundaboutInstruction(maneuver));
+      // Set verbal transition alert instruction
+      maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertTurnInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalEnterRoundaboutInstruction(maneuver));
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalTurnInstruction(maneuver));
 
-        // If the maneuver has a combined enter exit roundabout instruction
-        // then set verbal post transition instruction
-        if (maneuver.has_combined_enter_exit_roundabout()) {
-          maneuver.set_verbal_post_transition_instruction(
-              FormVerbalPostTransitionInstruction(maneuver,
-                                                  maneuver.HasRoundaboutExitBeginStreetNames()));
-        }
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kRoundaboutExit: {
-        // Set instruction
-        maneuver.set_instruction(FormExitRoundaboutInstruction(maneuver));
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kUturnRight:
+    case DirectionsLeg_Maneuver_Type_kUturnLeft: {
+      // Set verbal succinct transition instruction
+      maneuver.set_verbal_succinct_transition_instruction(
+          FormVerbalSuccinctUturnTransitionInstruction(maneuver));
 
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctExitRoundaboutTransitionInstruction(maneuver));
+      // Set verbal transition alert instruction
+      maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertUturnInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalExitRoundaboutInstruction(maneuver));
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalUturnInstruction(maneuver));
 
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kRampStraight: {
+      // Set verbal transition alert instruction
+      maneuver.set_verbal_transition_alert_instruction(
+          FormVerbalAlertRampStraightInstruction(maneuver));
+
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalRampStraightInstruction(maneuver));
+
+      // Only set verbal post if > min ramp length
+      // or contains obvious maneuver
+      // or has collapsed merge maneuver
+      if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
+          maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
         // Set verbal post transition instruction
         maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
-        break;
+            FormVerbalPostTransitionInstruction(maneuver));
       }
-      case DirectionsLeg_Maneuver_Type_kFerryEnter: {
-        // Set instruction
-        maneuver.set_instruction(FormEnterFerryInstruction(maneuver));
-
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            FormVerbalAlertEnterFerryInstruction(maneuver));
-
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalEnterFerryInstruction(maneuver));
-
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kRampRight:
+    case DirectionsLeg_Maneuver_Type_kRampLeft: {
+      // Set verbal transition alert instruction
+      maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertRampInstruction(maneuver));
+
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalRampInstruction(maneuver));
+
+      // Only set verbal post if > min ramp length
+      // or contains obvious maneuver
+      // or has collapsed merge maneuver
+      if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
+          maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
         // Set verbal post transition instruction
         maneuver.set_verbal_post_transition_instruction(
             FormVerbalPostTransitionInstruction(maneuver));
-        break;
       }
-      case DirectionsLeg_Maneuver_Type_kTransitConnectionStart: {
-        // Set instruction
-        maneuver.set_instruction(FormTransitConnectionStartInstruction(maneuver));
-
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalTransitConnectionStartInstruction(maneuver));
-
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kExitRight:
+    case DirectionsLeg_Maneuver_Type_kExitLeft: {
+      // Set verbal transition alert instruction
+      maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertExitInstruction(maneuver));
+
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalExitInstruction(maneuver));
+
+      // Only set verbal post if > min ramp length
+      // or contains obvious maneuver
+      // or has collapsed merge maneuver
+      if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
+          maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
         // Set verbal post transition instruction
         maneuver.set_verbal_post_transition_instruction(
             FormVerbalPostTransitionInstruction(maneuver));
-        break;
       }
-      case DirectionsLeg_Maneuver_Type_kTransitConnectionTransfer: {
-        // Set instruction
-        maneuver.set_instruction(FormTransitConnectionTransferInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kStayStraight:
+    case DirectionsLeg_Maneuver_Type_kStayRight:
+    case DirectionsLeg_Maneuver_Type_kStayLeft: {
+      if (maneuver.to_stay_on()) {
+        // Set verbal transition alert instruction
+        maneuver.set_verbal_transition_alert_instruction(
+            FormVerbalAlertKeepToStayOnInstruction(maneuver));
 
         // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalTransitConnectionTransferInstruction(maneuver));
+        maneuver.set_verbal_pre_transition_instruction(FormVerbalKeepToStayOnInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kTransitConnectionDestination: {
-        // Set instruction
-        maneuver.set_instruction(FormTransitConnectionDestinationInstruction(maneuver));
+        // For a ramp - only set verbal post if > min ramp length
+        if (maneuver.ramp() && !maneuver.has_collapsed_merge_maneuver()) {
+          if (maneuver.length() > kVerbalPostMinimumRampLength) {
+            // Set verbal post transition instruction
+            maneuver.set_verbal_post_transition_instruction(
+                FormVerbalPostTransitionInstruction(maneuver));
+          }
+        } else {
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver));
+        }
+      } else {
+        // Set verbal transition alert instruction
+        maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertKeepInstruction(maneuver));
 
         // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalTransitConnectionDestinationInstruction(maneuver));
+        maneuver.set_verbal_pre_transition_instruction(FormVerbalKeepInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
-        break;
+        // For a ramp - only set verbal post if > min ramp length
+        if (maneuver.ramp() && !maneuver.has_collapsed_merge_maneuver()) {
+          if (maneuver.length() > kVerbalPostMinimumRampLength) {
+            // Set verbal post transition instruction
+            maneuver.set_verbal_post_transition_instruction(
+                FormVerbalPostTransitionInstruction(maneuver));
+          }
+        } else {
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver));
+        }
+      }
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kMerge:
+    case DirectionsLeg_Maneuver_Type_kMergeRight:
+    case DirectionsLeg_Maneuver_Type_kMergeLeft: {
+      // Set verbal succinct transition instruction
+      maneuver.set_verbal_succinct_transition_instruction(
+          FormVerbalSuccinctMergeTransitionInstruction(maneuver));
+
+      // Set verbal transition alert instruction if previous maneuver
+      // is greater than 2 km
+      if (prev_maneuver && (prev_maneuver->length(Options::kilometers) >
+                            kVerbalAlertMergePriorManeuverMinimumLength)) {
+        maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertMergeInstruction(maneuver));
       }
-      case DirectionsLeg_Maneuver_Type_kTransit: {
-        // Set depart instruction
-        maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
-
-        // Set verbal depart instruction
-        maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
-
-        // Set instruction
-        maneuver.set_instruction(FormTransitInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalTransitInstruction(maneuver));
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalMergeInstruction(maneuver));
 
-        // Set verbal post transition instruction
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kRoundaboutEnter: {
+      // Set verbal succinct transition instruction
+      maneuver.set_verbal_succinct_transition_instruction(
+          FormVerbalSuccinctEnterRoundaboutTransitionInstruction(maneuver));
+
+      // Set verbal transition alert instruction
+      maneuver.set_verbal_transition_alert_instruction(
+          FormVerbalAlertEnterRoundaboutInstruction(maneuver));
+
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(
+          FormVerbalEnterRoundaboutInstruction(maneuver));
+
+      // If the maneuver has a combined enter exit roundabout instruction
+      // then set verbal post transition instruction
+      if (maneuver.has_combined_enter_exit_roundabout()) {
         maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionTransitInstruction(maneuver));
-
-        // Set arrive instruction
-        maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
-
-        // Set verbal arrive instruction
-        maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
-
-        break;
+            FormVerbalPostTransitionInstruction(maneuver,
+                                                maneuver.HasRoundaboutExitBeginStreetNames()));
       }
-      case DirectionsLeg_Maneuver_Type_kTransitRemainOn: {
-        // Set depart instruction
-        maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kRoundaboutExit: {
+      // Set verbal succinct transition instruction
+      maneuver.set_verbal_succinct_transition_instruction(
+          FormVerbalSuccinctExitRoundaboutTransitionInstruction(maneuver));
 
-        // Set verbal depart instruction
-        maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalExitRoundaboutInstruction(maneuver));
 
-        // Set instruction
-        maneuver.set_instruction(FormTransitRemainOnInstruction(maneuver));
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kFerryEnter: {
+      // Set verbal transition alert instruction
+      maneuver.set_verbal_transition_alert_instruction(
+          FormVerbalAlertEnterFerryInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalTransitRemainOnInstruction(maneuver));
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalEnterFerryInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionTransitInstruction(maneuver));
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransitConnectionStart: {
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(
+          FormVerbalTransitConnectionStartInstruction(maneuver));
+
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransitConnectionTransfer: {
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(
+          FormVerbalTransitConnectionTransferInstruction(maneuver));
+
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransitConnectionDestination: {
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(
+          FormVerbalTransitConnectionDestinationInstruction(maneuver));
+
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransit: {
+      // Set verbal depart instruction
+      maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
 
-        // Set arrive instruction
-        maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalTransitInstruction(maneuver));
 
-        // Set verbal arrive instruction
-        maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionTransitInstruction(maneuver));
 
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kTransitTransfer: {
-        // Set depart instruction
-        maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
+      // Set verbal arrive instruction
+      maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransitRemainOn: {
+      // Set verbal depart instruction
+      maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
 
-        // Set verbal depart instruction
-        maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(
+          FormVerbalTransitRemainOnInstruction(maneuver));
 
-        // Set instruction
-        maneuver.set_instruction(FormTransitTransferInstruction(maneuver));
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionTransitInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalTransitTransferInstruction(maneuver));
+      // Set verbal arrive instruction
+      maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kTransitTransfer: {
+      // Set verbal depart instruction
+      maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionTransitInstruction(maneuver));
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(
+          FormVerbalTransitTransferInstruction(maneuver));
 
-        // Set arrive instruction
-        maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionTransitInstruction(maneuver));
 
-        // Set verbal arrive instruction
-        maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kContinue:
-      default: {
-        // Set instruction
-        maneuver.set_instruction(FormContinueInstruction(maneuver));
-
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            FormVerbalAlertContinueInstruction(maneuver));
+      // Set verbal arrive instruction
+      maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
+      break;
+    }
+    case DirectionsLeg_Maneuver_Type_kContinue:
+    default: {
+      // Set verbal transition alert instruction
+      maneuver.set_verbal_transition_alert_instruction(
+          FormVerbalAlertContinueInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalContinueInstruction(maneuver));
+      // Set verbal pre transition instruction
+      maneuver.set_verbal_pre_transition_instruction(FormVerbalContinueInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
-        break;
-      }
+      // Set verbal post transition instruction
+      maneuver.set_verbal_post_transition_instruction(
+          FormVerbalPostTransitionInstruction(maneuver));
+      break;
     }
-    maneuver.set_instruction(FormBssManeuverType(maneuver.bss_maneuver_type()) +
-                             maneuver.instruction());
-
-    // Update previous maneuver
-    prev_maneuver = &maneuver;
   }
-
-  // Iterate over maneuvers to form verbal multi-cue instructions
-  FormVerbalMultiCue(maneuvers);
 }
 
 std::string NarrativeBuilder::FormVerbalAlertApproachInstruction(float distance,
@@ -499,14 +574,12 @@ std::string NarrativeBuilder::FormVerbalAlertApproachInstruction(float distance,
   instruction.reserve(kInstructionInitialCapacity);
   uint8_t phrase_id = 0;
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.approach_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(distance, dictionary_.approach_verbal_alert_subset.metric_lengths,
-                                dictionary_.approach_verbal_alert_subset.us_customary_lengths));
-  boost::replace_all(instruction, kCurrentVerbalCueTag, verbal_cue);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.approach_verbal_alert_subset.phrase(phrase_id).Fill(
+      {{kLengthTag,
+        FormLength(distance, dictionary_.approach_verbal_alert_subset.metric_lengths,
+                   dictionary_.approach_verbal_alert_subset.us_customary_lengths)},
+       {kCurrentVerbalCueTag, verbal_cue}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -564,13 +637,11 @@ std::string NarrativeBuilder::FormStartInstruction(Maneuver& maneuver) {
     phrase_id += 16;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.start_subset.phrase(phrase_id).Fill(
+      {{kCardinalDirectionTag, cardinal_direction},
+       {kStreetNamesTag, street_names},
+       {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -651,16 +722,14 @@ std::string NarrativeBuilder::FormVerbalStartInstruction(Maneuver& maneuver,
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
-                                dictionary_.start_verbal_subset.us_customary_lengths));
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.start_verbal_subset.phrase(phrase_id).Fill(
+      {{kCardinalDirectionTag, cardinal_direction},
+       {kStreetNamesTag, street_names},
+       {kBeginStreetNamesTag, begin_street_names},
+       {kLengthTag,
+        FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
+                   dictionary_.start_verbal_subset.us_customary_lengths)}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -704,14 +773,10 @@ std::string NarrativeBuilder::FormDestinationInstruction(Maneuver& maneuver) {
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_subset.phrases.at(std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.destination_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction},
+       {kDestinationTag, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -760,14 +825,10 @@ std::string NarrativeBuilder::FormVerbalAlertDestinationInstruction(Maneuver& ma
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.destination_verbal_alert_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction},
+       {kDestinationTag, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -816,14 +877,10 @@ std::string NarrativeBuilder::FormVerbalDestinationInstruction(Maneuver& maneuve
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.destination_verbal_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction},
+       {kDestinationTag, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -846,12 +903,10 @@ std::string NarrativeBuilder::FormBecomesInstruction(Maneuver& maneuver, Maneuve
   // Determine which phrase to use
   uint8_t phrase_id = 0;
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.becomes_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kPreviousStreetNamesTag, prev_street_names);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.becomes_subset.phrase(phrase_id).Fill(
+      {{kPreviousStreetNamesTag, prev_street_names},
+       {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -881,12 +936,10 @@ std::string NarrativeBuilder::FormVerbalBecomesInstruction(Maneuver& maneuver,
   // Determine which phrase to use
   uint8_t phrase_id = 0;
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.becomes_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kPreviousStreetNamesTag, prev_street_names);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.becomes_verbal_subset.phrase(phrase_id).Fill(
+      {{kPreviousStreetNamesTag, prev_street_names},
+       {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -932,13 +985,11 @@ std::string NarrativeBuilder::FormContinueInstruction(Maneuver& maneuver,
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.continue_subset.phrase(phrase_id).Fill(
+      {{kStreetNamesTag, street_names},
+       {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -988,13 +1039,11 @@ std::string NarrativeBuilder::FormVerbalAlertContinueInstruction(Maneuver& maneu
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.continue_verbal_alert_subset.phrase(phrase_id).Fill(
+      {{kStreetNamesTag, street_names},
+       {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1053,16 +1102,14 @@ std::string NarrativeBuilder::FormVerbalContinueInstruction(Maneuver& maneuver,
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.continue_verbal_subset.metric_lengths,
-                                dictionary_.continue_verbal_subset.us_customary_lengths));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.continue_verbal_subset.phrase(phrase_id).Fill(
+      {{kLengthTag,
+        FormLength(maneuver, dictionary_.continue_verbal_subset.metric_lengths,
+                   dictionary_.continue_verbal_subset.us_customary_lengths)},
+       {kStreetNamesTag, street_names},
+       {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1138,16 +1185,14 @@ std::string NarrativeBuilder::FormTurnInstruction(Maneuver& maneuver,
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = subset->phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(), subset->relative_directions)},
+       {kStreetNamesTag, street_names},
+       {kBeginStreetNamesTag, begin_street_names},
+       {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1246,16 +1291,14 @@ std::string NarrativeBuilder::FormVerbalTurnInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = subset->phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(), subset->relative_directions)},
+       {kStreetNamesTag, street_names},
+       {kBeginStreetNamesTag, begin_street_names},
+       {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1316,17 +1359,14 @@ std::string NarrativeBuilder::FormUturnInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.uturn_subset.relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kCrossStreetNamesTag, cross_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.uturn_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(), dictionary_.uturn_subset.relative_directions)},
+       {kStreetNamesTag, street_names},
+       {kCrossStreetNamesTag, cross_street_names},
+       {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1471,15 +1511,13 @@ std::string NarrativeBuilder::FormVerbalUturnInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kCrossStreetNamesTag, cross_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.uturn_verbal_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_dir},
+       {kStreetNamesTag, street_names},
+       {kCrossStreetNamesTag, cross_street_names},
+       {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1525,13 +1563,11 @@ std::string NarrativeBuilder::FormRampStraightInstruction(Maneuver& maneuver,
         maneuver.signs().GetExitNameString(element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_straight_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.ramp_straight_subset.phrase(phrase_id).Fill(
+      {{kBranchSignTag, exit_branch_sign},
+       {kTowardSignTag, exit_toward_sign},
+       {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1630,13 +1666,11 @@ std::string NarrativeBuilder::FormVerbalRampStraightInstruction(uint8_t phrase_i
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_straight_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.ramp_straight_verbal_subset.phrase(phrase_id).Fill(
+      {{kBranchSignTag, exit_branch_sign},
+       {kTowardSignTag, exit_toward_sign},
+       {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1704,16 +1738,13 @@ std::string NarrativeBuilder::FormRampInstruction(Maneuver& maneuver,
         maneuver.signs().GetExitNameString(element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.ramp_subset.relative_directions));
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.ramp_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(), dictionary_.ramp_subset.relative_directions)},
+       {kBranchSignTag, exit_branch_sign},
+       {kTowardSignTag, exit_toward_sign},
+       {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1864,14 +1895,12 @@ std::string NarrativeBuilder::FormVerbalRampInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.ramp_verbal_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_dir},
+       {kBranchSignTag, exit_branch_sign},
+       {kTowardSignTag, exit_toward_sign},
+       {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1949,17 +1978,14 @@ std::string NarrativeBuilder::FormExitInstruction(Maneuver& maneuver,
         maneuver.signs().GetExitNameString(element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.exit_subset.relative_directions));
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.exit_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(), dictionary_.exit_subset.relative_directions)},
+       {kNumberSignTag, exit_number_sign},
+       {kBranchSignTag, exit_branch_sign},
+       {kTowardSignTag, exit_toward_sign},
+       {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2120,15 +2146,13 @@ std::string NarrativeBuilder::FormVerbalExitInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.exit_verbal_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_dir},
+       {kNumberSignTag, exit_number_sign},
+       {kBranchSignTag, exit_branch_sign},
+       {kTowardSignTag, exit_toward_sign},
+       {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2209,16 +2233,13 @@ std::string NarrativeBuilder::FormKeepInstruction(Maneuver& maneuver,
     phrase_id += 4;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeThreeDirection(maneuver.type(),
-                                                dictionary_.keep_subset.relative_directions));
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.keep_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeThreeDirection(maneuver.type(), dictionary_.keep_subset.relative_directions)},
+       {kNumberSignTag, exit_number_sign},
+       {kStreetNamesTag, street_names},
+       {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2400,14 +2421,12 @@ std::string NarrativeBuilder::FormVerbalKeepInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.keep_verbal_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_dir},
+       {kNumberSignTag, exit_number_sign},
+       {kStreetNamesTag, street_names},
+       {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2459,16 +2478,14 @@ std::string NarrativeBuilder::FormKeepToStayOnInstruction(Maneuver& maneuver,
     phrase_id += 2;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_to_stay_on_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeThreeDirection(maneuver.type(), dictionary_.keep_to_stay_on_subset
-                                                                     .relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.keep_to_stay_on_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeThreeDirection(maneuver.type(),
+                                   dictionary_.keep_to_stay_on_subset.relative_directions)},
+       {kStreetNamesTag, street_names},
+       {kNumberSignTag, exit_number_sign},
+       {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2558,14 +2575,12 @@ std::string NarrativeBuilder::FormVerbalKeepToStayOnInstruction(uint8_t phrase_i
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_to_stay_on_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.keep_to_stay_on_verbal_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_dir},
+       {kStreetNamesTag, street_names},
+       {kNumberSignTag, exit_number_sign},
+       {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2616,13 +2631,11 @@ std::string NarrativeBuilder::FormMergeInstruction(Maneuver& maneuver,
         FormRelativeTwoDirection(maneuver.type(), dictionary_.merge_subset.relative_directions);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.merge_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction},
+       {kStreetNamesTag, street_names},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2691,13 +2704,11 @@ std::string NarrativeBuilder::FormVerbalMergeInstruction(Maneuver& maneuver,
                                  dictionary_.merge_verbal_subset.relative_directions);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.merge_verbal_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction},
+       {kStreetNamesTag, street_names},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2814,16 +2825,13 @@ std::string NarrativeBuilder::FormEnterRoundaboutInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
-  boost::replace_all(instruction, kRoundaboutExitStreetNamesTag, roundabout_exit_street_names);
-  boost::replace_all(instruction, kRoundaboutExitBeginStreetNamesTag,
-                     roundabout_exit_begin_street_names);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.enter_roundabout_subset.phrase(phrase_id).Fill(
+      {{kOrdinalValueTag, ordinal_value},
+       {kStreetNamesTag, street_names},
+       {kTowardSignTag, guide_sign},
+       {kRoundaboutExitStreetNamesTag, roundabout_exit_street_names},
+       {kRoundaboutExitBeginStreetNamesTag, roundabout_exit_begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2966,16 +2974,13 @@ std::string NarrativeBuilder::FormVerbalEnterRoundaboutInstruction(Maneuver& man
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
-  boost::replace_all(instruction, kRoundaboutExitStreetNamesTag, roundabout_exit_street_names);
-  boost::replace_all(instruction, kRoundaboutExitBeginStreetNamesTag,
-                     roundabout_exit_begin_street_names);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.enter_roundabout_verbal_subset.phrase(phrase_id).Fill(
+      {{kOrdinalValueTag, ordinal_value},
+       {kStreetNamesTag, street_names},
+       {kTowardSignTag, guide_sign},
+       {kRoundaboutExitStreetNamesTag, roundabout_exit_street_names},
+       {kRoundaboutExitBeginStreetNamesTag, roundabout_exit_begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3029,13 +3034,11 @@ std::string NarrativeBuilder::FormExitRoundaboutInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.exit_roundabout_subset.phrase(phrase_id).Fill(
+      {{kStreetNamesTag, street_names},
+       {kBeginStreetNamesTag, begin_street_names},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3093,13 +3096,11 @@ std::string NarrativeBuilder::FormVerbalExitRoundaboutInstruction(Maneuver& mane
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.exit_roundabout_verbal_subset.phrase(phrase_id).Fill(
+      {{kStreetNamesTag, street_names},
+       {kBeginStreetNamesTag, begin_street_names},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3143,13 +3144,11 @@ std::string NarrativeBuilder::FormEnterFerryInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_ferry_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kFerryLabelTag, ferry_label);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.enter_ferry_subset.phrase(phrase_id).Fill(
+      {{kStreetNamesTag, street_names},
+       {kFerryLabelTag, ferry_label},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3210,13 +3209,11 @@ std::string NarrativeBuilder::FormVerbalEnterFerryInstruction(Maneuver& maneuver
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_ferry_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kFerryLabelTag, ferry_label);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.enter_ferry_verbal_subset.phrase(phrase_id).Fill(
+      {{kStreetNamesTag, street_names},
+       {kFerryLabelTag, ferry_label},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3249,12 +3246,10 @@ std::string NarrativeBuilder::FormTransitConnectionStartInstruction(Maneuver& ma
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_start_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_connection_start_subset.phrase(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop},
+       {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3287,13 +3282,10 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionStartInstruction(Maneuv
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_start_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_connection_start_verbal_subset.phrase(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop},
+       {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3326,12 +3318,10 @@ std::string NarrativeBuilder::FormTransitConnectionTransferInstruction(Maneuver&
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_transfer_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_connection_transfer_subset.phrase(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop},
+       {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3364,13 +3354,10 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionTransferInstruction(Man
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_transfer_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_connection_transfer_verbal_subset.phrase(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop},
+       {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3403,13 +3390,10 @@ std::string NarrativeBuilder::FormTransitConnectionDestinationInstruction(Maneuv
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_destination_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_connection_destination_subset.phrase(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop},
+       {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3442,13 +3426,10 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionDestinationInstruction(
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_destination_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_connection_destination_verbal_subset.phrase(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop},
+       {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3471,13 +3452,11 @@ std::string NarrativeBuilder::FormDepartInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.depart_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.depart_subset.phrase(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop_name},
+       {kTimeTag,
+        get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3500,13 +3479,11 @@ std::string NarrativeBuilder::FormVerbalDepartInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.depart_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.depart_verbal_subset.phrase(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop_name},
+       {kTimeTag,
+        get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3529,13 +3506,10 @@ std::string NarrativeBuilder::FormArriveInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.arrive_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.arrive_subset.phrase(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop_name},
+       {kTimeTag, get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3558,13 +3532,10 @@ std::string NarrativeBuilder::FormVerbalArriveInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.arrive_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.arrive_verbal_subset.phrase(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop_name},
+       {kTimeTag, get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3591,16 +3562,14 @@ std::string NarrativeBuilder::FormTransitInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_subset.phrase(phrase_id).Fill(
+      {{kTransitNameTag,
+        FormTransitName(maneuver, dictionary_.transit_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign},
+       // TODO: locale specific numerals
+       {kTransitPlatformCountTag, std::to_string(stop_count)},
+       {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3623,14 +3592,11 @@ std::string NarrativeBuilder::FormVerbalTransitInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_verbal_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_verbal_subset.phrase(phrase_id).Fill(
+      {{kTransitNameTag,
+        FormTransitName(maneuver, dictionary_.transit_verbal_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3658,17 +3624,14 @@ std::string NarrativeBuilder::FormTransitRemainOnInstruction(Maneuver& maneuver)
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_remain_on_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_remain_on_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_remain_on_subset.phrase(phrase_id).Fill(
+      {{kTransitNameTag,
+        FormTransitName(maneuver, dictionary_.transit_remain_on_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign},
+       // TODO: locale specific numerals
+       {kTransitPlatformCountTag, std::to_string(stop_count)},
+       {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3691,14 +3654,12 @@ std::string NarrativeBuilder::FormVerbalTransitRemainOnInstruction(Maneuver& man
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_remain_on_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_remain_on_verbal_subset
-                                                   .empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_remain_on_verbal_subset.phrase(phrase_id).Fill(
+      {{kTransitNameTag,
+        FormTransitName(maneuver,
+                        dictionary_.transit_remain_on_verbal_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3726,17 +3687,14 @@ std::string NarrativeBuilder::FormTransitTransferInstruction(Maneuver& maneuver)
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_transfer_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_transfer_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_transfer_subset.phrase(phrase_id).Fill(
+      {{kTransitNameTag,
+        FormTransitName(maneuver, dictionary_.transit_transfer_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign},
+       // TODO: locale specific numerals
+       {kTransitPlatformCountTag, std::to_string(stop_count)},
+       {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3759,14 +3717,12 @@ std::string NarrativeBuilder::FormVerbalTransitTransferInstruction(Maneuver& man
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_transfer_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_transfer_verbal_subset
-                                                   .empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.transit_transfer_verbal_subset.phrase(phrase_id).Fill(
+      {{kTransitNameTag,
+        FormTransitName(maneuver,
+                        dictionary_.transit_transfer_verbal_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3807,14 +3763,12 @@ std::string NarrativeBuilder::FormVerbalPostTransitionInstruction(Maneuver& mane
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.post_transition_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
-                                dictionary_.post_transition_verbal_subset.us_customary_lengths));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.post_transition_verbal_subset.phrase(phrase_id).Fill(
+      {{kLengthTag,
+        FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
+                   dictionary_.post_transition_verbal_subset.us_customary_lengths)},
+       {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3835,14 +3789,11 @@ std::string NarrativeBuilder::FormVerbalPostTransitionTransitInstruction(Maneuve
       FormTransitPlatformCountLabel(stop_count, dictionary_.post_transition_transit_verbal_subset
                                                     .transit_stop_count_labels);
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.post_transition_transit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.post_transition_transit_verbal_subset.phrase(phrase_id).Fill(
+       // TODO: locale specific numerals
+      {{kTransitPlatformCountTag, std::to_string(stop_count)},
+       {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3886,14 +3837,12 @@ std::string NarrativeBuilder::FormVerbalSuccinctStartTransitionInstruction(Maneu
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
-                                dictionary_.start_verbal_subset.us_customary_lengths));
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.start_verbal_subset.phrase(phrase_id).Fill(
+      {{kCardinalDirectionTag, cardinal_direction},
+       {kLengthTag,
+        FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
+                   dictionary_.start_verbal_subset.us_customary_lengths)}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3952,14 +3901,12 @@ NarrativeBuilder::FormVerbalSuccinctTurnTransitionInstruction(Maneuver& maneuver
                                                maneuver.verbal_formatter(), &markup_formatter_);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = subset->phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(), subset->relative_directions)},
+       {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3998,15 +3945,13 @@ NarrativeBuilder::FormVerbalSuccinctUturnTransitionInstruction(Maneuver& maneuve
         maneuver.signs().GetJunctionNameString(element_max_count, limit_by_consecutive_count, delim,
                                                maneuver.verbal_formatter(), &markup_formatter_);
   }
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.uturn_verbal_subset.relative_directions));
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.uturn_verbal_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(),
+                                 dictionary_.uturn_verbal_subset.relative_directions)},
+       {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4050,12 +3995,10 @@ NarrativeBuilder::FormVerbalSuccinctMergeTransitionInstruction(Maneuver& maneuve
                                  dictionary_.merge_verbal_subset.relative_directions);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.merge_verbal_subset.phrase(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4098,12 +4041,10 @@ std::string NarrativeBuilder::FormVerbalSuccinctEnterRoundaboutTransitionInstruc
                                                         &markup_formatter_);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.enter_roundabout_verbal_subset.phrase(phrase_id).Fill(
+      {{kOrdinalValueTag, ordinal_value},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4134,10 +4075,9 @@ std::string NarrativeBuilder::FormVerbalSuccinctExitRoundaboutTransitionInstruct
                                                  maneuver.verbal_formatter(), &markup_formatter_);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase with its tags filled in
+  instruction = dictionary_.exit_roundabout_verbal_subset.phrase(phrase_id).Fill(
+      {{kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4560,14 +4500,12 @@ std::string NarrativeBuilder::FormVerbalMultiCue(Maneuver& maneuver,
   if (maneuver.distant_verbal_multi_cue()) {
     phrase_id = 1;
   }
-  instruction = dictionary_.verbal_multi_cue_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCurrentVerbalCueTag, first_verbal_cue);
-  boost::replace_all(instruction, kNextVerbalCueTag, second_verbal_cue);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
-                                dictionary_.post_transition_verbal_subset.us_customary_lengths));
+  instruction = dictionary_.verbal_multi_cue_subset.phrase(phrase_id).Fill(
+      {{kCurrentVerbalCueTag, first_verbal_cue},
+       {kNextVerbalCueTag, second_verbal_cue},
+       {kLengthTag,
+        FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
+                   dictionary_.post_transition_verbal_subset.us_customary_lengths)}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
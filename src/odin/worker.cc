@@ -29,6 +29,9 @@ namespace odin {
 
 odin_worker_t::odin_worker_t(const boost::property_tree::ptree& config)
     : service_worker_t(config), markup_formatter_(config) {
+  // how many legs a request needs before we build their directions in parallel
+  DirectionsBuilder::Configure(config);
+
   // signal that the worker started successfully
   started();
 }
@@ -67,7 +70,9 @@ odin_worker_t::work(const std::list<zmq::message_t>& job,
                     const std::function<void()>& interrupt_function) {
   auto& info = *static_cast<prime_server::http_request_info_t*>(request_info);
   LOG_INFO("Got Odin Request " + std::to_string(info.id));
-  Api request;
+  // the request lives in an arena backed by a buffer we reuse between requests
+  google::protobuf::Arena arena(arena_options());
+  Api& request = *google::protobuf::Arena::CreateMessage<Api>(&arena);
   prime_server::worker_t::result_t result{false, {}, {}};
   try {
     // Set the interrupt function
@@ -91,6 +96,7 @@ odin_worker_t::work(const std::list<zmq::message_t>& job,
       default: {
         // narrate them and serialize them along
         auto response = narrate(request);
+        cache_response(request, response);
         result = to_response(response, info, request);
         break;
       }
@@ -0,0 +1,209 @@
+#include "result_cache.h"
+#include "baldr/traffictile.h"
+#include "midgard/logging.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+namespace {
+
+// roughly what the list and hash map nodes of an entry cost on top of the result itself
+constexpr size_t kEntryOverhead = 96;
+
+bool is_cacheable(valhalla::ResultCache::Kind kind, valhalla::Options::Action action) {
+  using valhalla::Options;
+  // only routes get narrated again, everything else is finished by the time thor is done
+  if (kind == valhalla::ResultCache::Kind::kPath) {
+    return action == Options::route;
+  }
+  switch (action) {
+    case Options::route:
+    case Options::centroid:
+    case Options::optimized_route:
+    case Options::sources_to_targets:
+    case Options::isochrone:
+    case Options::trace_route:
+    case Options::trace_attributes:
+    case Options::expansion:
+      return true;
+    // the rest are either cheap or about the state of the service
+    default:
+      return false;
+  }
+}
+
+bool depends_on_now(const valhalla::Options& options) {
+  if (options.has_date_time_type_case() && options.date_time_type() == valhalla::Options::current) {
+    return true;
+  }
+  for (const auto* locations : {&options.locations(), &options.sources(), &options.targets()}) {
+    for (const auto& location : *locations) {
+      if (location.date_time() == "current") {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+template <typename T> void append(std::string& bytes, T value) {
+  bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+namespace valhalla {
+
+ResultCache::ResultCache(size_t capacity, bool live_traffic)
+    : capacity_(capacity), live_traffic_(live_traffic), used_(0), tileset_id_(0),
+      traffic_epoch_(0) {
+  stats_.capacity = capacity_;
+}
+
+std::shared_ptr<ResultCache> ResultCache::Get(const boost::property_tree::ptree& config) {
+  static std::mutex mutex;
+  static std::shared_ptr<ResultCache> cache;
+  auto size = config.get<size_t>("httpd.service.result_cache_size", 0);
+  if (size == 0) {
+    return nullptr;
+  }
+
+  // incidents come and go without anything to tell which ones a result was computed with
+  if (!config.get<std::string>("mjolnir.incident_log", "").empty() ||
+      !config.get<std::string>("mjolnir.incident_dir", "").empty()) {
+    static std::once_flag warned;
+    std::call_once(warned,
+                   [] { LOG_WARN("The result cache is disabled because incidents are configured"); });
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!cache) {
+    cache = std::make_shared<ResultCache>(size,
+                                          !config.get<std::string>("mjolnir.traffic_extract", "")
+                                               .empty());
+  }
+  return cache;
+}
+
+std::string ResultCache::Key(Kind kind, const Options& options, uint64_t tileset_id) {
+  if (!is_cacheable(kind, options.action()) || depends_on_now(options)) {
+    return {};
+  }
+
+  // live traffic which is updated in place could have changed under any result we kept, we can
+  // only tell which traffic a result was computed with when the updates are published by epoch
+  uint32_t traffic_epoch = 0;
+  if (live_traffic_) {
+    if (!baldr::TrafficEpochs::Get()) {
+      return {};
+    }
+    traffic_epoch = baldr::TrafficSnapshot::pinned();
+    traffic_epoch = traffic_epoch ? traffic_epoch : baldr::TrafficSnapshot::published();
+  }
+  advance(tileset_id, traffic_epoch);
+
+  // the path doesnt depend on how it will be presented
+  Options canonical(options);
+  if (kind == Kind::kPath) {
+    canonical.clear_units();
+    canonical.clear_language();
+    canonical.clear_directions_type();
+    canonical.clear_format();
+    canonical.clear_id();
+    canonical.clear_jsonp();
+    canonical.clear_shape_format();
+    canonical.clear_roundabout_exits();
+    canonical.clear_verbal_instructions();
+    canonical.clear_pbf_field_selector();
+  }
+
+  // what data the result comes from goes first, then the request
+  std::string bytes;
+  append(bytes, static_cast<uint8_t>(kind));
+  append(bytes, tileset_id);
+  append(bytes, traffic_epoch);
+
+  // the costings are a map so we need the serialization to be the same every time
+  {
+    google::protobuf::io::StringOutputStream stream(&bytes);
+    google::protobuf::io::CodedOutputStream coded(&stream);
+    coded.SetSerializationDeterministic(true);
+    canonical.SerializeToCodedStream(&coded);
+  }
+  return bytes;
+}
+
+bool ResultCache::Find(Kind kind, const std::string& key, std::string& result) {
+  if (key.empty()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = index_.find(key);
+  bool hit = found != index_.end();
+  if (kind == Kind::kResponse) {
+    ++(hit ? stats_.hits : stats_.misses);
+  } else {
+    ++(hit ? stats_.path_hits : stats_.path_misses);
+  }
+  if (!hit) {
+    return false;
+  }
+
+  // its the most recently used now
+  entries_.splice(entries_.begin(), entries_, found->second);
+  result = found->second->result;
+  return true;
+}
+
+void ResultCache::Insert(const std::string& key, std::string result) {
+  // one result shouldnt be able to push out everything else. the key is in the list and the map
+  auto size = 2 * key.size() + result.size() + kEntryOverhead;
+  if (key.empty() || size > capacity_ / 4) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // another thread beat us to it
+  if (index_.find(key) != index_.end()) {
+    return;
+  }
+
+  // make room
+  while (used_ + size > capacity_) {
+    const auto& oldest = entries_.back();
+    used_ -= 2 * oldest.key.size() + oldest.result.size() + kEntryOverhead;
+    index_.erase(oldest.key);
+    entries_.pop_back();
+  }
+
+  entries_.push_front(entry_t{key, std::move(result)});
+  index_.emplace(key, entries_.begin());
+  used_ += size;
+}
+
+ResultCache::stats_t ResultCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto stats = stats_;
+  stats.used = used_;
+  stats.entries = entries_.size();
+  return stats;
+}
+
+void ResultCache::advance(uint64_t tileset_id, uint32_t traffic_epoch) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // requests pinned to older traffic can still come in, their results just age out
+  if (tileset_id == tileset_id_ && traffic_epoch <= traffic_epoch_) {
+    return;
+  }
+
+  // everything we have was computed from what was there before
+  entries_.clear();
+  index_.clear();
+  used_ = 0;
+  tileset_id_ = tileset_id;
+  traffic_epoch_ = traffic_epoch;
+}
+
+} // namespace valhalla
@@ -54,8 +54,13 @@ void AStarBSSAlgorithm::Clear() {
   edgelabels_.clear();
   destinations_.clear();
   adjacencylist_.clear();
-  pedestrian_edgestatus_.clear();
-  bicycle_edgestatus_.clear();
+  if (clear_reserved_memory_) {
+    pedestrian_edgestatus_.release();
+    bicycle_edgestatus_.release();
+  } else {
+    pedestrian_edgestatus_.clear();
+    bicycle_edgestatus_.clear();
+  }
 
   // Set the ferry flag to false
   has_ferry_ = false;
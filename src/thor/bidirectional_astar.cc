@@ -85,8 +85,13 @@ void BidirectionalAStar::Clear() {
 
   adjacencylist_forward_.clear();
   adjacencylist_reverse_.clear();
-  edgestatus_forward_.clear();
-  edgestatus_reverse_.clear();
+  if (clear_reserved_memory_) {
+    edgestatus_forward_.release();
+    edgestatus_reverse_.release();
+  } else {
+    edgestatus_forward_.clear();
+    edgestatus_reverse_.clear();
+  }
 
   // Set the ferry flag to false
   has_ferry_ = false;
@@ -313,10 +318,12 @@ inline bool BidirectionalAStar::ExpandInner(baldr::GraphReader& graphreader,
   // Find the sort cost (with A* heuristic) using the lat,lng at the
   // end node of the directed edge.
   float dist = 0.0f;
-  float sortcost =
-      newcost.cost + (FORWARD
-                          ? astarheuristic_forward_.Get(t2->get_node_ll(meta.edge->endnode()), dist)
-                          : astarheuristic_reverse_.Get(t2->get_node_ll(meta.edge->endnode()), dist));
+  const auto endnode_ll = t2->get_node_ll(meta.edge->endnode());
+  float sortcost = newcost.cost + (FORWARD ? astarheuristic_forward_.Get(endnode_ll, dist)
+                                           : astarheuristic_reverse_.Get(endnode_ll, dist));
+
+  // The frontier is getting close to the border of the tile, start loading what is across it
+  graphreader.PrefetchNeighbors(meta.edge->endnode(), endnode_ll);
 
   // not_thru_pruning_ is only set to false on the 2nd pass in route_action.
   bool thru = not_thru_pruning_ ? (pred.not_thru_pruning() || !meta.edge->not_thru()) : false;
@@ -328,7 +335,7 @@ inline bool BidirectionalAStar::ExpandInner(baldr::GraphReader& graphreader,
     if (hierarchy_limits_forward_[meta.edge_id.level()].max_up_transitions != kUnlimitedTransitions) {
       // Override distance to the destination with a distance from the origin.
       // It will be used by hierarchy limits
-      dist = astarheuristic_reverse_.GetDistance(t2->get_node_ll(meta.edge->endnode()));
+      dist = astarheuristic_reverse_.GetDistance(endnode_ll);
     }
     edgelabels_forward_.emplace_back(pred_idx, meta.edge_id, opp_edge_id, meta.edge, newcost,
                                      sortcost, dist, mode_, transition_cost, thru,
@@ -342,7 +349,7 @@ inline bool BidirectionalAStar::ExpandInner(baldr::GraphReader& graphreader,
     if (hierarchy_limits_reverse_[meta.edge_id.level()].max_up_transitions != kUnlimitedTransitions) {
       // Override distance to the origin with a distance from the destination.
       // It will be used by hierarchy limits
-      dist = astarheuristic_forward_.GetDistance(t2->get_node_ll(meta.edge->endnode()));
+      dist = astarheuristic_forward_.GetDistance(endnode_ll);
     }
     edgelabels_reverse_.emplace_back(pred_idx, meta.edge_id, opp_edge_id, meta.edge, newcost,
                                      sortcost, dist, mode_, transition_cost, thru,
@@ -0,0 +1,605 @@
+#include "thor/connectionscan.h"
+#include "baldr/datetime.h"
+#include "baldr/time_info.h"
+#include "midgard/logging.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+using namespace valhalla::baldr;
+using namespace valhalla::sif;
+
+namespace {
+
+// a stop that hasnt been reached
+constexpr uint32_t kNever = std::numeric_limits<uint32_t>::max();
+
+// same as the in-station transfer of the multimodal A*
+constexpr uint32_t kTransferSecs = 30;
+
+
+} // namespace
+
+namespace valhalla {
+namespace thor {
+
+constexpr size_t ConnectionScan::kDays;
+
+ConnectionScan::ConnectionScan(std::shared_ptr<const timetable_t> timetable)
+    : timetable_(std::move(timetable)),
+      labels_(timetable_->stop_count(),
+              label_t{kNever, 0, nullptr, nullptr, timetable_t::kInvalidStop, 0}),
+      boarded_(timetable_->trip_count() * kDays, nullptr),
+      egress_secs_(timetable_->stop_count(), kNever) {
+}
+
+void ConnectionScan::Reset() {
+  for (auto stop : touched_stops_) {
+    labels_[stop].arrival = kNever;
+  }
+  touched_stops_.clear();
+  for (auto trip : touched_trips_) {
+    boarded_[trip] = nullptr;
+  }
+  touched_trips_.clear();
+  for (auto stop : touched_egress_) {
+    egress_secs_[stop] = kNever;
+  }
+  touched_egress_.clear();
+}
+
+void ConnectionScan::Reach(uint32_t stop, const label_t& label, uint32_t& target) {
+  auto& current = labels_[stop];
+  if (current.arrival == kNever) {
+    touched_stops_.push_back(stop);
+  }
+  current = label;
+
+  // getting off here might get us to the destination sooner
+  if (egress_secs_[stop] != kNever) {
+    target = std::min(target, label.arrival + egress_secs_[stop]);
+  }
+}
+
+void ConnectionScan::Walk(uint32_t stop, const filter_t& filter, uint32_t& target) {
+  // the footpaths arent closed so keep walking from every stop that we get to sooner, each stop
+  // only goes back on the queue when its arrival improves so this ends
+  walk_queue_.assign(1, stop);
+  while (!walk_queue_.empty()) {
+    auto from = walk_queue_.back();
+    walk_queue_.pop_back();
+    const auto arrival = labels_[from].arrival;
+    const auto transfers = labels_[from].transfers;
+    for (const auto& footpath : timetable_->footpaths(from)) {
+      if (footpath.distance <= filter.max_transfer_distance &&
+          arrival + footpath.secs < labels_[footpath.stop].arrival) {
+        Reach(footpath.stop, {arrival + footpath.secs, transfers, nullptr, nullptr, from, 0},
+              target);
+        walk_queue_.push_back(footpath.stop);
+      }
+    }
+  }
+}
+
+bool ConnectionScan::Usable(const timetable_t::connection_t& connection, const day_t& day) const {
+  return timetable_->schedule(connection.schedule).IsValid(day.date, day.dow);
+}
+
+void ConnectionScan::Days(uint32_t departure, const filter_t& filter, day_t (&days)[kDays]) const {
+  // yesterdays trips that are still going are the ones past midnight, tomorrows are all in reach
+  const uint32_t dow = filter.dow & kAllDaysOfWeek;
+  const uint32_t day = midgard::kSecondsPerDay;
+  days[0] = {timetable_->first_departure(departure + day), -static_cast<int32_t>(day),
+             filter.date - 1, (dow >> 1) | ((dow & 1) << 6)};
+  days[1] = {timetable_->first_departure(departure), 0, filter.date, dow};
+  days[2] = {timetable_->first_departure(departure > day ? departure - day : 0),
+             static_cast<int32_t>(day), filter.date + 1, ((dow << 1) & kAllDaysOfWeek) | (dow >> 6)};
+}
+
+const ConnectionScan::timetable_t::connection_t* ConnectionScan::Next(day_t (&days)[kDays],
+                                                                     size_t& day) const {
+  const auto* end = timetable_->connections().end();
+  const timetable_t::connection_t* next = nullptr;
+  int64_t next_departure = 0;
+  for (size_t i = 0; i < kDays; ++i) {
+    if (days[i].next == end) {
+      continue;
+    }
+    int64_t departure = static_cast<int64_t>(days[i].next->departure) + days[i].shift;
+    if (!next || departure < next_departure) {
+      next = days[i].next;
+      next_departure = departure;
+      day = i;
+    }
+  }
+  if (next) {
+    ++days[day].next;
+  }
+  return next;
+}
+
+bool ConnectionScan::EarliestArrival(const std::vector<access_t>& access,
+                                     const std::vector<access_t>& egress,
+                                     uint32_t departure,
+                                     const filter_t& filter,
+                                     journey_t& journey) {
+  Reset();
+  for (const auto& stop : egress) {
+    if (egress_secs_[stop.stop] == kNever) {
+      touched_egress_.push_back(stop.stop);
+    }
+    egress_secs_[stop.stop] = std::min(egress_secs_[stop.stop], stop.secs);
+  }
+
+  // walking from the origin to a stop doesnt count as reaching the destination, the multimodal A*
+  // does a better job of a walk all the way
+  uint32_t target = kNever;
+  for (const auto& stop : access) {
+    auto arrival = departure + stop.secs;
+    auto& label = labels_[stop.stop];
+    if (arrival < label.arrival) {
+      uint32_t ignored = kNever;
+      Reach(stop.stop, {arrival, 0, nullptr, nullptr, timetable_t::kInvalidStop, 0}, ignored);
+    }
+  }
+
+  // go through the connections of all the days in order of departure until none of them can get us
+  // there sooner
+  day_t days[kDays];
+  Days(departure, filter, days);
+  size_t day = 0;
+  const auto trip_count = timetable_->trip_count();
+  for (const auto* connection = Next(days, day);
+       connection && connection->departure + days[day].shift < target;
+       connection = Next(days, day)) {
+    if ((connection->flags & filter.flags) != filter.flags) {
+      continue;
+    }
+    const auto shift = days[day].shift;
+    const uint32_t connection_departure = connection->departure + shift;
+    const uint32_t connection_arrival = connection->arrival + shift;
+
+    // either we are already on this trip or we need to be at the stop in time to get on it
+    auto& boarded = boarded_[day * trip_count + connection->trip];
+    if (!boarded) {
+      const auto& from = labels_[connection->from_stop];
+      if (from.arrival == kNever) {
+        continue;
+      }
+      // changing vehicles takes a moment, walking up to the stop doesnt
+      auto ready = from.arrival + (from.board ? filter.transfer_secs : 0);
+      if (ready > connection_departure || !Usable(*connection, days[day])) {
+        continue;
+      }
+      boarded = connection;
+      touched_trips_.push_back(day * trip_count + connection->trip);
+    }
+
+    // riding to the next stop, ties go to fewer transfers
+    const auto& on = labels_[boarded->from_stop];
+    auto transfers = on.transfers + (on.board ? 1 : 0);
+    const auto& to = labels_[connection->to_stop];
+    if (connection_arrival > to.arrival ||
+        (connection_arrival == to.arrival && transfers >= to.transfers)) {
+      continue;
+    }
+    Reach(connection->to_stop,
+          {connection_arrival, transfers, boarded, connection, timetable_t::kInvalidStop, shift},
+          target);
+
+    // and walking on from there
+    Walk(connection->to_stop, filter, target);
+  }
+  if (target == kNever) {
+    return false;
+  }
+
+  // find the stop we got off at
+  journey.egress = {timetable_t::kInvalidStop, 0, 0};
+  for (auto stop : touched_egress_) {
+    const auto& label = labels_[stop];
+    bool ridden = label.board || label.walked_from != timetable_t::kInvalidStop;
+    if (label.arrival != kNever && ridden && label.arrival + egress_secs_[stop] == target) {
+      journey.egress = {stop, egress_secs_[stop], 0};
+      break;
+    }
+  }
+  if (journey.egress.stop == timetable_t::kInvalidStop) {
+    return false;
+  }
+
+  // follow the labels back to a stop we walked to from the origin
+  journey.legs.clear();
+  auto stop = journey.egress.stop;
+  while (true) {
+    const auto& label = labels_[stop];
+    if (label.board) {
+      journey.legs.push_back({label.board->from_stop, stop, label.board->departure + label.shift,
+                              label.arrival, label.board, label.alight, label.shift});
+      stop = label.board->from_stop;
+    } else if (label.walked_from != timetable_t::kInvalidStop) {
+      uint32_t secs = 0;
+      for (const auto& footpath : timetable_->footpaths(label.walked_from)) {
+        if (footpath.stop == stop) {
+          secs = footpath.secs;
+          break;
+        }
+      }
+      journey.legs.push_back(
+          {label.walked_from, stop, label.arrival - secs, label.arrival, nullptr, nullptr, 0});
+      stop = label.walked_from;
+    } else {
+      break;
+    }
+    // labels only ever get better so they cant loop, if they do its a bug so dont make it worse
+    if (journey.legs.size() > timetable_->stop_count()) {
+      LOG_ERROR("Connection scan labels form a loop");
+      return false;
+    }
+  }
+  std::reverse(journey.legs.begin(), journey.legs.end());
+
+  // leave the origin just in time to make the first connection
+  journey.access = {stop, labels_[stop].arrival - departure, 0};
+  journey.departure = journey.legs.front().departure - journey.access.secs;
+  journey.arrival = target;
+  return true;
+}
+
+std::vector<ConnectionScan::journey_t> ConnectionScan::Range(const std::vector<access_t>& access,
+                                                             const std::vector<access_t>& egress,
+                                                             uint32_t departure,
+                                                             uint32_t window,
+                                                             const filter_t& filter,
+                                                             size_t max_journeys) {
+  // any departure from a stop near the origin within the window is worth leaving for
+  std::unordered_map<uint32_t, uint32_t> access_secs;
+  uint32_t max_access_secs = 0;
+  for (const auto& stop : access) {
+    auto inserted = access_secs.emplace(stop.stop, stop.secs);
+    inserted.first->second = std::min(inserted.first->second, stop.secs);
+    max_access_secs = std::max(max_access_secs, stop.secs);
+  }
+  std::vector<uint32_t> leave_times;
+  day_t days[kDays];
+  Days(departure, filter, days);
+  size_t day = 0;
+  for (const auto* connection = Next(days, day);
+       connection &&
+       connection->departure + days[day].shift <= departure + window + max_access_secs;
+       connection = Next(days, day)) {
+    const uint32_t connection_departure = connection->departure + days[day].shift;
+    auto found = access_secs.find(connection->from_stop);
+    if (found != access_secs.cend() && connection_departure >= departure + found->second &&
+        connection_departure - found->second <= departure + window &&
+        (connection->flags & filter.flags) == filter.flags && Usable(*connection, days[day])) {
+      leave_times.push_back(connection_departure - found->second);
+    }
+  }
+  std::sort(leave_times.begin(), leave_times.end(), std::greater<uint32_t>());
+  leave_times.erase(std::unique(leave_times.begin(), leave_times.end()), leave_times.end());
+
+  // going from the latest to the earliest only keep a journey if it gets there sooner than all of
+  // the ones leaving after it
+  std::vector<journey_t> journeys;
+  uint32_t best = kNever;
+  journey_t journey;
+  for (auto leave_time : leave_times) {
+    if (EarliestArrival(access, egress, leave_time, filter, journey) && journey.arrival < best) {
+      best = journey.arrival;
+      journeys.push_back(journey);
+    }
+  }
+  std::reverse(journeys.begin(), journeys.end());
+  if (journeys.size() > max_journeys) {
+    journeys.resize(max_journeys);
+  }
+  return journeys;
+}
+
+StopWalk::StopWalk(const boost::property_tree::ptree& config)
+    : Dijkstras(config), forward_(true), max_distance_(0), timetable_(nullptr), targets_(nullptr),
+      target_secs_(0) {
+}
+
+void StopWalk::Walk(const valhalla::Location& location,
+                    GraphReader& reader,
+                    const sif::mode_costing_t& mode_costing,
+                    bool forward,
+                    uint32_t max_distance,
+                    const TransitTimetable& timetable,
+                    const std::unordered_set<uint64_t>& targets) {
+  Clear();
+  stop_labels_.clear();
+  forward_ = forward;
+  max_distance_ = max_distance;
+  timetable_ = &timetable;
+  targets_ = &targets;
+  target_secs_ = 0;
+
+  // the costing only allows transit connections walking forward, going away from the location and
+  // turning the walk around after is the same walk
+  google::protobuf::RepeatedPtrField<valhalla::Location> locations;
+  locations.Add()->CopyFrom(location);
+  Compute<ExpansionType::forward>(locations, reader, mode_costing, travel_mode_t::kPedestrian);
+  targets_ = nullptr;
+}
+
+void StopWalk::ExpandingNode(GraphReader&,
+                             graph_tile_ptr,
+                             const NodeInfo*,
+                             const EdgeLabel&,
+                             const EdgeLabel*) {
+  // the stops are found before expanding so they can be pruned
+}
+
+ExpansionRecommendation
+StopWalk::ShouldExpand(GraphReader&, const EdgeLabel& pred, const ExpansionType) {
+  // note how long it takes to walk to where we're going
+  if (!target_secs_ && targets_->count(pred.edgeid())) {
+    target_secs_ = std::max(1u, static_cast<uint32_t>(pred.cost().secs));
+  }
+
+  // the first time we get to a stop is the quickest, going through it would be riding or a
+  // footpath of the timetable
+  if (pred.endnode().level() == TileHierarchy::GetTransitLevel().level) {
+    auto stop = timetable_->find_stop(pred.endnode());
+    if (stop != TransitTimetable::kInvalidStop) {
+      stop_labels_.emplace(stop, edgestatus_.Get(pred.edgeid()).index());
+      return ExpansionRecommendation::prune_expansion;
+    }
+  }
+  return pred.path_distance() > max_distance_ ? ExpansionRecommendation::prune_expansion
+                                              : ExpansionRecommendation::continue_expansion;
+}
+
+void StopWalk::GetExpansionHints(uint32_t& bucket_count, uint32_t& edge_label_reservation) const {
+  // a walk doesnt go very far
+  bucket_count = std::max(max_distance_, 1000u);
+  edge_label_reservation = 10000;
+}
+
+std::vector<ConnectionScan::access_t> StopWalk::stops() const {
+  std::vector<ConnectionScan::access_t> stops;
+  stops.reserve(stop_labels_.size());
+  for (const auto& stop_label : stop_labels_) {
+    const auto& label = bdedgelabels_[stop_label.second];
+    stops.push_back(
+        {stop_label.first, static_cast<uint32_t>(label.cost().secs), label.path_distance()});
+  }
+  return stops;
+}
+
+bool StopWalk::AppendPath(uint32_t stop, uint32_t offset, std::vector<PathInfo>& path) const {
+  auto found = stop_labels_.find(stop);
+  if (found == stop_labels_.cend()) {
+    return false;
+  }
+  std::vector<uint32_t> chain;
+  for (auto index = found->second; index != kInvalidLabel;
+       index = bdedgelabels_[index].predecessor()) {
+    chain.push_back(index);
+  }
+
+  // going forward the labels have the time and distance from the start of the walk
+  float distance = path.empty() ? 0.f : path.back().path_distance;
+  if (forward_) {
+    for (auto index = chain.rbegin(); index != chain.rend(); ++index) {
+      const auto& label = bdedgelabels_[*index];
+      float secs = offset + label.cost().secs;
+      path.emplace_back(travel_mode_t::kPedestrian, Cost{secs, secs}, label.edgeid(), 0,
+                        distance + label.path_distance(), label.restriction_idx(),
+                        label.transition_cost());
+    }
+    return true;
+  }
+
+  // going in reverse they have what is left of the walk to the end, the labels are in order of the
+  // forward walk already and the edges we walk are the opposing ones
+  const auto& first = bdedgelabels_[chain.front()];
+  for (size_t i = 0; i < chain.size(); ++i) {
+    const auto& label = bdedgelabels_[chain[i]];
+    const auto* next = i + 1 < chain.size() ? &bdedgelabels_[chain[i + 1]] : nullptr;
+    float secs = offset + first.cost().secs - (next ? next->cost().secs : 0.f);
+    float walked = first.path_distance() - (next ? next->path_distance() : 0.f);
+    path.emplace_back(travel_mode_t::kPedestrian, Cost{secs, secs}, label.opp_edgeid(), 0,
+                      distance + walked, label.restriction_idx(), label.transition_cost());
+  }
+  return true;
+}
+
+valhalla::Location StopWalk::StopLocation(GraphReader& reader, const GraphId& node) {
+  valhalla::Location location;
+  auto tile = reader.GetGraphTile(node);
+  if (!tile) {
+    return location;
+  }
+  const auto* nodeinfo = tile->node(node);
+  auto ll = nodeinfo->latlng(tile->header()->base_ll());
+  location.mutable_ll()->set_lng(ll.lng());
+  location.mutable_ll()->set_lat(ll.lat());
+
+  // every edge leaving the stop except for the transit lines, we walk
+  GraphId edge_id(node.tileid(), node.level(), nodeinfo->edge_index());
+  for (const auto& edge : tile->GetDirectedEdges(nodeinfo)) {
+    if (!edge.IsTransitLine()) {
+      auto* path_edge = location.mutable_correlation()->add_edges();
+      path_edge->set_graph_id(edge_id);
+      path_edge->set_percent_along(0);
+      path_edge->set_begin_node(true);
+      path_edge->set_end_node(false);
+      path_edge->set_distance(0);
+      path_edge->mutable_ll()->CopyFrom(location.ll());
+    }
+    ++edge_id;
+  }
+  return location;
+}
+
+ConnectionScanAlgorithm::ConnectionScanAlgorithm(const boost::property_tree::ptree& config)
+    : MultiModalPathAlgorithm(config), access_(config), egress_(config), transfer_(config),
+      range_window_(config.get<uint32_t>("transit_range_window", 3600)) {
+}
+
+void ConnectionScanAlgorithm::set_timetable(std::shared_ptr<const TransitTimetable> timetable) {
+  timetable_ = std::move(timetable);
+  scan_.reset(timetable_ ? new ConnectionScan(timetable_) : nullptr);
+}
+
+void ConnectionScanAlgorithm::Clear() {
+  MultiModalPathAlgorithm::Clear();
+  access_.Clear();
+  egress_.Clear();
+  transfer_.Clear();
+}
+
+std::vector<std::vector<PathInfo>>
+ConnectionScanAlgorithm::GetBestPath(valhalla::Location& origin,
+                                     valhalla::Location& destination,
+                                     GraphReader& graphreader,
+                                     const sif::mode_costing_t& mode_costing,
+                                     const travel_mode_t mode,
+                                     const Options& options) {
+  // the timetable only knows the schedules, anything filtering the transit goes the long way
+  auto fallback = [&]() {
+    return MultiModalPathAlgorithm::GetBestPath(origin, destination, graphreader, mode_costing,
+                                                mode, options);
+  };
+  if (!timetable_ || !origin.has_date_time_case() || mode != travel_mode_t::kPedestrian) {
+    return fallback();
+  }
+  auto transit_options = options.costings().find(Costing::transit);
+  if (transit_options != options.costings().cend() &&
+      (transit_options->second.options().filter_stop_ids_size() ||
+       transit_options->second.options().filter_operator_ids_size() ||
+       transit_options->second.options().filter_route_ids_size())) {
+    return fallback();
+  }
+  auto pedestrian_options = options.costings().find(Costing::pedestrian);
+  if (pedestrian_options == options.costings().cend()) {
+    return fallback();
+  }
+
+  // walk to the stops near the origin and from the ones near the destination
+  const auto& pc = mode_costing[static_cast<uint32_t>(travel_mode_t::kPedestrian)];
+  const auto& tc = mode_costing[static_cast<uint32_t>(travel_mode_t::kPublicTransit)];
+  pc->SetAllowTransitConnections(true);
+  pc->UseMaxMultiModalDistance();
+  auto max_walk = pedestrian_options->second.options().transit_start_end_max_distance();
+  std::unordered_set<uint64_t> destination_edges;
+  for (const auto& edge : destination.correlation().edges()) {
+    destination_edges.insert(edge.graph_id());
+  }
+  access_.Walk(origin, graphreader, mode_costing, true, max_walk, *timetable_, destination_edges);
+  egress_.Walk(destination, graphreader, mode_costing, false, max_walk, *timetable_);
+  auto access = access_.stops();
+  auto egress = egress_.stops();
+  if (access.empty() || egress.empty()) {
+    return fallback();
+  }
+
+  // scan the service day of the origin, in its local time
+  TimeInfo::make(origin, graphreader, &tz_cache_);
+  const auto& date_time = origin.date_time();
+  ConnectionScan::filter_t filter{};
+  filter.date = DateTime::days_from_pivot_date(DateTime::get_formatted_date(date_time));
+  filter.dow = DateTime::day_of_week_mask(date_time);
+  filter.flags = (tc->wheelchair() ? TransitTimetable::kWheelchairAccessible : 0) |
+                 (tc->bicycle() ? TransitTimetable::kBicycleAccessible : 0);
+  filter.max_transfer_distance = pc->GetMaxTransferDistanceMM();
+  filter.transfer_secs = kTransferSecs;
+  uint32_t start_time = DateTime::seconds_from_midnight(date_time);
+
+  std::vector<ConnectionScan::journey_t> journeys;
+  if (options.alternates() > 0) {
+    journeys =
+        scan_->Range(access, egress, start_time, range_window_, filter, options.alternates() + 1);
+  } else {
+    journeys.emplace_back();
+    if (!scan_->EarliestArrival(access, egress, start_time, filter, journeys.back())) {
+      journeys.clear();
+    }
+  }
+
+  // if there is no transit or walking is quicker let the multimodal A* find the walk
+  if (journeys.empty() ||
+      (access_.target_secs() && start_time + access_.target_secs() <= journeys.front().arrival)) {
+    return fallback();
+  }
+
+  std::vector<std::vector<PathInfo>> paths;
+  for (const auto& journey : journeys) {
+    auto path = FormPath(journey, start_time, graphreader, mode_costing);
+    if (path.empty()) {
+      LOG_WARN("Connection scan could not walk part of a journey, using the multimodal A*");
+      return fallback();
+    }
+    paths.emplace_back(std::move(path));
+  }
+  return paths;
+}
+
+std::vector<PathInfo> ConnectionScanAlgorithm::FormPath(const ConnectionScan::journey_t& journey,
+                                                        uint32_t start_time,
+                                                        GraphReader& graphreader,
+                                                        const sif::mode_costing_t& mode_costing) {
+  // walk to the first stop, any waiting is done there
+  std::vector<PathInfo> path;
+  if (!access_.AppendPath(journey.access.stop, 0, path)) {
+    return {};
+  }
+
+  graph_tile_ptr tile;
+  const auto connections = timetable_->connections();
+  const auto& pc = mode_costing[static_cast<uint32_t>(travel_mode_t::kPedestrian)];
+  for (const auto& leg : journey.legs) {
+    auto elapsed = path.empty() ? 0.f : path.back().elapsed_cost.secs;
+
+    // walking between stops is done again with the costing of the request
+    if (!leg.board) {
+      GraphId from(timetable_->stop(leg.from_stop).node);
+      transfer_.Walk(StopWalk::StopLocation(graphreader, from), graphreader, mode_costing, true,
+                     pc->GetMaxTransferDistanceMM(), *timetable_);
+      auto offset = std::max(static_cast<uint32_t>(elapsed), leg.departure - start_time);
+      if (!transfer_.AppendPath(leg.to_stop, offset, path)) {
+        return {};
+      }
+      continue;
+    }
+
+    // ride each hop of the trip from getting on to getting off
+    for (const auto* connection = leg.board;; connection = &connections[connection->next]) {
+      GraphId edge_id(connection->edge);
+      const auto* edge = graphreader.directededge(edge_id, tile);
+      if (!edge) {
+        return {};
+      }
+      float secs =
+          std::max(elapsed, static_cast<float>(connection->arrival + leg.shift - start_time));
+      path.emplace_back(travel_mode_t::kPublicTransit, Cost{secs, secs}, edge_id,
+                        connection->tripid, path.empty() ? 0.f : path.back().path_distance,
+                        kInvalidRestriction);
+      path.back().path_distance += edge->length();
+      elapsed = secs;
+      if (connection == leg.alight) {
+        break;
+      }
+      if (connection->next == TransitTimetable::kNoConnection) {
+        return {};
+      }
+    }
+  }
+
+  // and walk from the last one
+  auto elapsed = path.empty() ? 0.f : path.back().elapsed_cost.secs;
+  auto offset = std::max(static_cast<uint32_t>(elapsed),
+                         journey.arrival - journey.egress.secs - start_time);
+  if (!egress_.AppendPath(journey.egress.stop, offset, path)) {
+    return {};
+  }
+  return path;
+}
+
+} // namespace thor
+} // namespace valhalla
@@ -67,7 +67,11 @@ void Dijkstras::Clear() {
 
   adjacencylist_.clear();
   mmadjacencylist_.clear();
-  edgestatus_.clear();
+  if (clear_reserved_memory_) {
+    edgestatus_.release();
+  } else {
+    edgestatus_.clear();
+  }
 }
 
 // Initialize - create adjacency list, edgestatus support, and reserve
@@ -245,6 +249,9 @@ void Dijkstras::ExpandInner(baldr::GraphReader& graphreader,
       oppedgeid = graphreader.GetOpposingEdgeId(edgeid, t2);
     }
 
+    // The frontier is getting close to the border of the tile, start loading what is across it
+    graphreader.PrefetchNeighbors(directededge->endnode(), t2);
+
     // Add edge label, add to the adjacency list and set edge status
     uint32_t idx = bdedgelabels_.size();
     *es = {EdgeSet::kTemporary, idx};
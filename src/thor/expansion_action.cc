@@ -130,6 +130,7 @@ std::string thor_worker_t::expansion(Api& request) {
   // tell all the algorithms how to track expansion
   for (auto* alg : std::vector<PathAlgorithm*>{
            &multi_modal_astar,
+           &connection_scan,
            &timedep_forward,
            &timedep_reverse,
            &bidir_astar,
@@ -152,8 +153,9 @@ std::string thor_worker_t::expansion(Api& request) {
   }
 
   // tell all the algorithms to stop tracking the expansion
-  for (auto* alg : std::vector<PathAlgorithm*>{&multi_modal_astar, &timedep_forward, &timedep_reverse,
-                                               &bidir_astar, &bss_astar}) {
+  for (auto* alg : std::vector<PathAlgorithm*>{&multi_modal_astar, &connection_scan,
+                                               &timedep_forward, &timedep_reverse, &bidir_astar,
+                                               &bss_astar}) {
     alg->set_track_expansion(nullptr);
   }
   isochrone_gen.set_track_expansion(nullptr);
@@ -90,7 +90,11 @@ void MultiModalPathAlgorithm::Clear() {
   adjacencylist_.clear();
 
   // Clear the edge status flags
-  edgestatus_.clear();
+  if (clear_reserved_memory_) {
+    edgestatus_.release();
+  } else {
+    edgestatus_.clear();
+  }
 
   // Set the ferry flag to false
   has_ferry_ = false;
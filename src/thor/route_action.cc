@@ -228,6 +228,42 @@ void thor_worker_t::route(Api& request) {
   }
 }
 
+void thor_worker_t::cached_route(Api& request) {
+  // the key has to come from the options before routing changes them
+  auto key = result_cache ? result_cache->Key(ResultCache::Kind::kPath, request.options(),
+                                              reader->GetTilesetId())
+                          : std::string();
+  std::string bytes;
+  if (!key.empty() && result_cache->Find(ResultCache::Kind::kPath, key, bytes)) {
+    // routing only adds the trip and warnings and changes the locations, the rest of the request
+    // stays as it is
+    Api path;
+    if (path.ParseFromString(bytes)) {
+      request.mutable_trip()->Swap(path.mutable_trip());
+      request.mutable_options()->mutable_locations()->Swap(
+          path.mutable_options()->mutable_locations());
+      for (auto& warning : *path.mutable_info()->mutable_warnings()) {
+        request.mutable_info()->add_warnings()->Swap(&warning);
+      }
+      return;
+    }
+  }
+
+  auto warnings = request.info().warnings_size();
+  route(request);
+
+  if (!key.empty()) {
+    Api path;
+    *path.mutable_trip() = request.trip();
+    *path.mutable_options()->mutable_locations() = request.options().locations();
+    // only the warnings routing added, the ones from before are already on the request
+    for (int i = warnings; i < request.info().warnings_size(); ++i) {
+      *path.mutable_info()->add_warnings() = request.info().warnings(i);
+    }
+    result_cache->Insert(key, path.SerializeAsString());
+  }
+}
+
 thor::PathAlgorithm* thor_worker_t::get_path_algorithm(const std::string& routetype,
                                                        const valhalla::Location& origin,
                                                        const valhalla::Location& destination,
@@ -235,6 +271,7 @@ thor::PathAlgorithm* thor_worker_t::get_path_algorithm(const std::string& routet
   // make sure they are all cancelable
   for (auto* alg : std::vector<PathAlgorithm*>{
            &multi_modal_astar,
+           &connection_scan,
            &timedep_forward,
            &timedep_reverse,
            &bidir_astar,
@@ -245,7 +282,7 @@ thor::PathAlgorithm* thor_worker_t::get_path_algorithm(const std::string& routet
 
   // Have to use multimodal for transit based routing
   if (routetype == "multimodal" || routetype == "transit") {
-    return &multi_modal_astar;
+    return use_connection_scan ? &connection_scan : &multi_modal_astar;
   }
 
   // Have to use bike share station algorithm
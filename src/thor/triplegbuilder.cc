@@ -1,6 +1,8 @@
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <ostream>
 #include <string>
@@ -19,6 +21,7 @@
 #include "midgard/logging.h"
 #include "midgard/pointll.h"
 #include "midgard/util.h"
+#include "midgard/workerpool.h"
 #include "proto/common.pb.h"
 #include "sif/costconstants.h"
 #include "sif/recost.h"
@@ -1440,11 +1443,169 @@ std::vector<double> elevationFromTrimmedPath(iterator_t trip_shape_begin,
   return final_samples;
 }
 
+// The part of the trip shape contributed by a single edge, along with its elevation and how much
+// of the edge was used. This only depends on the edge itself so for long paths it is computed in
+// parallel before the trip leg is assembled
+struct EdgeShape {
+  std::vector<PointLL> shape;
+  std::vector<double> elevation;
+  float trim_start_pct;
+  float trim_end_pct;
+  bool trimmed;
+};
+
+using edge_trimming_t = std::unordered_map<size_t, std::pair<EdgeTrimmingInfo, EdgeTrimmingInfo>>;
+
+/**
+ * Decodes, orients and trims the shape of an edge in the path and looks up its elevation. This
+ * only reads from the tile so it can be called from multiple threads at once
+ * @param tile           the tile containing the edge
+ * @param edge           the edge
+ * @param edge_index     the index of the edge in the path
+ * @param is_first_edge  whether its the first edge of the path
+ * @param is_last_edge   whether its the last edge of the path
+ * @param start_pct      percent along the first edge where the path begins
+ * @param start_vrt      where the path begins
+ * @param end_pct        percent along the last edge where the path ends
+ * @param end_vrt        where the path ends
+ * @param edge_trimming  markers on edges with information on how to trim their shape
+ * @param edge_shape     the resulting shape, elevation and trimming for the edge
+ */
+void BuildEdgeShape(const GraphTile& tile,
+                    const GraphId& edge,
+                    size_t edge_index,
+                    bool is_first_edge,
+                    bool is_last_edge,
+                    float start_pct,
+                    const PointLL& start_vrt,
+                    float end_pct,
+                    const PointLL& end_vrt,
+                    const edge_trimming_t& edge_trimming,
+                    EdgeShape& edge_shape) {
+  const DirectedEdge* directededge = tile.directededge(edge);
+  auto edgeinfo = tile.GetEdgeInfoFromIndex(edge.id());
+  auto& shape = edge_shape.shape;
+  shape = edgeinfo.shape();
+  const auto elevation_shape = edgeinfo.elevation_samples();
+
+  // some information regarding shape/length trimming
+  edge_shape.trim_start_pct = is_first_edge ? start_pct : 0;
+  edge_shape.trim_end_pct = is_last_edge ? end_pct : 1;
+  edge_shape.trimmed = false;
+
+  // Get edge shape and reverse it if directed edge is not forward.
+  if (!directededge->forward()) {
+    std::reverse(shape.begin(), shape.end());
+  }
+
+  auto trip_points = std::vector<TripPoint>{};
+  if (shape.size() == elevation_shape.size()) {
+    trip_points.reserve(shape.size());
+    for (auto i = 0; i < (int)shape.size(); ++i) {
+      trip_points.emplace_back(shape[i], elevation_shape[i]);
+    }
+  }
+
+  // Some edges at the beginning and end of the path and at intermediate locations will need to be trimmed
+  auto trimming = edge_trimming.end();
+  if (!edge_trimming.empty() &&
+      (trimming = edge_trimming.find(edge_index)) != edge_trimming.end()) {
+    edge_shape.trimmed = true;
+
+    // Grab the edge begin and end info
+    const auto& edge_begin_info = trimming->second.first;
+    const auto& edge_end_info = trimming->second.second;
+
+    // Start by assuming no trimming
+    double begin_trim_dist = 0, end_trim_dist = 1;
+    auto begin_trim_vrt = shape.front(), end_trim_vrt = shape.back();
+
+    // Trimming needed
+    if (edge_begin_info.trim) {
+      begin_trim_dist = edge_begin_info.distance_along;
+      begin_trim_vrt = edge_begin_info.vertex;
+    }
+    // Handle partial shape for first edge
+    else if (is_first_edge && !edge_begin_info.trim) {
+      begin_trim_dist = start_pct;
+      begin_trim_vrt = start_vrt;
+    }
+
+    // Trimming needed
+    if (edge_end_info.trim) {
+      end_trim_dist = edge_end_info.distance_along;
+      end_trim_vrt = edge_end_info.vertex;
+    } // Handle partial shape for last edge
+    else if (is_last_edge && !edge_end_info.trim) {
+      end_trim_dist = end_pct;
+      end_trim_vrt = end_vrt;
+    }
+
+    // Overwrite the trimming information for the edge length now that we know what it is
+    edge_shape.trim_start_pct = begin_trim_dist;
+    edge_shape.trim_end_pct = end_trim_dist;
+
+    // Trim the shape
+    auto edge_length = static_cast<float>(directededge->length());
+    trim_shape(begin_trim_dist * edge_length, begin_trim_vrt, end_trim_dist * edge_length,
+               end_trim_vrt, shape);
+  } // We need to clip the shape if its at the beginning or end
+  else if (is_first_edge || is_last_edge) {
+    float total = static_cast<float>(directededge->length());
+    // Trim both ways
+    if (is_first_edge && is_last_edge) {
+      trim_shape(start_pct * total, start_vrt, end_pct * total, end_vrt, shape);
+    } // Trim the shape at the front for the first edge
+    else if (is_first_edge) {
+      trim_shape(start_pct * total, start_vrt, total, shape.back(), shape);
+    } // And at the back if its the last edge
+    else {
+      trim_shape(0, shape.front(), end_pct * total, end_vrt, shape);
+    }
+  }
+
+  // The first point is redundant with the previous edge so it doesnt get an elevation
+  edge_shape.elevation =
+      elevationFromTrimmedPath(shape.begin() + !is_first_edge, shape.end(), trip_points);
+}
+
+// Paths with at least this many edges have their edge shapes built on multiple threads
+std::atomic<size_t> parallel_min_edges{TripLegBuilder::kDefaultParallelMinEdges};
+// How many threads to build the edge shapes with, 0 or 1 disables it
+std::atomic<size_t> parallel_threads{TripLegBuilder::kDefaultParallelThreads};
+// The threads long paths of all requests are built on
+SharedWorkerPool parallel_pool;
+
+/**
+ * Runs the given function over the range of edge indices, splitting it up into contiguous chunks
+ * over multiple threads when the path is long enough
+ * @param edge_count  the number of edges in the path
+ * @param func        does the work for the half open range of edge indices it is given
+ */
+void ForEachEdgeChunk(size_t edge_count, const std::function<void(size_t, size_t)>& func) {
+  size_t threads = parallel_threads.load(std::memory_order_relaxed);
+  if (threads < 2 || edge_count < parallel_min_edges.load(std::memory_order_relaxed)) {
+    func(0, edge_count);
+    return;
+  }
+
+  // each thread gets a contiguous chunk and writes to its own part of the output
+  auto pool = parallel_pool.Get(threads);
+  threads = std::min(threads, edge_count);
+  const size_t chunk = (edge_count + threads - 1) / threads;
+  pool->ParallelFor((edge_count + chunk - 1) / chunk, [&](size_t i) {
+    func(i * chunk, std::min(edge_count, (i + 1) * chunk));
+  });
+}
+
 } // namespace
 
 namespace valhalla {
 namespace thor {
 
+constexpr size_t TripLegBuilder::kDefaultParallelMinEdges;
+constexpr size_t TripLegBuilder::kDefaultParallelThreads;
+
 void TripLegBuilder::Build(
     const valhalla::Options& options,
     const AttributesController& controller,
@@ -1568,6 +1729,55 @@ void TripLegBuilder::Build(
   // so we should care about 'time_info' updates during iterations
   MultimodalBuilder multimodal_builder(origin, time_info);
 
+  // grab all the tiles up front, the graphreader can only be used from this thread. while we are
+  // at it we note the timezone and elapsed time at each node so the times can be done in one go
+  const size_t edge_count = path_end - path_begin;
+  std::vector<graph_tile_ptr> edge_tiles, start_tiles;
+  edge_tiles.reserve(edge_count);
+  start_tiles.reserve(edge_count);
+  std::vector<float> seconds_offsets;
+  std::vector<uint32_t> tz_indices;
+  seconds_offsets.reserve(edge_count);
+  tz_indices.reserve(edge_count);
+  GraphId node_id = startnode;
+  for (auto edge_itr = path_begin; edge_itr != path_end; ++edge_itr) {
+    graphtile = graphreader.GetGraphTile(edge_itr->edgeid, graphtile);
+    if (graphtile == nullptr) {
+      throw tile_gone_error_t("TripLegBuilder::Build failed", edge_itr->edgeid);
+    }
+    edge_tiles.push_back(graphtile);
+
+    graph_tile_ptr start_tile = graphtile;
+    graphreader.GetGraphTile(node_id, start_tile);
+    if (start_tile == nullptr) {
+      throw tile_gone_error_t("TripLegBuilder::Build failed", node_id);
+    }
+    start_tiles.push_back(start_tile);
+    tz_indices.push_back(start_tile->node(node_id)->timezone());
+    seconds_offsets.push_back((edge_itr == path_begin || invariant)
+                                  ? 0.f
+                                  : std::prev(edge_itr)->elapsed_cost.secs);
+    node_id = graphtile->directededge(edge_itr->edgeid)->endnode();
+  }
+
+  // the local time at each node, the timezone can change along the path
+  const auto time_infos = forward_time_info.forward(seconds_offsets, tz_indices);
+
+  // decoding and trimming the edge shapes is independent per edge so for long paths we do it in
+  // parallel. the threads only see the tiles via raw pointer since the refcount may not be atomic
+  std::vector<EdgeShape> edge_shapes(edge_count);
+  ForEachEdgeChunk(edge_count, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      BuildEdgeShape(*edge_tiles[i], (path_begin + i)->edgeid, i, i == 0, i == edge_count - 1,
+                     start_pct, start_vrt, end_pct, end_vrt, edge_trimming, edge_shapes[i]);
+    }
+  });
+
+  // Test interrupt prior to assembling the trip path
+  if (interrupt_callback) {
+    (*interrupt_callback)();
+  }
+
   // prepare to make some edges!
   trip_path.mutable_node()->Reserve((path_end - path_begin) + 1);
 
@@ -1579,21 +1789,14 @@ void TripLegBuilder::Build(
   // loop over the edges to build the trip leg
   for (auto edge_itr = path_begin; edge_itr != path_end; ++edge_itr, ++edge_index) {
     const GraphId& edge = edge_itr->edgeid;
-    graphtile = graphreader.GetGraphTile(edge, graphtile);
-    if (graphtile == nullptr) {
-      throw tile_gone_error_t("TripLegBuilder::Build failed", edge);
-    }
+    graphtile = edge_tiles[edge_index];
     const DirectedEdge* directededge = graphtile->directededge(edge);
     const sif::TravelMode mode = edge_itr->mode;
     const uint8_t travel_type = travel_types[static_cast<uint32_t>(mode)];
     const auto& costing = mode_costing[static_cast<uint32_t>(mode)];
 
     // Set node attributes - only set if they are true since they are optional
-    graph_tile_ptr start_tile = graphtile;
-    graphreader.GetGraphTile(startnode, start_tile);
-    if (start_tile == nullptr) {
-      throw tile_gone_error_t("TripLegBuilder::Build failed", startnode);
-    }
+    const graph_tile_ptr& start_tile = start_tiles[edge_index];
     const NodeInfo* node = start_tile->node(startnode);
 
     if (osmchangeset == 0 && controller.attributes.at(kOsmChangeset)) {
@@ -1603,11 +1806,7 @@ void TripLegBuilder::Build(
     const bool is_first_edge = edge_itr == path_begin;
     const bool is_last_edge = edge_itr == (path_end - 1);
 
-    // have to always compute the offset in case the timezone changes along the path
-    // we could cache the timezone and just add seconds when the timezone doesnt change
-    const float seconds_offset =
-        (is_first_edge || invariant) ? 0.f : std::prev(edge_itr)->elapsed_cost.secs;
-    time_info = forward_time_info.forward(seconds_offset, static_cast<int>(node->timezone()));
+    time_info = time_infos[edge_index];
 
     // Add a node to the trip path and set its attributes.
     TripLeg_Node* trip_node = trip_path.add_node();
@@ -1665,110 +1864,16 @@ void TripLegBuilder::Build(
                     time_info, startnode.id(), node->named_intersection(), start_tile,
                     edge_itr->restriction_index);
 
-    // some information regarding shape/length trimming
-    float trim_start_pct = is_first_edge ? start_pct : 0;
-    float trim_end_pct = is_last_edge ? end_pct : 1;
-
-    // Some edges at the beginning and end of the path and at intermediate locations will need to be trimmed
+    // Add the edges shape and elevation that we computed up front, skipping the first point when
+    // its redundant with the previous edge
+    const auto& edge_shape = edge_shapes[edge_index];
+    const float trim_start_pct = edge_shape.trim_start_pct;
+    const float trim_end_pct = edge_shape.trim_end_pct;
     uint32_t begin_index = is_first_edge ? 0 : trip_shape.size() - 1;
-    auto edgeinfo = graphtile->GetEdgeInfoFromIndex(edge.id());
-
-    auto edge_shape = edgeinfo.shape();
-    const auto elevation_shape = edgeinfo.elevation_samples();
-    auto trip_points = std::vector<TripPoint>{};
-
-    // Get edge shape and reverse it if directed edge is not forward.
-    if (!directededge->forward()) {
-      std::reverse(edge_shape.begin(), edge_shape.end());
-    }
-
-    if (edge_shape.size() == elevation_shape.size()) {
-      trip_points.reserve(edge_shape.size());
-      for (auto i = 0; i < (int)edge_shape.size(); ++i) {
-        trip_points.emplace_back(edge_shape[i], elevation_shape[i]);
-      }
-    }
-
-    auto edge_elevation = std::vector<double>{};
-
-    auto trimming = edge_trimming.end();
-    if (!edge_trimming.empty() &&
-        (trimming = edge_trimming.find(edge_index)) != edge_trimming.end()) {
-
-      // Grab the edge begin and end info
-      const auto& edge_begin_info = trimming->second.first;
-      const auto& edge_end_info = trimming->second.second;
-
-      // Start by assuming no trimming
-      double begin_trim_dist = 0, end_trim_dist = 1;
-      auto begin_trim_vrt = edge_shape.front(), end_trim_vrt = edge_shape.back();
-
-      // Trimming needed
-      if (edge_begin_info.trim) {
-        begin_trim_dist = edge_begin_info.distance_along;
-        begin_trim_vrt = edge_begin_info.vertex;
-      }
-      // Handle partial shape for first edge
-      else if (is_first_edge && !edge_begin_info.trim) {
-        begin_trim_dist = start_pct;
-        begin_trim_vrt = start_vrt;
-      }
-
-      // Trimming needed
-      if (edge_end_info.trim) {
-        end_trim_dist = edge_end_info.distance_along;
-        end_trim_vrt = edge_end_info.vertex;
-      } // Handle partial shape for last edge
-      else if (is_last_edge && !edge_end_info.trim) {
-        end_trim_dist = end_pct;
-        end_trim_vrt = end_vrt;
-      }
-
-      // Overwrite the trimming information for the edge length now that we know what it is
-      trim_start_pct = begin_trim_dist;
-      trim_end_pct = end_trim_dist;
-
-      // Trim the shape
-      auto edge_length = static_cast<float>(directededge->length());
-      trim_shape(begin_trim_dist * edge_length, begin_trim_vrt, end_trim_dist * edge_length,
-                 end_trim_vrt, edge_shape);
-      // Add edge shape to the trip and skip the first point when its redundant with the previous edge
-      trip_shape.insert(trip_shape.end(), edge_shape.begin() + !is_first_edge, edge_shape.end());
-      edge_elevation = elevationFromTrimmedPath(edge_shape.begin() + !is_first_edge,
-                                                edge_shape.end(), trip_points);
-    } // We need to clip the shape if its at the beginning or end
-    else if (is_first_edge || is_last_edge) {
-      float total = static_cast<float>(directededge->length());
-      // Trim both ways
-      if (is_first_edge && is_last_edge) {
-        trim_shape(start_pct * total, start_vrt, end_pct * total, end_vrt, edge_shape);
-      } // Trim the shape at the front for the first edge
-      else if (is_first_edge) {
-        trim_shape(start_pct * total, start_vrt, total, edge_shape.back(), edge_shape);
-      } // And at the back if its the last edge
-      else {
-        trim_shape(0, edge_shape.front(), end_pct * total, end_vrt, edge_shape);
-      }
-      // Keep the shape
-      trip_shape.insert(trip_shape.end(), edge_shape.begin() + !is_first_edge, edge_shape.end());
-      edge_elevation = elevationFromTrimmedPath(edge_shape.begin() + !is_first_edge,
-                                                edge_shape.end(), trip_points);
-
-    } // Just get the shape in there in the right direction no clipping needed
-    else {
-      if (directededge->forward()) {
-        trip_shape.insert(trip_shape.end(), edgeinfo.shape().begin() + 1, edgeinfo.shape().end());
-        edge_elevation = elevationFromTrimmedPath(edgeinfo.shape().begin() + 1,
-                                                  edgeinfo.shape().end(), trip_points);
-      } else {
-        trip_shape.insert(trip_shape.end(), edgeinfo.shape().rbegin() + 1, edgeinfo.shape().rend());
-        edge_elevation = elevationFromTrimmedPath(edgeinfo.shape().rbegin() + 1,
-                                                  edgeinfo.shape().rend(), trip_points);
-      }
-    }
-
-    trip_elevation_shape.insert(std::end(trip_elevation_shape), std::begin(edge_elevation),
-                                std::end(edge_elevation));
+    trip_shape.insert(trip_shape.end(), edge_shape.shape.begin() + !is_first_edge,
+                      edge_shape.shape.end());
+    trip_elevation_shape.insert(trip_elevation_shape.end(), edge_shape.elevation.begin(),
+                                edge_shape.elevation.end());
 
     // Set the portion of the edge we used
     // TODO: attributes controller and then use this in recosting
@@ -1789,7 +1894,7 @@ void TripLegBuilder::Build(
       // So for intermediate locations that dont have any trimming we know they occur at the node
       // In this case and only for ARRIVE_BY, the edge index that we convert to shape is off by 1
       // So here we need to set this one as if it were at the end of the previous edge in the path
-      if (trimming == edge_trimming.end() &&
+      if (!edge_shape.trimmed &&
           (options.has_date_time_type_case() && options.date_time_type() == Options::arrive_by)) {
         intermediate_itr->mutable_correlation()->set_leg_shape_index(begin_index);
         intermediate_itr->mutable_correlation()->set_distance_from_leg_origin(
@@ -1917,5 +2022,12 @@ void TripLegBuilder::Build(
                                  graphreader, trip_path);
 }
 
+void TripLegBuilder::Configure(const boost::property_tree::ptree& config) {
+  parallel_min_edges.store(config.get<size_t>("tripleg_parallel_min_edges", kDefaultParallelMinEdges),
+                           std::memory_order_relaxed);
+  parallel_threads.store(config.get<size_t>("tripleg_parallel_threads", kDefaultParallelThreads),
+                         std::memory_order_relaxed);
+}
+
 } // namespace thor
 } // namespace valhalla
@@ -46,7 +46,11 @@ void UnidirectionalAStar<expansion_direction, FORWARD>::Clear() {
   edgelabels_.clear();
   destinations_percent_along_.clear();
   adjacencylist_.clear();
-  edgestatus_.clear();
+  if (clear_reserved_memory_) {
+    edgestatus_.release();
+  } else {
+    edgestatus_.clear();
+  }
 
   // Set the ferry flag to false
   has_ferry_ = false;
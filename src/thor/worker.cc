@@ -6,6 +6,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "baldr/traffictile.h"
+#include "baldr/transittimetable.h"
 #include "midgard/constants.h"
 #include "midgard/logging.h"
 #include "midgard/util.h"
@@ -50,6 +52,8 @@ constexpr float kDistanceScale = 10.f;
 
 #ifdef HAVE_HTTP
 std::string serialize_to_pbf(Api& request) {
+  // odin is next so we leave out what it wont look at
+  prune_for(Stage::kOdin, request);
   std::string buf;
   if (!request.SerializeToString(&buf)) {
     LOG_ERROR("Failed serializing to pbf in Thor::Worker");
@@ -68,7 +72,8 @@ thor_worker_t::thor_worker_t(const boost::property_tree::ptree& config,
                              const std::shared_ptr<baldr::GraphReader>& graph_reader)
     : service_worker_t(config), mode(valhalla::sif::TravelMode::kPedestrian),
       bidir_astar(config.get_child("thor")), bss_astar(config.get_child("thor")),
-      multi_modal_astar(config.get_child("thor")), timedep_forward(config.get_child("thor")),
+      multi_modal_astar(config.get_child("thor")), connection_scan(config.get_child("thor")),
+      use_connection_scan(false), timedep_forward(config.get_child("thor")),
       timedep_reverse(config.get_child("thor")), isochrone_gen(config.get_child("thor")),
       reader(graph_reader ? graph_reader
                           : std::make_shared<baldr::GraphReader>(config.get_child("mjolnir"))),
@@ -101,6 +106,26 @@ thor_worker_t::thor_worker_t(const boost::property_tree::ptree& config,
   max_timedep_distance =
       config.get<float>("service_limits.max_timedep_distance", kDefaultMaxTimeDependentDistance);
 
+  // how long routes need to be before we build their trip legs in parallel
+  TripLegBuilder::Configure(config.get_child("thor"));
+
+  // route on the flattened timetable instead of the departures in the tiles if there is one
+  if (config.get<std::string>("thor.transit_engine", "multimodal") == "connection_scan") {
+    auto timetable_file = baldr::GraphReader::FindSidecar(config.get_child("mjolnir"),
+                                                          baldr::TransitTimetable::kFileName);
+    try {
+      if (timetable_file.empty()) {
+        throw std::runtime_error(std::string(baldr::TransitTimetable::kFileName) +
+                                 " is neither in the tile_dir nor next to the tile_extract, "
+                                 "build it with valhalla_build_tiles -s timetable -e timetable");
+      }
+      connection_scan.set_timetable(std::make_shared<const baldr::TransitTimetable>(timetable_file));
+      use_connection_scan = true;
+    } catch (const std::exception& e) {
+      LOG_WARN("Not using the connection scan: " + std::string(e.what()));
+    }
+  }
+
   // signal that the worker started successfully
   started();
 }
@@ -117,7 +142,9 @@ thor_worker_t::work(const std::list<zmq::message_t>& job,
   // get request info and make sure to record any metrics before we are done
   auto& info = *static_cast<prime_server::http_request_info_t*>(request_info);
   LOG_INFO("Got Thor Request " + std::to_string(info.id));
-  Api request;
+  // the request lives in an arena backed by a buffer we reuse between requests
+  google::protobuf::Arena arena(arena_options());
+  Api& request = *google::protobuf::Arena::CreateMessage<Api>(&arena);
   prime_server::worker_t::result_t result{true, {}, {}};
   try {
     // crack open the original request
@@ -130,22 +157,30 @@ thor_worker_t::work(const std::list<zmq::message_t>& job,
 
     // Set the interrupt function
     service_worker_t::set_interrupt(&interrupt_function);
+    // read the same live traffic for the whole request, even while it is being updated
+    baldr::TrafficSnapshot traffic(traffic_epoch(request));
 
     // do request specific processing
     switch (options.action()) {
-      case Options::sources_to_targets:
-        result = to_response(matrix(request), info, request);
+      case Options::sources_to_targets: {
+        auto response = matrix(request);
+        cache_response(request, response);
+        result = to_response(response, info, request);
         break;
+      }
       case Options::optimized_route: {
         optimized_route(request);
         result.messages.emplace_back(serialize_to_pbf(request));
         break;
       }
-      case Options::isochrone:
-        result = to_response(isochrones(request), info, request);
+      case Options::isochrone: {
+        auto response = isochrones(request);
+        cache_response(request, response);
+        result = to_response(response, info, request);
         break;
+      }
       case Options::route: {
-        route(request);
+        cached_route(request);
         result.messages.emplace_back(serialize_to_pbf(request));
         break;
       }
@@ -154,11 +189,16 @@ thor_worker_t::work(const std::list<zmq::message_t>& job,
         result.messages.emplace_back(serialize_to_pbf(request));
         break;
       }
-      case Options::trace_attributes:
-        result = to_response(trace_attributes(request), info, request);
+      case Options::trace_attributes: {
+        auto response = trace_attributes(request);
+        cache_response(request, response);
+        result = to_response(response, info, request);
         break;
+      }
       case Options::expansion: {
-        result = to_response(expansion(request), info, request);
+        auto response = expansion(request);
+        cache_response(request, response);
+        result = to_response(response, info, request);
         break;
       }
       case Options::centroid: {
@@ -343,6 +383,7 @@ void thor_worker_t::cleanup() {
   timedep_forward.Clear();
   timedep_reverse.Clear();
   multi_modal_astar.Clear();
+  connection_scan.Clear();
   bss_astar.Clear();
   trace.clear();
   isochrone_gen.Clear();
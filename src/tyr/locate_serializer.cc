@@ -63,7 +63,7 @@ json::ArrayPtr serialize_edges(const PathLocation& location, GraphReader& reader
       // they want MOAR!
       if (verbose) {
         // live traffic information
-        const volatile auto& traffic = tile->trafficspeed(directed_edge);
+        auto traffic = tile->trafficspeed(directed_edge);
         auto live_speed = traffic.json();
 
         // incident information
@@ -102,6 +102,58 @@ std::string serializeStatus(Api& request) {
   status_doc.AddMember("tileset_last_modified",
                        rapidjson::Value().SetInt(request.status().tileset_last_modified()), alloc);
 
+  if (request.status().has_shared_tile_cache_capacity_case())
+    status_doc.AddMember("shared_tile_cache_capacity",
+                         rapidjson::Value().SetUint64(request.status().shared_tile_cache_capacity()),
+                         alloc);
+  if (request.status().has_shared_tile_cache_used_case())
+    status_doc.AddMember("shared_tile_cache_used",
+                         rapidjson::Value().SetUint64(request.status().shared_tile_cache_used()),
+                         alloc);
+  if (request.status().has_shared_tile_cache_tiles_case())
+    status_doc.AddMember("shared_tile_cache_tiles",
+                         rapidjson::Value().SetUint64(request.status().shared_tile_cache_tiles()),
+                         alloc);
+  if (request.status().has_shared_shortcut_cache_capacity_case())
+    status_doc.AddMember("shared_shortcut_cache_capacity",
+                         rapidjson::Value().SetUint64(
+                             request.status().shared_shortcut_cache_capacity()),
+                         alloc);
+  if (request.status().has_shared_shortcut_cache_used_case())
+    status_doc.AddMember("shared_shortcut_cache_used",
+                         rapidjson::Value().SetUint64(
+                             request.status().shared_shortcut_cache_used()),
+                         alloc);
+  if (request.status().has_shared_shortcut_cache_tiles_case())
+    status_doc.AddMember("shared_shortcut_cache_tiles",
+                         rapidjson::Value().SetUint64(
+                             request.status().shared_shortcut_cache_tiles()),
+                         alloc);
+
+  // how well the result cache is doing, the hit rates are hits / (hits + misses)
+  if (request.status().has_result_cache_hits_case())
+    status_doc.AddMember("result_cache_hits",
+                         rapidjson::Value().SetUint64(request.status().result_cache_hits()), alloc);
+  if (request.status().has_result_cache_misses_case())
+    status_doc.AddMember("result_cache_misses",
+                         rapidjson::Value().SetUint64(request.status().result_cache_misses()),
+                         alloc);
+  if (request.status().has_result_cache_path_hits_case())
+    status_doc.AddMember("result_cache_path_hits",
+                         rapidjson::Value().SetUint64(request.status().result_cache_path_hits()),
+                         alloc);
+  if (request.status().has_result_cache_path_misses_case())
+    status_doc.AddMember("result_cache_path_misses",
+                         rapidjson::Value().SetUint64(request.status().result_cache_path_misses()),
+                         alloc);
+  if (request.status().has_result_cache_capacity_case())
+    status_doc.AddMember("result_cache_capacity",
+                         rapidjson::Value().SetUint64(request.status().result_cache_capacity()),
+                         alloc);
+  if (request.status().has_result_cache_used_case())
+    status_doc.AddMember("result_cache_used",
+                         rapidjson::Value().SetUint64(request.status().result_cache_used()), alloc);
+
   if (request.status().has_has_tiles_case())
     status_doc.AddMember("has_tiles", rapidjson::Value().SetBool(request.status().has_tiles()),
                          alloc);
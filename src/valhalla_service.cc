@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -20,6 +22,7 @@
 using namespace prime_server;
 #endif
 
+#include "baldr/graphreader.h"
 #include "midgard/logging.h"
 
 #include "loki/worker.h"
@@ -27,10 +30,63 @@ using namespace prime_server;
 #include "thor/worker.h"
 #include "tyr/actor.h"
 
+namespace {
+
+#ifdef HAVE_HTTP
+// Loads the tiles of a region into the cache, the region is either a hierarchy level or a bounding
+// box given as min_lon,min_lat,max_lon,max_lat. The workers only see the preloaded tiles if they
+// share the cache with the reader we load them with, so this turns on the global synchronized cache
+void preload(boost::property_tree::ptree& config, const std::string& region, size_t concurrency) {
+  auto& mjolnir = config.get_child("mjolnir");
+  if (!mjolnir.get<bool>("global_synchronized_cache", false)) {
+    LOG_INFO("Enabling mjolnir.global_synchronized_cache so that the workers use the preloaded "
+             "tiles");
+    mjolnir.put("global_synchronized_cache", true);
+  }
+
+  // the cache is a static owned by the tile cache factory so it outlives this reader
+  valhalla::baldr::GraphReader reader(mjolnir);
+  std::vector<std::string> parts;
+  std::stringstream ss(region);
+  for (std::string part; std::getline(ss, part, ',');) {
+    parts.push_back(part);
+  }
+
+  size_t loaded = 0;
+  if (parts.size() == 1) {
+    loaded = reader.Preload(static_cast<uint8_t>(std::stoul(parts[0])), concurrency);
+  } else if (parts.size() == 4) {
+    valhalla::midgard::AABB2<valhalla::midgard::PointLL> bbox{std::stof(parts[0]),
+                                                              std::stof(parts[1]),
+                                                              std::stof(parts[2]),
+                                                              std::stof(parts[3])};
+    loaded = reader.Preload(bbox, concurrency);
+  } else {
+    throw std::runtime_error("--preload expects a level or min_lon,min_lat,max_lon,max_lat");
+  }
+  LOG_INFO("Preloaded " + std::to_string(loaded) + " tiles");
+}
+#endif
+
+} // namespace
+
 int main(int argc, char** argv) {
 #ifdef HAVE_HTTP
+  // pull out the optional preload argument so the positional ones stay where they are
+  std::string preload_region;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg.find("--preload=") == 0) {
+      preload_region = arg.substr(strlen("--preload="));
+      std::copy(argv + i + 1, argv + argc, argv + i);
+      --argc;
+      break;
+    }
+  }
+
   if (argc < 2 || argc > 4) {
-    LOG_ERROR("Usage: " + std::string(argv[0]) + " config/file.json [concurrency]");
+    LOG_ERROR("Usage: " + std::string(argv[0]) +
+              " config/file.json [concurrency] [--preload=level|min_lon,min_lat,max_lon,max_lat]");
     LOG_ERROR("Usage: " + std::string(argv[0]) + " config/file.json action json_request");
     return 1;
   }
@@ -180,6 +236,12 @@ int main(int argc, char** argv) {
     worker_concurrency = std::stoul(argv[2]);
   }
 
+  // warm up the tile cache before we start taking requests, this has to happen before the workers
+  // get their copy of the config
+  if (!preload_region.empty()) {
+    preload(config, preload_region, worker_concurrency);
+  }
+
   // setup the cluster within this process
   zmq::context_t context;
   std::thread server_thread =
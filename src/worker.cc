@@ -6,6 +6,7 @@
 #include "baldr/datetime.h"
 #include "baldr/graphconstants.h"
 #include "baldr/location.h"
+#include "baldr/traffictile.h"
 #include "loki/worker.h"
 #include "midgard/encoded.h"
 #include "midgard/logging.h"
@@ -1082,6 +1083,13 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
                            options.has_roundabout_exits_case() ? options.roundabout_exits() : true);
   options.set_roundabout_exits(roundabout_exits);
 
+  // whether to form the verbal instructions of the maneuvers, default true
+  auto verbal_instructions =
+      rapidjson::get<bool>(doc, "/verbal_instructions",
+                           options.has_verbal_instructions_case() ? options.verbal_instructions()
+                                                                  : true);
+  options.set_verbal_instructions(verbal_instructions);
+
   // force these into the output so its obvious what we did to the user
   doc.AddMember({"language", allocator}, {options.language(), allocator}, allocator);
   doc.AddMember({"format", allocator},
@@ -1163,6 +1171,41 @@ void ParseApi(const std::string& request, Options::Action action, valhalla::Api&
   from_json(document, action, api);
 }
 
+void prune_for(Stage next, Api& api) {
+  // if they asked for the options back in the pbf they would see what we leave out
+  auto& options = *api.mutable_options();
+  if (options.format() == Options::pbf && options.pbf_field_selector().options()) {
+    return;
+  }
+
+  switch (next) {
+    // loki already turned these into excluded edges on the costing
+    case Stage::kThor:
+      options.clear_exclude_locations();
+      options.clear_exclude_polygons();
+      break;
+    // the path is found so the other candidates are only there for the waypoints in the osrm
+    // format, which want the first one, and the number of alternatives of each trace point
+    case Stage::kOdin:
+      for (auto* locations :
+           {options.mutable_locations(), options.mutable_sources(), options.mutable_targets()}) {
+        for (auto& location : *locations) {
+          auto& edges = *location.mutable_correlation()->mutable_edges();
+          if (edges.size() > 1) {
+            edges.DeleteSubrange(1, edges.size() - 1);
+          }
+          location.mutable_correlation()->clear_filtered_edges();
+        }
+      }
+      for (auto* locations : {options.mutable_shape(), options.mutable_trace()}) {
+        for (auto& location : *locations) {
+          location.mutable_correlation()->clear_filtered_edges();
+        }
+      }
+      break;
+  }
+}
+
 #ifdef HAVE_HTTP
 void ParseApi(const http_request_t& request, valhalla::Api& api) {
   // block all but get and post
@@ -1312,10 +1355,16 @@ struct statsd_client_t : public Statsd::StatsdClient {
   std::vector<std::string> tags;
 };
 
-service_worker_t::service_worker_t(const boost::property_tree::ptree& conf) : interrupt(nullptr) {
+service_worker_t::service_worker_t(const boost::property_tree::ptree& conf)
+    : interrupt(nullptr),
+      arena_block_size(conf.get<size_t>("httpd.service.arena_block_size", 1024 * 1024)),
+      result_cache(ResultCache::Get(conf)) {
   if (conf.count("statsd")) {
     statsd_client = std::make_unique<statsd_client_t>(conf);
   }
+  if (arena_block_size) {
+    arena_block.reset(new char[arena_block_size]);
+  }
 }
 service_worker_t::~service_worker_t() {
 }
@@ -1378,6 +1427,26 @@ midgard::Finally<std::function<void()>> service_worker_t::measure_scope_time(Api
   });
 }
 
+google::protobuf::ArenaOptions service_worker_t::arena_options() const {
+  google::protobuf::ArenaOptions options;
+  options.initial_block = arena_block.get();
+  options.initial_block_size = arena_block ? arena_block_size : 0;
+  return options;
+}
+
+void service_worker_t::cache_response(const Api& api, const std::string& response) const {
+  if (result_cache && !api.info().cache_key().empty()) {
+    result_cache->Insert(api.info().cache_key(), response);
+  }
+}
+
+uint32_t service_worker_t::traffic_epoch(Api& api) {
+  if (!api.info().traffic_epoch()) {
+    api.mutable_info()->set_traffic_epoch(baldr::TrafficSnapshot::published());
+  }
+  return api.info().traffic_epoch();
+}
+
 void service_worker_t::started() {
   if (statsd_client) {
     statsd_client->count("none.info." + service_name() + ".worker_started", 1, 1.f,
@@ -0,0 +1,95 @@
+#include "midgard/arena.h"
+
+#include "test.h"
+
+using namespace valhalla::midgard;
+
+namespace {
+
+TEST(Arena, Alignment) {
+  MonotonicArena arena(1024, 128);
+  for (size_t alignment : {1, 2, 4, 8, 16, 32}) {
+    auto* ptr = arena.allocate(3, alignment);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0);
+  }
+}
+
+TEST(Arena, ValueInitialized) {
+  MonotonicArena arena(1024, 64);
+  auto* ints = arena.allocate_array<uint32_t>(1000);
+  for (size_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(ints[i], 0);
+  }
+  // dirty the memory, reset and make sure we get zeros again
+  std::fill_n(ints, 1000, 0xdeadbeef);
+  arena.reset();
+  ints = arena.allocate_array<uint32_t>(1000);
+  for (size_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(ints[i], 0);
+  }
+}
+
+TEST(Arena, ReuseAfterReset) {
+  MonotonicArena arena(1024 * 1024, 1024);
+
+  // the first round has to go to the system
+  for (int i = 0; i < 10; ++i) {
+    arena.allocate(500);
+  }
+  EXPECT_EQ(arena.allocations(), 10);
+  EXPECT_EQ(arena.bytes_allocated(), 5000);
+  EXPECT_GT(arena.block_allocations(), 0);
+  auto capacity = arena.capacity();
+
+  // the same pattern again should not need any more blocks
+  arena.reset();
+  for (int i = 0; i < 10; ++i) {
+    arena.allocate(500);
+  }
+  EXPECT_EQ(arena.block_allocations(), 0);
+  EXPECT_EQ(arena.capacity(), capacity);
+
+  // oversized allocations get their own block
+  arena.reset();
+  arena.allocate(4096);
+  EXPECT_GE(arena.capacity(), capacity);
+}
+
+TEST(Arena, GeometricGrowth) {
+  MonotonicArena arena(1024 * 1024, 1024, 8192);
+
+  // blocks start small and double until they reach the max block size
+  arena.allocate(1000);
+  EXPECT_EQ(arena.capacity(), 1024);
+  arena.allocate(1000);
+  EXPECT_EQ(arena.capacity(), 1024 + 2048);
+  for (int i = 0; i < 20; ++i) {
+    arena.allocate(1000);
+  }
+  EXPECT_EQ(arena.block_allocations(), 5);
+  EXPECT_EQ(arena.capacity(), 1024 + 2048 + 4096 + 8192 + 8192);
+
+  // an unused arena does not hold any memory
+  MonotonicArena unused;
+  EXPECT_EQ(unused.capacity(), 0);
+}
+
+TEST(Arena, RetentionLimit) {
+  MonotonicArena arena(2048, 1024, 1024);
+  for (int i = 0; i < 10; ++i) {
+    arena.allocate(1000);
+  }
+  EXPECT_GE(arena.capacity(), 10 * 1000);
+  arena.reset();
+  EXPECT_LE(arena.capacity(), 2048);
+
+  arena.release();
+  EXPECT_EQ(arena.capacity(), 0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
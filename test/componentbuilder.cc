@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "mjolnir/componentbuilder.h"
+
+#include "test.h"
+
+using namespace valhalla::mjolnir;
+
+namespace {
+
+using graph_t = std::vector<std::vector<uint32_t>>;
+
+ComponentBuilder::labels_t label(const graph_t& graph) {
+  // neighbors are the successors plus the predecessors
+  graph_t undirected(graph.size());
+  for (uint32_t node = 0; node < graph.size(); ++node) {
+    for (auto successor : graph[node]) {
+      undirected[node].push_back(successor);
+      undirected[successor].push_back(node);
+    }
+  }
+  return ComponentBuilder::Label(
+      graph.size(),
+      [&graph](uint32_t node, std::vector<uint32_t>& out) {
+        out.insert(out.end(), graph[node].begin(), graph[node].end());
+      },
+      [&undirected](uint32_t node, std::vector<uint32_t>& out) {
+        out.insert(out.end(), undirected[node].begin(), undirected[node].end());
+      });
+}
+
+// same logic as baldr::ComponentLabels::MayReach
+bool may_reach(const ComponentBuilder::labels_t& labels, uint32_t from, uint32_t to) {
+  auto from_label = labels.labels[from];
+  auto to_label = labels.labels[to];
+  auto island = [&labels](uint32_t label) {
+    return std::upper_bound(labels.islands.begin(), labels.islands.end(), label) -
+           labels.islands.begin();
+  };
+  return from_label == to_label || (island(from_label) == island(to_label) && to_label < from_label);
+}
+
+std::vector<bool> reachable(const graph_t& graph, uint32_t from) {
+  std::vector<bool> seen(graph.size(), false);
+  std::vector<uint32_t> todo{from};
+  seen[from] = true;
+  while (!todo.empty()) {
+    auto node = todo.back();
+    todo.pop_back();
+    for (auto successor : graph[node]) {
+      if (!seen[successor]) {
+        seen[successor] = true;
+        todo.push_back(successor);
+      }
+    }
+  }
+  return seen;
+}
+
+TEST(ComponentBuilder, OnewayTrapAndIsland) {
+  // 0 <-> 1 <-> 2 is a two way street, 1 -> 3 is a oneway into a dead end and 4 <-> 5 is an island
+  graph_t graph{{1}, {0, 2, 3}, {1}, {}, {5}, {4}};
+  auto labels = label(graph);
+
+  EXPECT_EQ(labels.labels[0], labels.labels[1]);
+  EXPECT_EQ(labels.labels[1], labels.labels[2]);
+  EXPECT_NE(labels.labels[1], labels.labels[3]);
+  EXPECT_EQ(labels.labels[4], labels.labels[5]);
+  EXPECT_EQ(labels.islands.size(), 2);
+
+  // into the trap is fine, out of it isnt and neither is the island
+  EXPECT_TRUE(may_reach(labels, 0, 3));
+  EXPECT_FALSE(may_reach(labels, 3, 0));
+  EXPECT_FALSE(may_reach(labels, 0, 4));
+  EXPECT_FALSE(may_reach(labels, 4, 3));
+  EXPECT_TRUE(may_reach(labels, 5, 4));
+}
+
+TEST(ComponentBuilder, NeverRejectsReachable) {
+  // random sparse graphs with plenty of oneways and islands
+  std::mt19937 gen(7);
+  for (int round = 0; round < 50; ++round) {
+    graph_t graph(200);
+    std::uniform_int_distribution<uint32_t> node(0, graph.size() - 1);
+    for (int edge = 0; edge < 220; ++edge) {
+      graph[node(gen)].push_back(node(gen));
+    }
+    auto labels = label(graph);
+
+    size_t rejected = 0;
+    for (uint32_t from = 0; from < graph.size(); ++from) {
+      auto reach = reachable(graph, from);
+      for (uint32_t to = 0; to < graph.size(); ++to) {
+        if (reach[to]) {
+          ASSERT_TRUE(may_reach(labels, from, to)) << from << " -> " << to;
+        }
+        rejected += !may_reach(labels, from, to);
+      }
+    }
+    // its only useful if it actually rejects something
+    EXPECT_GT(rejected, 0);
+  }
+}
+
+TEST(ComponentBuilder, LongChain) {
+  // deep enough that a recursive implementation would blow the stack
+  graph_t graph(1000000);
+  for (uint32_t node = 0; node + 1 < graph.size(); ++node) {
+    graph[node].push_back(node + 1);
+  }
+  auto labels = label(graph);
+  EXPECT_EQ(labels.islands.size(), 1);
+  EXPECT_TRUE(may_reach(labels, 0, graph.size() - 1));
+  EXPECT_FALSE(may_reach(labels, graph.size() - 1, 0));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
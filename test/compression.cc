@@ -1,6 +1,7 @@
 #include "baldr/compression_utils.h"
 
 #include <string>
+#include <vector>
 
 #include "test.h"
 
@@ -136,6 +137,88 @@ TEST(Compression, fail_inflate) {
   EXPECT_FALSE(inflate_result);
 }
 
+// records of the sort a dictionary is good at, lots of structure and a few different values
+std::vector<char> make_record(size_t i) {
+  std::string record;
+  for (size_t j = 0; j < 16; ++j) {
+    record += "{\"way_id\":" + std::to_string(i * 7919 + j) +
+              ",\"speed\":" + std::to_string(10 + (i + j) % 90) +
+              ",\"names\":[\"Oudegracht\",\"Lange Nieuwstraat\"],\"access\":{\"auto\":" +
+              ((i + j) % 3 ? "true" : "false") + "}}";
+  }
+  return std::vector<char>(record.begin(), record.end());
+}
+
+TEST(Compression, zstd_roundtrip) {
+  auto record = make_record(1);
+  std::vector<char> compressed, decompressed;
+  if (!valhalla::baldr::zstd_supported()) {
+    EXPECT_FALSE(valhalla::baldr::zstd_compress(record.data(), record.size(), compressed));
+    EXPECT_THROW(valhalla::baldr::ZstdDictionary{record}, std::runtime_error);
+    return;
+  }
+
+  ASSERT_TRUE(valhalla::baldr::zstd_compress(record.data(), record.size(), compressed));
+  EXPECT_LT(compressed.size(), record.size());
+  EXPECT_EQ(valhalla::baldr::zstd_dictionary_id(compressed.data(), compressed.size()), 0);
+  ASSERT_TRUE(
+      valhalla::baldr::zstd_decompress(compressed.data(), compressed.size(), decompressed));
+  EXPECT_EQ(decompressed, record);
+
+  // cut off or not zstd at all
+  EXPECT_FALSE(
+      valhalla::baldr::zstd_decompress(compressed.data(), compressed.size() / 2, decompressed));
+  EXPECT_FALSE(valhalla::baldr::zstd_decompress(record.data(), record.size(), decompressed));
+}
+
+TEST(Compression, zstd_dictionary) {
+  if (!valhalla::baldr::zstd_supported()) {
+    return;
+  }
+
+  // train on some records
+  std::vector<char> samples;
+  std::vector<size_t> sizes;
+  for (size_t i = 0; i < 500; ++i) {
+    auto record = make_record(i);
+    samples.insert(samples.end(), record.begin(), record.end());
+    sizes.push_back(record.size());
+  }
+  auto trained = valhalla::baldr::ZstdDictionary::Train(samples, sizes, 4096);
+  EXPECT_LE(trained.size(), 4096);
+  sizes.back() += 1;
+  EXPECT_THROW(valhalla::baldr::ZstdDictionary::Train(samples, sizes, 4096), std::runtime_error);
+  EXPECT_THROW(valhalla::baldr::ZstdDictionary{std::vector<char>(100, 'x')}, std::runtime_error);
+
+  // one that hasnt been seen does better with the dictionary than without it
+  valhalla::baldr::ZstdDictionary dictionary(trained, 19);
+  EXPECT_NE(dictionary.id(), 0);
+  EXPECT_EQ(dictionary.level(), 19);
+  auto record = make_record(1000);
+  std::vector<char> plain, compressed, decompressed;
+  ASSERT_TRUE(valhalla::baldr::zstd_compress(record.data(), record.size(), plain, 19));
+  ASSERT_TRUE(valhalla::baldr::zstd_compress(record.data(), record.size(), compressed, 19,
+                                             &dictionary));
+  EXPECT_LT(compressed.size(), plain.size());
+  EXPECT_EQ(valhalla::baldr::zstd_dictionary_id(compressed.data(), compressed.size()),
+            dictionary.id());
+
+  // it takes the dictionary to decompress it
+  EXPECT_FALSE(
+      valhalla::baldr::zstd_decompress(compressed.data(), compressed.size(), decompressed));
+  ASSERT_TRUE(valhalla::baldr::zstd_decompress(compressed.data(), compressed.size(), decompressed,
+                                               &dictionary));
+  EXPECT_EQ(decompressed, record);
+
+  // a dictionary only for decompressing cant compress
+  valhalla::baldr::ZstdDictionary decompressor(trained);
+  EXPECT_FALSE(valhalla::baldr::zstd_compress(record.data(), record.size(), compressed, 19,
+                                              &decompressor));
+  ASSERT_TRUE(valhalla::baldr::zstd_decompress(plain.data(), plain.size(), decompressed,
+                                               &decompressor));
+  EXPECT_EQ(decompressed, record);
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
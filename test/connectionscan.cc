@@ -0,0 +1,230 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "baldr/transittimetable.h"
+#include "thor/connectionscan.h"
+
+#include "test.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::thor;
+
+namespace {
+
+constexpr uint32_t kAll = TransitTimetable::kWheelchairAccessible |
+                          TransitTimetable::kBicycleAccessible;
+
+// stops 0 through 6, the trips going from 0 to 3 are:
+//   trip 0 rides 0-1-2 and trip 2 goes on 2-3, trip 1 leaves 2 too soon after trip 0 gets there
+//   trip 3 and trip 7 go straight there but take longer, trip 7 only takes bicycles
+//   trip 5 would be the quickest but never runs, trip 6 only runs on one day of the week
+// and trip 4 goes 4-5 which you can walk to from stop 1, you can walk on from 4 to 6 as well
+// trip 8 goes 4-5 too but leaves after midnight, its the day before's trip in the early morning
+std::shared_ptr<const TransitTimetable> timetable() {
+  static std::shared_ptr<const TransitTimetable> timetable;
+  if (timetable) {
+    return timetable;
+  }
+
+  std::vector<TransitTimetable::stop_t> stops;
+  for (uint64_t node = 1; node <= 7; ++node) {
+    stops.push_back({node, 0, 0});
+  }
+  std::vector<TransitTimetable::schedule_t> schedules{
+      {~0ULL, 0x7f, 63, 0, 0},
+      {0, 0, 63, 0, 0},
+      {0, 1 << 3, 0, 0, 0},
+  };
+  std::vector<TransitTimetable::connection_t> connections{
+      {10, 100, 200, 0, 1, 0, 100, 0, kAll},
+      {11, 210, 300, 1, 2, 0, 100, 0, kAll},
+      {12, 320, 400, 2, 3, 1, 101, 0, kAll},
+      {12, 340, 450, 2, 3, 2, 102, 0, 0},
+      {13, 150, 500, 0, 3, 3, 103, 0, kAll},
+      {14, 270, 320, 4, 5, 4, 104, 0, kAll},
+      {13, 120, 300, 0, 3, 5, 105, 1, kAll},
+      {13, 130, 350, 0, 3, 6, 106, 2, kAll},
+      {13, 160, 480, 0, 3, 7, 107, 0, TransitTimetable::kBicycleAccessible},
+      {14, 86410, 86500, 4, 5, 8, 108, 0, kAll},
+  };
+  std::vector<std::vector<TransitTimetable::footpath_t>> footpaths(stops.size());
+  footpaths[1].push_back({4, 60, 100});
+  footpaths[4].push_back({1, 60, 100});
+  footpaths[4].push_back({6, 60, 100});
+
+  std::string file_name = "test/data/connectionscan_timetable.bin";
+  TransitTimetable::Write(file_name, stops, schedules, connections, footpaths, 9);
+  timetable = std::make_shared<const TransitTimetable>(file_name);
+  return timetable;
+}
+
+ConnectionScan::filter_t filter() {
+  return {10, 1, 0, 805, 30};
+}
+
+TEST(ConnectionScan, ReadBack) {
+  auto t = timetable();
+  EXPECT_EQ(t->stop_count(), 7);
+  EXPECT_EQ(t->trip_count(), 9);
+  EXPECT_EQ(t->find_stop(GraphId(3)), 2);
+  EXPECT_EQ(t->find_stop(GraphId(8)), TransitTimetable::kInvalidStop);
+
+  // only trip 0 has more than one hop
+  uint32_t departure = 0;
+  const auto connections = t->connections();
+  for (const auto& connection : connections) {
+    EXPECT_GE(connection.departure, departure);
+    departure = connection.departure;
+    if (connection.tripid == 100 && connection.departure == 100) {
+      ASSERT_NE(connection.next, TransitTimetable::kNoConnection);
+      EXPECT_EQ(connections[connection.next].tripid, 100);
+      EXPECT_EQ(connections[connection.next].departure, 210);
+    } else {
+      EXPECT_EQ(connection.next, TransitTimetable::kNoConnection);
+    }
+  }
+  EXPECT_EQ(t->first_departure(125)->departure, 130);
+  EXPECT_EQ(t->footpaths(1).size(), 1);
+  EXPECT_EQ(t->footpaths(1).begin()->stop, 4);
+  EXPECT_EQ(t->footpaths(0).size(), 0);
+}
+
+TEST(ConnectionScan, EarliestArrival) {
+  ConnectionScan scan(timetable());
+  ConnectionScan::journey_t journey;
+  ASSERT_TRUE(scan.EarliestArrival({{0, 20}}, {{3, 10}}, 0, filter(), journey));
+
+  // staying on trip 0 at stop 1 doesnt need a transfer but getting off at 2 means missing trip 1
+  EXPECT_EQ(journey.departure, 80);
+  EXPECT_EQ(journey.arrival, 460);
+  ASSERT_EQ(journey.legs.size(), 2);
+  EXPECT_EQ(journey.legs[0].from_stop, 0);
+  EXPECT_EQ(journey.legs[0].to_stop, 2);
+  EXPECT_EQ(journey.legs[0].board->tripid, 100);
+  EXPECT_EQ(journey.legs[0].alight->arrival, 300);
+  EXPECT_EQ(journey.legs[1].board->tripid, 102);
+  EXPECT_EQ(journey.access.stop, 0);
+  EXPECT_EQ(journey.egress.stop, 3);
+
+  // leaving too late for trip 0 gets the direct one
+  ASSERT_TRUE(scan.EarliestArrival({{0, 0}}, {{3, 0}}, 101, filter(), journey));
+  EXPECT_EQ(journey.arrival, 480);
+  ASSERT_EQ(journey.legs.size(), 1);
+  EXPECT_EQ(journey.legs[0].board->tripid, 107);
+
+  // and after the last one its tomorrows trips
+  ASSERT_TRUE(scan.EarliestArrival({{0, 0}}, {{3, 0}}, 161, filter(), journey));
+  EXPECT_EQ(journey.arrival, 86850);
+  ASSERT_EQ(journey.legs.size(), 2);
+  EXPECT_EQ(journey.legs[0].shift, 86400);
+  EXPECT_EQ(journey.legs[0].departure, 86500);
+  EXPECT_EQ(journey.legs[0].alight->arrival, 300);
+}
+
+TEST(ConnectionScan, AfterMidnight) {
+  ConnectionScan scan(timetable());
+  ConnectionScan::journey_t journey;
+
+  // early in the morning yesterdays trip is still going
+  ASSERT_TRUE(scan.EarliestArrival({{4, 0}}, {{5, 0}}, 0, filter(), journey));
+  EXPECT_EQ(journey.arrival, 100);
+  ASSERT_EQ(journey.legs.size(), 1);
+  EXPECT_EQ(journey.legs[0].board->tripid, 108);
+  EXPECT_EQ(journey.legs[0].shift, -86400);
+  EXPECT_EQ(journey.legs[0].departure, 10);
+
+  // and late at night its todays
+  ASSERT_TRUE(scan.EarliestArrival({{4, 0}}, {{5, 0}}, 86000, filter(), journey));
+  EXPECT_EQ(journey.arrival, 86500);
+  EXPECT_EQ(journey.legs[0].shift, 0);
+
+  // tomorrow goes by its own day of the week, trip 6 runs on the wednesday after a tuesday
+  auto tuesday = filter();
+  tuesday.dow = 1 << 2;
+  ASSERT_TRUE(scan.EarliestArrival({{0, 0}}, {{3, 0}}, 161, tuesday, journey));
+  EXPECT_EQ(journey.arrival, 86750);
+  EXPECT_EQ(journey.legs[0].board->tripid, 106);
+}
+
+TEST(ConnectionScan, Footpath) {
+  ConnectionScan scan(timetable());
+  ConnectionScan::journey_t journey;
+  ASSERT_TRUE(scan.EarliestArrival({{0, 0}}, {{5, 10}}, 0, filter(), journey));
+  EXPECT_EQ(journey.arrival, 330);
+  ASSERT_EQ(journey.legs.size(), 3);
+  EXPECT_EQ(journey.legs[1].board, nullptr);
+  EXPECT_EQ(journey.legs[1].from_stop, 1);
+  EXPECT_EQ(journey.legs[1].to_stop, 4);
+  EXPECT_EQ(journey.legs[1].departure, 200);
+  EXPECT_EQ(journey.legs[1].arrival, 260);
+  EXPECT_EQ(journey.legs[2].board->tripid, 104);
+
+  // footpaths keep going from stops you walked to
+  ASSERT_TRUE(scan.EarliestArrival({{0, 0}}, {{6, 0}}, 0, filter(), journey));
+  EXPECT_EQ(journey.arrival, 320);
+  ASSERT_EQ(journey.legs.size(), 3);
+  EXPECT_EQ(journey.legs[1].to_stop, 4);
+  EXPECT_EQ(journey.legs[2].board, nullptr);
+  EXPECT_EQ(journey.legs[2].from_stop, 4);
+  EXPECT_EQ(journey.legs[2].to_stop, 6);
+
+  // too far to walk
+  auto short_walks = filter();
+  short_walks.max_transfer_distance = 50;
+  EXPECT_FALSE(scan.EarliestArrival({{0, 0}}, {{5, 10}}, 0, short_walks, journey));
+}
+
+TEST(ConnectionScan, ScheduleDays) {
+  ConnectionScan scan(timetable());
+  ConnectionScan::journey_t journey;
+
+  // trip 6 only runs on one day of the week, trip 5 never does
+  auto wednesday = filter();
+  wednesday.dow = 1 << 3;
+  ASSERT_TRUE(scan.EarliestArrival({{0, 0}}, {{3, 0}}, 0, wednesday, journey));
+  EXPECT_EQ(journey.arrival, 350);
+  EXPECT_EQ(journey.legs.front().board->tripid, 106);
+
+  ASSERT_TRUE(scan.EarliestArrival({{0, 0}}, {{3, 0}}, 0, filter(), journey));
+  EXPECT_EQ(journey.arrival, 450);
+}
+
+TEST(ConnectionScan, Wheelchair) {
+  ConnectionScan scan(timetable());
+  ConnectionScan::journey_t journey;
+  auto wheelchair = filter();
+  wheelchair.flags = TransitTimetable::kWheelchairAccessible;
+  ASSERT_TRUE(scan.EarliestArrival({{0, 0}}, {{3, 0}}, 0, wheelchair, journey));
+  EXPECT_EQ(journey.arrival, 500);
+  EXPECT_EQ(journey.legs.front().board->tripid, 103);
+}
+
+TEST(ConnectionScan, Range) {
+  ConnectionScan scan(timetable());
+
+  // leaving at 150 is beaten by leaving at 160 so only the other two are worth it
+  auto journeys = scan.Range({{0, 0}}, {{3, 0}}, 0, 200, filter(), 5);
+  ASSERT_EQ(journeys.size(), 2);
+  EXPECT_EQ(journeys[0].departure, 100);
+  EXPECT_EQ(journeys[0].arrival, 450);
+  EXPECT_EQ(journeys[1].departure, 160);
+  EXPECT_EQ(journeys[1].arrival, 480);
+
+  // the window cuts off the later one
+  journeys = scan.Range({{0, 0}}, {{3, 0}}, 0, 120, filter(), 5);
+  ASSERT_EQ(journeys.size(), 1);
+  EXPECT_EQ(journeys[0].departure, 100);
+
+  // and so can the count
+  journeys = scan.Range({{0, 0}}, {{3, 0}}, 0, 200, filter(), 1);
+  ASSERT_EQ(journeys.size(), 1);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,9 +1,12 @@
 
+#include <chrono>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "baldr/datetime.h"
 #include "baldr/graphconstants.h"
+#include "baldr/time_info.h"
 #include "baldr/timedomain.h"
 #include "midgard/constants.h"
 
@@ -698,9 +701,102 @@ TEST(DateTime, DiffCaching) {
     }
   }
   EXPECT_NE(total_offset, 0);
+
+  // the transition tables answer all of those so the cache is only used past the end of them
+  EXPECT_TRUE(cache.empty());
+  for (const auto& test_case : test_cases) {
+    DateTime::timezone_diff(DateTime::tz_transitions_t::kEnd + 1586579654,
+                            tzdb.from_index(std::get<1>(test_case)),
+                            tzdb.from_index(std::get<2>(test_case)), &cache);
+  }
   EXPECT_GE(cache.size(), test_cases.size());
 }
 
+TEST(DateTime, TransitionTables) {
+  const auto& tzdb = DateTime::get_tz_db();
+  const auto& transitions = DateTime::get_tz_transitions();
+  EXPECT_EQ(tzdb.to_index(tzdb.from_index(110)), 110);
+  EXPECT_EQ(tzdb.to_index(static_cast<const date::time_zone*>(nullptr)), 0);
+
+  // the table has to agree with the tz db either side of every transition in a few zones
+  for (const auto* name : {"America/New_York", "Europe/London", "Australia/Lord_Howe",
+                           "Asia/Kolkata", "America/Santiago", "Pacific/Chatham"}) {
+    const auto* tz = date::locate_zone(name);
+    auto index = tzdb.to_index(tz);
+    ASSERT_NE(index, 0) << name;
+    for (int64_t t = 946684800; t < 2524608000; t += 86400 * 7 + 3613) {
+      date::sys_seconds tp{std::chrono::seconds(t)};
+      auto info = tz->get_info(tp);
+      EXPECT_EQ(transitions.offset(index, t), info.offset.count()) << name << " " << t;
+      auto edge = info.end.time_since_epoch().count();
+      if (edge < DateTime::tz_transitions_t::kEnd) {
+        EXPECT_EQ(transitions.offset(index, edge - 1), info.offset.count()) << name << " " << edge;
+        EXPECT_EQ(transitions.offset(index, edge), tz->get_info(info.end).offset.count())
+            << name << " " << edge;
+      }
+    }
+  }
+
+  // zones are the same by pointer as by index, invalid zones have no offset
+  const auto* ny = tzdb.from_index(110);
+  EXPECT_EQ(transitions.offset(ny, 1586660072), transitions.offset(110, 1586660072));
+  EXPECT_EQ(transitions.offset(static_cast<const date::time_zone*>(nullptr), 1586660072), 0);
+  EXPECT_EQ(transitions.offset(0, 1586660072), 0);
+  EXPECT_EQ(transitions.offset(size_t(100000), 1586660072), 0);
+
+  // and the batch matches one at a time
+  std::vector<uint64_t> seconds;
+  std::vector<uint32_t> zones;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    seconds.push_back(1583000000 + i * 3600);
+    zones.push_back(i % 300 < 200 ? 110 : 94);
+  }
+  std::vector<int32_t> offsets(seconds.size());
+  transitions.offsets(seconds.data(), zones.data(), seconds.size(), offsets.data());
+  for (size_t i = 0; i < seconds.size(); ++i) {
+    EXPECT_EQ(offsets[i], transitions.offset(zones[i], seconds[i])) << i;
+  }
+}
+
+TEST(DateTime, BatchForward) {
+  // an index past the end of the tz db, like a zone from tiles built with a newer one
+  const auto& tzdb = DateTime::get_tz_db();
+  uint32_t unknown = 1;
+  while (tzdb.from_index(unknown))
+    ++unknown;
+  ASSERT_LT(unknown, 512);
+
+  // the batch has to match one at a time from any origin, known or not, to any destination
+  std::vector<float> offsets;
+  std::vector<uint32_t> zones;
+  for (uint32_t i = 0; i < 400; ++i) {
+    offsets.push_back(i * 3600.f);
+    zones.push_back(std::vector<uint32_t>{110, 94, 0, unknown}[i % 4]);
+  }
+  for (uint32_t origin : {110u, 94u, 0u, unknown}) {
+    const TimeInfo time_info{true, origin, 1583000000, 3600, 0, false, nullptr};
+    const auto batch = time_info.forward(offsets, zones);
+    ASSERT_EQ(batch.size(), offsets.size());
+    for (size_t i = 0; i < offsets.size(); ++i) {
+      const auto one = time_info.forward(offsets[i], zones[i]);
+      EXPECT_EQ(batch[i].local_time, one.local_time) << origin << " " << i;
+      EXPECT_EQ(batch[i].second_of_week, one.second_of_week) << origin << " " << i;
+      EXPECT_EQ(batch[i].timezone_index, one.timezone_index) << origin << " " << i;
+    }
+  }
+}
+
+TEST(DateTime, LocalTimeFormat) {
+  // across the dst change in new york and in a zone thats not on the hour
+  const auto* ny = date::locate_zone("America/New_York");
+  EXPECT_EQ(DateTime::seconds_to_date(1583650740, ny, true), "2020-03-08T01:59-05:00");
+  EXPECT_EQ(DateTime::seconds_to_date(1583650800, ny, true), "2020-03-08T03:00-04:00");
+  EXPECT_EQ(DateTime::seconds_to_date(1583650800, ny, false), "2020-03-08T03:00");
+  EXPECT_EQ(DateTime::seconds_to_date(1583650800, date::locate_zone("Asia/Kathmandu"), true),
+            "2020-03-08T12:45+05:45");
+  EXPECT_EQ(DateTime::seconds_to_date(0, ny, true), "");
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -1,7 +1,9 @@
 #include "midgard/encoded.h"
+#include "midgard/varint.h"
 
 #include "test.h"
 
+#include <limits>
 #include <string>
 
 using namespace std;
@@ -659,6 +661,74 @@ TEST(Encode, AllZeros) {
   }
 }
 
+// every value length both formats can produce, including the extremes
+std::vector<int32_t> kernel_values() {
+  std::vector<int32_t> values{0, 1, -1, std::numeric_limits<int32_t>::max() / 2,
+                              std::numeric_limits<int32_t>::min() / 2};
+  for (int shift = 0; shift < 30; ++shift) {
+    values.push_back((1 << shift) + shift);
+    values.push_back(-(1 << shift) - shift);
+  }
+  // something like a shape with mostly short deltas
+  for (int i = 0; i < 200; ++i) {
+    values.push_back((i * 7919) % 2001 - 1000);
+  }
+  return values;
+}
+
+TEST(Encode, VarintKernels) {
+  const auto values = kernel_values();
+  std::string scalar5, scalar7;
+  ASSERT_TRUE(varint::use_kernel(varint::Kernel::kScalar));
+  varint::encode5(values.data(), values.size(), scalar5);
+  varint::encode7(values.data(), values.size(), scalar7);
+
+  for (auto kernel : {varint::Kernel::kScalar, varint::Kernel::kSimd}) {
+    if (!varint::use_kernel(kernel)) {
+      continue;
+    }
+
+    // the kernels have to produce exactly the same bytes
+    std::string encoded5, encoded7;
+    varint::encode5(values.data(), values.size(), encoded5);
+    varint::encode7(values.data(), values.size(), encoded7);
+    EXPECT_EQ(encoded5, scalar5);
+    EXPECT_EQ(encoded7, scalar7);
+
+    // decoding in odd sized pieces gets them all back
+    for (const auto* encoded : {&scalar5, &scalar7}) {
+      auto decode = [&encoded, &scalar5](const char*& begin, const char* end, int32_t* values,
+                                         size_t count) {
+        return encoded == &scalar5 ? varint::decode5(begin, end, values, count)
+                                   : varint::decode7(begin, end, values, count);
+      };
+      std::vector<int32_t> decoded(values.size() + 1);
+      const char* begin = encoded->data();
+      const char* end = begin + encoded->size();
+      size_t count = 0;
+      for (size_t piece = 1; size_t got = decode(begin, end, decoded.data() + count, piece % 13 + 1);
+           ++piece) {
+        count += got;
+      }
+      decoded.resize(count);
+      EXPECT_EQ(begin, end);
+      EXPECT_EQ(decoded, values);
+
+      // the last value being cut off stops the decoding just before it
+      begin = encoded->data();
+      end = begin + encoded->size() - 1;
+      decoded.resize(values.size());
+      EXPECT_EQ(decode(begin, end, decoded.data(), decoded.size()), values.size() - 1);
+    }
+
+    // and a cut off shape still throws
+    auto encoded = encode<container_t>(container_t{{-76.3002, 40.0433}, {-76.3001, 40.0435}});
+    encoded.pop_back();
+    EXPECT_THROW(decode<container_t>(encoded), std::runtime_error);
+  }
+  varint::use_kernel(varint::Kernel::kSimd);
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
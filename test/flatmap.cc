@@ -0,0 +1,97 @@
+#include "mjolnir/flatmap.h"
+#include <cstdint>
+#include <unistd.h>
+
+#include "test.h"
+
+using namespace valhalla::mjolnir;
+
+namespace {
+
+struct value_t {
+  uint32_t a;
+  float b;
+};
+
+TEST(FlatMap, MultiMap) {
+  FlatMultiMap<value_t> map;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    map.insert({(i * 7919) % 100, value_t{i, i * .5f}});
+  }
+  map.sort();
+  EXPECT_EQ(map.size(), 1000);
+
+  for (uint64_t id = 0; id < 100; ++id) {
+    auto range = map.equal_range(id);
+    ASSERT_EQ(range.second - range.first, 10);
+    // the values of one id are in the order they were inserted
+    uint32_t last = 0;
+    for (auto v = range.first; v != range.second; ++v) {
+      EXPECT_EQ(v->first, id);
+      EXPECT_EQ((v->second.a * 7919) % 100, id);
+      EXPECT_TRUE(v == range.first || v->second.a > last);
+      last = v->second.a;
+    }
+    EXPECT_EQ(map.find(id), range.first);
+  }
+
+  // missing ids are at the end
+  auto range = map.equal_range(100);
+  EXPECT_EQ(range.first, map.end());
+  EXPECT_EQ(range.second, map.end());
+  EXPECT_EQ(map.find(1000000), map.end());
+}
+
+TEST(FlatMap, Set) {
+  FlatSet set;
+  for (uint64_t id : {5000000000ull, 3ull, 7ull, 3ull, 5000000000ull}) {
+    set.insert(id);
+  }
+  set.sort();
+  EXPECT_EQ(set.size(), 3);
+  EXPECT_NE(set.find(3), set.end());
+  EXPECT_NE(set.find(5000000000ull), set.end());
+  EXPECT_EQ(set.find(5), set.end());
+  EXPECT_EQ(set.find(705032704), set.end());
+}
+
+TEST(FlatMap, WriteAndMap) {
+  auto file = "test/data/flatmap_" + std::to_string(getpid());
+  FlatMultiMap<value_t> map;
+  for (uint32_t i = 0; i < 100; ++i) {
+    map.insert({100 - i / 2, value_t{i, 0}});
+  }
+  map.sort();
+  ASSERT_TRUE(map.write(file));
+
+  FlatMultiMap<value_t> mapped;
+  ASSERT_TRUE(mapped.read(file));
+  ASSERT_EQ(mapped.size(), map.size());
+  auto range = mapped.equal_range(100);
+  ASSERT_EQ(range.second - range.first, 2);
+  EXPECT_EQ(range.first->second.a, 0);
+  EXPECT_EQ((range.first + 1)->second.a, 1);
+  EXPECT_EQ(mapped.find(50), mapped.end());
+
+  // adding to a mapped one takes a copy and leaves the file alone
+  mapped.insert({50, value_t{7, 0}});
+  mapped.sort();
+  EXPECT_EQ(mapped.find(50)->second.a, 7);
+  EXPECT_EQ(mapped.size(), 101);
+
+  // nothing to write is an empty file and nothing to map
+  FlatSet set, empty;
+  ASSERT_TRUE(set.write(file));
+  ASSERT_TRUE(empty.read(file));
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.find(1), empty.end());
+
+  unlink(file.c_str());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
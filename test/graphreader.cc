@@ -1,4 +1,5 @@
 #include <cstdint>
+#include <fstream>
 
 #include "baldr/connectivity_map.h"
 #include "baldr/graphreader.h"
@@ -6,6 +7,7 @@
 #include "filesystem.h"
 
 #include <fcntl.h>
+#include <unistd.h>
 
 #include "test.h"
 
@@ -20,6 +22,12 @@ public:
   using SimpleTileCache::SimpleTileCache;
 };
 
+class test_graph_reader : public GraphReader {
+public:
+  using GraphReader::cache_;
+  using GraphReader::GraphReader;
+};
+
 TEST(SimpleCache, QueryByPointOutOfRangeLL) {
   boost::property_tree::ptree pt;
   pt.put("tile_dir", "test/gphrdr_test");
@@ -880,6 +888,88 @@ TEST(CacheLruSoft, TrimOnExactlyFullCache) {
   CheckGraphTile(cache.Get(tile2_id), tile2_id, tile2_size);
 }
 
+TEST(GraphReader, Preload) {
+  auto conf = test::make_config("test/data/utrecht_tiles");
+  test_graph_reader reader(conf.get_child("mjolnir"));
+
+  // load a level in parallel and make sure everything ended up in the cache
+  auto tile_set = reader.GetTileSet(2);
+  ASSERT_FALSE(tile_set.empty());
+  EXPECT_EQ(reader.Preload(2, 4), tile_set.size());
+  for (const auto& tile_id : tile_set) {
+    EXPECT_TRUE(reader.cache_->Contains(tile_id)) << "Tile " << tile_id << " was not preloaded";
+  }
+
+  // nothing left to do the second time around
+  EXPECT_EQ(reader.Preload(2, 4), 0);
+
+  // a bounding box only loads the tiles that are missing
+  valhalla::midgard::AABB2<valhalla::midgard::PointLL> bbox{5.1, 52.0, 5.15, 52.1};
+  auto bbox_tiles = TileHierarchy::GetGraphIds(bbox);
+  size_t missing = 0;
+  for (const auto& tile_id : bbox_tiles) {
+    missing += !reader.cache_->Contains(tile_id) && reader.DoesTileExist(tile_id);
+  }
+  EXPECT_EQ(reader.Preload(bbox, 4), missing);
+}
+
+TEST(GraphReader, SharedTileCache) {
+  auto conf = test::make_config("test/data/utrecht_tiles");
+  const std::string name = "valhalla_test_graphreader_" + std::to_string(getpid());
+  SharedTileSegment::Remove(name);
+  conf.put("mjolnir.shared_tile_cache", name);
+  conf.put("mjolnir.shared_tile_cache_size", 256 * 1024 * 1024);
+
+  // the first reader loads the tile from disk and publishes it
+  test_graph_reader first(conf.get_child("mjolnir"));
+  ASSERT_TRUE(first.GetSharedTileSegment());
+  auto tile_id = *first.GetTileSet(2).begin();
+  auto tile = first.GetGraphTile(tile_id);
+  ASSERT_TRUE(tile);
+  EXPECT_EQ(first.GetSharedTileSegment()->stats().tiles, 1);
+
+  // the second one finds it without loading it and uses the very same memory
+  test_graph_reader second(conf.get_child("mjolnir"));
+  EXPECT_TRUE(second.cache_->Contains(tile_id));
+  auto shared = second.GetGraphTile(tile_id);
+  ASSERT_TRUE(shared);
+  EXPECT_EQ(shared->header(), tile->header());
+  EXPECT_EQ(second.GetSharedTileSegment()->stats().tiles, 1);
+
+  // clearing a cache doesnt remove anything from shared memory
+  first.Clear();
+  EXPECT_TRUE(first.cache_->Contains(tile_id));
+  EXPECT_EQ(first.GetGraphTile(tile_id)->header(), tile->header());
+
+  SharedTileSegment::Remove(name);
+}
+
+TEST(GraphReader, FindSidecar) {
+  const std::string tile_dir = "test/data/sidecar_tiles";
+  const std::string extract_dir = "test/data/sidecar_extract";
+  filesystem::remove_all(tile_dir);
+  filesystem::remove_all(extract_dir);
+  filesystem::create_directories(tile_dir);
+  filesystem::create_directories(extract_dir);
+  boost::property_tree::ptree conf;
+  conf.put("tile_dir", tile_dir);
+  EXPECT_EQ(GraphReader::FindSidecar(conf, "labels.bin"), "");
+
+  // next to the extract
+  conf.put("tile_extract", extract_dir + "/tiles.tar");
+  std::ofstream(extract_dir + "/labels.bin") << "x";
+  auto next_to_extract = extract_dir + filesystem::path::preferred_separator + "labels.bin";
+  EXPECT_EQ(GraphReader::FindSidecar(conf, "labels.bin"), next_to_extract);
+
+  // the tile_dir wins
+  std::ofstream(tile_dir + "/labels.bin") << "x";
+  auto in_tile_dir = tile_dir + filesystem::path::preferred_separator + "labels.bin";
+  EXPECT_EQ(GraphReader::FindSidecar(conf, "labels.bin"), in_tile_dir);
+
+  filesystem::remove_all(tile_dir);
+  filesystem::remove_all(extract_dir);
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,125 @@
+#include "gurka.h"
+#include "baldr/componentlabels.h"
+#include "mjolnir/componentbuilder.h"
+#include "sif/costfactory.h"
+#include <gtest/gtest.h>
+
+#if !defined(VALHALLA_SOURCE_DIR)
+#define VALHALLA_SOURCE_DIR
+#endif
+
+using namespace valhalla;
+
+class ComponentLabelsTest : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize_metres = 100;
+
+    const std::string ascii_map = R"(
+    A-----B-----C     E-----F
+          |
+          1
+          |
+          D
+    )";
+
+    // BD is a oneway into a dead end and EF is an island
+    const gurka::ways ways = {
+        {"AB", {{"highway", "residential"}}},
+        {"BC", {{"highway", "residential"}}},
+        {"BD", {{"highway", "residential"}, {"oneway", "yes"}}},
+        {"EF", {{"highway", "residential"}}},
+    };
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize_metres);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_component_labels");
+    mjolnir::ComponentBuilder::Build(map.config);
+  }
+
+  // the error code of the route or 0 if there was a route
+  static int route(const std::vector<std::string>& waypoints,
+                   const std::string& costing,
+                   const std::unordered_map<std::string, std::string>& options = {},
+                   bool use_labels = true) {
+    auto labels_map = map;
+    labels_map.config.put("loki.use_component_labels", use_labels);
+    try {
+      gurka::do_action(Options::route, labels_map, waypoints, costing, options);
+    } catch (const valhalla_exception_t& e) { return e.code; }
+    return 0;
+  }
+};
+gurka::map ComponentLabelsTest::map = {};
+
+TEST_F(ComponentLabelsTest, Reachable) {
+  EXPECT_EQ(route({"A", "C"}, "auto"), 0);
+  EXPECT_EQ(route({"A", "1"}, "auto"), 0);
+  EXPECT_EQ(route({"E", "F"}, "auto"), 0);
+}
+
+TEST_F(ComponentLabelsTest, OnewayTrap) {
+  // loki knows right away
+  EXPECT_EQ(route({"1", "A"}, "auto"), 170);
+  EXPECT_EQ(route({"A", "1", "C"}, "auto"), 170);
+
+  // without the labels thor has to go looking
+  EXPECT_EQ(route({"1", "A"}, "auto", {}, false), 442);
+
+  // pedestrians dont care about the oneway and neither does someone ignoring it
+  EXPECT_EQ(route({"1", "A"}, "pedestrian"), 0);
+  EXPECT_EQ(route({"1", "A"}, "auto", {{"/costing_options/auto/ignore_oneways", "1"}}), 0);
+}
+
+TEST_F(ComponentLabelsTest, Island) {
+  EXPECT_EQ(route({"A", "E"}, "auto"), 170);
+  EXPECT_EQ(route({"F", "C"}, "pedestrian"), 170);
+  EXPECT_EQ(route({"A", "E"}, "auto", {}, false), 442);
+}
+
+TEST_F(ComponentLabelsTest, Matrix) {
+  auto labels_map = map;
+  labels_map.config.put("loki.use_component_labels", true);
+  auto matrix = [&labels_map](const std::string& sources, const std::string& targets) {
+    auto request = R"({"sources":[)" + sources + R"(],"targets":[)" + targets +
+                   R"(],"costing":"auto"})";
+    try {
+      gurka::do_action(Options::sources_to_targets, labels_map, request);
+    } catch (const valhalla_exception_t& e) { return e.code; }
+    return 0;
+  };
+  auto ll = [](const std::string& node) {
+    return R"({"lat":)" + std::to_string(map.nodes.at(node).lat()) + R"(,"lon":)" +
+           std::to_string(map.nodes.at(node).lng()) + "}";
+  };
+
+  // nothing is reachable so there is no point in trying
+  EXPECT_EQ(matrix(ll("1"), ll("A") + "," + ll("E")), 170);
+  // some of it is reachable
+  EXPECT_EQ(matrix(ll("1") + "," + ll("A"), ll("C")), 0);
+}
+
+TEST(ComponentLabels, ModeForAccess) {
+  // the costings get the labels of their mode even if their access mask isnt exactly the same
+  sif::CostFactory factory;
+  std::vector<std::pair<Costing::Type, baldr::ComponentLabels::Mode>> expected = {
+      {Costing::auto_, baldr::ComponentLabels::kAuto},
+      {Costing::truck, baldr::ComponentLabels::kTruck},
+      {Costing::bicycle, baldr::ComponentLabels::kBicycle},
+      {Costing::pedestrian, baldr::ComponentLabels::kPedestrian},
+  };
+  for (const auto& type_mode : expected) {
+    baldr::ComponentLabels::Mode mode;
+    auto access = factory.Create(type_mode.first)->access_mode();
+    ASSERT_TRUE(baldr::ComponentLabels::mode_for_access(access, mode)) << access;
+    EXPECT_EQ(mode, type_mode.second);
+  }
+
+  // but not those that can use edges none of the modes were labelled with
+  baldr::ComponentLabels::Mode mode;
+  EXPECT_FALSE(baldr::ComponentLabels::mode_for_access(baldr::kMopedAccess, mode));
+  EXPECT_FALSE(
+      baldr::ComponentLabels::mode_for_access(baldr::kAutoAccess | baldr::kTaxiAccess, mode));
+  EXPECT_FALSE(baldr::ComponentLabels::mode_for_access(0, mode));
+}
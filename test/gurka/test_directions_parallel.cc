@@ -0,0 +1,99 @@
+#include "gurka.h"
+#include <gtest/gtest.h>
+
+#if !defined(VALHALLA_SOURCE_DIR)
+#define VALHALLA_SOURCE_DIR
+#endif
+
+using namespace valhalla;
+
+class DirectionsParallel : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize_metres = 100;
+
+    const std::string ascii_map = R"(
+    A----B----C----D
+    |    |    |    |
+    E----F----G----H
+    |    |    |    |
+    I----J----K----L
+    )";
+
+    const gurka::ways ways = {{"AB", {{"highway", "primary"}, {"name", "Alpha"}}},
+                              {"BC", {{"highway", "primary"}, {"name", "Alpha"}}},
+                              {"CD", {{"highway", "primary"}, {"name", "Alpha"}}},
+                              {"EF", {{"highway", "residential"}, {"name", "Echo"}}},
+                              {"FG", {{"highway", "residential"}, {"name", "Echo"}}},
+                              {"GH", {{"highway", "residential"}, {"name", "Echo"}}},
+                              {"IJ", {{"highway", "secondary"}, {"name", "India"}}},
+                              {"JK", {{"highway", "secondary"}, {"name", "India"}}},
+                              {"KL", {{"highway", "secondary"}, {"name", "India"}}},
+                              {"AEI", {{"highway", "tertiary"}, {"name", "First"}}},
+                              {"BFJ", {{"highway", "tertiary"}, {"name", "Second"}}},
+                              {"CGK", {{"highway", "tertiary"}, {"name", "Third"}}},
+                              {"DHL", {{"highway", "tertiary"}, {"name", "Fourth"}}}};
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize_metres);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_directions_parallel");
+  }
+
+  // builds the same route with and without the legs being built in parallel
+  static std::pair<Api, Api> route(const std::vector<std::string>& waypoints) {
+    auto serial_map = map;
+    serial_map.config.put("odin.directions_parallel_threads", 0);
+    auto serial = gurka::do_action(Options::route, serial_map, waypoints, "auto");
+
+    auto parallel_map = map;
+    parallel_map.config.put("odin.directions_parallel_threads", 4);
+    parallel_map.config.put("odin.directions_parallel_min_legs", 2);
+    auto parallel = gurka::do_action(Options::route, parallel_map, waypoints, "auto");
+
+    return {serial, parallel};
+  }
+
+  static void expect_same_directions(const Api& serial, const Api& parallel) {
+    ASSERT_EQ(serial.directions().routes_size(), parallel.directions().routes_size());
+    for (int r = 0; r < serial.directions().routes_size(); ++r) {
+      const auto& expected_route = serial.directions().routes(r);
+      const auto& actual_route = parallel.directions().routes(r);
+      ASSERT_EQ(expected_route.legs_size(), actual_route.legs_size());
+      for (int i = 0; i < expected_route.legs_size(); ++i) {
+        const auto& expected = expected_route.legs(i);
+        const auto& actual = actual_route.legs(i);
+        EXPECT_EQ(expected.shape(), actual.shape()) << "Leg " << i;
+        ASSERT_EQ(expected.maneuver_size(), actual.maneuver_size()) << "Leg " << i;
+        for (int j = 0; j < expected.maneuver_size(); ++j) {
+          EXPECT_EQ(expected.maneuver(j).type(), actual.maneuver(j).type());
+          EXPECT_EQ(expected.maneuver(j).text_instruction(), actual.maneuver(j).text_instruction());
+          EXPECT_EQ(expected.maneuver(j).verbal_pre_transition_instruction(),
+                    actual.maneuver(j).verbal_pre_transition_instruction());
+        }
+      }
+    }
+  }
+};
+gurka::map DirectionsParallel::map = {};
+
+TEST_F(DirectionsParallel, ManyLegs) {
+  auto result = route({"A", "L", "D", "I", "G", "E", "C", "J"});
+  ASSERT_EQ(result.second.directions().routes(0).legs_size(), 7);
+  expect_same_directions(result.first, result.second);
+
+  // each leg of directions goes with the leg of the trip it was built from
+  const auto& trip = result.second.trip().routes(0);
+  const auto& directions = result.second.directions().routes(0);
+  for (int i = 0; i < directions.legs_size(); ++i) {
+    EXPECT_EQ(directions.legs(i).shape(), trip.legs(i).shape()) << "Leg " << i;
+    EXPECT_EQ(directions.legs(i).maneuver(0).type(), DirectionsLeg_Maneuver_Type_kStart);
+    EXPECT_EQ(directions.legs(i).maneuver().rbegin()->type(),
+              DirectionsLeg_Maneuver_Type_kDestination);
+  }
+}
+
+TEST_F(DirectionsParallel, SingleLeg) {
+  auto result = route({"A", "L"});
+  expect_same_directions(result.first, result.second);
+}
@@ -83,7 +83,8 @@ TEST(OnlyRestrictions, OneNeighbour) {
   }
 }
 
-TEST(OnlyRestrictions, ManyNeighbours) {
+void check_many_neighbours(const std::string& workdir,
+                           const std::unordered_map<std::string, std::string>& options) {
   const std::string ascii_map = R"(
            1   3--5
            |   |
@@ -118,9 +119,7 @@ TEST(OnlyRestrictions, ManyNeighbours) {
   };
 
   const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
-  auto map =
-      gurka::buildtiles(layout, ways, {}, relations, "test/data/only_restrictions_many_neighbours",
-                        {{"mjolnir.concurrency", "1"}});
+  auto map = gurka::buildtiles(layout, ways, {}, relations, workdir, options);
 
   for (const auto& from : {"A", "B"}) {
     for (const auto& to : {"1", "2", "3", "4", "5"}) {
@@ -135,3 +134,14 @@ TEST(OnlyRestrictions, ManyNeighbours) {
     }
   }
 }
+
+TEST(OnlyRestrictions, ManyNeighbours) {
+  check_many_neighbours("test/data/only_restrictions_many_neighbours",
+                        {{"mjolnir.concurrency", "1"}});
+}
+
+TEST(OnlyRestrictions, ManyNeighboursSorted) {
+  // the restrictions are joined with the tiles up front rather than searched for every edge
+  check_many_neighbours("test/data/only_restrictions_many_neighbours_sorted",
+                        {{"mjolnir.concurrency", "2"}, {"mjolnir.sorted_restrictions", "true"}});
+}
@@ -0,0 +1,178 @@
+#include "baldr/edgereach.h"
+#include "filesystem.h"
+#include "gurka.h"
+#include "loki/reach.h"
+#include "mjolnir/reachbuilder.h"
+#include "sif/costfactory.h"
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <vector>
+
+#if !defined(VALHALLA_SOURCE_DIR)
+#define VALHALLA_SOURCE_DIR
+#endif
+
+using namespace valhalla;
+
+class PrecomputedReach : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize_metres = 100;
+
+    const std::string ascii_map = R"(
+    A-----B-----C-----D
+          |     |
+          E-----F     G-----H
+    )";
+
+    // CD is a oneway out of the rest, DG is a footway and GH is an island for cars
+    const gurka::ways ways = {
+        {"AB", {{"highway", "residential"}}},
+        {"BC", {{"highway", "residential"}}},
+        {"CD", {{"highway", "residential"}, {"oneway", "yes"}}},
+        {"BE", {{"highway", "residential"}}},
+        {"EF", {{"highway", "residential"}}},
+        {"FC", {{"highway", "residential"}}},
+        {"DG", {{"highway", "footway"}}},
+        {"GH", {{"highway", "residential"}}},
+    };
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize_metres);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_precomputed_reach");
+    mjolnir::ReachBuilder::Build(map.config);
+  }
+};
+gurka::map PrecomputedReach::map = {};
+
+TEST_F(PrecomputedReach, MatchesLiveReach) {
+  auto tile_dir = map.config.get<std::string>("mjolnir.tile_dir");
+  auto edge_reach = std::make_shared<const baldr::EdgeReach>(
+      tile_dir + filesystem::path::preferred_separator + baldr::EdgeReach::kFileName);
+  auto max_reach = edge_reach->max_reach();
+  EXPECT_EQ(max_reach, map.config.get<uint32_t>("service_limits.max_reachability"));
+
+  baldr::GraphReader reader(map.config.get_child("mjolnir"));
+  loki::Reach live;
+  sif::CostFactory factory;
+  for (int mode = 0; mode < baldr::ComponentLabels::kModeCount; ++mode) {
+    auto costing = factory.Create(loki::default_costing(loki::kPrecomputedReachCostings[mode]));
+    loki::Reach precomputed;
+    precomputed.set_precomputed(edge_reach, static_cast<baldr::EdgeReach::Mode>(mode));
+
+    size_t compared = 0;
+    for (const auto& tile_id : reader.GetTileSet()) {
+      auto tile = reader.GetGraphTile(tile_id);
+      EXPECT_EQ(edge_reach->edge_count(tile_id), tile->header()->directededgecount());
+      for (baldr::GraphId edge_id = tile_id; edge_id.id() < tile->header()->directededgecount();
+           ++edge_id) {
+        const auto* edge = tile->directededge(edge_id);
+        if (edge->is_shortcut()) {
+          continue;
+        }
+        auto expected = live(edge, edge_id, max_reach, reader, costing);
+        uint32_t outbound, inbound;
+        ASSERT_TRUE(edge_reach->Get(edge_id, static_cast<baldr::EdgeReach::Mode>(mode), outbound,
+                                    inbound));
+        EXPECT_EQ(outbound, expected.outbound);
+        EXPECT_EQ(inbound, expected.inbound);
+
+        // asking for less or for a single direction gets the same answer either way
+        auto a = live(edge, edge_id, 2, reader, costing, kOutbound);
+        auto b = precomputed(edge, edge_id, 2, reader, costing, kOutbound);
+        EXPECT_EQ(a.outbound, b.outbound);
+        a = live(edge, edge_id, 2, reader, costing, kInbound);
+        b = precomputed(edge, edge_id, 2, reader, costing, kInbound);
+        EXPECT_EQ(a.inbound, b.inbound);
+        ++compared;
+      }
+    }
+    EXPECT_GT(compared, 0);
+  }
+}
+
+TEST_F(PrecomputedReach, Route) {
+  for (bool use_precomputed : {true, false}) {
+    auto reach_map = map;
+    reach_map.config.put("loki.use_precomputed_reach", use_precomputed);
+
+    // default costing uses the sidecar
+    auto result = gurka::do_action(Options::route, reach_map, {"A", "E"}, "auto");
+    gurka::assert::raw::expect_path(result, {"AB", "BE"});
+
+    // the island is too small to get out of so cars get snapped somewhere else
+    result = gurka::do_action(Options::route, reach_map, {"A", "H"}, "auto",
+                              {{"/locations/1/minimum_reachability", "5"}});
+    EXPECT_NE(gurka::detail::get_paths(result).front().back(), "GH");
+
+    // preferences still use the sidecar, restricting access falls back to expanding
+    result = gurka::do_action(Options::route, reach_map, {"A", "E"}, "auto",
+                              {{"/costing_options/auto/use_highways", "0.2"}});
+    gurka::assert::raw::expect_path(result, {"AB", "BE"});
+    result = gurka::do_action(Options::route, reach_map, {"A", "E"}, "auto",
+                              {{"/costing_options/auto/exclude_unpaved", "1"}});
+    gurka::assert::raw::expect_path(result, {"AB", "BE"});
+  }
+}
+
+TEST_F(PrecomputedReach, UsedForAuto) {
+  // overwrite the auto reach in the sidecar with something loki could never find by expanding
+  auto tile_dir = map.config.get<std::string>("mjolnir.tile_dir");
+  auto file_name = tile_dir + filesystem::path::preferred_separator + baldr::EdgeReach::kFileName;
+  constexpr uint8_t kFakeReach = 3;
+  {
+    std::fstream file(file_name, std::ios::in | std::ios::out | std::ios::binary);
+    baldr::EdgeReach::header_t header;
+    ASSERT_TRUE(file.read(reinterpret_cast<char*>(&header), sizeof(header)));
+    file.seekp(sizeof(header) + header.tile_count * sizeof(baldr::EdgeReach::tile_t) +
+               baldr::ComponentLabels::kAuto * header.edge_count * sizeof(baldr::EdgeReach::reach_t));
+    std::vector<baldr::EdgeReach::reach_t> reach(header.edge_count, {kFakeReach, kFakeReach});
+    file.write(reinterpret_cast<const char*>(reach.data()),
+               reach.size() * sizeof(baldr::EdgeReach::reach_t));
+    ASSERT_TRUE(file.good());
+  }
+
+  // the reach loki found for the edges of the origin comes from the sidecar only if it was used
+  for (bool use_precomputed : {true, false}) {
+    auto reach_map = map;
+    reach_map.config.put("loki.use_precomputed_reach", use_precomputed);
+    auto result = gurka::do_action(Options::route, reach_map, {"A", "E"}, "auto",
+                                   {{"/locations/0/minimum_reachability", "5"}});
+    const auto& edges = result.options().locations(0).correlation().edges();
+    ASSERT_GT(edges.size(), 0);
+    for (const auto& edge : edges) {
+      if (use_precomputed) {
+        EXPECT_EQ(edge.outbound_reach(), kFakeReach);
+      } else {
+        EXPECT_GT(edge.outbound_reach(), kFakeReach);
+      }
+    }
+  }
+
+  // put back the real reach for the other tests
+  mjolnir::ReachBuilder::Build(map.config);
+}
+
+TEST(PrecomputedReachKey, OnlyAccessMatters) {
+  for (auto type : loki::kPrecomputedReachCostings) {
+    auto defaults = loki::default_costing(type).options();
+    auto key = loki::reach_access_key(defaults);
+
+    // what things cost doesnt change what can be reached
+    auto preferences = defaults;
+    preferences.set_use_highways(0.1f);
+    preferences.set_maneuver_penalty(100.f);
+    preferences.set_use_living_streets(0.9f);
+    EXPECT_EQ(loki::reach_access_key(preferences), key);
+
+    // but what can be used does
+    auto access = defaults;
+    access.set_exclude_unpaved(true);
+    EXPECT_NE(loki::reach_access_key(access), key);
+    access = defaults;
+    access.set_ignore_oneways(true);
+    EXPECT_NE(loki::reach_access_key(access), key);
+  }
+}
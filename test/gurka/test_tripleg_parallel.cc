@@ -0,0 +1,93 @@
+#include "gurka.h"
+#include <gtest/gtest.h>
+
+#if !defined(VALHALLA_SOURCE_DIR)
+#define VALHALLA_SOURCE_DIR
+#endif
+
+using namespace valhalla;
+
+class TripLegParallel : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize_metres = 50;
+
+    const std::string ascii_map = R"(
+    A-1-B--C--D--E--F--G--H--I--J--K-3-L--M--N--O--P--Q--R--S--T--U--V--W-2-X
+    )";
+
+    // give every way its own name so that nothing gets merged together
+    const std::string names = "ABCDEFGHIJKLMNOPQRSTUVWX";
+    gurka::ways ways;
+    for (size_t i = 0; i + 1 < names.size(); ++i) {
+      ways[names.substr(i, 2)] = {{"highway", "primary"}, {"name", names.substr(i, 2)}};
+    }
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize_metres);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_tripleg_parallel");
+  }
+
+  // builds the same route with and without the edge shapes being built in parallel
+  static std::pair<Api, Api> route(const std::vector<std::string>& waypoints,
+                                   const std::string& stop_type) {
+    auto serial_map = map;
+    serial_map.config.put("thor.tripleg_parallel_threads", 0);
+    auto serial = gurka::do_action(Options::route, serial_map, waypoints, "auto", {}, {}, nullptr,
+                                   stop_type);
+
+    auto parallel_map = map;
+    parallel_map.config.put("thor.tripleg_parallel_threads", 4);
+    parallel_map.config.put("thor.tripleg_parallel_min_edges", 1);
+    auto parallel = gurka::do_action(Options::route, parallel_map, waypoints, "auto", {}, {},
+                                     nullptr, stop_type);
+
+    return {serial, parallel};
+  }
+
+  static void expect_same_legs(const Api& serial, const Api& parallel) {
+    ASSERT_EQ(serial.trip().routes(0).legs_size(), parallel.trip().routes(0).legs_size());
+    for (int i = 0; i < serial.trip().routes(0).legs_size(); ++i) {
+      const auto& expected = serial.trip().routes(0).legs(i);
+      const auto& actual = parallel.trip().routes(0).legs(i);
+      EXPECT_EQ(expected.shape(), actual.shape());
+      ASSERT_EQ(expected.node_size(), actual.node_size());
+      for (int j = 0; j < expected.node_size() - 1; ++j) {
+        const auto& e = expected.node(j).edge();
+        const auto& a = actual.node(j).edge();
+        EXPECT_EQ(e.begin_shape_index(), a.begin_shape_index()) << "Edge " << j;
+        EXPECT_EQ(e.end_shape_index(), a.end_shape_index()) << "Edge " << j;
+        EXPECT_FLOAT_EQ(e.length_km(), a.length_km()) << "Edge " << j;
+        EXPECT_FLOAT_EQ(e.source_along_edge(), a.source_along_edge()) << "Edge " << j;
+        EXPECT_FLOAT_EQ(e.target_along_edge(), a.target_along_edge()) << "Edge " << j;
+      }
+      ASSERT_EQ(expected.location_size(), actual.location_size());
+      for (int j = 0; j < expected.location_size(); ++j) {
+        EXPECT_EQ(expected.location(j).correlation().leg_shape_index(),
+                  actual.location(j).correlation().leg_shape_index());
+      }
+    }
+  }
+};
+gurka::map TripLegParallel::map = {};
+
+TEST_F(TripLegParallel, PartialEdges) {
+  auto result = route({"1", "2"}, "break");
+  gurka::assert::raw::expect_path(result.second,
+                                  {"AB", "BC", "CD", "DE", "EF", "FG", "GH", "HI", "IJ", "JK", "KL",
+                                   "LM", "MN", "NO", "OP", "PQ", "QR", "RS", "ST", "TU", "UV", "VW",
+                                   "WX"});
+  expect_same_legs(result.first, result.second);
+}
+
+TEST_F(TripLegParallel, ThroughLocation) {
+  auto result = route({"1", "3", "2"}, "through");
+  expect_same_legs(result.first, result.second);
+}
+
+TEST_F(TripLegParallel, SingleEdge) {
+  auto result = route({"A", "1"}, "break");
+  gurka::assert::raw::expect_path(result.second, {"AB"});
+  expect_same_legs(result.first, result.second);
+}
@@ -1,9 +1,11 @@
 #include "test.h"
 
 #include <string>
+#include <vector>
 
 #include "mjolnir/graph_lua_proc.h"
 #include "mjolnir/luatagtransform.h"
+#include "mjolnir/nativetagtransform.h"
 #include "mjolnir/osmdata.h"
 
 using namespace valhalla;
@@ -103,6 +105,258 @@ TEST(Lua, NumberDoublePeriod) {
   // ... but that the results aren't completely empty
   ASSERT_TRUE(results.size() > 0);
 }
+
+// every combination of the tags that rels_proc looks at
+std::vector<mjolnir::Tags> relation_tags() {
+  std::vector<std::pair<std::string, std::vector<std::string>>> choices{
+      {"type", {"", "route", "restriction", "connectivity", "multipolygon"}},
+      {"restriction", {"", "no_left_turn", "only_straight_on", "bogus"}},
+      {"restriction:conditional",
+       {"", "no_u_turn @ (07:00-09:00)", "no_right_turn@(Mo-Fr)", "no left_turn @ x", "no_entry @",
+        "no_exit @  ", "junk"}},
+      {"restriction:probable", {"", "no_turn @ (wet)", "only_left_turn", "@"}},
+      {"restriction:hgv", {"", "no_turn", "bogus"}},
+      {"restriction:foot", {"", "no_exit"}},
+      {"route", {"", "bicycle", "mtb", "road"}},
+      {"network", {"", "ncn", "rcn", "lcn", "mtb"}},
+  };
+  std::vector<mjolnir::Tags> all{{{"day_on", "Mo"}, {"name", "x"}}};
+  for (const auto& choice : choices) {
+    std::vector<mjolnir::Tags> next;
+    for (const auto& tags : all) {
+      for (const auto& value : choice.second) {
+        next.push_back(tags);
+        if (!value.empty()) {
+          next.back()[choice.first] = value;
+        }
+      }
+    }
+    all.swap(next);
+  }
+  return all;
+}
+
+TEST(Lua, NativeRelations) {
+  mjolnir::LuaTagTransform lua(std::string(lua_graph_lua, lua_graph_lua + lua_graph_lua_len));
+  for (const auto& tags : relation_tags()) {
+    auto expected = lua.Transform(mjolnir::OSMType::kRelation, 1, tags);
+    auto native = mjolnir::NativeTagTransform::Transform(mjolnir::OSMType::kRelation, tags);
+    ASSERT_EQ(native, expected) << "type=" << (tags.count("type") ? tags.at("type") : "")
+                                << " restriction:conditional="
+                                << (tags.count("restriction:conditional")
+                                        ? tags.at("restriction:conditional")
+                                        : "");
+  }
+}
+
+// each of the bases with one of the tags the lua looks at set to each of its choices, and each
+// base with every pair of the given tags set to the first of their choices
+std::vector<mjolnir::Tags>
+varied_tags(const std::vector<mjolnir::Tags>& bases,
+            const std::vector<std::pair<std::string, std::vector<std::string>>>& choices) {
+  std::vector<mjolnir::Tags> all;
+  for (const auto& base : bases) {
+    all.push_back(base);
+    for (const auto& choice : choices) {
+      for (const auto& value : choice.second) {
+        all.push_back(base);
+        all.back()[choice.first] = value;
+      }
+    }
+    for (size_t i = 0; i < choices.size(); ++i) {
+      for (size_t j = i + 1; j < choices.size(); ++j) {
+        all.push_back(base);
+        all.back()[choices[i].first] = choices[i].second.front();
+        all.back()[choices[j].first] = choices[j].second.front();
+      }
+    }
+  }
+  return all;
+}
+
+std::string describe(const mjolnir::Tags& tags) {
+  std::string out;
+  for (const auto& tag : tags) {
+    out += tag.first + "=" + tag.second + " ";
+  }
+  return out;
+}
+
+std::vector<mjolnir::Tags> way_tags() {
+  std::vector<mjolnir::Tags> bases{
+      {{"highway", "primary"}},
+      {{"highway", "residential"}, {"oneway", "yes"}},
+      {{"highway", "footway"}, {"bicycle", "yes"}},
+      {{"highway", "cycleway"}, {"oneway", "-1"}},
+      {{"highway", "construction"}, {"construction", "secondary_link"}},
+      {{"highway", "motorway"}, {"hov", "designated"}, {"hov:minimum", "2"}, {"oneway", "yes"}},
+      {{"highway", "track"}, {"tracktype", "grade2"}},
+      {{"route", "ferry"}},
+      {{"railway", "rail"}, {"route", "shuttle_train"}},
+      {{"highway", "bridleway"}, {"access", "no"}},
+  };
+  std::vector<std::pair<std::string, std::vector<std::string>>> choices{
+      {"access", {"no", "private", "psv", "emergency", "hov", "permissive", "destination"}},
+      {"motor_vehicle", {"no", "yes", "destination", "private"}},
+      {"vehicle", {"no"}},
+      {"motorcar", {"no", "yes"}},
+      {"hgv", {"no", "designated", "local"}},
+      {"bus", {"yes", "no"}},
+      {"taxi", {"yes"}},
+      {"psv", {"yes", "no"}},
+      {"lanes:psv:forward", {"1"}},
+      {"lanes:psv:backward", {"yes"}},
+      {"moped", {"no"}},
+      {"mofa", {"yes"}},
+      {"motorcycle", {"no"}},
+      {"foot", {"no", "yes", "designated"}},
+      {"bicycle", {"no", "dismount", "designated"}},
+      {"bicycle_road", {"yes"}},
+      {"impassable", {"yes"}},
+      {"emergency", {"yes", "no"}},
+      {"service", {"driveway", "emergency_access", "parking_aisle", "alley"}},
+      {"oneway", {"yes", "-1", "no", "reversible", "alternating", "true", "1"}},
+      {"oneway:bicycle", {"no", "-1", "yes"}},
+      {"oneway:bus", {"no", "-1"}},
+      {"oneway:psv", {"no", "-1"}},
+      {"oneway:taxi", {"no", "-1"}},
+      {"oneway:moped", {"no", "-1"}},
+      {"oneway:motorcycle", {"no", "-1"}},
+      {"oneway:foot", {"yes", "no", "-1"}},
+      {"bicycle:backward", {"yes", "no"}},
+      {"bus:backward", {"yes", "designated"}},
+      {"taxi:backward", {"yes"}},
+      {"moped:backward", {"yes"}},
+      {"motorcycle:backward", {"yes"}},
+      {"foot:backward", {"yes"}},
+      {"junction", {"roundabout", "circular"}},
+      {"cycleway", {"lane", "opposite_lane", "track", "shared_lane", "opposite"}},
+      {"cycleway:both", {"lane", "separate"}},
+      {"cycleway:right", {"lane", "opposite_track", "track"}},
+      {"cycleway:left", {"track", "share_busway"}},
+      {"cycleway:both:buffer", {"yes"}},
+      {"cycleway:right:buffer", {"yes"}},
+      {"busway", {"lane", "opposite_lane"}},
+      {"busway:left", {"lane"}},
+      {"lanes:bus", {"1", "2"}},
+      {"lanes:psv", {"1", "2"}},
+      {"segregated", {"yes", "no"}},
+      {"sac_scale", {"hiking", "alpine_hiking"}},
+      {"motorroad", {"yes"}},
+      {"area", {"yes"}},
+      {"shoulder", {"yes", "right", "left", "no", "both"}},
+      {"shoulder:right", {"yes"}},
+      {"shoulder:left", {"yes"}},
+      {"maxspeed", {"50", "30 mph", "none", "5", "200", "signals", "80;100"}},
+      {"maxspeed:advisory", {"40"}},
+      {"maxspeed:practical", {"25 mph"}},
+      {"maxspeed:forward", {"60"}},
+      {"maxspeed:backward", {"70"}},
+      {"maxspeed:hgv", {"80"}},
+      {"lanes", {"2", "4", "20", "2;3", "x"}},
+      {"lanes:forward", {"1"}},
+      {"lanes:backward", {"3"}},
+      {"maxheight", {"3.5", "4,2", "12'6\"", "3 m", "none", "default", "14 ft", "3..35", "-1"}},
+      {"maxheight:physical", {"4.1"}},
+      {"maxwidth", {"2.5", "7'"}},
+      {"maxwidth:physical", {"3"}},
+      {"maxlength", {"12", "40 ft"}},
+      {"maxweight", {"7.5", "3.5 t", "10000 lbs", "500kg", "12 tons", "x", "0x10", " 5 "}},
+      {"maxaxleload", {"10", "2 st"}},
+      {"hazmat", {"no", "designated"}},
+      {"hazmat:water", {"permissive"}},
+      {"hgv:national_network", {"yes"}},
+      {"bridge", {"yes", "viaduct", "no"}},
+      {"tunnel", {"yes", "building_passage"}},
+      {"toll", {"yes", "no"}},
+      {"seasonal", {"winter", "no"}},
+      {"hov", {"designated", "lane", "no"}},
+      {"hov:lanes", {"designated|designated", "|designated"}},
+      {"hov:minimum", {"2", "3", "4"}},
+      {"oneway:conditional", {"yes @ (Mo-Fr 07:00-09:00)"}},
+      {"wheelchair", {"yes", "no", "limited"}},
+      {"ncn_ref", {"4"}},
+      {"rcn", {"yes"}},
+      {"lcn_ref", {"12"}},
+      {"mtb", {"yes"}},
+      {"unsigned_ref", {"A 7"}},
+      {"name", {"Main Street"}},
+      {"footway", {"sidewalk", "crossing"}},
+      {"FIXME", {"check"}},
+      {"source", {"survey"}},
+  };
+  return varied_tags(bases, choices);
+}
+
+TEST(Lua, NativeWays) {
+  mjolnir::LuaTagTransform lua(std::string(lua_graph_lua, lua_graph_lua + lua_graph_lua_len));
+  for (const auto& tags : way_tags()) {
+    auto expected = lua.Transform(mjolnir::OSMType::kWay, 1, tags);
+    auto native = mjolnir::NativeTagTransform::Transform(mjolnir::OSMType::kWay, tags);
+    ASSERT_EQ(native, expected) << describe(tags);
+  }
+}
+
+std::vector<mjolnir::Tags> node_tags() {
+  std::vector<mjolnir::Tags> bases{
+      {{"highway", "traffic_signals"}},
+      {{"barrier", "gate"}},
+      {{"barrier", "bollard"}},
+      {{"barrier", "toll_booth"}},
+      {{"highway", "stop"}},
+      {{"highway", "give_way"}, {"direction", "forward"}},
+      {{"highway", "crossing"}, {"crossing", "zebra"}},
+      {{"railway", "level_crossing"}},
+      {{"amenity", "bicycle_rental"}, {"name", "Velo"}},
+  };
+  std::vector<std::pair<std::string, std::vector<std::string>>> choices{
+      {"access", {"no", "private", "psv", "emergency", "yes", "destination"}},
+      {"motor_vehicle", {"no", "yes"}},
+      {"vehicle", {"no"}},
+      {"motorcar", {"no", "yes"}},
+      {"hgv", {"no", "yes"}},
+      {"bus", {"no", "yes"}},
+      {"taxi", {"no"}},
+      {"psv", {"yes", "no"}},
+      {"foot", {"no", "yes"}},
+      {"wheelchair", {"no", "yes"}},
+      {"bicycle", {"no", "yes", "crossing"}},
+      {"moped", {"no"}},
+      {"mofa", {"yes"}},
+      {"motorcycle", {"no"}},
+      {"hov", {"designated", "no"}},
+      {"hov:minimum", {"2"}},
+      {"impassable", {"yes"}},
+      {"emergency", {"yes"}},
+      {"service", {"emergency_access"}},
+      {"barrier", {"lift_gate", "block", "sump_buster", "border_control", "yes"}},
+      {"bollard", {"rising", "removable"}},
+      {"payment:cash", {"yes", "no"}},
+      {"payment:coins", {"yes"}},
+      {"payment:credit_cards", {"yes", "no"}},
+      {"iso:3166_2", {"US-PA", "DE-BY", "USPA", "FR", "GBR", "ABCDE", "US-A"}},
+      {"traffic_signals:direction", {"forward", "backward", "both"}},
+      {"direction", {"both", "backward", "reverse", "north"}},
+      {"stop", {"all", "minor"}},
+      {"give_way", {"yes"}},
+      {"junction", {"yes"}},
+      {"reference_point", {"yes"}},
+      {"public_transport", {"stop_position"}},
+      {"name", {"Main and 1st"}},
+      {"shop", {"bicycle"}},
+      {"service:bicycle:rental", {"yes"}},
+  };
+  return varied_tags(bases, choices);
+}
+
+TEST(Lua, NativeNodes) {
+  mjolnir::LuaTagTransform lua(std::string(lua_graph_lua, lua_graph_lua + lua_graph_lua_len));
+  for (const auto& tags : node_tags()) {
+    auto expected = lua.Transform(mjolnir::OSMType::kNode, 1, tags);
+    auto native = mjolnir::NativeTagTransform::Transform(mjolnir::OSMType::kNode, tags);
+    ASSERT_EQ(native, expected) << describe(tags);
+  }
+}
 } // namespace
 
 // TODO: sweet jesus add more tests of this class!
@@ -1,7 +1,10 @@
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include <boost/algorithm/string/replace.hpp>
+
 #include "midgard/logging.h"
 #include "odin/narrative_dictionary.h"
 #include "odin/util.h"
@@ -1338,6 +1341,40 @@ TEST(NarrativeDictionary, test_en_US_approach_verbal_alert) {
   validate(us_customary_lengths, kExpectedUsCustomaryLengths);
 }
 
+TEST(NarrativeDictionary, test_phrase_template) {
+  const std::string relative_direction = "right";
+  const std::string street_names = "Main Street";
+
+  // Tags are replaced, tags without a value and brackets that arent tags are left as they are
+  PhraseTemplate phrase("Turn <RELATIVE_DIRECTION> onto <STREET_NAMES> for <LENGTH>. <<x>");
+  EXPECT_EQ(phrase.Fill({{kRelativeDirectionTag, relative_direction},
+                         {kStreetNamesTag, street_names}}),
+            "Turn right onto Main Street for <LENGTH>. <<x>");
+  EXPECT_EQ(phrase.Fill({}), "Turn <RELATIVE_DIRECTION> onto <STREET_NAMES> for <LENGTH>. <<x>");
+  EXPECT_EQ(PhraseTemplate("<STREET_NAMES><STREET_NAMES>").Fill({{kStreetNamesTag, street_names}}),
+            "Main StreetMain Street");
+  EXPECT_EQ(PhraseTemplate("").Fill({{kStreetNamesTag, street_names}}), "");
+}
+
+TEST(NarrativeDictionary, test_phrase_templates_all_locales) {
+  const std::string street_names = "Main Street";
+  const std::string length = "2 kilometers";
+  for (const auto& locale : get_locales()) {
+    const auto& subset = locale.second->turn_subset;
+    for (const auto& phrase : subset.phrases) {
+      // Every phrase is compiled and fills in the same as replacing the tags one at a time
+      std::string expected = phrase.second;
+      boost::replace_all(expected, kStreetNamesTag, street_names);
+      boost::replace_all(expected, kLengthTag, length);
+      EXPECT_EQ(subset.phrase(std::stoul(phrase.first))
+                    .Fill({{kStreetNamesTag, street_names}, {kLengthTag, length}}),
+                expected)
+          << locale.first;
+    }
+    EXPECT_THROW(subset.phrase(subset.phrases.size() + 100), std::out_of_range);
+  }
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
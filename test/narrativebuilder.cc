@@ -3279,6 +3279,28 @@ TEST(NarrativeBuilder, TestBuildStartInstructions_0_miles_en_US) {
   TryBuild(options, maneuvers, expected_maneuvers);
 }
 
+TEST(NarrativeBuilder, TestBuildStartInstructionsWithoutVerbal_0_miles_en_US) {
+  std::string country_code = "US";
+  std::string state_code = "PA";
+
+  // Configure directions options without verbal instructions
+  Options options;
+  options.set_units(Options::miles);
+  options.set_language("en-US");
+  options.set_verbal_instructions(false);
+
+  // Configure maneuvers
+  std::list<Maneuver> maneuvers;
+  PopulateStartManeuverList_0(maneuvers, country_code, state_code);
+
+  // Configure expected maneuvers based on directions options
+  std::list<Maneuver> expected_maneuvers;
+  PopulateStartManeuverList_0(expected_maneuvers, country_code, state_code);
+  SetExpectedManeuverInstructions(expected_maneuvers, "Head east.", "", "", "", "");
+
+  TryBuild(options, maneuvers, expected_maneuvers);
+}
+
 TEST(NarrativeBuilder, TestBuildStartInstructions_1_miles_en_US) {
   std::string country_code = "US";
   std::string state_code = "PA";
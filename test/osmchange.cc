@@ -0,0 +1,163 @@
+#include "mjolnir/osmchange.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <zlib.h>
+
+#include "baldr/graphreader.h"
+#include "baldr/tilehierarchy.h"
+
+#include "test.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+const std::string kChange = R"(<?xml version="1.0" encoding="UTF-8"?>
+<osmChange version="0.6" generator="osmium">
+  <!-- a comment > with a bracket -->
+  <create>
+    <node id="1" version="1" lat="52.0907" lon="5.1214"/>
+    <way id="10" version="1">
+      <nd ref="1"/>
+      <nd ref='2'/>
+      <tag k="highway" v="residential"/>
+      <tag k="note" v="not &lt;nd ref=&quot;5&quot;/&gt; but > &amp; &lt;"/>
+    </way>
+  </create>
+  <modify>
+    <node id="3" version="4" lat="-33.5" lon="151.25">
+      <tag k="barrier" v="gate"/>
+      <![CDATA[<node id="5" lat="1" lon="1"/>]]>
+    </node>
+    <relation id="100" version="2">
+      <member type="way" ref="11" role="from"/>
+      <member type="node" ref="3" role="via"/>
+      <member type="way" ref="12" role="to"/>
+      <tag k="type" v="restriction"/>
+    </relation>
+  </modify>
+  <delete>
+    <node id="4" version="2"/>
+    <way id="13" version="3"/>
+  </delete>
+</osmChange>
+)";
+
+// writes the xml to a file, gzip compressed if the name says so
+std::string write_file(const std::string& file_name, const std::string& xml) {
+  if (file_name.size() > 3 && file_name.compare(file_name.size() - 3, 3, ".gz") == 0) {
+    gzFile out = gzopen(file_name.c_str(), "wb");
+    gzwrite(out, xml.data(), xml.size());
+    gzclose(out);
+  } else {
+    std::ofstream(file_name) << xml;
+  }
+  return file_name;
+}
+
+void check(const OSMChange& change) {
+  // brackets in values, entities and cdata are no elements
+  ASSERT_EQ(change.nodes.size(), 3);
+  EXPECT_NEAR(change.nodes[1].lat(), 52.0907, 1e-6);
+  EXPECT_NEAR(change.nodes[1].lng(), 5.1214, 1e-6);
+  EXPECT_NEAR(change.nodes[3].lat(), -33.5, 1e-6);
+  EXPECT_FALSE(change.nodes[4].IsValid());
+
+  ASSERT_EQ(change.ways.size(), 2);
+  EXPECT_EQ(change.ways[10], (std::vector<uint64_t>{1, 2}));
+  EXPECT_TRUE(change.ways[13].empty());
+
+  EXPECT_EQ(change.relation_ways, (std::unordered_set<uint64_t>{11, 12}));
+}
+
+TEST(OSMChange, Read) {
+  auto file_name = write_file("test_osmchange.osc", kChange);
+  check(OSMChange::Read(file_name));
+  std::remove(file_name.c_str());
+}
+
+TEST(OSMChange, ReadCompressed) {
+  auto file_name = write_file("test_osmchange.osc.gz", kChange);
+  check(OSMChange::Read(file_name));
+  std::remove(file_name.c_str());
+}
+
+TEST(OSMChange, Malformed) {
+  const std::string file_name = "test_osmchange_malformed.osc";
+  for (const auto& bad : {std::string("<osmChange><create><node id=\"1\""),
+                          std::string("<nodes><node id=\"1\"/></nodes>"),
+                          std::string("<osmChange><modify><node id=\"x1\"/></modify></osmChange>"),
+                          std::string("<osmChange><way id=\"1\"><nd ref=1/></way></osmChange>"),
+                          std::string("<osmChange><node id=\"1\" lat=\"north\"/></osmChange>"),
+                          std::string("<osmChange><node id=\"1\"/></osmchange>"),
+                          std::string("<osmChange/><osmChange/>"),
+                          std::string("<osmChange><!-- unterminated </osmChange>")}) {
+    write_file(file_name, bad);
+    EXPECT_THROW(OSMChange::Read(file_name), std::runtime_error) << bad;
+  }
+  write_file(file_name, "<osmChange version=\"0.6\"/>\n");
+  EXPECT_TRUE(OSMChange::Read(file_name).nodes.empty());
+  std::remove(file_name.c_str());
+
+  // only change files are read
+  EXPECT_THROW(OSMChange::Read(write_file("test_osmchange.osm", kChange)), std::runtime_error);
+  std::remove("test_osmchange.osm");
+  EXPECT_THROW(OSMChange::Read("test_osmchange_missing.osc"), std::runtime_error);
+}
+
+TEST(OSMChange, Tiles) {
+  auto conf = test::make_config("test/data/utrecht_tiles");
+  GraphReader reader(conf.get_child("mjolnir"));
+  const auto& local_level = TileHierarchy::levels().back();
+
+  // the way of some edge in the tiles
+  auto tile_id = *reader.GetTileSet(local_level.level).begin();
+  auto tile = reader.GetGraphTile(tile_id);
+  ASSERT_TRUE(tile);
+  auto way_id = tile->edgeinfo(tile->directededge(0)).wayid();
+
+  OSMChange change;
+  change.ways[way_id] = {};
+  // a node on the other side of the world and a new way nowhere in the tiles
+  change.nodes[1] = PointLL(151.25, -33.5);
+  change.ways[2] = {3, 4};
+  change.nodes[3] = PointLL();
+  auto changed = FindChangedTiles(reader, change);
+
+  GraphId far_tile(local_level.tiles.TileId(PointLL(151.25, -33.5)), local_level.level, 0);
+  EXPECT_TRUE(changed.changed.count(tile_id));
+  EXPECT_TRUE(changed.changed.count(far_tile));
+  EXPECT_EQ(changed.unlocated_ways, 1);
+  for (const auto& neighbor : changed.neighbors) {
+    EXPECT_FALSE(changed.changed.count(neighbor));
+  }
+
+  // the parents are over the local tiles
+  for (const auto& level : TileHierarchy::levels()) {
+    if (level.level == local_level.level) {
+      continue;
+    }
+    auto center = local_level.tiles.Center(far_tile.tileid());
+    EXPECT_TRUE(changed.parents.count(GraphId(level.tiles.TileId(center), level.level, 0)));
+    for (const auto& parent : changed.parents) {
+      EXPECT_NE(parent.level(), local_level.level);
+    }
+  }
+
+  // nothing changed is no tiles
+  auto unchanged = FindChangedTiles(reader, OSMChange{});
+  EXPECT_TRUE(unchanged.changed.empty());
+  EXPECT_TRUE(unchanged.neighbors.empty());
+  EXPECT_TRUE(unchanged.parents.empty());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
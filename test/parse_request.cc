@@ -2812,6 +2812,60 @@ TEST(ParseRequest, test_operators_transit_filter) {
   test_filter_operator_parsing(costing, filter_action, filter_ids);
 }
 
+Api make_forwarded_request() {
+  Api api;
+  auto& options = *api.mutable_options();
+  for (auto* locations : {options.mutable_locations(), options.mutable_shape()}) {
+    for (int i = 0; i < 2; ++i) {
+      auto& correlation = *locations->Add()->mutable_correlation();
+      for (int j = 0; j < 3; ++j) {
+        correlation.add_edges()->set_graph_id(j);
+        correlation.add_filtered_edges()->set_graph_id(j + 3);
+      }
+    }
+  }
+  options.add_exclude_locations()->mutable_ll()->set_lat(52.1);
+  options.add_exclude_polygons()->add_coords()->set_lng(5.1);
+  return api;
+}
+
+TEST(ParseRequest, test_prune_for_thor) {
+  auto api = make_forwarded_request();
+  prune_for(Stage::kThor, api);
+  EXPECT_EQ(api.options().exclude_locations_size(), 0);
+  EXPECT_EQ(api.options().exclude_polygons_size(), 0);
+  // thor still has to pick from all of the candidates
+  for (const auto& location : api.options().locations()) {
+    EXPECT_EQ(location.correlation().edges_size(), 3);
+    EXPECT_EQ(location.correlation().filtered_edges_size(), 3);
+  }
+}
+
+TEST(ParseRequest, test_prune_for_odin) {
+  auto api = make_forwarded_request();
+  prune_for(Stage::kOdin, api);
+  for (const auto& location : api.options().locations()) {
+    ASSERT_EQ(location.correlation().edges_size(), 1);
+    EXPECT_EQ(location.correlation().edges(0).graph_id(), 0);
+    EXPECT_EQ(location.correlation().filtered_edges_size(), 0);
+  }
+  // the number of candidates of a trace point is its number of alternatives
+  for (const auto& location : api.options().shape()) {
+    EXPECT_EQ(location.correlation().edges_size(), 3);
+    EXPECT_EQ(location.correlation().filtered_edges_size(), 0);
+  }
+}
+
+TEST(ParseRequest, test_prune_for_pbf_options) {
+  auto api = make_forwarded_request();
+  api.mutable_options()->set_format(Options::pbf);
+  api.mutable_options()->mutable_pbf_field_selector()->set_options(true);
+  auto expected = api.SerializeAsString();
+  prune_for(Stage::kThor, api);
+  prune_for(Stage::kOdin, api);
+  EXPECT_EQ(api.SerializeAsString(), expected);
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,100 @@
+#include <random>
+
+#include "mjolnir/admin.h"
+
+#include "test.h"
+
+using namespace valhalla::mjolnir;
+using valhalla::midgard::AABB2;
+using valhalla::midgard::PointLL;
+
+namespace {
+
+multi_polygon_type make_polygon(const std::string& wkt) {
+  multi_polygon_type polygon;
+  boost::geometry::read_wkt(wkt, polygon);
+  return polygon;
+}
+
+// a tile split between a few polygons, one of them with a hole and one going off the tile
+std::multimap<uint32_t, multi_polygon_type> make_polygons() {
+  std::multimap<uint32_t, multi_polygon_type> polys;
+  polys.emplace(1, make_polygon("MULTIPOLYGON(((0 0,0.5 0,0.5 0.5,0 0.5,0 0),"
+                                "(0.1 0.1,0.1 0.2,0.2 0.2,0.2 0.1,0.1 0.1)))"));
+  polys.emplace(2, make_polygon("MULTIPOLYGON(((0.5 0,1 0,1 0.5,0.5 0.5,0.5 0)))"));
+  polys.emplace(3, make_polygon("MULTIPOLYGON(((0 0.5,0.73 0.91,-1 2,0 0.5)),"
+                                "((0.6 0.6,0.9 0.6,0.9 0.9,0.6 0.6)))"));
+  polys.emplace(4, make_polygon("MULTIPOLYGON(((0.1 0.1,0.1 0.2,0.2 0.2,0.2 0.1,0.1 0.1)))"));
+  return polys;
+}
+
+TEST(PolygonIndex, SameAsTestingEveryPolygon) {
+  auto polys = make_polygons();
+  AABB2<PointLL> bounds(0, 0, 1, 1);
+  for (uint32_t divisions : {1, 3, 16, 64}) {
+    PolygonIndex index(polys, bounds, divisions);
+    std::mt19937 generator(divisions);
+    std::uniform_real_distribution<double> distribution(-0.1, 1.1);
+    for (int i = 0; i < 10000; ++i) {
+      PointLL ll(distribution(generator), distribution(generator));
+      ASSERT_EQ(GetMultiPolyId(index, ll), GetMultiPolyId(polys, ll))
+          << divisions << " divisions at " << ll.lng() << "," << ll.lat();
+    }
+    // on the cell edges and the polygon corners
+    for (int x = 0; x <= 40; ++x) {
+      for (int y = 0; y <= 40; ++y) {
+        PointLL ll(x * .025, y * .025);
+        ASSERT_EQ(GetMultiPolyId(index, ll), GetMultiPolyId(polys, ll))
+            << divisions << " divisions at " << ll.lng() << "," << ll.lat();
+      }
+    }
+  }
+}
+
+TEST(PolygonIndex, Boundaries) {
+  auto polys = make_polygons();
+  PolygonIndex index(polys, AABB2<PointLL>(0, 0, 1, 1), 4);
+  // on the shared boundary the first one wins
+  EXPECT_EQ(GetMultiPolyId(index, PointLL(0.5, 0.25)), 1);
+  EXPECT_EQ(GetMultiPolyId(index, PointLL(0.5, 0.5)), 1);
+  // in the hole of the first is the last one
+  EXPECT_EQ(GetMultiPolyId(index, PointLL(0.15, 0.15)), 4);
+  EXPECT_EQ(GetMultiPolyId(index, PointLL(0.1, 0.15)), 1);
+  // on the corners of the tile
+  EXPECT_EQ(GetMultiPolyId(index, PointLL(0, 0)), 1);
+  EXPECT_EQ(GetMultiPolyId(index, PointLL(1, 0)), 2);
+  EXPECT_EQ(GetMultiPolyId(index, PointLL(1, 1)), 0);
+  // outside all of them
+  EXPECT_EQ(GetMultiPolyId(index, PointLL(0.95, 0.6)), 0);
+}
+
+TEST(PolygonIndex, Covering) {
+  auto polys = make_polygons();
+  PolygonIndex index(polys, AABB2<PointLL>(0, 0, 1, 1));
+  std::vector<uint32_t> covering;
+  index.covering(PointLL(0.15, 0.15), [&covering](uint32_t id) {
+    covering.push_back(id);
+    return false;
+  });
+  EXPECT_EQ(covering, std::vector<uint32_t>{4});
+
+  covering.clear();
+  index.covering(PointLL(0.2, 0.2), [&covering](uint32_t id) {
+    covering.push_back(id);
+    return false;
+  });
+  EXPECT_EQ(covering, (std::vector<uint32_t>{1, 4}));
+
+  // a single polygon isnt worth indexing but is still tested
+  std::multimap<uint32_t, multi_polygon_type> one{{7, polys.find(2)->second}};
+  PolygonIndex single(one, AABB2<PointLL>(0, 0, 1, 1));
+  EXPECT_EQ(GetMultiPolyId(single, PointLL(0.75, 0.25)), 7);
+  EXPECT_EQ(GetMultiPolyId(single, PointLL(0.25, 0.25)), 0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
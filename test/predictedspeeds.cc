@@ -283,6 +283,26 @@ TEST_F(EncoderDecoderTest, test_speeds_decoder) {
       << "Incorrect decoded coefficients";
 }
 
+TEST_F(EncoderDecoderTest, test_speeds_decoder_in_place) {
+  std::array<int16_t, kCoefficientCount> my_coefficients;
+  ASSERT_TRUE(decode_compressed_speeds(encoded.data(), encoded.size(), my_coefficients.data()));
+  ASSERT_TRUE(std::equal(coefficients.begin(), coefficients.end(), my_coefficients.begin()))
+      << "Incorrect decoded coefficients";
+
+  // the padding is optional
+  auto unpadded = encoded.substr(0, encoded.find('='));
+  my_coefficients.fill(0);
+  ASSERT_TRUE(decode_compressed_speeds(unpadded.data(), unpadded.size(), my_coefficients.data()));
+  ASSERT_TRUE(std::equal(coefficients.begin(), coefficients.end(), my_coefficients.begin()));
+
+  // not base64 or not the right length
+  auto bad = encoded;
+  bad[10] = ',';
+  EXPECT_FALSE(decode_compressed_speeds(bad.data(), bad.size(), my_coefficients.data()));
+  EXPECT_FALSE(decode_compressed_speeds(encoded.data(), 400, my_coefficients.data()));
+  EXPECT_THROW(decode_compressed_speeds(bad), std::runtime_error);
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
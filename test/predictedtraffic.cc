@@ -0,0 +1,146 @@
+#include "mjolnir/predictedtraffic.h"
+
+#include <fstream>
+
+#include "baldr/graphreader.h"
+#include "baldr/tilehierarchy.h"
+#include "filesystem.h"
+
+#include "test.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+// a week of the same speed
+std::string encoded_speeds(float speed) {
+  std::vector<float> speeds(kBucketsPerWeek, speed);
+  auto coefficients = compress_speed_buckets(speeds.data());
+  return encode_compressed_speeds(coefficients.data());
+}
+
+TrafficRow::Field parse(TrafficRow& row, const std::string& line) {
+  return row.Parse(line.data(), line.data() + line.size());
+}
+
+TEST(PredictedTraffic, Parse) {
+  TrafficRow row;
+  auto speeds = encoded_speeds(50);
+
+  ASSERT_EQ(parse(row, "1/47701/130," + speeds), TrafficRow::kFreeFlowSpeed);
+
+  ASSERT_EQ(parse(row, "1/47701/130,45,30," + speeds + "\r"), TrafficRow::kFieldCount);
+  EXPECT_EQ(row.edge_id, GraphId(47701, 1, 130));
+  EXPECT_EQ(row.free_flow_speed, 45);
+  EXPECT_EQ(row.constrained_flow_speed, 30);
+  EXPECT_EQ(row.field_count, 4);
+  EXPECT_TRUE(row.has_coefficients);
+  EXPECT_EQ(encode_compressed_speeds(row.coefficients.data()), speeds);
+
+  // missing and empty fields leave the speeds alone
+  ASSERT_EQ(parse(row, "2/0/7,45"), TrafficRow::kFieldCount);
+  EXPECT_EQ(row.edge_id, GraphId(0, 2, 7));
+  EXPECT_EQ(row.constrained_flow_speed, 0);
+  EXPECT_EQ(row.field_count, 2);
+  EXPECT_FALSE(row.has_coefficients);
+  ASSERT_EQ(parse(row, "0/1/2, ,,"), TrafficRow::kFieldCount);
+  EXPECT_EQ(row.free_flow_speed, 0);
+  EXPECT_EQ(row.field_count, 4);
+  EXPECT_FALSE(row.has_coefficients);
+
+  // the first field that is wrong
+  EXPECT_EQ(parse(row, ""), TrafficRow::kEdgeId);
+  EXPECT_EQ(parse(row, "1/47701"), TrafficRow::kEdgeId);
+  EXPECT_EQ(parse(row, "1/47701/130/2,45"), TrafficRow::kEdgeId);
+  EXPECT_EQ(parse(row, "8/0/0,45"), TrafficRow::kEdgeId);
+  EXPECT_EQ(parse(row, "1/47701/x,45"), TrafficRow::kEdgeId);
+  EXPECT_EQ(parse(row, "1/47701/130,256"), TrafficRow::kFreeFlowSpeed);
+  EXPECT_EQ(parse(row, "1/47701/130,4 5"), TrafficRow::kFreeFlowSpeed);
+  EXPECT_EQ(parse(row, "1/47701/130,45,-1"), TrafficRow::kConstrainedFlowSpeed);
+  EXPECT_EQ(parse(row, "1/47701/130,45,30,AAAA"), TrafficRow::kCompressedSpeeds);
+  EXPECT_EQ(parse(row, "1/47701/130,45,30," + speeds.substr(1) + "!"),
+            TrafficRow::kCompressedSpeeds);
+}
+
+TEST(PredictedTraffic, UpdateInPlace) {
+  // work on a copy of a tile
+  auto conf = test::make_config("test/data/utrecht_tiles");
+  GraphReader reader(conf.get_child("mjolnir"));
+  auto tile_id = *reader.GetTileSet(TileHierarchy::levels().back().level).begin();
+  auto tile_dir = std::string("test/data/predicted_traffic");
+  auto tile_path = tile_dir + filesystem::path::preferred_separator + GraphTile::FileSuffix(tile_id);
+  filesystem::remove_all(tile_dir);
+  ASSERT_TRUE(filesystem::create_directories(filesystem::path(tile_path).parent_path()));
+  {
+    std::ifstream in(conf.get<std::string>("mjolnir.tile_dir") +
+                         filesystem::path::preferred_separator + GraphTile::FileSuffix(tile_id),
+                     std::ios::binary);
+    std::ofstream out(tile_path, std::ios::binary);
+    out << in.rdbuf();
+  }
+  auto original = GraphTile::Create(tile_dir, tile_id);
+  ASSERT_TRUE(original);
+  ASSERT_GT(original->header()->directededgecount(), 2);
+
+  // the first edge gets everything, the second only a speed
+  TrafficRow row;
+  TileSpeedsUpdater updater;
+  updater.Open(tile_path);
+  EXPECT_EQ(updater.edge_count(), original->header()->directededgecount());
+  ASSERT_EQ(parse(row, "0/0/0,45,30," + encoded_speeds(50)), TrafficRow::kFieldCount);
+  EXPECT_TRUE(updater.Update(0, row));
+  EXPECT_FALSE(updater.Update(0, row));
+  ASSERT_EQ(parse(row, "0/0/1,0,20"), TrafficRow::kFieldCount);
+  EXPECT_TRUE(updater.Update(1, row));
+  EXPECT_EQ(updater.Write(), 2);
+
+  auto updated = GraphTile::Create(tile_dir, tile_id);
+  ASSERT_TRUE(updated);
+  EXPECT_EQ(updated->header()->end_offset(), filesystem::directory_entry(tile_path).file_size());
+  EXPECT_EQ(updated->header()->predictedspeeds_count(), 1);
+  const auto* edge = updated->directededge(0);
+  EXPECT_EQ(edge->free_flow_speed(), 45);
+  EXPECT_EQ(edge->constrained_flow_speed(), 30);
+  EXPECT_TRUE(edge->has_predicted_speed());
+  EXPECT_NEAR(updated->GetSpeed(edge, kPredictedFlowMask, 3600), 50, 2);
+  edge = updated->directededge(1);
+  EXPECT_EQ(edge->free_flow_speed(), original->directededge(1)->free_flow_speed());
+  EXPECT_EQ(edge->constrained_flow_speed(), 20);
+  EXPECT_FALSE(edge->has_predicted_speed());
+  // the rest of the tile is as it was
+  EXPECT_EQ(updated->directededge(2)->free_flow_speed(),
+            original->directededge(2)->free_flow_speed());
+  EXPECT_EQ(updated->edgeinfo(updated->directededge(2)).wayid(),
+            original->edgeinfo(original->directededge(2)).wayid());
+
+  // doing it again replaces the predicted speeds rather than adding more of them
+  updater.Open(tile_path);
+  ASSERT_EQ(parse(row, "0/0/1,,," + encoded_speeds(30)), TrafficRow::kFieldCount);
+  EXPECT_TRUE(updater.Update(1, row));
+  EXPECT_EQ(updater.Write(), 1);
+  updated = GraphTile::Create(tile_dir, tile_id);
+  ASSERT_TRUE(updated);
+  EXPECT_EQ(updated->header()->end_offset(), filesystem::directory_entry(tile_path).file_size());
+  EXPECT_EQ(updated->header()->predictedspeeds_count(), 1);
+  EXPECT_FALSE(updated->directededge(0)->has_predicted_speed());
+  EXPECT_EQ(updated->directededge(0)->free_flow_speed(), 45);
+  EXPECT_TRUE(updated->directededge(1)->has_predicted_speed());
+  EXPECT_NEAR(updated->GetSpeed(updated->directededge(1), kPredictedFlowMask, 3600), 30, 2);
+
+  // and without any predicted speeds the tile shrinks back to its old size
+  updater.Open(tile_path);
+  EXPECT_EQ(updater.Write(), 0);
+  updated = GraphTile::Create(tile_dir, tile_id);
+  ASSERT_TRUE(updated);
+  EXPECT_EQ(updated->header()->predictedspeeds_count(), 0);
+  EXPECT_EQ(updated->header()->end_offset(), original->header()->end_offset());
+  EXPECT_EQ(filesystem::directory_entry(tile_path).file_size(), original->header()->end_offset());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -6,12 +6,15 @@
 
 #include "baldr/graphreader.h"
 #include "baldr/rapidjson_utils.h"
+#include "baldr/sharedtilesegment.h"
 #include "baldr/tilehierarchy.h"
 #include "midgard/encoded.h"
 #include "midgard/util.h"
 #include "src/baldr/shortcut_recovery.h"
 #include <boost/property_tree/ptree.hpp>
 
+#include <unistd.h>
+
 using namespace valhalla;
 using namespace valhalla::baldr;
 using namespace valhalla::midgard;
@@ -26,8 +29,10 @@ const auto conf = test::make_config("test/data/utrecht_tiles");
 
 // expose the constructor
 struct testable_recovery : public shortcut_recovery_t {
-  testable_recovery(GraphReader* reader) : shortcut_recovery_t(reader) {
+  testable_recovery(GraphReader* reader, std::shared_ptr<SharedTileSegment> segment = nullptr)
+      : shortcut_recovery_t(reader, std::move(segment)) {
   }
+  using shortcut_recovery_t::shortcuts;
 };
 
 void recover(bool cache) {
@@ -131,6 +136,46 @@ TEST(RecoverShortcut, test_recover_shortcut_edges_cache) {
   recover(true);
 }
 
+TEST(RecoverShortcut, test_recover_shortcut_edges_shared) {
+  GraphReader graphreader(conf.get_child("mjolnir"));
+  const std::string name = "valhalla_test_shortcuts_" + std::to_string(getpid());
+  SharedTileSegment::Remove(name);
+  auto segment = SharedTileSegment::Get(name, 64 * 1024 * 1024, graphreader.GetTilesetId());
+
+  // the first one recovers the shortcuts and keeps nothing to itself
+  testable_recovery local{&graphreader};
+  testable_recovery first{&graphreader, segment};
+  EXPECT_TRUE(first.shortcuts.empty());
+  EXPECT_GT(segment->stats().tiles, 0);
+
+  // the second one finds them all in shared memory
+  const auto used = segment->stats().used;
+  testable_recovery second{&graphreader, segment};
+  EXPECT_TRUE(second.shortcuts.empty());
+  EXPECT_EQ(segment->stats().used, used);
+
+  // and they are the same as the ones recovered without sharing
+  size_t shortcuts = 0;
+  for (const auto& level : TileHierarchy::levels()) {
+    if (level.level > 1)
+      continue;
+    for (const auto tileid : graphreader.GetTileSet(level.level)) {
+      auto tile = graphreader.GetGraphTile(tileid);
+      for (size_t j = 0; j < tile->header()->directededgecount(); ++j) {
+        if (!tile->directededge(j)->is_shortcut())
+          continue;
+        auto shortcutid = tileid;
+        shortcutid.set_id(j);
+        EXPECT_EQ(second.get(shortcutid, graphreader), local.get(shortcutid, graphreader));
+        ++shortcuts;
+      }
+    }
+  }
+  EXPECT_GT(shortcuts, 0);
+
+  SharedTileSegment::Remove(name);
+}
+
 int main(int argc, char* argv[]) {
   // valhalla::midgard::logging::Configure({{"type", ""}});
   testing::InitGoogleTest(&argc, argv);
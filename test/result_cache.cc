@@ -0,0 +1,174 @@
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include "baldr/traffictile.h"
+#include "result_cache.h"
+
+#include "test.h"
+
+using namespace valhalla;
+
+namespace {
+
+constexpr auto kResponse = ResultCache::Kind::kResponse;
+constexpr auto kPath = ResultCache::Kind::kPath;
+
+Options make_options(Options::Action action) {
+  Options options;
+  options.set_action(action);
+  options.set_costing_type(Costing::auto_);
+  (*options.mutable_costings())[Costing::auto_].set_type(Costing::auto_);
+  (*options.mutable_costings())[Costing::bicycle].set_type(Costing::bicycle);
+  for (double lat : {52.09, 52.1}) {
+    auto* location = options.add_locations();
+    location->mutable_ll()->set_lat(lat);
+    location->mutable_ll()->set_lng(5.1);
+  }
+  return options;
+}
+
+TEST(ResultCache, FindAndInsert) {
+  ResultCache cache(1 << 20);
+  std::string result;
+  EXPECT_FALSE(cache.Find(kResponse, "1", result));
+  cache.Insert("1", "one");
+  ASSERT_TRUE(cache.Find(kResponse, "1", result));
+  EXPECT_EQ(result, "one");
+
+  // the first one in wins
+  cache.Insert("1", "uno");
+  ASSERT_TRUE(cache.Find(kResponse, "1", result));
+  EXPECT_EQ(result, "one");
+
+  // an empty key means it cant be cached
+  cache.Insert("", "zero");
+  EXPECT_FALSE(cache.Find(kResponse, "", result));
+
+  auto stats = cache.stats();
+  EXPECT_EQ(stats.hits, 2);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.path_hits, 0);
+  EXPECT_EQ(stats.entries, 1);
+  EXPECT_EQ(stats.capacity, 1 << 20);
+  EXPECT_GT(stats.used, 3);
+}
+
+TEST(ResultCache, LeastRecentlyUsed) {
+  // room for about 8 of these
+  ResultCache cache(8 * 1100);
+  std::string result(1000, 'x');
+  for (int key = 1; key <= 8; ++key) {
+    cache.Insert(std::to_string(key), result);
+  }
+  EXPECT_EQ(cache.stats().entries, 8);
+
+  // touch the first so that the second is the oldest
+  EXPECT_TRUE(cache.Find(kPath, "1", result));
+  cache.Insert("9", result);
+  EXPECT_TRUE(cache.Find(kPath, "1", result));
+  EXPECT_FALSE(cache.Find(kPath, "2", result));
+  EXPECT_TRUE(cache.Find(kPath, "9", result));
+  EXPECT_LE(cache.stats().used, 8 * 1100);
+  EXPECT_EQ(cache.stats().path_hits, 3);
+  EXPECT_EQ(cache.stats().path_misses, 1);
+
+  // something this big would push out most everything else
+  cache.Insert("10", std::string(4000, 'x'));
+  EXPECT_FALSE(cache.Find(kPath, "10", result));
+}
+
+TEST(ResultCache, Keys) {
+  ResultCache cache(1 << 20);
+  auto options = make_options(Options::route);
+  auto response_key = cache.Key(kResponse, options, 1);
+  auto path_key = cache.Key(kPath, options, 1);
+  EXPECT_FALSE(response_key.empty());
+  EXPECT_FALSE(path_key.empty());
+  EXPECT_NE(response_key, path_key);
+  EXPECT_EQ(cache.Key(kResponse, make_options(Options::route), 1), response_key);
+
+  // the language changes the response but not the path
+  options.set_language("de-DE");
+  EXPECT_NE(cache.Key(kResponse, options, 1), response_key);
+  EXPECT_EQ(cache.Key(kPath, options, 1), path_key);
+
+  // the costing changes both
+  (*options.mutable_costings())[Costing::auto_].mutable_options()->set_toll_booth_cost(60);
+  EXPECT_NE(cache.Key(kPath, options, 1), path_key);
+
+  // anything depending on the current time cant be cached
+  options = make_options(Options::route);
+  options.set_date_time_type(Options::current);
+  EXPECT_TRUE(cache.Key(kResponse, options, 1).empty());
+  EXPECT_TRUE(cache.Key(kPath, options, 1).empty());
+
+  // only routes have paths worth keeping and locate and status are not worth keeping at all
+  EXPECT_FALSE(cache.Key(kResponse, make_options(Options::sources_to_targets), 1).empty());
+  EXPECT_TRUE(cache.Key(kPath, make_options(Options::sources_to_targets), 1).empty());
+  EXPECT_TRUE(cache.Key(kResponse, make_options(Options::locate), 1).empty());
+  EXPECT_TRUE(cache.Key(kResponse, make_options(Options::status), 1).empty());
+}
+
+TEST(ResultCache, Tileset) {
+  ResultCache cache(1 << 20);
+  auto options = make_options(Options::route);
+  auto key = cache.Key(kResponse, options, 1);
+  cache.Insert(key, "route");
+  std::string result;
+  EXPECT_TRUE(cache.Find(kResponse, key, result));
+  EXPECT_EQ(cache.Key(kResponse, options, 1), key);
+
+  // new tiles mean new keys and nothing left over from before
+  auto new_key = cache.Key(kResponse, options, 2);
+  EXPECT_NE(new_key, key);
+  EXPECT_FALSE(cache.Find(kResponse, new_key, result));
+  EXPECT_FALSE(cache.Find(kResponse, key, result));
+  EXPECT_EQ(cache.stats().entries, 0);
+  EXPECT_EQ(cache.stats().used, 0);
+}
+
+TEST(ResultCache, Traffic) {
+  auto options = make_options(Options::route);
+
+  // traffic updated in place cant be told apart so nothing is cached
+  baldr::TrafficEpochs::Set(nullptr);
+  ResultCache cache(1 << 20, true);
+  EXPECT_TRUE(cache.Key(kResponse, options, 1).empty());
+
+  // with epochs the results are kept for the epoch they were computed with
+  auto file = "test/data/result_cache_" + std::to_string(getpid());
+  auto epochs = std::make_shared<baldr::TrafficEpochs>(file, true);
+  baldr::TrafficEpochs::Set(epochs);
+  std::string key;
+  {
+    baldr::TrafficSnapshot snapshot;
+    key = cache.Key(kResponse, options, 1);
+    ASSERT_FALSE(key.empty());
+    cache.Insert(key, "route");
+  }
+  std::string result;
+  EXPECT_TRUE(cache.Find(kResponse, key, result));
+
+  // once the next update is published the old results are gone
+  epochs->Publish(epochs->Begin());
+  {
+    baldr::TrafficSnapshot snapshot;
+    auto new_key = cache.Key(kResponse, options, 1);
+    EXPECT_NE(new_key, key);
+    EXPECT_FALSE(cache.Find(kResponse, new_key, result));
+    EXPECT_FALSE(cache.Find(kResponse, key, result));
+    EXPECT_EQ(cache.stats().entries, 0);
+  }
+
+  baldr::TrafficEpochs::Set(nullptr);
+  unlink(file.c_str());
+  unlink((file + ".epochs").c_str());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,8 @@
 #include "midgard/sequence.h"
+#include <algorithm>
 #include <cstdint>
+#include <unistd.h>
+#include <vector>
 
 #include "test.h"
 
@@ -70,6 +73,39 @@ TEST(Sequence, Iterator) {
   EXPECT_EQ(i.position(), 0) << "Pre-decrement operator wasn't right";
 }
 
+TEST(Sequence, ParallelSort) {
+  // lots of duplicates and a few too many for the buffer so there are uneven subsections
+  std::string file_name = "parallel.nd";
+  const uint64_t count = 100003;
+  std::vector<uint64_t> ids;
+  {
+    sequence<osm_node> sequence(file_name, true);
+    for (uint64_t i = 0; i < count; ++i) {
+      ids.push_back((i * 7919) % 1000);
+      sequence.push_back({ids.back(), 0.f, 0.f, static_cast<uint32_t>(i)});
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+
+  for (size_t threads : {1, 3, 8}) {
+    sequence<osm_node> sequence(file_name, false);
+    sequence.sort([](const osm_node& a, const osm_node& b) { return a.attributes < b.attributes; },
+                  10000, 1);
+    sequence.sort([](const osm_node& a, const osm_node& b) { return a.id < b.id; }, 10000,
+                  threads);
+    ASSERT_EQ(sequence.size(), count);
+    // sorted and nothing lost or repeated along the way
+    std::vector<bool> seen(count);
+    for (uint64_t i = 0; i < count; ++i) {
+      osm_node node = *sequence[i];
+      ASSERT_EQ(node.id, ids[i]) << threads << " threads at " << i;
+      ASSERT_FALSE(seen[node.attributes]);
+      seen[node.attributes] = true;
+    }
+  }
+  unlink(file_name.c_str());
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
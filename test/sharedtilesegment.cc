@@ -0,0 +1,187 @@
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "baldr/sharedtilesegment.h"
+
+#include "test.h"
+
+using namespace valhalla::baldr;
+
+namespace {
+
+constexpr uint64_t kTileset = 1234;
+
+// unique per test process so that parallel test runs dont trip over each other
+std::string segment_name(const std::string& test) {
+  return "valhalla_test_" + test + "_" + std::to_string(getpid());
+}
+
+struct segment_guard {
+  explicit segment_guard(std::string name) : name(std::move(name)) {
+    SharedTileSegment::Remove(this->name);
+  }
+  ~segment_guard() {
+    SharedTileSegment::Remove(name);
+  }
+  std::string name;
+};
+
+TEST(SharedTileSegment, PublishAndFind) {
+  segment_guard guard(segment_name("publish"));
+  auto segment = SharedTileSegment::Get(guard.name, 1 << 20, kTileset);
+
+  GraphId tile_id(10, 2, 0);
+  EXPECT_EQ(segment->Find(tile_id).first, nullptr);
+
+  std::string bytes(1000, 'x');
+  auto published = segment->Publish(tile_id, bytes.data(), bytes.size());
+  ASSERT_NE(published.first, nullptr);
+  EXPECT_EQ(published.second, bytes.size());
+  EXPECT_EQ(std::memcmp(published.first, bytes.data(), bytes.size()), 0);
+
+  // any id in the tile finds it and publishing it again hands back the first copy
+  auto found = segment->Find(GraphId(10, 2, 42));
+  EXPECT_EQ(found.first, published.first);
+  EXPECT_EQ(segment->Publish(tile_id, bytes.data(), bytes.size()).first, published.first);
+
+  auto stats = segment->stats();
+  EXPECT_EQ(stats.tiles, 1);
+  EXPECT_GE(stats.used, bytes.size());
+  EXPECT_GT(stats.capacity, stats.used);
+
+  // the same name gives the same mapping within a process
+  EXPECT_EQ(SharedTileSegment::Get(guard.name, 1 << 20, kTileset).get(), segment.get());
+}
+
+TEST(SharedTileSegment, Full) {
+  segment_guard guard(segment_name("full"));
+  auto segment = SharedTileSegment::Get(guard.name, 1 << 20, kTileset);
+
+  std::string big(segment->stats().capacity / 2 + 1, 'y');
+  EXPECT_NE(segment->Publish(GraphId(1, 2, 0), big.data(), big.size()).first, nullptr);
+  EXPECT_EQ(segment->Publish(GraphId(2, 2, 0), big.data(), big.size()).first, nullptr);
+  EXPECT_EQ(segment->Find(GraphId(2, 2, 0)).first, nullptr);
+
+  // smaller ones still fit
+  std::string small(100, 'z');
+  EXPECT_NE(segment->Publish(GraphId(3, 2, 0), small.data(), small.size()).first, nullptr);
+  EXPECT_EQ(segment->stats().tiles, 2);
+}
+
+TEST(SharedTileSegment, SharedAcrossProcesses) {
+  segment_guard guard(segment_name("processes"));
+  auto segment = SharedTileSegment::Get(guard.name, 1 << 20, kTileset);
+
+  std::string bytes(1000, 'x');
+  auto published = segment->Publish(GraphId(10, 2, 0), bytes.data(), bytes.size());
+  ASSERT_NE(published.first, nullptr);
+
+  // another process sees the tile and can publish its own
+  pid_t pid = fork();
+  if (pid == 0) {
+    SharedTileSegment other(guard.name, 0, kTileset);
+    auto found = other.Find(GraphId(10, 2, 0));
+    bool ok = found.first && found.second == bytes.size() && found.first[0] == 'x';
+    ok = ok && other.Publish(GraphId(11, 2, 0), bytes.data(), bytes.size()).first;
+    _exit(ok ? 0 : 1);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+
+  EXPECT_NE(segment->Find(GraphId(11, 2, 0)).first, nullptr);
+  EXPECT_EQ(segment->stats().tiles, 2);
+}
+
+TEST(SharedTileSegment, ReadOnly) {
+  segment_guard guard(segment_name("readonly"));
+  auto segment = SharedTileSegment::Get(guard.name, 1 << 20, kTileset);
+
+  std::string bytes(1000, 'x');
+  auto published = segment->Publish(GraphId(10, 2, 0), bytes.data(), bytes.size());
+  ASSERT_NE(published.first, nullptr);
+
+  // writing to a published tile is not allowed
+  EXPECT_DEATH(published.first[0] = 'z', "");
+}
+
+TEST(SharedTileSegment, OtherTileset) {
+  segment_guard guard(segment_name("tileset"));
+  auto segment = SharedTileSegment::Get(guard.name, 1 << 20, kTileset);
+  std::string bytes(1000, 'x');
+  auto published = segment->Publish(GraphId(10, 2, 0), bytes.data(), bytes.size());
+  ASSERT_NE(published.first, nullptr);
+
+  // opening it for other tiles starts over with an empty segment
+  auto other = SharedTileSegment::Get(guard.name, 1 << 20, kTileset + 1);
+  EXPECT_NE(other.get(), segment.get());
+  EXPECT_EQ(other->tileset_id(), kTileset + 1);
+  EXPECT_EQ(other->stats().tiles, 0);
+  EXPECT_EQ(other->Find(GraphId(10, 2, 0)).first, nullptr);
+
+  // while the old mapping keeps working
+  EXPECT_EQ(segment->Find(GraphId(10, 2, 0)).first, published.first);
+  EXPECT_EQ(published.first[0], 'x');
+}
+
+TEST(SharedTileSegment, DeadWriter) {
+  segment_guard guard(segment_name("dead"));
+  auto segment = SharedTileSegment::Get(guard.name, 1 << 20, kTileset);
+
+  // another process publishes a tile and goes away
+  std::string bytes(1000, 'x');
+  pid_t pid = fork();
+  if (pid == 0) {
+    SharedTileSegment other(guard.name, 0, kTileset);
+    _exit(other.Publish(GraphId(10, 2, 0), bytes.data(), bytes.size()).first ? 0 : 1);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+
+  // pretend it died half way through by putting its slot back into the writing state. the slots
+  // follow the 64 byte header and are 32 bytes each: key, state, owner, offset, size
+  int fd = shm_open(("/" + guard.name).c_str(), O_RDWR, 0);
+  ASSERT_NE(fd, -1);
+  auto* memory =
+      static_cast<char*>(mmap(nullptr, 1 << 20, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+  close(fd);
+  ASSERT_NE(memory, MAP_FAILED);
+  const uint64_t key = GraphId(10, 2, 0).value + 1;
+  bool found = false;
+  for (char* slot = memory + 64; slot + 32 <= memory + (1 << 20) && !found; slot += 32) {
+    if (std::memcmp(slot, &key, sizeof(key)) == 0) {
+      const uint32_t writing = 0;
+      std::memcpy(slot + 8, &writing, sizeof(writing));
+      found = true;
+    }
+  }
+  munmap(memory, 1 << 20);
+  ASSERT_TRUE(found);
+  EXPECT_EQ(segment->Find(GraphId(10, 2, 0)).first, nullptr);
+
+  // so we take over and publish it ourselves
+  std::string ours(1000, 'y');
+  auto published = segment->Publish(GraphId(10, 2, 0), ours.data(), ours.size());
+  ASSERT_NE(published.first, nullptr);
+  EXPECT_EQ(published.first[0], 'y');
+  EXPECT_EQ(segment->Find(GraphId(10, 2, 0)).first, published.first);
+}
+
+TEST(SharedTileSegment, TooSmall) {
+  segment_guard guard(segment_name("small"));
+  EXPECT_THROW(SharedTileSegment(guard.name, 1024, kTileset), std::runtime_error);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
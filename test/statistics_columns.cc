@@ -0,0 +1,169 @@
+#include "statistics.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "filesystem.h"
+#include "midgard/sequence.h"
+
+#include "test.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+const std::string kDir = "test/data/statistics_columns";
+
+struct column_t {
+  std::string name;
+  uint32_t type;
+  uint64_t offset;
+  uint64_t size;
+};
+
+// a <table>.columns file mapped back in, checking the layout as it goes
+struct table_t {
+  mem_map<char> map;
+  uint64_t rows = 0;
+  std::vector<column_t> columns;
+
+  explicit table_t(const std::string& name) {
+    auto path = kDir + "/" + name + ".columns";
+    uint64_t size = std::ifstream(path, std::ios::binary | std::ios::ate).tellg();
+    map.map(path, size, POSIX_MADV_NORMAL, true);
+    const char* data = map.get();
+
+    EXPECT_EQ(std::string(data, 8), "VSTATCOL");
+    uint32_t version, count;
+    std::memcpy(&version, data + 8, sizeof(version));
+    std::memcpy(&count, data + 12, sizeof(count));
+    std::memcpy(&rows, data + 16, sizeof(rows));
+    EXPECT_EQ(version, 1);
+
+    // the columns come after the headers, in order, and start 8 byte aligned
+    uint64_t end = 24 + 64 * count;
+    for (uint32_t i = 0; i < count; ++i) {
+      const char* header = data + 24 + 64 * i;
+      EXPECT_EQ(header[39], '\0');
+      column_t column{std::string(header), 0, 0, 0};
+      uint32_t reserved;
+      std::memcpy(&column.type, header + 40, sizeof(column.type));
+      std::memcpy(&reserved, header + 44, sizeof(reserved));
+      std::memcpy(&column.offset, header + 48, sizeof(column.offset));
+      std::memcpy(&column.size, header + 56, sizeof(column.size));
+      EXPECT_EQ(reserved, 0);
+      EXPECT_EQ(column.offset % 8, 0) << column.name;
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(data + column.offset) % 8, 0) << column.name;
+      EXPECT_GE(column.offset, end) << column.name;
+      EXPECT_LT(column.offset - end, 8) << column.name;
+      end = column.offset + column.size;
+      columns.push_back(column);
+    }
+    EXPECT_EQ(end, size);
+  }
+
+  const column_t& column(const std::string& name) const {
+    for (const auto& column : columns) {
+      if (column.name == name) {
+        return column;
+      }
+    }
+    throw std::runtime_error("No column " + name);
+  }
+
+  // the values of a number column, used straight from the map
+  template <typename T> std::vector<T> values(const std::string& name, uint32_t type) const {
+    const auto& c = column(name);
+    EXPECT_EQ(c.type, type) << name;
+    EXPECT_EQ(c.size, rows * sizeof(T)) << name;
+    const auto* begin = reinterpret_cast<const T*>(map.get() + c.offset);
+    return std::vector<T>(begin, begin + rows);
+  }
+
+  std::vector<std::string> strings(const std::string& name) const {
+    const auto& c = column(name);
+    EXPECT_EQ(c.type, 2) << name;
+    const auto* offsets = reinterpret_cast<const uint32_t*>(map.get() + c.offset);
+    const char* characters = map.get() + c.offset + (rows + 1) * sizeof(uint32_t);
+    EXPECT_EQ(offsets[0], 0) << name;
+    EXPECT_EQ(c.size, (rows + 1) * sizeof(uint32_t) + offsets[rows]) << name;
+    std::vector<std::string> strings;
+    for (uint64_t i = 0; i < rows; ++i) {
+      EXPECT_LE(offsets[i], offsets[i + 1]) << name;
+      strings.emplace_back(characters + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    return strings;
+  }
+};
+
+TEST(StatisticsColumns, Write) {
+  statistics stats;
+  stats.add_tile_road(5, RoadClass::kMotorway, 10.f);
+  stats.add_tile_road(3, RoadClass::kResidential, 2.5f);
+  stats.add_tile_road(3, RoadClass::kResidential, 1.f);
+  stats.add_tile_area(5, 1.5f);
+  stats.add_tile_geom(5, AABB2<PointLL>(5, 52, 5.25, 52.25));
+  stats.add_tile_geom(3, AABB2<PointLL>(4.75, 52, 5, 52.25));
+  stats.add_tile_one_way(5, RoadClass::kMotorway, 4.f);
+  stats.add_tile_int_edge(5, RoadClass::kMotorway, 3);
+  stats.add_country_road("NL", RoadClass::kMotorway, 10.f);
+  stats.add_country_road("DE", RoadClass::kTrunk, 2.f);
+  stats.add_exitinfo(std::pair<std::string, short>("NL", 1));
+  stats.add_exitinfo(std::pair<std::string, short>("NL", 0));
+  filesystem::remove_all(kDir);
+  stats.build_columns(kDir);
+
+  // a row per tile, sorted by id
+  table_t tiles("tiledata");
+  EXPECT_EQ(tiles.rows, 2);
+  ASSERT_EQ(tiles.columns.size(), 15);
+  EXPECT_EQ(tiles.columns.front().name, "tileid");
+  EXPECT_EQ(tiles.columns.back().name, "maxy");
+  EXPECT_EQ(tiles.values<uint64_t>("tileid", 0), (std::vector<uint64_t>{3, 5}));
+  EXPECT_EQ(tiles.values<float>("tilearea", 1), (std::vector<float>{0.f, 1.5f}));
+  EXPECT_EQ(tiles.values<float>("totalroadlen", 1), (std::vector<float>{3.5f, 10.f}));
+  EXPECT_EQ(tiles.values<float>("motorway", 1), (std::vector<float>{0.f, 10.f}));
+  EXPECT_EQ(tiles.values<float>("residential", 1), (std::vector<float>{3.5f, 0.f}));
+  EXPECT_EQ(tiles.values<float>("minx", 1), (std::vector<float>{4.75f, 5.f}));
+
+  // a row per tile and road class, the types are strings of different lengths
+  table_t roads("rclasstiledata");
+  EXPECT_EQ(roads.rows, 2 * 8);
+  auto types = roads.strings("type");
+  EXPECT_EQ(types[0], "Motorway");
+  EXPECT_EQ(types[1], "Primary");
+  EXPECT_EQ(types[8], "Motorway");
+  auto tile_ids = roads.values<uint64_t>("tileid", 0);
+  auto oneway = roads.values<float>("oneway", 1);
+  auto internal = roads.values<uint64_t>("internaledges", 0);
+  EXPECT_EQ(tile_ids[8], 5);
+  EXPECT_EQ(oneway[8], 4.f);
+  EXPECT_EQ(internal[8], 3);
+  EXPECT_EQ(internal[0], 0);
+
+  // a row per country, sorted by iso code
+  table_t countries("countrydata");
+  EXPECT_EQ(countries.strings("isocode"), (std::vector<std::string>{"DE", "NL"}));
+  EXPECT_EQ(countries.values<float>("trunk", 1), (std::vector<float>{2.f, 0.f}));
+
+  table_t exits("ctry_exitinfo");
+  EXPECT_EQ(exits.strings("isocode"), (std::vector<std::string>{"NL"}));
+  EXPECT_EQ(exits.values<float>("exitsign", 1), (std::vector<float>{0.5f}));
+
+  // the tables without any rows are still there
+  table_t forks("tile_forkinfo");
+  EXPECT_EQ(forks.rows, 0);
+  EXPECT_EQ(forks.values<uint64_t>("tileid", 0).size(), 0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
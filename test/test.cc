@@ -8,6 +8,7 @@
 #include "mjolnir/graphtilebuilder.h"
 
 #include <cmath>
+#include <cstdio>
 #include <fstream>
 #include <random>
 #include <sstream>
@@ -434,7 +435,8 @@ typedef struct {
 //
 /*************************************************************/
 void build_live_traffic_data(const boost::property_tree::ptree& config,
-                             uint32_t traffic_tile_version) {
+                             uint32_t traffic_tile_version,
+                             bool double_buffered) {
 
   std::string tile_dir = config.get<std::string>("mjolnir.tile_dir");
   std::string traffic_extract = config.get<std::string>("mjolnir.traffic_extract");
@@ -477,7 +479,7 @@ void build_live_traffic_data(const boost::property_tree::ptree& config,
       header.directed_edge_count = tile->header()->directededgecount();
       buffer.write(reinterpret_cast<char*>(&header), sizeof(header));
       valhalla::baldr::TrafficSpeed dummy_speed = {}; // Initialize to all zeros
-      for (uint32_t i = 0; i < header.directed_edge_count; ++i) {
+      for (uint32_t i = 0; i < header.directed_edge_count * (double_buffered ? 2 : 1); ++i) {
         buffer.write(reinterpret_cast<char*>(&dummy_speed), sizeof(dummy_speed));
       }
 
@@ -501,6 +503,12 @@ void build_live_traffic_data(const boost::property_tree::ptree& config,
     mtar_finalize(&tar);
     mtar_close(&tar);
   }
+
+  // double buffered tiles need somewhere to publish their updates
+  std::remove((traffic_extract + ".epochs").c_str());
+  if (double_buffered) {
+    valhalla::baldr::TrafficEpochs epochs(traffic_extract, true);
+  }
 }
 
 /*************************************************************/
@@ -513,8 +521,11 @@ void customize_live_traffic_data(const boost::property_tree::ptree& config,
                                  const LiveTrafficCustomize& setter_cb) {
   // Now we have the tar-file and can go ahead with per edge customizations
   {
-    const auto memory =
-        std::make_shared<MMap>(config.get<std::string>("mjolnir.traffic_extract").c_str());
+    const auto traffic_extract = config.get<std::string>("mjolnir.traffic_extract");
+    const auto memory = std::make_shared<MMap>(traffic_extract.c_str());
+    // publish it as one update if the tiles are double buffered
+    auto epochs = valhalla::baldr::TrafficEpochs::Open(traffic_extract);
+    auto epoch = epochs ? epochs->Begin() : 0;
 
     mtar_t tar;
     tar.pos = 0;
@@ -543,13 +554,15 @@ void customize_live_traffic_data(const boost::property_tree::ptree& config,
 
       valhalla::baldr::GraphId tile_id(tile.header->tile_id);
 
+      auto* speeds = tile.begin_update(epoch);
       for (uint32_t index = 0; index < tile.header->directed_edge_count; index++) {
-        valhalla::baldr::TrafficSpeed* current =
-            const_cast<valhalla::baldr::TrafficSpeed*>(tile.speeds + index);
-        setter_cb(reader, tile, index, current);
+        setter_cb(reader, tile, index, speeds + index);
       }
       mtar_next(&tar);
     }
+    if (epochs) {
+      epochs->Publish(epoch);
+    }
   }
 }
 
@@ -67,16 +67,19 @@ make_clean_graphreader(const boost::property_tree::ptree& mjolnir_conf);
 // Creates an empty traffic file
 //
 // To actually customize the traffic data, use `customize_live_traffic_data`
+// Double buffered tiles have room for the speeds of the next update
 //
 /*************************************************************/
 void build_live_traffic_data(const boost::property_tree::ptree& config,
-                             uint32_t traffic_tile_version = valhalla::baldr::TRAFFIC_TILE_VERSION);
+                             uint32_t traffic_tile_version = valhalla::baldr::TRAFFIC_TILE_VERSION,
+                             bool double_buffered = false);
 
 /*************************************************************/
 // Helper function for customizing traffic data in unit-tests
 //
 // `setter_cb` is a callback that can modify traffic for each edge
-// when building traffic data
+// when building traffic data, double buffered tiles publish the
+// changes once all of a tile's edges have been visited
 /*************************************************************/
 using LiveTrafficCustomize = std::function<void(valhalla::baldr::GraphReader&,
                                                 valhalla::baldr::TrafficTile&,
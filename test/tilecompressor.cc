@@ -0,0 +1,88 @@
+#include "mjolnir/tilecompressor.h"
+
+#include <fstream>
+
+#include "baldr/compression_utils.h"
+#include "baldr/graphreader.h"
+#include "baldr/tilehierarchy.h"
+#include "filesystem.h"
+
+#include "test.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+TEST(TileCompressor, Compress) {
+  if (!zstd_supported()) {
+    return;
+  }
+
+  // work on a copy of the tiles
+  auto conf = test::make_config("test/data/utrecht_tiles");
+  auto source_dir = conf.get<std::string>("mjolnir.tile_dir");
+  auto tile_dir = std::string("test/data/compressed_tiles");
+  filesystem::remove_all(tile_dir);
+  GraphReader reader(conf.get_child("mjolnir"));
+  std::vector<GraphId> tile_ids;
+  for (const auto& level : TileHierarchy::levels()) {
+    for (const auto& tile_id : reader.GetTileSet(level.level)) {
+      auto suffix = GraphTile::FileSuffix(tile_id);
+      auto tile_path = tile_dir + filesystem::path::preferred_separator + suffix;
+      filesystem::create_directories(filesystem::path(tile_path).parent_path());
+      std::ifstream in(source_dir + filesystem::path::preferred_separator + suffix,
+                       std::ios::binary);
+      std::ofstream out(tile_path, std::ios::binary);
+      out << in.rdbuf();
+      tile_ids.push_back(tile_id);
+    }
+  }
+  ASSERT_FALSE(tile_ids.empty());
+
+  // do it twice, the second time around the tiles are decompressed and compressed again
+  TileCompressor::Options options;
+  options.level = 3;
+  options.compare_gzip = true;
+  for (int run = 0; run < 2; ++run) {
+    auto all_stats = TileCompressor::Compress(tile_dir, options);
+    size_t tiles = 0;
+    for (const auto& stats : all_stats) {
+      tiles += stats.tiles;
+      EXPECT_GT(stats.size, stats.zstd_size);
+      EXPECT_GT(stats.gzip_size, 0);
+    }
+    EXPECT_EQ(tiles, tile_ids.size());
+
+    // only the compressed tiles are left and they load as the originals did
+    for (const auto& tile_id : tile_ids) {
+      auto tile_path = tile_dir + filesystem::path::preferred_separator +
+                       GraphTile::FileSuffix(tile_id);
+      EXPECT_FALSE(filesystem::exists(tile_path));
+      EXPECT_TRUE(filesystem::exists(tile_path + ".zst"));
+      auto original = GraphTile::Create(source_dir, tile_id);
+      auto compressed = GraphTile::Create(tile_dir, tile_id);
+      ASSERT_TRUE(compressed);
+      ASSERT_EQ(compressed->header()->end_offset(), original->header()->end_offset());
+      EXPECT_EQ(compressed->header()->directededgecount(),
+                original->header()->directededgecount());
+      for (uint32_t i = 0; i < original->header()->directededgecount(); ++i) {
+        EXPECT_EQ(compressed->edgeinfo(compressed->directededge(i)).wayid(),
+                  original->edgeinfo(original->directededge(i)).wayid());
+      }
+    }
+  }
+
+  // and the graph reader finds them
+  conf.put("mjolnir.tile_dir", tile_dir);
+  GraphReader compressed_reader(conf.get_child("mjolnir"));
+  EXPECT_TRUE(compressed_reader.DoesTileExist(tile_ids.front()));
+  EXPECT_TRUE(compressed_reader.GetGraphTile(tile_ids.front()));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,146 @@
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "baldr/graphtile.h"
+#include "baldr/tileprefetcher.h"
+
+#include "test.h"
+
+using namespace valhalla::baldr;
+
+namespace {
+
+struct test_tile : public GraphTile {
+  test_tile(const GraphId& id) {
+    header_ = &fake_header;
+    fake_header.set_graphid(id);
+  }
+  GraphTileHeader fake_header;
+};
+
+// lets a test hold the loading threads and wait for them to get through the tiles
+struct loader_gate {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool open = true;
+  int loads = 0;
+
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    open = false;
+  }
+  void release() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      open = true;
+    }
+    cv.notify_all();
+  }
+  void wait_for_loads(int count) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this, count]() { return loads >= count; });
+  }
+};
+
+TilePrefetcher::loader_t make_loader(loader_gate& gate) {
+  return [&gate](const GraphId& id) -> graph_tile_ptr {
+    {
+      std::unique_lock<std::mutex> lock(gate.mutex);
+      gate.cv.wait(lock, [&gate]() { return gate.open; });
+      ++gate.loads;
+    }
+    gate.cv.notify_all();
+    // pretend tiles with an odd id dont exist
+    if (id.tileid() % 2) {
+      return nullptr;
+    }
+    return graph_tile_ptr{new test_tile(id)};
+  };
+}
+
+// the tiles show up in ready once the thread that loaded them has put them there, which happens
+// right after the load
+std::vector<GraphId> collect(TilePrefetcher& prefetcher, size_t count) {
+  std::vector<GraphId> collected;
+  while (collected.size() < count) {
+    prefetcher.Collect([&collected](const GraphId& id, graph_tile_ptr&& tile) {
+      EXPECT_EQ(tile->id(), id);
+      collected.push_back(id);
+    });
+    std::this_thread::yield();
+  }
+  return collected;
+}
+
+TEST(TilePrefetcher, TakeAfterPrefetch) {
+  loader_gate gate;
+  TilePrefetcher prefetcher(2, 16, make_loader(gate));
+
+  GraphId a(2, 2, 0), b(4, 2, 0), missing(3, 2, 0);
+  EXPECT_TRUE(prefetcher.Prefetch(a));
+  EXPECT_TRUE(prefetcher.Prefetch(b));
+  EXPECT_TRUE(prefetcher.Prefetch(missing));
+  // asking again does nothing
+  EXPECT_FALSE(prefetcher.Prefetch(a));
+
+  // the take either gets it straight away, waits for it or finds it still queued
+  auto tile = prefetcher.Take(a);
+  if (tile) {
+    EXPECT_EQ(tile->id(), a);
+  }
+  EXPECT_EQ(prefetcher.Take(missing), nullptr);
+
+  // something we never asked for is always a miss
+  EXPECT_EQ(prefetcher.Take(GraphId(6, 2, 0)), nullptr);
+
+  auto stats = prefetcher.stats();
+  EXPECT_EQ(stats.requested, 3);
+  EXPECT_GE(stats.misses, 2);
+}
+
+TEST(TilePrefetcher, Collect) {
+  loader_gate gate;
+  TilePrefetcher prefetcher(1, 16, make_loader(gate));
+
+  for (uint32_t i = 0; i < 8; i += 2) {
+    EXPECT_TRUE(prefetcher.Prefetch(GraphId(i, 1, 0)));
+  }
+  gate.wait_for_loads(4);
+  EXPECT_EQ(collect(prefetcher, 4).size(), 4);
+  EXPECT_EQ(prefetcher.stats().collected, 4);
+
+  // the cache may evict what was collected so it can be prefetched again
+  EXPECT_TRUE(prefetcher.Prefetch(GraphId(0, 1, 0)));
+  gate.wait_for_loads(5);
+  EXPECT_EQ(collect(prefetcher, 1).front(), GraphId(0, 1, 0));
+}
+
+TEST(TilePrefetcher, MaxPendingAndClear) {
+  loader_gate gate;
+  gate.close();
+  TilePrefetcher prefetcher(1, 2, make_loader(gate));
+
+  // the thread is stuck loading the first one or hasnt picked it up yet, either way both count
+  EXPECT_TRUE(prefetcher.Prefetch(GraphId(0, 0, 0)));
+  EXPECT_TRUE(prefetcher.Prefetch(GraphId(2, 0, 0)));
+  // over the limit
+  EXPECT_FALSE(prefetcher.Prefetch(GraphId(4, 0, 0)));
+
+  // after clearing we can ask for things again
+  prefetcher.Clear();
+  EXPECT_TRUE(prefetcher.Prefetch(GraphId(4, 0, 0)));
+
+  // nothing from before the clear shows up
+  gate.release();
+  auto collected = collect(prefetcher, 1);
+  ASSERT_EQ(collected.size(), 1);
+  EXPECT_EQ(collected.front(), GraphId(4, 0, 0));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
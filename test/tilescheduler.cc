@@ -0,0 +1,90 @@
+#include "mjolnir/tilescheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "test.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+std::vector<std::pair<GraphId, uint64_t>> make_tiles(size_t count) {
+  std::vector<std::pair<GraphId, uint64_t>> tiles;
+  for (size_t i = 0; i < count; ++i) {
+    tiles.emplace_back(GraphId(i, 2, 0), (i * 7919) % 1000);
+  }
+  return tiles;
+}
+
+TEST(TileScheduler, BiggestFirst) {
+  auto tiles = make_tiles(100);
+  TileScheduler scheduler("test", tiles, 1);
+  EXPECT_EQ(scheduler.size(), 100);
+  EXPECT_EQ(scheduler.workers(), 1);
+
+  // a single worker gets all of them from the biggest down
+  std::vector<uint64_t> costs;
+  GraphId tile_id;
+  while (scheduler.Next(0, tile_id)) {
+    costs.push_back(tiles[tile_id.tileid()].second);
+  }
+  ASSERT_EQ(costs.size(), tiles.size());
+  EXPECT_TRUE(std::is_sorted(costs.rbegin(), costs.rend()));
+  EXPECT_FALSE(scheduler.Next(0, tile_id));
+}
+
+TEST(TileScheduler, EveryTileOnce) {
+  auto tiles = make_tiles(1000);
+  TileScheduler scheduler("test", tiles, 4);
+
+  std::vector<std::atomic<int>> handed_out(tiles.size());
+  std::vector<std::thread> threads;
+  for (unsigned int worker = 0; worker < scheduler.workers(); ++worker) {
+    threads.emplace_back([&scheduler, &handed_out, worker]() {
+      GraphId tile_id;
+      while (scheduler.Next(worker, tile_id)) {
+        ++handed_out[tile_id.tileid()];
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& count : handed_out) {
+    EXPECT_EQ(count, 1);
+  }
+  scheduler.LogStats();
+}
+
+TEST(TileScheduler, Steal) {
+  // the first worker is stuck on its first tile while the second does everything else
+  auto tiles = make_tiles(10);
+  TileScheduler scheduler("test", tiles, 2);
+  GraphId tile_id;
+  ASSERT_TRUE(scheduler.Next(0, tile_id));
+  size_t count = 0;
+  while (scheduler.Next(1, tile_id)) {
+    ++count;
+  }
+  EXPECT_EQ(count, tiles.size() - 1);
+  EXPECT_FALSE(scheduler.Next(0, tile_id));
+}
+
+TEST(TileScheduler, NoTiles) {
+  TileScheduler scheduler("test", {}, 0);
+  EXPECT_EQ(scheduler.workers(), 1);
+  GraphId tile_id;
+  EXPECT_FALSE(scheduler.Next(0, tile_id));
+  scheduler.LogStats();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
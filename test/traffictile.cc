@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstdio>
+#include <string>
+
 #include "baldr/traffictile.h"
 
 namespace {
@@ -38,7 +42,7 @@ TEST(Traffic, TileConstruction) {
       std::make_unique<UnmanagedGraphMemory>(reinterpret_cast<char*>(&testdata), sizeof(TestTile));
   TrafficTile tile(std::move(memory));
 
-  auto const volatile& speed = tile.trafficspeed(2);
+  auto speed = tile.trafficspeed(2);
   EXPECT_TRUE(speed.speed_valid());
   EXPECT_FALSE(speed.closed());
   EXPECT_EQ(speed.get_overall_speed(), 98);
@@ -49,7 +53,7 @@ TEST(Traffic, TileConstruction) {
   EXPECT_EQ(3, TRAFFIC_TILE_VERSION);
   // Test with an invalid version
   testdata.header.traffic_tile_version = 78;
-  auto const volatile& invalid_speed = tile.trafficspeed(2);
+  auto invalid_speed = tile.trafficspeed(2);
   EXPECT_FALSE(invalid_speed.speed_valid());
 }
 
@@ -57,7 +61,7 @@ TEST(Traffic, NullTileConstruction) {
   using namespace valhalla::baldr;
   TrafficTile tile(nullptr); // Should not segfault
 
-  auto volatile& speed = tile.trafficspeed(99);
+  auto speed = tile.trafficspeed(99);
   EXPECT_FALSE(speed.speed_valid());
   EXPECT_FALSE(speed.closed());
 }
@@ -116,6 +120,112 @@ TEST(Traffic, SpeedValid) {
   EXPECT_EQ(speed.encoded_speed1, 0);
 }
 
+TEST(Traffic, DoubleBuffered) {
+  using namespace valhalla::baldr;
+
+#pragma pack(push, 1)
+  struct TestTile {
+    TrafficTileHeader header;
+    TrafficSpeed speeds[2][2];
+  };
+#pragma pack(pop)
+
+  TestTile testdata{};
+  testdata.header.directed_edge_count = 2;
+  testdata.header.traffic_tile_version = TRAFFIC_TILE_VERSION;
+  testdata.speeds[0][1].overall_encoded_speed = 50 >> 1;
+  testdata.speeds[0][1].breakpoint1 = 255;
+
+  std::string traffic_extract = "test/data/double_buffered_traffic.tar";
+  std::remove((traffic_extract + ".epochs").c_str());
+  EXPECT_EQ(TrafficEpochs::Open(traffic_extract), nullptr);
+  auto epochs = std::make_shared<TrafficEpochs>(traffic_extract, true);
+  EXPECT_EQ(epochs->published(), 1);
+  TrafficEpochs::Set(epochs);
+
+  auto memory =
+      std::make_unique<UnmanagedGraphMemory>(reinterpret_cast<char*>(&testdata), sizeof(TestTile));
+  TrafficTile tile(std::move(memory));
+  ASSERT_TRUE(tile.double_buffered());
+
+  // never published so its the first set of speeds
+  EXPECT_EQ(tile.trafficspeed(1).get_overall_speed(), 50);
+
+  // updates start from the current speeds and arent seen until they are published
+  auto epoch = epochs->Begin();
+  EXPECT_EQ(epoch, 2);
+  auto* update = tile.begin_update(epoch);
+  EXPECT_EQ(update, &testdata.speeds[1][0]);
+  EXPECT_EQ(tile.begin_update(epoch), update);
+  EXPECT_EQ(update[1].get_overall_speed(), 50);
+  update[1].overall_encoded_speed = 80 >> 1;
+  EXPECT_EQ(tile.trafficspeed(1).get_overall_speed(), 50);
+  epochs->Publish(epoch);
+  EXPECT_EQ(testdata.header.epochs[1], 2);
+  EXPECT_EQ(tile.trafficspeed(1).get_overall_speed(), 80);
+
+  {
+    // a snapshot keeps seeing what was published when it was taken
+    TrafficSnapshot snapshot;
+    EXPECT_EQ(TrafficSnapshot::pinned(), 2);
+    epoch = epochs->Begin();
+    update = tile.begin_update(epoch);
+    EXPECT_EQ(update, &testdata.speeds[0][0]);
+    EXPECT_EQ(update[1].get_overall_speed(), 80);
+    update[1].overall_encoded_speed = 100 >> 1;
+    epochs->Publish(epoch);
+    EXPECT_EQ(tile.trafficspeed(1).get_overall_speed(), 80);
+    {
+      TrafficSnapshot later;
+      EXPECT_EQ(TrafficSnapshot::pinned(), 3);
+      EXPECT_EQ(tile.trafficspeed(1).get_overall_speed(), 100);
+    }
+
+    // the next update overwrites what the snapshot reads so it waits for it to let go
+    auto start = std::chrono::steady_clock::now();
+    epoch = epochs->Begin(std::chrono::milliseconds(50));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+
+    // and once it started the older epoch cant be pinned anymore
+    TrafficSnapshot late(2);
+    EXPECT_EQ(TrafficSnapshot::pinned(), 3);
+  }
+  EXPECT_EQ(TrafficSnapshot::pinned(), 0);
+
+  // without a snapshot its the newest published speeds, not the update being written
+  update = tile.begin_update(epoch);
+  EXPECT_EQ(update, &testdata.speeds[1][0]);
+  update[1].overall_encoded_speed = 30 >> 1;
+  EXPECT_EQ(tile.trafficspeed(1).get_overall_speed(), 100);
+  epochs->Publish(epoch);
+  EXPECT_EQ(tile.trafficspeed(1).get_overall_speed(), 30);
+
+  // an update that was never published is started over from the published speeds
+  epoch = epochs->Begin();
+  TrafficTile crashed(
+      std::make_unique<UnmanagedGraphMemory>(reinterpret_cast<char*>(&testdata), sizeof(TestTile)));
+  crashed.begin_update(epoch)[1].overall_encoded_speed = 60 >> 1;
+  EXPECT_EQ(epochs->Begin(), epoch);
+  TrafficTile restarted(
+      std::make_unique<UnmanagedGraphMemory>(reinterpret_cast<char*>(&testdata), sizeof(TestTile)));
+  EXPECT_EQ(restarted.begin_update(epoch)[1].get_overall_speed(), 30);
+  EXPECT_EQ(tile.trafficspeed(1).get_overall_speed(), 30);
+
+  // without epochs updates go straight into the newest speeds
+  TrafficEpochs::Set(nullptr);
+  EXPECT_EQ(tile.begin_update(), &testdata.speeds[0][0]);
+
+  // tiles without the room for a second set of speeds are updated in place
+  auto small = std::make_unique<UnmanagedGraphMemory>(reinterpret_cast<char*>(&testdata),
+                                                      sizeof(TrafficTileHeader) +
+                                                          2 * sizeof(TrafficSpeed));
+  testdata.header.epochs[0] = testdata.header.epochs[1] = 0;
+  TrafficTile single(std::move(small));
+  EXPECT_FALSE(single.double_buffered());
+  EXPECT_EQ(single.begin_update(7), &testdata.speeds[0][0]);
+  EXPECT_EQ(testdata.header.epochs[0], 0);
+}
+
 int main(int argc, char* argv[]) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
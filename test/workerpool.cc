@@ -0,0 +1,92 @@
+#include "midgard/workerpool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include "test.h"
+
+using namespace valhalla::midgard;
+
+namespace {
+
+TEST(WorkerPool, EveryIndexOnce) {
+  WorkerPool pool(3);
+  EXPECT_EQ(pool.size(), 3);
+  std::vector<std::atomic<int>> counts(1000);
+  pool.ParallelFor(counts.size(), [&counts](size_t i) { ++counts[i]; });
+  for (const auto& count : counts) {
+    EXPECT_EQ(count, 1);
+  }
+  // nothing to do is fine too
+  pool.ParallelFor(0, [](size_t) { FAIL(); });
+}
+
+TEST(WorkerPool, NoThreads) {
+  // the caller does everything
+  WorkerPool pool(0);
+  auto caller = std::this_thread::get_id();
+  size_t count = 0;
+  pool.ParallelFor(10, [&](size_t) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+    ++count;
+  });
+  EXPECT_EQ(count, 10);
+}
+
+TEST(WorkerPool, LowestError) {
+  WorkerPool pool(2);
+  std::atomic<int> ran{0};
+  try {
+    pool.ParallelFor(100, [&ran](size_t i) {
+      ++ran;
+      if (i == 7 || i == 42) {
+        throw std::runtime_error(std::to_string(i));
+      }
+    });
+    FAIL() << "Expected an exception";
+  } catch (const std::runtime_error& e) { EXPECT_STREQ(e.what(), "7"); }
+  // everything else still ran
+  EXPECT_EQ(ran, 100);
+}
+
+TEST(WorkerPool, ConcurrentCallers) {
+  // more callers than threads, every caller still gets all of its work done
+  WorkerPool pool(2);
+  std::vector<std::thread> callers;
+  std::vector<std::atomic<size_t>> sums(8);
+  for (size_t c = 0; c < sums.size(); ++c) {
+    callers.emplace_back([&pool, &sums, c]() {
+      for (int round = 0; round < 50; ++round) {
+        pool.ParallelFor(20, [&sums, c](size_t i) { sums[c] += i; });
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  for (const auto& sum : sums) {
+    EXPECT_EQ(sum, 50 * 190);
+  }
+}
+
+TEST(WorkerPool, Shared) {
+  SharedWorkerPool shared;
+  auto pool = shared.Get(4);
+  EXPECT_EQ(pool->size(), 3);
+  EXPECT_EQ(shared.Get(4), pool);
+  // a different size replaces it but the old one stays usable
+  auto other = shared.Get(2);
+  EXPECT_NE(other, pool);
+  EXPECT_EQ(other->size(), 1);
+  size_t count = 0;
+  pool->ParallelFor(1, [&count](size_t) { ++count; });
+  EXPECT_EQ(count, 1);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
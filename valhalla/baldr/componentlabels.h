@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <valhalla/baldr/graphconstants.h>
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/midgard/sequence.h>
+
+namespace valhalla {
+namespace baldr {
+
+/**
+ * Per mode strongly connected component labels of every node in the graph, read from a sidecar
+ * file written by mjolnir after the tiles are built (see mjolnir::ComponentBuilder).
+ *
+ * The labels are the order in which Tarjan's algorithm finished the components, which means that
+ * a component can only ever reach components with a smaller label than its own. On top of that the
+ * graph is labelled one weakly connected component (island) at a time so each island gets its own
+ * contiguous range of labels. Together this gives a cheap test that can prove a node cannot reach
+ * another one, it never claims a path is impossible when one exists.
+ */
+class ComponentLabels {
+public:
+  // the modes we have labels for, these line up with the access masks below. an edge is part of the
+  // graph of a mode if it allows any of the access in the mask, auto includes hov so that the labels
+  // still cover what auto costing can get to when hov lanes are allowed
+  enum Mode : uint8_t { kAuto = 0, kTruck = 1, kBicycle = 2, kPedestrian = 3, kModeCount = 4 };
+  static constexpr uint16_t kModeAccess[kModeCount] = {kAutoAccess | kHOVAccess, kTruckAccess,
+                                                       kBicycleAccess, kPedestrianAccess};
+
+  // what you get back when we dont know anything about a node
+  static constexpr uint32_t kUnknownLabel = std::numeric_limits<uint32_t>::max();
+
+  // the name of the sidecar within the tile directory
+  static constexpr const char* kFileName = "components.bin";
+
+  // the layout of the file is the header, the tiles sorted by id, the labels of each mode in
+  // turn and then the first label of each island of each mode in turn
+  static constexpr uint64_t kMagic = 0x56414c4853434331; // VALHSCC1
+  static constexpr uint32_t kVersion = 2;
+  struct header_t {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t mode_count;
+    uint64_t tile_count;
+    uint64_t node_count;
+    uint64_t island_count[kModeCount];
+  };
+  struct tile_t {
+    uint64_t tile_id;
+    // where the labels of the first node in the tile are
+    uint64_t node_offset;
+  };
+
+  /**
+   * Maps the sidecar, throws if it cant be read or doesnt look like a label file
+   * @param file_name  the sidecar to load
+   */
+  explicit ComponentLabels(const std::string& file_name);
+
+  /**
+   * Gets the mode whose labels can be used for the given access mask, which are the labels of the
+   * first mode whose graph has every edge that the access mask allows
+   * @param access_mask  the access mask of the costing
+   * @param mode         set to the mode if there is one
+   * @return true if there are labels covering the access mask
+   */
+  static bool mode_for_access(uint32_t access_mask, Mode& mode);
+
+  /**
+   * @param tile_id  the tile
+   * @return how many nodes the tile had when it was labelled, 0 if it wasnt
+   */
+  uint32_t node_count(const GraphId& tile_id) const;
+
+  /**
+   * @param node  the node
+   * @param mode  the mode of travel
+   * @return the label of the nodes component or kUnknownLabel if the node wasnt labelled
+   */
+  uint32_t label(const GraphId& node, Mode mode) const;
+
+  /**
+   * @param label  a component label
+   * @param mode   the mode of travel
+   * @return the island the labelled component belongs to
+   */
+  uint32_t island(uint32_t label, Mode mode) const;
+
+  /**
+   * Checks whether one node might be able to reach another. Unknown nodes might reach anything.
+   * @param from  the node we start at
+   * @param to    the node we want to get to
+   * @param mode  the mode of travel
+   * @return false only if there is no way at all to get from one node to the other
+   */
+  bool MayReach(const GraphId& from, const GraphId& to, Mode mode) const;
+
+protected:
+  size_t tile_index(const GraphId& tile_id) const;
+
+  midgard::mem_map<char> memory_;
+  const header_t* header_;
+  const tile_t* tiles_;
+  const uint32_t* labels_;
+  const uint32_t* islands_[kModeCount];
+};
+
+} // namespace baldr
+} // namespace valhalla
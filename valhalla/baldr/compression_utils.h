@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <vector>
 #include <zlib.h>
 
 namespace valhalla {
@@ -26,5 +29,79 @@ bool deflate(const std::function<int(z_stream&)>& src_func,
 bool inflate(const std::function<void(z_stream&)>& src_func,
              const std::function<int(z_stream&)>& dst_func);
 
+/* Whether or not valhalla was built with zstd, without it none of the below will do anything
+ * but fail
+ */
+bool zstd_supported();
+
+class ZstdDictionary;
+
+/* Compresses data into a single zstd frame
+ * @param src         the data to compress
+ * @param size        how much of it there is
+ * @param dst         where to put the compressed data, its replaced
+ * @param level       what compression level to use, ignored if there is a dictionary
+ * @param dictionary  the dictionary to compress with if any
+ * @return            returns true if the data was compressed, false otherwise
+ */
+bool zstd_compress(const char* src,
+                   size_t size,
+                   std::vector<char>& dst,
+                   int level = 19,
+                   const ZstdDictionary* dictionary = nullptr);
+
+/* Decompresses a zstd frame. Decompression contexts are pooled per thread so that decompressing
+ * lots of small frames doesnt allocate for each one
+ * @param src         the compressed data
+ * @param size        how much of it there is
+ * @param dst         where to put the decompressed data, its replaced
+ * @param dictionary  the dictionary the data was compressed with if any
+ * @return            returns true if the data was decompressed, false otherwise
+ */
+bool zstd_decompress(const char* src,
+                     size_t size,
+                     std::vector<char>& dst,
+                     const ZstdDictionary* dictionary = nullptr);
+
+/* A trained zstd dictionary. Tiles of the same level share most of their structure so compressing
+ * each with a dictionary trained on its level does much better than compressing it on its own
+ */
+class ZstdDictionary {
+public:
+  /* Prepares a dictionary for use, throws if it isnt one
+   * @param dictionary  the dictionary bytes as trained
+   * @param level       what compression level to use, 0 when only decompressing
+   */
+  explicit ZstdDictionary(const std::vector<char>& dictionary, int level = 0);
+  ~ZstdDictionary();
+
+  /* Trains a dictionary on some samples
+   * @param samples   the samples one after the other
+   * @param sizes     how big each sample is
+   * @param capacity  the largest the dictionary can be
+   * @return          the dictionary, throws if there is too little to train on
+   */
+  static std::vector<char>
+  Train(const std::vector<char>& samples, const std::vector<size_t>& sizes, size_t capacity);
+
+  /* @return  the id compressed data refers to the dictionary by
+   */
+  uint32_t id() const;
+
+  /* @return  the compression level the dictionary was prepared for
+   */
+  int level() const;
+
+protected:
+  friend bool zstd_compress(const char*, size_t, std::vector<char>&, int, const ZstdDictionary*);
+  friend bool zstd_decompress(const char*, size_t, std::vector<char>&, const ZstdDictionary*);
+  struct pimpl_t;
+  std::unique_ptr<pimpl_t> pimpl;
+};
+
+/* @return  the id of the dictionary a zstd frame was compressed with or 0 if it wasnt
+ */
+uint32_t zstd_dictionary_id(const char* src, size_t size);
+
 } // namespace baldr
 } // namespace valhalla
\ No newline at end of file
@@ -29,6 +29,7 @@ namespace DateTime {
 struct tz_db_t {
   tz_db_t();
   size_t to_index(const std::string& zone) const;
+  size_t to_index(const date::time_zone* zone) const;
   const date::time_zone* from_index(size_t index) const;
 
 protected:
@@ -42,6 +43,68 @@ protected:
  */
 const tz_db_t& get_tz_db();
 
+/**
+ * The UTC offset of every zone in the tz db over the years we route in, computed once per process
+ * from the transitions of each zone. Looking up an offset is a binary search over the transitions
+ * of the zone so unlike going through date::time_zone it needs no cache and no locking. Moments
+ * outside of the years in the table are still answered, just slowly, by the tz db itself.
+ */
+struct tz_transitions_t {
+  // the table covers [1970, 2100)
+  static constexpr int64_t kBegin = 0;
+  static constexpr int64_t kEnd = 4102444800;
+
+  explicit tz_transitions_t(const tz_db_t& tz_db);
+
+  /**
+   * @param zone     the index of the zone as it is in the tz db (see tz_db_t::to_index)
+   * @param seconds  seconds since epoch
+   * @return the offset from UTC in seconds at that moment or 0 for no zone or one we dont know
+   */
+  int32_t offset(size_t zone, uint64_t seconds) const;
+
+  /**
+   * Same as above for a zone that might not be from our tz db, those are asked directly
+   * @param zone     the zone
+   * @param seconds  seconds since epoch
+   * @return the offset from UTC in seconds at that moment or 0 for no zone
+   */
+  int32_t offset(const date::time_zone* zone, uint64_t seconds) const;
+
+  /**
+   * Finds the offsets of many moments at once, eg. the time at every node of a trip leg. Moments
+   * in the same zone as the one before them reuse its transition when they are still within it so
+   * a leg going forward in time costs about one search for every zone it goes through.
+   * @param seconds  seconds since epoch of each moment
+   * @param zones    the index of the zone of each moment
+   * @param count    the number of moments
+   * @param offsets  set to the offset from UTC in seconds of each moment
+   */
+  void offsets(const uint64_t* seconds,
+               const uint32_t* zones,
+               size_t count,
+               int32_t* offsets) const;
+
+protected:
+  // when each offset starts, the first one starts at kBegin and the last one lasts until kEnd
+  struct zone_t {
+    std::vector<int64_t> begins;
+    std::vector<int32_t> offsets;
+  };
+
+  // index of the transition in effect at the moment, only valid within the table
+  static size_t find(const zone_t& zone, int64_t seconds);
+
+  const tz_db_t& tz_db;
+  std::vector<zone_t> zones;
+};
+
+/**
+ * Get the timezone transitions singleton
+ * @return  timezone transitions of all the zones in the tz db
+ */
+const tz_transitions_t& get_tz_transitions();
+
 /**
  * Get a formatted date from a string.
  * @param date       in the format of 2015-05-06T08:00
@@ -88,7 +151,8 @@ uint64_t seconds_since_epoch(const std::string& date_time, const date::time_zone
  * @param   seconds       seconds since epoch
  * @param   origin_tz     timezone for origin
  * @param   dest_tz       timezone for dest
- * @param   cache         a cache for timezone sys_info lookup (since its expensive)
+ * @param   cache         a cache for timezone sys_info lookup, only used for moments outside of the
+ *                        years covered by get_tz_transitions
  * @return Returns the seconds difference between the 2 timezones.
  */
 using tz_sys_info_cache_t = std::unordered_map<const date::time_zone*, std::vector<date::sys_info>>;
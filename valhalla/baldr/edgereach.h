@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <valhalla/baldr/componentlabels.h>
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/midgard/sequence.h>
+
+namespace valhalla {
+namespace baldr {
+
+/**
+ * The inbound and outbound reach of every directed edge in the graph for the default costing of
+ * each of the modes in ComponentLabels, read from a sidecar file written by mjolnir after the
+ * tiles are built (see mjolnir::ReachBuilder). Loki uses these instead of expanding around every
+ * candidate edge of every location when the request uses a default costing.
+ *
+ * The reach is the same number of nodes loki::Reach would find, capped at the max_reach the file
+ * was built with which is at most 255 so that each direction fits in a byte.
+ */
+class EdgeReach {
+public:
+  using Mode = ComponentLabels::Mode;
+
+  // the name of the sidecar within the tile directory
+  static constexpr const char* kFileName = "reach.bin";
+
+  // the layout of the file is the header, the tiles sorted by id and then the reach of all the
+  // edges of each mode in turn
+  static constexpr uint64_t kMagic = 0x56414c4852434831; // VALHRCH1
+  static constexpr uint32_t kVersion = 1;
+  struct header_t {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t mode_count;
+    uint32_t max_reach;
+    uint32_t reserved;
+    uint64_t tile_count;
+    uint64_t edge_count;
+  };
+  struct tile_t {
+    uint64_t tile_id;
+    // where the reach of the first edge in the tile is
+    uint64_t edge_offset;
+  };
+  struct reach_t {
+    uint8_t outbound;
+    uint8_t inbound;
+  };
+
+  /**
+   * Maps the sidecar, throws if it cant be read or doesnt look like a reach file
+   * @param file_name  the sidecar to load
+   */
+  explicit EdgeReach(const std::string& file_name);
+
+  /**
+   * @return the largest reach that was looked for when building the file
+   */
+  uint32_t max_reach() const {
+    return header_->max_reach;
+  }
+
+  /**
+   * @param tile_id  the tile
+   * @return how many edges the tile had when the reach was computed, 0 if it wasnt
+   */
+  uint32_t edge_count(const GraphId& tile_id) const;
+
+  /**
+   * Gets the reach of an edge
+   * @param edge_id   the edge
+   * @param mode      the mode of travel
+   * @param outbound  set to the outbound reach
+   * @param inbound   set to the inbound reach
+   * @return false if we dont know the reach of the edge
+   */
+  bool Get(const GraphId& edge_id, Mode mode, uint32_t& outbound, uint32_t& inbound) const;
+
+protected:
+  size_t tile_index(const GraphId& tile_id) const;
+
+  midgard::mem_map<char> memory_;
+  const header_t* header_;
+  const tile_t* tiles_;
+  const reach_t* reach_;
+};
+
+} // namespace baldr
+} // namespace valhalla
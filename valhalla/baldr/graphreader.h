@@ -2,18 +2,22 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <boost/property_tree/ptree.hpp>
 
 #include <valhalla/baldr/curler.h>
 #include <valhalla/baldr/graphid.h>
 #include <valhalla/baldr/graphtile.h>
+#include <valhalla/baldr/sharedtilesegment.h>
 #include <valhalla/baldr/tilegetter.h>
 #include <valhalla/baldr/tilehierarchy.h>
+#include <valhalla/baldr/tileprefetcher.h>
 
 #include <valhalla/midgard/aabb2.h>
 #include <valhalla/midgard/pointll.h>
@@ -414,6 +418,87 @@ private:
   std::mutex& mutex_ref_;
 };
 
+/**
+ * Tile cache that shares tiles with other processes on the same host through a SharedTileSegment.
+ * Tiles put into the cache are copied into shared memory and replaced by a tile pointing at the
+ * shared copy so that the private one can be freed. Tiles published by other processes are picked
+ * up from shared memory instead of being read from disk. Only the light weight GraphTile objects
+ * are kept in process memory. Once the segment is full tiles are kept privately like in the
+ * SimpleTileCache.
+ * It is NOT thread-safe!
+ */
+class SharedTileCache : public TileCache {
+public:
+  // Loads the traffic for a tile, tiles picked up from shared memory need to get it from somewhere
+  using memory_loader_t = std::function<std::unique_ptr<const GraphMemory>(const GraphId&)>;
+
+  /**
+   * Constructor.
+   * @param segment         the shared memory to publish tiles to and look them up in
+   * @param max_size        maximum size of the tiles kept in process memory
+   * @param traffic_loader  loads the traffic for a tile, may be empty if there is no traffic
+   */
+  SharedTileCache(std::shared_ptr<SharedTileSegment> segment,
+                  size_t max_size,
+                  memory_loader_t traffic_loader = nullptr);
+
+  /**
+   * Reserves enough cache to hold (max_cache_size / tile_size) items.
+   * @param tile_size appeoximate size of one tile
+   */
+  void Reserve(size_t tile_size) override;
+
+  /**
+   * Checks if tile exists in the cache or in shared memory.
+   * @param graphid  the graphid of the tile
+   * @return true if tile exists in the cache
+   */
+  bool Contains(const GraphId& graphid) const override;
+
+  /**
+   * Publishes the tile to shared memory and puts the shared version into the cache. If the tile
+   * cannot be published a copy of the tile is put into the cache instead.
+   * @param graphid  the graphid of the tile
+   * @param tile the graph tile
+   * @param size size of the tile in memory
+   */
+  graph_tile_ptr Put(const GraphId& graphid, graph_tile_ptr tile, size_t size) override;
+
+  /**
+   * Get a pointer to a graph tile object given a GraphId. Tiles in shared memory which have not
+   * been used by this cache yet are added to it.
+   * @param graphid  the graphid of the tile
+   * @return GraphTile* a pointer to the graph tile
+   */
+  graph_tile_ptr Get(const GraphId& graphid) const override;
+
+  /**
+   * Lets you know if the cache is too large.
+   * @return true if the cache is over committed with respect to the limit
+   */
+  bool OverCommitted() const override;
+
+  /**
+   * Clears the cache. The tiles in shared memory are not affected.
+   */
+  void Clear() override;
+
+  /**
+   *  Does its best to reduce the cache size to remove overcommitted state.
+   *  Some implementations may simply clear the entire cache
+   */
+  void Trim() override;
+
+protected:
+  graph_tile_ptr Wrap(const GraphId& graphid, const std::pair<char*, size_t>& bytes) const;
+
+  std::shared_ptr<SharedTileSegment> segment_;
+  memory_loader_t traffic_loader_;
+  mutable size_t cache_size_;
+  size_t max_cache_size_;
+  mutable std::unordered_map<GraphId, graph_tile_ptr> cache_;
+};
+
 /**
  * Creates tile caches.
  */
@@ -424,8 +509,12 @@ public:
   /**
    * Constructs tile cache.
    * @param pt  Property tree listing the configuration for the cahce configuration
+   * @param shared_segment  if set tiles are shared with other processes through this segment
+   * @param traffic_loader  loads the traffic for tiles picked up from the shared segment
    */
-  static TileCache* createTileCache(const boost::property_tree::ptree& pt);
+  static TileCache* createTileCache(const boost::property_tree::ptree& pt,
+                                    std::shared_ptr<SharedTileSegment> shared_segment = nullptr,
+                                    SharedTileCache::memory_loader_t traffic_loader = nullptr);
 };
 
 /**
@@ -504,10 +593,118 @@ public:
     return GetGraphTile(pointll, TileHierarchy::levels().back().level);
   }
 
+  /**
+   * Loads the given tiles into the cache using multiple threads to read and inflate them. This is
+   * useful to warm up the cache before accepting traffic. Loading stops early if the cache fills up.
+   * Note that unless the cache is the global synchronized one, only this reader benefits from the
+   * warm cache (though the OS page cache will also be warm for the tiles)
+   * @param tile_ids     the tiles to load, tiles already in the cache are skipped
+   * @param concurrency  how many threads to load the tiles with
+   * @return the number of tiles that were loaded
+   */
+  size_t Preload(const std::vector<GraphId>& tile_ids, size_t concurrency);
+
+  /**
+   * Loads all tiles, on all levels, which intersect the bounding box into the cache
+   * @param bbox         the region to load
+   * @param concurrency  how many threads to load the tiles with
+   * @return the number of tiles that were loaded
+   */
+  size_t Preload(const midgard::AABB2<midgard::PointLL>& bbox, size_t concurrency);
+
+  /**
+   * Loads all the tiles of a given hierarchy level into the cache
+   * @param level        the hierarchy level to load
+   * @param concurrency  how many threads to load the tiles with
+   * @return the number of tiles that were loaded
+   */
+  size_t Preload(const uint8_t level, size_t concurrency);
+
+  /**
+   * Identifies the tiles this reader reads so that things kept around between processes or requests
+   * (shared tile segments, cached results) can tell when the tiles were rebuilt. It is a hash of the
+   * headers of the level 0 tiles, which change with every build, so only a handful of tiles have to
+   * be read. Computed on first use
+   * @return the id of the tileset
+   */
+  uint64_t GetTilesetId() const;
+
+  /**
+   * Finds one of the files mjolnir writes next to the tiles (eg the component labels). These are
+   * looked for in the tile_dir and, when the tiles are read from an extract, next to the extract
+   * @param pt         the mjolnir config
+   * @param file_name  the name of the file
+   * @return the path of the file or an empty string if it is in neither place
+   */
+  static std::string FindSidecar(const boost::property_tree::ptree& pt,
+                                 const std::string& file_name);
+
+  /**
+   * @return the shared memory segment tiles are shared with other processes through or nullptr if
+   *         tiles arent shared
+   */
+  std::shared_ptr<const SharedTileSegment> GetSharedTileSegment() const {
+    return shared_segment_;
+  }
+
+  /**
+   * @return the shared memory segment the recovered shortcuts are shared with other processes
+   *         through or nullptr if they arent shared
+   */
+  std::shared_ptr<const SharedTileSegment> GetSharedShortcutSegment() const {
+    return shared_shortcut_segment_;
+  }
+
+  /**
+   * Asks for the tile containing the given graph id to be loaded in the background. This is a no-op
+   * unless tile prefetching is enabled (only possible when reading tiles from the tile_dir)
+   * @param graphid  any graph id within the tile
+   */
+  void Prefetch(const GraphId& graphid) {
+    if (prefetcher_) {
+      PrefetchTile(graphid.Tile_Base());
+    }
+  }
+
+  /**
+   * When a search reaches a node that is close to the border of its tile, the tile(s) on the other
+   * side of the border are likely to be needed soon. This asks for those to be loaded in the
+   * background. This is a no-op unless tile prefetching is enabled
+   * @param node  the graph id of the node the search reached
+   * @param ll    the location of the node
+   */
+  void PrefetchNeighbors(const GraphId& node, const midgard::PointLL& ll) {
+    if (prefetcher_) {
+      PrefetchNeighborTiles(node, ll);
+    }
+  }
+
+  /**
+   * Same as above but only looks up the location of the node if prefetching is enabled
+   * @param node  the graph id of the node the search reached
+   * @param tile  the tile the node is in
+   */
+  void PrefetchNeighbors(const GraphId& node, const graph_tile_ptr& tile) {
+    if (prefetcher_ && tile) {
+      PrefetchNeighborTiles(node, tile->get_node_ll(node));
+    }
+  }
+
+  /**
+   * Returns the counters of the tile prefetcher, all zeros if prefetching is disabled
+   * @return the prefetch counters
+   */
+  TilePrefetcher::stats_t GetPrefetchStats() const {
+    return prefetcher_ ? prefetcher_->stats() : TilePrefetcher::stats_t{};
+  }
+
   /**
    * Clears the cache
    */
   virtual void Clear() {
+    if (prefetcher_) {
+      prefetcher_->Clear();
+    }
     cache_->Clear();
   }
 
@@ -516,6 +713,9 @@ public:
    * In some cases may even remove the entire cache.
    */
   virtual void Trim() {
+    if (prefetcher_) {
+      prefetcher_->Clear();
+    }
     cache_->Trim();
   }
 
@@ -955,6 +1155,9 @@ protected:
   // Information about where the tiles are kept
   const std::string tile_dir_;
 
+  // Identifies the tiles, 0 until it is first needed
+  mutable std::atomic<uint64_t> tileset_id_;
+
   // Stuff for getting at remote tiles
   std::unique_ptr<tile_getter_t> tile_getter_;
   const size_t max_concurrent_users_;
@@ -963,9 +1166,47 @@ protected:
   std::mutex _404s_lock;
   std::unordered_set<GraphId> _404s;
 
+  // Shares tiles with other processes if configured
+  std::shared_ptr<SharedTileSegment> shared_segment_;
+
+  // Shares the recovered shortcuts with other processes if configured
+  std::shared_ptr<SharedTileSegment> shared_shortcut_segment_;
+
   std::unique_ptr<TileCache> cache_;
 
   bool enable_incidents_;
+
+  /**
+   * Loads a tile from the extract, the tile_dir or the tile_url without touching the cache. This is
+   * safe to call from multiple threads at once
+   * @param base  the base graph id of the tile
+   * @return the tile or nullptr if it couldnt be found
+   */
+  graph_tile_ptr LoadTile(const GraphId& base);
+
+  /**
+   * @param tile  a tile loaded by this reader
+   * @return the number of bytes the tile is accounted for in the cache
+   */
+  size_t CacheSize(const graph_tile_ptr& tile) const;
+
+  /**
+   * Moves any finished prefetches into the cache and queues the given tile if its not cached
+   * @param base  the base graph id of the tile to prefetch
+   */
+  void PrefetchTile(const GraphId& base);
+
+  /**
+   * Prefetches the tiles within the prefetch margin of the given node
+   * @param node  the node the search reached
+   * @param ll    the location of the node
+   */
+  void PrefetchNeighborTiles(const GraphId& node, const midgard::PointLL& ll);
+
+  // Loads tiles in the background if enabled
+  std::unique_ptr<TilePrefetcher> prefetcher_;
+  // How close to a tile border (as a fraction of the tile size) a node has to be to prefetch across
+  float prefetch_margin_;
 };
 
 // Given the Location relation, return the full metadata
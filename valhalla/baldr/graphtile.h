@@ -41,6 +41,9 @@ namespace baldr {
 
 const std::string SUFFIX_NON_COMPRESSED = ".gph";
 const std::string SUFFIX_COMPRESSED = ".gph.gz";
+const std::string SUFFIX_ZSTD = ".gph.zst";
+// the dictionary zstd tiles were compressed with, one in the directory of each level
+const std::string ZSTD_DICTIONARY = "zstd.dict";
 
 class tile_getter_t;
 /**
@@ -453,6 +456,14 @@ public:
    */
   std::unordered_map<uint32_t, TransitDeparture*> GetTransitDepartures() const;
 
+  /**
+   * Get all of the departures in the tile, sorted by line Id and then departure time.
+   * @return  Returns an iterable over the departures.
+   */
+  midgard::iterable_t<const TransitDeparture> GetDepartures() const {
+    return midgard::iterable_t<const TransitDeparture>{departures_, header_->departurecount()};
+  }
+
   /**
    * Get the stop onestop Ids in this tile.
    * @return  Returns a map of transit stops with onestop Ids as the key and
@@ -575,7 +586,7 @@ public:
     float partial_live_pct = 0;
     if ((flow_mask & kCurrentFlowMask) && traffic_tile() && live_traffic_multiplier != 0.) {
       auto directed_edge_index = std::distance(const_cast<const DirectedEdge*>(directededges_), de);
-      auto volatile& live_speed = traffic_tile.trafficspeed(directed_edge_index);
+      auto live_speed = traffic_tile.trafficspeed(directed_edge_index);
       // only use current speed if its valid and non zero, a speed of 0 makes costing values crazy
       if (live_speed.speed_valid() && (partial_live_speed = live_speed.get_overall_speed()) > 0) {
         *flow_sources |= kCurrentFlowMask;
@@ -664,7 +675,7 @@ public:
     return (is_truck && (de->truck_speed() > 0)) ? std::min(de->truck_speed(), speed) : speed;
   }
 
-  inline const volatile TrafficSpeed& trafficspeed(const DirectedEdge* de) const {
+  inline TrafficSpeed trafficspeed(const DirectedEdge* de) const {
     auto directed_edge_index = std::distance(const_cast<const DirectedEdge*>(directededges_), de);
     return traffic_tile.trafficspeed(directed_edge_index);
   }
@@ -710,9 +721,7 @@ public:
    * @return      whether or not its closed
    */
   inline bool IsClosed(const DirectedEdge* edge) const {
-    auto volatile& live_speed =
-        traffic_tile.trafficspeed(static_cast<uint32_t>(edge - directededges_));
-    return live_speed.closed();
+    return traffic_tile.trafficspeed(static_cast<uint32_t>(edge - directededges_)).closed();
   }
 
   const TrafficTile& get_traffic_tile() const {
@@ -47,6 +47,15 @@ std::string encode_compressed_speeds(const int16_t* coefficients);
  */
 std::array<int16_t, kCoefficientCount> decode_compressed_speeds(const std::string& encoded);
 
+/**
+ * Decode base64-encoded speeds without allocating, for parsing lots of them.
+ * @param encoded       base64-encoded speeds, padding is optional
+ * @param size          length of the encoded speeds
+ * @param coefficients  where to put the transformed speed buckets (must have room for 200)
+ * @return  false if the speeds are not valid base64 or are the wrong length.
+ */
+bool decode_compressed_speeds(const char* encoded, size_t size, int16_t* coefficients);
+
 /**
  * Class to access predicted speed information within a tile.
  */
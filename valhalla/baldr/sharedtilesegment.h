@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <valhalla/baldr/graphid.h>
+
+namespace valhalla {
+namespace baldr {
+
+/**
+ * A named segment of POSIX shared memory holding the raw bytes of graph tiles so that several
+ * processes on the same host (eg multiple valhalla_service instances) can share one copy of each
+ * tile instead of each keeping their own. Whichever process loads a tile first publishes it into
+ * the segment, after that the tile is only ever read. Tiles are never evicted, once the segment is
+ * full new tiles are simply not published.
+ *
+ * The segment outlives the processes using it. It remembers which tileset it was filled from and
+ * is replaced when a process opens it for a different one, processes still using the old tiles
+ * keep their mapping until they are restarted.
+ */
+class SharedTileSegment {
+public:
+  struct stats_t {
+    // how many bytes are available for tile data
+    uint64_t capacity = 0;
+    // how many bytes are taken up by published tiles
+    uint64_t used = 0;
+    // how many tiles have been published
+    uint64_t tiles = 0;
+    // how many tiles could be published at most
+    uint64_t slots = 0;
+  };
+
+  /**
+   * Opens the named segment, creating it if it doesnt exist yet. Only the process which creates the
+   * segment decides its size, everyone else uses what is already there. A segment that holds the
+   * tiles of another tileset or is not valid is removed and created again. Throws if that fails
+   * @param name        the name of the segment, ie what shows up in /dev/shm
+   * @param size        the total size of the segment in bytes if it needs to be created
+   * @param tileset_id  identifies the tiles the segment holds, see GraphReader::GetTilesetId
+   */
+  SharedTileSegment(const std::string& name, size_t size, uint64_t tileset_id);
+
+  /**
+   * Destructor, unmaps the segment but leaves it in place for other processes.
+   */
+  ~SharedTileSegment();
+
+  SharedTileSegment(const SharedTileSegment&) = delete;
+  SharedTileSegment& operator=(const SharedTileSegment&) = delete;
+
+  /**
+   * Looks for a published tile.
+   * @param graphid  the id of the tile
+   * @return the read only bytes of the tile and their size or nullptr if its not published
+   */
+  std::pair<char*, size_t> Find(const GraphId& graphid) const;
+
+  /**
+   * Copies a tile into the segment so that other processes can use it. If another process started
+   * publishing the tile but died before finishing we take over.
+   * @param graphid  the id of the tile
+   * @param data     the bytes of the tile
+   * @param size     how many bytes the tile has
+   * @return the read only bytes of the published tile and their size or nullptr if the tile could
+   *         not be published because the segment is full or another process is publishing it
+   */
+  std::pair<char*, size_t> Publish(const GraphId& graphid, const char* data, size_t size);
+
+  /**
+   * @return how full the segment is, these are shared by all processes using the segment
+   */
+  stats_t stats() const;
+
+  /**
+   * @return identifies the tiles the segment holds
+   */
+  uint64_t tileset_id() const;
+
+  /**
+   * @return the name of the segment
+   */
+  const std::string& name() const {
+    return name_;
+  }
+
+  /**
+   * Gets the segment with the given name. Segments are only mapped once per process and shared by
+   * all the callers in the process that use the same tileset.
+   * @param name        the name of the segment
+   * @param size        the size of the segment if it needs to be created
+   * @param tileset_id  identifies the tiles the segment holds
+   * @return the segment
+   */
+  static std::shared_ptr<SharedTileSegment>
+  Get(const std::string& name, size_t size, uint64_t tileset_id);
+
+  /**
+   * Removes the named segment from the system. Processes which have it mapped can keep using it
+   * but new ones will create a fresh segment.
+   * @param name  the name of the segment
+   * @return true if the segment existed and was removed
+   */
+  static bool Remove(const std::string& name);
+
+protected:
+  struct header_t;
+  struct slot_t;
+
+  // maps the segment, returns false if it had to be removed because it didnt fit
+  bool Open(size_t size, uint64_t tileset_id);
+
+  slot_t* FindSlot(uint64_t key) const;
+
+  std::string name_;
+  size_t size_;
+  // we map the segment twice, once writable to publish and once read only to hand out tiles
+  char* writable_;
+  char* readable_;
+  header_t* header_;
+  slot_t* slots_;
+};
+
+} // namespace baldr
+} // namespace valhalla
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphtileptr.h>
+
+namespace valhalla {
+namespace baldr {
+
+/**
+ * Loads graph tiles on a pool of background I/O threads so that a path algorithm can ask for tiles
+ * it will probably need soon and keep expanding instead of blocking on disk reads and inflating.
+ * The tiles are handed back to the owner of the prefetcher (ie the GraphReader) which then puts
+ * them into its cache.
+ *
+ * Prefetch, Collect, Take and Clear must all be called from the same thread, the one that owns the
+ * GraphReader. Only the loading itself happens on the background threads.
+ */
+class TilePrefetcher {
+public:
+  // Loads a tile given its base id, returns nullptr if the tile cannot be had
+  using loader_t = std::function<graph_tile_ptr(const GraphId&)>;
+
+  // Receives the tiles that finished loading in the background
+  using collector_t = std::function<void(const GraphId&, graph_tile_ptr&&)>;
+
+  struct stats_t {
+    // how many tiles were queued for prefetching
+    uint64_t requested = 0;
+    // how many prefetched tiles were handed to the cache before they were needed
+    uint64_t collected = 0;
+    // how many tiles were needed while the prefetch was already done
+    uint64_t hits = 0;
+    // how many tiles were needed while the prefetch was still in progress
+    uint64_t waits = 0;
+    // how many tiles were needed but not prefetched at all
+    uint64_t misses = 0;
+  };
+
+  /**
+   * Constructor
+   * @param thread_count  how many background threads to load tiles with
+   * @param max_pending   the maximum number of tiles that are queued, in flight or loaded but not
+   *                      yet collected. further prefetch requests are dropped while at this limit
+   * @param loader        the function that loads a tile
+   */
+  TilePrefetcher(size_t thread_count, size_t max_pending, loader_t loader);
+
+  /**
+   * Destructor, stops and joins the background threads.
+   */
+  ~TilePrefetcher();
+
+  TilePrefetcher(const TilePrefetcher&) = delete;
+  TilePrefetcher& operator=(const TilePrefetcher&) = delete;
+
+  /**
+   * Asks for a tile to be loaded in the background. Tiles which have already been asked for since
+   * the last call to Clear are ignored until they are collected or taken.
+   * @param tile_id  the base id of the tile
+   * @return true if the tile was queued
+   */
+  bool Prefetch(const GraphId& tile_id);
+
+  /**
+   * Hands over all of the tiles that have finished loading so far.
+   * @param collector  called for each finished tile
+   */
+  void Collect(const collector_t& collector) {
+    // cheap check to avoid locking on every call
+    if (ready_count_.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+    CollectReady(collector);
+  }
+
+  /**
+   * Gets a tile that is needed right now. If the tile is being loaded in the background we wait for
+   * it to finish, if it is still queued it is removed from the queue and the caller has to load it.
+   * @param tile_id  the base id of the tile
+   * @return the tile or nullptr if the caller needs to load it
+   */
+  graph_tile_ptr Take(const GraphId& tile_id);
+
+  /**
+   * Drops all queued and finished tiles and forgets what was asked for so far. Tiles that are being
+   * loaded right now are discarded when they finish.
+   */
+  void Clear();
+
+  /**
+   * @return the counters since construction
+   */
+  stats_t stats() const;
+
+protected:
+  void CollectReady(const collector_t& collector);
+  void Work();
+
+  loader_t loader_;
+  size_t max_pending_;
+
+  // only touched by the owning thread so we can skip the lock
+  std::unordered_set<GraphId> requested_;
+  stats_t stats_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  std::deque<GraphId> queue_;
+  std::unordered_set<GraphId> in_flight_;
+  std::unordered_map<GraphId, graph_tile_ptr> ready_;
+  std::atomic<size_t> ready_count_;
+  uint64_t generation_;
+  bool stop_;
+
+  std::vector<std::thread> threads_;
+};
+
+} // namespace baldr
+} // namespace valhalla
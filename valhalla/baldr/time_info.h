@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <vector>
 
 #include <valhalla/baldr/datetime.h>
 #include <valhalla/baldr/graphconstants.h>
@@ -169,19 +170,73 @@ struct TimeInfo {
     if (!valid)
       return *this;
 
-    // offset the local time and second of week by the amount traveled to this label
-    uint64_t lt = local_time + static_cast<uint64_t>(seconds_offset);
-    int32_t sw = static_cast<int32_t>(second_of_week + seconds_offset);
-
     // if the timezone changed we need to account for that offset as well
+    int tz_diff = 0;
     if (next_tz_index != timezone_index) {
       namespace dt = baldr::DateTime;
-      int tz_diff = dt::timezone_diff(lt, dt::get_tz_db().from_index(timezone_index),
-                                      dt::get_tz_db().from_index(next_tz_index), tz_cache);
-      lt += tz_diff;
-      sw += tz_diff;
+      tz_diff = dt::timezone_diff(local_time + static_cast<uint64_t>(seconds_offset),
+                                  dt::get_tz_db().from_index(timezone_index),
+                                  dt::get_tz_db().from_index(next_tz_index), tz_cache);
+    }
+    return shift(seconds_offset, next_tz_index, tz_diff);
+  }
+
+  /**
+   * Offset the initial time info to many points along the route at once. Rather than a timezone_diff
+   * per point the timezone offsets are looked up in one pass over the transition tables
+   * @param seconds_offsets  the number of seconds to offset the TimeInfo by at each point
+   * @param tz_indices       the timezone index at each point
+   * @return one TimeInfo per point, the same as calling forward for each of them
+   */
+  std::vector<TimeInfo> forward(const std::vector<float>& seconds_offsets,
+                                const std::vector<uint32_t>& tz_indices) const {
+    const size_t count = seconds_offsets.size();
+    if (!valid)
+      return std::vector<TimeInfo>(count, *this);
+
+    // like timezone_diff there is no difference to zones that arent in our tz db
+    const auto& tz_db = dt::get_tz_db();
+    auto known = [&tz_db](uint32_t index) { return tz_db.from_index(index) != nullptr; };
+    if (!known(timezone_index)) {
+      std::vector<TimeInfo> infos;
+      infos.reserve(count);
+      for (size_t i = 0; i < count; ++i)
+        infos.push_back(shift(seconds_offsets[i], tz_indices[i], 0));
+      return infos;
     }
 
+    // the offset of the origins timezone and of the one at each point at the moment we get there
+    std::vector<uint64_t> seconds(count);
+    for (size_t i = 0; i < count; ++i)
+      seconds[i] = local_time + static_cast<uint64_t>(seconds_offsets[i]);
+    std::vector<uint32_t> origin_tz(count, timezone_index);
+    std::vector<int32_t> origin_offsets(count), offsets(count);
+    const auto& transitions = DateTime::get_tz_transitions();
+    transitions.offsets(seconds.data(), origin_tz.data(), count, origin_offsets.data());
+    transitions.offsets(seconds.data(), tz_indices.data(), count, offsets.data());
+
+    std::vector<TimeInfo> infos;
+    infos.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      bool tz_changed = tz_indices[i] != timezone_index && known(tz_indices[i]);
+      infos.push_back(shift(seconds_offsets[i], tz_indices[i],
+                            tz_changed ? offsets[i] - origin_offsets[i] : 0));
+    }
+    return infos;
+  }
+
+  /**
+   * Offset all the initial time info to reflect the progress along the route to this point
+   * @param seconds_offset  the number of seconds to offset the TimeInfo by
+   * @param next_tz_index   the timezone index at the new location
+   * @param tz_diff         the difference between the offsets of the two timezones
+   * @return a new TimeInfo object reflecting the offset
+   */
+  inline TimeInfo shift(float seconds_offset, int next_tz_index, int tz_diff) const {
+    // offset the local time and second of week by the amount traveled to this label
+    uint64_t lt = local_time + static_cast<uint64_t>(seconds_offset) + tz_diff;
+    int32_t sw = static_cast<int32_t>(second_of_week + seconds_offset) + tz_diff;
+
     // wrap the week second it went past the beginning
     if (sw < 0) {
       sw += valhalla::midgard::kSecondsPerWeek;
@@ -8,7 +8,11 @@
 // C99 stdint.h, and POD structs with no constructors
 #ifndef C_ONLY_INTERFACE
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <ctime>
 #include <exception>
 #include <memory>
 #include <string>
@@ -24,6 +28,9 @@
 
 #ifndef C_ONLY_INTERFACE
 namespace valhalla {
+namespace midgard {
+template <class T> class mem_map;
+} // namespace midgard
 namespace baldr {
 
 using std::uint16_t;
@@ -65,15 +72,15 @@ struct TrafficSpeed {
   uint64_t spare : 1;
 
 #ifndef C_ONLY_INTERFACE
-  inline bool speed_valid() const volatile {
+  inline bool speed_valid() const {
     return breakpoint1 != 0 && overall_encoded_speed != UNKNOWN_TRAFFIC_SPEED_RAW;
   }
 
-  inline bool closed() const volatile {
+  inline bool closed() const {
     return breakpoint1 != 0 && overall_encoded_speed == 0;
   }
 
-  inline bool closed(std::size_t subsegment) const volatile {
+  inline bool closed(std::size_t subsegment) const {
     if (!speed_valid())
       return false;
     switch (subsegment) {
@@ -90,7 +97,7 @@ struct TrafficSpeed {
   }
 
   /// Returns overall speed in kph across edge
-  inline uint8_t get_overall_speed() const volatile {
+  inline uint8_t get_overall_speed() const {
     return overall_encoded_speed << 1;
   }
 
@@ -100,7 +107,7 @@ struct TrafficSpeed {
    * @param subsegment   the index of the subsegment you want
    * @return returns the speed of the subsegment or UNKNOWN_TRAFFIC_SPEED_KPH if unknown
    */
-  inline uint8_t get_speed(std::size_t subsegment) const volatile {
+  inline uint8_t get_speed(std::size_t subsegment) const {
     if (!speed_valid())
       return UNKNOWN_TRAFFIC_SPEED_KPH;
     switch (subsegment) {
@@ -137,7 +144,7 @@ struct TrafficSpeed {
         congestion3{c3}, has_incidents{incidents}, spare{0} {
   }
 
-  json::MapPtr json() const volatile {
+  json::MapPtr json() const {
     auto live_speed = json::map({});
     if (speed_valid()) {
       live_speed->emplace("overall_speed", static_cast<uint64_t>(get_overall_speed()));
@@ -187,8 +194,9 @@ struct TrafficTileHeader {
   uint64_t last_update; // seconds since epoch
   uint32_t directed_edge_count;
   uint32_t traffic_tile_version;
-  uint32_t spare2;
-  uint32_t spare3;
+  // the update (see TrafficEpochs) each of the two sets of speeds was written by, 0 if it never
+  // was. single buffered tiles leave both at 0
+  uint32_t epochs[2];
 };
 
 #ifndef C_ONLY_INTERFACE
@@ -204,12 +212,18 @@ static_assert(sizeof(TrafficSpeed) == sizeof(uint64_t),
 /**
  * A tile of live traffic data.  The layout is:
  *
- * TrafficTileHeader (24 bytes)
- * n x TrafficSpeed entries (n x 2 bytes)
+ * TrafficTileHeader (32 bytes)
+ * n x TrafficSpeed entries (n x 8 bytes)
+ * optionally another n x TrafficSpeed entries (n x 8 bytes)
+ *
+ * Tiles with room for the second set of speeds are double buffered: updaters write into the set
+ * readers are not using and mark it with the epoch of the update, which readers dont look at until
+ * the update is published in the TrafficEpochs of the extract. Tiles without the room, or without
+ * TrafficEpochs, are updated in place.
  */
 #ifndef C_ONLY_INTERFACE
 namespace {
-static constexpr volatile TrafficSpeed INVALID_SPEED{
+static constexpr TrafficSpeed INVALID_SPEED{
     UNKNOWN_TRAFFIC_SPEED_RAW,
     UNKNOWN_TRAFFIC_SPEED_RAW,
     UNKNOWN_TRAFFIC_SPEED_RAW,
@@ -226,7 +240,150 @@ static constexpr volatile TrafficSpeed INVALID_SPEED{
 // (We want to avoid including this file in graphconstants.h)
 static_assert(MAX_TRAFFIC_SPEED_KPH == valhalla::baldr::kMaxTrafficSpeed,
               "Constants must be the same");
+
+// We read speeds and epochs out of memory that another process writes to, one word at a time
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(TrafficSpeed) &&
+                  sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "Atomics must have the same size as what they wrap");
 } // namespace
+
+/**
+ * The epochs live traffic is published at, shared by the processes updating a traffic extract and
+ * those routing on it through a small file next to it, <traffic_extract>.epochs. Updates are
+ * numbered one after the other. An update is written into the spare set of speeds of every tile it
+ * touches and then published for all of them at once, so a request never sees half of one.
+ *
+ * Readers pin the epoch they started at so that the speeds they read cant be overwritten while they
+ * are using them, the next update waits for them first. There is only ever one updater at a time.
+ */
+class TrafficEpochs {
+public:
+  static constexpr uint64_t kMagic = 0x314f504546415254; // TRAFEPO1
+  static constexpr size_t kReaderSlots = 60;
+
+  // the layout of the file
+  struct layout_t {
+    uint64_t magic;
+    // the last update that was published
+    std::atomic<uint32_t> published;
+    // the last update that was started, its the same as published when none is being written
+    std::atomic<uint32_t> begun;
+    // how many readers are pinned to each epoch modulo the number of slots
+    std::atomic<uint32_t> readers[kReaderSlots];
+  };
+
+  /**
+   * Maps the epochs of a traffic extract
+   * @param traffic_extract  the traffic extract, the epochs are in the file next to it
+   * @param create           make the file if there isnt one yet
+   */
+  TrafficEpochs(const std::string& traffic_extract, bool create = false);
+  ~TrafficEpochs();
+
+  /**
+   * @param traffic_extract  the traffic extract
+   * @return its epochs or nullptr if it has none
+   */
+  static std::shared_ptr<TrafficEpochs> Open(const std::string& traffic_extract);
+
+  /**
+   * @return the epochs of the traffic extract this process reads from, nullptr if it has none
+   */
+  static TrafficEpochs* Get() {
+    return current().load(std::memory_order_acquire);
+  }
+
+  /**
+   * Sets the epochs of the traffic extract this process reads from, they are kept until the
+   * process exits since readers may still be pinned to them
+   * @param epochs  the epochs or nullptr if there are none
+   */
+  static void Set(std::shared_ptr<TrafficEpochs> epochs);
+
+  /**
+   * @return the last update that was published
+   */
+  uint32_t published() const {
+    return layout_->published.load();
+  }
+
+  /**
+   * Pins a reader to an epoch. If an update that could overwrite the speeds of that epoch has
+   * started already the reader is pinned to the newest one instead
+   * @param epoch  the epoch to pin, 0 for the newest
+   * @return the epoch that was pinned, which has to be unpinned when done
+   */
+  uint32_t Pin(uint32_t epoch);
+
+  /**
+   * @param epoch  the epoch a reader is done with
+   */
+  void Unpin(uint32_t epoch);
+
+  /**
+   * Starts an update, waiting for the readers that could still be using the speeds it overwrites.
+   * Readers that havent let go by the timeout are taken to be dead and forgotten about
+   * @param timeout  how long to wait for the readers
+   * @return the epoch of the update, pass it to TrafficTile::begin_update of each tile it changes
+   */
+  uint32_t Begin(std::chrono::milliseconds timeout = std::chrono::seconds(30));
+
+  /**
+   * Publishes an update for all of the tiles it changed at once
+   * @param epoch  the epoch of the update
+   */
+  void Publish(uint32_t epoch);
+
+protected:
+  static std::atomic<TrafficEpochs*>& current();
+
+  std::unique_ptr<midgard::mem_map<char>> map_;
+  layout_t* layout_;
+};
+
+/**
+ * Pins the live traffic that the current thread reads from double buffered tiles to an epoch of the
+ * TrafficEpochs of the extract, so that a whole request sees one consistent set of speeds while
+ * updates are published underneath it. Without a snapshot threads read the newest published speeds.
+ * Snapshots nest, the previous one is restored when a snapshot goes out of scope.
+ */
+class TrafficSnapshot {
+public:
+  /**
+   * @param epoch  the epoch to pin, 0 for the newest published one
+   */
+  explicit TrafficSnapshot(const uint32_t epoch = 0)
+      : previous_(pinned()), epochs_(TrafficEpochs::Get()) {
+    pinned() = epochs_ ? epochs_->Pin(epoch) : epoch;
+  }
+
+  ~TrafficSnapshot() {
+    if (epochs_) {
+      epochs_->Unpin(pinned());
+    }
+    pinned() = previous_;
+  }
+
+  TrafficSnapshot(const TrafficSnapshot&) = delete;
+  TrafficSnapshot& operator=(const TrafficSnapshot&) = delete;
+
+  // The epoch the current thread is pinned to, 0 if it is not pinned and reads the newest speeds
+  static uint32_t& pinned() {
+    static thread_local uint32_t epoch = 0;
+    return epoch;
+  }
+
+  // The newest published epoch, ie. what a snapshot taken now sees. 0 if there are no epochs
+  static uint32_t published() {
+    const auto* epochs = TrafficEpochs::Get();
+    return epochs ? epochs->published() : 0;
+  }
+
+private:
+  uint32_t previous_;
+  TrafficEpochs* epochs_;
+};
+
 class TrafficTile {
 public:
   // Disallow copying
@@ -239,13 +396,19 @@ public:
 
   TrafficTile(std::unique_ptr<const GraphMemory> memory)
       : memory_(std::move(memory)),
-        header(memory_ ? reinterpret_cast<volatile TrafficTileHeader*>(memory_->data) : nullptr),
-        speeds(memory_ ? reinterpret_cast<volatile TrafficSpeed*>(memory_->data +
-                                                                  sizeof(TrafficTileHeader))
-                       : nullptr) {
+        header(memory_ ? reinterpret_cast<TrafficTileHeader*>(memory_->data) : nullptr),
+        speeds(memory_ ? reinterpret_cast<TrafficSpeed*>(memory_->data + sizeof(TrafficTileHeader))
+                       : nullptr),
+        pending_(-1), pending_epoch_(0) {
   }
 
-  const volatile TrafficSpeed& trafficspeed(const uint32_t directed_edge_offset) const {
+  /**
+   * Returns a copy of the live speed of an edge. For double buffered tiles the speed comes from
+   * the set of speeds the thread's TrafficSnapshot pins, or from the newest if there is none.
+   * @param directed_edge_offset  the index of the edge within the tile
+   * @return the speed, which is invalid if the tile is not a valid traffic tile
+   */
+  TrafficSpeed trafficspeed(const uint32_t directed_edge_offset) const {
     if (header == nullptr || header->traffic_tile_version != TRAFFIC_TILE_VERSION) {
       return INVALID_SPEED;
     }
@@ -254,7 +417,12 @@ public:
                                std::to_string(directed_edge_offset) +
                                ", edge count: " + std::to_string(header->directed_edge_count));
 
-    return *(speeds + directed_edge_offset);
+    // a single read so we cant get half of the old speed and half of the new one
+    const auto* active = reinterpret_cast<const std::atomic<uint64_t>*>(active_speeds());
+    auto raw = active[directed_edge_offset].load(std::memory_order_relaxed);
+    TrafficSpeed speed;
+    std::memcpy(static_cast<void*>(&speed), &raw, sizeof(speed));
+    return speed;
   }
 
   // Returns true if this tile is valid or not
@@ -262,16 +430,85 @@ public:
     return header != nullptr;
   }
 
+  // Returns true if the tile has room for a second set of speeds that updates are written into
+  bool double_buffered() const {
+    return header != nullptr && header->directed_edge_count > 0 &&
+           memory_->size >= sizeof(TrafficTileHeader) +
+                                2 * sizeof(TrafficSpeed) * header->directed_edge_count;
+  }
+
+  /**
+   * Starts writing an update into this tile and returns the directed_edge_count speeds to write it
+   * into. For double buffered tiles those are the set readers are not using, seeded with the current
+   * speeds, and readers dont see the changes until the update is published with TrafficEpochs.
+   * Other tiles, or updates without an epoch, are written in place.
+   * @param epoch  the epoch of the update from TrafficEpochs::Begin, 0 to update in place
+   * @return the speeds to update
+   */
+  TrafficSpeed* begin_update(const uint32_t epoch = 0) {
+    if (!double_buffered()) {
+      return speeds;
+    }
+    auto count = header->directed_edge_count;
+    uint32_t epochs[] = {this->epoch(0), this->epoch(1)};
+    if (epoch == 0) {
+      return speeds + (epochs[1] > epochs[0]) * count;
+    }
+    if (pending_ >= 0 && pending_epoch_ == epoch) {
+      return speeds + pending_ * count;
+    }
+
+    // copy the published speeds over the older ones, or over those of an update that never finished
+    size_t published = epochs[1] < epoch && (epochs[0] >= epoch || epochs[1] > epochs[0]);
+    pending_ = 1 - published;
+    pending_epoch_ = epoch;
+    reinterpret_cast<std::atomic<uint32_t>*>(&header->epochs[pending_])
+        ->store(epoch, std::memory_order_release);
+    std::memcpy(static_cast<void*>(speeds + pending_ * count),
+                static_cast<const void*>(speeds + published * count), count * sizeof(TrafficSpeed));
+    return speeds + pending_ * count;
+  }
+
 private:
+  uint32_t epoch(const size_t buffer) const {
+    return reinterpret_cast<const std::atomic<uint32_t>*>(&header->epochs[buffer])
+        ->load(std::memory_order_acquire);
+  }
+
+  // The set of speeds readers should look at right now
+  const TrafficSpeed* active_speeds() const {
+    if (!double_buffered()) {
+      return speeds;
+    }
+    uint32_t epochs[] = {epoch(0), epoch(1)};
+    size_t newest = epochs[1] > epochs[0];
+    const auto* traffic_epochs = TrafficEpochs::Get();
+    if (traffic_epochs) {
+      // the newest speeds published by the epoch we are pinned to
+      auto pinned = TrafficSnapshot::pinned();
+      if (!pinned) {
+        pinned = traffic_epochs->published();
+      }
+      if (epochs[newest] > pinned && epochs[1 - newest] <= pinned) {
+        newest = 1 - newest;
+      }
+    }
+    return speeds + newest * header->directed_edge_count;
+  }
+
   std::unique_ptr<const GraphMemory> memory_;
 
 public:
   // These are all const pointers to data structures - once assigned,
-  // the pointer values won't change.  The pointer targets are marked
-  // as const volatile because they can be modified by code outside
-  // our control (another process accessing a mmap'd file for example)
-  volatile TrafficTileHeader* header;
-  volatile TrafficSpeed* speeds;
+  // the pointer values won't change.  The pointer targets can be modified
+  // by code outside our control (another process accessing a mmap'd file
+  // for example) which is why speeds and epochs are only read atomically
+  TrafficTileHeader* header;
+  TrafficSpeed* speeds;
+
+private:
+  int pending_;
+  uint32_t pending_epoch_;
 };
 
 } // namespace baldr
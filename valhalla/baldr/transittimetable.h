@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/midgard/sequence.h>
+#include <valhalla/midgard/util.h>
+
+namespace valhalla {
+namespace baldr {
+
+/**
+ * A flat timetable of all of the transit in the graph, written next to the tiles when transit is
+ * added to them (see mjolnir::TransitBuilder). It holds every scheduled hop of every trip between
+ * two stops as a connection sorted by departure time along with the walking transfers between the
+ * stops, which is what thor::ConnectionScan needs to route on transit without going through the
+ * departures of each transit edge in the tiles.
+ */
+class TransitTimetable {
+public:
+  // the name of the sidecar within the tile directory
+  static constexpr const char* kFileName = "timetable.bin";
+
+  // marks a stop that isnt in the timetable
+  static constexpr uint32_t kInvalidStop = std::numeric_limits<uint32_t>::max();
+
+  // marks the last hop of a trip
+  static constexpr uint32_t kNoConnection = std::numeric_limits<uint32_t>::max();
+
+  // what a connection can carry
+  static constexpr uint32_t kWheelchairAccessible = 1;
+  static constexpr uint32_t kBicycleAccessible = 2;
+
+  // the layout of the file is the header, the stops sorted by node id, the schedules, the
+  // connections sorted by departure time and last the footpaths of each stop in turn
+  static constexpr uint64_t kMagic = 0x56414c4854544231; // VALHTTB1
+  static constexpr uint32_t kVersion = 2;
+  struct header_t {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t stop_count;
+    uint32_t schedule_count;
+    uint32_t connection_count;
+    uint32_t footpath_count;
+    uint32_t trip_count;
+  };
+  struct stop_t {
+    // the transit platform node
+    uint64_t node;
+    // where the footpaths leaving this stop are
+    uint32_t footpath_offset;
+    uint32_t footpath_count;
+  };
+  struct schedule_t {
+    // same as baldr::TransitSchedule but relative to the creation date of the tile it came from
+    uint64_t days;
+    uint32_t days_of_week;
+    uint32_t end_day;
+    uint32_t date_created;
+    uint32_t spare;
+
+    /**
+     * @param date  days from the pivot date
+     * @param dow   day of week mask
+     * @return true if the trips on this schedule run on the date
+     */
+    bool IsValid(const uint32_t date, const uint32_t dow) const {
+      if (date < date_created || date - date_created > end_day) {
+        return (days_of_week & dow) > 0;
+      }
+      return (days & (1ULL << (date - date_created))) > 0;
+    }
+  };
+  struct connection_t {
+    // the transit line edge this hop is on
+    uint64_t edge;
+    // seconds from midnight, can go past midnight for trips starting the day before
+    uint32_t departure;
+    uint32_t arrival;
+    uint32_t from_stop;
+    uint32_t to_stop;
+    // dense index of the vehicle making the hop, unique per run of a frequency based trip
+    uint32_t trip;
+    // the trip id as it is in the tiles
+    uint32_t tripid;
+    uint32_t schedule;
+    uint32_t flags;
+    // index of the next hop of the same trip or kNoConnection, filled in when writing
+    uint32_t next;
+    uint32_t spare;
+  };
+  struct footpath_t {
+    uint32_t stop;
+    uint32_t secs;
+    uint32_t distance;
+  };
+
+  /**
+   * Maps the sidecar, throws if it cant be read or doesnt look like a timetable
+   * @param file_name  the sidecar to load
+   */
+  explicit TransitTimetable(const std::string& file_name);
+
+  /**
+   * Writes a timetable, the connections are sorted by departure, linked to the next hop of their
+   * trip and the footpaths are grouped by stop so the caller doesnt have to
+   * @param file_name    where to write it
+   * @param stops        the stops sorted by node id, their footpath offsets are filled in
+   * @param schedules    the schedules referenced by the connections
+   * @param connections  every hop of every trip
+   * @param footpaths    the walking transfers, indexed by the stop they leave from
+   * @param trip_count   the number of distinct trips referenced by the connections
+   */
+  static void Write(const std::string& file_name,
+                    std::vector<stop_t> stops,
+                    const std::vector<schedule_t>& schedules,
+                    std::vector<connection_t> connections,
+                    const std::vector<std::vector<footpath_t>>& footpaths,
+                    uint32_t trip_count);
+
+  uint32_t stop_count() const {
+    return header_->stop_count;
+  }
+
+  uint32_t trip_count() const {
+    return header_->trip_count;
+  }
+
+  const stop_t& stop(const uint32_t index) const {
+    return stops_[index];
+  }
+
+  const schedule_t& schedule(const uint32_t index) const {
+    return schedules_[index];
+  }
+
+  /**
+   * @param node  a transit platform node
+   * @return the index of the stop or kInvalidStop if it isnt in the timetable
+   */
+  uint32_t find_stop(const GraphId& node) const;
+
+  /**
+   * @return all of the connections sorted by departure time
+   */
+  midgard::iterable_t<const connection_t> connections() const {
+    return midgard::iterable_t<const connection_t>{connections_, header_->connection_count};
+  }
+
+  /**
+   * @param time  seconds from midnight
+   * @return the first connection departing at or after the time
+   */
+  const connection_t* first_departure(const uint32_t time) const;
+
+  /**
+   * @param stop  index of the stop
+   * @return the walking transfers leaving the stop
+   */
+  midgard::iterable_t<const footpath_t> footpaths(const uint32_t stop) const {
+    return midgard::iterable_t<const footpath_t>{footpaths_ + stops_[stop].footpath_offset,
+                                                 stops_[stop].footpath_count};
+  }
+
+protected:
+  midgard::mem_map<char> memory_;
+  const header_t* header_;
+  const stop_t* stops_;
+  const schedule_t* schedules_;
+  const connection_t* connections_;
+  const footpath_t* footpaths_;
+};
+
+} // namespace baldr
+} // namespace valhalla
@@ -1,7 +1,9 @@
 #pragma once
 #include <cstdint>
+#include <string>
 
 #include <valhalla/baldr/directededge.h>
+#include <valhalla/baldr/edgereach.h>
 #include <valhalla/loki/search.h>
 #include <valhalla/thor/dijkstras.h>
 
@@ -32,6 +34,28 @@ struct directed_reach {
   uint32_t inbound : 16;
 };
 
+// the costing of each of the modes in baldr::EdgeReach, their reach is precomputed with the default
+// options of these costings
+constexpr Costing::Type kPrecomputedReachCostings[baldr::ComponentLabels::kModeCount] =
+    {Costing::auto_, Costing::truck, Costing::bicycle, Costing::pedestrian};
+
+/**
+ * Gets a costing with all of its options set to their defaults, the same as a request which didnt
+ * specify any costing options would get
+ * @param type  the type of costing
+ * @return the costing
+ */
+Costing default_costing(Costing::Type type);
+
+/**
+ * The part of the costing options which can change what an edge's reach is, ie everything except
+ * the preferences which only change how much using an edge costs. Requests whose options have the
+ * same key as the default costing of a mode can use the precomputed reach of that mode
+ * @param options  the costing options
+ * @return the key
+ */
+std::string reach_access_key(const Costing::Options& options);
+
 class Reach : public thor::Dijkstras {
 public:
   Reach();
@@ -55,6 +79,18 @@ public:
                             const std::shared_ptr<sif::DynamicCost>& costing,
                             uint8_t direction = kInbound | kOutbound);
 
+  /**
+   * Use the reach precomputed by mjolnir whenever its there and goes far enough instead of doing an
+   * expansion. Its only valid for the default costing of the given mode
+   * @param edge_reach  the precomputed reach or nullptr to always do the expansion
+   * @param mode        which modes reach to use
+   */
+  void set_precomputed(std::shared_ptr<const baldr::EdgeReach> edge_reach,
+                       baldr::EdgeReach::Mode mode) {
+    precomputed_ = std::move(edge_reach);
+    precomputed_mode_ = mode;
+  }
+
 protected:
   // the main method above will do a conservative reach estimate stopping the expansion at any
   // edges which the costing could decide to skip (because of restrictions and possibly more?)
@@ -100,6 +136,8 @@ protected:
   std::unordered_set<uint64_t> queue_, done_;
   uint32_t max_reach_{};
   size_t transitions_{};
+  std::shared_ptr<const baldr::EdgeReach> precomputed_;
+  baldr::EdgeReach::Mode precomputed_mode_{};
 };
 
 } // namespace loki
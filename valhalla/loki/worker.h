@@ -6,7 +6,9 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <valhalla/baldr/componentlabels.h>
 #include <valhalla/baldr/connectivity_map.h>
+#include <valhalla/baldr/edgereach.h>
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/baldr/location.h>
 #include <valhalla/baldr/pathlocation.h>
@@ -63,11 +65,44 @@ protected:
   std::vector<midgard::PointLL> init_height(Api& request);
   void init_transit_available(Api& request);
 
+  /**
+   * Whether the component labels can be used with the current costing and request options. They
+   * cant when the costing uses an access mask we dont have labels for or ignores oneways/access
+   * @param options  the request options
+   * @param mode     set to the mode of the labels to use
+   * @return true if the labels can be used
+   */
+  bool component_mode(const Options& options, baldr::ComponentLabels::Mode& mode) const;
+
+  /**
+   * Uses the component labels to check if any of the edges of one correlated location might lead
+   * to any of the edges of another.
+   * @param origin       the correlated location we start from
+   * @param destination  the correlated location we want to get to
+   * @param mode         the mode of the labels to use
+   * @return false only if there is definitely no path between the two locations
+   */
+  bool may_reach(const valhalla::Location& origin,
+                 const valhalla::Location& destination,
+                 baldr::ComponentLabels::Mode mode) const;
+
+  /**
+   * Gets the precomputed reach if it can be used for the requests costing, ie its one of the
+   * costings the reach was precomputed for and it allows the same edges as the default costing
+   * (see reach_access_key)
+   * @param options  the request options
+   * @return the precomputed reach or nullptr if the reach has to be found by expanding
+   */
+  std::shared_ptr<const baldr::EdgeReach> precomputed_reach(const Options& options) const;
+
   boost::property_tree::ptree config;
   sif::CostFactory factory;
   sif::cost_ptr_t costing;
   std::shared_ptr<baldr::GraphReader> reader;
   std::shared_ptr<baldr::connectivity_map_t> connectivity_map;
+  std::shared_ptr<baldr::ComponentLabels> component_labels;
+  std::shared_ptr<const baldr::EdgeReach> edge_reach;
+  std::unordered_map<Costing::Type, std::string> precomputed_reach_keys;
   std::unordered_set<Options::Action> actions;
   std::string action_str;
   std::unordered_map<std::string, size_t> max_locations;
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace valhalla {
+namespace midgard {
+
+/**
+ * A simple monotonic (bump pointer) allocator. Memory is handed out from blocks and is never
+ * returned individually. Instead the whole arena is reset at once, typically between requests,
+ * which makes the blocks available again without going back to the system allocator. This avoids
+ * malloc contention and page faults for state that is rebuilt from scratch on every request. The
+ * first block is small and each new block doubles in size up to a maximum so that arenas which
+ * only ever see a little use stay small.
+ *
+ * Only use this for trivially destructible types since destructors are never run.
+ */
+class MonotonicArena {
+public:
+  /**
+   * Constructor
+   * @param max_retained_bytes  how much memory to keep around when the arena is reset, any blocks
+   *                            beyond this are released back to the system
+   * @param initial_block_size  the size of the first block requested from the system allocator
+   * @param max_block_size      blocks double in size until they reach this size. requests larger
+   *                            than the next block size get their own dedicated block
+   */
+  explicit MonotonicArena(size_t max_retained_bytes = kDefaultMaxRetainedBytes,
+                          size_t initial_block_size = kDefaultInitialBlockSize,
+                          size_t max_block_size = kDefaultMaxBlockSize)
+      : initial_block_size_(initial_block_size),
+        max_block_size_(std::max(initial_block_size, max_block_size)),
+        max_retained_bytes_(max_retained_bytes), current_(0), offset_(0), bytes_allocated_(0),
+        allocations_(0), block_allocations_(0) {
+  }
+
+  MonotonicArena(const MonotonicArena&) = delete;
+  MonotonicArena& operator=(const MonotonicArena&) = delete;
+  MonotonicArena(MonotonicArena&&) = default;
+  MonotonicArena& operator=(MonotonicArena&&) = default;
+
+  /**
+   * Allocate some memory from the arena.
+   * @param bytes      how many bytes are needed
+   * @param alignment  the alignment of the returned pointer, must be a power of 2
+   * @return pointer to uninitialized memory which stays valid until the next reset
+   */
+  void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+    ++allocations_;
+    bytes_allocated_ += bytes;
+
+    // try to fit it in the current block or any of the retained blocks after it
+    for (; current_ < blocks_.size(); ++current_, offset_ = 0) {
+      auto& block = blocks_[current_];
+      auto base = reinterpret_cast<uintptr_t>(block.data.get());
+      auto aligned = (base + offset_ + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+      if (aligned + bytes <= base + block.size) {
+        offset_ = aligned + bytes - base;
+        return reinterpret_cast<void*>(aligned);
+      }
+    }
+
+    // we need a new block, twice as big as the last one up to the max. oversized requests get
+    // their own block
+    size_t size = blocks_.empty() ? initial_block_size_
+                                  : std::min(blocks_.back().size * 2, max_block_size_);
+    size = std::max(size, bytes + alignment);
+    blocks_.push_back({std::unique_ptr<char[]>(new char[size]), size});
+    ++block_allocations_;
+    current_ = blocks_.size() - 1;
+    offset_ = 0;
+    return allocate_from_current(bytes, alignment);
+  }
+
+  /**
+   * Allocate and value initialize an array of T from the arena.
+   * @param count  how many elements to allocate
+   * @return pointer to the first element
+   */
+  template <typename T> T* allocate_array(size_t count) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "Arena allocated types must be trivially destructible");
+    auto* ptr = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    std::uninitialized_fill_n(ptr, count, T());
+    return ptr;
+  }
+
+  /**
+   * Makes all of the memory available for reuse. Previously returned pointers are invalidated. Any
+   * blocks beyond the retention limit are freed.
+   */
+  void reset() {
+    size_t retained = 0;
+    auto keep = std::find_if(blocks_.begin(), blocks_.end(), [&retained, this](const block_t& b) {
+      retained += b.size;
+      return retained > max_retained_bytes_;
+    });
+    blocks_.erase(keep, blocks_.end());
+    current_ = 0;
+    offset_ = 0;
+    bytes_allocated_ = 0;
+    allocations_ = 0;
+    block_allocations_ = 0;
+  }
+
+  /**
+   * Releases all the memory back to the system allocator.
+   */
+  void release() {
+    blocks_.clear();
+    reset();
+  }
+
+  /**
+   * @return the number of bytes requested since the last reset
+   */
+  size_t bytes_allocated() const {
+    return bytes_allocated_;
+  }
+
+  /**
+   * @return the number of allocations served since the last reset
+   */
+  size_t allocations() const {
+    return allocations_;
+  }
+
+  /**
+   * @return the number of blocks that had to be requested from the system since the last reset
+   */
+  size_t block_allocations() const {
+    return block_allocations_;
+  }
+
+  /**
+   * @return the total size of the blocks currently held by the arena
+   */
+  size_t capacity() const {
+    size_t total = 0;
+    for (const auto& b : blocks_) {
+      total += b.size;
+    }
+    return total;
+  }
+
+  static constexpr size_t kDefaultInitialBlockSize = 4 * 1024;
+  static constexpr size_t kDefaultMaxBlockSize = 1024 * 1024;
+  static constexpr size_t kDefaultMaxRetainedBytes = 16 * 1024 * 1024;
+
+protected:
+  struct block_t {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  void* allocate_from_current(size_t bytes, size_t alignment) {
+    auto& block = blocks_[current_];
+    auto base = reinterpret_cast<uintptr_t>(block.data.get());
+    auto aligned = (base + offset_ + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    offset_ = aligned + bytes - base;
+    return reinterpret_cast<void*>(aligned);
+  }
+
+  size_t initial_block_size_;
+  size_t max_block_size_;
+  size_t max_retained_bytes_;
+  std::vector<block_t> blocks_;
+  size_t current_;
+  size_t offset_;
+  size_t bytes_allocated_;
+  size_t allocations_;
+  size_t block_allocations_;
+};
+
+} // namespace midgard
+} // namespace valhalla
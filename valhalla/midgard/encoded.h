@@ -6,6 +6,8 @@
 #include <type_traits>
 #include <vector>
 
+#include <valhalla/midgard/varint.h>
+
 // we store 6 digits of precision in the tiles, changing to 7 digits is a breaking change
 // if you want to try out 7 digits of precision you can uncomment this definition
 //#define USE_7DIGITS_DEFAULT
@@ -60,71 +62,61 @@ std::vector<double> decode7Samples(std::string_view encodedString, double precis
 std::vector<double> decode7Samples(std::string encodedString, double precision) noexcept(false);
 #endif
 
-template <typename Point> class Shape7Decoder {
+// decodes the shape a few points at a time with the varint kernels but hands them out one by one so
+// that callers who only need the first few points dont pay for the whole thing. if the input ends
+// in the middle of a value the kernels stop short of it and we throw when we get there
+template <typename Point, bool kPolyline> class ShapeDecoder {
 public:
-  Shape7Decoder(const char* begin, const size_t size, const double precision = DECODE_PRECISION)
+  ShapeDecoder(const char* begin, const size_t size, const double precision = DECODE_PRECISION)
       : begin(begin), end(begin + size), prec(precision) {
   }
   Point pop() noexcept(false) {
+    if (size - pos < 2) {
+      fill();
+    }
     lat = next(lat);
     lon = next(lon);
     return Point(double(lon) * prec, double(lat) * prec);
   }
   bool empty() const {
-    return begin == end;
+    return pos == size && begin == end;
   }
 
 private:
-  const char* begin;
-  const char* end;
-  int32_t lat = 0;
-  int32_t lon = 0;
-  double prec;
+  // 8 points worth of values
+  static constexpr size_t kBatch = 16;
 
-  int32_t next(const int32_t previous) noexcept(false) {
-    return decode7Sample(&begin, end, previous);
-  }
-};
-
-template <typename Point> class Shape5Decoder {
-public:
-  Shape5Decoder(const char* begin, const size_t size, const double precision = DECODE_PRECISION)
-      : begin(begin), end(begin + size), prec(precision) {
-  }
-  Point pop() noexcept(false) {
-    lat = next(lat);
-    lon = next(lon);
-    return Point(double(lon) * prec, double(lat) * prec);
-  }
-  bool empty() const {
-    return begin == end;
-  }
-
-private:
   const char* begin;
   const char* end;
   int32_t lat = 0;
   int32_t lon = 0;
   double prec;
+  int32_t values[kBatch];
+  size_t pos = 0;
+  size_t size = 0;
+
+  void fill() {
+    size_t left = size - pos;
+    if (left) {
+      values[0] = values[pos];
+    }
+    pos = 0;
+    size = left + (kPolyline ? varint::decode5(begin, end, values + left, kBatch - left)
+                             : varint::decode7(begin, end, values + left, kBatch - left));
+  }
 
   int32_t next(const int32_t previous) noexcept(false) {
-    // grab each 5 bits and mask it in where it belongs using the shift
-    int byte, shift = 0, result = 0;
-    do {
-      if (empty()) {
-        throw std::runtime_error("Bad encoded polyline");
-      }
-      // take the least significant 5 bits shifted into place
-      byte = int32_t(*begin++) - 63;
-      result |= (byte & 0x1f) << shift;
-      shift += 5;
-      // if the most significant bit is set there is more to this number
-    } while (byte >= 0x20);
-    // handle the bit flipping and add to previous since its an offset
-    return previous + (result & 1 ? ~(result >> 1) : (result >> 1));
+    // the kernel stopped on a value it couldnt finish or there was nothing left
+    if (pos == size) {
+      throw std::runtime_error("Bad encoded polyline");
+    }
+    return previous + values[pos++];
   }
 };
 
+template <typename Point> using Shape7Decoder = ShapeDecoder<Point, false>;
+template <typename Point> using Shape5Decoder = ShapeDecoder<Point, true>;
+
 // specialized implementation for std::vector with reserve
 template <class container_t, class ShapeDecoder = Shape5Decoder<typename container_t::value_type>>
 typename std::enable_if<
@@ -183,55 +175,55 @@ container_t decode7(const std::string& encoded, const double precision = DECODE_
   return decode7<container_t>(encoded.c_str(), encoded.length(), precision);
 }
 
-/**
- * Polyline encode a container of points into a string suitable for web use
- * Note: newer versions of this algorithm allow one to specify a zoom level
- * which allows displaying simplified versions of the encoded linestring
- *
- * @param points    the list of points to encode
- * @param precision Precision of the encoded polyline. Defaults to 6 digit precision.
- * @return string   the encoded container of points
- */
-template <class container_t>
-std::string encode(const container_t& points, const int precision = ENCODE_PRECISION) {
+// turns the points into deltas a chunk at a time and hands them to the varint kernels
+template <bool kPolyline, class container_t>
+std::string encode_points(const container_t& points, const int precision) {
   // a place to keep the output
   std::string output;
   // unless the shape is very course you should probably only need about 3 bytes
   // per coord, which is 6 bytes with 2 coords, so we overshoot to 8 just in case
   output.reserve(points.size() * 8);
 
-  // handy lambda to turn an integer into an encoded string
-  auto serialize = [&output](int number) {
-    // move the bits left 1 position and flip all the bits if it was a negative number
-    number = number < 0 ? ~(static_cast<unsigned int>(number) << 1) : (number << 1);
-    // write 5 bit chunks of the number
-    while (number >= 0x20) {
-      int nextValue = (0x20 | (number & 0x1f)) + 63;
-      output.push_back(static_cast<char>(nextValue));
-      number >>= 5;
-    }
-    // write the last chunk
-    number += 63;
-    output.push_back(static_cast<char>(number));
-  };
+  auto flush = kPolyline ? varint::encode5 : varint::encode7;
 
   // this is an offset encoding so we remember the last point we saw
+  int32_t deltas[64];
+  size_t count = 0;
   int last_lon = 0, last_lat = 0;
   // for each point
   for (const auto& p : points) {
-    // shift the decimal point 5 places to the right and truncate
+    // shift the decimal point x places to the right and truncate
     int lon = static_cast<int>(round(static_cast<double>(p.first) * precision));
     int lat = static_cast<int>(round(static_cast<double>(p.second) * precision));
     // encode each coordinate, lat first for some reason
-    serialize(lat - last_lat);
-    serialize(lon - last_lon);
+    deltas[count++] = lat - last_lat;
+    deltas[count++] = lon - last_lon;
     // remember the last one we encountered
     last_lon = lon;
     last_lat = lat;
+    if (count == 64) {
+      flush(deltas, count, output);
+      count = 0;
+    }
   }
+  flush(deltas, count, output);
   return output;
 }
 
+/**
+ * Polyline encode a container of points into a string suitable for web use
+ * Note: newer versions of this algorithm allow one to specify a zoom level
+ * which allows displaying simplified versions of the encoded linestring
+ *
+ * @param points    the list of points to encode
+ * @param precision Precision of the encoded polyline. Defaults to 6 digit precision.
+ * @return string   the encoded container of points
+ */
+template <class container_t>
+std::string encode(const container_t& points, const int precision = ENCODE_PRECISION) {
+  return encode_points<true>(points, precision);
+}
+
 /**
  * Varint encode a container of points into a string
  *
@@ -240,27 +232,7 @@ std::string encode(const container_t& points, const int precision = ENCODE_PRECI
  */
 template <class container_t>
 std::string encode7(const container_t& points, const int precision = ENCODE_PRECISION) {
-  // a place to keep the output
-  std::string output;
-  // unless the shape is very course you should probably only need about 3 bytes
-  // per coord, which is 6 bytes with 2 coords, so we overshoot to 8 just in case
-  output.reserve(points.size() * 8);
-
-  // this is an offset encoding so we remember the last point we saw
-  int last_lon = 0, last_lat = 0;
-  // for each point
-  for (const auto& p : points) {
-    // shift the decimal point x places to the right and truncate
-    int lon = static_cast<int>(round(static_cast<double>(p.first) * precision));
-    int lat = static_cast<int>(round(static_cast<double>(p.second) * precision));
-    // encode each coordinate, lat first for some reason
-    encode7Sample(lat - last_lat, output);
-    encode7Sample(lon - last_lon, output);
-    // remember the last one we encountered
-    last_lon = lon;
-    last_lat = lat;
-  }
-  return output;
+  return encode_points<false>(points, precision);
 }
 
 } // namespace midgard
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cmath>
 #include <cstdint>
@@ -16,6 +17,7 @@
 #include <queue>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -156,7 +158,7 @@ public:
   void create(const std::string& new_file_name, size_t new_count, int advice = POSIX_MADV_NORMAL) {
     auto target_size = new_count * sizeof(T);
     struct stat s;
-    if (stat(new_file_name.c_str(), &s) || s.st_size != target_size) {
+    if (stat(new_file_name.c_str(), &s) || static_cast<size_t>(s.st_size) != target_size) {
       // open, create and truncate the file
       std::ofstream f(new_file_name, std::ios::binary | std::ios::out | std::ios::trunc);
       // seek to the new size and put a null char
@@ -325,57 +327,116 @@ public:
     return npos;
   }
 
-  // sort the file based on the predicate, and outputs to output_seq
+  // how many elements are sorted in memory at once by default
+  static constexpr size_t kSortBufferSize = 1024 * 1024 * 512 / sizeof(T);
+
+  // sort the file based on the predicate
   //
-  // Strategy is to first sort sub-ranges of length buffer_size in place.
-  // These should all fit in memory. Then, merge the sub-ranges into the
-  // output sequence via priority queue.
+  // Strategy is to first sort sub-ranges of the file in place, several at a time on separate
+  // threads, with at most buffer_size elements being sorted at once. Then the sorted sub-ranges
+  // are merged into a temporary file. To merge in parallel the output is split at a few splitter
+  // values sampled from the sub-ranges, every thread then merges the parts of the sub-ranges that
+  // fall between two splitters via priority queue into its own region of the output. Both the
+  // sub-ranges and the output are only ever walked front to back while merging so the kernel is
+  // told to read ahead and drop pages behind us. The predicate is called from at most concurrency
+  // threads, callers that want more than one should take it from their configuration.
   void sort(const std::function<bool(const T&, const T&)>& predicate,
-            size_t buffer_size = 1024 * 1024 * 512 / sizeof(T)) {
+            size_t buffer_size = kSortBufferSize,
+            size_t concurrency = 1) {
     flush();
     // if no elements we are done
-    if (memmap.size() == 0) {
+    const size_t count = memmap.size();
+    if (count == 0) {
       return;
     }
 
     // If there wont be any merging we may as well take the simple approach
-    if (buffer_size > memmap.size() + write_buffer.size()) {
-      std::sort(static_cast<T*>(memmap), static_cast<T*>(memmap) + memmap.size(), predicate);
+    concurrency = std::max(concurrency, static_cast<size_t>(1));
+    if (buffer_size > count && (concurrency == 1 || count < kMinParallelSort)) {
+      std::sort(static_cast<T*>(memmap), static_cast<T*>(memmap) + count, predicate);
       return;
     }
 
+    // the buffer is shared by the threads but each of them gets at least one sub-range
+    size_t range_size = std::max(buffer_size / concurrency, static_cast<size_t>(1));
+    range_size = std::min(range_size, (count + concurrency - 1) / concurrency);
+    const size_t range_count = (count + range_size - 1) / range_size;
+
+    // Sort the subsections, each thread grabs the next one until there are none left
+    T* data = memmap;
+    std::atomic<size_t> next(0);
+    parallel(std::min(concurrency, range_count), [&]() {
+      for (size_t r = next++; r < range_count; r = next++) {
+        std::sort(data + r * range_size, data + std::min(count, (r + 1) * range_size), predicate);
+      }
+    });
+
+    // split the output into a few parts per thread so one slow part doesnt hold up the rest
+    const size_t part_count = std::min(concurrency * 4, count);
+    std::vector<T> samples;
+    samples.reserve(range_count * part_count);
+    for (size_t r = 0; r < range_count; ++r) {
+      size_t begin = r * range_size, size = std::min(count, begin + range_size) - begin;
+      for (size_t s = 0; s < part_count; ++s) {
+        samples.push_back(data[begin + s * size / part_count]);
+      }
+    }
+    std::sort(samples.begin(), samples.end(), predicate);
+
+    // where each part starts in each sub-range, everything before the splitter of a part goes to
+    // the parts before it so the parts are consecutive and dont overlap in the output
+    std::vector<std::vector<size_t>> bounds(part_count + 1, std::vector<size_t>(range_count));
+    for (size_t r = 0; r < range_count; ++r) {
+      bounds.front()[r] = r * range_size;
+      bounds.back()[r] = std::min(count, (r + 1) * range_size);
+      for (size_t p = 1; p < part_count; ++p) {
+        const T& splitter = samples[p * samples.size() / part_count];
+        bounds[p][r] = std::lower_bound(data + bounds[p - 1][r], data + bounds.back()[r], splitter,
+                                        predicate) -
+                       data;
+      }
+    }
+
     auto tmp_path = filesystem::path(file_name).replace_filename(
         filesystem::path(file_name).filename().string() + ".tmp");
     {
-      // we need a temporary sequence to merge the sorted subsections into
-      sequence<T> output_seq(tmp_path.string(), true);
-
-      // Comparator needs to be inverted for pq to provide constant time *smallest* lookup
-      // Pq keeps track of element and its index.
-      auto cmp = [&predicate](const std::pair<T, size_t>& a, std::pair<T, size_t>& b) {
-        return predicate(b.first, a.first);
-      };
-      std::priority_queue<std::pair<T, size_t>, std::vector<std::pair<T, size_t>>, decltype(cmp)> pq(
-          cmp);
-
-      // Sort the subsections
-      for (size_t i = 0; i < memmap.size(); i += buffer_size) {
-        std::sort(static_cast<T*>(memmap) + i,
-                  static_cast<T*>(memmap) + std::min(memmap.size(), i + buffer_size), predicate);
-        pq.emplace(*at(i), i);
-      }
-
-      // Perform the merge
-      while (!pq.empty()) {
-        auto tmp = pq.top();
-        pq.pop();
-        output_seq.push_back(tmp.first);
-        size_t new_idx = tmp.second + 1;
-        if (new_idx % buffer_size != 0 && new_idx < memmap.size()) {
-          pq.emplace(*at(new_idx), new_idx);
+      // we need a temporary file to merge the sorted subsections into
+      mem_map<T> output;
+      output.create(tmp_path.string(), count, POSIX_MADV_SEQUENTIAL);
+      memmap.map(file_name, count, POSIX_MADV_SEQUENTIAL);
+      data = memmap;
+
+      // Perform the merge, each thread grabs the next part until there are none left
+      next = 0;
+      parallel(std::min(concurrency, part_count), [&]() {
+        // Comparator needs to be inverted for pq to provide constant time *smallest* lookup
+        // Pq keeps track of the index of the element and the end of its subsection.
+        auto cmp = [&predicate, data](const std::pair<size_t, size_t>& a,
+                                      const std::pair<size_t, size_t>& b) {
+          return predicate(data[b.first], data[a.first]);
+        };
+        std::priority_queue<std::pair<size_t, size_t>, std::vector<std::pair<size_t, size_t>>,
+                            decltype(cmp)>
+            pq(cmp);
+        for (size_t p = next++; p < part_count; p = next++) {
+          // the output of this part starts after everything that went into the earlier parts
+          T* out = output.get();
+          for (size_t r = 0; r < range_count; ++r) {
+            out += bounds[p][r] - bounds.front()[r];
+            if (bounds[p][r] < bounds[p + 1][r]) {
+              pq.emplace(bounds[p][r], bounds[p + 1][r]);
+            }
+          }
+          while (!pq.empty()) {
+            auto top = pq.top();
+            pq.pop();
+            *out++ = data[top.first];
+            if (++top.first < top.second) {
+              pq.push(top);
+            }
+          }
         }
-      }
-      output_seq.flush();
+      });
     }
 
     // Forget about this file for a second so we can swap in the temp file
@@ -587,6 +648,22 @@ public:
   }
 
 protected:
+  // below this many elements sorting on one thread beats the cost of merging into another file
+  static constexpr size_t kMinParallelSort = 1024 * 1024;
+
+  // run the work on this thread and on threads - 1 others until all of them return
+  static void parallel(size_t threads, const std::function<void()>& work) {
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+      pool.emplace_back(work);
+    }
+    work();
+    for (auto& thread : pool) {
+      thread.join();
+    }
+  }
+
   std::shared_ptr<std::fstream> file;
   std::string file_name;
   std::vector<T> write_buffer;
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace valhalla {
+namespace midgard {
+namespace varint {
+
+/**
+ * Bulk kernels for the two variable length integer formats we use for shapes: the 5 bit chunks of
+ * the google polyline format (printable, each byte offset by 63) and the 7 bit chunks of the shape
+ * stored in the tiles. Both zig-zag the sign bit into the lowest bit first. The values in and out
+ * are the deltas between consecutive coordinates, accumulating them is left to the caller.
+ *
+ * On x86-64 the kernels find where each value ends for 16 bytes at a time with SSE2 and, when the
+ * cpu has BMI2, gather or scatter the payload bits of a whole value with a single pext or pdep.
+ * Which implementation is used is decided once at startup from what the cpu supports.
+ */
+enum class Kernel : uint8_t { kScalar = 0, kSimd = 1 };
+
+/**
+ * @return the implementation the kernels currently use
+ */
+Kernel active_kernel();
+
+/**
+ * Switches the implementation the kernels use, meant for tests and benchmarks as its not thread
+ * safe with respect to other threads en/decoding at the same time
+ * @param kernel  the implementation to use
+ * @return false if the cpu doesnt support it in which case nothing changes
+ */
+bool use_kernel(Kernel kernel);
+
+/**
+ * Decodes as many whole values as are available up to count. Decoding stops early at the end of the
+ * input or at a value which is cut off by the end of the input, which is left for the caller to
+ * complain about.
+ * @param begin   where to start decoding, moved past the values that were decoded
+ * @param end     the end of the input
+ * @param values  the decoded values are written here
+ * @param count   at most this many values are decoded
+ * @return the number of values decoded
+ */
+size_t decode5(const char*& begin, const char* end, int32_t* values, size_t count);
+size_t decode7(const char*& begin, const char* end, int32_t* values, size_t count);
+
+/**
+ * Encodes the values and appends them to the output
+ * @param values  the values to encode
+ * @param count   how many of them there are
+ * @param output  where to append the encoded bytes
+ */
+void encode5(const int32_t* values, size_t count, std::string& output);
+void encode7(const int32_t* values, size_t count, std::string& output);
+
+} // namespace varint
+} // namespace midgard
+} // namespace valhalla
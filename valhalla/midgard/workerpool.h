@@ -0,0 +1,83 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace valhalla {
+namespace midgard {
+
+/**
+ * A fixed set of threads that the parallel parts of request handling share, so that a busy service
+ * doesn't create threads for every request and the number of them stays bounded no matter how many
+ * requests run at once. The thread asking for work to be done always works on it as well, so work
+ * still gets done when every thread of the pool is busy with other requests.
+ */
+class WorkerPool {
+public:
+  /**
+   * Constructor
+   * @param threads  how many threads the pool has, not counting the threads that hand it work
+   */
+  explicit WorkerPool(size_t threads);
+
+  /**
+   * Destructor, finishes what was handed to the pool and joins the threads.
+   */
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * Runs the task for every index in [0, count) on the threads of the pool and this thread and
+   * returns when all of them are done. If tasks throw, the exception of the lowest index is
+   * rethrown so the same error is reported no matter the timing.
+   * @param count  how many times to run the task
+   * @param task   the work for the index it is given
+   */
+  void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+  /**
+   * @return how many threads the pool has
+   */
+  size_t size() const {
+    return threads_.size();
+  }
+
+protected:
+  struct Job;
+  void Work();
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::deque<std::shared_ptr<Job>> jobs_;
+  bool stop_;
+  std::vector<std::thread> threads_;
+};
+
+/**
+ * The pool of a stage of request handling, made when it is first needed and replaced when the stage
+ * is configured with a different number of threads. Requests still running on a replaced pool keep
+ * it alive until they are done.
+ */
+class SharedWorkerPool {
+public:
+  /**
+   * @param threads  how many threads, including the calling one, should work on a task
+   * @return the pool with one thread less than that
+   */
+  std::shared_ptr<WorkerPool> Get(size_t threads);
+
+protected:
+  std::mutex mutex_;
+  std::shared_ptr<WorkerPool> pool_;
+};
+
+} // namespace midgard
+} // namespace valhalla
@@ -8,8 +8,10 @@
 #include <boost/geometry/multi/geometries/multi_polygon.hpp>
 
 #include <cstdint>
+#include <map>
 #include <sqlite3.h>
 #include <unordered_map>
+#include <vector>
 #include <valhalla/baldr/graphconstants.h>
 #include <valhalla/midgard/aabb2.h>
 #include <valhalla/midgard/pointll.h>
@@ -51,6 +53,97 @@ uint32_t GetMultiPolyId(const std::multimap<uint32_t, multi_polygon_type>& polys
  */
 uint32_t GetMultiPolyId(const std::multimap<uint32_t, multi_polygon_type>& polys, const PointLL& ll);
 
+/**
+ * An index over the admin or timezone polygons of a tile to find the ones covering a point without
+ * a full point in polygon test against each of them. It splits the tile into a uniform grid and
+ * keeps per cell which polygons cover all of it and which have some of their boundary in it, along
+ * with those boundary segments and whether the center of the cell is inside. Whether a point is in
+ * one of the latter is then a matter of counting how many of the cell's segments the line from the
+ * center to the point crosses. Points on or very near a boundary, and points outside the tile, get
+ * the exact test. The polygons must outlive the index.
+ */
+class PolygonIndex {
+public:
+  /**
+   * Builds the index, which is only worth it with more than one polygon so with fewer points are
+   * just tested against them
+   * @param  polys      the polygons keyed by their admin or timezone index
+   * @param  bounds     the bounds of the tile the polygons are for
+   * @param  divisions  the number of rows and columns of the grid
+   */
+  PolygonIndex(const std::multimap<uint32_t, multi_polygon_type>& polys,
+               const AABB2<PointLL>& bounds,
+               uint32_t divisions = 16);
+
+  /**
+   * Calls the visitor with the index of every polygon covering the point, in the order of the
+   * polygons map, until it returns true
+   * @param  ll     the point
+   * @param  visit  the visitor, returns true to stop
+   */
+  template <typename visitor_t> void covering(const PointLL& ll, const visitor_t& visit) const {
+    auto cell = cell_of(ll);
+    if (cell < 0) {
+      for (const auto& polygon : polygons_) {
+        if (boost::geometry::covered_by(point_type(ll.lng(), ll.lat()), *polygon.second) &&
+            visit(polygon.first)) {
+          return;
+        }
+      }
+      return;
+    }
+    for (auto e = cells_[cell]; e < cells_[cell + 1]; ++e) {
+      if (covers(entries_[e], cell, ll) && visit(polygons_[entries_[e].polygon].first)) {
+        return;
+      }
+    }
+  }
+
+protected:
+  struct segment_t {
+    double x1, y1, x2, y2;
+  };
+
+  // a polygon in a cell, without segments it covers the whole cell
+  struct entry_t {
+    uint32_t polygon;
+    uint32_t begin;
+    uint32_t end;
+    bool center_inside;
+  };
+
+  int32_t cell_of(const PointLL& ll) const;
+  PointLL center(uint32_t cell) const;
+  bool covers(const entry_t& entry, uint32_t cell, const PointLL& ll) const;
+
+  std::vector<std::pair<uint32_t, const multi_polygon_type*>> polygons_;
+  AABB2<PointLL> bounds_;
+  uint32_t divisions_;
+  double cell_width_;
+  double cell_height_;
+  // where each cell's entries begin, the last one is where they end
+  std::vector<uint32_t> cells_;
+  std::vector<entry_t> entries_;
+  std::vector<segment_t> segments_;
+};
+
+/**
+ * Get the polygon index.  Used by admin areas.  Same as above but looks the polygons up in the
+ * index rather than testing every one of them.
+ * @param  index      index of the polys.
+ * @param  ll         point that needs to be checked.
+ * @param  graphtile  graphtilebuilder that is used to determine if we are a country poly or not.
+ */
+uint32_t GetMultiPolyId(const PolygonIndex& index, const PointLL& ll, GraphTileBuilder& graphtile);
+
+/**
+ * Get the polygon index.  Used by tz and admin areas.  Same as above but looks the polygons up in
+ * the index rather than testing every one of them.
+ * @param  index      index of the polys.
+ * @param  ll         point that needs to be checked.
+ */
+uint32_t GetMultiPolyId(const PolygonIndex& index, const PointLL& ll);
+
 /**
  * Get the timezone polys from the db
  * @param  db_handle    sqlite3 db handle
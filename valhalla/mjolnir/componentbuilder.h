@@ -0,0 +1,51 @@
+#ifndef VALHALLA_MJOLNIR_COMPONENTBUILDER_H
+#define VALHALLA_MJOLNIR_COMPONENTBUILDER_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * Labels the strongly connected components of the graph for each of the modes in
+ * baldr::ComponentLabels and writes them to a sidecar file in the tile directory. Loki uses the
+ * labels to reject locations that cannot reach each other before thor goes looking for a path.
+ */
+class ComponentBuilder {
+public:
+  // the labels of every node for a single mode
+  struct labels_t {
+    // the component of each node, in the order tarjan finished them
+    std::vector<uint32_t> labels;
+    // the first component label of each island (weakly connected component)
+    std::vector<uint32_t> islands;
+  };
+
+  // appends the nodes adjacent to a node to the vector
+  using adjacency_t = std::function<void(uint32_t, std::vector<uint32_t>&)>;
+
+  /**
+   * Labels the components of all of the tiles in the tile directory and writes the sidecar.
+   * @param pt  the config
+   */
+  static void Build(const boost::property_tree::ptree& pt);
+
+  /**
+   * Labels the strongly connected components of a graph one island at a time.
+   * @param node_count  how many nodes the graph has
+   * @param successors  gives the nodes you can get to from a node
+   * @param neighbors   gives the nodes connected to a node in either direction
+   * @return the labels
+   */
+  static labels_t
+  Label(uint32_t node_count, const adjacency_t& successors, const adjacency_t& neighbors);
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_COMPONENTBUILDER_H
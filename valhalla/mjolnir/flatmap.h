@@ -0,0 +1,231 @@
+#ifndef VALHALLA_MJOLNIR_FLATMAP_H
+#define VALHALLA_MJOLNIR_FLATMAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <valhalla/midgard/sequence.h>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * Flat storage for the lookups kept in OSMData. Entries are appended while parsing and sorted
+ * once when a parsing stage is done, after that lookups are binary searches over one contiguous
+ * array. Written to disk the array is stored as is so that a later stage can memory map it
+ * instead of rebuilding a hash map on the heap.
+ */
+template <class T> class FlatStorage {
+public:
+  using const_iterator = const T*;
+
+  const_iterator begin() const {
+    return mapped_ ? mapped_->get() : entries_.data();
+  }
+
+  const_iterator end() const {
+    return begin() + size();
+  }
+
+  size_t size() const {
+    return mapped_ ? mapped_->size() : entries_.size();
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  /**
+   * Write the sorted entries to a file. The entries may be mapped from the very file being written
+   * so they go to a temporary file first which then replaces it, the mapping keeps the old one.
+   * @return Returns true if successful, false if an error occurs.
+   */
+  bool write(const std::string& filename) const {
+    // still mapped from there means nothing changed since it was read
+    if (mapped_ && filename == mapped_file_) {
+      return true;
+    }
+
+    auto temp = filename + ".tmp";
+    {
+      std::ofstream file(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!file.is_open()) {
+        return false;
+      }
+      file.write(reinterpret_cast<const char*>(begin()), size() * sizeof(T));
+      file.close();
+      if (file.fail()) {
+        std::remove(temp.c_str());
+        return false;
+      }
+    }
+    return std::rename(temp.c_str(), filename.c_str()) == 0;
+  }
+
+  /**
+   * Memory map the entries written by a previous stage.
+   * @return Returns true if successful, false if an error occurs.
+   */
+  bool read(const std::string& filename) {
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open() || file.tellg() % sizeof(T) != 0) {
+      return false;
+    }
+    size_t count = file.tellg() / sizeof(T);
+    file.close();
+
+    entries_.clear();
+    entries_.shrink_to_fit();
+    mapped_.reset();
+    mapped_file_.clear();
+    sorted_ = true;
+    if (count > 0) {
+      mapped_ = std::make_shared<midgard::mem_map<T>>();
+      mapped_->map_readonly(filename, count, POSIX_MADV_RANDOM);
+      mapped_file_ = filename;
+    }
+    return true;
+  }
+
+protected:
+  void append(const T& entry) {
+    // rare but possible if a stage starts from files and then parses more
+    if (mapped_) {
+      entries_.assign(begin(), end());
+      mapped_.reset();
+      mapped_file_.clear();
+    }
+    entries_.push_back(entry);
+    sorted_ = false;
+  }
+
+  /**
+   * Sorts the entries. When stable, equal entries keep the order they were inserted in. Rather than
+   * std::stable_sort, which wants a buffer as big as the entries, that sorts 4 byte positions and
+   * then moves the entries into place.
+   */
+  template <class Less> void sort(const Less& less, bool stable = true) {
+    if (sorted_) {
+      return;
+    }
+    sorted_ = true;
+    if (std::is_sorted(entries_.begin(), entries_.end(), less)) {
+      return;
+    }
+    if (!stable) {
+      std::sort(entries_.begin(), entries_.end(), less);
+      return;
+    }
+    if (entries_.size() > std::numeric_limits<uint32_t>::max()) {
+      std::stable_sort(entries_.begin(), entries_.end(), less);
+      return;
+    }
+
+    // where each entry should come from, ties go to the one inserted first
+    std::vector<uint32_t> from(entries_.size());
+    for (uint32_t i = 0; i < from.size(); ++i) {
+      from[i] = i;
+    }
+    std::sort(from.begin(), from.end(), [this, &less](uint32_t a, uint32_t b) {
+      return less(entries_[a], entries_[b]) || (!less(entries_[b], entries_[a]) && a < b);
+    });
+
+    // follow each cycle of the permutation, marking the places that are done
+    for (uint32_t i = 0; i < from.size(); ++i) {
+      if (from[i] == i) {
+        continue;
+      }
+      T entry = std::move(entries_[i]);
+      auto to = i;
+      while (from[to] != i) {
+        auto next = from[to];
+        entries_[to] = std::move(entries_[next]);
+        from[to] = to;
+        to = next;
+      }
+      entries_[to] = std::move(entry);
+      from[to] = to;
+    }
+  }
+
+  template <class Equal> void unique(const Equal& equal) {
+    if (!mapped_) {
+      entries_.erase(std::unique(entries_.begin(), entries_.end(), equal), entries_.end());
+    }
+  }
+
+  std::vector<T> entries_;
+  std::shared_ptr<midgard::mem_map<T>> mapped_;
+  std::string mapped_file_;
+  bool sorted_ = true;
+};
+
+/**
+ * A multimap from an OSM id to a value, see FlatStorage. Lookups are only valid after sort().
+ */
+template <class V> class FlatMultiMap : public FlatStorage<std::pair<uint64_t, V>> {
+public:
+  using value_type = std::pair<uint64_t, V>;
+  using const_iterator = const value_type*;
+
+  void insert(const value_type& entry) {
+    this->append(entry);
+  }
+
+  void sort() {
+    FlatStorage<value_type>::sort(
+        [](const value_type& a, const value_type& b) { return a.first < b.first; });
+  }
+
+  std::pair<const_iterator, const_iterator> equal_range(const uint64_t id) const {
+    auto lower = std::lower_bound(this->begin(), this->end(), id,
+                                  [](const value_type& a, uint64_t b) { return a.first < b; });
+    auto upper = lower;
+    while (upper != this->end() && upper->first == id) {
+      ++upper;
+    }
+    // like the hash maps these replace an empty range is at the end
+    if (lower == upper) {
+      return {this->end(), this->end()};
+    }
+    return {lower, upper};
+  }
+
+  const_iterator find(const uint64_t id) const {
+    return equal_range(id).first;
+  }
+};
+
+/**
+ * A set of OSM ids, see FlatStorage. Lookups are only valid after sort().
+ */
+class FlatSet : public FlatStorage<uint64_t> {
+public:
+  void insert(const uint64_t id) {
+    append(id);
+  }
+
+  void sort() {
+    // duplicates go anyway so the order among them doesnt matter
+    FlatStorage<uint64_t>::sort(std::less<uint64_t>(), false);
+    unique(std::equal_to<uint64_t>());
+  }
+
+  const_iterator find(const uint64_t id) const {
+    auto found = std::lower_bound(begin(), end(), id);
+    return found != end() && *found == id ? found : end();
+  }
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_FLATMAP_H
@@ -29,6 +29,9 @@ public:
 
   ~LuaTagTransform();
 
+  LuaTagTransform(const LuaTagTransform&) = delete;
+  LuaTagTransform& operator=(const LuaTagTransform&) = delete;
+
   Tags Transform(OSMType type, uint64_t osmid, const Tags& tags);
 
 protected:
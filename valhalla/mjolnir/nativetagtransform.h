@@ -0,0 +1,29 @@
+#ifndef VALHALLA_MJOLNIR_NATIVETAGTRANSFORM_H
+#define VALHALLA_MJOLNIR_NATIVETAGTRANSFORM_H
+
+#include <valhalla/mjolnir/luatagtransform.h>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * Native versions of nodes_proc, ways_proc and rels_proc in lua/graph.lua. They give the same tags
+ * as the lua does but skip building a lua table for every object and interpreting the script, so
+ * the parser uses them in place of the lua when it is running the built in script. Any change to
+ * lua/graph.lua has to be made here as well, test/lua.cc checks that the two agree.
+ */
+class NativeTagTransform {
+public:
+  /**
+   * Transform the tags of an osm object the same way lua/graph.lua does.
+   * @param  type  the type of osm object
+   * @param  tags  the tags of the object
+   * @return the transformed tags or nothing if the object is of no interest
+   */
+  static Tags Transform(OSMType type, const Tags& tags);
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_NATIVETAGTRANSFORM_H
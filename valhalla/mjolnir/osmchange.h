@@ -0,0 +1,68 @@
+#ifndef VALHALLA_MJOLNIR_OSMCHANGE_H
+#define VALHALLA_MJOLNIR_OSMCHANGE_H
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphreader.h>
+#include <valhalla/midgard/pointll.h>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * The parts of an OSM change file (.osc) that say where in the graph it lands. Creates, modifies
+ * and deletes are all treated the same, what matters is which nodes, ways and relations changed.
+ */
+struct OSMChange {
+  // where each changed node is now, deleted nodes usually dont say and have an invalid location
+  std::unordered_map<uint64_t, midgard::PointLL> nodes;
+  // changed ways and the nodes of those that still exist
+  std::unordered_map<uint64_t, std::vector<uint64_t>> ways;
+  // the ways that are members of changed relations, their restrictions or refs may have changed
+  std::unordered_set<uint64_t> relation_ways;
+
+  /**
+   * Read an osmChange file. The file is streamed through, gzip decompressing it if need be, so only
+   * the ids, locations and refs of the nodes, ways and relations found are kept in memory.
+   * @param  file_name  the .osc or gzip compressed .osc.gz file
+   * @return the change, throws std::runtime_error if the file is not an osmChange file or it is
+   *         cut off or malformed
+   */
+  static OSMChange Read(const std::string& file_name);
+};
+
+/**
+ * The tiles a change touches, which are the ones an incremental build would have to redo.
+ */
+struct ChangedTiles {
+  // local level tiles holding changed nodes or edges of changed ways
+  std::set<baldr::GraphId> changed;
+  // other local level tiles with edges to or from the changed ones, their edges point at nodes
+  // whose ids may move so they are rebuilt with them
+  std::set<baldr::GraphId> neighbors;
+  // the highway and arterial tiles above all of those
+  std::set<baldr::GraphId> parents;
+  // changed ways none of whose nodes have a location in the change and which arent in the
+  // tiles yet, new ways made of existing nodes. where they are cant be known from the tiles
+  size_t unlocated_ways = 0;
+};
+
+/**
+ * Find the tiles of an existing tile set that a change touches. Every tile is read once to find
+ * the edges of the changed ways and which local tiles are connected to which.
+ * @param  reader  reader of the tiles the change applies to
+ * @param  change  the change
+ * @return the tiles to rebuild
+ */
+ChangedTiles FindChangedTiles(baldr::GraphReader& reader, const OSMChange& change);
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_OSMCHANGE_H
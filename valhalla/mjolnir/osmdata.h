@@ -5,9 +5,10 @@
 #include <map>
 #include <memory>
 #include <string>
-#include <unordered_set>
+#include <unordered_map>
 #include <vector>
 
+#include <valhalla/mjolnir/flatmap.h>
 #include <valhalla/mjolnir/osmaccessrestriction.h>
 #include <valhalla/mjolnir/osmnode.h>
 #include <valhalla/mjolnir/osmrestriction.h>
@@ -42,12 +43,13 @@ struct OSMLaneConnectivity {
   uint32_t from_lanes_index; // Index to string in UniqueNames
 };
 
-// Data types used within OSMData
-using RestrictionsMultiMap = std::unordered_multimap<uint64_t, OSMRestriction>;
-using ViaSet = std::unordered_set<uint64_t>;
-using AccessRestrictionsMultiMap = std::unordered_multimap<uint64_t, OSMAccessRestriction>;
-using BikeMultiMap = std::unordered_multimap<uint64_t, OSMBike>;
-using OSMLaneConnectivityMultiMap = std::unordered_multimap<uint64_t, OSMLaneConnectivity>;
+// Data types used within OSMData. These are sorted arrays rather than hash maps so that they take
+// a fraction of the memory while parsing and can be memory mapped by the stages after it
+using RestrictionsMultiMap = FlatMultiMap<OSMRestriction>;
+using ViaSet = FlatSet;
+using AccessRestrictionsMultiMap = FlatMultiMap<OSMAccessRestriction>;
+using BikeMultiMap = FlatMultiMap<OSMBike>;
+using OSMLaneConnectivityMultiMap = FlatMultiMap<OSMLaneConnectivity>;
 
 // OSMString map uses the way Id as the key and the name index into UniqueNames as the value
 using OSMStringMap = std::unordered_map<uint64_t, uint32_t>;
@@ -75,6 +77,11 @@ struct OSMData {
    */
   bool read_from_unique_names_file(const std::string& tile_dir);
 
+  /**
+   * Sort the flat maps so they can be searched. Called when each parsing stage is done.
+   */
+  void sort_maps();
+
   /**
    * add the direction information to the forward or reverse map for relations.
    */
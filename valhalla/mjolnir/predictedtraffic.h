@@ -0,0 +1,97 @@
+#ifndef VALHALLA_MJOLNIR_PREDICTEDTRAFFIC_H
+#define VALHALLA_MJOLNIR_PREDICTEDTRAFFIC_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <valhalla/baldr/directededge.h>
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphtileheader.h>
+#include <valhalla/baldr/predictedspeeds.h>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * A row of the csv files valhalla_add_predicted_traffic reads. A row is the edge id (as
+ * level/tile/id) followed by the free flow speed, the constrained flow speed and the base64
+ * encoded speed profile of the edge, all but the edge id may be empty.
+ */
+struct TrafficRow {
+  // the fields in the order they come in a row
+  enum Field : uint8_t {
+    kEdgeId,
+    kFreeFlowSpeed,
+    kConstrainedFlowSpeed,
+    kCompressedSpeeds,
+    kFieldCount
+  };
+
+  baldr::GraphId edge_id;
+  uint8_t free_flow_speed;
+  uint8_t constrained_flow_speed;
+  // how many of the fields the row had
+  uint8_t field_count;
+  bool has_coefficients;
+  std::array<int16_t, baldr::kCoefficientCount> coefficients;
+
+  /**
+   * Parse a row without allocating anything, fields past the speed profile are ignored.
+   * @param  begin  the start of the row
+   * @param  end    the end of the row, not including the line break
+   * @return the first field that could not be parsed or kFieldCount if the row is fine
+   */
+  Field Parse(const char* begin, const char* end);
+};
+
+/**
+ * Updates the speeds of the edges of a tile on disk in place. Only the header, the directed edges
+ * and the predicted speeds get written, the rest of the tile is left as it is on disk. Keeping one
+ * of these per thread means its buffers are reused from tile to tile.
+ */
+class TileSpeedsUpdater {
+public:
+  /**
+   * Read the header and the directed edges of a tile. Throws if the tile cant be read.
+   * @param  tile_path  the tile file
+   */
+  void Open(const std::string& tile_path);
+
+  /**
+   * @return the number of directed edges in the open tile
+   */
+  uint32_t edge_count() const {
+    return edges_.size();
+  }
+
+  /**
+   * Set the speeds of an edge from a row.
+   * @param  edge_index  the index of the edge in the tile, must be less than edge_count()
+   * @param  row         the speeds, the zero ones are left as they are
+   * @return false if the edge already got its speeds from an earlier row
+   */
+  bool Update(uint32_t edge_index, const TrafficRow& row);
+
+  /**
+   * Write the updates to the tile. Any predicted speeds the tile had before are replaced.
+   * @return the number of edges updated
+   */
+  uint32_t Write();
+
+protected:
+  std::string tile_path_;
+  baldr::GraphTileHeader header_;
+  size_t edges_offset_;
+  std::vector<baldr::DirectedEdge> edges_;
+  std::vector<bool> updated_;
+  uint32_t updated_count_;
+  std::vector<uint32_t> profile_offsets_;
+  std::vector<int16_t> profiles_;
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_PREDICTEDTRAFFIC_H
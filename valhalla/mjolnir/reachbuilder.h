@@ -0,0 +1,27 @@
+#ifndef VALHALLA_MJOLNIR_REACHBUILDER_H
+#define VALHALLA_MJOLNIR_REACHBUILDER_H
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * Computes the inbound and outbound reach of every directed edge for the default costing of each
+ * of the modes in baldr::EdgeReach and writes it to a sidecar file in the tile directory. Loki
+ * uses it instead of expanding around every candidate edge when a request uses default costing.
+ */
+class ReachBuilder {
+public:
+  /**
+   * Computes the reach of all of the edges in the tile directory and writes the sidecar. The reach
+   * is computed up to service_limits.max_reachability (at most 255).
+   * @param pt  the config
+   */
+  static void Build(const boost::property_tree::ptree& pt);
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_REACHBUILDER_H
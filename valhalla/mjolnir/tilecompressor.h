@@ -0,0 +1,59 @@
+#ifndef VALHALLA_MJOLNIR_TILECOMPRESSOR_H
+#define VALHALLA_MJOLNIR_TILECOMPRESSOR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * Compresses the tiles of a tile directory with zstd, using a dictionary trained on the tiles of
+ * each level. GraphTile::Create reads them from there as long as the uncompressed tile is gone.
+ */
+class TileCompressor {
+public:
+  struct Options {
+    // zstd compression level, its only paid once when building and doesnt slow decompression
+    int level = 19;
+    // the largest a dictionary can be
+    size_t dictionary_size = 112640;
+    // how many bytes of tiles of each level to train its dictionary on
+    size_t sample_size = 64 * 1024 * 1024;
+    // keep the uncompressed tiles, they are read instead of the compressed ones if they are there
+    bool keep = false;
+    // also gzip each tile to compare the sizes and decompression times
+    bool compare_gzip = false;
+    unsigned int concurrency = std::max(std::thread::hardware_concurrency(), 1u);
+  };
+
+  // how it went for a level
+  struct LevelStats {
+    uint8_t level = 0;
+    size_t tiles = 0;
+    size_t dictionary_size = 0;
+    uint64_t size = 0;
+    uint64_t zstd_size = 0;
+    double zstd_seconds = 0;
+    uint64_t gzip_size = 0;
+    double gzip_seconds = 0;
+  };
+
+  /**
+   * Compress all the uncompressed tiles of a tile directory, level by level. Tiles are written
+   * as <tile>.gph.zst next to the uncompressed ones and each level's dictionary goes in its
+   * directory as zstd.dict. Throws if valhalla was built without zstd.
+   * @param  tile_dir  the tile directory
+   * @param  options   how to compress them
+   * @return how it went for each level that had tiles
+   */
+  static std::vector<LevelStats> Compress(const std::string& tile_dir, const Options& options);
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_TILECOMPRESSOR_H
@@ -0,0 +1,95 @@
+#ifndef VALHALLA_MJOLNIR_TILESCHEDULER_H
+#define VALHALLA_MJOLNIR_TILESCHEDULER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <valhalla/baldr/graphid.h>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * Hands out the tiles of a stage to its worker threads. Tiles differ a lot in how long they take
+ * (a city versus the ocean) so handing them out in any order leaves one thread working on the
+ * last big tile while the others sit idle. Instead the biggest tiles go first: they are dealt to
+ * the workers by size, each worker works through its own tiles from the biggest down and when it
+ * runs out it steals the smallest tile of the worker with the most work left. Each worker only
+ * ever locks its own queue, except when stealing.
+ *
+ * The scheduler also times every tile so that LogStats can report how busy the workers were,
+ * how long tiles took and which tiles held the stage up.
+ */
+class TileScheduler {
+public:
+  /**
+   * Schedule tiles by their size on disk, tiles that arent there cost nothing.
+   * @param  stage     the name of the stage for the stats
+   * @param  tile_dir  the tile directory to look at the tiles in
+   * @param  tiles     the tiles to schedule
+   * @param  workers   the number of worker threads that will call Next
+   */
+  TileScheduler(const std::string& stage,
+                const std::string& tile_dir,
+                const std::vector<baldr::GraphId>& tiles,
+                unsigned int workers);
+
+  /**
+   * Schedule tiles by a cost of the callers choosing.
+   * @param  stage    the name of the stage for the stats
+   * @param  tiles    the tiles to schedule and what they cost
+   * @param  workers  the number of worker threads that will call Next
+   */
+  TileScheduler(const std::string& stage,
+                std::vector<std::pair<baldr::GraphId, uint64_t>> tiles,
+                unsigned int workers);
+
+  ~TileScheduler();
+
+  /**
+   * Get the next tile for a worker, its previous tile is taken to be done. Each worker thread
+   * must use its own worker index.
+   * @param  worker   the index of the worker, less than the number of workers
+   * @param  tile_id  set to the next tile
+   * @return false once there are no tiles left for anyone
+   */
+  bool Next(unsigned int worker, baldr::GraphId& tile_id);
+
+  /**
+   * @return the number of tiles scheduled
+   */
+  size_t size() const {
+    return tiles_.size();
+  }
+
+  /**
+   * @return the number of workers
+   */
+  unsigned int workers() const {
+    return workers_.size();
+  }
+
+  /**
+   * Log how busy the workers were, a histogram of the time per tile and the slowest tiles. Call it
+   * once the workers are done.
+   */
+  void LogStats() const;
+
+protected:
+  struct Worker;
+
+  // deals the tiles, biggest first, to the worker with the least work so far
+  void Deal();
+
+  std::string stage_;
+  std::vector<std::pair<baldr::GraphId, uint64_t>> tiles_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_TILESCHEDULER_H
@@ -18,6 +18,14 @@ public:
    *             and other configuration needed to build transit.
    */
   static void Build(const boost::property_tree::ptree& pt);
+
+  /**
+   * Flatten the transit departures of the tiles into a timetable next to them, along with the
+   * walking transfers between the stops, so thor can route on transit with a connection scan.
+   * Needs the final graph since the transfers are walked on it.
+   * @param pt   Property tree containing the hierarchy configuration
+   */
+  static void BuildTimetable(const boost::property_tree::ptree& pt);
 };
 
 } // namespace mjolnir
@@ -38,7 +38,12 @@ enum class BuildStage : int8_t {
   kRestrictions = 12,
   kElevation = 13,
   kValidate = 14,
-  kCleanup = 15
+  kCleanup = 15,
+  // the sidecars only run when asked for with -s/-e, they read the finished tiles so they can
+  // also be built later against an existing tile_dir
+  kComponents = 16,
+  kReach = 17,
+  kTimetable = 18
 };
 
 constexpr uint8_t kMinor = 1;
@@ -63,7 +68,10 @@ inline BuildStage string_to_buildstage(const std::string& s) {
        {"restrictions", BuildStage::kRestrictions},
        {"elevation", BuildStage::kElevation},
        {"validate", BuildStage::kValidate},
-       {"cleanup", BuildStage::kCleanup}};
+       {"cleanup", BuildStage::kCleanup},
+       {"components", BuildStage::kComponents},
+       {"reach", BuildStage::kReach},
+       {"timetable", BuildStage::kTimetable}};
 
   auto i = stringToBuildStage.find(s);
   return (i == stringToBuildStage.cend()) ? BuildStage::kInvalid : i->second;
@@ -87,7 +95,10 @@ inline std::string to_string(BuildStage stg) {
        {static_cast<int8_t>(BuildStage::kRestrictions), "restrictions"},
        {static_cast<int8_t>(BuildStage::kElevation), "elevation"},
        {static_cast<int8_t>(BuildStage::kValidate), "validate"},
-       {static_cast<int8_t>(BuildStage::kCleanup), "cleanup"}};
+       {static_cast<int8_t>(BuildStage::kCleanup), "cleanup"},
+       {static_cast<int8_t>(BuildStage::kComponents), "components"},
+       {static_cast<int8_t>(BuildStage::kReach), "reach"},
+       {static_cast<int8_t>(BuildStage::kTimetable), "timetable"}};
 
   auto i = BuildStageStrings.find(static_cast<int8_t>(stg));
   return (i == BuildStageStrings.cend()) ? "null" : i->second;
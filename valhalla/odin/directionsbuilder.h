@@ -3,6 +3,8 @@
 
 #include <list>
 
+#include <boost/property_tree/ptree.hpp>
+
 #include <valhalla/odin/enhancedtrippath.h>
 #include <valhalla/odin/maneuver.h>
 #include <valhalla/odin/markup_formatter.h>
@@ -17,12 +19,26 @@ namespace odin {
  */
 class DirectionsBuilder {
 public:
+  // By default requests with this many legs or more have their legs built on multiple threads
+  static constexpr size_t kDefaultParallelMinLegs = 4;
+  static constexpr size_t kDefaultParallelThreads = 4;
+
+  /**
+   * Sets how many legs a request needs before they are built in parallel and how many threads to
+   * use for it. This applies to all subsequent calls to Build in the process
+   *
+   * @param config  the config, reads odin.directions_parallel_min_legs and
+   *                odin.directions_parallel_threads
+   */
+  static void Configure(const boost::property_tree::ptree& config);
+
   /**
    * Returns the trip directions based on the specified directions options
    * and trip path. This method calls ManeuversBuilder::Build and
    * NarrativeBuilder::Build to form the maneuver list. This method
    * calls PopulateDirectionsLeg to transform the maneuver list into the
-   * trip directions.
+   * trip directions. The legs of all of the routes are independent and may be built
+   * concurrently, see Configure, the directions are always in the same order as the legs.
    *
    * @param api   the protobuf object containing the request, the path and a place
    *              to store the resulting directions
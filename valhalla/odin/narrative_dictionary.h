@@ -1,9 +1,12 @@
 #ifndef VALHALLA_ODIN_NARRATIVE_DICTIONARY_H_
 #define VALHALLA_ODIN_NARRATIVE_DICTIONARY_H_
 
+#include <initializer_list>
 #include <locale>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <boost/property_tree/ptree.hpp>
@@ -157,8 +160,68 @@ constexpr auto kTransitPlatformCountLabelTag = "<TRANSIT_STOP_COUNT_LABEL>";
 namespace valhalla {
 namespace odin {
 
+/**
+ * A phrase compiled into its literal text and the tags in between so that filling in the tag
+ * values is a single pass over the phrase rather than a find and replace per tag.
+ */
+class PhraseTemplate {
+public:
+  using Values = std::initializer_list<std::pair<const char*, const std::string&>>;
+
+  PhraseTemplate() = default;
+
+  /**
+   * Splits the specified phrase into literal text and tags.
+   *
+   * @param phrase  The phrase to compile. Example: "Turn <RELATIVE_DIRECTION> onto <STREET_NAMES>."
+   */
+  explicit PhraseTemplate(const std::string& phrase);
+
+  /**
+   * Returns the phrase with its tags replaced by the specified values. Tags without a value are
+   * left as they are, values without a tag in the phrase are ignored.
+   *
+   * @param values  The tag and value pairs. Example: {{kStreetNamesTag, street_names}}
+   *
+   * @return the phrase with its tags replaced by the specified values.
+   */
+  std::string Fill(Values values) const;
+
+  /**
+   * @return true if the template was compiled from a phrase.
+   */
+  bool compiled() const {
+    return !parts_.empty();
+  }
+
+protected:
+  struct part_t {
+    std::string text;
+    bool tag;
+  };
+  std::vector<part_t> parts_;
+  size_t literal_size_ = 0;
+};
+
 struct PhraseSet {
   std::unordered_map<std::string, std::string> phrases;
+  // The phrases compiled once at load time, indexed by phrase id
+  std::vector<PhraseTemplate> templates;
+
+  /**
+   * Returns the compiled phrase with the specified id.
+   *
+   * @param  phrase_id  The phrase id.
+   *
+   * @return the compiled phrase with the specified id.
+   * @throws std::out_of_range if the phrase set does not have the phrase.
+   */
+  const PhraseTemplate& phrase(size_t phrase_id) const {
+    if (phrase_id >= templates.size() || !templates[phrase_id].compiled()) {
+      throw std::out_of_range("Missing phrase: " + std::to_string(phrase_id));
+    }
+    return templates[phrase_id];
+  }
 };
 
 struct StartSubset : PhraseSet {
@@ -71,6 +71,24 @@ public:
   }
 
 protected:
+  /////////////////////////////////////////////////////////////////////////////
+  /**
+   * Sets the text instructions of the specified maneuver.
+   *
+   * @param maneuver The current maneuver to process.
+   * @param prev_maneuver The previous maneuver, if any.
+   */
+  void FormInstructions(Maneuver& maneuver, Maneuver* prev_maneuver);
+
+  /**
+   * Sets the verbal instructions of the specified maneuver, only called when the request
+   * wants verbal instructions.
+   *
+   * @param maneuver The current maneuver to process.
+   * @param prev_maneuver The previous maneuver, if any.
+   */
+  void FormVerbalInstructions(Maneuver& maneuver, Maneuver* prev_maneuver);
+
   /////////////////////////////////////////////////////////////////////////////
   std::string FormStartInstruction(Maneuver& maneuver);
 
@@ -648,6 +666,7 @@ protected:
   const NarrativeDictionary& dictionary_;
   MarkupFormatter markup_formatter_; // No ref - need our own non-const copy
   bool articulated_preposition_enabled_;
+  bool verbal_;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <valhalla/proto/options.pb.h>
+
+namespace valhalla {
+
+/**
+ * An in process cache of the results of requests so that the same routes and matrices, asked for
+ * again and again, dont have to go through the whole pipeline every time. There are two kinds of
+ * results: whole responses, which loki can send straight back, and the paths thor found, which can
+ * be narrated again for a request that only differs in how the result is presented (language,
+ * units, format etc).
+ *
+ * Results are keyed by the canonical serialization of the parsed options together with the id of
+ * the tileset and the live traffic epoch the request sees, so a result is never handed out for
+ * other tiles or other traffic than the ones it was computed from. Incidents are not versioned so
+ * the cache is disabled when they are configured. The cache is bounded in bytes and evicts the
+ * least recently used results first.
+ */
+class ResultCache {
+public:
+  enum class Kind : uint8_t { kResponse = 0, kPath = 1 };
+
+  struct stats_t {
+    // how often a whole response was found or not
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // how often a path was found or not
+    uint64_t path_hits = 0;
+    uint64_t path_misses = 0;
+    // how many bytes the results may take up and how many they do
+    uint64_t capacity = 0;
+    uint64_t used = 0;
+    // how many results there are
+    uint64_t entries = 0;
+  };
+
+  /**
+   * Constructor
+   * @param capacity      how many bytes the results may take up
+   * @param live_traffic  whether there is live traffic, which can only be cached when its updates
+   *                      are published by epoch
+   */
+  ResultCache(size_t capacity, bool live_traffic = false);
+
+  /**
+   * Returns the cache shared by all of the workers in this process, made the first time its asked
+   * for. The size comes from httpd.service.result_cache_size
+   * @param config  the whole config
+   * @return the cache or nullptr if it is disabled or incidents are configured
+   */
+  static std::shared_ptr<ResultCache> Get(const boost::property_tree::ptree& config);
+
+  /**
+   * Works out the key a result is kept under. For paths the options that only change how the path
+   * is presented are left out. The key is the request itself rather than a hash of it so that two
+   * requests can never share a result. Seeing a new tileset or a newer traffic epoch empties the
+   * cache since nothing in it can be used anymore.
+   * @param kind        what kind of result
+   * @param options     the options of the request
+   * @param tileset_id  the id of the tileset the request is answered from
+   * @return the key or an empty string if the result of the request cannot be cached, for example
+   *         because it depends on the current time
+   */
+  std::string Key(Kind kind, const Options& options, uint64_t tileset_id);
+
+  /**
+   * Looks for a result, also counts it towards the hit rate
+   * @param kind    what kind of result
+   * @param key     its key
+   * @param result  the result is copied here if found
+   * @return true if it was found
+   */
+  bool Find(Kind kind, const std::string& key, std::string& result);
+
+  /**
+   * Keeps a result, evicting others to make room for it. Results which are too big are not kept
+   * @param key     its key
+   * @param result  the result
+   */
+  void Insert(const std::string& key, std::string result);
+
+  /**
+   * @return the hit counts and how full the cache is
+   */
+  stats_t stats() const;
+
+protected:
+  // empties the cache if the tileset changed or the traffic moved on
+  void advance(uint64_t tileset_id, uint32_t traffic_epoch);
+
+  struct entry_t {
+    std::string key;
+    std::string result;
+  };
+
+  const size_t capacity_;
+  const bool live_traffic_;
+
+  mutable std::mutex mutex_;
+  // most recently used at the front
+  std::list<entry_t> entries_;
+  std::unordered_map<std::string, std::list<entry_t>::iterator> index_;
+  size_t used_;
+  stats_t stats_;
+
+  // the newest data we have seen a request for
+  uint64_t tileset_id_;
+  uint32_t traffic_epoch_;
+};
+
+} // namespace valhalla
@@ -0,0 +1,320 @@
+#ifndef VALHALLA_THOR_CONNECTIONSCAN_H_
+#define VALHALLA_THOR_CONNECTIONSCAN_H_
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <valhalla/baldr/graphreader.h>
+#include <valhalla/baldr/transittimetable.h>
+#include <valhalla/proto/common.pb.h>
+#include <valhalla/sif/dynamiccost.h>
+#include <valhalla/thor/dijkstras.h>
+#include <valhalla/thor/multimodal.h>
+#include <valhalla/thor/pathinfo.h>
+
+namespace valhalla {
+namespace thor {
+
+/**
+ * Connection Scan over a baldr::TransitTimetable. It knows nothing about the graph, the stops the
+ * journeys can start and end at come from walking to and from them with pedestrian costing (see
+ * ConnectionScanAlgorithm). Journeys arrive as early as possible, ties going to fewer transfers.
+ *
+ * Besides the service day of the departure the scan looks at the trips of the day before that run
+ * past midnight and at the trips of the next day for journeys that go on past midnight. All times
+ * are seconds from the midnight of the departure's service day.
+ */
+class ConnectionScan {
+public:
+  using timetable_t = baldr::TransitTimetable;
+
+  // a stop a journey can start or end at and how long it takes to walk between it and the location
+  struct access_t {
+    uint32_t stop;
+    uint32_t secs;
+    uint32_t distance;
+  };
+
+  // one part of a journey, a ride along connections of a single trip or a walk between two stops
+  struct leg_t {
+    uint32_t from_stop;
+    uint32_t to_stop;
+    uint32_t departure;
+    uint32_t arrival;
+    // the first and last connections ridden, both are null for a walk
+    const timetable_t::connection_t* board;
+    const timetable_t::connection_t* alight;
+    // what to add to the times of the connections when the trip runs on the day before or after
+    int32_t shift;
+  };
+
+  struct journey_t {
+    // when to leave the origin and when the destination is reached
+    uint32_t departure;
+    uint32_t arrival;
+    // the stops walked to from the origin and from to the destination
+    access_t access;
+    access_t egress;
+    std::vector<leg_t> legs;
+  };
+
+  // which connections can be used
+  struct filter_t {
+    // days from the pivot date and day of week mask of the service day
+    uint32_t date;
+    uint32_t dow;
+    // flags the connections must have (wheelchair, bicycle)
+    uint32_t flags;
+    // footpaths longer than this are not walked
+    uint32_t max_transfer_distance;
+    // time needed to change trips at a stop
+    uint32_t transfer_secs;
+  };
+
+  /**
+   * @param timetable  the timetable to route on
+   */
+  explicit ConnectionScan(std::shared_ptr<const timetable_t> timetable);
+
+  /**
+   * Finds the journey that arrives at the destination the earliest
+   * @param access     the stops that can be walked to from the origin
+   * @param egress     the stops the destination can be walked to from
+   * @param departure  when the origin is left, seconds from midnight
+   * @param filter     which connections can be used
+   * @param journey    set to the journey if there is one
+   * @return true if the destination could be reached
+   */
+  bool EarliestArrival(const std::vector<access_t>& access,
+                       const std::vector<access_t>& egress,
+                       uint32_t departure,
+                       const filter_t& filter,
+                       journey_t& journey);
+
+  /**
+   * Finds all of the journeys leaving the origin within a window of time which are not beaten by a
+   * journey leaving later, ie. the answer to "what are my options in the next hour"
+   * @param access        the stops that can be walked to from the origin
+   * @param egress        the stops the destination can be walked to from
+   * @param departure     the start of the window, seconds from midnight
+   * @param window        the length of the window in seconds
+   * @param filter        which connections can be used
+   * @param max_journeys  stop after finding this many
+   * @return the journeys ordered by departure
+   */
+  std::vector<journey_t> Range(const std::vector<access_t>& access,
+                               const std::vector<access_t>& egress,
+                               uint32_t departure,
+                               uint32_t window,
+                               const filter_t& filter,
+                               size_t max_journeys);
+
+protected:
+  // how a stop was reached
+  struct label_t {
+    uint32_t arrival;
+    uint32_t transfers;
+    // the first and last connections ridden to get here or null when walking
+    const timetable_t::connection_t* board;
+    const timetable_t::connection_t* alight;
+    // the stop walked from or kInvalidStop when walking from the origin
+    uint32_t walked_from;
+    // the shift of the day the trip ridden runs on
+    int32_t shift;
+  };
+
+  // the connections of one service day that are still to be scanned
+  struct day_t {
+    const timetable_t::connection_t* next;
+    int32_t shift;
+    uint32_t date;
+    uint32_t dow;
+  };
+  static constexpr size_t kDays = 3;
+
+  void Reset();
+  void Reach(uint32_t stop, const label_t& label, uint32_t& target);
+  void Walk(uint32_t stop, const filter_t& filter, uint32_t& target);
+  bool Usable(const timetable_t::connection_t& connection, const day_t& day) const;
+
+  /**
+   * Sets up the previous, current and next service day to scan from a time onwards
+   * @param departure  seconds from midnight of the current day
+   * @param filter     has the date and day of week of the current day
+   * @param days       the days to set up
+   */
+  void Days(uint32_t departure, const filter_t& filter, day_t (&days)[kDays]) const;
+
+  /**
+   * @param days  the days being scanned
+   * @param day   set to the index of the day of the connection
+   * @return the connection departing next of all of the days or nullptr when there are none left
+   */
+  const timetable_t::connection_t* Next(day_t (&days)[kDays], size_t& day) const;
+
+  std::shared_ptr<const timetable_t> timetable_;
+
+  // per stop and per trip state, only whats touched is reset between scans
+  std::vector<label_t> labels_;
+  std::vector<uint32_t> touched_stops_;
+  std::vector<const timetable_t::connection_t*> boarded_;
+  std::vector<uint32_t> touched_trips_;
+  std::vector<uint32_t> egress_secs_;
+  std::vector<uint32_t> touched_egress_;
+  std::vector<uint32_t> walk_queue_;
+};
+
+/**
+ * Walks with pedestrian costing from a location to the transit stops near it and remembers how to
+ * get to each stop. Walks never go through a stop, that is what the footpaths of the timetable are
+ * for, and never along the transit lines.
+ *
+ * Pedestrian costing doesnt allow transit connections in reverse so the walk from the stops to a
+ * location is found walking away from it as well and then turned around, walks are taken to be the
+ * same either way.
+ */
+class StopWalk : public Dijkstras {
+public:
+  explicit StopWalk(const boost::property_tree::ptree& config = {});
+
+  /**
+   * Walks out from the location
+   * @param location      where to start, or end when walking towards it
+   * @param reader        graph access
+   * @param mode_costing  the pedestrian costing has to allow transit connections
+   * @param forward       whether the path goes away from the location or towards it
+   * @param max_distance  dont walk further than this many metres
+   * @param timetable     the timetable that says which nodes are stops
+   * @param targets       edges to note the walking time to, empty if none
+   */
+  void Walk(const valhalla::Location& location,
+            baldr::GraphReader& reader,
+            const sif::mode_costing_t& mode_costing,
+            bool forward,
+            uint32_t max_distance,
+            const baldr::TransitTimetable& timetable,
+            const std::unordered_set<uint64_t>& targets = {});
+
+  /**
+   * @return the stops that were reached and how long and far it was to walk to them
+   */
+  std::vector<ConnectionScan::access_t> stops() const;
+
+  /**
+   * @return the shortest walk to one of the target edges in seconds, 0 if none were reached
+   */
+  uint32_t target_secs() const {
+    return target_secs_;
+  }
+
+  /**
+   * The edges walked between the location and the stop in the order they are walked
+   * @param stop    the stop
+   * @param offset  the time at the start of the walk
+   * @param path    the edges are added to this
+   * @return false if the stop wasnt reached
+   */
+  bool AppendPath(uint32_t stop, uint32_t offset, std::vector<PathInfo>& path) const;
+
+  /**
+   * Makes a location on a stop so that you can walk from it
+   * @param reader  graph access
+   * @param node    the stop node
+   * @return the location with all of the edges leaving the node correlated
+   */
+  static valhalla::Location StopLocation(baldr::GraphReader& reader, const baldr::GraphId& node);
+
+protected:
+  void ExpandingNode(baldr::GraphReader& graphreader,
+                     graph_tile_ptr tile,
+                     const baldr::NodeInfo* node,
+                     const sif::EdgeLabel& current,
+                     const sif::EdgeLabel* previous) override;
+
+  ExpansionRecommendation ShouldExpand(baldr::GraphReader& graphreader,
+                                       const sif::EdgeLabel& pred,
+                                       const ExpansionType route_type) override;
+
+  void GetExpansionHints(uint32_t& bucket_count, uint32_t& edge_label_reservation) const override;
+
+  bool forward_;
+  uint32_t max_distance_;
+  const baldr::TransitTimetable* timetable_;
+  const std::unordered_set<uint64_t>* targets_;
+  uint32_t target_secs_;
+  // the label of the edge that got us to each stop
+  std::unordered_map<uint32_t, uint32_t> stop_labels_;
+};
+
+/**
+ * Routes on transit with ConnectionScan over the timetable written at build time instead of looking
+ * up departures edge by edge. The walking at either end and between stops uses pedestrian costing.
+ * Anything the timetable cant answer, such as stop, route or operator filters, walking being faster
+ * or a graph without a timetable, falls back to the multimodal A*.
+ */
+class ConnectionScanAlgorithm : public MultiModalPathAlgorithm {
+public:
+  /**
+   * Constructor.
+   * @param config A config object of key, value pairs
+   */
+  explicit ConnectionScanAlgorithm(const boost::property_tree::ptree& config = {});
+
+  /**
+   * @param timetable  the timetable to route on, without one this is the multimodal A*
+   */
+  void set_timetable(std::shared_ptr<const baldr::TransitTimetable> timetable);
+
+  /**
+   * Finds the journey arriving the earliest, or when alternates are requested the journeys leaving
+   * within the range window that are not beaten by a later one
+   * @param  origin  Origin location
+   * @param  dest    Destination location
+   * @param  graphreader  Graph reader for accessing routing graph.
+   * @param  mode_costing  An array of costing methods, one per TravelMode.
+   * @param  mode     Travel mode from the origin.
+   * @param  options  The request options
+   * @return  Returns the path edges (and elapsed time/modes at end of each edge).
+   */
+  std::vector<std::vector<PathInfo>>
+  GetBestPath(valhalla::Location& origin,
+              valhalla::Location& dest,
+              baldr::GraphReader& graphreader,
+              const sif::mode_costing_t& mode_costing,
+              const sif::TravelMode mode,
+              const Options& options = Options::default_instance()) override;
+
+  /**
+   * Returns the name of the algorithm
+   * @return the name of the algorithm
+   */
+  virtual const char* name() const override {
+    return "ConnectionScan";
+  }
+
+  /**
+   * Clear the temporary information generated during path construction.
+   */
+  void Clear() override;
+
+protected:
+  std::vector<PathInfo> FormPath(const ConnectionScan::journey_t& journey,
+                                 uint32_t start_time,
+                                 baldr::GraphReader& graphreader,
+                                 const sif::mode_costing_t& mode_costing);
+
+  std::shared_ptr<const baldr::TransitTimetable> timetable_;
+  std::unique_ptr<ConnectionScan> scan_;
+  StopWalk access_;
+  StopWalk egress_;
+  StopWalk transfer_;
+  uint32_t range_window_;
+};
+
+} // namespace thor
+} // namespace valhalla
+
+#endif // VALHALLA_THOR_CONNECTIONSCAN_H_
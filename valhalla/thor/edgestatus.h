@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include <valhalla/baldr/graphid.h>
 #include <valhalla/baldr/graphtile.h>
+#include <valhalla/midgard/arena.h>
 
 // handy macro for shifting the 7bit path index value so that it can be or'd with the tile/level id
 #define SHIFT_path_id(x) (static_cast<uint32_t>(x) << 25u)
@@ -49,7 +50,9 @@ struct EdgeStatusInfo {
  * list during shortest path algorithms. This method stores status info for
  * edges within arrays for each tile. This allows the path algorithms to get
  * a pointer to the first edge status and iterate that pointer over sequential
- * edges. This reduces the number of map lookups.
+ * edges. This reduces the number of map lookups. The per tile arrays are carved
+ * out of an arena which is reset rather than freed when the status is cleared so
+ * that subsequent requests can reuse the memory without going back to malloc.
  */
 class EdgeStatus {
 public:
@@ -66,21 +69,29 @@ public:
   EdgeStatus& operator=(EdgeStatus&&) = default;
 
   /**
-   * Destructor. Delete any allocated EdgeStatusInfo arrays.
+   * Clear the EdgeStatusInfo arrays and the edge status map. The memory backing the
+   * arrays is kept around (up to the arenas retention limit) for the next search.
    */
-  ~EdgeStatus() {
-    clear();
+  void clear() {
+    edgestatus_.clear();
+    arena_.reset();
   }
 
   /**
-   * Clear the EdgeStatusInfo arrays and the edge status map.
+   * Clear the edge status and give all of the memory back to the system.
    */
-  void clear() {
-    // Delete any allocated arrays for tiles within the map.
-    for (auto& iter : edgestatus_) {
-      delete[] iter.second;
-    }
+  void release() {
     edgestatus_.clear();
+    arena_.release();
+  }
+
+  /**
+   * Returns the arena the per tile arrays are allocated from, useful to inspect
+   * how much memory a search required.
+   * @return the arena
+   */
+  const midgard::MonotonicArena& arena() const {
+    return arena_;
   }
 
   /**
@@ -105,7 +116,8 @@ public:
       // Tile is not in the map. Add an array of EdgeStatusInfo, sized to
       // the number of directed edges in the specified tile.
       auto inserted = edgestatus_.emplace(edgeid.tile_value() | SHIFT_path_id(path_id),
-                                          new EdgeStatusInfo[tile->header()->directededgecount()]);
+                                          arena_.allocate_array<EdgeStatusInfo>(
+                                              tile->header()->directededgecount()));
       inserted.first->second[edgeid.id()] = {set, index};
     }
   }
@@ -161,7 +173,8 @@ public:
       // Tile is not in the map. Add an array of EdgeStatusInfo, sized to
       // the number of directed edges in the specified tile.
       auto inserted = edgestatus_.emplace(edgeid.tile_value() | SHIFT_path_id(path_id),
-                                          new EdgeStatusInfo[tile->header()->directededgecount()]);
+                                          arena_.allocate_array<EdgeStatusInfo>(
+                                              tile->header()->directededgecount()));
       return &(inserted.first->second)[edgeid.id()];
     }
   }
@@ -171,6 +184,9 @@ private:
   // values are dynamically allocated arrays of EdgeStatusInfo (sized
   // based on the directed edge count within the tile).
   std::unordered_map<uint32_t, EdgeStatusInfo*> edgestatus_;
+
+  // Backing memory for the EdgeStatusInfo arrays
+  midgard::MonotonicArena arena_;
 };
 
 } // namespace thor
@@ -6,6 +6,8 @@
 #include <utility>
 #include <vector>
 
+#include <boost/property_tree/ptree.hpp>
+
 #include <valhalla/baldr/graphid.h>
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/baldr/pathlocation.h>
@@ -32,6 +34,18 @@ struct EdgeTrimmingInfo {
  */
 class TripLegBuilder {
 public:
+  // By default paths with this many edges or more have their shape built on multiple threads
+  static constexpr size_t kDefaultParallelMinEdges = 4000;
+  static constexpr size_t kDefaultParallelThreads = 4;
+
+  /**
+   * Sets how long paths need to be before their edge shapes are decoded and trimmed in parallel and
+   * how many threads to use for it. This applies to all subsequent calls to Build in the process
+   *
+   * @param config  the thor config, reads tripleg_parallel_min_edges and tripleg_parallel_threads
+   */
+  static void Configure(const boost::property_tree::ptree& config);
+
   /**
    * Form a trip leg out of a path (sequence of path infos)
    *
@@ -22,6 +22,7 @@
 #include <valhalla/thor/attributes_controller.h>
 #include <valhalla/thor/bidirectional_astar.h>
 #include <valhalla/thor/centroid.h>
+#include <valhalla/thor/connectionscan.h>
 #include <valhalla/thor/isochrone.h>
 #include <valhalla/thor/multimodal.h>
 #include <valhalla/thor/triplegbuilder.h>
@@ -79,6 +80,12 @@ protected:
                                           const Location& destination,
                                           const Options& options);
   void route_match(Api& request);
+  /**
+   * Routes the request unless the result cache already has the path for the same request, in which
+   * case the trip, the correlated locations and the warnings routing gave are taken from there
+   * @param request  the request to route
+   */
+  void cached_route(Api& request);
   /**
    * Returns the results of the map match where the first float is the normalized
    * match score (based on alternatives), the second is the raw score (the cost)
@@ -119,6 +126,8 @@ protected:
   BidirectionalAStar bidir_astar;
   AStarBSSAlgorithm bss_astar;
   MultiModalPathAlgorithm multi_modal_astar;
+  ConnectionScanAlgorithm connection_scan;
+  bool use_connection_scan;
   TimeDepForward timedep_forward;
   TimeDepReverse timedep_reverse;
 
@@ -6,6 +6,7 @@
 #include <valhalla/baldr/rapidjson_utils.h>
 #include <valhalla/midgard/util.h>
 #include <valhalla/proto/api.pb.h>
+#include <valhalla/result_cache.h>
 #include <valhalla/valhalla.h>
 
 #ifdef HAVE_HTTP
@@ -73,6 +74,22 @@ void ParseApi(const std::string& json_request, Options::Action action, Api& api)
 void ParseApi(const prime_server::http_request_t& http_request, Api& api);
 #endif
 
+/**
+ * The stages of the service pipeline which a request is forwarded to by the one before it
+ */
+enum class Stage : uint8_t { kThor, kOdin };
+
+/**
+ * Drops the parts of the request which the next stage never reads so that they dont have to be
+ * serialized and parsed again on the way there. After loki the exclude locations and polygons have
+ * become excluded edges on the costing and after thor only the first candidate edge of a location
+ * is looked at. Nothing is dropped if the options are part of a pbf response.
+ *
+ * @param next  the stage the request is about to be forwarded to
+ * @param api   the request to prune
+ */
+void prune_for(Stage next, Api& api);
+
 std::string serialize_error(const valhalla_exception_t& exception, Api& options);
 #ifdef HAVE_HTTP
 prime_server::worker_t::result_t serialize_error(const valhalla_exception_t& exception,
@@ -155,8 +172,38 @@ protected:
    */
   void started();
 
+  /**
+   * Returns the options for a protobuf arena whose first block is a buffer owned by this worker.
+   * The buffer is reused for every request so that parsing and building up the request object does
+   * not have to go to the heap unless the request outgrows it
+   *
+   * @return the options to construct the per request arena with
+   */
+  google::protobuf::ArenaOptions arena_options() const;
+
+  /**
+   * Keeps the finished response to a request in the result cache, if there is one, so that loki can
+   * send it straight back the next time the same request comes in
+   *
+   * @param api       the request, it knows the key the response is kept under
+   * @param response  the response to keep
+   */
+  void cache_response(const Api& api, const std::string& response) const;
+
+  /**
+   * Returns the epoch of live traffic the request reads, the first stage to ask takes the newest
+   * published one and keeps it in the request so that every later stage pins the very same speeds
+   *
+   * @param api  the request which keeps the epoch
+   * @return the epoch to pin the TrafficSnapshot of this stage to
+   */
+  static uint32_t traffic_epoch(Api& api);
+
   const std::function<void()>* interrupt;
   std::unique_ptr<statsd_client_t> statsd_client;
+  std::unique_ptr<char[]> arena_block;
+  size_t arena_block_size;
+  std::shared_ptr<ResultCache> result_cache;
 };
 } // namespace valhalla
 